@@ -0,0 +1,456 @@
+#include "WebRTCClientBenchmarkFixture.h"
+
+namespace com {
+namespace amazonaws {
+namespace kinesis {
+namespace video {
+namespace webrtcclient {
+
+#define RTP_BENCHMARK_FRAME_COUNT         300
+#define RTP_BENCHMARK_OPUS_FRAME_COUNT    300
+#define RTP_BENCHMARK_VP8_FRAME_SIZE      (16 * 1024)
+#define RTP_BENCHMARK_MAX_DEPAY_FRAME_LEN (512 * 1024)
+#define RTP_BENCHMARK_PAYLOAD_TYPE        96
+#define RTP_BENCHMARK_SSRC                0x12345678
+
+typedef STATUS (*BenchmarkPayloadFunc)(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
+
+class RtpPayloaderBenchmark : public WebRtcClientBenchmarkBase {
+  public:
+    VOID SetUp(const ::benchmark::State& state)
+    {
+        WebRtcClientBenchmarkBase::SetUp(state);
+        MEMSET(&payloadArray, 0x00, SIZEOF(payloadArray));
+        MEMSET(&payloadDescriptors, 0x00, SIZEOF(payloadDescriptors));
+    }
+
+    VOID TearDown(const ::benchmark::State& state)
+    {
+        SAFE_MEMFREE(payloadArray.payloadBuffer);
+        SAFE_MEMFREE(payloadArray.payloadSubLength);
+        freePayloadDescriptorArray(&payloadDescriptors);
+        WebRtcClientBenchmarkBase::TearDown(state);
+    }
+
+    // Same two-call pattern and buffer reuse as writeFrame
+    STATUS packetize(BenchmarkPayloadFunc payloadFn, PBYTE pFrame, UINT32 frameLen)
+    {
+        STATUS retStatus = STATUS_SUCCESS;
+
+        CHK_STATUS(payloadFn(DEFAULT_MTU_SIZE_BYTES, pFrame, frameLen, NULL, &payloadArray.payloadLength, NULL, &payloadArray.payloadSubLenSize));
+        if (payloadArray.payloadLength > payloadArray.maxPayloadLength) {
+            SAFE_MEMFREE(payloadArray.payloadBuffer);
+            payloadArray.payloadBuffer = (PBYTE) MEMALLOC(payloadArray.payloadLength);
+            payloadArray.maxPayloadLength = payloadArray.payloadLength;
+        }
+        if (payloadArray.payloadSubLenSize > payloadArray.maxPayloadSubLenSize) {
+            SAFE_MEMFREE(payloadArray.payloadSubLength);
+            payloadArray.payloadSubLength = (PUINT32) MEMALLOC(payloadArray.payloadSubLenSize * SIZEOF(UINT32));
+            payloadArray.maxPayloadSubLenSize = payloadArray.payloadSubLenSize;
+        }
+        CHK_STATUS(payloadFn(DEFAULT_MTU_SIZE_BYTES, pFrame, frameLen, payloadArray.payloadBuffer, &payloadArray.payloadLength,
+                             payloadArray.payloadSubLength, &payloadArray.payloadSubLenSize));
+
+    CleanUp:
+
+        return retStatus;
+    }
+
+    // Splits every frame into its RTP payloads once, outside of the timed region
+    STATUS collectPayloads(BenchmarkPayloadFunc payloadFn, std::vector<std::vector<BYTE>>& frames, std::vector<std::vector<BYTE>>& payloads)
+    {
+        STATUS retStatus = STATUS_SUCCESS;
+        UINT32 i, offset;
+
+        payloads.clear();
+        for (auto& frame : frames) {
+            CHK_STATUS(packetize(payloadFn, frame.data(), (UINT32) frame.size()));
+            for (i = 0, offset = 0; i < payloadArray.payloadSubLenSize; offset += payloadArray.payloadSubLength[i], i++) {
+                payloads.emplace_back(payloadArray.payloadBuffer + offset, payloadArray.payloadBuffer + offset + payloadArray.payloadSubLength[i]);
+            }
+        }
+
+    CleanUp:
+
+        return retStatus;
+    }
+
+    VOID runPayloader(benchmark::State& state, BenchmarkPayloadFunc payloadFn, std::vector<std::vector<BYTE>>& frames)
+    {
+        STATUS retStatus = STATUS_SUCCESS;
+        UINT64 bytes = 0, frameCount = 0, allocations = 0;
+        SIZE_T index = 0;
+
+        CHK(!frames.empty(), STATUS_INVALID_ARG);
+
+        startCountingAllocations();
+        for (auto _ : state) {
+            auto& frame = frames[index];
+            CHK_STATUS(packetize(payloadFn, frame.data(), (UINT32) frame.size()));
+            bytes += frame.size();
+            frameCount++;
+            index = (index + 1) % frames.size();
+        }
+        allocations = stopCountingAllocations();
+
+        reportCounters(state, bytes, frameCount, allocations);
+
+    CleanUp:
+
+        if (STATUS_FAILED(retStatus)) {
+            stopCountingAllocations();
+            state.SkipWithError("packetization failed");
+        }
+    }
+
+    // Single-pass packetization followed by the copy into the payload array, as done by writeFrame
+    VOID runPacketizer(benchmark::State& state, RtpPacketizeFunc packetizeFn, std::vector<std::vector<BYTE>>& frames)
+    {
+        STATUS retStatus = STATUS_SUCCESS;
+        UINT64 bytes = 0, frameCount = 0, allocations = 0;
+        SIZE_T index = 0;
+
+        CHK(!frames.empty(), STATUS_INVALID_ARG);
+
+        startCountingAllocations();
+        for (auto _ : state) {
+            auto& frame = frames[index];
+            resetPayloadDescriptorArray(&payloadDescriptors);
+            CHK_STATUS(packetizeFn(DEFAULT_MTU_SIZE_BYTES, frame.data(), (UINT32) frame.size(), &payloadDescriptors));
+            CHK_STATUS(flattenPayloadDescriptors(&payloadDescriptors, &payloadArray));
+            bytes += frame.size();
+            frameCount++;
+            index = (index + 1) % frames.size();
+        }
+        allocations = stopCountingAllocations();
+
+        reportCounters(state, bytes, frameCount, allocations);
+
+    CleanUp:
+
+        if (STATUS_FAILED(retStatus)) {
+            stopCountingAllocations();
+            state.SkipWithError("packetization failed");
+        }
+    }
+
+    VOID runDepayloader(benchmark::State& state, BenchmarkPayloadFunc payloadFn, DepayRtpPayloadFunc depayFn,
+                        std::vector<std::vector<BYTE>>& frames)
+    {
+        STATUS retStatus = STATUS_SUCCESS;
+        std::vector<std::vector<BYTE>> payloads;
+        std::vector<BYTE> outBuffer(RTP_BENCHMARK_MAX_DEPAY_FRAME_LEN);
+        UINT64 bytes = 0, packetCount = 0, allocations = 0;
+        UINT32 outLen;
+        BOOL isStart;
+        SIZE_T index = 0;
+
+        CHK(!frames.empty(), STATUS_INVALID_ARG);
+        CHK_STATUS(collectPayloads(payloadFn, frames, payloads));
+
+        startCountingAllocations();
+        for (auto _ : state) {
+            auto& payload = payloads[index];
+            outLen = (UINT32) outBuffer.size();
+            isStart = TRUE;
+            CHK_STATUS(depayFn(payload.data(), (UINT32) payload.size(), outBuffer.data(), &outLen, &isStart));
+            bytes += payload.size();
+            packetCount++;
+            index = (index + 1) % payloads.size();
+        }
+        allocations = stopCountingAllocations();
+
+        // Depayloaders are invoked per packet; scale the per-item count to whole frames for comparison with the payloaders
+        reportCounters(state, bytes, packetCount * frames.size() / payloads.size(), allocations);
+
+    CleanUp:
+
+        if (STATUS_FAILED(retStatus)) {
+            stopCountingAllocations();
+            state.SkipWithError("depacketization failed");
+        }
+    }
+
+    VOID reportCounters(benchmark::State& state, UINT64 bytes, UINT64 frameCount, UINT64 allocations)
+    {
+        state.SetBytesProcessed((INT64) bytes);
+        state.SetItemsProcessed((INT64) state.iterations());
+        state.counters["allocs_per_frame"] = frameCount == 0 ? 0.0 : (DOUBLE) allocations / (DOUBLE) frameCount;
+    }
+
+    STATUS loadH264Frames(std::vector<std::vector<BYTE>>& frames)
+    {
+        return loadSampleFrames((PCHAR) "h264SampleFrames", (PCHAR) "frame-%04d.h264", 1, RTP_BENCHMARK_FRAME_COUNT, frames);
+    }
+
+    STATUS loadH265Frames(std::vector<std::vector<BYTE>>& frames)
+    {
+        return loadSampleFrames((PCHAR) "h265SampleFrames", (PCHAR) "frame-%04d.h265", 1, RTP_BENCHMARK_FRAME_COUNT, frames);
+    }
+
+    STATUS loadOpusFrames(std::vector<std::vector<BYTE>>& frames)
+    {
+        return loadSampleFrames((PCHAR) "opusSampleFrames", (PCHAR) "sample-%03d.opus", 0, RTP_BENCHMARK_OPUS_FRAME_COUNT, frames);
+    }
+
+    // There are no bundled VP8 samples; a single key-frame sized buffer exercises the same fragmentation path
+    VOID makeVp8Frames(std::vector<std::vector<BYTE>>& frames)
+    {
+        std::vector<BYTE> frame(RTP_BENCHMARK_VP8_FRAME_SIZE);
+        for (UINT32 i = 0; i < RTP_BENCHMARK_VP8_FRAME_SIZE; i++) {
+            frame[i] = (BYTE) (i * 7);
+        }
+        frames.assign(1, frame);
+    }
+
+    PayloadArray payloadArray;
+    PayloadDescriptorArray payloadDescriptors;
+};
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_CreatePayloadForH264)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    if (STATUS_FAILED(loadH264Frames(frames))) {
+        state.SkipWithError("failed to load h264 sample frames");
+        return;
+    }
+    runPayloader(state, createPayloadForH264, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_CreatePayloadForH265)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    if (STATUS_FAILED(loadH265Frames(frames))) {
+        state.SkipWithError("failed to load h265 sample frames");
+        return;
+    }
+    runPayloader(state, createPayloadForH265, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_CreatePayloadForVP8)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    makeVp8Frames(frames);
+    runPayloader(state, createPayloadForVP8, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_PacketizeH264Frame)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    if (STATUS_FAILED(loadH264Frames(frames))) {
+        state.SkipWithError("failed to load h264 sample frames");
+        return;
+    }
+    runPacketizer(state, packetizeH264Frame, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_PacketizeH265Frame)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    if (STATUS_FAILED(loadH265Frames(frames))) {
+        state.SkipWithError("failed to load h265 sample frames");
+        return;
+    }
+    runPacketizer(state, packetizeH265Frame, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_PacketizeVP8Frame)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    makeVp8Frames(frames);
+    runPacketizer(state, packetizeVP8Frame, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_CreatePayloadForOpusRed)(benchmark::State& state)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    std::vector<std::vector<BYTE>> frames;
+    PRedSenderState pRedState = NULL;
+    UINT64 bytes = 0, frameCount = 0, allocations = 0;
+    UINT32 rtpTimestamp = 0, subLenCap;
+    BOOL isFallback;
+    SIZE_T index = 0;
+
+    CHK_STATUS(loadOpusFrames(frames));
+    CHK_STATUS(createRedSenderState((UINT8) state.range(0), RTP_BENCHMARK_PAYLOAD_TYPE, &pRedState));
+
+    payloadArray.maxPayloadLength = DEFAULT_MTU_SIZE_BYTES;
+    payloadArray.payloadBuffer = (PBYTE) MEMALLOC(payloadArray.maxPayloadLength);
+    payloadArray.maxPayloadSubLenSize = 1;
+    payloadArray.payloadSubLength = (PUINT32) MEMALLOC(SIZEOF(UINT32));
+    CHK(payloadArray.payloadBuffer != NULL && payloadArray.payloadSubLength != NULL, STATUS_NOT_ENOUGH_MEMORY);
+
+    startCountingAllocations();
+    for (auto _ : state) {
+        auto& frame = frames[index];
+        payloadArray.payloadLength = payloadArray.maxPayloadLength;
+        subLenCap = 1;
+        CHK_STATUS(createPayloadForOpusRed(DEFAULT_MTU_SIZE_BYTES, frame.data(), (UINT32) frame.size(), rtpTimestamp, pRedState,
+                                           payloadArray.payloadBuffer, &payloadArray.payloadLength, payloadArray.payloadSubLength, &subLenCap,
+                                           &isFallback));
+        rtpTimestamp += 960;
+        bytes += frame.size();
+        frameCount++;
+        index = (index + 1) % frames.size();
+    }
+    allocations = stopCountingAllocations();
+
+    reportCounters(state, bytes, frameCount, allocations);
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus)) {
+        stopCountingAllocations();
+        state.SkipWithError("opus red packetization failed");
+    }
+
+    freeRedSenderState(&pRedState);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_DepayH264FromRtpPayload)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    if (STATUS_FAILED(loadH264Frames(frames))) {
+        state.SkipWithError("failed to load h264 sample frames");
+        return;
+    }
+    runDepayloader(state, createPayloadForH264, depayH264FromRtpPayload, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_DepayH265FromRtpPayload)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    if (STATUS_FAILED(loadH265Frames(frames))) {
+        state.SkipWithError("failed to load h265 sample frames");
+        return;
+    }
+    runDepayloader(state, createPayloadForH265, depayH265FromRtpPayload, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_DepayVP8FromRtpPayload)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    makeVp8Frames(frames);
+    runDepayloader(state, createPayloadForVP8, depayVP8FromRtpPayload, frames);
+}
+
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_DepayOpusFromRtpPayload)(benchmark::State& state)
+{
+    std::vector<std::vector<BYTE>> frames;
+    if (STATUS_FAILED(loadOpusFrames(frames))) {
+        state.SkipWithError("failed to load opus sample frames");
+        return;
+    }
+    runDepayloader(state, createPayloadForOpus, depayOpusFromRtpPayload, frames);
+}
+
+// Full send-side path for a frame: payloader, RTP header construction and wire serialization
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_ConstructAndSerializeRtpPackets)(benchmark::State& state)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    std::vector<std::vector<BYTE>> frames;
+    std::vector<RtpPacket> packets;
+    std::vector<BYTE> rawPacket(MAX_UDP_PACKET_SIZE);
+    UINT64 bytes = 0, frameCount = 0, allocations = 0;
+    UINT32 i, rawPacketLen, rtpTimestamp = 0;
+    UINT16 sequenceNumber = 0;
+    SIZE_T index = 0;
+
+    CHK_STATUS(loadH264Frames(frames));
+
+    startCountingAllocations();
+    for (auto _ : state) {
+        auto& frame = frames[index];
+        CHK_STATUS(packetize(createPayloadForH264, frame.data(), (UINT32) frame.size()));
+        if (packets.size() < payloadArray.payloadSubLenSize) {
+            packets.resize(payloadArray.payloadSubLenSize);
+        }
+        CHK_STATUS(constructRtpPackets(&payloadArray, RTP_BENCHMARK_PAYLOAD_TYPE, sequenceNumber, rtpTimestamp, RTP_BENCHMARK_SSRC, packets.data(),
+                                       payloadArray.payloadSubLenSize));
+        for (i = 0; i < payloadArray.payloadSubLenSize; i++) {
+            rawPacketLen = (UINT32) rawPacket.size();
+            CHK_STATUS(createBytesFromRtpPacket(&packets[i], rawPacket.data(), &rawPacketLen));
+            bytes += rawPacketLen;
+        }
+        sequenceNumber += (UINT16) payloadArray.payloadSubLenSize;
+        rtpTimestamp += 3000;
+        frameCount++;
+        index = (index + 1) % frames.size();
+    }
+    allocations = stopCountingAllocations();
+
+    reportCounters(state, bytes, frameCount, allocations);
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus)) {
+        stopCountingAllocations();
+        state.SkipWithError("rtp packet construction failed");
+    }
+}
+
+// The writeFrame path: single-pass packetization, then the frame bytes are gathered straight into each serialized packet
+BENCHMARK_DEFINE_F(RtpPayloaderBenchmark, BM_GatherRtpPacketsFromDescriptors)(benchmark::State& state)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    std::vector<std::vector<BYTE>> frames;
+    std::vector<RtpPacket> packets;
+    std::vector<BYTE> rawPacket(MAX_UDP_PACKET_SIZE);
+    UINT64 bytes = 0, frameCount = 0, allocations = 0;
+    UINT32 i, rawPacketLen, rtpTimestamp = 0;
+    UINT16 sequenceNumber = 0;
+    SIZE_T index = 0;
+
+    CHK_STATUS(loadH264Frames(frames));
+
+    startCountingAllocations();
+    for (auto _ : state) {
+        auto& frame = frames[index];
+        resetPayloadDescriptorArray(&payloadDescriptors);
+        CHK_STATUS(packetizeH264Frame(DEFAULT_MTU_SIZE_BYTES, frame.data(), (UINT32) frame.size(), &payloadDescriptors));
+        if (packets.size() < payloadDescriptors.descriptorCount) {
+            packets.resize(payloadDescriptors.descriptorCount);
+        }
+        CHK_STATUS(constructRtpPacketsFromDescriptors(&payloadDescriptors, RTP_BENCHMARK_PAYLOAD_TYPE, sequenceNumber, rtpTimestamp,
+                                                      RTP_BENCHMARK_SSRC, packets.data(), payloadDescriptors.descriptorCount));
+        for (i = 0; i < payloadDescriptors.descriptorCount; i++) {
+            rawPacketLen = (UINT32) rawPacket.size();
+            CHK_STATUS(createBytesFromRtpPacketDescriptor(&packets[i], &payloadDescriptors, i, rawPacket.data(), &rawPacketLen));
+            bytes += rawPacketLen;
+        }
+        sequenceNumber += (UINT16) payloadDescriptors.descriptorCount;
+        rtpTimestamp += 3000;
+        frameCount++;
+        index = (index + 1) % frames.size();
+    }
+    allocations = stopCountingAllocations();
+
+    reportCounters(state, bytes, frameCount, allocations);
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus)) {
+        stopCountingAllocations();
+        state.SkipWithError("rtp packet construction failed");
+    }
+}
+
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_CreatePayloadForH264);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_CreatePayloadForH265);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_CreatePayloadForVP8);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_PacketizeH264Frame);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_PacketizeH265Frame);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_PacketizeVP8Frame);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_CreatePayloadForOpusRed)->Arg(1)->Arg(2);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_DepayH264FromRtpPayload);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_DepayH265FromRtpPayload);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_DepayVP8FromRtpPayload);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_DepayOpusFromRtpPayload);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_ConstructAndSerializeRtpPackets);
+BENCHMARK_REGISTER_F(RtpPayloaderBenchmark, BM_GatherRtpPacketsFromDescriptors);
+
+} // namespace webrtcclient
+} // namespace video
+} // namespace kinesis
+} // namespace amazonaws
+} // namespace com
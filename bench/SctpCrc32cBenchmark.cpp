@@ -0,0 +1,62 @@
+#include "WebRTCClientBenchmarkFixture.h"
+
+namespace com {
+namespace amazonaws {
+namespace kinesis {
+namespace video {
+namespace webrtcclient {
+
+typedef UINT32 (*Crc32cBenchmarkFunc)(PBYTE, UINT32);
+
+class SctpCrc32cBenchmark : public WebRtcClientBenchmarkBase {
+  public:
+    VOID run(benchmark::State& state, Crc32cBenchmarkFunc crcFn)
+    {
+        UINT32 dataSize = (UINT32) state.range(0);
+        std::vector<BYTE> data(dataSize);
+        for (UINT32 i = 0; i < dataSize; i++) {
+            data[i] = (BYTE) (i * 31);
+        }
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(crcFn(data.data(), dataSize));
+        }
+        state.SetBytesProcessed((INT64) state.iterations() * dataSize);
+    }
+};
+
+BENCHMARK_DEFINE_F(SctpCrc32cBenchmark, BM_SctpCrc32cBytewise)(benchmark::State& state)
+{
+    run(state, sctpCrc32cBytewise);
+}
+
+BENCHMARK_DEFINE_F(SctpCrc32cBenchmark, BM_SctpCrc32cSlicingBy8)(benchmark::State& state)
+{
+    run(state, sctpCrc32cSlicingBy8);
+}
+
+BENCHMARK_DEFINE_F(SctpCrc32cBenchmark, BM_SctpCrc32cHardware)(benchmark::State& state)
+{
+    if (!sctpCrc32cHardwareAvailable()) {
+        state.SkipWithError("CPU has no CRC32c instruction");
+        return;
+    }
+    run(state, sctpCrc32cHardware);
+}
+
+BENCHMARK_DEFINE_F(SctpCrc32cBenchmark, BM_SctpCrc32cDispatched)(benchmark::State& state)
+{
+    run(state, sctpCrc32c);
+}
+
+// 12 bytes is an empty SCTP common header, 1200 a full data-channel packet
+BENCHMARK_REGISTER_F(SctpCrc32cBenchmark, BM_SctpCrc32cBytewise)->Arg(12)->Arg(64)->Arg(256)->Arg(1200)->Arg(8 << 10);
+BENCHMARK_REGISTER_F(SctpCrc32cBenchmark, BM_SctpCrc32cSlicingBy8)->Arg(12)->Arg(64)->Arg(256)->Arg(1200)->Arg(8 << 10);
+BENCHMARK_REGISTER_F(SctpCrc32cBenchmark, BM_SctpCrc32cHardware)->Arg(12)->Arg(64)->Arg(256)->Arg(1200)->Arg(8 << 10);
+BENCHMARK_REGISTER_F(SctpCrc32cBenchmark, BM_SctpCrc32cDispatched)->Arg(12)->Arg(64)->Arg(256)->Arg(1200)->Arg(8 << 10);
+
+} // namespace webrtcclient
+} // namespace video
+} // namespace kinesis
+} // namespace amazonaws
+} // namespace com
@@ -6,6 +6,11 @@ namespace kinesis {
 namespace video {
 namespace webrtcclient {
 
+std::atomic<UINT64> WebRtcClientBenchmarkBase::sAllocationCount(0);
+memAlloc WebRtcClientBenchmarkBase::sSavedMemAlloc = NULL;
+memCalloc WebRtcClientBenchmarkBase::sSavedMemCalloc = NULL;
+memRealloc WebRtcClientBenchmarkBase::sSavedMemRealloc = NULL;
+
 VOID WebRtcClientBenchmarkBase::SetUp(const ::benchmark::State& state)
 {
     UNUSED_PARAM(state);
@@ -19,6 +24,68 @@ VOID WebRtcClientBenchmarkBase::TearDown(const ::benchmark::State& state)
     deinitKvsWebRtc();
 }
 
+STATUS WebRtcClientBenchmarkBase::loadSampleFrames(PCHAR folder, PCHAR nameFormat, UINT32 firstIndex, UINT32 count,
+                                                   std::vector<std::vector<BYTE>>& frames)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    CHAR fileName[MAX_PATH_LEN + 1];
+    CHAR filePath[MAX_PATH_LEN + 1];
+    UINT64 size;
+    UINT32 i;
+
+    frames.clear();
+    frames.reserve(count);
+    for (i = 0; i < count; i++) {
+        SNPRINTF(fileName, SIZEOF(fileName), nameFormat, firstIndex + i);
+        SNPRINTF(filePath, SIZEOF(filePath), "%s/%s/%s", KVS_BENCHMARK_SAMPLES_DIR, folder, fileName);
+        CHK_STATUS(readFile(filePath, TRUE, NULL, &size));
+        std::vector<BYTE> frame((SIZE_T) size);
+        CHK_STATUS(readFile(filePath, TRUE, frame.data(), &size));
+        frames.push_back(std::move(frame));
+    }
+
+CleanUp:
+
+    return retStatus;
+}
+
+PVOID WebRtcClientBenchmarkBase::countingMemAlloc(SIZE_T size)
+{
+    sAllocationCount++;
+    return sSavedMemAlloc(size);
+}
+
+PVOID WebRtcClientBenchmarkBase::countingMemCalloc(SIZE_T num, SIZE_T size)
+{
+    sAllocationCount++;
+    return sSavedMemCalloc(num, size);
+}
+
+PVOID WebRtcClientBenchmarkBase::countingMemRealloc(PVOID ptr, SIZE_T size)
+{
+    sAllocationCount++;
+    return sSavedMemRealloc(ptr, size);
+}
+
+VOID WebRtcClientBenchmarkBase::startCountingAllocations()
+{
+    sAllocationCount = 0;
+    sSavedMemAlloc = globalMemAlloc;
+    sSavedMemCalloc = globalMemCalloc;
+    sSavedMemRealloc = globalMemRealloc;
+    globalMemAlloc = countingMemAlloc;
+    globalMemCalloc = countingMemCalloc;
+    globalMemRealloc = countingMemRealloc;
+}
+
+UINT64 WebRtcClientBenchmarkBase::stopCountingAllocations()
+{
+    globalMemAlloc = sSavedMemAlloc;
+    globalMemCalloc = sSavedMemCalloc;
+    globalMemRealloc = sSavedMemRealloc;
+    return sAllocationCount;
+}
+
 } // namespace webrtcclient
 } // namespace video
 } // namespace kinesis
@@ -4,9 +4,14 @@
 #include <mutex>
 #include <queue>
 #include <atomic>
+#include <vector>
 
 #define MAX_BENCHMARK_AWAIT_DURATION (2 * HUNDREDS_OF_NANOS_IN_A_SECOND)
 
+#ifndef KVS_BENCHMARK_SAMPLES_DIR
+#define KVS_BENCHMARK_SAMPLES_DIR "../samples"
+#endif
+
 namespace com {
 namespace amazonaws {
 namespace kinesis {
@@ -17,6 +22,23 @@ class WebRtcClientBenchmarkBase : public benchmark::Fixture {
   protected:
     virtual VOID SetUp(const ::benchmark::State& state);
     virtual VOID TearDown(const ::benchmark::State& state);
+
+    // Reads count files named by nameFormat (e.g. "frame-%04d.h264") starting at firstIndex from a samples sub-folder
+    STATUS loadSampleFrames(PCHAR folder, PCHAR nameFormat, UINT32 firstIndex, UINT32 count, std::vector<std::vector<BYTE>>& frames);
+
+    // Routes MEMALLOC/MEMCALLOC/MEMREALLOC through a counter until stopCountingAllocations is called
+    VOID startCountingAllocations();
+    UINT64 stopCountingAllocations();
+
+  private:
+    static PVOID countingMemAlloc(SIZE_T size);
+    static PVOID countingMemCalloc(SIZE_T num, SIZE_T size);
+    static PVOID countingMemRealloc(PVOID ptr, SIZE_T size);
+
+    static std::atomic<UINT64> sAllocationCount;
+    static memAlloc sSavedMemAlloc;
+    static memCalloc sSavedMemCalloc;
+    static memRealloc sSavedMemRealloc;
 };
 
 } // namespace webrtcclient
@@ -190,6 +190,8 @@ extern "C" {
 #define STATUS_CREATE_SOCKET_PAIR_FAILED           STATUS_NETWORKING_BASE + 0x00000027
 #define STATUS_SOCKET_WRITE_FAILED                 STATUS_NETWORKING_BASE + 0X00000028
 #define STATUS_INVALID_ADDRESS_LENGTH              STATUS_NETWORKING_BASE + 0X00000029
+#define STATUS_CREATE_POLL_SET_FAILED              STATUS_NETWORKING_BASE + 0x0000002a
+#define STATUS_POLL_SET_UPDATE_FAILED              STATUS_NETWORKING_BASE + 0x0000002b
 
 /*!@} */
 
@@ -392,6 +394,7 @@ extern "C" {
 #define STATUS_SCTP_BASE                 STATUS_PEERCONNECTION_BASE + 0x01000000
 #define STATUS_SCTP_SESSION_SETUP_FAILED STATUS_SCTP_BASE + 0x00000001
 #define STATUS_SCTP_INVALID_DCEP_PACKET  STATUS_SCTP_BASE + 0x00000002
+#define STATUS_SCTP_MESSAGE_TOO_LARGE    STATUS_SCTP_BASE + 0x00000003
 /*!@} */
 
 /////////////////////////////////////////////////////
@@ -704,6 +707,22 @@ extern "C" {
  */
 #define WEBRTC_THREADPOOL_MAX_THREADS_ENV_VAR (PCHAR) "AWS_KVS_WEBRTC_THREADPOOL_MAX_THREADS"
 
+/**
+ * Env to set the number of threads driving a timer wheel shared by all the peer connections of the process.
+ * Unset or 0 means every peer connection runs its own timer queue thread.
+ */
+#define WEBRTC_TIMER_WHEEL_THREADS_ENV_VAR (PCHAR) "AWS_KVS_WEBRTC_TIMER_WHEEL_THREADS"
+
+/**
+ * Default age after which a pre-generated certificate is replaced, see RtcCertificatePoolConfig
+ */
+#define DEFAULT_RTC_CERTIFICATE_POOL_MAX_AGE (1 * HUNDREDS_OF_NANOS_IN_AN_HOUR)
+
+/**
+ * Maximum number of certificates of each kind kept by the certificate pool
+ */
+#define MAX_RTC_CERTIFICATE_POOL_SIZE 64
+
 /**
  * Env to control whether to use dual stack endpoints, unset means false
  */
@@ -742,6 +761,11 @@ extern "C" {
  * Default jitter buffer tolerated latency, frame will be dropped if it is out of window
  */
 #define DEFAULT_JITTER_BUFFER_MAX_LATENCY (2000L * HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
+
+/**
+ * Default largest data channel message accepted, same as browsers advertise
+ */
+#define DEFAULT_SCTP_MAX_MESSAGE_SIZE 262144
 /*!@} */
 
 /**
@@ -1027,6 +1051,30 @@ typedef enum {
  */
 typedef VOID (*RtcOnFrame)(UINT64, PFrame);
 
+/**
+ * @brief One slice of a received frame handed to RtcOnFrameFragments
+ */
+typedef struct {
+    PBYTE pData;    //!< Fragment bytes. Points into a received packet, or at static storage for start codes. Valid until the callback returns
+    UINT32 size;    //!< Fragment size in bytes
+    BOOL startCode; //!< pData is an Annex-B start code preceding the NAL unit in the next fragment
+} RtcFrameFragment, *PRtcFrameFragment;
+
+/**
+ * @brief RtcOnFrameFragments is fired instead of RtcOnFrame, when registered, with the ordered fragments
+ * a received frame is made of. Concatenating them gives the frame RtcOnFrame would deliver, without the
+ * SDK copying the depayloaded media into a contiguous buffer. The packets the fragments point into are
+ * released once the callback returns.
+ *
+ * NOTE: RtcOnFrameFragments is a KVS specific method
+ *
+ * @param[in] UINT64 User customData passed during registration
+ * @param[in] PFrame Frame timing and index. frameData is NULL and size is the total size of the fragments
+ * @param[in] PRtcFrameFragment Fragments in decode order
+ * @param[in] UINT32 Number of fragments
+ */
+typedef VOID (*RtcOnFrameFragments)(UINT64, PFrame, PRtcFrameFragment, UINT32);
+
 /**
  * @brief RtcOnBandwidthEstimation is fired everytime a bandwidth estimation value
  * is computed. This will be fired for receiver side estimation
@@ -1243,6 +1291,18 @@ typedef struct {
     UINT32 privateKeySize; //!< Size of private key in bytes (optional)
 } RtcCertificate, *PRtcCertificate;
 
+/**
+ * @brief Sizes the process-wide pool of pre-generated DTLS certificates, see initRtcCertificatePool
+ */
+typedef struct {
+    UINT32 ecdsaCertificateCount; //!< ECDSA P-256 certificates kept ready for peer connections with generateRSACertificate unset
+    UINT32 rsaCertificateCount;   //!< RSA certificates kept ready for peer connections with generateRSACertificate set
+    INT32 rsaCertificateBits;     //!< RSA key size of the pooled certificates, 0 for the default 2048. Peer connections asking for
+                                  //!< another generatedCertificateBits value generate their own certificate.
+    UINT64 maxCertificateAge;     //!< Pooled certificates older than this are replaced in the background, 0 for
+                                  //!< DEFAULT_RTC_CERTIFICATE_POOL_MAX_AGE. In 100ns
+} RtcCertificatePoolConfig, *PRtcCertificatePoolConfig;
+
 /**
  *  KvsRtcConfiguration is a collection of non-standard extensions to RTCConfiguration
  *  these exist to serve use cases that currently aren't being served by the W3C standard
@@ -1323,6 +1383,42 @@ typedef struct {
                                                                //!< behind 1:1 NAT / a load balancer where the public IP is not assigned to any
                                                                //!< local interface. Leave empty (default) to emit real interface IPs.
 
+    UINT32 inboundPacketPoolSize; //!< Number of inbound RTP packets per peer connection that are stored in preallocated buffers
+                                  //!< instead of the heap. Packets beyond this count (e.g. a deep jitter buffer at a high bitrate)
+                                  //!< still work but fall back to heap allocations, reported by inboundPacketPoolMisses in
+                                  //!< PeerConnectionStats. If 0, 256 is used.
+
+    UINT32 outboundPacketPoolSize; //!< Number of MTU sized send buffers per peer connection shared by writeFrame, the pacer queue
+                                   //!< and retransmissions. Sized for the packets in flight at once, e.g. a keyframe waiting
+                                   //!< in the pacer. Further buffers come from the heap and are reported by
+                                   //!< outboundPacketPoolMisses in PeerConnectionStats. If 0, 512 is used.
+
+    UINT32 connectionListenerThreadCount; //!< Number of threads receiving on the peer connection sockets. Above 1, the threads are
+                                          //!< shared by all peer connections of the process, each owning its own epoll set, and
+                                          //!< the peer connection that starts them sets the count. All sockets of a peer connection
+                                          //!< are read by the same thread. Values above 64 are clamped. Each peer connection
+                                          //!< keeps its own single thread on platforms without epoll. If 0 or 1, the peer
+                                          //!< connection has its own single thread.
+
+    UINT64 connectionListenerCpuAffinity; //!< Bit mask of CPUs (0..63) the receive threads are pinned to. Thread i runs on the
+                                          //!< i-th set bit, wrapping around when there are more threads than CPUs. Shared threads
+                                          //!< keep the mask of the peer connection that started them.
+                                          //!< Ignored where thread affinity is not supported. If 0, threads are not pinned.
+
+    UINT32 sctpMaxMessageSize; //!< Largest data channel message accepted from the remote peer, advertised to it with the SDP
+                               //!< max-message-size attribute. Larger messages are dropped. Only applies when built with
+                               //!< ENABLE_NATIVE_SCTP, with usrsctp nothing is advertised and incoming messages are not limited.
+                               //!< Messages sent are checked against the size the remote advertises instead. If 0,
+                               //!< DEFAULT_SCTP_MAX_MESSAGE_SIZE (256 KB) is used.
+
+    BOOL enableGccBandwidthEstimation; //!< Run the built-in GCC controller on TWCC feedback. Its target bitrate drives the pacer when
+                                       //!< pacing is enabled with peerConnectionEnablePacing, and is passed to the
+                                       //!< RtcOnBandwidthEstimation callback of every transceiver whenever it changes so encoders can
+                                       //!< follow it. Ignored when disableSenderSideBandwidthEstimation is TRUE. Default: FALSE.
+
+    UINT64 gccMinBitrateBps; //!< Lower bound of the GCC target bitrate. If 0, 100 kbps is used.
+    UINT64 gccMaxBitrateBps; //!< Upper bound of the GCC target bitrate. If 0, 2.5 Mbps is used.
+
 #ifdef ENABLE_STATS_CALCULATION_CONTROL
     BOOL enableIceStats; //!< Control whether ICE agent stats are to be calculated. ENABLE_STATS_CALCULATION_CONTROL compiler flag must be defined
                          //!< to use this member, else stats are enabled by default.
@@ -2066,6 +2162,18 @@ PUBLIC_API STATUS addTransceiver(PRtcPeerConnection, PRtcMediaStreamTrack, PRtcR
  */
 PUBLIC_API STATUS transceiverOnFrame(PRtcRtpTransceiver, UINT64, RtcOnFrame);
 
+/**
+ * @brief Set a callback receiving frames as fragments of the received packets instead of a copied contiguous buffer.
+ * Once set, RtcOnFrame is no longer fired for complete frames of this transceiver.
+ *
+ * @param[in] PRtcRtpTransceiver Populated RtcRtpTransceiver struct
+ * @param[in] UINT64 User customData that will be passed along when RtcOnFrameFragments is called
+ * @param[in] RtcOnFrameFragments User RtcOnFrameFragments callback
+ *
+ * @return STATUS code of the execution. STATUS_SUCCESS on success
+ */
+PUBLIC_API STATUS transceiverOnFrameFragments(PRtcRtpTransceiver, UINT64, RtcOnFrameFragments);
+
 /**
  * @brief Set a callback for partially delivered frames (when some packets are lost/dropped)
  *
@@ -2445,6 +2553,25 @@ PUBLIC_API STATUS createRtcCertificate(PRtcCertificate*);
  */
 PUBLIC_API STATUS freeRtcCertificate(PRtcCertificate);
 
+/**
+ * @brief Starts a process-wide pool of DTLS certificates generated on a background thread. Peer connections created
+ * without RtcConfiguration certificates take one from the pool instead of generating a key pair while being created,
+ * and fall back to generating it when the pool has none left. Must be called after initKvsWebRtc. The pool is
+ * released by deinitRtcCertificatePool or deinitKvsWebRtc.
+ *
+ * @param[in] PRtcCertificatePoolConfig Number and kind of certificates to keep ready
+ *
+ * @return STATUS code of the execution. STATUS_SUCCESS on success
+ */
+PUBLIC_API STATUS initRtcCertificatePool(PRtcCertificatePoolConfig);
+
+/**
+ * @brief Stops the certificate pool and frees the certificates it holds. The call is idempotent
+ *
+ * @return STATUS code of the execution. STATUS_SUCCESS on success
+ */
+PUBLIC_API STATUS deinitRtcCertificatePool(VOID);
+
 /**
  * @brief Requests a key frame from the remote peer.
  *
@@ -669,6 +669,10 @@ typedef struct {
     UINT64 closePeerConnectionTime;    //!< Time taken (ms) to close the peer connection
     UINT64 freePeerConnectionTime;     //!< Time taken (ms) to free the peer connection object
     UINT64 stunDnsResolutionTime;      //!< Time taken (ms) to complete STUN DNS resolution on the thread
+    UINT64 inboundPacketPoolHits;      //!< Inbound RTP packets stored in a preallocated pool buffer
+    UINT64 inboundPacketPoolMisses;    //!< Inbound RTP packets that fell back to a heap allocation (pool exhausted or packet too large)
+    UINT64 outboundPacketPoolHits;     //!< Outbound RTP packet buffers served from the preallocated send pool
+    UINT64 outboundPacketPoolMisses;   //!< Outbound RTP packet buffers that fell back to a heap allocation
 } PeerConnectionStats, *PPeerConnectionStats;
 
 /**
@@ -0,0 +1,324 @@
+#define LOG_CLASS "CertificatePool"
+#include "../Include_i.h"
+
+static PCertificatePool gCertificatePool = NULL;
+// Guards gCertificatePool. Unlike the pool's own lock it outlives the pool, so takers never lock a freed mutex.
+static MUTEX gCertificatePoolLock = INVALID_MUTEX_VALUE;
+
+static STATUS certificatePoolGenerate(PCertificatePool pCertificatePool, CERTIFICATE_POOL_TYPE type, PCertificatePoolEntry pEntry)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT64 startTimeInMacro = 0;
+    BOOL rsa = type == CERTIFICATE_POOL_TYPE_RSA;
+
+    MEMSET(pEntry, 0x00, SIZEOF(CertificatePoolEntry));
+#ifdef KVS_USE_OPENSSL
+    PROFILE_CALL(CHK_STATUS(createCertificateAndKey(pCertificatePool->rsaCertificateBits, rsa, &pEntry->certInfo.pCert, &pEntry->certInfo.pKey)),
+                 "Pooled certificate creation time");
+    pEntry->certInfo.created = TRUE;
+#elif KVS_USE_MBEDTLS
+    PROFILE_CALL(CHK_STATUS(createCertificateAndKey(pCertificatePool->rsaCertificateBits, rsa, &pEntry->certInfo.cert, &pEntry->certInfo.privateKey)),
+                 "Pooled certificate creation time");
+#else
+#error "A Crypto implementation is required."
+#endif
+    pEntry->createTime = GETTIME();
+
+CleanUp:
+
+    return retStatus;
+}
+
+static VOID certificatePoolFreeEntry(PCertificatePoolEntry pEntry)
+{
+#ifdef KVS_USE_OPENSSL
+    freeCertificateAndKey(&pEntry->certInfo.pCert, &pEntry->certInfo.pKey);
+#elif KVS_USE_MBEDTLS
+    freeCertificateAndKey(&pEntry->certInfo.cert, &pEntry->certInfo.privateKey);
+#else
+#error "A Crypto implementation is required."
+#endif
+    MEMSET(pEntry, 0x00, SIZEOF(CertificatePoolEntry));
+}
+
+// Drops the certificates that outlived maxCertificateAge. Oldest are at the head, so this stops at the first fresh one.
+static VOID certificatePoolRotate(PCertificatePool pCertificatePool, PCertificatePoolRing pRing, UINT64 now)
+{
+    PCertificatePoolEntry pEntry;
+
+    while (pRing->count != 0) {
+        pEntry = &pRing->entries[pRing->head];
+        if (pEntry->createTime + pCertificatePool->maxCertificateAge > now) {
+            break;
+        }
+
+        certificatePoolFreeEntry(pEntry);
+        pRing->head = (pRing->head + 1) % MAX_RTC_CERTIFICATE_POOL_SIZE;
+        pRing->count--;
+        pCertificatePool->rotatedCount++;
+    }
+}
+
+static PVOID certificatePoolRefillRoutine(PVOID args)
+{
+    STATUS retStatus;
+    PCertificatePool pCertificatePool = (PCertificatePool) args;
+    PCertificatePoolRing pRing;
+    CertificatePoolEntry entry;
+    CERTIFICATE_POOL_TYPE type;
+    UINT64 now, nextRotation;
+
+    MUTEX_LOCK(pCertificatePool->lock);
+    while (!ATOMIC_LOAD_BOOL(&pCertificatePool->shutdown)) {
+        now = GETTIME();
+        nextRotation = MAX_UINT64;
+        for (type = 0; type < CERTIFICATE_POOL_TYPE_COUNT; type++) {
+            pRing = &pCertificatePool->rings[type];
+            certificatePoolRotate(pCertificatePool, pRing, now);
+            if (pRing->count != 0) {
+                nextRotation = MIN(nextRotation, pRing->entries[pRing->head].createTime + pCertificatePool->maxCertificateAge);
+            }
+        }
+
+        // ECDSA first, it is the default and takes a fraction of the time of an RSA key
+        for (type = 0; type < CERTIFICATE_POOL_TYPE_COUNT && pCertificatePool->rings[type].count >= pCertificatePool->rings[type].targetCount;
+             type++) {
+        }
+
+        if (type == CERTIFICATE_POOL_TYPE_COUNT) {
+            CVAR_WAIT(pCertificatePool->cvar, pCertificatePool->lock, nextRotation == MAX_UINT64 ? INFINITE_TIME_VALUE : nextRotation - now);
+            continue;
+        }
+
+        // Generate without holding the lock so peer connections can keep taking certificates
+        MUTEX_UNLOCK(pCertificatePool->lock);
+        retStatus = certificatePoolGenerate(pCertificatePool, type, &entry);
+        MUTEX_LOCK(pCertificatePool->lock);
+
+        if (STATUS_FAILED(retStatus)) {
+            DLOGW("Failed to generate a pooled certificate with 0x%08x", retStatus);
+            if (!ATOMIC_LOAD_BOOL(&pCertificatePool->shutdown)) {
+                CVAR_WAIT(pCertificatePool->cvar, pCertificatePool->lock, CERTIFICATE_POOL_RETRY_DELAY);
+            }
+        } else if (ATOMIC_LOAD_BOOL(&pCertificatePool->shutdown)) {
+            certificatePoolFreeEntry(&entry);
+        } else {
+            pRing = &pCertificatePool->rings[type];
+            pRing->entries[(pRing->head + pRing->count) % MAX_RTC_CERTIFICATE_POOL_SIZE] = entry;
+            pRing->count++;
+        }
+    }
+    MUTEX_UNLOCK(pCertificatePool->lock);
+
+    return NULL;
+}
+
+STATUS createCertificatePoolLock(VOID)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(!IS_VALID_MUTEX_VALUE(gCertificatePoolLock), retStatus);
+    gCertificatePoolLock = MUTEX_CREATE(FALSE);
+    CHK(IS_VALID_MUTEX_VALUE(gCertificatePoolLock), STATUS_INVALID_OPERATION);
+
+CleanUp:
+
+    return retStatus;
+}
+
+VOID freeCertificatePoolLock(VOID)
+{
+    if (IS_VALID_MUTEX_VALUE(gCertificatePoolLock)) {
+        MUTEX_FREE(gCertificatePoolLock);
+        gCertificatePoolLock = INVALID_MUTEX_VALUE;
+    }
+}
+
+STATUS initRtcCertificatePool(PRtcCertificatePoolConfig pConfig)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PCertificatePool pCertificatePool = NULL;
+    BOOL locked = FALSE;
+
+    CHK(pConfig != NULL, STATUS_NULL_ARG);
+    CHK(pConfig->ecdsaCertificateCount <= MAX_RTC_CERTIFICATE_POOL_SIZE && pConfig->rsaCertificateCount <= MAX_RTC_CERTIFICATE_POOL_SIZE &&
+            pConfig->rsaCertificateBits >= 0,
+        STATUS_INVALID_ARG);
+    CHK_ERR(IS_VALID_MUTEX_VALUE(gCertificatePoolLock), STATUS_INVALID_OPERATION, "initKvsWebRtc has to be called first");
+
+    MUTEX_LOCK(gCertificatePoolLock);
+    locked = TRUE;
+    CHK_ERR(gCertificatePool == NULL, STATUS_INVALID_OPERATION, "Certificate pool already initialized");
+
+    CHK(NULL != (pCertificatePool = (PCertificatePool) MEMCALLOC(1, SIZEOF(CertificatePool))), STATUS_NOT_ENOUGH_MEMORY);
+    pCertificatePool->refillTid = INVALID_TID_VALUE;
+    pCertificatePool->rsaCertificateBits = pConfig->rsaCertificateBits == 0 ? GENERATED_CERTIFICATE_BITS : pConfig->rsaCertificateBits;
+    pCertificatePool->maxCertificateAge = pConfig->maxCertificateAge == 0 ? DEFAULT_RTC_CERTIFICATE_POOL_MAX_AGE : pConfig->maxCertificateAge;
+    pCertificatePool->rings[CERTIFICATE_POOL_TYPE_ECDSA].targetCount = pConfig->ecdsaCertificateCount;
+    pCertificatePool->rings[CERTIFICATE_POOL_TYPE_RSA].targetCount = pConfig->rsaCertificateCount;
+    ATOMIC_STORE_BOOL(&pCertificatePool->shutdown, FALSE);
+
+    pCertificatePool->lock = MUTEX_CREATE(FALSE);
+    CHK(IS_VALID_MUTEX_VALUE(pCertificatePool->lock), STATUS_INVALID_OPERATION);
+    pCertificatePool->cvar = CVAR_CREATE();
+    CHK(IS_VALID_CVAR_VALUE(pCertificatePool->cvar), STATUS_INVALID_OPERATION);
+    CHK_STATUS(THREAD_CREATE(&pCertificatePool->refillTid, certificatePoolRefillRoutine, (PVOID) pCertificatePool));
+
+    gCertificatePool = pCertificatePool;
+    DLOGI("Certificate pool keeping %u ECDSA and %u RSA certificates ready", pConfig->ecdsaCertificateCount, pConfig->rsaCertificateCount);
+
+CleanUp:
+
+    if (locked) {
+        MUTEX_UNLOCK(gCertificatePoolLock);
+    }
+
+    CHK_LOG_ERR(retStatus);
+
+    if (STATUS_FAILED(retStatus) && pCertificatePool != NULL) {
+        if (IS_VALID_CVAR_VALUE(pCertificatePool->cvar)) {
+            CVAR_FREE(pCertificatePool->cvar);
+        }
+        if (IS_VALID_MUTEX_VALUE(pCertificatePool->lock)) {
+            MUTEX_FREE(pCertificatePool->lock);
+        }
+        MEMFREE(pCertificatePool);
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS deinitRtcCertificatePool(VOID)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PCertificatePool pCertificatePool = NULL;
+    PCertificatePoolRing pRing;
+    UINT32 type;
+
+    CHK(IS_VALID_MUTEX_VALUE(gCertificatePoolLock), retStatus);
+
+    // Once swapped out no taker can reach the pool, and the ones that did have released it
+    MUTEX_LOCK(gCertificatePoolLock);
+    pCertificatePool = gCertificatePool;
+    gCertificatePool = NULL;
+    MUTEX_UNLOCK(gCertificatePoolLock);
+    CHK(pCertificatePool != NULL, retStatus);
+
+    // Waits for a key generation in progress to finish
+    MUTEX_LOCK(pCertificatePool->lock);
+    ATOMIC_STORE_BOOL(&pCertificatePool->shutdown, TRUE);
+    CVAR_SIGNAL(pCertificatePool->cvar);
+    MUTEX_UNLOCK(pCertificatePool->lock);
+    THREAD_JOIN(pCertificatePool->refillTid, NULL);
+
+    for (type = 0; type < CERTIFICATE_POOL_TYPE_COUNT; type++) {
+        pRing = &pCertificatePool->rings[type];
+        for (; pRing->count != 0; pRing->count--) {
+            certificatePoolFreeEntry(&pRing->entries[pRing->head]);
+            pRing->head = (pRing->head + 1) % MAX_RTC_CERTIFICATE_POOL_SIZE;
+        }
+    }
+
+    DLOGI("Certificate pool handed out %" PRIu64 " certificates, missed %" PRIu64 " requests and rotated %" PRIu64 " certificates",
+          pCertificatePool->takenCount, pCertificatePool->missedCount, pCertificatePool->rotatedCount);
+
+    CVAR_FREE(pCertificatePool->cvar);
+    MUTEX_FREE(pCertificatePool->lock);
+    MEMFREE(pCertificatePool);
+
+CleanUp:
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS certificatePoolGetStats(PCertificatePoolStats pStats)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PCertificatePool pCertificatePool = NULL;
+    BOOL globalLocked = FALSE;
+    UINT32 i;
+
+    CHK(pStats != NULL, STATUS_NULL_ARG);
+    CHK(IS_VALID_MUTEX_VALUE(gCertificatePoolLock), STATUS_INVALID_OPERATION);
+
+    MUTEX_LOCK(gCertificatePoolLock);
+    globalLocked = TRUE;
+    pCertificatePool = gCertificatePool;
+    CHK(pCertificatePool != NULL, STATUS_INVALID_OPERATION);
+
+    MUTEX_LOCK(pCertificatePool->lock);
+    for (i = 0; i < CERTIFICATE_POOL_TYPE_COUNT; i++) {
+        pStats->readyCounts[i] = pCertificatePool->rings[i].count;
+    }
+    pStats->takenCount = pCertificatePool->takenCount;
+    pStats->missedCount = pCertificatePool->missedCount;
+    pStats->rotatedCount = pCertificatePool->rotatedCount;
+    MUTEX_UNLOCK(pCertificatePool->lock);
+
+CleanUp:
+
+    if (globalLocked) {
+        MUTEX_UNLOCK(gCertificatePoolLock);
+    }
+
+    return retStatus;
+}
+
+STATUS certificatePoolTake(BOOL rsa, INT32 certificateBits, PDtlsSessionCertificateInfo pCertInfo, PBOOL pTaken)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PCertificatePool pCertificatePool = NULL;
+    PCertificatePoolRing pRing;
+    BOOL globalLocked = FALSE, locked = FALSE;
+
+    CHK(pCertInfo != NULL && pTaken != NULL, STATUS_NULL_ARG);
+    *pTaken = FALSE;
+    CHK(IS_VALID_MUTEX_VALUE(gCertificatePoolLock), retStatus);
+
+    // Held until the certificate is out so deinitRtcCertificatePool can't free the pool underneath
+    MUTEX_LOCK(gCertificatePoolLock);
+    globalLocked = TRUE;
+    pCertificatePool = gCertificatePool;
+    CHK(pCertificatePool != NULL, retStatus);
+
+    MUTEX_LOCK(pCertificatePool->lock);
+    locked = TRUE;
+
+    if (rsa && certificateBits != pCertificatePool->rsaCertificateBits) {
+        pCertificatePool->missedCount++;
+        CHK(FALSE, retStatus);
+    }
+
+    pRing = &pCertificatePool->rings[rsa ? CERTIFICATE_POOL_TYPE_RSA : CERTIFICATE_POOL_TYPE_ECDSA];
+    // The refill thread may not have caught up with the rotation yet
+    certificatePoolRotate(pCertificatePool, pRing, GETTIME());
+    if (pRing->count == 0) {
+        pCertificatePool->missedCount++;
+        CHK(FALSE, retStatus);
+    }
+
+    *pCertInfo = pRing->entries[pRing->head].certInfo;
+    MEMSET(&pRing->entries[pRing->head], 0x00, SIZEOF(CertificatePoolEntry));
+    pRing->head = (pRing->head + 1) % MAX_RTC_CERTIFICATE_POOL_SIZE;
+    pRing->count--;
+    pCertificatePool->takenCount++;
+    *pTaken = TRUE;
+
+    CVAR_SIGNAL(pCertificatePool->cvar);
+
+CleanUp:
+
+    if (locked) {
+        MUTEX_UNLOCK(pCertificatePool->lock);
+    }
+
+    if (globalLocked) {
+        MUTEX_UNLOCK(gCertificatePoolLock);
+    }
+
+    return retStatus;
+}
@@ -0,0 +1,94 @@
+//
+// Pre-generated DTLS certificate pool
+//
+
+#ifndef __KINESIS_VIDEO_WEBRTC_CLIENT_CRYPTO_CERTIFICATE_POOL__
+#define __KINESIS_VIDEO_WEBRTC_CLIENT_CRYPTO_CERTIFICATE_POOL__
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Delay before generating again after a failed key generation
+#define CERTIFICATE_POOL_RETRY_DELAY (1 * HUNDREDS_OF_NANOS_IN_A_SECOND)
+
+typedef enum {
+    CERTIFICATE_POOL_TYPE_ECDSA,
+    CERTIFICATE_POOL_TYPE_RSA,
+    CERTIFICATE_POOL_TYPE_COUNT,
+} CERTIFICATE_POOL_TYPE;
+
+typedef struct {
+    DtlsSessionCertificateInfo certInfo;
+    UINT64 createTime;
+} CertificatePoolEntry, *PCertificatePoolEntry;
+
+// FIFO of ready certificates of one kind. The oldest is handed out first so certificates rarely age out unused.
+typedef struct {
+    CertificatePoolEntry entries[MAX_RTC_CERTIFICATE_POOL_SIZE];
+    UINT32 head;
+    UINT32 count;
+    UINT32 targetCount;
+} CertificatePoolRing, *PCertificatePoolRing;
+
+typedef struct {
+    MUTEX lock;
+    CVAR cvar; //!< Signaled when a certificate is taken and on shutdown
+    TID refillTid;
+    volatile ATOMIC_BOOL shutdown;
+    INT32 rsaCertificateBits;
+    UINT64 maxCertificateAge;
+    CertificatePoolRing rings[CERTIFICATE_POOL_TYPE_COUNT];
+    UINT64 takenCount;   //!< Certificates handed out
+    UINT64 missedCount;  //!< Requests the pool could not serve
+    UINT64 rotatedCount; //!< Certificates dropped for being older than maxCertificateAge
+} CertificatePool, *PCertificatePool;
+
+// Snapshot of the pool counters
+typedef struct {
+    UINT32 readyCounts[CERTIFICATE_POOL_TYPE_COUNT]; //!< Certificates ready to be handed out, per kind
+    UINT64 takenCount;                               //!< Certificates handed out
+    UINT64 missedCount;                              //!< Requests the pool could not serve
+    UINT64 rotatedCount;                             //!< Certificates dropped for being older than maxCertificateAge
+} CertificatePoolStats, *PCertificatePoolStats;
+
+/**
+ * Takes a ready certificate matching the request out of the process-wide pool. The caller owns the certificate
+ * and key afterwards and releases them with freeCertificateAndKey.
+ *
+ * @param - BOOL - IN - RSA instead of ECDSA
+ * @param - INT32 - IN - RSA key size, ignored for ECDSA
+ * @param - PDtlsSessionCertificateInfo - OUT - Certificate and key, left untouched when none is available
+ * @param - PBOOL - OUT - Whether a certificate was taken. FALSE when the pool is not started, empty or sized differently
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS certificatePoolTake(BOOL, INT32, PDtlsSessionCertificateInfo, PBOOL);
+
+/**
+ * Creates the lock guarding the process-wide pool pointer, called by initKvsWebRtc
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS createCertificatePoolLock(VOID);
+
+/**
+ * Frees the lock guarding the process-wide pool pointer, called by deinitKvsWebRtc once the pool is released
+ */
+VOID freeCertificatePoolLock(VOID);
+
+/**
+ * Copies the counters of the process-wide pool
+ *
+ * @param - PCertificatePoolStats - OUT - Pool counters
+ *
+ * @return - STATUS code of the execution, STATUS_INVALID_OPERATION when initRtcCertificatePool has not been called
+ */
+STATUS certificatePoolGetStats(PCertificatePoolStats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __KINESIS_VIDEO_WEBRTC_CLIENT_CRYPTO_CERTIFICATE_POOL__ */
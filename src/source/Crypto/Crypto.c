@@ -79,3 +79,191 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+#define KVS_HMAC_INNER_PAD 0x36
+#define KVS_HMAC_OUTER_PAD 0x5c
+
+static STATUS kvsSha1Starts(KvsSha1Context* pContext)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+#ifdef KVS_USE_OPENSSL
+    if (*pContext == NULL) {
+        CHK(NULL != (*pContext = EVP_MD_CTX_new()), STATUS_NOT_ENOUGH_MEMORY);
+    }
+    CHK(EVP_DigestInit_ex(*pContext, EVP_sha1(), NULL) == 1, STATUS_HMAC_GENERATION_ERROR);
+#elif KVS_USE_MBEDTLS
+    mbedtls_sha1_init(pContext);
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    CHK(mbedtls_sha1_starts(pContext) == 0, STATUS_HMAC_GENERATION_ERROR);
+#else
+    CHK(mbedtls_sha1_starts_ret(pContext) == 0, STATUS_HMAC_GENERATION_ERROR);
+#endif
+#else
+#error "A Crypto implementation is required."
+#endif
+
+CleanUp:
+
+    return retStatus;
+}
+
+static STATUS kvsSha1Update(KvsSha1Context* pContext, PBYTE pData, UINT32 dataLen)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+#ifdef KVS_USE_OPENSSL
+    CHK(EVP_DigestUpdate(*pContext, pData, dataLen) == 1, STATUS_HMAC_GENERATION_ERROR);
+#elif KVS_USE_MBEDTLS
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    CHK(mbedtls_sha1_update(pContext, pData, dataLen) == 0, STATUS_HMAC_GENERATION_ERROR);
+#else
+    CHK(mbedtls_sha1_update_ret(pContext, pData, dataLen) == 0, STATUS_HMAC_GENERATION_ERROR);
+#endif
+#else
+#error "A Crypto implementation is required."
+#endif
+
+CleanUp:
+
+    return retStatus;
+}
+
+static STATUS kvsSha1Finish(KvsSha1Context* pContext, PBYTE pDigest)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+#ifdef KVS_USE_OPENSSL
+    CHK(EVP_DigestFinal_ex(*pContext, pDigest, NULL) == 1, STATUS_HMAC_GENERATION_ERROR);
+#elif KVS_USE_MBEDTLS
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    CHK(mbedtls_sha1_finish(pContext, pDigest) == 0, STATUS_HMAC_GENERATION_ERROR);
+#else
+    CHK(mbedtls_sha1_finish_ret(pContext, pDigest) == 0, STATUS_HMAC_GENERATION_ERROR);
+#endif
+#else
+#error "A Crypto implementation is required."
+#endif
+
+CleanUp:
+
+    return retStatus;
+}
+
+// Resumes pDestination from the state absorbed so far by pSource
+static STATUS kvsSha1Clone(KvsSha1Context* pDestination, KvsSha1Context* pSource)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+#ifdef KVS_USE_OPENSSL
+    if (*pDestination == NULL) {
+        CHK(NULL != (*pDestination = EVP_MD_CTX_new()), STATUS_NOT_ENOUGH_MEMORY);
+    }
+    CHK(EVP_MD_CTX_copy_ex(*pDestination, *pSource) == 1, STATUS_HMAC_GENERATION_ERROR);
+#elif KVS_USE_MBEDTLS
+    mbedtls_sha1_init(pDestination);
+    mbedtls_sha1_clone(pDestination, pSource);
+#else
+#error "A Crypto implementation is required."
+#endif
+
+CleanUp:
+
+    return retStatus;
+}
+
+static VOID kvsSha1Free(KvsSha1Context* pContext)
+{
+#ifdef KVS_USE_OPENSSL
+    EVP_MD_CTX_free(*pContext);
+    *pContext = NULL;
+#elif KVS_USE_MBEDTLS
+    mbedtls_sha1_free(pContext);
+#else
+#error "A Crypto implementation is required."
+#endif
+}
+
+STATUS kvsHmacSha1KeyInit(PKvsHmacSha1Key pKey, PBYTE key, UINT32 keyLen)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    BYTE block[KVS_SHA1_BLOCK_LENGTH], pad[KVS_SHA1_BLOCK_LENGTH];
+    KvsSha1Context context;
+    UINT32 i;
+
+    MEMSET(&context, 0x00, SIZEOF(context));
+    MEMSET(block, 0x00, SIZEOF(block));
+    MEMSET(pad, 0x00, SIZEOF(pad));
+    CHK(pKey != NULL && (key != NULL || keyLen == 0), STATUS_NULL_ARG);
+
+    // Keys longer than a block are hashed down first, https://tools.ietf.org/html/rfc2104#section-2
+    if (keyLen > KVS_SHA1_BLOCK_LENGTH) {
+        CHK_STATUS(kvsSha1Starts(&context));
+        CHK_STATUS(kvsSha1Update(&context, key, keyLen));
+        CHK_STATUS(kvsSha1Finish(&context, block));
+    } else if (keyLen != 0) {
+        MEMCPY(block, key, keyLen);
+    }
+
+    for (i = 0; i < KVS_SHA1_BLOCK_LENGTH; i++) {
+        pad[i] = block[i] ^ KVS_HMAC_INNER_PAD;
+    }
+    CHK_STATUS(kvsSha1Starts(&pKey->innerContext));
+    CHK_STATUS(kvsSha1Update(&pKey->innerContext, pad, KVS_SHA1_BLOCK_LENGTH));
+
+    for (i = 0; i < KVS_SHA1_BLOCK_LENGTH; i++) {
+        pad[i] = block[i] ^ KVS_HMAC_OUTER_PAD;
+    }
+    CHK_STATUS(kvsSha1Starts(&pKey->outerContext));
+    CHK_STATUS(kvsSha1Update(&pKey->outerContext, pad, KVS_SHA1_BLOCK_LENGTH));
+
+CleanUp:
+
+    kvsSha1Free(&context);
+
+    // Don't leave key material on the stack
+    MEMSET(block, 0x00, SIZEOF(block));
+    MEMSET(pad, 0x00, SIZEOF(pad));
+
+    return retStatus;
+}
+
+STATUS kvsHmacSha1(PKvsHmacSha1Key pKey, PBYTE pMessage, UINT32 messageLen, PBYTE pDigest)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    BYTE innerDigest[KVS_SHA1_DIGEST_LENGTH];
+    KvsSha1Context context;
+
+    MEMSET(&context, 0x00, SIZEOF(context));
+    CHK(pKey != NULL && (pMessage != NULL || messageLen == 0) && pDigest != NULL, STATUS_NULL_ARG);
+
+    // Work on a copy so the key schedule keeps the absorbed pads for the next message
+    CHK_STATUS(kvsSha1Clone(&context, &pKey->innerContext));
+    CHK_STATUS(kvsSha1Update(&context, pMessage, messageLen));
+    CHK_STATUS(kvsSha1Finish(&context, innerDigest));
+
+    CHK_STATUS(kvsSha1Clone(&context, &pKey->outerContext));
+    CHK_STATUS(kvsSha1Update(&context, innerDigest, KVS_SHA1_DIGEST_LENGTH));
+    CHK_STATUS(kvsSha1Finish(&context, pDigest));
+
+CleanUp:
+
+    kvsSha1Free(&context);
+
+    return retStatus;
+}
+
+STATUS kvsHmacSha1KeyFree(PKvsHmacSha1Key pKey)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pKey != NULL, STATUS_NULL_ARG);
+
+    kvsSha1Free(&pKey->innerContext);
+    kvsSha1Free(&pKey->outerContext);
+    MEMSET(pKey, 0x00, SIZEOF(KvsHmacSha1Key));
+
+CleanUp:
+
+    return retStatus;
+}
@@ -31,6 +31,9 @@ typedef enum {
     KVS_SRTP_PROFILE_AES128_CM_HMAC_SHA1_80 = SRTP_AES128_CM_SHA1_80,
     KVS_SRTP_PROFILE_AES128_CM_HMAC_SHA1_32 = SRTP_AES128_CM_SHA1_32,
 } KVS_SRTP_PROFILE;
+
+// The low level SHA1_* calls are deprecated on OpenSSL 3, digest states are held as EVP contexts
+typedef EVP_MD_CTX* KvsSha1Context;
 #elif KVS_USE_MBEDTLS
 #define KVS_RSA_F4             0x10001L
 #define KVS_MD5_DIGEST_LENGTH  16
@@ -59,10 +62,56 @@ typedef enum {
     KVS_SRTP_PROFILE_AES128_CM_HMAC_SHA1_80 = MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_80,
     KVS_SRTP_PROFILE_AES128_CM_HMAC_SHA1_32 = MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_32,
 } KVS_SRTP_PROFILE;
+
+typedef mbedtls_sha1_context KvsSha1Context;
 #else
 #error "A Crypto implementation is required."
 #endif
 
+#define KVS_SHA1_BLOCK_LENGTH 64
+
+/**
+ * HMAC-SHA1 key schedule: the SHA1 states after absorbing the inner and the outer padded key.
+ * Computing a MAC from it skips the key padding and two of the block compressions KVS_SHA1_HMAC pays per message.
+ * The states may own allocations, a key schedule must start zeroed and is released with kvsHmacSha1KeyFree.
+ */
+typedef struct {
+    KvsSha1Context innerContext;
+    KvsSha1Context outerContext;
+} KvsHmacSha1Key, *PKvsHmacSha1Key;
+
+/**
+ * Precomputes the HMAC-SHA1 key schedule for a key. An already initialized key schedule is reused for the new key.
+ *
+ * @param - PKvsHmacSha1Key - IN/OUT - Zeroed or previously initialized key schedule
+ * @param - PBYTE - IN - Key
+ * @param - UINT32 - IN - Key length in bytes
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS kvsHmacSha1KeyInit(PKvsHmacSha1Key, PBYTE, UINT32);
+
+/**
+ * Computes HMAC-SHA1 of a message with a precomputed key schedule. The key schedule is not modified.
+ *
+ * @param - PKvsHmacSha1Key - IN - Key schedule from kvsHmacSha1KeyInit
+ * @param - PBYTE - IN - Message
+ * @param - UINT32 - IN - Message length in bytes
+ * @param - PBYTE - OUT - KVS_SHA1_DIGEST_LENGTH bytes of digest
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS kvsHmacSha1(PKvsHmacSha1Key, PBYTE, UINT32, PBYTE);
+
+/**
+ * Releases the states held by a key schedule and leaves it zeroed. Freeing a zeroed key schedule is a no-op.
+ *
+ * @param - PKvsHmacSha1Key - IN/OUT - Key schedule to release
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS kvsHmacSha1KeyFree(PKvsHmacSha1Key);
+
 #ifdef __cplusplus
 }
 #endif
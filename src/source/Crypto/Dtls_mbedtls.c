@@ -16,6 +16,7 @@ STATUS createDtlsSession(PDtlsSessionCallbacks pDtlsSessionCallbacks, TIMER_QUEU
     PDtlsSession pDtlsSession = NULL;
     PDtlsSessionCertificateInfo pCertInfo;
     UINT32 i, certCount;
+    BOOL pooled = FALSE;
 
     CHK(ppDtlsSession != NULL && pDtlsSessionCallbacks != NULL, STATUS_NULL_ARG);
     CHK_STATUS(dtlsValidateRtcCertificates(pRtcCertificates, &certCount));
@@ -41,8 +42,11 @@ STATUS createDtlsSession(PDtlsSessionCallbacks pDtlsSessionCallbacks, TIMER_QUEU
     }
 
     if (certCount == 0) {
-        CHK_STATUS(createCertificateAndKey(certificateBits, generateRSACertificate, &pDtlsSession->certificates[0].cert,
-                                           &pDtlsSession->certificates[0].privateKey));
+        CHK_STATUS(certificatePoolTake(generateRSACertificate, certificateBits, &pDtlsSession->certificates[0], &pooled));
+        if (!pooled) {
+            CHK_STATUS(createCertificateAndKey(certificateBits, generateRSACertificate, &pDtlsSession->certificates[0].cert,
+                                               &pDtlsSession->certificates[0].privateKey));
+        }
         pDtlsSession->certificateCount = 1;
     } else {
         for (i = 0; i < certCount; i++) {
@@ -87,7 +91,7 @@ STATUS freeDtlsSession(PDtlsSession* ppDtlsSession)
     CHK(pDtlsSession != NULL, retStatus);
 
     if (pDtlsSession->timerId != MAX_UINT32) {
-        timerQueueCancelTimer(pDtlsSession->timerQueueHandle, pDtlsSession->timerId, (UINT64) pDtlsSession);
+        kvsTimerQueueCancelTimer(pDtlsSession->timerQueueHandle, pDtlsSession->timerId, (UINT64) pDtlsSession);
     }
 
     for (i = 0; i < pDtlsSession->certificateCount; i++) {
@@ -336,8 +340,8 @@ STATUS dtlsSessionStart(PDtlsSession pDtlsSession, BOOL isServer)
 
     // Start non-blocking handshaking
     pDtlsSession->dtlsSessionStartTime = GETTIME();
-    CHK_STATUS(timerQueueAddTimer(pDtlsSession->timerQueueHandle, DTLS_SESSION_TIMER_START_DELAY, DTLS_TRANSMISSION_INTERVAL,
-                                  dtlsTransmissionTimerCallback, (UINT64) pDtlsSession, &pDtlsSession->timerId));
+    CHK_STATUS(kvsTimerQueueAddTimer(pDtlsSession->timerQueueHandle, DTLS_SESSION_TIMER_START_DELAY, DTLS_TRANSMISSION_INTERVAL,
+                                     dtlsTransmissionTimerCallback, (UINT64) pDtlsSession, &pDtlsSession->timerId));
 
 CleanUp:
     if (locked) {
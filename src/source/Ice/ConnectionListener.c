@@ -2,35 +2,134 @@
  * Kinesis Video Producer ConnectionListener
  */
 #define LOG_CLASS "ConnectionListener"
+#if (defined(HAVE_RECVMMSG) || defined(HAVE_SCHED_SETAFFINITY)) && !defined(_GNU_SOURCE)
+// recvmmsg, struct mmsghdr and the cpu_set_t macros are GNU extensions
+#define _GNU_SOURCE
+#endif
 #include "../Include_i.h"
 
+#if defined(HAVE_RECVMMSG)
+/**
+ * Preallocated receive ring drained with a single recvmmsg call. Every slot owns a datagram buffer and a source
+ * address, the message headers point at them once at creation time.
+ */
+struct __ConnectionListenerRecvRing {
+    struct mmsghdr messages[CONNECTION_LISTENER_RECV_BATCH_SIZE];
+    struct iovec iovecs[CONNECTION_LISTENER_RECV_BATCH_SIZE];
+    struct sockaddr_storage srcAddrs[CONNECTION_LISTENER_RECV_BATCH_SIZE];
+    BYTE buffers[CONNECTION_LISTENER_RECV_BATCH_SIZE][CONNECTION_LISTENER_RECV_SLOT_SIZE];
+};
+#endif
+
+// Guards the process-wide listener and its attach count. Unlike the listener it lives as long as the library is initialized.
+static MUTEX gSharedConnectionListenerLock = INVALID_MUTEX_VALUE;
+#if defined(HAVE_EPOLL)
+static PConnectionListener gSharedConnectionListener = NULL;
+static UINT32 gSharedConnectionListenerAttachCount = 0;
+#endif
+
 STATUS createConnectionListener(PConnectionListener* ppConnectionListener)
+{
+    return createConnectionListenerWithParams(1, 0, ppConnectionListener);
+}
+
+STATUS createConnectionListenerWithParams(UINT32 threadCount, UINT64 cpuAffinity, PConnectionListener* ppConnectionListener)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    UINT32 allocationSize = SIZEOF(ConnectionListener) + MAX_UDP_PACKET_SIZE;
     PConnectionListener pConnectionListener = NULL;
+    PConnectionListenerShard pShard;
+    UINT32 i;
+#if defined(HAVE_RECVMMSG)
+    PConnectionListenerRecvRing pRecvRing;
+    UINT32 j;
+#endif
+#if defined(HAVE_EPOLL)
+    struct epoll_event event;
+#endif
 
     CHK(ppConnectionListener != NULL, STATUS_NULL_ARG);
 
-    pConnectionListener = (PConnectionListener) MEMCALLOC(1, allocationSize);
+    pConnectionListener = (PConnectionListener) MEMCALLOC(1, SIZEOF(ConnectionListener));
     CHK(pConnectionListener != NULL, STATUS_NOT_ENOUGH_MEMORY);
 
     ATOMIC_STORE_BOOL(&pConnectionListener->terminate, FALSE);
     pConnectionListener->receiveDataRoutine = INVALID_TID_VALUE;
     pConnectionListener->lock = MUTEX_CREATE(FALSE);
+    pConnectionListener->cpuAffinity = cpuAffinity;
 
     // No sockets are present
     pConnectionListener->socketCount = 0;
 
-    // pConnectionListener->pBuffer starts at the end of ConnectionListener struct
-    pConnectionListener->pBuffer = (PBYTE) (pConnectionListener + 1);
-    pConnectionListener->bufferLen = MAX_UDP_PACKET_SIZE;
-
-    // Use socketpair only if available
 #if defined(HAVE_SOCKETPAIR)
     pConnectionListener->kickSocket[CONNECTION_LISTENER_KICK_SOCKET_LISTEN] = -1;
     pConnectionListener->kickSocket[CONNECTION_LISTENER_KICK_SOCKET_WRITE] = -1;
+#endif
+
+#if defined(HAVE_EPOLL)
+    pConnectionListener->shardCount = MAX(1, MIN(threadCount, CONNECTION_LISTENER_MAX_THREAD_COUNT));
+#else
+    // A single poll() thread serves all the sockets
+    pConnectionListener->shardCount = 1;
+#endif
+
+    pConnectionListener->pShards = (PConnectionListenerShard) MEMCALLOC(pConnectionListener->shardCount, SIZEOF(ConnectionListenerShard));
+    CHK(pConnectionListener->pShards != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    for (i = 0; i < pConnectionListener->shardCount; i++) {
+        pShard = &pConnectionListener->pShards[i];
+        pShard->pConnectionListener = pConnectionListener;
+        pShard->index = i;
+        pShard->receiveDataRoutine = INVALID_TID_VALUE;
+#if defined(HAVE_EPOLL)
+        pShard->epollFd = -1;
+#endif
+    }
+
+    for (i = 0; i < pConnectionListener->shardCount; i++) {
+        pShard = &pConnectionListener->pShards[i];
+        pShard->pBuffer = (PBYTE) MEMALLOC(MAX_UDP_PACKET_SIZE);
+        CHK(pShard->pBuffer != NULL, STATUS_NOT_ENOUGH_MEMORY);
+        pShard->bufferLen = MAX_UDP_PACKET_SIZE;
+
+#if defined(HAVE_RECVMMSG)
+        pRecvRing = (PConnectionListenerRecvRing) MEMCALLOC(1, SIZEOF(struct __ConnectionListenerRecvRing));
+        CHK(pRecvRing != NULL, STATUS_NOT_ENOUGH_MEMORY);
+        for (j = 0; j < CONNECTION_LISTENER_RECV_BATCH_SIZE; j++) {
+            pRecvRing->iovecs[j].iov_base = pRecvRing->buffers[j];
+            pRecvRing->iovecs[j].iov_len = CONNECTION_LISTENER_RECV_SLOT_SIZE;
+            pRecvRing->messages[j].msg_hdr.msg_iov = &pRecvRing->iovecs[j];
+            pRecvRing->messages[j].msg_hdr.msg_iovlen = 1;
+            pRecvRing->messages[j].msg_hdr.msg_name = &pRecvRing->srcAddrs[j];
+            pRecvRing->messages[j].msg_hdr.msg_namelen = SIZEOF(struct sockaddr_storage);
+        }
+        pShard->pRecvRing = pRecvRing;
+#endif
+
+#if defined(HAVE_EPOLL)
+        pShard->lock = MUTEX_CREATE(FALSE);
+        pShard->pSockets = (PSocketConnection*) MEMCALLOC(CONNECTION_LISTENER_SHARD_INITIAL_SOCKET_COUNT, SIZEOF(PSocketConnection));
+        pShard->pOwners = (PConnectionListener*) MEMCALLOC(CONNECTION_LISTENER_SHARD_INITIAL_SOCKET_COUNT, SIZEOF(PConnectionListener));
+        CHK(pShard->pSockets != NULL && pShard->pOwners != NULL, STATUS_NOT_ENOUGH_MEMORY);
+        pShard->socketCapacity = CONNECTION_LISTENER_SHARD_INITIAL_SOCKET_COUNT;
+        pShard->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        CHK_ERR(pShard->epollFd >= 0, STATUS_CREATE_POLL_SET_FAILED, "epoll_create1() failed with errno %s", getErrorString(getErrorCode()));
+#endif
+    }
+
+    // Use socketpair only if available
+#if defined(HAVE_SOCKETPAIR)
     CHK_STATUS(createSocketPair(&(pConnectionListener->kickSocket)));
+
+#if defined(HAVE_EPOLL)
+    // Every epoll set watches the kick socket so a single write wakes up all the receive threads
+    for (i = 0; i < pConnectionListener->shardCount; i++) {
+        MEMSET(&event, 0x00, SIZEOF(event));
+        event.events = EPOLLIN;
+        event.data.u64 = CONNECTION_LISTENER_KICK_SOCKET_SLOT;
+        CHK_ERR(epoll_ctl(pConnectionListener->pShards[i].epollFd, EPOLL_CTL_ADD,
+                          pConnectionListener->kickSocket[CONNECTION_LISTENER_KICK_SOCKET_LISTEN], &event) == 0,
+                STATUS_POLL_SET_UPDATE_FAILED, "epoll_ctl() failed with errno %s", getErrorString(getErrorCode()));
+    }
+#endif
 #endif
 
 CleanUp:
@@ -47,11 +146,124 @@ CleanUp:
     return retStatus;
 }
 
+STATUS createSharedConnectionListenerLock(VOID)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(!IS_VALID_MUTEX_VALUE(gSharedConnectionListenerLock), retStatus);
+    gSharedConnectionListenerLock = MUTEX_CREATE(FALSE);
+    CHK(IS_VALID_MUTEX_VALUE(gSharedConnectionListenerLock), STATUS_INVALID_OPERATION);
+
+CleanUp:
+
+    return retStatus;
+}
+
+VOID freeSharedConnectionListenerLock(VOID)
+{
+    if (IS_VALID_MUTEX_VALUE(gSharedConnectionListenerLock)) {
+        MUTEX_FREE(gSharedConnectionListenerLock);
+        gSharedConnectionListenerLock = INVALID_MUTEX_VALUE;
+    }
+}
+
+STATUS attachSharedConnectionListener(UINT32 threadCount, UINT64 cpuAffinity, PConnectionListener* ppConnectionListener)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+#if defined(HAVE_EPOLL)
+    PConnectionListener pConnectionListener = NULL;
+    PConnectionListenerShard pShard;
+    BOOL locked = FALSE;
+    UINT32 i;
+
+    CHK(ppConnectionListener != NULL, STATUS_NULL_ARG);
+    CHK_ERR(IS_VALID_MUTEX_VALUE(gSharedConnectionListenerLock), STATUS_INVALID_OPERATION, "initKvsWebRtc has to be called first");
+
+    pConnectionListener = (PConnectionListener) MEMCALLOC(1, SIZEOF(ConnectionListener));
+    CHK(pConnectionListener != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    ATOMIC_STORE_BOOL(&pConnectionListener->terminate, FALSE);
+    pConnectionListener->receiveDataRoutine = INVALID_TID_VALUE;
+    pConnectionListener->lock = INVALID_MUTEX_VALUE;
+
+    MUTEX_LOCK(gSharedConnectionListenerLock);
+    locked = TRUE;
+
+    if (gSharedConnectionListener == NULL) {
+        CHK_STATUS(createConnectionListenerWithParams(threadCount, cpuAffinity, &gSharedConnectionListener));
+        CHK_STATUS(connectionListenerStart(gSharedConnectionListener));
+    }
+
+    // Pin the new listener to the shard serving the fewest listeners
+    pShard = &gSharedConnectionListener->pShards[0];
+    for (i = 1; i < gSharedConnectionListener->shardCount; i++) {
+        if (gSharedConnectionListener->pShards[i].attachedCount < pShard->attachedCount) {
+            pShard = &gSharedConnectionListener->pShards[i];
+        }
+    }
+
+    pShard->attachedCount++;
+    gSharedConnectionListenerAttachCount++;
+    pConnectionListener->pSharedListener = gSharedConnectionListener;
+    pConnectionListener->sharedShardIndex = pShard->index;
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus)) {
+        if (locked && gSharedConnectionListenerAttachCount == 0) {
+            freeConnectionListener(&gSharedConnectionListener);
+        }
+        SAFE_MEMFREE(pConnectionListener);
+    }
+
+    if (locked) {
+        MUTEX_UNLOCK(gSharedConnectionListenerLock);
+    }
+
+    if (ppConnectionListener != NULL) {
+        *ppConnectionListener = pConnectionListener;
+    }
+
+    return retStatus;
+#else
+    // The single poll() thread of a listener can not be shared, every caller gets its own
+    UNUSED_PARAM(threadCount);
+    CHK_STATUS(createConnectionListenerWithParams(1, cpuAffinity, ppConnectionListener));
+
+CleanUp:
+
+    return retStatus;
+#endif
+}
+
+#if defined(HAVE_EPOLL)
+// Drops the sockets added through an attached listener and frees it. The process-wide listener goes away with the last one.
+static STATUS connectionListenerDetach(PConnectionListener pConnectionListener)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK_LOG_ERR(connectionListenerRemoveAllConnection(pConnectionListener));
+    ATOMIC_STORE_BOOL(&pConnectionListener->terminate, TRUE);
+
+    MUTEX_LOCK(gSharedConnectionListenerLock);
+    pConnectionListener->pSharedListener->pShards[pConnectionListener->sharedShardIndex].attachedCount--;
+    if (--gSharedConnectionListenerAttachCount == 0) {
+        retStatus = freeConnectionListener(&gSharedConnectionListener);
+    }
+    MUTEX_UNLOCK(gSharedConnectionListenerLock);
+
+    MEMFREE(pConnectionListener);
+
+    return retStatus;
+}
+#endif
+
 STATUS freeConnectionListener(PConnectionListener* ppConnectionListener)
 {
     STATUS retStatus = STATUS_SUCCESS;
     PConnectionListener pConnectionListener = NULL;
+    PConnectionListenerShard pShard;
     TID threadId;
+    UINT32 i;
     const char* msg = "1";
 
     CHK(ppConnectionListener != NULL, STATUS_NULL_ARG);
@@ -59,6 +271,14 @@ STATUS freeConnectionListener(PConnectionListener* ppConnectionListener)
 
     pConnectionListener = *ppConnectionListener;
 
+#if defined(HAVE_EPOLL)
+    if (pConnectionListener->pSharedListener != NULL) {
+        *ppConnectionListener = NULL;
+        CHK_STATUS(connectionListenerDetach(pConnectionListener));
+        CHK(FALSE, retStatus);
+    }
+#endif
+
     ATOMIC_STORE_BOOL(&pConnectionListener->terminate, TRUE);
 
     if (IS_VALID_MUTEX_VALUE(pConnectionListener->lock)) {
@@ -70,14 +290,20 @@ STATUS freeConnectionListener(PConnectionListener* ppConnectionListener)
         // This writes to the socketpair, kicking the POLL() out early,
         // otherwise wait for the POLL to timeout
 #if defined(HAVE_SOCKETPAIR)
-        socketWrite(pConnectionListener->kickSocket[CONNECTION_LISTENER_KICK_SOCKET_WRITE], msg, STRLEN(msg));
+        if (IS_VALID_TID_VALUE(threadId)) {
+            socketWrite(pConnectionListener->kickSocket[CONNECTION_LISTENER_KICK_SOCKET_WRITE], msg, STRLEN(msg));
+        }
 #endif
 
-        // wait for thread to finish.
-        if (IS_VALID_TID_VALUE(threadId)) {
-            THREAD_JOIN(pConnectionListener->receiveDataRoutine, NULL);
-            pConnectionListener->receiveDataRoutine = INVALID_TID_VALUE;
+        // wait for the threads to finish.
+        for (i = 0; pConnectionListener->pShards != NULL && i < pConnectionListener->shardCount; i++) {
+            pShard = &pConnectionListener->pShards[i];
+            if (IS_VALID_TID_VALUE(pShard->receiveDataRoutine)) {
+                THREAD_JOIN(pShard->receiveDataRoutine, NULL);
+                pShard->receiveDataRoutine = INVALID_TID_VALUE;
+            }
         }
+        pConnectionListener->receiveDataRoutine = INVALID_TID_VALUE;
 
         MUTEX_FREE(pConnectionListener->lock);
     }
@@ -92,6 +318,23 @@ STATUS freeConnectionListener(PConnectionListener* ppConnectionListener)
     }
 #endif
 
+    for (i = 0; pConnectionListener->pShards != NULL && i < pConnectionListener->shardCount; i++) {
+        pShard = &pConnectionListener->pShards[i];
+#if defined(HAVE_EPOLL)
+        if (pShard->epollFd >= 0) {
+            close(pShard->epollFd);
+        }
+        if (IS_VALID_MUTEX_VALUE(pShard->lock)) {
+            MUTEX_FREE(pShard->lock);
+        }
+        SAFE_MEMFREE(pShard->pSockets);
+        SAFE_MEMFREE(pShard->pOwners);
+#endif
+        SAFE_MEMFREE(pShard->pRecvRing);
+        SAFE_MEMFREE(pShard->pBuffer);
+    }
+
+    SAFE_MEMFREE(pConnectionListener->pShards);
     MEMFREE(pConnectionListener);
 
     *ppConnectionListener = NULL;
@@ -106,12 +349,74 @@ CleanUp:
 STATUS connectionListenerAddConnection(PConnectionListener pConnectionListener, PSocketConnection pSocketConnection)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    BOOL locked = FALSE, iterate = TRUE;
+    BOOL locked = FALSE;
     UINT32 i;
+#if defined(HAVE_EPOLL)
+    PConnectionListenerShard pShard = NULL;
+    PSocketConnection* pNewSockets;
+    PConnectionListener* pNewOwners;
+    struct epoll_event event;
+#else
+    BOOL iterate = TRUE;
+#endif
 
     CHK(pConnectionListener != NULL && pSocketConnection != NULL, STATUS_NULL_ARG);
     CHK(!ATOMIC_LOAD_BOOL(&pConnectionListener->terminate), retStatus);
 
+#if defined(HAVE_EPOLL)
+    if (pConnectionListener->pSharedListener != NULL) {
+        // Every socket of an attached listener goes to the shard it is pinned to
+        pShard = &pConnectionListener->pSharedListener->pShards[pConnectionListener->sharedShardIndex];
+    } else {
+        // Hand the socket to the least loaded receive thread
+        pShard = &pConnectionListener->pShards[0];
+        for (i = 1; i < pConnectionListener->shardCount; i++) {
+            if (ATOMIC_LOAD(&pConnectionListener->pShards[i].socketCount) < ATOMIC_LOAD(&pShard->socketCount)) {
+                pShard = &pConnectionListener->pShards[i];
+            }
+        }
+    }
+
+    MUTEX_LOCK(pShard->lock);
+    locked = TRUE;
+
+    for (i = 0; i < pShard->socketCapacity && pShard->pSockets[i] != NULL; i++) {
+        // Find an empty slot
+    }
+
+    if (i == pShard->socketCapacity) {
+        pNewSockets = (PSocketConnection*) MEMCALLOC(2 * pShard->socketCapacity, SIZEOF(PSocketConnection));
+        pNewOwners = (PConnectionListener*) MEMCALLOC(2 * pShard->socketCapacity, SIZEOF(PConnectionListener));
+        if (pNewSockets == NULL || pNewOwners == NULL) {
+            SAFE_MEMFREE(pNewSockets);
+            SAFE_MEMFREE(pNewOwners);
+            CHK(FALSE, STATUS_NOT_ENOUGH_MEMORY);
+        }
+        MEMCPY(pNewSockets, pShard->pSockets, pShard->socketCapacity * SIZEOF(PSocketConnection));
+        MEMCPY(pNewOwners, pShard->pOwners, pShard->socketCapacity * SIZEOF(PConnectionListener));
+        MEMFREE(pShard->pSockets);
+        MEMFREE(pShard->pOwners);
+        pShard->pSockets = pNewSockets;
+        pShard->pOwners = pNewOwners;
+        pShard->socketCapacity *= 2;
+    }
+
+    MEMSET(&event, 0x00, SIZEOF(event));
+    event.events = EPOLLIN;
+    event.data.u64 = i;
+    CHK_ERR(epoll_ctl(pShard->epollFd, EPOLL_CTL_ADD, pSocketConnection->localSocket, &event) == 0, STATUS_POLL_SET_UPDATE_FAILED,
+            "epoll_ctl() failed to add socket %d with errno %s", pSocketConnection->localSocket, getErrorString(getErrorCode()));
+
+    pShard->pSockets[i] = pSocketConnection;
+    pShard->pOwners[i] = pConnectionListener;
+    pSocketConnection->listenerShardIndex = pShard->index;
+    pSocketConnection->listenerSlotIndex = i;
+    ATOMIC_INCREMENT(&pShard->socketCount);
+    ATOMIC_INCREMENT(&pConnectionListener->socketCount);
+    if (pConnectionListener->pSharedListener != NULL) {
+        ATOMIC_INCREMENT(&pConnectionListener->pSharedListener->socketCount);
+    }
+#else
     MUTEX_LOCK(pConnectionListener->lock);
     locked = TRUE;
 
@@ -123,17 +428,20 @@ STATUS connectionListenerAddConnection(PConnectionListener pConnectionListener,
         if (pConnectionListener->sockets[i] == NULL) {
             pConnectionListener->sockets[i] = pSocketConnection;
             pConnectionListener->socketCount++;
+            pConnectionListener->socketListVersion++;
             iterate = FALSE;
         }
     }
-
-    MUTEX_UNLOCK(pConnectionListener->lock);
-    locked = FALSE;
+#endif
 
 CleanUp:
 
     if (locked) {
+#if defined(HAVE_EPOLL)
+        MUTEX_UNLOCK(pShard->lock);
+#else
         MUTEX_UNLOCK(pConnectionListener->lock);
+#endif
     }
 
     return retStatus;
@@ -142,12 +450,36 @@ CleanUp:
 STATUS connectionListenerRemoveConnection(PConnectionListener pConnectionListener, PSocketConnection pSocketConnection)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    BOOL locked = FALSE, iterate = TRUE;
+    BOOL locked = FALSE;
+#if defined(HAVE_EPOLL)
+    PConnectionListener pServingListener;
+    PConnectionListenerShard pShard = NULL;
+#else
+    BOOL iterate = TRUE;
     UINT32 i;
+#endif
 
     CHK(pConnectionListener != NULL && pSocketConnection != NULL, STATUS_NULL_ARG);
     CHK(!ATOMIC_LOAD_BOOL(&pConnectionListener->terminate), retStatus);
 
+#if defined(HAVE_EPOLL)
+    // Mark socket as closed
+    CHK_STATUS(socketConnectionClosed(pSocketConnection));
+
+    // Only the shard serving the socket is touched, the other receive threads keep running undisturbed
+    pServingListener = pConnectionListener->pSharedListener != NULL ? pConnectionListener->pSharedListener : pConnectionListener;
+    CHK(pSocketConnection->listenerShardIndex < pServingListener->shardCount, retStatus);
+    pShard = &pServingListener->pShards[pSocketConnection->listenerShardIndex];
+
+    MUTEX_LOCK(pShard->lock);
+    locked = TRUE;
+
+    if (pSocketConnection->listenerSlotIndex < pShard->socketCapacity &&
+        pShard->pSockets[pSocketConnection->listenerSlotIndex] == pSocketConnection &&
+        pShard->pOwners[pSocketConnection->listenerSlotIndex] == pConnectionListener) {
+        connectionListenerShardRemoveSocket(pShard, pSocketConnection->listenerSlotIndex);
+    }
+#else
     MUTEX_LOCK(pConnectionListener->lock);
     locked = TRUE;
 
@@ -162,13 +494,19 @@ STATUS connectionListenerRemoveConnection(PConnectionListener pConnectionListene
             // Mark the slot as empty and decrement the count
             pConnectionListener->sockets[i] = NULL;
             pConnectionListener->socketCount--;
+            pConnectionListener->socketListVersion++;
         }
     }
+#endif
 
 CleanUp:
 
     if (locked) {
+#if defined(HAVE_EPOLL)
+        MUTEX_UNLOCK(pShard->lock);
+#else
         MUTEX_UNLOCK(pConnectionListener->lock);
+#endif
     }
 
     return retStatus;
@@ -179,10 +517,38 @@ STATUS connectionListenerRemoveAllConnection(PConnectionListener pConnectionList
     STATUS retStatus = STATUS_SUCCESS;
     BOOL locked = FALSE;
     UINT32 i;
+#if defined(HAVE_EPOLL)
+    PConnectionListener pServingListener;
+    PConnectionListenerShard pShard = NULL;
+    UINT32 j;
+#endif
 
     CHK(pConnectionListener != NULL, STATUS_NULL_ARG);
     CHK(!ATOMIC_LOAD_BOOL(&pConnectionListener->terminate), retStatus);
 
+#if defined(HAVE_EPOLL)
+    // An attached listener only drops the sockets added through it, all of them sit on its shard
+    pServingListener = pConnectionListener->pSharedListener != NULL ? pConnectionListener->pSharedListener : pConnectionListener;
+    for (j = 0; j < pServingListener->shardCount; j++) {
+        if (pConnectionListener != pServingListener && j != pConnectionListener->sharedShardIndex) {
+            continue;
+        }
+
+        pShard = &pServingListener->pShards[j];
+        MUTEX_LOCK(pShard->lock);
+        locked = TRUE;
+
+        for (i = 0; i < pShard->socketCapacity; i++) {
+            if (pShard->pSockets[i] != NULL && pShard->pOwners[i] == pConnectionListener) {
+                CHK_STATUS(socketConnectionClosed(pShard->pSockets[i]));
+                connectionListenerShardRemoveSocket(pShard, i);
+            }
+        }
+
+        MUTEX_UNLOCK(pShard->lock);
+        locked = FALSE;
+    }
+#else
     MUTEX_LOCK(pConnectionListener->lock);
     locked = TRUE;
 
@@ -191,31 +557,79 @@ STATUS connectionListenerRemoveAllConnection(PConnectionListener pConnectionList
             CHK_STATUS(socketConnectionClosed(pConnectionListener->sockets[i]));
             pConnectionListener->sockets[i] = NULL;
             pConnectionListener->socketCount--;
+            pConnectionListener->socketListVersion++;
         }
     }
+#endif
 
 CleanUp:
 
     if (locked) {
+#if defined(HAVE_EPOLL)
+        MUTEX_UNLOCK(pShard->lock);
+#else
         MUTEX_UNLOCK(pConnectionListener->lock);
+#endif
     }
 
     return retStatus;
 }
 
+BOOL connectionListenerHasConnection(PConnectionListener pConnectionListener, PSocketConnection pSocketConnection)
+{
+    BOOL found = FALSE;
+#if defined(HAVE_EPOLL)
+    PConnectionListener pServingListener;
+    PConnectionListenerShard pShard;
+#else
+    UINT32 i;
+#endif
+
+    if (pConnectionListener == NULL || pSocketConnection == NULL) {
+        return FALSE;
+    }
+
+#if defined(HAVE_EPOLL)
+    pServingListener = pConnectionListener->pSharedListener != NULL ? pConnectionListener->pSharedListener : pConnectionListener;
+    if (pSocketConnection->listenerShardIndex < pServingListener->shardCount) {
+        pShard = &pServingListener->pShards[pSocketConnection->listenerShardIndex];
+        MUTEX_LOCK(pShard->lock);
+        found = pSocketConnection->listenerSlotIndex < pShard->socketCapacity &&
+            pShard->pSockets[pSocketConnection->listenerSlotIndex] == pSocketConnection &&
+            pShard->pOwners[pSocketConnection->listenerSlotIndex] == pConnectionListener;
+        MUTEX_UNLOCK(pShard->lock);
+    }
+#else
+    MUTEX_LOCK(pConnectionListener->lock);
+    for (i = 0; !found && i < CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION; i++) {
+        found = pConnectionListener->sockets[i] == pSocketConnection;
+    }
+    MUTEX_UNLOCK(pConnectionListener->lock);
+#endif
+
+    return found;
+}
+
 STATUS connectionListenerStart(PConnectionListener pConnectionListener)
 {
     STATUS retStatus = STATUS_SUCCESS;
     BOOL locked = FALSE;
+    UINT32 i;
 
     CHK(pConnectionListener != NULL, STATUS_NULL_ARG);
     CHK(!ATOMIC_LOAD_BOOL(&pConnectionListener->terminate), retStatus);
+    // The threads serving an attached listener belong to the process-wide one and are already running
+    CHK(pConnectionListener->pSharedListener == NULL, retStatus);
 
     MUTEX_LOCK(pConnectionListener->lock);
     locked = TRUE;
 
     CHK(!IS_VALID_TID_VALUE(pConnectionListener->receiveDataRoutine), retStatus);
-    CHK_STATUS(THREAD_CREATE(&pConnectionListener->receiveDataRoutine, connectionListenerReceiveDataRoutine, (PVOID) pConnectionListener));
+    for (i = 0; i < pConnectionListener->shardCount; i++) {
+        CHK_STATUS(THREAD_CREATE(&pConnectionListener->pShards[i].receiveDataRoutine, connectionListenerReceiveDataRoutine,
+                                 (PVOID) &pConnectionListener->pShards[i]));
+    }
+    pConnectionListener->receiveDataRoutine = pConnectionListener->pShards[0].receiveDataRoutine;
 
 CleanUp:
 
@@ -226,94 +640,263 @@ CleanUp:
     return retStatus;
 }
 
-BOOL canReadFd(INT32 fd, struct pollfd* fds, INT32 nfds)
+VOID connectionListenerDispatchData(PSocketConnection pSocketConnection, PBYTE pBuffer, UINT32 bufferLen, INT64 readLen,
+                                    struct sockaddr_storage* pSrcAddrBuff)
 {
-    INT32 i;
-    for (i = 0; i < nfds; i++) {
-        if (fds[i].fd == fd && (fds[i].revents & POLLIN) != 0) {
-            return TRUE;
+    struct sockaddr_in* pIpv4Addr;
+    struct sockaddr_in6* pIpv6Addr;
+    KvsIpAddress srcAddr;
+    PKvsIpAddress pSrcAddr = NULL;
+
+    if (ATOMIC_LOAD_BOOL(&pSocketConnection->receiveData) && pSocketConnection->dataAvailableCallbackFn != NULL &&
+        /* data could be encrypted so they need to be decrypted through socketConnectionReadData
+         * and get the decrypted data length. */
+        STATUS_SUCCEEDED(socketConnectionReadData(pSocketConnection, pBuffer, bufferLen, (PUINT32) &readLen))) {
+        if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_UDP) {
+            MEMSET(&srcAddr, 0x00, SIZEOF(KvsIpAddress));
+            srcAddr.isPointToPoint = FALSE;
+            if (pSrcAddrBuff->ss_family == AF_INET) {
+                srcAddr.family = KVS_IP_FAMILY_TYPE_IPV4;
+                pIpv4Addr = (struct sockaddr_in*) pSrcAddrBuff;
+                MEMCPY(srcAddr.address, (PBYTE) &pIpv4Addr->sin_addr, IPV4_ADDRESS_LENGTH);
+                srcAddr.port = pIpv4Addr->sin_port;
+            } else if (pSrcAddrBuff->ss_family == AF_INET6) {
+                srcAddr.family = KVS_IP_FAMILY_TYPE_IPV6;
+                pIpv6Addr = (struct sockaddr_in6*) pSrcAddrBuff;
+                MEMCPY(srcAddr.address, (PBYTE) &pIpv6Addr->sin6_addr, IPV6_ADDRESS_LENGTH);
+                srcAddr.port = pIpv6Addr->sin6_port;
+            }
+            pSrcAddr = &srcAddr;
+        } else {
+            // srcAddr is ignored in TCP callback handlers
+            pSrcAddr = NULL;
+        }
+
+        // readLen may be 0 if SSL does not emit any application data.
+        // in that case, no need to call dataAvailable callback
+        if (readLen > 0) {
+            pSocketConnection->dataAvailableCallbackFn(pSocketConnection->dataAvailableCallbackCustomData, pSocketConnection, pBuffer,
+                                                       (UINT32) readLen, pSrcAddr,
+                                                       NULL); // no dest information available right now.
         }
     }
-    return FALSE;
+}
+
+STATUS connectionListenerReceiveData(PConnectionListenerShard pShard, PSocketConnection pSocketConnection, INT32 localSocket)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    BOOL iterate = TRUE;
+    INT64 readLen;
+    // the source address is put here. sockaddr_storage can hold either sockaddr_in or sockaddr_in6
+    struct sockaddr_storage srcAddrBuff;
+    socklen_t srcAddrBuffLen = SIZEOF(srcAddrBuff);
+#if defined(HAVE_RECVMMSG)
+    PConnectionListenerRecvRing pRecvRing = pShard->pRecvRing;
+    INT32 received, i;
+    UINT32 batches;
+
+    if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_UDP) {
+        for (batches = 0; iterate && batches < CONNECTION_LISTENER_RECV_MAX_BATCHES_PER_WAKEUP; batches++) {
+            // recvmmsg overwrites the address length and flags of every slot it fills
+            for (i = 0; i < CONNECTION_LISTENER_RECV_BATCH_SIZE; i++) {
+                pRecvRing->messages[i].msg_hdr.msg_namelen = SIZEOF(struct sockaddr_storage);
+                pRecvRing->messages[i].msg_hdr.msg_flags = 0;
+            }
+
+            received = recvmmsg(localSocket, pRecvRing->messages, CONNECTION_LISTENER_RECV_BATCH_SIZE, 0, NULL);
+            if (received < 0) {
+                switch (getErrorCode()) {
+                    case EWOULDBLOCK:
+                        break;
+                    default:
+                        /* on any other error, close connection */
+                        CHK_STATUS(socketConnectionClosed(pSocketConnection));
+                        DLOGD("recvmmsg() failed with errno %s for socket %d", getErrorString(getErrorCode()), localSocket);
+                        break;
+                }
+
+                iterate = FALSE;
+            } else {
+                for (i = 0; i < received; i++) {
+                    if ((pRecvRing->messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+                        DLOGW("Dropping datagram larger than %u bytes on socket %d", CONNECTION_LISTENER_RECV_SLOT_SIZE, localSocket);
+                    } else if (pRecvRing->messages[i].msg_len > 0) {
+                        connectionListenerDispatchData(pSocketConnection, pRecvRing->buffers[i], CONNECTION_LISTENER_RECV_SLOT_SIZE,
+                                                       (INT64) pRecvRing->messages[i].msg_len, &pRecvRing->srcAddrs[i]);
+                    }
+                }
+
+                // A short batch means the socket has been drained. A socket still holding data after the last batch
+                // stays readable, the level triggered poll reports it again on the next wakeup.
+                iterate = received == CONNECTION_LISTENER_RECV_BATCH_SIZE;
+            }
+        }
+
+        CHK(FALSE, retStatus);
+    }
+#endif
+
+    while (iterate) {
+        readLen = recvfrom(localSocket, pShard->pBuffer, pShard->bufferLen, 0, (struct sockaddr*) &srcAddrBuff, &srcAddrBuffLen);
+        if (readLen < 0) {
+            switch (getErrorCode()) {
+                case EWOULDBLOCK:
+                    break;
+                default:
+                    /* on any other error, close connection */
+                    CHK_STATUS(socketConnectionClosed(pSocketConnection));
+                    DLOGD("recvfrom() failed with errno %s for socket %d", getErrorString(getErrorCode()), localSocket);
+                    break;
+            }
+
+            iterate = FALSE;
+        } else if (readLen == 0) {
+            CHK_STATUS(socketConnectionClosed(pSocketConnection));
+            iterate = FALSE;
+        } else {
+            connectionListenerDispatchData(pSocketConnection, pShard->pBuffer, (UINT32) pShard->bufferLen, readLen, &srcAddrBuff);
+        }
+
+        // reset srcAddrBuffLen to actual size
+        srcAddrBuffLen = SIZEOF(srcAddrBuff);
+    }
+
+CleanUp:
+
+    return retStatus;
 }
 
 PVOID connectionListenerReceiveDataRoutine(PVOID arg)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    PConnectionListener pConnectionListener = (PConnectionListener) arg;
+    PConnectionListenerShard pShard = (PConnectionListenerShard) arg;
+#if defined(HAVE_SCHED_SETAFFINITY)
+    UINT64 cpuAffinity;
+    UINT32 cpu, cpuCount = 0, target;
+    cpu_set_t cpuSet;
+#endif
+
+    CHK(pShard != NULL, STATUS_NULL_ARG);
+
+    if (pShard->pConnectionListener->cpuAffinity != 0) {
+#if defined(HAVE_SCHED_SETAFFINITY)
+        // Thread i runs on the i-th CPU of the mask, wrapping around
+        cpuAffinity = pShard->pConnectionListener->cpuAffinity;
+        for (cpu = 0; cpu < 64; cpu++) {
+            cpuCount += (UINT32) ((cpuAffinity >> cpu) & 1);
+        }
+        target = pShard->index % cpuCount;
+        for (cpu = 0; cpu < 64; cpu++) {
+            if (((cpuAffinity >> cpu) & 1) != 0 && target-- == 0) {
+                break;
+            }
+        }
+
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        if (sched_setaffinity(0, SIZEOF(cpuSet), &cpuSet) != 0) {
+            DLOGW("Failed to pin connection listener thread %u to cpu %u with errno %s", pShard->index, cpu, getErrorString(getErrorCode()));
+        }
+#else
+        DLOGW("Connection listener cpu affinity is not supported on this platform");
+#endif
+    }
+
+#if defined(HAVE_EPOLL)
+    CHK_STATUS(connectionListenerEpollLoop(pShard));
+#else
+    CHK_STATUS(connectionListenerPollLoop(pShard));
+#endif
+
+CleanUp:
+
+    CHK_LOG_ERR(retStatus);
+
+    return (PVOID) (ULONG_PTR) retStatus;
+}
+
+STATUS connectionListenerPollLoop(PConnectionListenerShard pShard)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PConnectionListener pConnectionListener = pShard->pConnectionListener;
     PSocketConnection pSocketConnection;
-    BOOL iterate = TRUE;
+    BOOL rebuild;
     PSocketConnection sockets[CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION];
-    UINT32 i, socketCount;
+    UINT32 i, socketCount = 0;
+    UINT64 socketListVersion = 0;
 
     INT32 nfds = 0;
     //+1 added for the pipe() to kickout poll()
     struct pollfd rfds[CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION + 1];
     INT32 retval, localSocket;
-    INT64 readLen;
-    // the source address is put here. sockaddr_storage can hold either sockaddr_in or sockaddr_in6
-    struct sockaddr_storage srcAddrBuff;
-    socklen_t srcAddrBuffLen = SIZEOF(srcAddrBuff);
-    struct sockaddr_in* pIpv4Addr;
-    struct sockaddr_in6* pIpv6Addr;
-    KvsIpAddress srcAddr;
-    PKvsIpAddress pSrcAddr = NULL;
-
-    CHK(pConnectionListener != NULL, STATUS_NULL_ARG);
 
     /* Ensure that memory sanitizers consider
      * rfds initialized even if FD_ZERO is
      * implemented in assembly. */
     MEMSET(&rfds, 0x00, SIZEOF(rfds));
 
-    srcAddr.isPointToPoint = FALSE;
-
     while (!ATOMIC_LOAD_BOOL(&pConnectionListener->terminate)) {
-        nfds = 0;
-
-        // Perform the socket connection gathering under the lock
+        // Mark the sockets as in use under the lock so a removed socket is never picked up after its removal.
+        // The poll set is only rebuilt when the socket list changed or one of the sockets got closed.
         // NOTE: There is no cleanup jump from the lock/unlock block
         // so we don't need to use a boolean indicator whether locked
         MUTEX_LOCK(pConnectionListener->lock);
-        for (i = 0, socketCount = 0; i < CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION; i++) {
-            pSocketConnection = pConnectionListener->sockets[i];
-            if (pSocketConnection != NULL) {
-                if (!socketConnectionIsClosed(pSocketConnection)) {
-                    MUTEX_LOCK(pSocketConnection->lock);
-                    localSocket = pSocketConnection->localSocket;
-                    MUTEX_UNLOCK(pSocketConnection->lock);
-                    rfds[nfds].fd = localSocket;
-                    rfds[nfds].events = POLLIN | POLLPRI;
+        rebuild = socketCount == 0 || pConnectionListener->socketListVersion != socketListVersion;
+        for (i = 0; !rebuild && i < socketCount; i++) {
+            rebuild = socketConnectionIsClosed(sockets[i]);
+        }
+
+        if (rebuild) {
+            nfds = 0;
+            for (i = 0, socketCount = 0; i < CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION; i++) {
+                pSocketConnection = pConnectionListener->sockets[i];
+                if (pSocketConnection != NULL) {
+                    if (!socketConnectionIsClosed(pSocketConnection)) {
+                        MUTEX_LOCK(pSocketConnection->lock);
+                        localSocket = pSocketConnection->localSocket;
+                        MUTEX_UNLOCK(pSocketConnection->lock);
+                        rfds[nfds].fd = localSocket;
+                        rfds[nfds].events = POLLIN | POLLPRI;
 #if !defined(HAVE_SOCKETPAIR)
-                    rfds[nfds].events &= ~POLLPRI;
-#endif
-                    rfds[nfds].revents = 0;
-                    nfds++;
-
-                    // Store the sockets locally while in use and mark it as in use
-                    sockets[socketCount++] = pSocketConnection;
-                    ATOMIC_STORE_BOOL(&pSocketConnection->inUse, TRUE);
-                } else {
-                    // Remove the connection
-                    pConnectionListener->sockets[i] = NULL;
-                    pConnectionListener->socketCount--;
+                        rfds[nfds].events &= ~POLLPRI;
+#endif
+                        nfds++;
+
+                        // Store the sockets locally while in use
+                        sockets[socketCount++] = pSocketConnection;
+                    } else {
+                        // Remove the connection
+                        pConnectionListener->sockets[i] = NULL;
+                        pConnectionListener->socketCount--;
+                    }
                 }
             }
-        }
 
-        // Need to unlock the mutex to ensure other racing threads unblock
-        MUTEX_UNLOCK(pConnectionListener->lock);
-        retval = 0;
-        if (nfds != 0) {
             // TODO add support for socketpair() in windows
             // This end of the socketpair has been added to the list of sockets polled
             // in order to have a way to end the poll early from the destructor
 #if defined(HAVE_SOCKETPAIR)
-            rfds[nfds].fd = pConnectionListener->kickSocket[CONNECTION_LISTENER_KICK_SOCKET_LISTEN];
-            rfds[nfds].events = POLLIN;
-            rfds[nfds].revents = 0;
-            nfds++;
+            if (nfds != 0) {
+                rfds[nfds].fd = pConnectionListener->kickSocket[CONNECTION_LISTENER_KICK_SOCKET_LISTEN];
+                rfds[nfds].events = POLLIN;
+                nfds++;
+            }
 #endif
+            socketListVersion = pConnectionListener->socketListVersion;
+        }
+
+        for (i = 0; i < socketCount; i++) {
+            ATOMIC_STORE_BOOL(&sockets[i]->inUse, TRUE);
+        }
+
+        // Need to unlock the mutex to ensure other racing threads unblock
+        MUTEX_UNLOCK(pConnectionListener->lock);
+        retval = 0;
+        if (nfds != 0) {
+            for (i = 0; i < (UINT32) nfds; i++) {
+                rfds[i].revents = 0;
+            }
+
             // blocking call until resolves as a timeout, an error, a signal or data received
             retval = POLL(rfds, nfds, CONNECTION_LISTENER_SOCKET_WAIT_FOR_DATA_TIMEOUT / HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
         } else {
@@ -326,70 +909,11 @@ PVOID connectionListenerReceiveDataRoutine(PVOID arg)
         if (retval == -1) {
             DLOGW("poll() failed with errno %s", getErrorString(getErrorCode()));
         } else if (retval > 0) {
+            // sockets[i] was polled through rfds[i]
             for (i = 0; i < socketCount; i++) {
                 pSocketConnection = sockets[i];
-                if (!socketConnectionIsClosed(pSocketConnection)) {
-                    MUTEX_LOCK(pSocketConnection->lock);
-                    localSocket = pSocketConnection->localSocket;
-                    MUTEX_UNLOCK(pSocketConnection->lock);
-
-                    if (canReadFd(localSocket, rfds, nfds)) {
-                        iterate = TRUE;
-                        while (iterate) {
-                            readLen = recvfrom(localSocket, pConnectionListener->pBuffer, pConnectionListener->bufferLen, 0,
-                                               (struct sockaddr*) &srcAddrBuff, &srcAddrBuffLen);
-                            if (readLen < 0) {
-                                switch (getErrorCode()) {
-                                    case EWOULDBLOCK:
-                                        break;
-                                    default:
-                                        /* on any other error, close connection */
-                                        CHK_STATUS(socketConnectionClosed(pSocketConnection));
-                                        DLOGD("recvfrom() failed with errno %s for socket %d", getErrorString(getErrorCode()), localSocket);
-                                        break;
-                                }
-
-                                iterate = FALSE;
-                            } else if (readLen == 0) {
-                                CHK_STATUS(socketConnectionClosed(pSocketConnection));
-                                iterate = FALSE;
-                            } else if (/* readLen > 0 */
-                                       ATOMIC_LOAD_BOOL(&pSocketConnection->receiveData) && pSocketConnection->dataAvailableCallbackFn != NULL &&
-                                       /* data could be encrypted so they need to be decrypted through socketConnectionReadData
-                                        * and get the decrypted data length. */
-                                       STATUS_SUCCEEDED(socketConnectionReadData(pSocketConnection, pConnectionListener->pBuffer,
-                                                                                 pConnectionListener->bufferLen, (PUINT32) &readLen))) {
-                                if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_UDP) {
-                                    if (srcAddrBuff.ss_family == AF_INET) {
-                                        srcAddr.family = KVS_IP_FAMILY_TYPE_IPV4;
-                                        pIpv4Addr = (struct sockaddr_in*) &srcAddrBuff;
-                                        MEMCPY(srcAddr.address, (PBYTE) &pIpv4Addr->sin_addr, IPV4_ADDRESS_LENGTH);
-                                        srcAddr.port = pIpv4Addr->sin_port;
-                                    } else if (srcAddrBuff.ss_family == AF_INET6) {
-                                        srcAddr.family = KVS_IP_FAMILY_TYPE_IPV6;
-                                        pIpv6Addr = (struct sockaddr_in6*) &srcAddrBuff;
-                                        MEMCPY(srcAddr.address, (PBYTE) &pIpv6Addr->sin6_addr, IPV6_ADDRESS_LENGTH);
-                                        srcAddr.port = pIpv6Addr->sin6_port;
-                                    }
-                                    pSrcAddr = &srcAddr;
-                                } else {
-                                    // srcAddr is ignored in TCP callback handlers
-                                    pSrcAddr = NULL;
-                                }
-
-                                // readLen may be 0 if SSL does not emit any application data.
-                                // in that case, no need to call dataAvailable callback
-                                if (readLen > 0) {
-                                    pSocketConnection->dataAvailableCallbackFn(pSocketConnection->dataAvailableCallbackCustomData, pSocketConnection,
-                                                                               pConnectionListener->pBuffer, (UINT32) readLen, pSrcAddr,
-                                                                               NULL); // no dest information available right now.
-                                }
-                            }
-
-                            // reset srcAddrBuffLen to actual size
-                            srcAddrBuffLen = SIZEOF(srcAddrBuff);
-                        }
-                    }
+                if (!socketConnectionIsClosed(pSocketConnection) && (rfds[i].revents & POLLIN) != 0) {
+                    CHK_STATUS(connectionListenerReceiveData(pShard, pSocketConnection, rfds[i].fd));
                 }
 
                 // Release this socket immediately so freeSocketConnection can
@@ -409,7 +933,82 @@ PVOID connectionListenerReceiveDataRoutine(PVOID arg)
 
 CleanUp:
 
-    CHK_LOG_ERR(retStatus);
+    return retStatus;
+}
 
-    return (PVOID) (ULONG_PTR) retStatus;
+#if defined(HAVE_EPOLL)
+STATUS connectionListenerEpollLoop(PConnectionListenerShard pShard)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PConnectionListener pConnectionListener = pShard->pConnectionListener;
+    PSocketConnection pSocketConnection;
+    PSocketConnection readable[CONNECTION_LISTENER_EPOLL_MAX_EVENTS];
+    struct epoll_event events[CONNECTION_LISTENER_EPOLL_MAX_EVENTS];
+    INT32 eventCount, i, readableCount;
+    UINT64 slot;
+
+    while (!ATOMIC_LOAD_BOOL(&pConnectionListener->terminate)) {
+        // Sockets stay registered between iterations, adding or removing one does not interrupt the wait
+        eventCount = epoll_wait(pShard->epollFd, events, CONNECTION_LISTENER_EPOLL_MAX_EVENTS,
+                                CONNECTION_LISTENER_SOCKET_WAIT_FOR_DATA_TIMEOUT / HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+        if (eventCount < 0) {
+            if (getErrorCode() != EINTR) {
+                DLOGW("epoll_wait() failed with errno %s", getErrorString(getErrorCode()));
+            }
+            continue;
+        }
+
+        // Resolve the events under the shard lock and mark the sockets in use so a concurrent removal
+        // followed by freeSocketConnection waits for this iteration to finish with them
+        readableCount = 0;
+        MUTEX_LOCK(pShard->lock);
+        for (i = 0; i < eventCount; i++) {
+            slot = events[i].data.u64;
+            if (slot >= pShard->socketCapacity || (pSocketConnection = pShard->pSockets[slot]) == NULL) {
+                // Kick socket or a socket removed after the events were collected
+                continue;
+            }
+
+            if (socketConnectionIsClosed(pSocketConnection)) {
+                // A closed socket is never read again, stop watching it so pending data does not keep waking us up
+                connectionListenerShardRemoveSocket(pShard, (UINT32) slot);
+            } else {
+                ATOMIC_STORE_BOOL(&pSocketConnection->inUse, TRUE);
+                readable[readableCount++] = pSocketConnection;
+            }
+        }
+        MUTEX_UNLOCK(pShard->lock);
+
+        for (i = 0; i < readableCount; i++) {
+            // Errors and hang ups are reported by the read as well
+            CHK_STATUS(connectionListenerReceiveData(pShard, readable[i], readable[i]->localSocket));
+
+            // Release this socket immediately so freeSocketConnection can proceed
+            ATOMIC_STORE_BOOL(&readable[i]->inUse, FALSE);
+        }
+    }
+
+CleanUp:
+
+    return retStatus;
 }
+
+VOID connectionListenerShardRemoveSocket(PConnectionListenerShard pShard, UINT32 slot)
+{
+    PSocketConnection pSocketConnection = pShard->pSockets[slot];
+
+    // The descriptor is still open, it is only closed by freeSocketConnection
+    if (epoll_ctl(pShard->epollFd, EPOLL_CTL_DEL, pSocketConnection->localSocket, NULL) != 0) {
+        DLOGD("epoll_ctl() failed to remove socket %d with errno %s", pSocketConnection->localSocket, getErrorString(getErrorCode()));
+    }
+
+    if (pShard->pOwners[slot] != pShard->pConnectionListener) {
+        ATOMIC_DECREMENT(&pShard->pOwners[slot]->socketCount);
+    }
+
+    pShard->pSockets[slot] = NULL;
+    pShard->pOwners[slot] = NULL;
+    ATOMIC_DECREMENT(&pShard->socketCount);
+    ATOMIC_DECREMENT(&pShard->pConnectionListener->socketCount);
+}
+#endif
@@ -16,14 +16,74 @@ extern "C" {
 #define CONNECTION_LISTENER_KICK_SOCKET_LISTEN               0
 #define CONNECTION_LISTENER_KICK_SOCKET_WRITE                1
 
+// Datagrams drained from a UDP socket per recvmmsg call and the size of each receive ring slot.
+// Datagrams larger than a slot are truncated by the kernel and dropped.
+#define CONNECTION_LISTENER_RECV_BATCH_SIZE 16
+#define CONNECTION_LISTENER_RECV_SLOT_SIZE  4096
+
+// recvmmsg calls made on one socket per wakeup. Whatever is left is read on the next wakeup, so a busy socket does not
+// keep the other ready sockets waiting.
+#define CONNECTION_LISTENER_RECV_MAX_BATCHES_PER_WAKEUP 4
+
+// Upper bound for the number of receive threads, each thread polls its own shard of the sockets
+#define CONNECTION_LISTENER_MAX_THREAD_COUNT 64
+
+// epoll backend: events fetched per epoll_wait call and the initial socket table size of a shard
+#define CONNECTION_LISTENER_EPOLL_MAX_EVENTS          64
+#define CONNECTION_LISTENER_SHARD_INITIAL_SOCKET_COUNT 16
+
+// epoll user data of the kick socket, never a valid socket table index
+#define CONNECTION_LISTENER_KICK_SOCKET_SLOT MAX_UINT64
+
+typedef struct __ConnectionListenerRecvRing ConnectionListenerRecvRing;
+typedef struct __ConnectionListenerRecvRing* PConnectionListenerRecvRing;
+
+struct __ConnectionListener;
+
+/**
+ * Part of the listener served by one receive thread. Every shard owns its receive buffers so the threads never share state
+ * on the data path. With epoll, a shard also owns the epoll set and the table of the sockets registered in it; the epoll
+ * user data of a socket is its index in that table.
+ */
 typedef struct {
+    struct __ConnectionListener* pConnectionListener;
+    UINT32 index;
+    TID receiveDataRoutine;
+    PBYTE pBuffer;
+    UINT64 bufferLen;
+    // Receive ring for batched UDP reads, NULL when recvmmsg is not available
+    PConnectionListenerRecvRing pRecvRing;
+#if defined(HAVE_EPOLL)
+    INT32 epollFd;
+    // Protects pSockets and serializes registration changes with the receive thread marking sockets in use
+    MUTEX lock;
+    PSocketConnection* pSockets;
+    // Listener each socket of pSockets was added through, an attached listener when the shard belongs to the shared one
+    struct __ConnectionListener** pOwners;
+    UINT32 socketCapacity;
+    volatile SIZE_T socketCount;
+    // Attached listeners pinned to this shard
+    UINT32 attachedCount;
+#endif
+} ConnectionListenerShard, *PConnectionListenerShard;
+
+typedef struct __ConnectionListener {
     volatile ATOMIC_BOOL terminate;
+    // Sockets polled by the single poll() thread when epoll is not available
     PSocketConnection sockets[CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION];
-    UINT64 socketCount;
+    volatile SIZE_T socketCount;
+    // Bumped under lock whenever sockets changes so the receive thread only rebuilds its poll set when needed
+    UINT64 socketListVersion;
     MUTEX lock;
+    // First receive thread, valid once the listener has been started
     TID receiveDataRoutine;
-    PBYTE pBuffer;
-    UINT64 bufferLen;
+    UINT64 cpuAffinity;
+    UINT32 shardCount;
+    PConnectionListenerShard pShards;
+    // Set on a listener attached to the process-wide one. It runs no threads and all its sockets go to one shard of
+    // pSharedListener, so the sockets of one ICE agent are never read on two threads at once.
+    struct __ConnectionListener* pSharedListener;
+    UINT32 sharedShardIndex;
 #if defined(HAVE_SOCKETPAIR)
     INT32 kickSocket[2];
 #endif
@@ -38,6 +98,38 @@ typedef struct {
  */
 STATUS createConnectionListener(PConnectionListener*);
 
+/**
+ * allocate the ConnectionListener struct with several receive threads. Sockets are assigned to the thread that currently
+ * serves the fewest sockets. Without epoll support the listener always runs a single poll() thread.
+ *
+ * @param - UINT32 - IN - number of receive threads, clamped to 1..CONNECTION_LISTENER_MAX_THREAD_COUNT
+ * @param - UINT64 - IN - bit mask of CPUs to pin the receive threads to, 0 to leave them unpinned
+ * @param - PConnectionListener* - IN/OUT - pointer to PConnectionListener being allocated
+ *
+ * @return - STATUS status of execution
+ */
+STATUS createConnectionListenerWithParams(UINT32, UINT64, PConnectionListener*);
+
+/**
+ * attach to the process-wide ConnectionListener, creating and starting it with the given parameters on first use. Later
+ * calls share the threads of the first one and their parameters are ignored. The attached listener runs no threads of its
+ * own, all its sockets are served by the shard with the fewest attached listeners. The process-wide listener is freed with
+ * its last attached listener. Without epoll support a private single thread listener is created instead.
+ *
+ * @param - UINT32 - IN - number of receive threads of the process-wide listener
+ * @param - UINT64 - IN - bit mask of CPUs to pin the receive threads to, 0 to leave them unpinned
+ * @param - PConnectionListener* - IN/OUT - pointer to the attached PConnectionListener, freed with freeConnectionListener
+ *
+ * @return - STATUS status of execution
+ */
+STATUS attachSharedConnectionListener(UINT32, UINT64, PConnectionListener*);
+
+/**
+ * Create and free the lock guarding the process-wide ConnectionListener, called by initKvsWebRtc and deinitKvsWebRtc
+ */
+STATUS createSharedConnectionListenerLock(VOID);
+VOID freeSharedConnectionListenerLock(VOID);
+
 /**
  * free the ConnectionListener struct and all its resources
  *
@@ -77,7 +169,17 @@ STATUS connectionListenerRemoveConnection(PConnectionListener, PSocketConnection
 STATUS connectionListenerRemoveAllConnection(PConnectionListener);
 
 /**
- * Spin off a listener thread that listen for incoming traffic for all PSocketConnection stored in connectionList.
+ * check whether a PSocketConnection is currently being listened to
+ *
+ * @param - PConnectionListener      - IN - the ConnectionListener struct to use
+ * @param - PSocketConnection   - IN - PSocketConnection to look for
+ *
+ * @return - BOOL TRUE if the socket connection is registered with the listener
+ */
+BOOL connectionListenerHasConnection(PConnectionListener, PSocketConnection);
+
+/**
+ * Spin off the listener threads that listen for incoming traffic for all PSocketConnection stored in connectionList.
  * Whenever a PSocketConnection receives data, invoke ConnectionDataAvailableFunc passed in.
  *
  * @param - PConnectionListener      - IN - the ConnectionListener struct to use
@@ -91,6 +193,58 @@ STATUS connectionListenerStart(PConnectionListener);
 ////////////////////////////////////////////
 PVOID connectionListenerReceiveDataRoutine(PVOID arg);
 
+/**
+ * Receive loop of a shard, run by connectionListenerReceiveDataRoutine until the listener terminates
+ *
+ * @param - PConnectionListenerShard - IN - the shard to serve
+ *
+ * @return - STATUS status of execution
+ */
+STATUS connectionListenerPollLoop(PConnectionListenerShard);
+
+#if defined(HAVE_EPOLL)
+/**
+ * epoll based receive loop of a shard, used instead of connectionListenerPollLoop when epoll is available
+ *
+ * @param - PConnectionListenerShard - IN - the shard to serve
+ *
+ * @return - STATUS status of execution
+ */
+STATUS connectionListenerEpollLoop(PConnectionListenerShard);
+
+/**
+ * Unregister the socket stored at a socket table index. Must be called with the shard lock held.
+ *
+ * @param - PConnectionListenerShard - IN - the shard owning the socket
+ * @param - UINT32 - IN - socket table index
+ */
+VOID connectionListenerShardRemoveSocket(PConnectionListenerShard, UINT32);
+#endif
+
+/**
+ * Drain pending data from a readable socket and hand every datagram to the socket data available callback.
+ * UDP sockets are read in batches of CONNECTION_LISTENER_RECV_BATCH_SIZE when recvmmsg is available, at most
+ * CONNECTION_LISTENER_RECV_MAX_BATCHES_PER_WAKEUP of them per call.
+ *
+ * @param - PConnectionListenerShard - IN - shard whose receive buffers are used
+ * @param - PSocketConnection - IN - readable PSocketConnection
+ * @param - INT32 - IN - local socket of the PSocketConnection
+ *
+ * @return - STATUS status of execution
+ */
+STATUS connectionListenerReceiveData(PConnectionListenerShard, PSocketConnection, INT32);
+
+/**
+ * Decrypt a received buffer if needed and invoke the socket data available callback
+ *
+ * @param - PSocketConnection - IN - PSocketConnection the data was read from
+ * @param - PBYTE - IN - received data
+ * @param - UINT32 - IN - size of the receive buffer
+ * @param - INT64 - IN - number of bytes received
+ * @param - struct sockaddr_storage* - IN - source address of the data
+ */
+VOID connectionListenerDispatchData(PSocketConnection, PBYTE, UINT32, INT64, struct sockaddr_storage*);
+
 #ifdef __cplusplus
 }
 #endif
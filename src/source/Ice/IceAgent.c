@@ -41,6 +41,7 @@ STATUS createIceAgent(PCHAR username, PCHAR password, PIceAgentCallbacks pIceAge
     CHK(NULL != (pIceAgent = (PIceAgent) MEMCALLOC(1, SIZEOF(IceAgent))), STATUS_NOT_ENOUGH_MEMORY);
     STRNCPY(pIceAgent->localUsername, username, MAX_ICE_CONFIG_USER_NAME_LEN);
     STRNCPY(pIceAgent->localPassword, password, MAX_ICE_CONFIG_CREDENTIAL_LEN);
+    CHK_STATUS(kvsHmacSha1KeyInit(&pIceAgent->localPasswordKey, (PBYTE) pIceAgent->localPassword, (UINT32) STRLEN(pIceAgent->localPassword)));
     ATOMIC_STORE_BOOL(&pIceAgent->remoteCredentialReceived, FALSE);
     ATOMIC_STORE_BOOL(&pIceAgent->agentStartGathering, FALSE);
     ATOMIC_STORE_BOOL(&pIceAgent->stopGathering, FALSE);
@@ -187,6 +188,8 @@ STATUS freeIceAgent(PIceAgent* ppIceAgent)
 
     pIceAgent = *ppIceAgent;
 
+    iceAgentRetractDataPath(pIceAgent);
+
     if (pIceAgent->localCandidates != NULL) {
         CHK_STATUS(doubleListGetHeadNode(pIceAgent->localCandidates, &pCurNode));
         while (pCurNode != NULL) {
@@ -289,6 +292,8 @@ STATUS freeIceAgent(PIceAgent* ppIceAgent)
     }
 
     CHK_LOG_ERR(hashTableFree(pIceAgent->requestTimestampDiagnostics));
+    CHK_LOG_ERR(kvsHmacSha1KeyFree(&pIceAgent->localPasswordKey));
+    CHK_LOG_ERR(kvsHmacSha1KeyFree(&pIceAgent->remotePasswordKey));
     SAFE_MEMFREE(pIceAgent->pRtcSelectedLocalIceCandidateDiagnostics);
     SAFE_MEMFREE(pIceAgent->pRtcSelectedRemoteIceCandidateDiagnostics);
     for (i = 0; i < MAX_ICE_SERVERS_COUNT; i++) {
@@ -646,6 +651,7 @@ STATUS iceAgentStartAgent(PIceAgent pIceAgent, PCHAR remoteUsername, PCHAR remot
 
     STRNCPY(pIceAgent->remoteUsername, remoteUsername, MAX_ICE_CONFIG_USER_NAME_LEN);
     STRNCPY(pIceAgent->remotePassword, remotePassword, MAX_ICE_CONFIG_CREDENTIAL_LEN);
+    CHK_STATUS(kvsHmacSha1KeyInit(&pIceAgent->remotePasswordKey, (PBYTE) pIceAgent->remotePassword, (UINT32) STRLEN(pIceAgent->remotePassword)));
     if (STRLEN(pIceAgent->remoteUsername) + STRLEN(pIceAgent->localUsername) + 1 > MAX_ICE_CONFIG_USER_NAME_LEN) {
         DLOGW("remoteUsername:localUsername will be truncated to stay within %u char limit", MAX_ICE_CONFIG_USER_NAME_LEN);
     }
@@ -654,9 +660,9 @@ STATUS iceAgentStartAgent(PIceAgent pIceAgent, PCHAR remoteUsername, PCHAR remot
     MUTEX_UNLOCK(pIceAgent->lock);
     locked = FALSE;
 
-    CHK_STATUS(timerQueueAddTimer(pIceAgent->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY,
-                                  pIceAgent->kvsRtcConfiguration.iceConnectionCheckPollingInterval, iceAgentStateTransitionTimerCallback,
-                                  (UINT64) pIceAgent, &pIceAgent->iceAgentStateTimerTask));
+    CHK_STATUS(kvsTimerQueueAddTimer(pIceAgent->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY,
+                                     pIceAgent->kvsRtcConfiguration.iceConnectionCheckPollingInterval, iceAgentStateTransitionTimerCallback,
+                                     (UINT64) pIceAgent, &pIceAgent->iceAgentStateTimerTask));
 
 CleanUp:
 
@@ -707,8 +713,8 @@ STATUS iceAgentStartGathering(PIceAgent pIceAgent)
 
     pIceAgent->candidateGatheringEndTime = GETTIME() + pIceAgent->kvsRtcConfiguration.iceLocalCandidateGatheringTimeout;
 
-    CHK_STATUS(timerQueueAddTimer(pIceAgent->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY, KVS_ICE_GATHER_CANDIDATE_TIMER_POLLING_INTERVAL,
-                                  iceAgentGatherCandidateTimerCallback, (UINT64) pIceAgent, &pIceAgent->iceCandidateGatheringTimerTask));
+    CHK_STATUS(kvsTimerQueueAddTimer(pIceAgent->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY, KVS_ICE_GATHER_CANDIDATE_TIMER_POLLING_INTERVAL,
+                                     iceAgentGatherCandidateTimerCallback, (UINT64) pIceAgent, &pIceAgent->iceCandidateGatheringTimerTask));
 
 CleanUp:
 
@@ -724,94 +730,204 @@ CleanUp:
 STATUS iceAgentSendPacket(PIceAgent pIceAgent, PBYTE pBuffer, UINT32 bufferLen)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    BOOL locked = FALSE, isRelay = FALSE;
+
+    CHK(pIceAgent != NULL && pBuffer != NULL, STATUS_NULL_ARG);
+    CHK(bufferLen != 0, STATUS_INVALID_ARG);
+
+    retStatus = iceAgentSendPackets(pIceAgent, &pBuffer, &bufferLen, 1, NULL);
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS iceAgentSendPackets(PIceAgent pIceAgent, PBYTE* ppBuffers, PUINT32 pBufferLens, UINT32 count, PUINT32 pSentCount)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    BOOL locked = FALSE, isRelay = FALSE, onDataPath = FALSE, connectionClosed = FALSE;
     PTurnConnection pTurnConnection = NULL;
+    PIceCandidatePair pIceCandidatePair = NULL;
+    UINT32 i, sentCount = 0;
     UINT32 packetsDiscarded = 0;
     UINT32 bytesDiscarded = 0;
     UINT32 bytesSent = 0;
     UINT32 packetsSent = 0;
+    SIZE_T publishedPair;
 
-    CHK(pIceAgent != NULL && pBuffer != NULL, STATUS_NULL_ARG);
-    CHK(bufferLen != 0, STATUS_INVALID_ARG);
+    CHK(pIceAgent != NULL && ppBuffers != NULL && pBufferLens != NULL, STATUS_NULL_ARG);
+    for (i = 0; i < count; i++) {
+        CHK(ppBuffers[i] != NULL, STATUS_NULL_ARG);
+        CHK(pBufferLens[i] != 0, STATUS_INVALID_ARG);
+    }
+    CHK(count > 0, retStatus);
 
-    MUTEX_LOCK(pIceAgent->lock);
-    locked = TRUE;
+    // Once READY the selected pair is published and stays valid until iceAgentRetractDataPath returns
+    ATOMIC_INCREMENT(&pIceAgent->dataPathReaders);
+    onDataPath = TRUE;
+    pIceCandidatePair = (PIceCandidatePair) ATOMIC_LOAD(&pIceAgent->dataPathPair);
+    if (pIceCandidatePair == NULL) {
+        ATOMIC_DECREMENT(&pIceAgent->dataPathReaders);
+        onDataPath = FALSE;
+
+        MUTEX_LOCK(pIceAgent->lock);
+        locked = TRUE;
+        pIceCandidatePair = pIceAgent->pDataSendingIceCandidatePair;
+    }
 
     /* Do not proceed if ice is shutting down */
     CHK(!ATOMIC_LOAD_BOOL(&pIceAgent->shutdown), retStatus);
-    CHK(bufferLen != 0, STATUS_INVALID_ARG);
 
-    CHK_WARN(pIceAgent->pDataSendingIceCandidatePair != NULL, retStatus, "No valid ice candidate pair available to send data");
-    CHK_WARN(pIceAgent->pDataSendingIceCandidatePair->state == ICE_CANDIDATE_PAIR_STATE_SUCCEEDED, retStatus,
-             "Invalid state for data sending candidate pair.");
+    CHK_WARN(pIceCandidatePair != NULL, retStatus, "No valid ice candidate pair available to send data");
+    CHK_WARN(pIceCandidatePair->state == ICE_CANDIDATE_PAIR_STATE_SUCCEEDED, retStatus, "Invalid state for data sending candidate pair.");
 
-    CHK_WARN(pIceAgent->pDataSendingIceCandidatePair->local != NULL, retStatus, "Local ice candidate is invalid");
+    CHK_WARN(pIceCandidatePair->local != NULL, retStatus, "Local ice candidate is invalid");
 
-    isRelay = IS_CANN_PAIR_SENDING_FROM_RELAYED(pIceAgent->pDataSendingIceCandidatePair);
+    isRelay = IS_CANN_PAIR_SENDING_FROM_RELAYED(pIceCandidatePair);
     if (isRelay) {
-        CHK_ERR(pIceAgent->pDataSendingIceCandidatePair->local->pTurnConnection != NULL, STATUS_NULL_ARG,
-                "Candidate is relay but pTurnConnection is NULL");
-        pTurnConnection = pIceAgent->pDataSendingIceCandidatePair->local->pTurnConnection;
+        CHK_ERR(pIceCandidatePair->local->pTurnConnection != NULL, STATUS_NULL_ARG, "Candidate is relay but pTurnConnection is NULL");
+        pTurnConnection = pIceCandidatePair->local->pTurnConnection;
     }
 
-    retStatus = iceUtilsSendData(pBuffer, bufferLen, &pIceAgent->pDataSendingIceCandidatePair->remote->ipAddress,
-                                 pIceAgent->pDataSendingIceCandidatePair->local->pSocketConnection, pTurnConnection, isRelay);
+    retStatus = iceUtilsSendDataBatch(ppBuffers, pBufferLens, count, &pIceCandidatePair->remote->ipAddress,
+                                      pIceCandidatePair->local->pSocketConnection, pTurnConnection, isRelay, &sentCount);
+
+    for (i = 0; i < count; i++) {
+        if (i < sentCount) {
+            bytesSent += pBufferLens[i];
+            packetsSent++;
+        } else {
+            // This includes header and padding. TODO: update length to remove header and padding
+            bytesDiscarded += pBufferLens[i];
+            packetsDiscarded++;
+        }
+    }
 
     if (STATUS_FAILED(retStatus)) {
-        DLOGW("iceUtilsSendData failed with 0x%08x", retStatus);
-        packetsDiscarded++;
-        bytesDiscarded = bufferLen; // This includes header and padding. TODO: update length to remove header and padding
+        DLOGW("iceUtilsSendDataBatch failed with 0x%08x after %u of %u packets", retStatus, sentCount, count);
         if (retStatus == STATUS_SOCKET_CONNECTION_CLOSED_ALREADY) {
             DLOGW("IceAgent connection closed unexpectedly");
-            pIceAgent->iceAgentStatus = STATUS_SOCKET_CONNECTION_CLOSED_ALREADY;
-            pIceAgent->pDataSendingIceCandidatePair->state = ICE_CANDIDATE_PAIR_STATE_FAILED;
+            connectionClosed = TRUE;
         }
         retStatus = STATUS_SUCCESS;
-    } else {
-        // TODO: use a better estimate of actual time when packet was sent
-        // eg setsockopt(SO_TIMESTAMPING)
-        // SOF_TIMESTAMPING_TX_HARDWARE - tx timestamps generated by network hardware
-        // SOF_TIMESTAMPING_TX_SOFTWARE - tx timestamps generated by kernel, when data leaves kernel, before hardware
-        pIceAgent->pDataSendingIceCandidatePair->lastDataSentTime = GETTIME();
+    }
 
-        bytesSent = bufferLen;
-        packetsSent++;
+    // Folded into the diagnostics by iceAgentCollectDataPathStats, which also stamps lastDataSentTime
+    if (pIceCandidatePair->pRtcIceCandidatePairDiagnostics != NULL) {
+        if (packetsSent > 0) {
+            ATOMIC_ADD(&pIceCandidatePair->dataPathPacketsSent, packetsSent);
+            ATOMIC_ADD(&pIceCandidatePair->dataPathBytesSent, bytesSent);
+        }
+        if (packetsDiscarded > 0) {
+            ATOMIC_ADD(&pIceCandidatePair->dataPathPacketsDiscarded, packetsDiscarded);
+            ATOMIC_ADD(&pIceCandidatePair->dataPathBytesDiscarded, bytesDiscarded);
+        }
     }
 
 CleanUp:
 
-    if (STATUS_SUCCEEDED(retStatus) && pIceAgent->pDataSendingIceCandidatePair != NULL) {
-        if (pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics != NULL) {
-            pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->packetsDiscardedOnSend += packetsDiscarded;
-            pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->bytesDiscardedOnSend += bytesDiscarded;
-            pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->state = pIceAgent->pDataSendingIceCandidatePair->state;
-            pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->lastPacketSentTimestamp =
-                pIceAgent->pDataSendingIceCandidatePair->lastDataSentTime;
-            pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->bytesSent += bytesSent;
-            pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->packetsSent += packetsSent;
+    if (onDataPath) {
+        ATOMIC_DECREMENT(&pIceAgent->dataPathReaders);
+    }
+
+    if (connectionClosed) {
+        if (!locked) {
+            // Stop other senders from using the closed pair before waiting on the lock
+            publishedPair = (SIZE_T) pIceCandidatePair;
+            ATOMIC_COMPARE_EXCHANGE(&pIceAgent->dataPathPair, &publishedPair, 0);
+            MUTEX_LOCK(pIceAgent->lock);
+            locked = TRUE;
+        }
+
+        // Off the lock the pair may have been replaced in the meantime
+        if (pIceAgent->pDataSendingIceCandidatePair == pIceCandidatePair) {
+            pIceAgent->iceAgentStatus = STATUS_SOCKET_CONNECTION_CLOSED_ALREADY;
+            pIceCandidatePair->state = ICE_CANDIDATE_PAIR_STATE_FAILED;
         }
     }
 
     if (locked) {
+        iceAgentCollectDataPathStats(pIceAgent);
         MUTEX_UNLOCK(pIceAgent->lock);
     }
 
+    if (pSentCount != NULL) {
+        *pSentCount = sentCount;
+    }
+
     return retStatus;
 }
 
-STATUS iceAgentPopulateSdpMediaDescriptionCandidates(PIceAgent pIceAgent, PSdpMediaDescription pSdpMediaDescription, UINT32 attrBufferLen,
-                                                     PUINT32 pIndex)
+VOID iceAgentRetractDataPath(PIceAgent pIceAgent)
+{
+    if (pIceAgent == NULL) {
+        return;
+    }
+
+    ATOMIC_STORE(&pIceAgent->dataPathPair, 0);
+    while (ATOMIC_LOAD(&pIceAgent->dataPathReaders) != 0) {
+        THREAD_SLEEP(KVS_ICE_DATA_PATH_DRAIN_DELAY);
+    }
+
+    iceAgentCollectDataPathStats(pIceAgent);
+}
+
+VOID iceAgentCollectDataPathStats(PIceAgent pIceAgent)
+{
+    PIceCandidatePair pIceCandidatePair;
+    PRtcIceCandidatePairDiagnostics pDiagnostics;
+    UINT64 currentTime;
+
+    if (pIceAgent == NULL) {
+        return;
+    }
+
+    currentTime = GETTIME();
+    if (ATOMIC_EXCHANGE(&pIceAgent->dataPathPacketsReceived, 0) != 0) {
+        pIceAgent->lastDataReceivedTime = currentTime;
+    }
+
+    pIceCandidatePair = pIceAgent->pDataSendingIceCandidatePair;
+    if (pIceCandidatePair == NULL || pIceCandidatePair->pRtcIceCandidatePairDiagnostics == NULL) {
+        return;
+    }
+
+    pDiagnostics = pIceCandidatePair->pRtcIceCandidatePairDiagnostics;
+    if (ATOMIC_LOAD(&pIceCandidatePair->dataPathPacketsSent) != 0) {
+        // TODO: use a better estimate of actual time when packet was sent
+        // eg setsockopt(SO_TIMESTAMPING)
+        // SOF_TIMESTAMPING_TX_HARDWARE - tx timestamps generated by network hardware
+        // SOF_TIMESTAMPING_TX_SOFTWARE - tx timestamps generated by kernel, when data leaves kernel, before hardware
+        pIceCandidatePair->lastDataSentTime = currentTime;
+        pDiagnostics->packetsSent += ATOMIC_EXCHANGE(&pIceCandidatePair->dataPathPacketsSent, 0);
+        pDiagnostics->bytesSent += ATOMIC_EXCHANGE(&pIceCandidatePair->dataPathBytesSent, 0);
+    }
+    if (ATOMIC_LOAD(&pIceCandidatePair->dataPathPacketsDiscarded) != 0) {
+        pDiagnostics->packetsDiscardedOnSend += ATOMIC_EXCHANGE(&pIceCandidatePair->dataPathPacketsDiscarded, 0);
+        pDiagnostics->bytesDiscardedOnSend += ATOMIC_EXCHANGE(&pIceCandidatePair->dataPathBytesDiscarded, 0);
+    }
+    if (ATOMIC_LOAD(&pIceCandidatePair->dataPathPacketsReceived) != 0) {
+        pDiagnostics->lastPacketReceivedTimestamp = currentTime;
+        // Since every byte buffer translates to a single RTP packet
+        pDiagnostics->packetsReceived += ATOMIC_EXCHANGE(&pIceCandidatePair->dataPathPacketsReceived, 0);
+        pDiagnostics->bytesReceived += ATOMIC_EXCHANGE(&pIceCandidatePair->dataPathBytesReceived, 0);
+    }
+
+    pDiagnostics->state = pIceCandidatePair->state;
+    pDiagnostics->lastPacketSentTimestamp = pIceCandidatePair->lastDataSentTime;
+}
+
+STATUS iceAgentPopulateSdpMediaDescriptionCandidates(PIceAgent pIceAgent, PSessionDescription pSessionDescription,
+                                                     PSdpMediaDescription pSdpMediaDescription)
 {
     STATUS retStatus = STATUS_SUCCESS;
     UINT64 data;
     PDoubleListNode pCurNode = NULL;
     BOOL locked = FALSE;
-    UINT32 attrIndex;
+    UINT32 candidateLen;
+    PCHAR pCandidateStr = NULL;
     PIceCandidate pCandidate = NULL;
 
-    CHK(pIceAgent != NULL && pSdpMediaDescription != NULL && pIndex != NULL, STATUS_NULL_ARG);
-
-    attrIndex = *pIndex;
+    CHK(pIceAgent != NULL && pSessionDescription != NULL && pSdpMediaDescription != NULL, STATUS_NULL_ARG);
 
     MUTEX_LOCK(pIceAgent->lock);
     locked = TRUE;
@@ -822,14 +938,13 @@ STATUS iceAgentPopulateSdpMediaDescriptionCandidates(PIceAgent pIceAgent, PSdpMe
         pCurNode = pCurNode->pNext;
         pCandidate = (PIceCandidate) data;
         if (pCandidate->state == ICE_CANDIDATE_STATE_VALID) {
-            STRCPY(pSdpMediaDescription->sdpAttributes[attrIndex].attributeName, "candidate");
-            CHK_STATUS(iceCandidateSerialize((PIceCandidate) data, pSdpMediaDescription->sdpAttributes[attrIndex].attributeValue, &attrBufferLen));
-            attrIndex++;
+            CHK_STATUS(iceCandidateSerialize(pCandidate, NULL, &candidateLen));
+            CHK_STATUS(sdpArenaAlloc(pSessionDescription, candidateLen, (PVOID*) &pCandidateStr));
+            CHK_STATUS(iceCandidateSerialize(pCandidate, pCandidateStr, &candidateLen));
+            CHK_STATUS(sdpAppendAttribute(pSessionDescription, pSdpMediaDescription, "candidate", pCandidateStr));
         }
     }
 
-    *pIndex = attrIndex;
-
 CleanUp:
 
     if (locked) {
@@ -867,18 +982,20 @@ STATUS iceAgentShutdown(PIceAgent pIceAgent)
     MUTEX_UNLOCK(pIceAgent->lock);
 
     if (stateTimerTask != MAX_UINT32) {
-        CHK_STATUS(timerQueueCancelTimer(pIceAgent->timerQueueHandle, stateTimerTask, (UINT64) pIceAgent));
+        CHK_STATUS(kvsTimerQueueCancelTimer(pIceAgent->timerQueueHandle, stateTimerTask, (UINT64) pIceAgent));
     }
     if (keepAliveTask != MAX_UINT32) {
-        CHK_STATUS(timerQueueCancelTimer(pIceAgent->timerQueueHandle, keepAliveTask, (UINT64) pIceAgent));
+        CHK_STATUS(kvsTimerQueueCancelTimer(pIceAgent->timerQueueHandle, keepAliveTask, (UINT64) pIceAgent));
     }
     if (gatheringTask != MAX_UINT32) {
-        CHK_STATUS(timerQueueCancelTimer(pIceAgent->timerQueueHandle, gatheringTask, (UINT64) pIceAgent));
+        CHK_STATUS(kvsTimerQueueCancelTimer(pIceAgent->timerQueueHandle, gatheringTask, (UINT64) pIceAgent));
     }
 
     MUTEX_LOCK(pIceAgent->lock);
     locked = TRUE;
 
+    iceAgentRetractDataPath(pIceAgent);
+
     CHK_STATUS(doubleListGetHeadNode(pIceAgent->localCandidates, &pCurNode));
     while (pCurNode != NULL) {
         pLocalCandidate = (PIceCandidate) pCurNode->data;
@@ -950,17 +1067,17 @@ STATUS iceAgentRestart(PIceAgent pIceAgent, PCHAR localIceUfrag, PCHAR localIceP
     CHK(!alreadyRestarting, retStatus);
 
     if (pIceAgent->iceAgentStateTimerTask != MAX_UINT32) {
-        CHK_STATUS(timerQueueCancelTimer(pIceAgent->timerQueueHandle, pIceAgent->iceAgentStateTimerTask, (UINT64) pIceAgent));
+        CHK_STATUS(kvsTimerQueueCancelTimer(pIceAgent->timerQueueHandle, pIceAgent->iceAgentStateTimerTask, (UINT64) pIceAgent));
         pIceAgent->iceAgentStateTimerTask = MAX_UINT32;
     }
 
     if (pIceAgent->keepAliveTimerTask != MAX_UINT32) {
-        CHK_STATUS(timerQueueCancelTimer(pIceAgent->timerQueueHandle, pIceAgent->keepAliveTimerTask, (UINT64) pIceAgent));
+        CHK_STATUS(kvsTimerQueueCancelTimer(pIceAgent->timerQueueHandle, pIceAgent->keepAliveTimerTask, (UINT64) pIceAgent));
         pIceAgent->keepAliveTimerTask = MAX_UINT32;
     }
 
     if (pIceAgent->iceCandidateGatheringTimerTask != MAX_UINT32) {
-        CHK_STATUS(timerQueueCancelTimer(pIceAgent->timerQueueHandle, pIceAgent->iceCandidateGatheringTimerTask, (UINT64) pIceAgent));
+        CHK_STATUS(kvsTimerQueueCancelTimer(pIceAgent->timerQueueHandle, pIceAgent->iceCandidateGatheringTimerTask, (UINT64) pIceAgent));
         pIceAgent->iceCandidateGatheringTimerTask = MAX_UINT32;
     }
 
@@ -1048,6 +1165,7 @@ STATUS iceAgentRestart(PIceAgent pIceAgent, PCHAR localIceUfrag, PCHAR localIceP
 
     STRNCPY(pIceAgent->localUsername, localIceUfrag, MAX_ICE_CONFIG_USER_NAME_LEN);
     STRNCPY(pIceAgent->localPassword, localIcePwd, MAX_ICE_CONFIG_CREDENTIAL_LEN);
+    CHK_STATUS(kvsHmacSha1KeyInit(&pIceAgent->localPasswordKey, (PBYTE) pIceAgent->localPassword, (UINT32) STRLEN(pIceAgent->localPassword)));
 
     pIceAgent->iceAgentState = ICE_AGENT_STATE_NEW;
     CHK_STATUS(setStateMachineCurrentState(pIceAgent->pStateMachine, ICE_AGENT_STATE_NEW));
@@ -1369,6 +1487,7 @@ STATUS iceCandidatePairCheckConnection(PStunPacket pStunBindingRequest, PIceAgen
 {
     STATUS retStatus = STATUS_SUCCESS;
     PStunAttributePriority pStunAttributePriority = NULL;
+    PStunPacketTemplate pTemplate = NULL;
     UINT32 checkSum = 0;
 
     CHK(pStunBindingRequest != NULL && pIceAgent != NULL && pIceCandidatePair != NULL, STATUS_NULL_ARG);
@@ -1400,8 +1519,17 @@ STATUS iceCandidatePairCheckConnection(PStunPacket pStunBindingRequest, PIceAgen
         pIceAgent->pRtcIceServerDiagnostics[pIceCandidatePair->local->iceServerIndex]->totalRequestsSent++;
     }
 
-    CHK_STATUS(iceAgentSendStunPacket(pStunBindingRequest, (PBYTE) pIceAgent->remotePassword,
-                                      (UINT32) STRLEN(pIceAgent->remotePassword) * SIZEOF(CHAR), pIceAgent, pIceCandidatePair->local,
+    // Checks only differ by transaction id and priority so they go out of the pre-serialized request. The template is
+    // rebuilt when handed another packet, or when the packet had attributes appended since.
+    pTemplate = &pIceAgent->bindingRequestTemplate;
+    if (pTemplate->packetLen == 0 || pTemplate->pStunPacket != pStunBindingRequest ||
+        pTemplate->attributesCount != pStunBindingRequest->attributesCount) {
+        CHK_STATUS(stunPacketTemplateInit(pStunBindingRequest, &pIceAgent->remotePasswordKey, pTemplate));
+    }
+
+    CHK_STATUS(stunPacketTemplateUpdate(pTemplate, &pIceAgent->remotePasswordKey, pStunBindingRequest->header.transactionId,
+                                        pStunAttributePriority->priority));
+    CHK_STATUS(iceAgentSendStunBuffer(pTemplate->packet, pTemplate->packetLen, pIceAgent, pIceCandidatePair->local,
                                       &pIceCandidatePair->remote->ipAddress));
 
     if (pIceCandidatePair->pRtcIceCandidatePairDiagnostics != NULL) {
@@ -1415,21 +1543,39 @@ CleanUp:
     return retStatus;
 }
 
-STATUS iceAgentSendStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32 passwordLen, PIceAgent pIceAgent, PIceCandidate pLocalCandidate,
+STATUS iceAgentSendStunPacket(PStunPacket pStunPacket, PKvsHmacSha1Key pHmacKey, PIceAgent pIceAgent, PIceCandidate pLocalCandidate,
                               PKvsIpAddress pDestAddr)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 stunPacketSize = STUN_PACKET_ALLOCATION_SIZE;
+    BYTE stunPacketBuffer[STUN_PACKET_ALLOCATION_SIZE];
+
+    CHK(pStunPacket != NULL, STATUS_NULL_ARG);
+
+    CHK_STATUS(serializeStunPacketWithKey(pStunPacket, pHmacKey, TRUE, stunPacketBuffer, &stunPacketSize));
+    CHK_STATUS(iceAgentSendStunBuffer(stunPacketBuffer, stunPacketSize, pIceAgent, pLocalCandidate, pDestAddr));
+
+CleanUp:
+
+    CHK_LOG_ERR(retStatus);
+
+    return retStatus;
+}
+
+STATUS iceAgentSendStunBuffer(PBYTE pBuffer, UINT32 size, PIceAgent pIceAgent, PIceCandidate pLocalCandidate, PKvsIpAddress pDestAddr)
 {
     STATUS retStatus = STATUS_SUCCESS;
     PIceCandidatePair pIceCandidatePair = NULL;
 
     // Assuming holding pIceAgent->lock
 
-    CHK(pStunPacket != NULL && pIceAgent != NULL && pLocalCandidate != NULL && pDestAddr != NULL, STATUS_NULL_ARG);
+    CHK(pBuffer != NULL && pIceAgent != NULL && pLocalCandidate != NULL && pDestAddr != NULL, STATUS_NULL_ARG);
 
-    retStatus = iceUtilsSendStunPacket(pStunPacket, password, passwordLen, pDestAddr, pLocalCandidate->pSocketConnection,
-                                       pLocalCandidate->pTurnConnection, pLocalCandidate->iceCandidateType == ICE_CANDIDATE_TYPE_RELAYED);
+    retStatus = iceUtilsSendStunBuffer(pBuffer, size, pDestAddr, pLocalCandidate->pSocketConnection, pLocalCandidate->pTurnConnection,
+                                       pLocalCandidate->iceCandidateType == ICE_CANDIDATE_TYPE_RELAYED);
 
     if (STATUS_FAILED(retStatus)) {
-        DLOGW("iceUtilsSendStunPacket failed with 0x%08x", retStatus);
+        DLOGW("iceUtilsSendStunBuffer failed with 0x%08x", retStatus);
 
         if (retStatus == STATUS_SOCKET_CONNECTION_CLOSED_ALREADY) {
             pLocalCandidate->state = ICE_CANDIDATE_STATE_INVALID;
@@ -1557,7 +1703,7 @@ STATUS iceAgentSendSrflxCandidateRequest(PIceAgent pIceAgent)
                     transactionIdStoreInsert(pIceAgent->pStunBindingRequestTransactionIdStore, pBindingRequest->header.transactionId);
                     checkSum = COMPUTE_CRC32(pBindingRequest->header.transactionId, ARRAY_SIZE(pBindingRequest->header.transactionId));
 
-                    CHK_STATUS(iceAgentSendStunPacket(pBindingRequest, NULL, 0, pIceAgent, pCandidate, pStunServerAddr));
+                    CHK_STATUS(iceAgentSendStunPacket(pBindingRequest, NULL, pIceAgent, pCandidate, pStunServerAddr));
                     if (pIceAgent->pRtcIceServerDiagnostics[pCandidate->iceServerIndex] != NULL) {
                         pIceAgent->pRtcIceServerDiagnostics[pCandidate->iceServerIndex]->totalRequestsSent++;
                         CHK_STATUS(hashTableUpsert(pIceAgent->requestTimestampDiagnostics, checkSum, GETTIME()));
@@ -1662,7 +1808,7 @@ STATUS iceAgentSendKeepAliveTimerCallback(UINT32 timerId, UINT64 currentTime, UI
         if (pIceCandidatePair->state == ICE_CANDIDATE_PAIR_STATE_SUCCEEDED) {
             pIceCandidatePair->lastDataSentTime = currentTime;
             DLOGV("send keep alive");
-            CHK_STATUS(iceAgentSendStunPacket(pIceAgent->pBindingIndication, NULL, 0, pIceAgent, pIceCandidatePair->local,
+            CHK_STATUS(iceAgentSendStunPacket(pIceAgent->pBindingIndication, NULL, pIceAgent, pIceCandidatePair->local,
                                               &pIceCandidatePair->remote->ipAddress));
         }
     }
@@ -2162,6 +2308,7 @@ STATUS iceAgentCheckConnectionStateSetup(PIceAgent pIceAgent)
         CHK_STATUS(appendStunIceControllAttribute(pIceAgent->pBindingRequest,
                                                   pIceAgent->isControlling ? STUN_ATTRIBUTE_TYPE_ICE_CONTROLLING : STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED,
                                                   pIceAgent->tieBreaker));
+        CHK_STATUS(stunPacketTemplateInit(pIceAgent->pBindingRequest, &pIceAgent->remotePasswordKey, &pIceAgent->bindingRequestTemplate));
     }
 
     pIceAgent->stateEndTime = GETTIME() + pIceAgent->kvsRtcConfiguration.iceConnectionCheckTimeout;
@@ -2258,6 +2405,7 @@ STATUS iceAgentConnectedStateSetup(PIceAgent pIceAgent)
         // connection listener thread, and that thread needs pIceAgent->lock in
         // its data callback. Defer the cleanup to after the lock is released.
         ATOMIC_STORE_BOOL(&pIceAgent->restart, FALSE);
+        iceAgentRetractDataPath(pIceAgent);
         pIceAgent->pDeferredOldPairCleanup = pIceAgent->pDataSendingIceCandidatePair;
         pIceAgent->pDataSendingIceCandidatePair = NULL;
     }
@@ -2278,8 +2426,8 @@ STATUS iceAgentConnectedStateSetup(PIceAgent pIceAgent)
     }
 
     // schedule sending keep alive
-    CHK_STATUS(timerQueueAddTimer(pIceAgent->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY, KVS_ICE_SEND_KEEP_ALIVE_INTERVAL,
-                                  iceAgentSendKeepAliveTimerCallback, (UINT64) pIceAgent, &pIceAgent->keepAliveTimerTask));
+    CHK_STATUS(kvsTimerQueueAddTimer(pIceAgent->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY, KVS_ICE_SEND_KEEP_ALIVE_INTERVAL,
+                                     iceAgentSendKeepAliveTimerCallback, (UINT64) pIceAgent, &pIceAgent->keepAliveTimerTask));
 
 CleanUp:
 
@@ -2317,6 +2465,7 @@ STATUS iceAgentNominatingStateSetup(PIceAgent pIceAgent)
         CHK_STATUS(appendStunPriorityAttribute(pIceAgent->pBindingRequest, 0));
         CHK_STATUS(appendStunIceControllAttribute(pIceAgent->pBindingRequest, STUN_ATTRIBUTE_TYPE_ICE_CONTROLLING, pIceAgent->tieBreaker));
         CHK_STATUS(appendStunFlagAttribute(pIceAgent->pBindingRequest, STUN_ATTRIBUTE_TYPE_USE_CANDIDATE));
+        CHK_STATUS(stunPacketTemplateInit(pIceAgent->pBindingRequest, &pIceAgent->remotePasswordKey, &pIceAgent->bindingRequestTemplate));
     }
 
     pIceAgent->stateEndTime = GETTIME() + pIceAgent->kvsRtcConfiguration.iceCandidateNominationTimeout;
@@ -2351,12 +2500,15 @@ STATUS iceAgentReadyStateSetup(PIceAgent pIceAgent)
 
     CHK(pIceAgent != NULL, STATUS_NULL_ARG);
 
-    CHK_STATUS(timerQueueUpdateTimerPeriod(pIceAgent->timerQueueHandle, (UINT64) pIceAgent, pIceAgent->iceAgentStateTimerTask,
-                                           KVS_ICE_STATE_READY_TIMER_POLLING_INTERVAL));
+    CHK_STATUS(kvsTimerQueueUpdateTimerPeriod(pIceAgent->timerQueueHandle, (UINT64) pIceAgent, pIceAgent->iceAgentStateTimerTask,
+                                              KVS_ICE_STATE_READY_TIMER_POLLING_INTERVAL));
 
     MUTEX_LOCK(pIceAgent->lock);
     locked = TRUE;
 
+    // Re-entering READY, e.g. after a disconnection, may free the pair media is flowing on
+    iceAgentRetractDataPath(pIceAgent);
+
     // if data sending pair already selected and is nominated, no need to find it again
     if (pIceAgent->pDataSendingIceCandidatePair == NULL) {
         // find nominated pair
@@ -2421,6 +2573,10 @@ STATUS iceAgentReadyStateSetup(PIceAgent pIceAgent)
         }
     }
 
+    if (pIceAgent->pDataSendingIceCandidatePair->state == ICE_CANDIDATE_PAIR_STATE_SUCCEEDED) {
+        ATOMIC_STORE(&pIceAgent->dataPathPair, (SIZE_T) pIceAgent->pDataSendingIceCandidatePair);
+    }
+
 CleanUp:
 
     CHK_LOG_ERR(retStatus);
@@ -2548,22 +2704,53 @@ CleanUp:
     return retStatus;
 }
 
+BOOL iceCandidatePairMatchesSource(PIceCandidatePair pIceCandidatePair, PSocketConnection pSocketConnection, PKvsIpAddress pSrc)
+{
+    UINT32 addrLen = IS_IPV4_ADDR(pSrc) ? IPV4_ADDRESS_LENGTH : IPV6_ADDRESS_LENGTH;
+
+    return pIceCandidatePair->local->pSocketConnection == pSocketConnection && pIceCandidatePair->remote->ipAddress.family == pSrc->family &&
+        MEMCMP(pIceCandidatePair->remote->ipAddress.address, pSrc->address, addrLen) == 0 &&
+        pIceCandidatePair->remote->ipAddress.port == pSrc->port;
+}
+
 STATUS incomingDataHandler(UINT64 customData, PSocketConnection pSocketConnection, PBYTE pBuffer, UINT32 bufferLen, PKvsIpAddress pSrc,
                            PKvsIpAddress pDest)
 {
     STATUS retStatus = STATUS_SUCCESS;
     PIceAgent pIceAgent = (PIceAgent) customData;
-    BOOL locked = FALSE;
-    UINT32 addrLen = 0;
+    PIceCandidatePair pIceCandidatePair = NULL;
+    BOOL locked = FALSE, isMedia;
     CHK(pIceAgent != NULL && pSocketConnection != NULL, STATUS_NULL_ARG);
 
+    // for stun packets, first 8 bytes are 4 byte type and length, then 4 byte magic byte
+    isMedia = (bufferLen < 8 || !IS_STUN_PACKET(pBuffer)) && pIceAgent->iceAgentCallbacks.inboundPacketFn != NULL;
+
+    // Media on a READY agent only bumps counters the state machine folds in, leaving the lock to stun and timers
+    if (isMedia) {
+        ATOMIC_INCREMENT(&pIceAgent->dataPathReaders);
+        pIceCandidatePair = (PIceCandidatePair) ATOMIC_LOAD(&pIceAgent->dataPathPair);
+        if (pIceCandidatePair != NULL) {
+            ATOMIC_INCREMENT(&pIceAgent->dataPathPacketsReceived);
+            if (pIceCandidatePair->pRtcIceCandidatePairDiagnostics != NULL &&
+                iceCandidatePairMatchesSource(pIceCandidatePair, pSocketConnection, pSrc)) {
+                ATOMIC_INCREMENT(&pIceCandidatePair->dataPathPacketsReceived);
+                ATOMIC_ADD(&pIceCandidatePair->dataPathBytesReceived, bufferLen);
+            }
+        }
+        ATOMIC_DECREMENT(&pIceAgent->dataPathReaders);
+
+        if (pIceCandidatePair != NULL) {
+            pIceAgent->iceAgentCallbacks.inboundPacketFn(pIceAgent->iceAgentCallbacks.customData, pBuffer, bufferLen);
+            CHK(FALSE, retStatus);
+        }
+    }
+
     MUTEX_LOCK(pIceAgent->lock);
     locked = TRUE;
 
     pIceAgent->lastDataReceivedTime = GETTIME();
 
-    // for stun packets, first 8 bytes are 4 byte type and length, then 4 byte magic byte
-    if ((bufferLen < 8 || !IS_STUN_PACKET(pBuffer)) && pIceAgent->iceAgentCallbacks.inboundPacketFn != NULL) {
+    if (isMedia) {
         // release lock early
 
         MUTEX_UNLOCK(pIceAgent->lock);
@@ -2572,12 +2759,8 @@ STATUS incomingDataHandler(UINT64 customData, PSocketConnection pSocketConnectio
 
         MUTEX_LOCK(pIceAgent->lock);
         locked = TRUE;
-        addrLen = IS_IPV4_ADDR(pSrc) ? IPV4_ADDRESS_LENGTH : IPV6_ADDRESS_LENGTH;
         if (pIceAgent->pDataSendingIceCandidatePair != NULL &&
-            pIceAgent->pDataSendingIceCandidatePair->local->pSocketConnection == pSocketConnection &&
-            pIceAgent->pDataSendingIceCandidatePair->remote->ipAddress.family == pSrc->family &&
-            MEMCMP(pIceAgent->pDataSendingIceCandidatePair->remote->ipAddress.address, pSrc->address, addrLen) == 0 &&
-            (pIceAgent->pDataSendingIceCandidatePair->remote->ipAddress.port == pSrc->port)) {
+            iceCandidatePairMatchesSource(pIceAgent->pDataSendingIceCandidatePair, pSocketConnection, pSrc)) {
             if (pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics != NULL) {
                 pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->lastPacketReceivedTimestamp = GETTIME();
                 pIceAgent->pDataSendingIceCandidatePair->pRtcIceCandidatePairDiagnostics->bytesReceived += bufferLen;
@@ -2652,12 +2835,13 @@ STATUS handleStunPacket(PIceAgent pIceAgent, PBYTE pBuffer, UINT32 bufferLen, PS
     UNUSED_PARAM(pDestAddr);
 
     STATUS retStatus = STATUS_SUCCESS;
-    PStunPacket pStunPacket = NULL, pStunResponse = NULL;
-    PStunAttributeHeader pStunAttr = NULL;
+    StunPacketView stunPacketView;
+    PStunAttributeView pStunAttr = NULL;
+    PStunPacket pStunResponse = NULL;
+    UINT64 responseStorage[STUN_BINDING_RESPONSE_STORAGE_SIZE / SIZEOF(UINT64)];
+    KvsIpAddress mappedAddress;
     UINT16 stunPacketType = 0;
     PIceCandidatePair pIceCandidatePair = NULL;
-    PStunAttributeAddress pStunAttributeAddress = NULL;
-    PStunAttributePriority pStunAttributePriority = NULL;
     UINT32 priority = 0;
     PIceCandidate pIceCandidate = NULL;
     CHAR ipAddrStr[KVS_IP_ADDRESS_STRING_BUFFER_LEN], ipAddrStr2[KVS_IP_ADDRESS_STRING_BUFFER_LEN];
@@ -2675,42 +2859,43 @@ STATUS handleStunPacket(PIceAgent pIceAgent, PBYTE pBuffer, UINT32 bufferLen, PS
     switch (stunPacketType) {
         case STUN_PACKET_TYPE_BINDING_REQUEST:
             connectivityCheckRequestsReceived++;
-            CHK_STATUS(deserializeStunPacket(pBuffer, bufferLen, (PBYTE) pIceAgent->localPassword,
-                                             (UINT32) STRLEN(pIceAgent->localPassword) * SIZEOF(CHAR), &pStunPacket));
+            CHK_STATUS(stunPacketViewInit(pBuffer, bufferLen, &pIceAgent->localPasswordKey, &stunPacketView));
 
             // RFC 8445 §7.3.1.1: a lite agent is always controlled. If the remote peer signals ICE-CONTROLLED, that is a
             // role conflict — reply with a 487 Binding Error Response and do not process the request further.
             if (pIceAgent->isLiteAgent) {
-                PStunAttributeHeader pIceControlledAttr = NULL;
-                CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED, &pIceControlledAttr));
+                PStunAttributeView pIceControlledAttr = NULL;
+                CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED, &pIceControlledAttr));
                 if (pIceControlledAttr != NULL) {
                     DLOGW("ICE-lite: received Binding Request with ICE-CONTROLLED from remote; replying 487 Role Conflict");
-                    CHK_STATUS(createStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_ERROR, pStunPacket->header.transactionId, &pStunResponse));
+                    CHK_STATUS(initStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_ERROR, stunPacketView.transactionId, (PBYTE) responseStorage,
+                                              SIZEOF(responseStorage), &pStunResponse));
                     CHK_STATUS(appendStunErrorCodeAttribute(pStunResponse, (PCHAR) "Role Conflict", 487));
                     CHK_STATUS(findCandidateWithSocketConnection(pSocketConnection, pIceAgent->localCandidates, &pIceCandidate));
                     if (pIceCandidate != NULL) {
-                        iceAgentSendStunPacket(pStunResponse, (PBYTE) pIceAgent->localPassword,
-                                               (UINT32) STRLEN(pIceAgent->localPassword) * SIZEOF(CHAR), pIceAgent, pIceCandidate, pSrcAddr);
+                        iceAgentSendStunPacket(pStunResponse, &pIceAgent->localPasswordKey, pIceAgent, pIceCandidate, pSrcAddr);
                     }
-                    // stop processing; CleanUp will free pStunPacket and pStunResponse
+                    // stop processing, the response lives on the stack
                     CHK(FALSE, retStatus);
                 }
             }
 
-            CHK_STATUS(createStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS, pStunPacket->header.transactionId, &pStunResponse));
+            CHK_STATUS(initStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS, stunPacketView.transactionId, (PBYTE) responseStorage,
+                                      SIZEOF(responseStorage), &pStunResponse));
             CHK_STATUS(appendStunAddressAttribute(pStunResponse, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, pSrcAddr));
             CHK_STATUS(appendStunIceControllAttribute(
                 pStunResponse, pIceAgent->isControlling ? STUN_ATTRIBUTE_TYPE_ICE_CONTROLLING : STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED,
                 pIceAgent->tieBreaker));
 
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_PRIORITY, (PStunAttributeHeader*) &pStunAttributePriority));
-            priority = pStunAttributePriority == NULL ? 0 : pStunAttributePriority->priority;
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_PRIORITY, &pStunAttr));
+            if (pStunAttr != NULL) {
+                CHK_STATUS(stunAttributeViewGetUint32(pStunAttr, &priority));
+            }
             CHK_STATUS(iceAgentCheckPeerReflexiveCandidate(pIceAgent, pSrcAddr, priority, TRUE, 0));
 
             CHK_STATUS(findCandidateWithSocketConnection(pSocketConnection, pIceAgent->localCandidates, &pIceCandidate));
             CHK_WARN(pIceCandidate != NULL, retStatus, "Could not find local candidate to send STUN response");
-            CHK_STATUS(iceAgentSendStunPacket(pStunResponse, (PBYTE) pIceAgent->localPassword,
-                                              (UINT32) STRLEN(pIceAgent->localPassword) * SIZEOF(CHAR), pIceAgent, pIceCandidate, pSrcAddr));
+            CHK_STATUS(iceAgentSendStunPacket(pStunResponse, &pIceAgent->localPasswordKey, pIceAgent, pIceCandidate, pSrcAddr));
 
             connectivityCheckResponsesSent++;
             // return early if there is no candidate pair. This can happen when we get connectivity check from the peer
@@ -2720,7 +2905,7 @@ STATUS handleStunPacket(PIceAgent pIceAgent, PBYTE pBuffer, UINT32 bufferLen, PS
             DLOGD("Pair binding request! %s %s", pIceCandidatePair->local->id, pIceCandidatePair->remote->id);
 
             if (!pIceCandidatePair->nominated) {
-                CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_USE_CANDIDATE, &pStunAttr));
+                CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_USE_CANDIDATE, &pStunAttr));
                 if (pStunAttr != NULL) {
                     DLOGI("received candidate with USE_CANDIDATE flag, local candidate type %s(%s:%s).",
                           iceAgentGetCandidateTypeStr(pIceCandidatePair->local->iceCandidateType), pIceCandidatePair->local->id,
@@ -2773,14 +2958,13 @@ STATUS handleStunPacket(PIceAgent pIceAgent, PBYTE pBuffer, UINT32 bufferLen, PS
                     }
                 }
 
-                CHK_STATUS(deserializeStunPacket(pBuffer, bufferLen, NULL, 0, &pStunPacket));
-                CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, &pStunAttr));
+                CHK_STATUS(stunPacketViewInit(pBuffer, bufferLen, NULL, &stunPacketView));
+                CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, &pStunAttr));
                 CHK_WARN(pStunAttr != NULL, retStatus, "No mapped address attribute found in STUN binding response. Dropping Packet");
-
-                pStunAttributeAddress = (PStunAttributeAddress) pStunAttr;
+                CHK_STATUS(stunAttributeViewGetAddress(&stunPacketView, pStunAttr, &mappedAddress));
 
                 // Update the server reflexive address which later will be picked up by the timer callback
-                CHK_STATUS(updateCandidateAddress(pIceCandidate, &pStunAttributeAddress->address));
+                CHK_STATUS(updateCandidateAddress(pIceCandidate, &mappedAddress));
 
                 // Remove from the transaction id store as we no longer are awaiting for the bind response
                 transactionIdStoreRemove(pIceAgent->pStunBindingRequestTransactionIdStore, pBuffer + STUN_PACKET_TRANSACTION_ID_OFFSET);
@@ -2820,16 +3004,14 @@ STATUS handleStunPacket(PIceAgent pIceAgent, PBYTE pBuffer, UINT32 bufferLen, PS
                     }
                 }
             }
-            CHK_STATUS(deserializeStunPacket(pBuffer, bufferLen, (PBYTE) pIceAgent->remotePassword,
-                                             (UINT32) STRLEN(pIceAgent->remotePassword) * SIZEOF(CHAR), &pStunPacket));
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, &pStunAttr));
+            CHK_STATUS(stunPacketViewInit(pBuffer, bufferLen, &pIceAgent->remotePasswordKey, &stunPacketView));
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, &pStunAttr));
             CHK_WARN(pStunAttr != NULL, retStatus, "No mapped address attribute found in STUN response. Dropping Packet");
-
-            pStunAttributeAddress = (PStunAttributeAddress) pStunAttr;
+            CHK_STATUS(stunAttributeViewGetAddress(&stunPacketView, pStunAttr, &mappedAddress));
 
             if (pIceCandidatePair->local->iceCandidateType == ICE_CANDIDATE_TYPE_SERVER_REFLEXIVE &&
                 pIceCandidatePair->remote->iceCandidateType == ICE_CANDIDATE_TYPE_SERVER_REFLEXIVE &&
-                !isSameIpAddress(&pStunAttributeAddress->address, &pIceCandidatePair->local->ipAddress, FALSE)) {
+                !isSameIpAddress(&mappedAddress, &pIceCandidatePair->local->ipAddress, FALSE)) {
                 // this can happen for host and server reflexive candidates. If the peer
                 // is in the same subnet, server reflexive candidate's binding response's xor mapped IP address will be
                 // the host candidate IP address. In this case we will ignore the packet since the host candidate will
@@ -2837,8 +3019,8 @@ STATUS handleStunPacket(PIceAgent pIceAgent, PBYTE pBuffer, UINT32 bufferLen, PS
                 DLOGD("local candidate IP address does not match with xor mapped address in binding response");
 
                 // we have a peer reflexive local candidate
-                CHK_STATUS(iceAgentCheckPeerReflexiveCandidate(pIceAgent, &pStunAttributeAddress->address, pIceCandidatePair->local->priority, FALSE,
-                                                               pSocketConnection));
+                CHK_STATUS(
+                    iceAgentCheckPeerReflexiveCandidate(pIceAgent, &mappedAddress, pIceCandidatePair->local->priority, FALSE, pSocketConnection));
             }
 
             if (pIceCandidatePair->state != ICE_CANDIDATE_PAIR_STATE_SUCCEEDED) {
@@ -2907,14 +3089,6 @@ CleanUp:
 
     SAFE_MEMFREE(hexStr);
 
-    if (pStunPacket != NULL) {
-        freeStunPacket(&pStunPacket);
-    }
-
-    if (pStunResponse != NULL) {
-        freeStunPacket(&pStunResponse);
-    }
-
     // TODO send error packet
 
     return retStatus;
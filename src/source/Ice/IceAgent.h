@@ -24,6 +24,7 @@ extern "C" {
 #define KVS_ICE_TURN_CONNECTION_SHUTDOWN_TIMEOUT (1 * HUNDREDS_OF_NANOS_IN_A_SECOND)
 #define KVS_ICE_DEFAULT_TIMER_START_DELAY        (3 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
 #define KVS_ICE_SHORT_CHECK_DELAY                (50 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
+#define KVS_ICE_DATA_PATH_DRAIN_DELAY            (100 * HUNDREDS_OF_NANOS_IN_A_MICROSECOND)
 
 // Ta in https://tools.ietf.org/html/rfc8445
 #define KVS_ICE_CONNECTION_CHECK_POLLING_INTERVAL  (50 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
@@ -191,6 +192,14 @@ typedef struct {
     UINT64 roundTripTime;
     UINT64 responsesReceived;
     PRtcIceCandidatePairDiagnostics pRtcIceCandidatePairDiagnostics;
+
+    // Media counters not yet folded into pRtcIceCandidatePairDiagnostics, only kept when it is allocated
+    volatile SIZE_T dataPathPacketsSent;
+    volatile SIZE_T dataPathBytesSent;
+    volatile SIZE_T dataPathPacketsDiscarded;
+    volatile SIZE_T dataPathBytesDiscarded;
+    volatile SIZE_T dataPathPacketsReceived;
+    volatile SIZE_T dataPathBytesReceived;
 } IceCandidatePair, *PIceCandidatePair;
 
 typedef struct {
@@ -219,6 +228,8 @@ struct __IceAgent {
     CHAR remoteUsername[MAX_ICE_CONFIG_USER_NAME_LEN + 1];
     CHAR remotePassword[MAX_ICE_CONFIG_CREDENTIAL_LEN + 1];
     CHAR combinedUserName[(MAX_ICE_CONFIG_USER_NAME_LEN + 1) << 1]; //!< the combination of remote user name and local user name.
+    KvsHmacSha1Key localPasswordKey;                                //!< MESSAGE-INTEGRITY key schedule of localPassword, signs responses
+    KvsHmacSha1Key remotePasswordKey;                               //!< MESSAGE-INTEGRITY key schedule of remotePassword, signs requests
 
     PRtcIceServerDiagnostics pRtcIceServerDiagnostics[MAX_ICE_SERVERS_COUNT];
     PRtcIceCandidateDiagnostics pRtcSelectedLocalIceCandidateDiagnostics;
@@ -252,6 +263,11 @@ struct __IceAgent {
     UINT64 stateEndTime;
     UINT64 candidateGatheringEndTime;
     PIceCandidatePair pDataSendingIceCandidatePair;
+    // Copy of pDataSendingIceCandidatePair published while READY so media can be sent and received without the lock.
+    // Cleared by iceAgentRetractDataPath, which also waits for the threads still using it.
+    volatile SIZE_T dataPathPair;
+    volatile SIZE_T dataPathReaders;         //!< Threads currently using dataPathPair
+    volatile SIZE_T dataPathPacketsReceived; //!< Media received on the data path since lastDataReceivedTime was refreshed
     // Old data-sending pair deferred for cleanup after the state machine
     // lock is released (to avoid deadlocking with the connection listener).
     PIceCandidatePair pDeferredOldPairCleanup;
@@ -282,6 +298,8 @@ struct __IceAgent {
     // Pre-allocated stun packets
     PStunPacket pBindingIndication;
     PStunPacket pBindingRequest;
+    // pBindingRequest pre-serialized, connectivity checks only patch the transaction id and priority
+    StunPacketTemplate bindingRequestTemplate;
 
     // store transaction ids for stun binding request.
     PTransactionIdStore pStunBindingRequestTransactionIdStore;
@@ -368,6 +386,21 @@ STATUS iceCandidateSerialize(PIceCandidate, PCHAR, PUINT32);
  */
 STATUS iceAgentSendPacket(PIceAgent, PBYTE, UINT32);
 
+/**
+ * Send several packets through the selected connection while holding the agent lock once. On a plain UDP pair the whole
+ * batch is handed to the kernel in as few syscalls as the platform allows. PIceAgent has to be in
+ * ICE_AGENT_CONNECTION_STATE_CONNECTED state.
+ *
+ * @param - PIceAgent - IN - IceAgent object
+ * @param - PBYTE* - IN - buffers storing the packets to be sent
+ * @param - PUINT32 - IN - length of each packet
+ * @param - UINT32 - IN - number of packets
+ * @param - PUINT32 - OUT - number of leading packets that were sent (OPTIONAL)
+ *
+ * @return - STATUS - status of execution
+ */
+STATUS iceAgentSendPackets(PIceAgent, PBYTE*, PUINT32, UINT32, PUINT32);
+
 /**
  * gather local IP addresses and create a udp port. If port creation succeeded then create a new candidate
  * and store it in localCandidates. Ips that are already a local candidate will not be added again.
@@ -379,16 +412,15 @@ STATUS iceAgentSendPacket(PIceAgent, PBYTE, UINT32);
 STATUS iceAgentInitHostCandidate(PIceAgent);
 
 /**
- * Starting from given index, fillout PSdpMediaDescription->sdpAttributes with serialize local candidate strings.
+ * Appends the serialized valid local candidates to the sdpAttributes of PSdpMediaDescription.
  *
  * @param - PIceAgent - IN - IceAgent object
- * @param - PSdpMediaDescription - IN - PSdpMediaDescription object whose sdpAttributes will be filled with local candidate strings
- * @param - UINT32 - IN - buffer length of pSdpMediaDescription->sdpAttributes[index].attributeValue
- * @param - PUINT32 - IN - starting index in sdpAttributes
+ * @param - PSessionDescription - IN - SessionDescription owning the media section, the candidate strings go to its arena
+ * @param - PSdpMediaDescription - IN - PSdpMediaDescription object whose sdpAttributes will be appended the local candidate strings
  *
  * @return - STATUS - status of execution
  */
-STATUS iceAgentPopulateSdpMediaDescriptionCandidates(PIceAgent, PSdpMediaDescription, UINT32, PUINT32);
+STATUS iceAgentPopulateSdpMediaDescriptionCandidates(PIceAgent, PSessionDescription, PSdpMediaDescription);
 
 /**
  * Start shutdown sequence for IceAgent. Once the function returns Ice will not deliver anymore data and
@@ -432,13 +464,15 @@ STATUS createIceCandidatePairs(PIceAgent, PIceCandidate, BOOL);
 STATUS freeIceCandidatePair(PIceCandidatePair*);
 STATUS insertIceCandidatePair(PDoubleList, PIceCandidatePair);
 STATUS findIceCandidatePairWithLocalSocketConnectionAndRemoteAddr(PIceAgent, PSocketConnection, PKvsIpAddress, BOOL, PIceCandidatePair*);
+BOOL iceCandidatePairMatchesSource(PIceCandidatePair, PSocketConnection, PKvsIpAddress);
 STATUS pruneUnconnectedIceCandidatePair(PIceAgent);
 STATUS iceCandidatePairCheckConnection(PStunPacket, PIceAgent, PIceCandidatePair);
 
 STATUS iceAgentSendSrflxCandidateRequest(PIceAgent);
 STATUS iceAgentCheckCandidatePairConnection(PIceAgent);
 STATUS iceAgentSendCandidateNomination(PIceAgent);
-STATUS iceAgentSendStunPacket(PStunPacket, PBYTE, UINT32, PIceAgent, PIceCandidate, PKvsIpAddress);
+STATUS iceAgentSendStunPacket(PStunPacket, PKvsHmacSha1Key, PIceAgent, PIceCandidate, PKvsIpAddress);
+STATUS iceAgentSendStunBuffer(PBYTE, UINT32, PIceAgent, PIceCandidate, PKvsIpAddress);
 
 STATUS iceAgentInitHostCandidate(PIceAgent);
 STATUS iceAgentInitSrflxCandidate(PIceAgent);
@@ -462,6 +496,22 @@ STATUS iceAgentNominateCandidatePair(PIceAgent);
 STATUS iceAgentInvalidateCandidatePair(PIceAgent);
 STATUS iceAgentCheckPeerReflexiveCandidate(PIceAgent, PKvsIpAddress, UINT32, BOOL, PSocketConnection);
 STATUS iceAgentFatalError(PIceAgent, STATUS);
+
+/**
+ * Stops media from using the lock-free data path and waits for the threads still on it. Must be called before
+ * pDataSendingIceCandidatePair changes or is freed. Assumes holding pIceAgent->lock, if any.
+ *
+ * @param - PIceAgent - IN - IceAgent object
+ */
+VOID iceAgentRetractDataPath(PIceAgent);
+
+/**
+ * Folds the counters kept by the lock-free data path into lastDataReceivedTime and the selected pair diagnostics.
+ * Assumes holding pIceAgent->lock.
+ *
+ * @param - PIceAgent - IN - IceAgent object
+ */
+VOID iceAgentCollectDataPathStats(PIceAgent);
 VOID iceAgentLogNewCandidate(PIceCandidate);
 
 UINT32 computeCandidatePriority(PIceCandidate);
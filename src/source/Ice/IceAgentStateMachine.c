@@ -114,6 +114,9 @@ STATUS iceAgentStateMachineCheckDisconnection(PIceAgent pIceAgent, PUINT64 pNext
 
     CHK(pIceAgent != NULL && pNextState != NULL, STATUS_NULL_ARG);
 
+    // Media received without the lock is only accounted for here
+    iceAgentCollectDataPathStats(pIceAgent);
+
     currentTime = GETTIME();
     if (!pIceAgent->detectedDisconnection && IS_VALID_TIMESTAMP(pIceAgent->lastDataReceivedTime) &&
         pIceAgent->lastDataReceivedTime + pIceAgent->kvsRtcConfiguration.iceDisconnectionTimeout <= currentTime) {
@@ -149,9 +149,11 @@ STATUS iceUtilsPackageStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32
         addMessageIntegrity = TRUE;
     }
 
-    CHK_STATUS(serializeStunPacket(pStunPacket, password, passwordLen, addMessageIntegrity, TRUE, NULL, &stunPacketSize));
-    CHK(stunPacketSize <= *pBufferLen, STATUS_BUFFER_TOO_SMALL);
-    CHK_STATUS(serializeStunPacket(pStunPacket, password, passwordLen, addMessageIntegrity, TRUE, pBuffer, &stunPacketSize));
+    // Single pass, the serializer bounds every write by the buffer size
+    stunPacketSize = *pBufferLen;
+    retStatus = serializeStunPacket(pStunPacket, password, passwordLen, addMessageIntegrity, TRUE, pBuffer, &stunPacketSize);
+    CHK(retStatus != STATUS_NOT_ENOUGH_MEMORY, STATUS_BUFFER_TOO_SMALL);
+    CHK_STATUS(retStatus);
     *pBufferLen = stunPacketSize;
 
 CleanUp:
@@ -168,35 +170,47 @@ STATUS iceUtilsSendStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32 pa
     UINT32 stunPacketSize = STUN_PACKET_ALLOCATION_SIZE;
     BYTE stunPacketBuffer[STUN_PACKET_ALLOCATION_SIZE];
 
-    CHAR ipAddrStr[KVS_IP_ADDRESS_STRING_BUFFER_LEN];
+    CHK_STATUS(iceUtilsPackageStunPacket(pStunPacket, password, passwordLen, stunPacketBuffer, &stunPacketSize));
+    CHK_STATUS(iceUtilsSendStunBuffer(stunPacketBuffer, stunPacketSize, pDest, pSocketConnection, pTurnConnection, useTurn));
 
-    CHK_STATUS(getIpAddrStr(pDest, ipAddrStr, ARRAY_SIZE(ipAddrStr)));
+CleanUp:
 
-    CHK_STATUS(iceUtilsPackageStunPacket(pStunPacket, password, passwordLen, stunPacketBuffer, &stunPacketSize));
-    CHK(pDest != NULL, STATUS_NULL_ARG);
-    switch (pStunPacket->header.stunMessageType) {
-        case STUN_PACKET_TYPE_BINDING_REQUEST:
-            if (pDest->family == KVS_IP_FAMILY_TYPE_IPV4) {
-                DLOGD("Sending BINDING_REQUEST on socket id: %d, to ip:%s, port:%u", pSocketConnection->localSocket, ipAddrStr,
-                      (UINT16) getInt16(pDest->port));
-            } else {
-                DLOGD("Sending BINDING_REQUEST on socket id: %d, to ip:%s, port:%u", pSocketConnection->localSocket, ipAddrStr,
-                      (UINT16) getInt16(pDest->port));
-            }
-            break;
-        case STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS:
-            if (pDest->family == KVS_IP_FAMILY_TYPE_IPV4) {
-                DLOGD("Sending BINDING_RESPONSE_SUCCESS on socket id: %d to ip:%s, port:%u", pSocketConnection->localSocket, ipAddrStr,
-                      (UINT16) getInt16(pDest->port));
-            } else {
-                DLOGD("Sending BINDING_RESPONSE_SUCCESS on socket id: %d to ip:%s, port:%u", pSocketConnection->localSocket, ipAddrStr,
-                      (UINT16) getInt16(pDest->port));
-            }
-            break;
-        default:
-            break;
+    CHK_LOG_ERR(retStatus);
+
+    return retStatus;
+}
+
+STATUS iceUtilsSendStunBuffer(PBYTE pBuffer, UINT32 size, PKvsIpAddress pDest, PSocketConnection pSocketConnection, PTurnConnection pTurnConnection,
+                              BOOL useTurn)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    CHAR ipAddrStr[KVS_IP_ADDRESS_STRING_BUFFER_LEN];
+    PCHAR typeStr = NULL;
+
+    CHK(pBuffer != NULL && pDest != NULL, STATUS_NULL_ARG);
+    CHK(size >= STUN_HEADER_LEN, STATUS_INVALID_ARG);
+
+    // Formatting the address is only worth it when the line is going to be logged
+    if (GET_LOGGER_LOG_LEVEL() <= LOG_LEVEL_DEBUG) {
+        switch ((UINT16) getInt16(*(PINT16) pBuffer)) {
+            case STUN_PACKET_TYPE_BINDING_REQUEST:
+                typeStr = "BINDING_REQUEST";
+                break;
+            case STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS:
+                typeStr = "BINDING_RESPONSE_SUCCESS";
+                break;
+            default:
+                break;
+        }
+
+        if (typeStr != NULL && pSocketConnection != NULL) {
+            CHK_STATUS(getIpAddrStr(pDest, ipAddrStr, ARRAY_SIZE(ipAddrStr)));
+            DLOGD("Sending %s on socket id: %d to ip:%s, port:%u", typeStr, pSocketConnection->localSocket, ipAddrStr,
+                  (UINT16) getInt16(pDest->port));
+        }
     }
-    CHK_STATUS(iceUtilsSendData(stunPacketBuffer, stunPacketSize, pDest, pSocketConnection, pTurnConnection, useTurn));
+
+    CHK_STATUS(iceUtilsSendData(pBuffer, size, pDest, pSocketConnection, pTurnConnection, useTurn));
 
 CleanUp:
 
@@ -229,6 +243,45 @@ CleanUp:
     return retStatus;
 }
 
+STATUS iceUtilsSendDataBatch(PBYTE* ppBuffers, PUINT32 pBufferLens, UINT32 count, PKvsIpAddress pDest, PSocketConnection pSocketConnection,
+                             PTurnConnection pTurnConnection, BOOL useTurn, PUINT32 pSentCount)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 sentCount = 0;
+
+    CHK((pSocketConnection != NULL && !useTurn) || (pTurnConnection != NULL && useTurn), STATUS_INVALID_ARG);
+
+    if (useTurn) {
+        // Every datagram gets its own TURN framing, so relayed data goes out one packet at a time
+        while (sentCount < count) {
+            retStatus = turnConnectionSendData(pTurnConnection, ppBuffers[sentCount], pBufferLens[sentCount], pDest);
+            if (STATUS_FAILED(retStatus)) {
+                break;
+            }
+            sentCount++;
+        }
+    } else {
+        retStatus = socketConnectionSendDataBatch(pSocketConnection, ppBuffers, pBufferLens, count, pDest, &sentCount);
+    }
+
+    // Fix-up the not-yet-ready socket
+    if (retStatus == STATUS_SOCKET_CONNECTION_NOT_READY_TO_SEND) {
+        sentCount = count;
+    }
+    CHK(STATUS_SUCCEEDED(retStatus) || retStatus == STATUS_SOCKET_CONNECTION_NOT_READY_TO_SEND, retStatus);
+    retStatus = STATUS_SUCCESS;
+
+CleanUp:
+
+    if (pSentCount != NULL) {
+        *pSentCount = sentCount;
+    }
+
+    CHK_LOG_ERR(retStatus);
+
+    return retStatus;
+}
+
 STATUS parseIceServer(PIceServer pIceServer, PCHAR url, PCHAR username, PCHAR credential)
 {
     ENTERS();
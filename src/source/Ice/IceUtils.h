@@ -48,7 +48,9 @@ STATUS iceUtilsGenerateTransactionId(PBYTE, UINT32);
 // Stun packaging and sending functions
 STATUS iceUtilsPackageStunPacket(PStunPacket, PBYTE, UINT32, PBYTE, PUINT32);
 STATUS iceUtilsSendStunPacket(PStunPacket, PBYTE, UINT32, PKvsIpAddress, PSocketConnection, struct __TurnConnection*, BOOL);
+STATUS iceUtilsSendStunBuffer(PBYTE, UINT32, PKvsIpAddress, PSocketConnection, struct __TurnConnection*, BOOL);
 STATUS iceUtilsSendData(PBYTE, UINT32, PKvsIpAddress, PSocketConnection, struct __TurnConnection*, BOOL);
+STATUS iceUtilsSendDataBatch(PBYTE*, PUINT32, UINT32, PKvsIpAddress, PSocketConnection, struct __TurnConnection*, BOOL, PUINT32);
 
 typedef struct {
     // isTurn ? TURN server : STUN server
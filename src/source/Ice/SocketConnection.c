@@ -2,6 +2,10 @@
  * Kinesis Video Tcp
  */
 #define LOG_CLASS "SocketConnection"
+#if defined(HAVE_SENDMMSG) && !defined(_GNU_SOURCE)
+// sendmmsg and struct mmsghdr are GNU extensions
+#define _GNU_SOURCE
+#endif
 #include "../Include_i.h"
 
 STATUS createSocketConnection(KVS_IP_FAMILY_TYPE familyType, KVS_SOCKET_PROTOCOL protocol, PKvsIpAddress pBindAddr, PKvsIpAddress pPeerIpAddr,
@@ -254,6 +258,114 @@ CleanUp:
     return retStatus;
 }
 
+STATUS socketConnectionSendDataBatch(PSocketConnection pSocketConnection, PBYTE* ppBuffers, PUINT32 pBufferLens, UINT32 count, PKvsIpAddress pDestIp,
+                                     PUINT32 pSentCount)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    BOOL locked = FALSE;
+    UINT32 i, sentCount = 0;
+
+    CHK(pSocketConnection != NULL && ppBuffers != NULL && pBufferLens != NULL, STATUS_NULL_ARG);
+    CHK((pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_TCP || pDestIp != NULL), STATUS_INVALID_ARG);
+
+    // Using a single CHK_WARN might output too much spew in bad network conditions
+    if (ATOMIC_LOAD_BOOL(&pSocketConnection->connectionClosed)) {
+        DLOGW("Warning: Failed to send data. Socket closed already");
+        CHK(FALSE, STATUS_SOCKET_CONNECTION_CLOSED_ALREADY);
+    }
+
+    /* Should have valid buffers */
+    for (i = 0; i < count; i++) {
+        CHK(ppBuffers[i] != NULL && pBufferLens[i] > 0, STATUS_INVALID_ARG);
+    }
+
+    MUTEX_LOCK(pSocketConnection->lock);
+    locked = TRUE;
+
+    if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_UDP && count > 1) {
+        CHK_STATUS(socketSendDataBatchWithRetry(pSocketConnection, ppBuffers, pBufferLens, count, pDestIp, &sentCount));
+    } else {
+        for (; sentCount < count; sentCount++) {
+            if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_TCP && pSocketConnection->secureConnection) {
+                CHK_STATUS(tlsSessionPutApplicationData(pSocketConnection->pTlsSession, ppBuffers[sentCount], pBufferLens[sentCount]));
+            } else if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_TCP) {
+                CHK_STATUS(socketSendDataWithRetry(pSocketConnection, ppBuffers[sentCount], pBufferLens[sentCount], NULL, NULL));
+            } else if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_UDP) {
+                CHK_STATUS(socketSendDataWithRetry(pSocketConnection, ppBuffers[sentCount], pBufferLens[sentCount], pDestIp, NULL));
+            } else {
+                CHECK_EXT(FALSE, "socketConnectionSendDataBatch should not reach here. Nothing is sent.");
+            }
+        }
+    }
+
+CleanUp:
+
+    if (locked) {
+        MUTEX_UNLOCK(pSocketConnection->lock);
+    }
+
+    if (pSentCount != NULL) {
+        *pSentCount = sentCount;
+    }
+
+    return retStatus;
+}
+
+STATUS socketConnectionSendDataGather(PSocketConnection pSocketConnection, PBYTE* ppBuffers, PUINT32 pBufferLens, UINT32 count, PKvsIpAddress pDestIp)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    BOOL locked = FALSE;
+    BYTE gatherBuffer[SOCKET_SEND_GATHER_STACK_BUFFER_LEN];
+    UINT32 i, totalLen = 0;
+
+    CHK(pSocketConnection != NULL && ppBuffers != NULL && pBufferLens != NULL, STATUS_NULL_ARG);
+    CHK((pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_TCP || pDestIp != NULL), STATUS_INVALID_ARG);
+    CHK(count > 0 && count <= SOCKET_SEND_GATHER_MAX_BUFFERS, STATUS_INVALID_ARG);
+
+    // Using a single CHK_WARN might output too much spew in bad network conditions
+    if (ATOMIC_LOAD_BOOL(&pSocketConnection->connectionClosed)) {
+        DLOGW("Warning: Failed to send data. Socket closed already");
+        CHK(FALSE, STATUS_SOCKET_CONNECTION_CLOSED_ALREADY);
+    }
+
+    /* Should have valid buffers */
+    for (i = 0; i < count; i++) {
+        CHK(ppBuffers[i] != NULL && pBufferLens[i] > 0, STATUS_INVALID_ARG);
+        totalLen += pBufferLens[i];
+    }
+
+    MUTEX_LOCK(pSocketConnection->lock);
+    locked = TRUE;
+
+    if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_TCP && pSocketConnection->secureConnection) {
+        if (totalLen <= SIZEOF(gatherBuffer)) {
+            for (i = 0, totalLen = 0; i < count; totalLen += pBufferLens[i], i++) {
+                MEMCPY(gatherBuffer + totalLen, ppBuffers[i], pBufferLens[i]);
+            }
+            CHK_STATUS(tlsSessionPutApplicationData(pSocketConnection->pTlsSession, gatherBuffer, totalLen));
+        } else {
+            // The stream keeps the parts contiguous as long as the connection lock is held
+            for (i = 0; i < count; i++) {
+                CHK_STATUS(tlsSessionPutApplicationData(pSocketConnection->pTlsSession, ppBuffers[i], pBufferLens[i]));
+            }
+        }
+    } else if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_TCP) {
+        CHK_STATUS(socketSendDataGatherWithRetry(pSocketConnection, ppBuffers, pBufferLens, count, NULL));
+    } else if (pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_UDP) {
+        CHK_STATUS(socketSendDataGatherWithRetry(pSocketConnection, ppBuffers, pBufferLens, count, pDestIp));
+    } else {
+        CHECK_EXT(FALSE, "socketConnectionSendDataGather should not reach here. Nothing is sent.");
+    }
+
+CleanUp:
+
+    if (locked) {
+        MUTEX_UNLOCK(pSocketConnection->lock);
+    }
+
+    return retStatus;
+}
+
 STATUS socketConnectionReadData(PSocketConnection pSocketConnection, PBYTE pBuf, UINT32 bufferLen, PUINT32 pDataLen)
 {
     STATUS retStatus = STATUS_SUCCESS;
@@ -467,3 +579,278 @@ CleanUp:
 
     return retStatus;
 }
+
+STATUS socketSendDataBatchWithRetry(PSocketConnection pSocketConnection, PBYTE* ppBuffers, PUINT32 pBufferLens, UINT32 count, PKvsIpAddress pDestIp,
+                                    PUINT32 pSentCount)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 sentCount = 0;
+#ifdef HAVE_SENDMMSG
+    INT32 socketWriteAttempt = 0, result = 0, pollResult = 0, errorNum = 0;
+    UINT32 windowCount, msgCount, segmentCount, segmentBytes, i;
+    BOOL useGso = FALSE;
+    UINT16 gsoSize;
+    struct pollfd wfds;
+    socklen_t addrLen = 0;
+    struct sockaddr* destAddr = NULL;
+    struct sockaddr_in ipv4Addr;
+    struct sockaddr_in6 ipv6Addr;
+    struct mmsghdr msgs[SOCKET_SEND_BATCH_MAX_PACKETS];
+    struct iovec iovs[SOCKET_SEND_BATCH_MAX_PACKETS];
+    UINT32 msgPacketCount[SOCKET_SEND_BATCH_MAX_PACKETS];
+#ifdef UDP_SEGMENT
+    // CMSG_SPACE keeps every row a multiple of the header alignment, so aligning the array aligns each row
+    BYTE gsoControl[SOCKET_SEND_BATCH_MAX_PACKETS][CMSG_SPACE(SIZEOF(UINT16))] __attribute__((aligned(__alignof__(struct cmsghdr))));
+    struct cmsghdr* pCmsg;
+#endif
+#endif
+
+    CHK(pSocketConnection != NULL && ppBuffers != NULL && pBufferLens != NULL && pDestIp != NULL, STATUS_NULL_ARG);
+
+#ifdef HAVE_SENDMMSG
+    if (IS_IPV4_ADDR(pDestIp)) {
+        addrLen = SIZEOF(ipv4Addr);
+        MEMSET(&ipv4Addr, 0x00, SIZEOF(ipv4Addr));
+        ipv4Addr.sin_family = AF_INET;
+        ipv4Addr.sin_port = pDestIp->port;
+        MEMCPY(&ipv4Addr.sin_addr, pDestIp->address, IPV4_ADDRESS_LENGTH);
+        destAddr = (struct sockaddr*) &ipv4Addr;
+    } else {
+        addrLen = SIZEOF(ipv6Addr);
+        MEMSET(&ipv6Addr, 0x00, SIZEOF(ipv6Addr));
+        ipv6Addr.sin6_family = AF_INET6;
+        ipv6Addr.sin6_port = pDestIp->port;
+        MEMCPY(&ipv6Addr.sin6_addr, pDestIp->address, IPV6_ADDRESS_LENGTH);
+        destAddr = (struct sockaddr*) &ipv6Addr;
+    }
+
+    while (sentCount < count && socketWriteAttempt < MAX_SOCKET_WRITE_RETRY) {
+        windowCount = MIN(count - sentCount, SOCKET_SEND_BATCH_MAX_PACKETS);
+        MEMSET(msgs, 0x00, SIZEOF(struct mmsghdr) * windowCount);
+#ifdef UDP_SEGMENT
+        useGso = !pSocketConnection->gsoDisabled;
+#endif
+
+        for (i = 0; i < windowCount; i++) {
+            iovs[i].iov_base = ppBuffers[sentCount + i];
+            iovs[i].iov_len = pBufferLens[sentCount + i];
+        }
+
+        for (i = 0, msgCount = 0; i < windowCount; i += segmentCount, msgCount++) {
+            // A GSO message carries a run of equally sized datagrams where only the last one may be shorter
+            segmentCount = 1;
+            segmentBytes = (UINT32) iovs[i].iov_len;
+            while (useGso && i + segmentCount < windowCount && segmentCount < SOCKET_GSO_MAX_SEGMENTS &&
+                   iovs[i + segmentCount - 1].iov_len == iovs[i].iov_len && iovs[i + segmentCount].iov_len <= iovs[i].iov_len &&
+                   segmentBytes + iovs[i + segmentCount].iov_len <= SOCKET_GSO_MAX_BYTES) {
+                segmentBytes += (UINT32) iovs[i + segmentCount].iov_len;
+                segmentCount++;
+            }
+
+            msgs[msgCount].msg_hdr.msg_name = destAddr;
+            msgs[msgCount].msg_hdr.msg_namelen = addrLen;
+            msgs[msgCount].msg_hdr.msg_iov = &iovs[i];
+            msgs[msgCount].msg_hdr.msg_iovlen = segmentCount;
+            msgPacketCount[msgCount] = segmentCount;
+#ifdef UDP_SEGMENT
+            if (segmentCount > 1) {
+                msgs[msgCount].msg_hdr.msg_control = gsoControl[msgCount];
+                msgs[msgCount].msg_hdr.msg_controllen = SIZEOF(gsoControl[msgCount]);
+                pCmsg = CMSG_FIRSTHDR(&msgs[msgCount].msg_hdr);
+                pCmsg->cmsg_level = IPPROTO_UDP;
+                pCmsg->cmsg_type = UDP_SEGMENT;
+                pCmsg->cmsg_len = CMSG_LEN(SIZEOF(UINT16));
+                gsoSize = (UINT16) iovs[i].iov_len;
+                MEMCPY(CMSG_DATA(pCmsg), &gsoSize, SIZEOF(UINT16));
+            }
+#endif
+        }
+
+        result = sendmmsg(pSocketConnection->localSocket, msgs, msgCount, NO_SIGNAL_SEND);
+        if (result > 0) {
+            // Datagrams are never partially written, a short count means the rest of the batch is retried
+            for (i = 0; i < (UINT32) result; i++) {
+                sentCount += msgPacketCount[i];
+            }
+            continue;
+        }
+
+        errorNum = result < 0 ? getErrorCode() : EAGAIN;
+        if (useGso && (errorNum == EIO || errorNum == EINVAL || errorNum == ENOPROTOOPT || errorNum == EOPNOTSUPP)) {
+            // Kernel or NIC cannot segment, fall back to one datagram per message without counting an attempt
+            DLOGI("UDP_SEGMENT rejected on socket %d with errno %s(%d), disabling GSO", pSocketConnection->localSocket, getErrorString(errorNum),
+                  errorNum);
+            pSocketConnection->gsoDisabled = TRUE;
+            continue;
+        } else if (errorNum == EAGAIN || errorNum == EWOULDBLOCK) {
+            MEMSET(&wfds, 0x00, SIZEOF(struct pollfd));
+            wfds.fd = pSocketConnection->localSocket;
+            wfds.events = POLLOUT;
+            wfds.revents = 0;
+            pollResult = POLL(&wfds, 1, SOCKET_SEND_RETRY_TIMEOUT_MILLI_SECOND);
+
+            if (pollResult == 0) {
+                /* loop back and try again */
+                DLOGE("poll() timed out");
+            } else if (pollResult < 0) {
+                DLOGE("poll() failed with errno %s", getErrorString(getErrorCode()));
+                break;
+            }
+        } else if (errorNum == EINTR) {
+            /* nothing need to be done, just retry */
+        } else {
+            /* fatal error from sendmmsg() */
+            DLOGE("sendmmsg() socket %d failed with errno %s(%d)", pSocketConnection->localSocket, getErrorString(errorNum), errorNum);
+            break;
+        }
+
+        // Indicate an attempt only on error
+        socketWriteAttempt++;
+    }
+
+    if (result < 0) {
+        CLOSE_SOCKET_IF_CANT_RETRY(errorNum, pSocketConnection);
+    }
+#else
+    for (; sentCount < count; sentCount++) {
+        CHK_STATUS(socketSendDataWithRetry(pSocketConnection, ppBuffers[sentCount], pBufferLens[sentCount], pDestIp, NULL));
+    }
+#endif
+
+    if (sentCount < count) {
+        DLOGD("Failed to send batch. Packets sent %u. Batch size %u", sentCount, count);
+        retStatus = STATUS_SEND_DATA_FAILED;
+    }
+
+CleanUp:
+
+    if (pSentCount != NULL) {
+        *pSentCount = sentCount;
+    }
+
+    // CHK_LOG_ERR might be too verbose in this case
+    if (STATUS_FAILED(retStatus)) {
+        DLOGD("Warning: Send data batch failed with 0x%08x", retStatus);
+    }
+
+    return retStatus;
+}
+
+STATUS socketSendDataGatherWithRetry(PSocketConnection pSocketConnection, PBYTE* ppBuffers, PUINT32 pBufferLens, UINT32 count, PKvsIpAddress pDestIp)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 i, totalLen = 0;
+#ifndef _WIN32
+    INT32 socketWriteAttempt = 0, errorNum = 0;
+    SSIZE_T result = 0;
+    UINT32 bytesWritten = 0, iovIndex = 0;
+    struct pollfd wfds;
+    struct msghdr msg;
+    struct iovec iovs[SOCKET_SEND_GATHER_MAX_BUFFERS];
+    struct sockaddr_in ipv4Addr;
+    struct sockaddr_in6 ipv6Addr;
+#else
+    BYTE gatherBuffer[SOCKET_SEND_GATHER_STACK_BUFFER_LEN];
+#endif
+
+    CHK(pSocketConnection != NULL && ppBuffers != NULL && pBufferLens != NULL, STATUS_NULL_ARG);
+    CHK(count > 0 && count <= SOCKET_SEND_GATHER_MAX_BUFFERS, STATUS_INVALID_ARG);
+
+    for (i = 0; i < count; i++) {
+        totalLen += pBufferLens[i];
+    }
+
+#ifndef _WIN32
+    MEMSET(&msg, 0x00, SIZEOF(struct msghdr));
+    if (pDestIp != NULL) {
+        if (IS_IPV4_ADDR(pDestIp)) {
+            MEMSET(&ipv4Addr, 0x00, SIZEOF(ipv4Addr));
+            ipv4Addr.sin_family = AF_INET;
+            ipv4Addr.sin_port = pDestIp->port;
+            MEMCPY(&ipv4Addr.sin_addr, pDestIp->address, IPV4_ADDRESS_LENGTH);
+            msg.msg_name = &ipv4Addr;
+            msg.msg_namelen = SIZEOF(ipv4Addr);
+        } else {
+            MEMSET(&ipv6Addr, 0x00, SIZEOF(ipv6Addr));
+            ipv6Addr.sin6_family = AF_INET6;
+            ipv6Addr.sin6_port = pDestIp->port;
+            MEMCPY(&ipv6Addr.sin6_addr, pDestIp->address, IPV6_ADDRESS_LENGTH);
+            msg.msg_name = &ipv6Addr;
+            msg.msg_namelen = SIZEOF(ipv6Addr);
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        iovs[i].iov_base = ppBuffers[i];
+        iovs[i].iov_len = pBufferLens[i];
+    }
+
+    while (socketWriteAttempt < MAX_SOCKET_WRITE_RETRY && bytesWritten < totalLen) {
+        msg.msg_iov = &iovs[iovIndex];
+        msg.msg_iovlen = count - iovIndex;
+        result = sendmsg(pSocketConnection->localSocket, &msg, NO_SIGNAL_SEND);
+        if (result < 0) {
+            errorNum = getErrorCode();
+            if (errorNum == EAGAIN || errorNum == EWOULDBLOCK) {
+                MEMSET(&wfds, 0x00, SIZEOF(struct pollfd));
+                wfds.fd = pSocketConnection->localSocket;
+                wfds.events = POLLOUT;
+                wfds.revents = 0;
+                if (POLL(&wfds, 1, SOCKET_SEND_RETRY_TIMEOUT_MILLI_SECOND) < 0) {
+                    DLOGE("poll() failed with errno %s", getErrorString(getErrorCode()));
+                    break;
+                }
+            } else if (errorNum != EINTR) {
+                /* fatal error from sendmsg() */
+                DLOGE("sendmsg() socket %d failed with errno %s(%d)", pSocketConnection->localSocket, getErrorString(errorNum), errorNum);
+                break;
+            }
+
+            // Indicate an attempt only on error
+            socketWriteAttempt++;
+        } else {
+            // A stream socket may take part of the message, resume from where it stopped
+            bytesWritten += (UINT32) result;
+            for (; iovIndex < count && (SIZE_T) result >= iovs[iovIndex].iov_len; iovIndex++) {
+                result -= iovs[iovIndex].iov_len;
+            }
+            if (iovIndex < count) {
+                iovs[iovIndex].iov_base = (PBYTE) iovs[iovIndex].iov_base + result;
+                iovs[iovIndex].iov_len -= result;
+            }
+            result = 0;
+        }
+    }
+
+    if (result < 0) {
+        CLOSE_SOCKET_IF_CANT_RETRY(errorNum, pSocketConnection);
+    }
+
+    if (bytesWritten < totalLen) {
+        DLOGD("Failed to send data. Bytes sent %u. Data len %u. Retry count %u", bytesWritten, totalLen, socketWriteAttempt);
+        retStatus = STATUS_SEND_DATA_FAILED;
+    }
+#else
+    if (totalLen <= SIZEOF(gatherBuffer)) {
+        for (i = 0, totalLen = 0; i < count; totalLen += pBufferLens[i], i++) {
+            MEMCPY(gatherBuffer + totalLen, ppBuffers[i], pBufferLens[i]);
+        }
+        CHK_STATUS(socketSendDataWithRetry(pSocketConnection, gatherBuffer, totalLen, pDestIp, NULL));
+    } else {
+        // Splitting is only safe on a stream
+        CHK(pSocketConnection->protocol == KVS_SOCKET_PROTOCOL_TCP, STATUS_BUFFER_TOO_SMALL);
+        for (i = 0; i < count; i++) {
+            CHK_STATUS(socketSendDataWithRetry(pSocketConnection, ppBuffers[i], pBufferLens[i], pDestIp, NULL));
+        }
+    }
+#endif
+
+CleanUp:
+
+    // CHK_LOG_ERR might be too verbose in this case
+    if (STATUS_FAILED(retStatus)) {
+        DLOGD("Warning: Send data gather failed with 0x%08x", retStatus);
+    }
+
+    return retStatus;
+}
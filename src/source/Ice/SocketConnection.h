@@ -13,6 +13,17 @@ extern "C" {
 #define SOCKET_SEND_RETRY_TIMEOUT_MILLI_SECOND 500
 #define MAX_SOCKET_WRITE_RETRY                 3
 
+// Maximum number of datagrams handed to the kernel by a single batched send call
+#define SOCKET_SEND_BATCH_MAX_PACKETS 64
+
+// UDP generic segmentation offload limits, mirrors UDP_MAX_SEGMENTS and the maximum UDP payload
+#define SOCKET_GSO_MAX_SEGMENTS 64
+#define SOCKET_GSO_MAX_BYTES    65000
+
+// Limits of socketConnectionSendDataGather. Messages up to the stack buffer size go out as a single TLS record.
+#define SOCKET_SEND_GATHER_MAX_BUFFERS      4
+#define SOCKET_SEND_GATHER_STACK_BUFFER_LEN 2048
+
 // EHOSTDOWN is not defined on Windows
 #ifndef EHOSTDOWN
 #define EHOSTDOWN 64
@@ -45,6 +56,13 @@ struct __SocketConnection {
     BOOL secureConnection;
     PTlsSession pTlsSession;
 
+    /* Set once the kernel rejected a UDP_SEGMENT send, batches are then sent one datagram per message */
+    BOOL gsoDisabled;
+
+    /* Shard and socket table index assigned by the epoll based connection listener */
+    UINT32 listenerShardIndex;
+    UINT32 listenerSlotIndex;
+
     MUTEX lock;
 
     ConnectionDataAvailableFunc dataAvailableCallbackFn;
@@ -110,6 +128,37 @@ STATUS socketConnectionInitSecureConnection(PSocketConnection, BOOL);
  */
 STATUS socketConnectionSendData(PSocketConnection, PBYTE, UINT32, PKvsIpAddress);
 
+/**
+ * Send several buffers through the underlying socket while holding the connection lock once. Plain UDP sockets hand the
+ * whole batch to the kernel with sendmmsg where available, coalescing runs of equally sized datagrams with UDP_SEGMENT
+ * when the kernel supports it. Other socket types send the buffers one by one the same way socketConnectionSendData does.
+ *
+ * @param - PSocketConnection - IN - the SocketConnection struct
+ * @param - PBYTE* - IN - buffers containing unencrypted data
+ * @param - PUINT32 - IN - length of each buffer
+ * @param - UINT32 - IN - number of buffers
+ * @param - PKvsIpAddress - IN - destination address. Required only if socket type is UDP.
+ * @param - PUINT32 - OUT - number of leading buffers that were sent (OPTIONAL)
+ *
+ * @return - STATUS - status of execution
+ */
+STATUS socketConnectionSendDataBatch(PSocketConnection, PBYTE*, PUINT32, UINT32, PKvsIpAddress, PUINT32);
+
+/**
+ * Send several buffers as one message, i.e. a single datagram over UDP, without copying them together first. Plain
+ * sockets use sendmsg with an iovec, TLS connections gather messages up to SOCKET_SEND_GATHER_STACK_BUFFER_LEN on the
+ * stack so they are encrypted as one record.
+ *
+ * @param - PSocketConnection - IN - the SocketConnection struct
+ * @param - PBYTE* - IN - buffers containing unencrypted data, in the order they go out
+ * @param - PUINT32 - IN - length of each buffer
+ * @param - UINT32 - IN - number of buffers, at most SOCKET_SEND_GATHER_MAX_BUFFERS
+ * @param - PKvsIpAddress - IN - destination address. Required only if socket type is UDP.
+ *
+ * @return - STATUS - status of execution
+ */
+STATUS socketConnectionSendDataGather(PSocketConnection, PBYTE*, PUINT32, UINT32, PKvsIpAddress);
+
 /**
  * If PSocketConnection is not secure then nothing happens, otherwise assuming the bytes passed in are encrypted, and
  * the encryted data will be replaced with unencrypted data at function return.
@@ -153,6 +202,8 @@ BOOL socketConnectionIsConnected(PSocketConnection);
 
 // internal functions
 STATUS socketSendDataWithRetry(PSocketConnection, PBYTE, UINT32, PKvsIpAddress, PUINT32);
+STATUS socketSendDataBatchWithRetry(PSocketConnection, PBYTE*, PUINT32, UINT32, PKvsIpAddress, PUINT32);
+STATUS socketSendDataGatherWithRetry(PSocketConnection, PBYTE*, PUINT32, UINT32, PKvsIpAddress);
 STATUS socketConnectionTlsSessionOutBoundPacket(UINT64, PBYTE, UINT32);
 VOID socketConnectionTlsSessionOnStateChange(UINT64, TLS_SESSION_STATE);
 
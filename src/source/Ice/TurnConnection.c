@@ -77,11 +77,9 @@ STATUS createTurnConnection(PIceServer pTurnServer, TIMER_QUEUE_HANDLE timerQueu
     CHK_STATUS(getHostnameFromUrl(pTurnServer->url, &hostname));
     pTurnSocket->hostname = hostname;
 
-    pTurnConnection = (PTurnConnection) MEMCALLOC(
-        1, SIZEOF(TurnConnection) + DEFAULT_TURN_MESSAGE_RECV_CHANNEL_DATA_BUFFER_LEN * 2 + DEFAULT_TURN_MESSAGE_SEND_CHANNEL_DATA_BUFFER_LEN);
+    pTurnConnection = (PTurnConnection) MEMCALLOC(1, SIZEOF(TurnConnection) + DEFAULT_TURN_MESSAGE_RECV_CHANNEL_DATA_BUFFER_LEN * 2);
     CHK(pTurnConnection != NULL, STATUS_NOT_ENOUGH_MEMORY);
     pTurnConnection->lock = MUTEX_CREATE(TRUE);
-    pTurnConnection->sendLock = MUTEX_CREATE(FALSE);
     pTurnConnection->freeAllocationCvar = CVAR_CREATE();
     pTurnConnection->timerQueueHandle = timerQueueHandle;
     pTurnConnection->turnServer = *pTurnServer;
@@ -105,17 +103,17 @@ STATUS createTurnConnection(PIceServer pTurnServer, TIMER_QUEUE_HANDLE timerQueu
         pTurnConnection->turnConnectionCallbacks = *pTurnConnectionCallbacks;
     }
     pTurnConnection->recvDataBufferSize = DEFAULT_TURN_MESSAGE_RECV_CHANNEL_DATA_BUFFER_LEN;
-    pTurnConnection->dataBufferSize = DEFAULT_TURN_MESSAGE_SEND_CHANNEL_DATA_BUFFER_LEN;
-    pTurnConnection->sendDataBuffer = (PBYTE) (pTurnConnection + 1);
-    pTurnConnection->recvDataBuffer = pTurnConnection->sendDataBuffer + pTurnConnection->dataBufferSize;
-    pTurnConnection->completeChannelDataBuffer =
-        pTurnConnection->sendDataBuffer + pTurnConnection->dataBufferSize + pTurnConnection->recvDataBufferSize;
+    pTurnConnection->recvDataBuffer = (PBYTE) (pTurnConnection + 1);
+    pTurnConnection->completeChannelDataBuffer = pTurnConnection->recvDataBuffer + pTurnConnection->recvDataBufferSize;
     pTurnConnection->currRecvDataLen = 0;
     pTurnConnection->allocationExpirationTime = INVALID_TIMESTAMP_VALUE;
     pTurnConnection->nextAllocationRefreshTime = 0;
     pTurnConnection->currentTimerCallingPeriod = DEFAULT_TURN_TIMER_INTERVAL_BEFORE_READY;
     pTurnConnection->ipFamilyType = turnServerIpFamily;
 
+    // Responses are validated against the empty long term key until the credentials are obtained
+    CHK_STATUS(kvsHmacSha1KeyInit(&pTurnConnection->longTermHmacKey, pTurnConnection->longTermKey, SIZEOF(pTurnConnection->longTermKey)));
+
     SNPRINTF(turnStateMachineName, MAX_STATE_MACHINE_NAME_LENGTH, "%s-%p", TURN_STATE_MACHINE_NAME, (PVOID) pTurnConnection);
     CHK_STATUS(createStateMachineWithName(TURN_CONNECTION_STATE_MACHINE_STATES, TURN_CONNECTION_STATE_MACHINE_STATE_COUNT, (UINT64) pTurnConnection,
                                           turnConnectionGetTime, (UINT64) pTurnConnection, turnStateMachineName, &pTurnConnection->pStateMachine));
@@ -165,7 +163,7 @@ STATUS freeTurnConnection(PTurnConnection* ppTurnConnection)
     // Ensure we are not freeing everything without cancelling the timer
     timerCallbackId = ATOMIC_EXCHANGE(&pTurnConnection->timerCallbackId, MAX_UINT32);
     if (timerCallbackId != MAX_UINT32) {
-        CHK_LOG_ERR(timerQueueCancelTimer(pTurnConnection->timerQueueHandle, (UINT32) timerCallbackId, (UINT64) pTurnConnection));
+        CHK_LOG_ERR(kvsTimerQueueCancelTimer(pTurnConnection->timerQueueHandle, (UINT32) timerCallbackId, (UINT64) pTurnConnection));
     }
     // shutdown control channel
     if (pTurnConnection->pControlChannel) {
@@ -186,13 +184,6 @@ STATUS freeTurnConnection(PTurnConnection* ppTurnConnection)
         MUTEX_FREE(pTurnConnection->lock);
     }
 
-    if (IS_VALID_MUTEX_VALUE(pTurnConnection->sendLock)) {
-        /* in case some thread is in the middle of a turn api call. */
-        MUTEX_LOCK(pTurnConnection->sendLock);
-        MUTEX_UNLOCK(pTurnConnection->sendLock);
-        MUTEX_FREE(pTurnConnection->sendLock);
-    }
-
     if (IS_VALID_CVAR_VALUE(pTurnConnection->freeAllocationCvar)) {
         CVAR_FREE(pTurnConnection->freeAllocationCvar);
     }
@@ -201,6 +192,8 @@ STATUS freeTurnConnection(PTurnConnection* ppTurnConnection)
 
     turnConnectionFreePreAllocatedPackets(pTurnConnection);
 
+    CHK_LOG_ERR(kvsHmacSha1KeyFree(&pTurnConnection->longTermHmacKey));
+
     MEMFREE(pTurnConnection);
 
     *ppTurnConnection = NULL;
@@ -268,10 +261,9 @@ STATUS turnConnectionHandleStun(PTurnConnection pTurnConnection, PBYTE pBuffer,
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     UINT16 stunPacketType = 0;
-    PStunAttributeHeader pStunAttr = NULL;
-    PStunAttributeAddress pStunAttributeAddress = NULL;
-    PStunAttributeLifetime pStunAttributeLifetime = NULL;
-    PStunPacket pStunPacket = NULL;
+    StunPacketView stunPacketView;
+    PStunAttributeView pStunAttr = NULL, pStunAttributeLifetime = NULL;
+    UINT32 lifetime = 0;
     CHAR profileDebugStr[MAX_TURN_PROFILE_LOG_DESC_LEN];
     CHAR ipAddrStr[KVS_IP_ADDRESS_STRING_BUFFER_LEN];
     BOOL locked = FALSE;
@@ -295,24 +287,23 @@ STATUS turnConnectionHandleStun(PTurnConnection pTurnConnection, PBYTE pBuffer,
         case STUN_PACKET_TYPE_ALLOCATE_SUCCESS_RESPONSE:
             /* If shutdown has been initiated, ignore the allocation response */
             CHK(!ATOMIC_LOAD(&pTurnConnection->stopTurnConnection), retStatus);
-            CHK_STATUS(deserializeStunPacket(pBuffer, bufferLen, pTurnConnection->longTermKey, KVS_MD5_DIGEST_LENGTH, &pStunPacket));
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_XOR_RELAYED_ADDRESS, &pStunAttr));
+            CHK_STATUS(stunPacketViewInit(pBuffer, bufferLen, &pTurnConnection->longTermHmacKey, &stunPacketView));
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_XOR_RELAYED_ADDRESS, &pStunAttr));
             CHK_WARN(pStunAttr != NULL, retStatus, "No relay address attribute found in TURN allocate response. Dropping Packet");
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_LIFETIME, (PStunAttributeHeader*) &pStunAttributeLifetime));
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_LIFETIME, &pStunAttributeLifetime));
             CHK_WARN(pStunAttributeLifetime != NULL, retStatus, "Missing lifetime in Allocation response. Dropping Packet");
+            CHK_STATUS(stunAttributeViewGetUint32(pStunAttributeLifetime, &lifetime));
 
             // convert lifetime to 100ns and store it
-            pTurnConnection->allocationExpirationTime = (pStunAttributeLifetime->lifetime * HUNDREDS_OF_NANOS_IN_A_SECOND) + currentTime;
+            pTurnConnection->allocationExpirationTime = (lifetime * HUNDREDS_OF_NANOS_IN_A_SECOND) + currentTime;
 
-            pStunAttributeAddress = (PStunAttributeAddress) pStunAttr;
-            pTurnConnection->relayAddress = pStunAttributeAddress->address;
+            CHK_STATUS(stunAttributeViewGetAddress(&stunPacketView, pStunAttr, &pTurnConnection->relayAddress));
             ATOMIC_STORE_BOOL(&pTurnConnection->hasAllocation, TRUE);
             getIpAddrStr(&pTurnConnection->relayAddress, ipAddrStr, ARRAY_SIZE(ipAddrStr));
             SNPRINTF(profileDebugStr, MAX_TURN_PROFILE_LOG_DESC_LEN, "%p - %s:%d - %s", (PVOID) pTurnConnection, ipAddrStr,
                      pTurnConnection->relayAddress.port, "TURN allocation");
             DLOGD("[%p - %s:%d] TURN Allocation succeeded. Life time: %u seconds. Allocation expiration epoch %" PRIu64, pTurnConnection, ipAddrStr,
-                  pTurnConnection->relayAddress.port, pStunAttributeLifetime->lifetime,
-                  pTurnConnection->allocationExpirationTime / DEFAULT_TIME_UNIT_IN_NANOS);
+                  pTurnConnection->relayAddress.port, lifetime, pTurnConnection->allocationExpirationTime / DEFAULT_TIME_UNIT_IN_NANOS);
             PROFILE_WITH_START_TIME_OBJ(pTurnConnection->turnProfileDiagnostics.createAllocationStartTime,
                                         pTurnConnection->turnProfileDiagnostics.createAllocationTime, profileDebugStr);
 
@@ -330,19 +321,20 @@ STATUS turnConnectionHandleStun(PTurnConnection pTurnConnection, PBYTE pBuffer,
             break;
 
         case STUN_PACKET_TYPE_REFRESH_SUCCESS_RESPONSE:
-            CHK_STATUS(deserializeStunPacket(pBuffer, bufferLen, pTurnConnection->longTermKey, KVS_MD5_DIGEST_LENGTH, &pStunPacket));
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_LIFETIME, (PStunAttributeHeader*) &pStunAttributeLifetime));
+            CHK_STATUS(stunPacketViewInit(pBuffer, bufferLen, &pTurnConnection->longTermHmacKey, &stunPacketView));
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_LIFETIME, &pStunAttributeLifetime));
             CHK_WARN(pStunAttributeLifetime != NULL, retStatus, "No lifetime attribute found in TURN refresh response. Dropping Packet");
+            CHK_STATUS(stunAttributeViewGetUint32(pStunAttributeLifetime, &lifetime));
 
-            if (pStunAttributeLifetime->lifetime == 0) {
+            if (lifetime == 0) {
                 hasAllocation = ATOMIC_EXCHANGE_BOOL(&pTurnConnection->hasAllocation, FALSE);
                 CHK(hasAllocation, retStatus);
                 DLOGD("TURN Allocation freed.");
                 CVAR_SIGNAL(pTurnConnection->freeAllocationCvar);
             } else {
                 // convert lifetime to 100ns and store it
-                pTurnConnection->allocationExpirationTime = (pStunAttributeLifetime->lifetime * HUNDREDS_OF_NANOS_IN_A_SECOND) + currentTime;
-                DLOGD("Refreshed TURN allocation lifetime is %u seconds. Allocation expiration epoch %" PRIu64, pStunAttributeLifetime->lifetime,
+                pTurnConnection->allocationExpirationTime = (lifetime * HUNDREDS_OF_NANOS_IN_A_SECOND) + currentTime;
+                DLOGD("Refreshed TURN allocation lifetime is %u seconds. Allocation expiration epoch %" PRIu64, lifetime,
                       pTurnConnection->allocationExpirationTime / DEFAULT_TIME_UNIT_IN_NANOS);
             }
 
@@ -416,10 +408,6 @@ CleanUp:
         MUTEX_UNLOCK(pTurnConnection->lock);
     }
 
-    if (pStunPacket != NULL) {
-        freeStunPacket(&pStunPacket);
-    }
-
     LEAVES();
     return retStatus;
 }
@@ -428,12 +416,9 @@ STATUS turnConnectionHandleStunError(PTurnConnection pTurnConnection, PBYTE pBuf
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    UINT16 stunPacketType = 0;
-    PStunAttributeHeader pStunAttr = NULL;
-    PStunAttributeErrorCode pStunAttributeErrorCode = NULL;
-    PStunAttributeNonce pStunAttributeNonce = NULL;
-    PStunAttributeRealm pStunAttributeRealm = NULL;
-    PStunPacket pStunPacket = NULL;
+    UINT16 stunPacketType = 0, errorCode = 0;
+    StunPacketView stunPacketView;
+    PStunAttributeView pStunAttr = NULL, pStunAttributeErrorCode = NULL;
     BOOL locked = FALSE, iterate = TRUE;
     PTurnPeer pTurnPeer = NULL;
     CHAR profileDebugStr[MAX_TURN_PROFILE_LOG_DESC_LEN];
@@ -457,36 +442,32 @@ STATUS turnConnectionHandleStunError(PTurnConnection pTurnConnection, PBYTE pBuf
     }
 
     if (pTurnConnection->credentialObtained) {
-        retStatus = deserializeStunPacket(pBuffer, bufferLen, pTurnConnection->longTermKey, KVS_MD5_DIGEST_LENGTH, &pStunPacket);
+        retStatus = stunPacketViewInit(pBuffer, bufferLen, &pTurnConnection->longTermHmacKey, &stunPacketView);
     }
     /* if deserializing with password didnt work, try deserialize without password again */
     if (!pTurnConnection->credentialObtained || STATUS_FAILED(retStatus)) {
-        CHK_STATUS(deserializeStunPacket(pBuffer, bufferLen, NULL, 0, &pStunPacket));
+        CHK_STATUS(stunPacketViewInit(pBuffer, bufferLen, NULL, &stunPacketView));
         retStatus = STATUS_SUCCESS;
     }
 
-    CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_ERROR_CODE, &pStunAttr));
-    CHK_WARN(pStunAttr != NULL, retStatus, "No error code attribute found in Stun Error response. Dropping Packet");
-    pStunAttributeErrorCode = (PStunAttributeErrorCode) pStunAttr;
+    CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_ERROR_CODE, &pStunAttributeErrorCode));
+    CHK_WARN(pStunAttributeErrorCode != NULL, retStatus, "No error code attribute found in Stun Error response. Dropping Packet");
+    CHK_STATUS(stunAttributeViewGetErrorCode(pStunAttributeErrorCode, &errorCode));
 
-    switch (pStunAttributeErrorCode->errorCode) {
+    switch (errorCode) {
         case STUN_ERROR_UNAUTHORIZED:
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_NONCE, &pStunAttr));
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_NONCE, &pStunAttr));
             CHK_WARN(pStunAttr != NULL, retStatus, "No Nonce attribute found in Allocate Error response. Dropping Packet");
-            pStunAttributeNonce = (PStunAttributeNonce) pStunAttr;
-            CHK_WARN(pStunAttributeNonce->attribute.length <= STUN_MAX_NONCE_LEN, retStatus,
-                     "Invalid Nonce found in Allocate Error response. Dropping Packet");
-            pTurnConnection->nonceLen = pStunAttributeNonce->attribute.length;
-            MEMCPY(pTurnConnection->turnNonce, pStunAttributeNonce->nonce, pTurnConnection->nonceLen);
+            CHK_WARN(pStunAttr->length <= STUN_MAX_NONCE_LEN, retStatus, "Invalid Nonce found in Allocate Error response. Dropping Packet");
+            pTurnConnection->nonceLen = pStunAttr->length;
+            MEMCPY(pTurnConnection->turnNonce, pStunAttr->pValue, pTurnConnection->nonceLen);
 
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_REALM, &pStunAttr));
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_REALM, &pStunAttr));
             CHK_WARN(pStunAttr != NULL, retStatus, "No Realm attribute found in Allocate Error response. Dropping Packet");
-            pStunAttributeRealm = (PStunAttributeRealm) pStunAttr;
-            CHK_WARN(pStunAttributeRealm->attribute.length <= STUN_MAX_REALM_LEN, retStatus,
-                     "Invalid Realm found in Allocate Error response. Dropping Packet");
-            // pStunAttributeRealm->attribute.length does not include null terminator and pStunAttributeRealm->realm is not null terminated
-            STRNCPY(pTurnConnection->turnRealm, pStunAttributeRealm->realm, pStunAttributeRealm->attribute.length);
-            pTurnConnection->turnRealm[pStunAttributeRealm->attribute.length] = '\0';
+            CHK_WARN(pStunAttr->length <= STUN_MAX_REALM_LEN, retStatus, "Invalid Realm found in Allocate Error response. Dropping Packet");
+            // the realm length does not include null terminator and the realm is not null terminated in the packet
+            MEMCPY(pTurnConnection->turnRealm, pStunAttr->pValue, pStunAttr->length);
+            pTurnConnection->turnRealm[pStunAttr->length] = '\0';
 
             pTurnConnection->credentialObtained = TRUE;
             SNPRINTF(profileDebugStr, MAX_TURN_PROFILE_LOG_DESC_LEN, "%p - %s", (PVOID) pTurnConnection, "TURN Get Credentials");
@@ -497,21 +478,20 @@ STATUS turnConnectionHandleStunError(PTurnConnection pTurnConnection, PBYTE pBuf
 
         case STUN_ERROR_STALE_NONCE:
             DLOGD("Updating stale nonce");
-            CHK_STATUS(getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_NONCE, &pStunAttr));
+            CHK_STATUS(stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_NONCE, &pStunAttr));
             CHK_WARN(pStunAttr != NULL, retStatus, "No Nonce attribute found in Refresh Error response. Dropping Packet");
-            pStunAttributeNonce = (PStunAttributeNonce) pStunAttr;
-            CHK_WARN(pStunAttributeNonce->attribute.length <= STUN_MAX_NONCE_LEN, retStatus,
-                     "Invalid Nonce found in Refresh Error response. Dropping Packet");
-            pTurnConnection->nonceLen = pStunAttributeNonce->attribute.length;
-            MEMCPY(pTurnConnection->turnNonce, pStunAttributeNonce->nonce, pTurnConnection->nonceLen);
+            CHK_WARN(pStunAttr->length <= STUN_MAX_NONCE_LEN, retStatus, "Invalid Nonce found in Refresh Error response. Dropping Packet");
+            pTurnConnection->nonceLen = pStunAttr->length;
+            MEMCPY(pTurnConnection->turnNonce, pStunAttr->pValue, pTurnConnection->nonceLen);
 
             CHK_STATUS(turnConnectionUpdateNonce(pTurnConnection));
             break;
 
         default:
             /* Remove peer for any other error */
-            DLOGW("Received STUN error response. Error type: 0x%02x, Error Code: %u. attribute len %u, Error detail: %s.", stunPacketType,
-                  pStunAttributeErrorCode->errorCode, pStunAttributeErrorCode->attribute.length, pStunAttributeErrorCode->errorPhrase);
+            DLOGW("Received STUN error response. Error type: 0x%02x, Error Code: %u. attribute len %u, Error detail: %.*s.", stunPacketType,
+                  errorCode, pStunAttributeErrorCode->length, pStunAttributeErrorCode->length - STUN_ERROR_CODE_PACKET_ERROR_PHRASE_OFFSET,
+                  (PCHAR) pStunAttributeErrorCode->pValue + STUN_ERROR_CODE_PACKET_ERROR_PHRASE_OFFSET);
             BOOL found = FALSE;
             /* Find TurnPeer using transaction Id, then mark it as failed */
             for (i = 0; iterate && i < pTurnConnection->turnPeerCount; ++i) {
@@ -540,10 +520,6 @@ CleanUp:
         MUTEX_UNLOCK(pTurnConnection->lock);
     }
 
-    if (pStunPacket != NULL) {
-        freeStunPacket(&pStunPacket);
-    }
-
     LEAVES();
     return retStatus;
 }
@@ -731,6 +707,7 @@ STATUS turnConnectionAddPeer(PTurnConnection pTurnConnection, PKvsIpAddress pPee
     STATUS retStatus = STATUS_SUCCESS;
     PTurnPeer pTurnPeer = NULL;
     BOOL locked = FALSE;
+    UINT32 slot;
 
     CHK(pTurnConnection != NULL && pPeerAddress != NULL, STATUS_NULL_ARG);
 
@@ -754,6 +731,7 @@ STATUS turnConnectionAddPeer(PTurnConnection pTurnConnection, PKvsIpAddress pPee
     pTurnPeer->xorAddress = *pPeerAddress;
     /* safe to down cast because DEFAULT_TURN_MAX_PEER_COUNT is enforced */
     pTurnPeer->channelNumber = (UINT16) pTurnConnection->turnPeerCount + TURN_CHANNEL_BIND_CHANNEL_NUMBER_BASE;
+    pTurnPeer->channelDataHeader = (UINT32) pTurnPeer->channelNumber << 16;
     pTurnPeer->permissionExpirationTime = INVALID_TIMESTAMP_VALUE;
     pTurnPeer->ready = FALSE;
     pTurnPeer->firstTimeCreatePermReq = TRUE;
@@ -763,6 +741,11 @@ STATUS turnConnectionAddPeer(PTurnConnection pTurnConnection, PKvsIpAddress pPee
 
     // CHK_STATUS(xorIpAddress(&pTurnPeer->xorAddress, NULL)); /* only work for IPv4 for now */
     CHK_STATUS(createTransactionIdStore(DEFAULT_MAX_STORED_TRANSACTION_ID_COUNT, &pTurnPeer->pTransactionIdStore));
+
+    // The index is at most half full, so there always is an empty slot to stop the probe
+    for (slot = turnConnectionPeerIndexSlot(pPeerAddress); pTurnConnection->turnPeerIndex[slot] != 0; slot = (slot + 1) % TURN_PEER_INDEX_SIZE) {
+    }
+    pTurnConnection->turnPeerIndex[slot] = (UINT8) pTurnConnection->turnPeerCount;
     pTurnPeer = NULL;
 
 CleanUp:
@@ -784,14 +767,18 @@ STATUS turnConnectionSendData(PTurnConnection pTurnConnection, PBYTE pBuf, UINT3
 {
     STATUS retStatus = STATUS_SUCCESS;
     PTurnPeer pSendPeer = NULL;
-    UINT32 paddedDataLen = 0;
     CHAR ipAddrStr[KVS_IP_ADDRESS_STRING_BUFFER_LEN];
     BOOL locked = FALSE;
-    BOOL sendLocked = FALSE;
     PKvsIpAddress pTurnServerIp = NULL;
+    // ChannelData needs 4 byte alignment over TCP, padding is harmless over UDP
+    static BYTE padding[TURN_DATA_CHANNEL_SEND_OVERHEAD];
+    BYTE header[TURN_DATA_CHANNEL_SEND_OVERHEAD];
+    PBYTE buffers[3];
+    UINT32 bufferLens[3];
 
     CHK(pTurnConnection != NULL && pDestIp != NULL, STATUS_NULL_ARG);
     CHK(pBuf != NULL && bufLen > 0, STATUS_INVALID_ARG);
+    CHK(bufLen <= MAX_UINT16, STATUS_BUFFER_TOO_SMALL);
 
     MUTEX_LOCK(pTurnConnection->lock);
     locked = TRUE;
@@ -806,40 +793,38 @@ STATUS turnConnectionSendData(PTurnConnection pTurnConnection, PBYTE pBuf, UINT3
 
     pSendPeer = turnConnectionGetPeerWithIp(pTurnConnection, pDestIp);
 
-    CHK_STATUS(getIpAddrStr(pDestIp, ipAddrStr, ARRAY_SIZE(ipAddrStr)));
     if (pSendPeer == NULL) {
+        getIpAddrStr(pDestIp, ipAddrStr, ARRAY_SIZE(ipAddrStr));
         DLOGV("Unable to send data through turn because peer with address %s:%u is not found", ipAddrStr, KVS_GET_IP_ADDRESS_PORT(pDestIp));
         CHK(FALSE, retStatus);
     } else if (pSendPeer->connectionState == TURN_PEER_CONN_STATE_FAILED) {
         CHK(FALSE, STATUS_TURN_CONNECTION_PEER_NOT_USABLE);
     } else if (!pSendPeer->ready) {
+        getIpAddrStr(pDestIp, ipAddrStr, ARRAY_SIZE(ipAddrStr));
         DLOGV("Unable to send data through turn because turn channel is not established with peer with address %s:%u", ipAddrStr,
               KVS_GET_IP_ADDRESS_PORT(pDestIp));
         CHK(FALSE, retStatus);
     }
 
+    putInt32((PINT32) header, (INT32) (pSendPeer->channelDataHeader | bufLen));
+    getTurnConnectionIpAddress(pTurnConnection, &pTurnServerIp);
+
     MUTEX_UNLOCK(pTurnConnection->lock);
     locked = FALSE;
 
-    /* need to serialize send because every send load data into the same buffer pTurnConnection->sendDataBuffer */
-    MUTEX_LOCK(pTurnConnection->sendLock);
-    sendLocked = TRUE;
-
-    CHK(pTurnConnection->dataBufferSize - TURN_DATA_CHANNEL_SEND_OVERHEAD >= bufLen, STATUS_BUFFER_TOO_SMALL);
+    /* header, payload and padding leave in one message without staging them in a shared buffer, so senders only
+     * serialize on the socket itself */
+    buffers[0] = header;
+    bufferLens[0] = TURN_DATA_CHANNEL_SEND_OVERHEAD;
+    buffers[1] = pBuf;
+    bufferLens[1] = bufLen;
+    buffers[2] = padding;
+    bufferLens[2] = ROUND_UP(bufLen, 4) - bufLen;
 
-    paddedDataLen = (UINT32) ROUND_UP(TURN_DATA_CHANNEL_SEND_OVERHEAD + bufLen, 4);
-
-    /* generate data channel TURN message */
-    putInt16((PINT16) (pTurnConnection->sendDataBuffer), pSendPeer->channelNumber);
-    putInt16((PINT16) (pTurnConnection->sendDataBuffer + 2), (UINT16) bufLen);
-    MEMCPY(pTurnConnection->sendDataBuffer + TURN_DATA_CHANNEL_SEND_OVERHEAD, pBuf, bufLen);
-
-    getTurnConnectionIpAddress(pTurnConnection, &pTurnServerIp);
-
-    retStatus = iceUtilsSendData(pTurnConnection->sendDataBuffer, paddedDataLen, pTurnServerIp, pTurnConnection->pControlChannel, NULL, FALSE);
+    retStatus = socketConnectionSendDataGather(pTurnConnection->pControlChannel, buffers, bufferLens, bufferLens[2] == 0 ? 2 : 3, pTurnServerIp);
 
     if (STATUS_FAILED(retStatus)) {
-        DLOGW("iceUtilsSendData failed with 0x%08x", retStatus);
+        DLOGW("socketConnectionSendDataGather failed with 0x%08x", retStatus);
         if (retStatus != STATUS_SOCKET_CONNECTION_CLOSED_ALREADY) {
             retStatus = STATUS_SUCCESS;
         }
@@ -849,10 +834,6 @@ CleanUp:
 
     CHK_LOG_ERR(retStatus);
 
-    if (sendLocked) {
-        MUTEX_UNLOCK(pTurnConnection->sendLock);
-    }
-
     if (locked) {
         MUTEX_UNLOCK(pTurnConnection->lock);
     }
@@ -879,12 +860,12 @@ STATUS turnConnectionStart(PTurnConnection pTurnConnection)
 
     timerCallbackId = ATOMIC_EXCHANGE(&pTurnConnection->timerCallbackId, MAX_UINT32);
     if (timerCallbackId != MAX_UINT32) {
-        CHK_STATUS(timerQueueCancelTimer(pTurnConnection->timerQueueHandle, (UINT32) timerCallbackId, (UINT64) pTurnConnection));
+        CHK_STATUS(kvsTimerQueueCancelTimer(pTurnConnection->timerQueueHandle, (UINT32) timerCallbackId, (UINT64) pTurnConnection));
     }
 
     /* schedule the timer, which will drive the state machine. */
-    CHK_STATUS(timerQueueAddTimer(pTurnConnection->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY, pTurnConnection->currentTimerCallingPeriod,
-                                  turnConnectionTimerCallback, (UINT64) pTurnConnection, (PUINT32) &timerCallbackId));
+    CHK_STATUS(kvsTimerQueueAddTimer(pTurnConnection->timerQueueHandle, KVS_ICE_DEFAULT_TIMER_START_DELAY, pTurnConnection->currentTimerCallingPeriod,
+                                     turnConnectionTimerCallback, (UINT64) pTurnConnection, (PUINT32) &timerCallbackId));
 
     ATOMIC_STORE(&pTurnConnection->timerCallbackId, timerCallbackId);
 
@@ -1264,31 +1245,41 @@ CleanUp:
 }
 
 PTurnPeer turnConnectionGetPeerWithChannelNumber(PTurnConnection pTurnConnection, UINT16 channelNumber)
+{
+    // Channel numbers are handed out in turnPeerList order by turnConnectionAddPeer
+    UINT32 i = (UINT32) (UINT16) (channelNumber - TURN_CHANNEL_BIND_CHANNEL_NUMBER_BASE - 1);
+
+    return i < pTurnConnection->turnPeerCount ? &pTurnConnection->turnPeerList[i] : NULL;
+}
+
+PTurnPeer turnConnectionGetPeerWithIp(PTurnConnection pTurnConnection, PKvsIpAddress pKvsIpAddress)
 {
     PTurnPeer pTurnPeer = NULL;
-    UINT32 i = 0;
+    UINT32 slot = turnConnectionPeerIndexSlot(pKvsIpAddress);
+    UINT8 position;
 
-    for (; i < pTurnConnection->turnPeerCount; ++i) {
-        if (pTurnConnection->turnPeerList[i].channelNumber == channelNumber) {
-            pTurnPeer = &pTurnConnection->turnPeerList[i];
+    while (pTurnPeer == NULL && (position = pTurnConnection->turnPeerIndex[slot]) != 0) {
+        if (isSameIpAddress(&pTurnConnection->turnPeerList[position - 1].address, pKvsIpAddress, TRUE)) {
+            pTurnPeer = &pTurnConnection->turnPeerList[position - 1];
         }
+        slot = (slot + 1) % TURN_PEER_INDEX_SIZE;
     }
 
     return pTurnPeer;
 }
 
-PTurnPeer turnConnectionGetPeerWithIp(PTurnConnection pTurnConnection, PKvsIpAddress pKvsIpAddress)
+UINT32 turnConnectionPeerIndexSlot(PKvsIpAddress pKvsIpAddress)
 {
-    PTurnPeer pTurnPeer = NULL;
-    UINT32 i = 0;
+    // FNV-1a over the fields isSameIpAddress compares
+    UINT32 hash = 2166136261U, i, addrLen = IS_IPV4_ADDR(pKvsIpAddress) ? IPV4_ADDRESS_LENGTH : IPV6_ADDRESS_LENGTH;
 
-    for (; i < pTurnConnection->turnPeerCount; ++i) {
-        if (isSameIpAddress(&pTurnConnection->turnPeerList[i].address, pKvsIpAddress, TRUE)) {
-            pTurnPeer = &pTurnConnection->turnPeerList[i];
-        }
+    for (i = 0; i < addrLen; i++) {
+        hash = (hash ^ pKvsIpAddress->address[i]) * 16777619U;
     }
+    hash = (hash ^ (pKvsIpAddress->port & 0xff)) * 16777619U;
+    hash = (hash ^ (pKvsIpAddress->port >> 8)) * 16777619U;
 
-    return pTurnPeer;
+    return hash % TURN_PEER_INDEX_SIZE;
 }
 
 VOID turnConnectionFatalError(PTurnConnection pTurnConnection, STATUS errorStatus)
@@ -31,12 +31,14 @@ extern "C" {
 #define DEFAULT_TURN_PERMISSION_REFRESH_GRACE_PERIOD (30 * HUNDREDS_OF_NANOS_IN_A_SECOND)
 
 #define MAX_TURN_CHANNEL_DATA_MESSAGE_SIZE                4 + 65536 /* header + data */
-#define DEFAULT_TURN_MESSAGE_SEND_CHANNEL_DATA_BUFFER_LEN MAX_TURN_CHANNEL_DATA_MESSAGE_SIZE
 #define DEFAULT_TURN_MESSAGE_RECV_CHANNEL_DATA_BUFFER_LEN MAX_TURN_CHANNEL_DATA_MESSAGE_SIZE
 #define DEFAULT_TURN_CHANNEL_DATA_BUFFER_SIZE             512
 #define DEFAULT_TURN_MAX_PEER_COUNT                       32
 #define MAX_TURN_PROFILE_LOG_DESC_LEN                     256
 
+// Open addressing index over turnPeerList keyed by peer address. Power of two, twice DEFAULT_TURN_MAX_PEER_COUNT.
+#define TURN_PEER_INDEX_SIZE 64
+
 // all turn channel numbers must be greater than 0x4000 and less than 0x7FFF
 #define TURN_CHANNEL_BIND_CHANNEL_NUMBER_BASE (UINT16) 0x4000
 
@@ -96,6 +98,7 @@ typedef struct {
     TURN_PEER_CONNECTION_STATE connectionState;
     PTransactionIdStore pTransactionIdStore;
     UINT16 channelNumber;
+    UINT32 channelDataHeader; //!< ChannelData header with the channel number filled in, data length goes in the low 16 bits
     UINT64 permissionExpirationTime;
     BOOL ready;
     BOOL firstTimeCreatePermReq;
@@ -128,6 +131,8 @@ struct __TurnConnection {
     BYTE turnNonce[STUN_MAX_NONCE_LEN];
     UINT16 nonceLen;
     BYTE longTermKey[KVS_MD5_DIGEST_LENGTH];
+    // HMAC key schedule of longTermKey for validating responses
+    KvsHmacSha1Key longTermHmacKey;
     BOOL credentialObtained;
     BOOL relayAddressReported;
 
@@ -135,13 +140,13 @@ struct __TurnConnection {
 
     TurnPeer turnPeerList[DEFAULT_TURN_MAX_PEER_COUNT];
     UINT32 turnPeerCount;
+    UINT8 turnPeerIndex[TURN_PEER_INDEX_SIZE]; //!< 1-based position in turnPeerList, 0 for an empty slot
 
     TIMER_QUEUE_HANDLE timerQueueHandle;
 
     IceServer turnServer;
 
     MUTEX lock;
-    MUTEX sendLock;
     CVAR freeAllocationCvar;
 
     UINT64 state;
@@ -166,9 +171,6 @@ struct __TurnConnection {
 
     TurnConnectionCallbacks turnConnectionCallbacks;
 
-    PBYTE sendDataBuffer;
-    UINT32 dataBufferSize;
-
     PBYTE recvDataBuffer;
     UINT32 recvDataBufferSize;
     UINT32 currRecvDataLen;
@@ -219,6 +221,7 @@ VOID turnConnectionFatalError(PTurnConnection, STATUS);
 
 PTurnPeer turnConnectionGetPeerWithChannelNumber(PTurnConnection, UINT16);
 PTurnPeer turnConnectionGetPeerWithIp(PTurnConnection, PKvsIpAddress);
+UINT32 turnConnectionPeerIndexSlot(PKvsIpAddress);
 
 STATUS getTurnConnectionIpAddress(PTurnConnection, PKvsIpAddress*);
 
@@ -344,6 +344,7 @@ STATUS executeAllocationTurnState(UINT64 customData, UINT64 time)
         CHK_STATUS(turnConnectionGetLongTermKey(pTurnConnection->turnServer.username, pTurnConnection->turnRealm,
                                                 pTurnConnection->turnServer.credential, pTurnConnection->longTermKey,
                                                 SIZEOF(pTurnConnection->longTermKey)));
+        CHK_STATUS(kvsHmacSha1KeyInit(&pTurnConnection->longTermHmacKey, pTurnConnection->longTermKey, SIZEOF(pTurnConnection->longTermKey)));
         CHK_STATUS(turnConnectionPackageTurnAllocationRequest(
             pTurnConnection->turnServer.username, pTurnConnection->turnRealm, pTurnConnection->turnNonce, pTurnConnection->nonceLen,
             DEFAULT_TURN_ALLOCATION_LIFETIME_SECONDS, &pTurnConnection->pTurnPacket, pTurnConnection->ipFamilyType));
@@ -580,15 +581,17 @@ STATUS fromReadyTurnState(UINT64 customData, PUINT64 pState)
         pTurnConnection->stateTimeoutTime = currentTime + DEFAULT_TURN_CREATE_PERMISSION_TIMEOUT;
         MUTEX_UNLOCK(pTurnConnection->lock);
         locked = FALSE;
-        CHK_STATUS(timerQueueUpdateTimerPeriod(pTurnConnection->timerQueueHandle, (UINT64) pTurnConnection,
-                                               (UINT32) ATOMIC_LOAD(&pTurnConnection->timerCallbackId), pTurnConnection->currentTimerCallingPeriod));
+        CHK_STATUS(kvsTimerQueueUpdateTimerPeriod(pTurnConnection->timerQueueHandle, (UINT64) pTurnConnection,
+                                                  (UINT32) ATOMIC_LOAD(&pTurnConnection->timerCallbackId),
+                                                  pTurnConnection->currentTimerCallingPeriod));
     } else if (pTurnConnection->currentTimerCallingPeriod != DEFAULT_TURN_TIMER_INTERVAL_AFTER_READY) {
         // use longer timer interval as now it just needs to check disconnection and permission expiration.
         pTurnConnection->currentTimerCallingPeriod = DEFAULT_TURN_TIMER_INTERVAL_AFTER_READY;
         MUTEX_UNLOCK(pTurnConnection->lock);
         locked = FALSE;
-        CHK_STATUS(timerQueueUpdateTimerPeriod(pTurnConnection->timerQueueHandle, (UINT64) pTurnConnection,
-                                               (UINT32) ATOMIC_LOAD(&pTurnConnection->timerCallbackId), pTurnConnection->currentTimerCallingPeriod));
+        CHK_STATUS(kvsTimerQueueUpdateTimerPeriod(pTurnConnection->timerQueueHandle, (UINT64) pTurnConnection,
+                                                  (UINT32) ATOMIC_LOAD(&pTurnConnection->timerCallbackId),
+                                                  pTurnConnection->currentTimerCallingPeriod));
     }
 
     *pState = state;
@@ -42,6 +42,7 @@ extern "C" {
 #if MBEDTLS_VERSION_NUMBER < 0x03000000
 #include <mbedtls/certs.h>
 #endif
+#include <mbedtls/sha1.h>
 #include <mbedtls/sha256.h>
 #include <mbedtls/md5.h>
 #endif
@@ -69,9 +70,16 @@ extern "C" {
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #ifdef HAVE_POLL_H
 #include <poll.h>
 #endif
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#endif
+#ifdef HAVE_SCHED_SETAFFINITY
+#include <sched.h>
+#endif
 #endif
 
 // STRNCPY that always null-terminates. dst must be a fixed-size array (not a pointer).
@@ -153,9 +161,11 @@ STATUS generateJSONSafeString(PCHAR, UINT32);
 #ifdef ENABLE_KVS_THREADPOOL
 #include "Threadpool/ThreadpoolContext.h"
 #endif
+#include "Timer/TimerWheel.h"
 #include "Crypto/IOBuffer.h"
 #include "Crypto/Crypto.h"
 #include "Crypto/Dtls.h"
+#include "Crypto/CertificatePool.h"
 #include "Crypto/Tls.h"
 #include "Ice/Network.h"
 #include "Ice/SocketConnection.h"
@@ -177,6 +187,7 @@ STATUS generateJSONSafeString(PCHAR, UINT32);
 #include "Signaling/StateMachine.h"
 #include "Signaling/LwsApiCalls.h"
 #endif
+#include "Rtp/PacketPool.h"
 #include "Rtp/RtpPacket.h"
 #include "Rtp/Codecs/RtpRedPayloader.h"
 #include "Rtcp/RtcpPacket.h"
@@ -185,13 +196,14 @@ STATUS generateJSONSafeString(PCHAR, UINT32);
 #include "PcapDump/PcapDump.h"
 #include "PeerConnection/JitterBuffer.h"
 #include "PeerConnection/Pacer.h"
+#include "PeerConnection/Gcc_i.h"
 #include "PeerConnection/PeerConnection.h"
 #include "PeerConnection/Retransmitter.h"
 #include "PeerConnection/SessionDescription.h"
 #include "PeerConnection/Rtp.h"
 #include "PeerConnection/Rtcp.h"
-#include "PeerConnection/Gcc_i.h"
 #include "PeerConnection/DataChannel.h"
+#include "Rtp/Codecs/AnnexBScanner.h"
 #include "Rtp/Codecs/RtpVP8Payloader.h"
 #include "Rtp/Codecs/RtpH264Payloader.h"
 #include "Rtp/Codecs/RtpH265Payloader.h"
@@ -59,10 +59,15 @@ STATUS dataChannelSend(PRtcDataChannel pRtcDataChannel, BOOL isBinary, PBYTE pMe
     STATUS retStatus = STATUS_SUCCESS;
     PSctpSession pSctpSession = NULL;
     PKvsDataChannel pKvsDataChannel = (PKvsDataChannel) pRtcDataChannel;
+    PKvsPeerConnection pKvsPeerConnection;
 
     CHK(pKvsDataChannel != NULL && pMessage != NULL, STATUS_NULL_ARG);
 
-    pSctpSession = ((PKvsPeerConnection) pKvsDataChannel->pRtcPeerConnection)->pSctpSession;
+    pKvsPeerConnection = (PKvsPeerConnection) pKvsDataChannel->pRtcPeerConnection;
+    pSctpSession = pKvsPeerConnection->pSctpSession;
+    CHK_ERR(pKvsPeerConnection->remoteSctpMaxMessageSize == 0 || pMessageLen <= pKvsPeerConnection->remoteSctpMaxMessageSize,
+            STATUS_SCTP_MESSAGE_TOO_LARGE, "Message of %u bytes is larger than the remote max-message-size %u", pMessageLen,
+            pKvsPeerConnection->remoteSctpMaxMessageSize);
 
     CHK_STATUS(sctpSessionWriteMessage(pSctpSession, pKvsDataChannel->channelId, isBinary, pMessage, pMessageLen));
     ATOMIC_INCREMENT(&pKvsDataChannel->atomicMessagesSent);
@@ -5,8 +5,30 @@
 // Applies only to the case where the very first frame has its first packets out of order
 #define MAX_OUT_OF_ORDER_PACKET_DIFFERENCE 512
 
-#define JITTER_BUFFER_HASH_TABLE_BUCKET_COUNT  3000
-#define JITTER_BUFFER_HASH_TABLE_BUCKET_LENGTH 2
+// Packets are kept in a ring indexed by the low bits of their sequence number. The ring doubles whenever two
+// buffered sequence numbers land in the same slot, so a full ring can hold every sequence number.
+#define JITTER_BUFFER_INITIAL_PACKET_RING_SIZE 512
+#define JITTER_BUFFER_MAX_PACKET_RING_SIZE     65536
+
+// Assembly state of the buffer from headSequenceNumber up to nextIndex, kept between pushes so that a push only folds
+// in the packets the previous parse has not seen yet instead of walking the whole buffer again.
+typedef struct {
+    BOOL valid;
+    UINT16 headSequenceNumber;         //!< Head the state was built from
+    UINT32 headTimestamp;              //!< Head timestamp the state was built from
+    UINT32 earliestAllowedTimestamp;   //!< Latency cutoff the state was built with
+    UINT16 nextIndex;                  //!< First sequence number not folded into the state yet
+    UINT16 startDropIndex;             //!< First sequence number of the head frame
+    UINT16 lastHeadFrameSeqNum;        //!< Last sequence number seen carrying the head timestamp
+    UINT16 firstGapIndex;              //!< First missing sequence number since the head frame started
+    UINT32 curFrameSize;               //!< Depayloaded size of the head frame so far
+    BOOL sizeCalcIsFirst;              //!< Next packet is the first one of the head frame
+    BOOL containStartForEarliestFrame; //!< The head frame has a packet the depayloader reported as frame start
+    BOOL headFrameIsContiguous;        //!< No packet of the head frame is missing so far
+    BOOL seenHeadFramePacket;
+    BOOL sawGapSinceLastFrame;
+    BOOL headFrameEnded; //!< The head frame has its marker packet
+} JitterBufferFrameState, *PJitterBufferFrameState;
 
 // Internal struct for the default jitter buffer implementation.
 // The base JitterBuffer must be the first member so that a PJitterBuffer
@@ -26,7 +48,9 @@ typedef struct {
     BOOL sequenceNumberOverflowState;
     BOOL timestampOverFlowState;
     BOOL alwaysSinglePacketFrames;
-    PHashTable pPkgBufferHashTable;
+    PRtpPacket* pPacketRing;
+    UINT32 packetRingSize; //!< Power of two
+    JitterBufferFrameState frameState;
 } JitterBufferInternal, *PJitterBufferInternal;
 
 // forward declarations of default implementations
@@ -113,7 +137,7 @@ STATUS createJitterBuffer(FrameReadyFunc onFrameReadyFunc, FrameDroppedFunc onFr
     CHK(ppJitterBuffer != NULL && onFrameReadyFunc != NULL && onFrameDroppedFunc != NULL && depayRtpPayloadFunc != NULL, STATUS_NULL_ARG);
     CHK(clockRate != 0, STATUS_INVALID_ARG);
 
-    pInternal = (PJitterBufferInternal) MEMALLOC(SIZEOF(JitterBufferInternal));
+    pInternal = (PJitterBufferInternal) MEMCALLOC(1, SIZEOF(JitterBufferInternal));
     CHK(pInternal != NULL, STATUS_NOT_ENOUGH_MEMORY);
 
     // Wire vtable
@@ -153,8 +177,9 @@ STATUS createJitterBuffer(FrameReadyFunc onFrameReadyFunc, FrameDroppedFunc onFr
     pInternal->alwaysSinglePacketFrames = alwaysSinglePacketFrames;
 
     pInternal->customData = customData;
-    CHK_STATUS(
-        hashTableCreateWithParams(JITTER_BUFFER_HASH_TABLE_BUCKET_COUNT, JITTER_BUFFER_HASH_TABLE_BUCKET_LENGTH, &pInternal->pPkgBufferHashTable));
+    pInternal->packetRingSize = JITTER_BUFFER_INITIAL_PACKET_RING_SIZE;
+    pInternal->pPacketRing = (PRtpPacket*) MEMCALLOC(pInternal->packetRingSize, SIZEOF(PRtpPacket));
+    CHK(pInternal->pPacketRing != NULL, STATUS_NOT_ENOUGH_MEMORY);
 
 CleanUp:
     if (STATUS_FAILED(retStatus) && pInternal != NULL) {
@@ -175,6 +200,86 @@ CleanUp:
 // Default implementation — internal helpers
 //
 
+static PRtpPacket packetRingGet(PJitterBufferInternal pInternal, UINT16 seqNum)
+{
+    PRtpPacket pPacket = pInternal->pPacketRing[seqNum & (pInternal->packetRingSize - 1)];
+
+    return (pPacket != NULL && pPacket->header.sequenceNumber == seqNum) ? pPacket : NULL;
+}
+
+// Detaches and returns the packet with the given sequence number, NULL when it is not buffered
+static PRtpPacket packetRingRemove(PJitterBufferInternal pInternal, UINT16 seqNum)
+{
+    PRtpPacket pPacket = packetRingGet(pInternal, seqNum);
+
+    if (pPacket != NULL) {
+        pInternal->pPacketRing[seqNum & (pInternal->packetRingSize - 1)] = NULL;
+    }
+
+    return pPacket;
+}
+
+static STATUS packetRingGrow(PJitterBufferInternal pInternal)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 i, newSize = pInternal->packetRingSize * 2;
+    PRtpPacket* pNewRing = NULL;
+
+    CHK(newSize <= JITTER_BUFFER_MAX_PACKET_RING_SIZE, STATUS_INVALID_OPERATION);
+    CHK(NULL != (pNewRing = (PRtpPacket*) MEMCALLOC(newSize, SIZEOF(PRtpPacket))), STATUS_NOT_ENOUGH_MEMORY);
+
+    // Packets that had distinct slots keep distinct slots once more bits of the sequence number are used
+    for (i = 0; i < pInternal->packetRingSize; i++) {
+        if (pInternal->pPacketRing[i] != NULL) {
+            pNewRing[pInternal->pPacketRing[i]->header.sequenceNumber & (newSize - 1)] = pInternal->pPacketRing[i];
+        }
+    }
+
+    MEMFREE(pInternal->pPacketRing);
+    pInternal->pPacketRing = pNewRing;
+    pInternal->packetRingSize = newSize;
+
+CleanUp:
+    return retStatus;
+}
+
+// Stores the packet, the caller must have removed any packet with the same sequence number first
+static STATUS packetRingPut(PJitterBufferInternal pInternal, PRtpPacket pRtpPacket)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT16 seqNum = pRtpPacket->header.sequenceNumber;
+    PRtpPacket pOccupant = NULL;
+    UINT32 slot;
+
+    while ((pOccupant = pInternal->pPacketRing[slot = seqNum & (pInternal->packetRingSize - 1)]) != NULL) {
+        // A late packet behind the head is never claimed by a frame, it only held on to its slot until destruction
+        if ((UINT16) (pOccupant->header.sequenceNumber - pInternal->headSequenceNumber) >
+            (UINT16) (pInternal->tailSequenceNumber - pInternal->headSequenceNumber)) {
+            freeRtpPacket(&pOccupant);
+            pInternal->pPacketRing[slot] = NULL;
+        } else {
+            CHK_STATUS(packetRingGrow(pInternal));
+        }
+    }
+
+    pInternal->pPacketRing[slot] = pRtpPacket;
+
+CleanUp:
+    return retStatus;
+}
+
+// Starts the frame state over from the current head
+static VOID resetFrameState(PJitterBufferInternal pInternal)
+{
+    PJitterBufferFrameState pState = &pInternal->frameState;
+
+    MEMSET(pState, 0x00, SIZEOF(JitterBufferFrameState));
+    pState->nextIndex = pInternal->headSequenceNumber;
+    pState->startDropIndex = pInternal->headSequenceNumber;
+    pState->sizeCalcIsFirst = TRUE;
+    pState->headFrameIsContiguous = TRUE;
+}
+
 static BOOL underflowPossible(PJitterBufferInternal pInternal, PRtpPacket pRtpPacket)
 {
     BOOL retVal = FALSE;
@@ -433,18 +538,12 @@ static BOOL withinLatencyTolerance(PJitterBufferInternal pInternal, PRtpPacket p
 static STATUS defaultGetPacket(PJitterBuffer pJitterBuffer, UINT16 seqNum, PRtpPacket* ppPacket)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    UINT64 hashValue = 0;
     PJitterBufferInternal pInternal = (PJitterBufferInternal) pJitterBuffer;
 
     CHK(pInternal != NULL && ppPacket != NULL, STATUS_NULL_ARG);
 
-    retStatus = hashTableGet(pInternal->pPkgBufferHashTable, seqNum, &hashValue);
-    if (retStatus == STATUS_HASH_KEY_NOT_PRESENT) {
-        *ppPacket = NULL;
-        CHK(FALSE, retStatus);
-    }
-    CHK_STATUS(retStatus);
-    *ppPacket = (PRtpPacket) hashValue;
+    *ppPacket = packetRingGet(pInternal, seqNum);
+    CHK(*ppPacket != NULL, STATUS_HASH_KEY_NOT_PRESENT);
 
 CleanUp:
     return retStatus;
@@ -456,25 +555,17 @@ static STATUS defaultFillPartialFrameData(PJitterBuffer pJitterBuffer, PBYTE pFr
     STATUS retStatus = STATUS_SUCCESS;
     PJitterBufferInternal pInternal = (PJitterBufferInternal) pJitterBuffer;
     UINT16 index;
-    UINT64 hashValue = 0;
     PRtpPacket pPacket = NULL;
     PBYTE pCurPtrInFrame = pFrame;
     UINT32 partialFrameSize = 0;
     UINT32 filledSize = 0;
-    BOOL hasEntry = FALSE;
     BOOL isFirstInFrame = TRUE;
 
     CHK(pInternal != NULL && pFilledSize != NULL, STATUS_NULL_ARG);
 
     for (index = startIndex; UINT16_DEC(index) != endIndex; index++) {
-        if (STATUS_FAILED(hashTableContains(pInternal->pPkgBufferHashTable, index, &hasEntry))) {
-            continue;
-        }
-        if (hasEntry) {
-            if (STATUS_FAILED(hashTableGet(pInternal->pPkgBufferHashTable, index, &hashValue))) {
-                continue;
-            }
-            pPacket = (PRtpPacket) hashValue;
+        pPacket = packetRingGet(pInternal, index);
+        if (pPacket != NULL) {
             if (pFrame != NULL) {
                 partialFrameSize = frameSize - filledSize;
             } else {
@@ -504,12 +595,13 @@ CleanUp:
 static STATUS defaultPush(PJitterBuffer pJitterBuffer, PRtpPacket pRtpPacket, PBOOL pPacketDiscarded)
 {
     ENTERS();
-    STATUS retStatus = STATUS_SUCCESS, status = STATUS_SUCCESS;
-    UINT64 hashValue = 0;
+    STATUS retStatus = STATUS_SUCCESS;
     PRtpPacket pCurPacket = NULL;
+    PJitterBufferFrameState pState = NULL;
     PJitterBufferInternal pInternal = (PJitterBufferInternal) pJitterBuffer;
 
     CHK(pInternal != NULL && pRtpPacket != NULL, STATUS_NULL_ARG);
+    pState = &pInternal->frameState;
 
     if (!pInternal->started) {
         pInternal->started = TRUE;
@@ -531,9 +623,8 @@ static STATUS defaultPush(PJitterBuffer pJitterBuffer, PRtpPacket pRtpPacket, PB
     }
 
     if (withinLatencyTolerance(pInternal, pRtpPacket)) {
-        status = hashTableGet(pInternal->pPkgBufferHashTable, pRtpPacket->header.sequenceNumber, &hashValue);
-        pCurPacket = (PRtpPacket) hashValue;
-        if (STATUS_SUCCEEDED(status) && pCurPacket != NULL) {
+        pCurPacket = packetRingGet(pInternal, pRtpPacket->header.sequenceNumber);
+        if (pCurPacket != NULL) {
             // RED synthetic-vs-real dedup:
             //   existing real + incoming synthetic  → drop incoming (keep real)
             //   existing synthetic + incoming real  → free existing, install real
@@ -545,11 +636,18 @@ static STATUS defaultPush(PJitterBuffer pJitterBuffer, PRtpPacket pRtpPacket, PB
                 }
                 CHK(FALSE, retStatus);
             }
+            packetRingRemove(pInternal, pRtpPacket->header.sequenceNumber);
             freeRtpPacket(&pCurPacket);
-            CHK_STATUS(hashTableRemove(pInternal->pPkgBufferHashTable, pRtpPacket->header.sequenceNumber));
         }
 
-        CHK_STATUS(hashTablePut(pInternal->pPkgBufferHashTable, pRtpPacket->header.sequenceNumber, (UINT64) pRtpPacket));
+        CHK_STATUS(packetRingPut(pInternal, pRtpPacket));
+
+        // Only a packet landing in the part already folded into the frame state invalidates it. Anything past
+        // nextIndex is picked up when the next parse resumes.
+        if ((UINT16) (pRtpPacket->header.sequenceNumber - pState->headSequenceNumber) <
+            (UINT16) (pState->nextIndex - pState->headSequenceNumber)) {
+            pState->valid = FALSE;
+        }
 
         if (headCheckingAllowed(pInternal, pRtpPacket)) {
             if (headTimestampCheck(pInternal, pRtpPacket)) {
@@ -578,6 +676,9 @@ CleanUp:
     return retStatus;
 }
 
+// Walks the buffer from the head and delivers or drops the head frame once it is complete or late. The walk resumes
+// from where the previous one stopped as long as the head, its timestamp and the latency cutoff it was computed with
+// still hold, so every packet is folded into the frame state once instead of on every push.
 static STATUS jitterBufferInternalParse(PJitterBufferInternal pInternal, BOOL bufferClosed)
 {
     ENTERS();
@@ -585,161 +686,160 @@ static STATUS jitterBufferInternalParse(PJitterBufferInternal pInternal, BOOL bu
     UINT16 index;
     UINT16 lastIndex;
     UINT32 earliestAllowedTimestamp = 0;
-    BOOL isFrameDataContinuous = TRUE;
-    BOOL headFrameIsContiguous = TRUE;
     UINT32 curTimestamp = 0;
-    UINT16 startDropIndex = 0;
-    UINT32 curFrameSize = 0;
-    BOOL sizeCalcIsFirst = TRUE;
     UINT32 partialFrameSize = 0;
-    UINT64 hashValue = 0;
-    BOOL isStart = FALSE, containStartForEarliestFrame = FALSE, hasEntry = FALSE;
+    BOOL isStart = FALSE, hasEntry = FALSE;
     UINT16 lastNonNullIndex = 0;
-    UINT16 lastHeadFrameSeqNum = 0;
-    BOOL seenHeadFramePacket = FALSE;
-    UINT16 firstGapIndex = 0;
-    BOOL sawGapSinceLastFrame = FALSE;
-    BOOL headFrameEnded = FALSE;
     PRtpPacket pCurPacket = NULL;
+    PJitterBufferFrameState pState = NULL;
 
     CHK(pInternal != NULL && pInternal->onFrameDroppedFn != NULL && pInternal->onFrameReadyFn != NULL, STATUS_NULL_ARG);
     CHK(pInternal->started, retStatus);
+    pState = &pInternal->frameState;
 
     if (pInternal->base.tailTimestamp > pInternal->maxLatency) {
         earliestAllowedTimestamp = pInternal->base.tailTimestamp - pInternal->maxLatency;
     }
 
     lastIndex = pInternal->tailSequenceNumber + 1;
-    index = pInternal->headSequenceNumber;
-    startDropIndex = index;
-    for (; index != lastIndex; index++) {
-        CHK_STATUS(hashTableContains(pInternal->pPkgBufferHashTable, index, &hasEntry));
-        if (!hasEntry) {
-            isFrameDataContinuous = FALSE;
-            if (!sawGapSinceLastFrame) {
-                firstGapIndex = index;
-                sawGapSinceLastFrame = TRUE;
+
+    // Closing the buffer walks everything once more, lastNonNullIndex is only tracked by a full walk
+    if (bufferClosed || !pState->valid || pState->headSequenceNumber != pInternal->headSequenceNumber ||
+        pState->headTimestamp != pInternal->headTimestamp || earliestAllowedTimestamp < pState->earliestAllowedTimestamp ||
+        (UINT16) (pState->nextIndex - pInternal->headSequenceNumber) > (UINT16) (lastIndex - pInternal->headSequenceNumber)) {
+        resetFrameState(pInternal);
+    }
+
+    for (index = pState->nextIndex; index != lastIndex; index++) {
+        pCurPacket = packetRingGet(pInternal, index);
+        if (pCurPacket == NULL) {
+            // Wait for the missing packet, the walk resumes here on the next push
+            if (pInternal->headTimestamp >= earliestAllowedTimestamp && !bufferClosed) {
+                break;
+            }
+            if (!pState->sawGapSinceLastFrame) {
+                pState->firstGapIndex = index;
+                pState->sawGapSinceLastFrame = TRUE;
             }
-            if (seenHeadFramePacket && !headFrameEnded) {
-                headFrameIsContiguous = FALSE;
+            if (pState->seenHeadFramePacket && !pState->headFrameEnded) {
+                pState->headFrameIsContiguous = FALSE;
             }
-            CHK(pInternal->headTimestamp < earliestAllowedTimestamp || bufferClosed, retStatus);
         } else {
             lastNonNullIndex = index;
-            retStatus = hashTableGet(pInternal->pPkgBufferHashTable, index, &hashValue);
-            if (retStatus == STATUS_HASH_KEY_NOT_PRESENT) {
-                continue;
-            } else {
-                CHK_STATUS(retStatus);
-            }
-            pCurPacket = (PRtpPacket) hashValue;
-            CHK(pCurPacket != NULL, STATUS_NULL_ARG);
             curTimestamp = pCurPacket->header.timestamp;
 
             if (curTimestamp == pInternal->headTimestamp) {
-                lastHeadFrameSeqNum = index;
-                seenHeadFramePacket = TRUE;
+                pState->lastHeadFrameSeqNum = index;
+                pState->seenHeadFramePacket = TRUE;
                 if (pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames) {
-                    headFrameEnded = TRUE;
+                    pState->headFrameEnded = TRUE;
                 }
             }
 
             if (curTimestamp != pInternal->headTimestamp) {
-                if (sawGapSinceLastFrame && seenHeadFramePacket) {
-                    if (firstGapIndex <= lastHeadFrameSeqNum) {
-                        headFrameIsContiguous = FALSE;
-                    } else if (!headFrameEnded) {
-                        headFrameIsContiguous = FALSE;
+                if (pState->sawGapSinceLastFrame && pState->seenHeadFramePacket) {
+                    if (pState->firstGapIndex <= pState->lastHeadFrameSeqNum) {
+                        pState->headFrameIsContiguous = FALSE;
+                    } else if (!pState->headFrameEnded) {
+                        pState->headFrameIsContiguous = FALSE;
                     }
                 }
-                if (containStartForEarliestFrame && headFrameIsContiguous) {
-                    CHK_STATUS(pInternal->onFrameReadyFn(pInternal->customData, startDropIndex, UINT16_DEC(index), curFrameSize));
-                    CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, startDropIndex, UINT16_DEC(index), curTimestamp));
+                if (pState->containStartForEarliestFrame && pState->headFrameIsContiguous) {
+                    CHK_STATUS(pInternal->onFrameReadyFn(pInternal->customData, pState->startDropIndex, UINT16_DEC(index), pState->curFrameSize));
+                    CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, pState->startDropIndex, UINT16_DEC(index), curTimestamp));
                     pInternal->firstFrameProcessed = TRUE;
-                    startDropIndex = index;
-                    containStartForEarliestFrame = FALSE;
-                    headFrameIsContiguous = TRUE;
-                    sawGapSinceLastFrame = FALSE;
-                    lastHeadFrameSeqNum = index;
-                    seenHeadFramePacket = TRUE;
-                    headFrameEnded = pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames;
-                } else if (seenHeadFramePacket && startDropIndex != index && (pInternal->headTimestamp < earliestAllowedTimestamp || bufferClosed)) {
-                    pInternal->onFrameDroppedFn(pInternal->customData, startDropIndex, UINT16_DEC(index), pInternal->headTimestamp);
-                    CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, startDropIndex, UINT16_DEC(index), curTimestamp));
+                    pState->startDropIndex = index;
+                    pState->containStartForEarliestFrame = FALSE;
+                    pState->headFrameIsContiguous = TRUE;
+                    pState->sawGapSinceLastFrame = FALSE;
+                    pState->lastHeadFrameSeqNum = index;
+                    pState->seenHeadFramePacket = TRUE;
+                    pState->headFrameEnded = pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames;
+                } else if (pState->seenHeadFramePacket && pState->startDropIndex != index &&
+                           (pInternal->headTimestamp < earliestAllowedTimestamp || bufferClosed)) {
+                    pInternal->onFrameDroppedFn(pInternal->customData, pState->startDropIndex, UINT16_DEC(index), pInternal->headTimestamp);
+                    CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, pState->startDropIndex, UINT16_DEC(index), curTimestamp));
                     pInternal->firstFrameProcessed = TRUE;
-                    isFrameDataContinuous = TRUE;
-                    headFrameIsContiguous = TRUE;
-                    sawGapSinceLastFrame = FALSE;
-                    lastHeadFrameSeqNum = index;
-                    seenHeadFramePacket = TRUE;
-                    headFrameEnded = pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames;
-                    startDropIndex = index;
-                } else if (seenHeadFramePacket) {
+                    pState->headFrameIsContiguous = TRUE;
+                    pState->sawGapSinceLastFrame = FALSE;
+                    pState->lastHeadFrameSeqNum = index;
+                    pState->seenHeadFramePacket = TRUE;
+                    pState->headFrameEnded = pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames;
+                    pState->startDropIndex = index;
+                } else if (pState->seenHeadFramePacket) {
+                    // The next frame waits for the head frame, the walk resumes here on the next push
                     break;
                 } else {
                     pInternal->headTimestamp = curTimestamp;
-                    startDropIndex = index;
-                    lastHeadFrameSeqNum = index;
-                    seenHeadFramePacket = TRUE;
-                    headFrameEnded = pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames;
-                    headFrameIsContiguous = TRUE;
-                    sawGapSinceLastFrame = FALSE;
+                    pState->startDropIndex = index;
+                    pState->lastHeadFrameSeqNum = index;
+                    pState->seenHeadFramePacket = TRUE;
+                    pState->headFrameEnded = pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames;
+                    pState->headFrameIsContiguous = TRUE;
+                    pState->sawGapSinceLastFrame = FALSE;
                 }
-                curFrameSize = 0;
-                sizeCalcIsFirst = TRUE;
+                pState->curFrameSize = 0;
+                pState->sizeCalcIsFirst = TRUE;
             }
 
-            isStart = sizeCalcIsFirst;
+            isStart = pState->sizeCalcIsFirst;
             CHK_STATUS(pInternal->depayPayloadFn(pCurPacket->payload, pCurPacket->payloadLength, NULL, &partialFrameSize, &isStart));
-            curFrameSize += partialFrameSize;
-            sizeCalcIsFirst = FALSE;
+            pState->curFrameSize += partialFrameSize;
+            pState->sizeCalcIsFirst = FALSE;
             if (isStart && pInternal->headTimestamp == curTimestamp) {
-                containStartForEarliestFrame = TRUE;
+                pState->containStartForEarliestFrame = TRUE;
             }
 
             // RFC 7587 §4.2: an Opus transmitter SHALL set the RTP marker bit
             // to 0, so single-packet-per-frame codecs cannot rely on the marker
             // bit to signal frame end — treat the packet itself as end-of-frame.
             if ((pInternal->firstFrameProcessed || pInternal->alwaysSinglePacketFrames) && curTimestamp == pInternal->headTimestamp &&
-                (pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames) && containStartForEarliestFrame && headFrameIsContiguous) {
-                CHK_STATUS(pInternal->onFrameReadyFn(pInternal->customData, startDropIndex, index, curFrameSize));
-                CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, startDropIndex, index, curTimestamp));
+                (pCurPacket->header.marker || pInternal->alwaysSinglePacketFrames) && pState->containStartForEarliestFrame &&
+                pState->headFrameIsContiguous) {
+                CHK_STATUS(pInternal->onFrameReadyFn(pInternal->customData, pState->startDropIndex, index, pState->curFrameSize));
+                CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, pState->startDropIndex, index, curTimestamp));
                 pInternal->firstFrameProcessed = TRUE;
-                startDropIndex = index + 1;
-                curFrameSize = 0;
-                sizeCalcIsFirst = TRUE;
-                break;
+                // The next frame is assembled from scratch starting at the new head
+                resetFrameState(pInternal);
+                CHK(FALSE, retStatus);
             }
         }
     }
+    pState->nextIndex = index;
 
     // Deal with last frame, we're force clearing the entire buffer.
-    if (bufferClosed && curFrameSize > 0) {
-        curFrameSize = 0;
-        sizeCalcIsFirst = TRUE;
+    if (bufferClosed && pState->curFrameSize > 0) {
+        pState->curFrameSize = 0;
+        pState->sizeCalcIsFirst = TRUE;
         hasEntry = TRUE;
-        for (index = startDropIndex; UINT16_DEC(index) != lastNonNullIndex && hasEntry; index++) {
-            CHK_STATUS(hashTableContains(pInternal->pPkgBufferHashTable, index, &hasEntry));
+        for (index = pState->startDropIndex; UINT16_DEC(index) != lastNonNullIndex && hasEntry; index++) {
+            pCurPacket = packetRingGet(pInternal, index);
+            hasEntry = pCurPacket != NULL;
             if (hasEntry) {
-                CHK_STATUS(hashTableGet(pInternal->pPkgBufferHashTable, index, &hashValue));
-                pCurPacket = (PRtpPacket) hashValue;
-                isStart = sizeCalcIsFirst;
+                isStart = pState->sizeCalcIsFirst;
                 CHK_STATUS(pInternal->depayPayloadFn(pCurPacket->payload, pCurPacket->payloadLength, NULL, &partialFrameSize, &isStart));
-                curFrameSize += partialFrameSize;
-                sizeCalcIsFirst = FALSE;
+                pState->curFrameSize += partialFrameSize;
+                pState->sizeCalcIsFirst = FALSE;
             }
         }
 
         if (UINT16_DEC(index) == lastNonNullIndex) {
-            CHK_STATUS(pInternal->onFrameReadyFn(pInternal->customData, startDropIndex, lastNonNullIndex, curFrameSize));
-            CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, startDropIndex, lastNonNullIndex, pInternal->headTimestamp));
+            CHK_STATUS(pInternal->onFrameReadyFn(pInternal->customData, pState->startDropIndex, lastNonNullIndex, pState->curFrameSize));
+            CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, pState->startDropIndex, lastNonNullIndex, pInternal->headTimestamp));
         } else {
-            CHK_STATUS(pInternal->onFrameDroppedFn(pInternal->customData, startDropIndex, UINT16_DEC(index), pInternal->headTimestamp));
-            CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, startDropIndex, lastNonNullIndex, pInternal->headTimestamp));
+            CHK_STATUS(pInternal->onFrameDroppedFn(pInternal->customData, pState->startDropIndex, UINT16_DEC(index), pInternal->headTimestamp));
+            CHK_STATUS(defaultDropBufferData((PJitterBuffer) pInternal, pState->startDropIndex, lastNonNullIndex, pInternal->headTimestamp));
         }
     }
 
 CleanUp:
+    if (pState != NULL) {
+        pState->valid = STATUS_SUCCEEDED(retStatus) && !bufferClosed;
+        pState->headSequenceNumber = pInternal->headSequenceNumber;
+        pState->headTimestamp = pInternal->headTimestamp;
+        pState->earliestAllowedTimestamp = earliestAllowedTimestamp;
+    }
+
     CHK_LOG_ERR(retStatus);
 
     LEAVES();
@@ -752,25 +852,19 @@ static STATUS defaultDropBufferData(PJitterBuffer pJitterBuffer, UINT16 startInd
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     UINT16 index = startIndex;
-    UINT64 hashValue;
     PRtpPacket pCurPacket = NULL;
-    BOOL hasEntry = FALSE;
     PJitterBufferInternal pInternal = (PJitterBufferInternal) pJitterBuffer;
 
     CHK(pInternal != NULL, STATUS_NULL_ARG);
     for (; UINT16_DEC(index) != endIndex; index++) {
-        CHK_STATUS(hashTableContains(pInternal->pPkgBufferHashTable, index, &hasEntry));
-        if (hasEntry) {
-            CHK_STATUS(hashTableGet(pInternal->pPkgBufferHashTable, index, &hashValue));
-            pCurPacket = (PRtpPacket) hashValue;
-            if (pCurPacket) {
-                freeRtpPacket(&pCurPacket);
-            }
-            CHK_STATUS(hashTableRemove(pInternal->pPkgBufferHashTable, index));
+        pCurPacket = packetRingRemove(pInternal, index);
+        if (pCurPacket != NULL) {
+            freeRtpPacket(&pCurPacket);
         }
     }
     pInternal->headTimestamp = nextTimestamp;
     pInternal->headSequenceNumber = endIndex + 1;
+    pInternal->frameState.valid = FALSE;
     if (exitTimestampOverflowCheck(pInternal)) {
         DLOGS("Exited timestamp overflow state");
     }
@@ -792,7 +886,6 @@ static STATUS defaultFillFrameData(PJitterBuffer pJitterBuffer, PBYTE pFrame, UI
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     UINT16 index = startIndex;
-    UINT64 hashValue;
     PRtpPacket pCurPacket = NULL;
     PBYTE pCurPtrInFrame = pFrame;
     UINT32 remainingFrameSize = frameSize;
@@ -802,10 +895,8 @@ static STATUS defaultFillFrameData(PJitterBuffer pJitterBuffer, PBYTE pFrame, UI
     CHK(pInternal != NULL && pFrame != NULL && pFilledSize != NULL, STATUS_NULL_ARG);
     BOOL isFirstInFrame = TRUE;
     for (; UINT16_DEC(index) != endIndex; index++) {
-        hashValue = 0;
-        CHK_STATUS(hashTableGet(pInternal->pPkgBufferHashTable, index, &hashValue));
-        pCurPacket = (PRtpPacket) hashValue;
-        CHK(pCurPacket != NULL, STATUS_NULL_ARG);
+        pCurPacket = packetRingGet(pInternal, index);
+        CHK(pCurPacket != NULL, STATUS_HASH_KEY_NOT_PRESENT);
         partialFrameSize = remainingFrameSize;
         CHK_STATUS(pInternal->depayPayloadFn(pCurPacket->payload, pCurPacket->payloadLength, pCurPtrInFrame, &partialFrameSize, &isFirstInFrame));
         pCurPtrInFrame += partialFrameSize;
@@ -823,22 +914,13 @@ CleanUp:
     return retStatus;
 }
 
-static STATUS freeRtpPacketHashEntry(UINT64 customData, PHashEntry pEntry)
-{
-    UNUSED_PARAM(customData);
-    if (pEntry != NULL && pEntry->value != 0) {
-        PRtpPacket pPacket = (PRtpPacket) pEntry->value;
-        freeRtpPacket(&pPacket);
-    }
-    return STATUS_SUCCESS;
-}
-
 static STATUS defaultDestroy(PJitterBuffer* ppJitterBuffer)
 {
     ENTERS();
 
     STATUS retStatus = STATUS_SUCCESS;
     PJitterBufferInternal pInternal = NULL;
+    UINT32 i;
 
     CHK(ppJitterBuffer != NULL, STATUS_NULL_ARG);
     CHK(*ppJitterBuffer != NULL, retStatus);
@@ -862,12 +944,18 @@ static STATUS defaultDestroy(PJitterBuffer* ppJitterBuffer)
         }
         defaultDropBufferData((PJitterBuffer) pInternal, pInternal->headSequenceNumber, pInternal->tailSequenceNumber, 0);
     }
-    // Free any RtpPackets that remain in the hash table. Reordered packets can be
+    // Free any RtpPackets that remain in the ring. Reordered packets can be
     // inserted with sequence numbers outside [headSequenceNumber, tailSequenceNumber]
     // (e.g. a late packet arriving after its frame has already been delivered), and
     // the range-based defaultDropBufferData above won't reach them.
-    hashTableIterateEntries(pInternal->pPkgBufferHashTable, 0, freeRtpPacketHashEntry);
-    hashTableFree(pInternal->pPkgBufferHashTable);
+    if (pInternal->pPacketRing != NULL) {
+        for (i = 0; i < pInternal->packetRingSize; i++) {
+            if (pInternal->pPacketRing[i] != NULL) {
+                freeRtpPacket(&pInternal->pPacketRing[i]);
+            }
+        }
+        MEMFREE(pInternal->pPacketRing);
+    }
 
     SAFE_MEMFREE(*ppJitterBuffer);
 
@@ -10,42 +10,90 @@ Based on GCC RFC draft-ietf-rmcat-gcc-02 Section 4
 // Internal helper functions
 //
 
-static PPacerPacket pacerCreatePacket(PBYTE pData, UINT32 size, UINT16 twccSeqNum)
+// Queues a packet at the tail of the queue. The caller has made room.
+static VOID pacerQueuePush(PPacer pPacer, PPacerQueue pQueue, PBYTE pData, UINT32 size, UINT16 twccSeqNum, UINT64 enqueueTimeKvs)
 {
-    PPacerPacket pPacket = (PPacerPacket) MEMCALLOC(1, SIZEOF(PacerPacket));
-    if (pPacket != NULL) {
-        pPacket->pData = pData;
-        pPacket->size = size;
-        pPacket->twccSeqNum = twccSeqNum;
-        pPacket->enqueueTimeKvs = GETTIME();
-        pPacket->pNext = NULL;
-    }
-    return pPacket;
+    PPacerPacket pPacket = &pQueue->pSlots[(pQueue->head + pQueue->count) % pQueue->capacity];
+
+    pPacket->pData = pData;
+    pPacket->size = size;
+    pPacket->twccSeqNum = twccSeqNum;
+    pPacket->enqueueTimeKvs = enqueueTimeKvs;
+    pPacket->priority = (UINT8) (pQueue - pPacer->queues);
+    pQueue->count++;
+    pQueue->bytes += size;
+    pPacer->queueSize++;
+    pPacer->queueBytes += size;
+}
+
+static VOID pacerQueuePop(PPacer pPacer, PPacerQueue pQueue, PPacerPacket pPacket)
+{
+    *pPacket = pQueue->pSlots[pQueue->head];
+    pQueue->head = (pQueue->head + 1) % pQueue->capacity;
+    pQueue->count--;
+    pQueue->bytes -= pPacket->size;
+    pPacer->queueSize--;
+    pPacer->queueBytes -= pPacket->size;
 }
 
-static VOID pacerFreePacket(PPacerPacket pPacket)
+static PPacerQueue pacerNextQueue(PPacer pPacer)
 {
-    if (pPacket != NULL) {
-        SAFE_MEMFREE(pPacket->pData);
-        MEMFREE(pPacket);
+    UINT32 priority;
+
+    for (priority = 0; priority < PACER_PRIORITY_COUNT; priority++) {
+        if (pPacer->queues[priority].count != 0) {
+            return &pPacer->queues[priority];
+        }
     }
+
+    return NULL;
 }
 
-static VOID pacerClearQueue(PPacer pPacer)
+// Drops the oldest packets of lower priorities until count packets of size bytes fit. Higher and equal priority
+// packets are never dropped, so FALSE is returned without touching the queues when they alone leave no room.
+static BOOL pacerMakeRoom(PPacer pPacer, PACER_PRIORITY priority, UINT32 count, UINT32 size)
 {
-    PPacerPacket pCurrent, pNext;
+    UINT32 keptCount = 0, keptBytes = 0, lowest;
+    PacerPacket packet;
+
+    // Only the short padding ring can fill up before the queue limits are reached
+    if (pPacer->queues[priority].count + count > pPacer->queues[priority].capacity) {
+        return FALSE;
+    }
 
-    pCurrent = pPacer->pHead;
-    while (pCurrent != NULL) {
-        pNext = pCurrent->pNext;
-        pacerFreePacket(pCurrent);
-        pCurrent = pNext;
+    for (lowest = 0; lowest <= priority; lowest++) {
+        keptCount += pPacer->queues[lowest].count;
+        keptBytes += pPacer->queues[lowest].bytes;
+    }
+    if (keptCount + count > pPacer->maxQueueSize || keptBytes + size > pPacer->maxQueueBytes) {
+        return FALSE;
     }
 
-    pPacer->pHead = NULL;
-    pPacer->pTail = NULL;
-    pPacer->queueSize = 0;
-    pPacer->queueBytes = 0;
+    lowest = PACER_PRIORITY_COUNT - 1;
+    while (pPacer->queueSize + count > pPacer->maxQueueSize || pPacer->queueBytes + size > pPacer->maxQueueBytes) {
+        if (pPacer->queues[lowest].count == 0) {
+            lowest--;
+            continue;
+        }
+
+        pacerQueuePop(pPacer, &pPacer->queues[lowest], &packet);
+        pPacer->stats.packetsDropped++;
+        pPacer->stats.bytesDropped += packet.size;
+        packetPoolFree(pPacer->pPacketPool, packet.pData);
+    }
+
+    return TRUE;
+}
+
+static VOID pacerClearQueue(PPacer pPacer)
+{
+    PPacerQueue pQueue;
+    PacerPacket packet;
+
+    while ((pQueue = pacerNextQueue(pPacer)) != NULL) {
+        pacerQueuePop(pPacer, pQueue, &packet);
+        packetPoolFree(pPacer->pPacketPool, packet.pData);
+    }
 }
 
 //
@@ -57,6 +105,7 @@ STATUS createPacer(PPacer* ppPacer, TIMER_QUEUE_HANDLE timerQueueHandle, PPacerC
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     PPacer pPacer = NULL;
+    UINT32 i, slotCount;
 
     CHK(ppPacer != NULL, STATUS_NULL_ARG);
     CHK(IS_VALID_TIMER_QUEUE_HANDLE(timerQueueHandle), STATUS_INVALID_ARG);
@@ -87,9 +136,17 @@ STATUS createPacer(PPacer* ppPacer, TIMER_QUEUE_HANDLE timerQueueHandle, PPacerC
         pPacer->enabled = TRUE;
     }
 
-    // Initialize queue
-    pPacer->pHead = NULL;
-    pPacer->pTail = NULL;
+    // Every media queue gets a ring as large as the whole queue limit and padding a short one, carved out of one allocation
+    for (i = 0, slotCount = 0; i < PACER_PRIORITY_COUNT; i++) {
+        pPacer->queues[i].capacity = i == PACER_PRIORITY_PADDING ? MIN(PACER_PADDING_QUEUE_SIZE, pPacer->maxQueueSize) : pPacer->maxQueueSize;
+        slotCount += pPacer->queues[i].capacity;
+    }
+    pPacer->pSlots = (PPacerPacket) MEMALLOC(slotCount * SIZEOF(PacerPacket));
+    CHK(pPacer->pSlots != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    for (i = 0, slotCount = 0; i < PACER_PRIORITY_COUNT; i++) {
+        pPacer->queues[i].pSlots = pPacer->pSlots + slotCount;
+        slotCount += pPacer->queues[i].capacity;
+    }
     pPacer->queueSize = 0;
     pPacer->queueBytes = 0;
 
@@ -133,6 +190,7 @@ STATUS freePacer(PPacer* ppPacer)
         MUTEX_FREE(pPacer->lock);
     }
 
+    SAFE_MEMFREE(pPacer->pSlots);
     SAFE_MEMFREE(pPacer);
     *ppPacer = NULL;
 
@@ -169,10 +227,10 @@ STATUS pacerStart(PPacer pPacer, PVOID pKvsPeerConnection)
     locked = FALSE;
 
     // Start periodic timer without holding the pacer lock
-    CHK_STATUS(timerQueueAddTimer(pPacer->timerQueueHandle,
-                                  PACER_INTERVAL_KVS, // Initial delay
-                                  PACER_INTERVAL_KVS, // Period
-                                  pacerTimerCallback, (UINT64) pPacer, &timerId));
+    CHK_STATUS(kvsTimerQueueAddTimer(pPacer->timerQueueHandle,
+                                     PACER_INTERVAL_KVS, // Initial delay
+                                     PACER_INTERVAL_KVS, // Period
+                                     pacerTimerCallback, (UINT64) pPacer, &timerId));
 
     MUTEX_LOCK(pPacer->lock);
     locked = TRUE;
@@ -212,7 +270,7 @@ STATUS pacerStop(PPacer pPacer)
     locked = FALSE;
 
     if (timerId != MAX_UINT32) {
-        timerQueueCancelTimer(pPacer->timerQueueHandle, timerId, (UINT64) pPacer);
+        kvsTimerQueueCancelTimer(pPacer->timerQueueHandle, timerId, (UINT64) pPacer);
         DLOGD("Pacer stopped");
     }
 
@@ -225,43 +283,31 @@ CleanUp:
     return retStatus;
 }
 
-STATUS pacerEnqueuePacket(PPacer pPacer, PBYTE pData, UINT32 size, UINT16 twccSeqNum)
+STATUS pacerEnqueuePacket(PPacer pPacer, PACER_PRIORITY priority, PBYTE pData, UINT32 size, UINT16 twccSeqNum)
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     BOOL locked = FALSE;
-    PPacerPacket pPacket = NULL;
 
     CHK(pPacer != NULL && pData != NULL && size > 0, STATUS_NULL_ARG);
+    CHK(priority < PACER_PRIORITY_COUNT, STATUS_INVALID_ARG);
 
     MUTEX_LOCK(pPacer->lock);
     locked = TRUE;
 
     // Check queue limits
-    if (pPacer->queueSize >= pPacer->maxQueueSize || pPacer->queueBytes + size > pPacer->maxQueueBytes) {
+    if (!pacerMakeRoom(pPacer, priority, 1, size)) {
         // Queue is full, drop the packet
         pPacer->stats.packetsDropped++;
         pPacer->stats.bytesDropped += size;
         DLOGW("Pacer queue full, dropping packet. Queue: %u/%u packets, %u/%u bytes", pPacer->queueSize, pPacer->maxQueueSize, pPacer->queueBytes,
               pPacer->maxQueueBytes);
         // Free the packet data since we own it
-        SAFE_MEMFREE(pData);
+        packetPoolFree(pPacer->pPacketPool, pData);
         CHK(FALSE, STATUS_NOT_ENOUGH_MEMORY);
     }
 
-    // Create packet wrapper
-    pPacket = pacerCreatePacket(pData, size, twccSeqNum);
-    CHK(pPacket != NULL, STATUS_NOT_ENOUGH_MEMORY);
-
-    // Add to tail of queue
-    if (pPacer->pTail != NULL) {
-        pPacer->pTail->pNext = pPacket;
-    } else {
-        pPacer->pHead = pPacket;
-    }
-    pPacer->pTail = pPacket;
-    pPacer->queueSize++;
-    pPacer->queueBytes += size;
+    pacerQueuePush(pPacer, &pPacer->queues[priority], pData, size, twccSeqNum, GETTIME());
 
     // Update stats
     pPacer->stats.currentQueueSize = pPacer->queueSize;
@@ -388,6 +434,20 @@ CleanUp:
     return retStatus;
 }
 
+STATUS pacerSetPacketPool(PPacer pPacer, PPacketPool pPacketPool)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pPacer != NULL, STATUS_NULL_ARG);
+
+    MUTEX_LOCK(pPacer->lock);
+    pPacer->pPacketPool = pPacketPool;
+    MUTEX_UNLOCK(pPacer->lock);
+
+CleanUp:
+    return retStatus;
+}
+
 UINT64 pacerGetMaxQueueTime(PPacer pPacer)
 {
     UINT64 maxQueueTimeKvs = 0;
@@ -403,17 +463,17 @@ UINT64 pacerGetMaxQueueTime(PPacer pPacer)
     return maxQueueTimeKvs;
 }
 
-STATUS pacerEnqueueFrame(PPacer pPacer, PPacerPacketInfo pPackets, UINT32 count)
+STATUS pacerEnqueueFrame(PPacer pPacer, PACER_PRIORITY priority, PPacerPacketInfo pPackets, UINT32 count)
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     BOOL locked = FALSE;
-    PPacerPacket pPacket = NULL;
     UINT64 frameEnqueueTime;
     UINT32 totalBytes = 0;
     UINT32 i;
 
     CHK(pPacer != NULL && pPackets != NULL && count > 0, STATUS_NULL_ARG);
+    CHK(priority < PACER_PRIORITY_COUNT, STATUS_INVALID_ARG);
 
     // Calculate total bytes for queue limit check
     for (i = 0; i < count; i++) {
@@ -425,7 +485,7 @@ STATUS pacerEnqueueFrame(PPacer pPacer, PPacerPacketInfo pPackets, UINT32 count)
     locked = TRUE;
 
     // Check queue limits for entire frame
-    if (pPacer->queueSize + count > pPacer->maxQueueSize || pPacer->queueBytes + totalBytes > pPacer->maxQueueBytes) {
+    if (!pacerMakeRoom(pPacer, priority, count, totalBytes)) {
         // Queue is full, drop the entire frame
         pPacer->stats.packetsDropped += count;
         pPacer->stats.bytesDropped += totalBytes;
@@ -433,40 +493,15 @@ STATUS pacerEnqueueFrame(PPacer pPacer, PPacerPacketInfo pPackets, UINT32 count)
               pPacer->maxQueueSize, pPacer->queueBytes, pPacer->maxQueueBytes);
         // Free all packet data since we own it
         for (i = 0; i < count; i++) {
-            SAFE_MEMFREE(pPackets[i].pData);
+            packetPoolFree(pPacer->pPacketPool, pPackets[i].pData);
         }
         CHK(FALSE, STATUS_NOT_ENOUGH_MEMORY);
     }
 
     // All packets in frame share the same enqueue time
     frameEnqueueTime = GETTIME();
-
-    // Enqueue all packets
     for (i = 0; i < count; i++) {
-        pPacket = (PPacerPacket) MEMCALLOC(1, SIZEOF(PacerPacket));
-        if (pPacket == NULL) {
-            // Memory allocation failed - free remaining packet data
-            for (; i < count; i++) {
-                SAFE_MEMFREE(pPackets[i].pData);
-            }
-            CHK(FALSE, STATUS_NOT_ENOUGH_MEMORY);
-        }
-
-        pPacket->pData = pPackets[i].pData;
-        pPacket->size = pPackets[i].size;
-        pPacket->twccSeqNum = pPackets[i].twccSeqNum;
-        pPacket->enqueueTimeKvs = frameEnqueueTime; // Same time for all packets in frame
-        pPacket->pNext = NULL;
-
-        // Add to tail of queue
-        if (pPacer->pTail != NULL) {
-            pPacer->pTail->pNext = pPacket;
-        } else {
-            pPacer->pHead = pPacket;
-        }
-        pPacer->pTail = pPacket;
-        pPacer->queueSize++;
-        pPacer->queueBytes += pPacket->size;
+        pacerQueuePush(pPacer, &pPacer->queues[priority], pPackets[i].pData, pPackets[i].size, pPackets[i].twccSeqNum, frameEnqueueTime);
     }
 
     // Update stats
@@ -508,16 +543,37 @@ UINT32 pacerCalculateBudget(PPacer pPacer, UINT64 elapsedTimeKvs)
     return (UINT32) MIN(bytesPerInterval, MAX_UINT32);
 }
 
+BOOL pacerDequeuePacket(PPacer pPacer, UINT64 budgetBytes, PPacerPacket pPacket)
+{
+    PPacerQueue pQueue;
+
+    if (pPacer == NULL || pPacket == NULL) {
+        return FALSE;
+    }
+
+    // Strict priority: a lower priority packet never overtakes a higher priority one that is waiting for budget
+    pQueue = pacerNextQueue(pPacer);
+    if (pQueue == NULL || pQueue->pSlots[pQueue->head].size > budgetBytes) {
+        return FALSE;
+    }
+
+    pacerQueuePop(pPacer, pQueue, pPacket);
+    return TRUE;
+}
+
 STATUS pacerDrainQueue(PPacer pPacer)
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    PPacerPacket pPacket = NULL;
+    PPacerQueue pQueue;
     UINT64 now = GETTIME();
-    UINT64 elapsedTimeKvs;
-    UINT32 bytesSent = 0;
-    UINT64 queueDelayKvs;
+    UINT64 elapsedTimeKvs, oldestEnqueueTimeKvs;
+    UINT32 bytesSent = 0, batchCount, batchBytes, sentCount = 0, i;
+    UINT64 queueDelayKvs, sentTimeKvs;
     PKvsPeerConnection pKvsPeerConnection = NULL;
+    PacerPacket batch[SOCKET_SEND_BATCH_MAX_PACKETS];
+    PBYTE sendBuffers[SOCKET_SEND_BATCH_MAX_PACKETS];
+    UINT32 sendBufferLens[SOCKET_SEND_BATCH_MAX_PACKETS];
 
     CHK(pPacer != NULL, STATUS_NULL_ARG);
     CHK(pPacer->pKvsPeerConnection != NULL, STATUS_INVALID_OPERATION);
@@ -530,8 +586,15 @@ STATUS pacerDrainQueue(PPacer pPacer)
     pPacer->lastSendTimeKvs = now;
 
     // Frame-rate pacing: ensure oldest packet meets deadline
-    if (pPacer->maxQueueTimeKvs > 0 && pPacer->pHead != NULL) {
-        UINT64 oldestPacketAge = now - pPacer->pHead->enqueueTimeKvs;
+    if (pPacer->maxQueueTimeKvs > 0 && pPacer->queueSize != 0) {
+        oldestEnqueueTimeKvs = now;
+        for (i = 0; i < PACER_PRIORITY_COUNT; i++) {
+            pQueue = &pPacer->queues[i];
+            if (pQueue->count != 0) {
+                oldestEnqueueTimeKvs = MIN(oldestEnqueueTimeKvs, pQueue->pSlots[pQueue->head].enqueueTimeKvs);
+            }
+        }
+        UINT64 oldestPacketAge = now - oldestEnqueueTimeKvs;
 
         if (oldestPacketAge < pPacer->maxQueueTimeKvs) {
             // Time remaining to clear queue
@@ -553,51 +616,64 @@ STATUS pacerDrainQueue(PPacer pPacer)
         }
     }
 
-    // Send packets while we have budget and packets in queue
-    while (pPacer->pHead != NULL && pPacer->budgetBytes >= pPacer->pHead->size) {
-        // Dequeue packet from head
-        pPacket = pPacer->pHead;
-        pPacer->pHead = pPacket->pNext;
-        if (pPacer->pHead == NULL) {
-            pPacer->pTail = NULL;
-        }
-        pPacer->queueSize--;
-        pPacer->queueBytes -= pPacket->size;
-
-        // Calculate queuing delay
-        queueDelayKvs = now - pPacket->enqueueTimeKvs;
+    // Send packets while we have budget and packets in queue, highest priority first
+    do {
+        // Dequeue the run of packets that fits the budget so it goes out in a single batched send
+        batchCount = 0;
+        batchBytes = 0;
+        while (batchCount < SOCKET_SEND_BATCH_MAX_PACKETS && pacerDequeuePacket(pPacer, pPacer->budgetBytes - batchBytes, &batch[batchCount])) {
+            // Calculate queuing delay
+            queueDelayKvs = now - batch[batchCount].enqueueTimeKvs;
+
+            // Update average queue delay (exponential moving average)
+            if (pPacer->stats.avgQueueDelayKvs == 0) {
+                pPacer->stats.avgQueueDelayKvs = queueDelayKvs;
+            } else {
+                pPacer->stats.avgQueueDelayKvs = (UINT64) (0.9 * pPacer->stats.avgQueueDelayKvs + 0.1 * queueDelayKvs);
+            }
 
-        // Update average queue delay (exponential moving average)
-        if (pPacer->stats.avgQueueDelayKvs == 0) {
-            pPacer->stats.avgQueueDelayKvs = queueDelayKvs;
-        } else {
-            pPacer->stats.avgQueueDelayKvs = (UINT64) (0.9 * pPacer->stats.avgQueueDelayKvs + 0.1 * queueDelayKvs);
+            sendBuffers[batchCount] = batch[batchCount].pData;
+            sendBufferLens[batchCount] = batch[batchCount].size;
+            batchBytes += batch[batchCount].size;
+            batchCount++;
         }
 
-        // Send the packet
-        retStatus = iceAgentSendPacket(pKvsPeerConnection->pIceAgent, pPacket->pData, pPacket->size);
-        if (STATUS_SUCCEEDED(retStatus)) {
-            UINT64 sentTimeKvs = GETTIME();
-
-            bytesSent += pPacket->size;
-            pPacer->stats.packetsSent++;
-            pPacer->stats.bytesSent += pPacket->size;
+        if (batchCount == 0) {
+            break;
+        }
 
-            // Deduct from budget
-            pPacer->budgetBytes -= pPacket->size;
+        // Send the batch, only the leading sentCount packets left
+        sentCount = 0;
+        retStatus = iceAgentSendPackets(pKvsPeerConnection->pIceAgent, sendBuffers, sendBufferLens, batchCount, &sentCount);
+        sentTimeKvs = GETTIME();
+        if (STATUS_FAILED(retStatus) || sentCount < batchCount) {
+            DLOGW("Sent %u of %u paced packets: 0x%08x", sentCount, batchCount, retStatus);
+        }
 
-            // Update TWCC manager with actual send time
-            if (pPacket->twccSeqNum != 0 && pKvsPeerConnection->twccExtId != 0) {
-                twccManagerOnPacedPacketSent(pKvsPeerConnection, pPacket->twccSeqNum, pPacket->size, sentTimeKvs);
+        for (i = 0; i < batchCount; i++) {
+            if (i >= sentCount) {
+                pPacer->stats.packetsDiscardedOnSend++;
+                pPacer->stats.bytesDiscardedOnSend += batch[i].size;
+            } else {
+                bytesSent += batch[i].size;
+                pPacer->stats.packetsSent++;
+                pPacer->stats.bytesSent += batch[i].size;
+                pPacer->stats.packetsSentByPriority[batch[i].priority]++;
+
+                // Deduct from budget
+                pPacer->budgetBytes -= batch[i].size;
+
+                // Update TWCC manager with actual send time
+                if (batch[i].twccSeqNum != 0 && pKvsPeerConnection->twccExtId != 0) {
+                    twccManagerOnPacedPacketSent(pKvsPeerConnection, batch[i].twccSeqNum, batch[i].size, sentTimeKvs);
+                }
             }
-        } else {
-            DLOGW("Failed to send paced packet: 0x%08x", retStatus);
-        }
 
-        // Free the packet (data is owned by packet)
-        pacerFreePacket(pPacket);
-        pPacket = NULL;
-    }
+            // The pacer owns the data until it is sent
+            packetPoolFree(pPacer->pPacketPool, batch[i].pData);
+        }
+        // A socket that did not take the whole batch will not take more this interval, keep the rest queued
+    } while (batchCount == SOCKET_SEND_BATCH_MAX_PACKETS && sentCount == batchCount);
 
     // Update queue stats
     pPacer->stats.currentQueueSize = pPacer->queueSize;
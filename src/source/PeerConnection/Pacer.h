@@ -19,6 +19,9 @@ extern "C" {
 #define PACER_DEFAULT_MAX_QUEUE_SIZE  500               // Maximum packets in queue
 #define PACER_DEFAULT_MAX_QUEUE_BYTES (2 * 1024 * 1024) // 2MB max queue size
 
+// Ring size of the padding queue. Padding only fills what the budget leaves over, it never needs a deep queue.
+#define PACER_PADDING_QUEUE_SIZE 16
+
 // Default pacing factor - allows sending at higher rate to clear queues faster
 // libwebrtc uses 2.5x, which helps clear large I-frames quickly
 #define PACER_DEFAULT_PACING_FACTOR 2.5
@@ -26,6 +29,17 @@ extern "C" {
 // Minimum bitrate to prevent divide-by-zero
 #define PACER_MIN_BITRATE_BPS 10000 // 10 kbps minimum
 
+/**
+ * Pacer queues, drained strictly in this order from one shared byte budget
+ */
+typedef enum {
+    PACER_PRIORITY_AUDIO,          //!< Audio frames, small and the most latency sensitive
+    PACER_PRIORITY_RETRANSMISSION, //!< NACK retransmissions, ahead of new video so losses heal before the next frame
+    PACER_PRIORITY_VIDEO,          //!< Video frames
+    PACER_PRIORITY_PADDING,        //!< Padding and probes, only sent when nothing else is queued
+    PACER_PRIORITY_COUNT,
+} PACER_PRIORITY;
+
 /**
  * Packet info for batch enqueue (frame-based pacing)
  */
@@ -38,14 +52,26 @@ typedef struct {
 /**
  * Queued packet for paced sending
  */
-typedef struct __PacerPacket {
-    PBYTE pData;                 //!< Encrypted packet data (owned by pacer)
-    UINT32 size;                 //!< Packet size in bytes
-    UINT64 enqueueTimeKvs;       //!< When packet was enqueued
-    UINT16 twccSeqNum;           //!< TWCC sequence number for tracking
-    struct __PacerPacket* pNext; //!< Next packet in queue
+typedef struct {
+    PBYTE pData;           //!< Encrypted packet data (owned by pacer)
+    UINT32 size;           //!< Packet size in bytes
+    UINT64 enqueueTimeKvs; //!< When packet was enqueued
+    UINT16 twccSeqNum;     //!< TWCC sequence number for tracking
+    UINT8 priority;        //!< PACER_PRIORITY of the queue holding the packet
 } PacerPacket, *PPacerPacket;
 
+/**
+ * FIFO of one priority. Media queues get a ring of maxQueueSize slots so a single class can hold the whole queue,
+ * the padding queue a ring of PACER_PADDING_QUEUE_SIZE slots.
+ */
+typedef struct {
+    PPacerPacket pSlots; //!< Ring storage, part of the pacer's single slot allocation
+    UINT32 capacity;     //!< Slots in the ring
+    UINT32 head;         //!< Slot of the oldest packet
+    UINT32 count;        //!< Packets queued
+    UINT32 bytes;        //!< Bytes queued
+} PacerQueue, *PPacerQueue;
+
 /**
  * Pacer configuration
  */
@@ -62,14 +88,17 @@ typedef struct {
  * Pacer statistics
  */
 typedef struct {
-    UINT64 packetsSent;         //!< Total packets sent through pacer
-    UINT64 bytesSent;           //!< Total bytes sent
-    UINT64 packetsDropped;      //!< Packets dropped due to queue overflow
-    UINT64 bytesDropped;        //!< Bytes dropped due to queue overflow
-    UINT64 currentQueueSize;    //!< Current number of packets in queue
-    UINT64 currentQueueBytes;   //!< Current bytes in queue
-    UINT64 maxQueueSizeReached; //!< Maximum queue size reached
-    UINT64 avgQueueDelayKvs;    //!< Average queuing delay (100ns units)
+    UINT64 packetsSent;                                 //!< Total packets sent through pacer
+    UINT64 bytesSent;                                   //!< Total bytes sent
+    UINT64 packetsDropped;                              //!< Packets dropped due to queue overflow
+    UINT64 bytesDropped;                                //!< Bytes dropped due to queue overflow
+    UINT64 packetsDiscardedOnSend;                      //!< Dequeued packets the socket did not take
+    UINT64 bytesDiscardedOnSend;                        //!< Bytes of the packets the socket did not take
+    UINT64 currentQueueSize;                            //!< Current number of packets in queue
+    UINT64 currentQueueBytes;                           //!< Current bytes in queue
+    UINT64 maxQueueSizeReached;                         //!< Maximum queue size reached
+    UINT64 avgQueueDelayKvs;                            //!< Average queuing delay (100ns units)
+    UINT64 packetsSentByPriority[PACER_PRIORITY_COUNT]; //!< Packets sent from each priority queue
 } PacerStats, *PPacerStats;
 
 /**
@@ -79,13 +108,12 @@ typedef struct __Pacer {
     MUTEX lock;   //!< Thread safety
     BOOL enabled; //!< Is pacing enabled?
 
-    // Queue management
-    PPacerPacket pHead;   //!< Head of packet queue
-    PPacerPacket pTail;   //!< Tail of packet queue
-    UINT32 queueSize;     //!< Number of packets in queue
-    UINT32 queueBytes;    //!< Total bytes in queue
-    UINT32 maxQueueSize;  //!< Maximum packets allowed
-    UINT32 maxQueueBytes; //!< Maximum bytes allowed
+    // Queue management, the limits apply to all priorities together
+    PacerQueue queues[PACER_PRIORITY_COUNT]; //!< One FIFO per priority
+    UINT32 queueSize;                        //!< Number of packets in all queues
+    UINT32 queueBytes;                       //!< Total bytes in all queues
+    UINT32 maxQueueSize;                     //!< Maximum packets allowed
+    UINT32 maxQueueBytes;                    //!< Maximum bytes allowed
 
     // Rate control
     UINT64 targetBitrateBps; //!< Target bitrate from GCC
@@ -101,6 +129,10 @@ typedef struct __Pacer {
     // Parent peer connection (for sending) - stored as PVOID to avoid circular dependency
     PVOID pKvsPeerConnection;
 
+    // Packet memory
+    PPacketPool pPacketPool; //!< Pool packet data is released to (not owned, NULL for heap)
+    PPacerPacket pSlots;     //!< Ring slots of every queue, allocated once at creation
+
     // Statistics
     PacerStats stats;
 } Pacer, *PPacer;
@@ -146,27 +178,30 @@ STATUS pacerStop(PPacer pPacer);
 
 /**
  * Enqueue a packet for paced sending
- * The pacer takes ownership of the packet data
+ * The pacer takes ownership of the packet data. When the queue is full, queued packets of lower priority are dropped,
+ * oldest first, to make room.
  *
  * @param[in] pPacer Pacer instance
- * @param[in] pData Packet data (pacer takes ownership, will free)
+ * @param[in] priority Queue the packet goes to
+ * @param[in] pData Packet data (pacer takes ownership, will release it to the configured packet pool)
  * @param[in] size Packet size in bytes
  * @param[in] twccSeqNum TWCC sequence number for the packet
  * @return STATUS code (STATUS_SUCCESS or STATUS_NOT_ENOUGH_MEMORY if queue full)
  */
-STATUS pacerEnqueuePacket(PPacer pPacer, PBYTE pData, UINT32 size, UINT16 twccSeqNum);
+STATUS pacerEnqueuePacket(PPacer pPacer, PACER_PRIORITY priority, PBYTE pData, UINT32 size, UINT16 twccSeqNum);
 
 /**
  * Enqueue multiple packets as a frame (batch enqueue with single lock)
  * All packets share the same enqueue timestamp for frame-deadline pacing.
- * The pacer takes ownership of all packet data.
+ * The pacer takes ownership of all packet data. The frame is either queued whole or dropped whole.
  *
  * @param[in] pPacer Pacer instance
+ * @param[in] priority Queue the frame goes to
  * @param[in] pPackets Array of packet info structures
  * @param[in] count Number of packets in array
  * @return STATUS code (STATUS_SUCCESS or STATUS_NOT_ENOUGH_MEMORY if queue full)
  */
-STATUS pacerEnqueueFrame(PPacer pPacer, PPacerPacketInfo pPackets, UINT32 count);
+STATUS pacerEnqueueFrame(PPacer pPacer, PACER_PRIORITY priority, PPacerPacketInfo pPackets, UINT32 count);
 
 /**
  * Set the target bitrate for pacing
@@ -228,6 +263,15 @@ UINT32 pacerGetQueueSize(PPacer pPacer);
  */
 STATUS pacerSetMaxQueueTime(PPacer pPacer, UINT64 maxQueueTimeKvs);
 
+/**
+ * Set the pool enqueued packet data is allocated from. Must be called before the first packet is enqueued.
+ *
+ * @param[in] pPacer Pacer instance
+ * @param[in] pPacketPool Pool instance, NULL for heap allocated packet data
+ * @return STATUS code
+ */
+STATUS pacerSetPacketPool(PPacer pPacer, PPacketPool pPacketPool);
+
 /**
  * Get current max queue time
  *
@@ -250,6 +294,17 @@ STATUS pacerTimerCallback(UINT32 timerId, UINT64 currentTime, UINT64 customData)
  */
 STATUS pacerDrainQueue(PPacer pPacer);
 
+/**
+ * Take the next packet in priority order if it fits in the budget. Must be called with the pacer lock held.
+ * The caller owns the packet data afterwards.
+ *
+ * @param[in] pPacer Pacer instance
+ * @param[in] budgetBytes Bytes that may still be sent
+ * @param[out] pPacket Dequeued packet
+ * @return TRUE if a packet was dequeued, FALSE if all queues are empty or the next packet does not fit
+ */
+BOOL pacerDequeuePacket(PPacer pPacer, UINT64 budgetBytes, PPacerPacket pPacket);
+
 /**
  * Calculate bytes allowed to send based on bitrate and elapsed time
  */
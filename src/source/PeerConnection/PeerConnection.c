@@ -156,10 +156,11 @@ STATUS allocateSctp(PKvsPeerConnection pKvsPeerConnection)
     sctpSessionCallbacks.customData = (UINT64) pKvsPeerConnection;
     CHK_STATUS(createSctpSession(&sctpSessionCallbacks, &(pKvsPeerConnection->pSctpSession)));
 #ifdef ENABLE_NATIVE_SCTP
+    CHK_STATUS(sctpSessionSetMaxMessageSize(pKvsPeerConnection->pSctpSession, pKvsPeerConnection->sctpMaxMessageSize));
     // Start periodic SCTP timer to drive retransmissions independently of incoming packets
     if (IS_VALID_TIMER_QUEUE_HANDLE(pKvsPeerConnection->timerQueueHandle)) {
-        CHK_STATUS(timerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, SCTP_TIMER_TICK_PERIOD, SCTP_TIMER_TICK_PERIOD, sctpTimerCallback,
-                                      (UINT64) pKvsPeerConnection, &pKvsPeerConnection->sctpTimerCallbackId));
+        CHK_STATUS(kvsTimerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, SCTP_TIMER_TICK_PERIOD, SCTP_TIMER_TICK_PERIOD, sctpTimerCallback,
+                                         (UINT64) pKvsPeerConnection, &pKvsPeerConnection->sctpTimerCallbackId));
     }
 #endif
 
@@ -454,7 +455,7 @@ STATUS sendPacketToRtpReceiver(PKvsPeerConnection pKvsPeerConnection, PBYTE pBuf
     UINT64 now;
     UINT32 ssrc;
     PRtpPacket pRtpPacket = NULL;
-    PBYTE pPayload = NULL;
+    RtpPacket twccPacket;
 
     CHK(pKvsPeerConnection != NULL && pBuffer != NULL, STATUS_NULL_ARG);
     CHK(bufferLen >= MIN_HEADER_LENGTH, STATUS_INVALID_ARG);
@@ -465,19 +466,12 @@ STATUS sendPacketToRtpReceiver(PKvsPeerConnection pKvsPeerConnection, PBYTE pBuf
     // RTP header and extensions are NOT encrypted by SRTP (only payload is)
     // This ensures we track TWCC even for packets that fail SRTP replay check
     if (pKvsPeerConnection->twccExtId != 0) {
-        // Parse RTP header from raw (still encrypted) packet to get TWCC extension
-        PRtpPacket pTwccPacket = NULL;
-        PBYTE pTwccBuffer = (PBYTE) MEMALLOC(bufferLen);
-        if (pTwccBuffer != NULL) {
-            MEMCPY(pTwccBuffer, pBuffer, bufferLen);
-            if (STATUS_SUCCEEDED(createRtpPacketFromBytes(pTwccBuffer, bufferLen, &pTwccPacket))) {
-                pTwccPacket->receivedTime = now;
-                if (pTwccPacket->header.extension && pTwccPacket->header.extensionProfile == TWCC_EXT_PROFILE) {
-                    twccReceiverOnPacketReceived(pKvsPeerConnection, pTwccPacket);
-                }
-                freeRtpPacket(&pTwccPacket);
-            } else {
-                MEMFREE(pTwccBuffer);
+        // Parse the RTP header in place; twccReceiverOnPacketReceived only reads the header extension
+        MEMSET(&twccPacket, 0x00, SIZEOF(RtpPacket));
+        if (STATUS_SUCCEEDED(setRtpPacketFromBytes(pBuffer, bufferLen, &twccPacket))) {
+            twccPacket.receivedTime = now;
+            if (twccPacket.header.extension && twccPacket.header.extensionProfile == TWCC_EXT_PROFILE) {
+                twccReceiverOnPacketReceived(pKvsPeerConnection, &twccPacket);
             }
         }
     }
@@ -493,10 +487,9 @@ STATUS sendPacketToRtpReceiver(PKvsPeerConnection pKvsPeerConnection, PBYTE pBuf
         pcapDumpWritePacket(pKvsPeerConnection->pPcapDump, pBuffer, bufferLen, FALSE, PCAP_PACKET_DIRECTION_RECV);
     }
 
-    CHK(NULL != (pPayload = (PBYTE) MEMALLOC(bufferLen)), STATUS_NOT_ENOUGH_MEMORY);
-    MEMCPY(pPayload, pBuffer, bufferLen);
-    CHK_STATUS(createRtpPacketFromBytes(pPayload, bufferLen, &pRtpPacket));
-    pPayload = NULL; // pRtpPacket now owns the buffer
+    // The socket buffer is reused for the next datagram, so the packet gets a single copy into a pool block
+    // that carries both the RtpPacket and its bytes. The jitter buffer owns it from here on.
+    CHK_STATUS(createRtpPacketFromPool(pKvsPeerConnection->pInboundPacketPool, pBuffer, bufferLen, &pRtpPacket));
     pRtpPacket->receivedTime = now;
 
     ssrc = pRtpPacket->header.ssrc;
@@ -518,7 +511,6 @@ STATUS sendPacketToRtpReceiver(PKvsPeerConnection pKvsPeerConnection, PBYTE pBuf
     }
 
 CleanUp:
-    SAFE_MEMFREE(pPayload);
     freeRtpPacket(&pRtpPacket);
     CHK_LOG_ERR(retStatus);
 
@@ -579,6 +571,79 @@ CleanUp:
     return retStatus;
 }
 
+// Hands a complete frame to onFrameFragments as slices of the jitter buffer's packets instead of copying it into
+// peerFrameBuffer. The packets are dropped by the jitter buffer once the frame ready callback returns.
+static STATUS deliverFrameFragments(PKvsRtpTransceiver pTransceiver, PFrame pFrame, UINT16 startIndex, UINT16 endIndex)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PRtpPacket pPacket = NULL;
+    PRtcFrameFragment pNewFragments = NULL;
+    PBYTE pNewBackup = NULL;
+    UINT16 index;
+    UINT32 i, fragmentCount = 0, packetFragmentCount = 0, packetCount = 0, filledPackets = 0, newCapacity, filledSize = 0;
+    BOOL isStart = TRUE;
+
+    // Count first so the arrays are grown once per frame
+    for (index = startIndex; UINT16_DEC(index) != endIndex; index++) {
+        CHK_STATUS(jitterBufferGetPacket(pTransceiver->pJitterBuffer, index, &pPacket));
+        CHK_STATUS(pTransceiver->depayFragmentsFn(pPacket->payload, pPacket->payloadLength, NULL, &packetFragmentCount, NULL));
+        fragmentCount += packetFragmentCount;
+        packetCount++;
+    }
+
+    if (fragmentCount > pTransceiver->frameFragmentsCapacity) {
+        newCapacity = MAX(fragmentCount, pTransceiver->frameFragmentsCapacity * 2);
+        CHK(NULL != (pNewFragments = (PRtcFrameFragment) MEMREALLOC(pTransceiver->pFrameFragments, newCapacity * SIZEOF(RtcFrameFragment))),
+            STATUS_NOT_ENOUGH_MEMORY);
+        pTransceiver->pFrameFragments = pNewFragments;
+        pTransceiver->frameFragmentsCapacity = newCapacity;
+    }
+
+    if (packetCount > pTransceiver->frameFragmentsBackupCapacity) {
+        newCapacity = MAX(packetCount, pTransceiver->frameFragmentsBackupCapacity * 2);
+        CHK(NULL != (pNewBackup = (PBYTE) MEMREALLOC(pTransceiver->pFrameFragmentsBackup, newCapacity * DEPAY_FRAGMENTS_REWRITE_SIZE)),
+            STATUS_NOT_ENOUGH_MEMORY);
+        pTransceiver->pFrameFragmentsBackup = pNewBackup;
+        pTransceiver->frameFragmentsBackupCapacity = newCapacity;
+    }
+
+    // A fill rewrites FU headers in place, the bytes it may touch are saved first in case the frame is not delivered
+    fragmentCount = 0;
+    for (index = startIndex; UINT16_DEC(index) != endIndex; index++) {
+        CHK_STATUS(jitterBufferGetPacket(pTransceiver->pJitterBuffer, index, &pPacket));
+        MEMCPY(pTransceiver->pFrameFragmentsBackup + filledPackets * DEPAY_FRAGMENTS_REWRITE_SIZE, pPacket->payload,
+               MIN(pPacket->payloadLength, DEPAY_FRAGMENTS_REWRITE_SIZE));
+        filledPackets++;
+
+        packetFragmentCount = pTransceiver->frameFragmentsCapacity - fragmentCount;
+        CHK_STATUS(pTransceiver->depayFragmentsFn(pPacket->payload, pPacket->payloadLength, pTransceiver->pFrameFragments + fragmentCount,
+                                                  &packetFragmentCount, &isStart));
+        fragmentCount += packetFragmentCount;
+        isStart = FALSE;
+    }
+
+    for (i = 0; i < fragmentCount; i++) {
+        filledSize += pTransceiver->pFrameFragments[i].size;
+    }
+    CHK(pFrame->size == filledSize, STATUS_INVALID_ARG_LEN);
+
+    pTransceiver->onFrameFragments(pTransceiver->onFrameFragmentsCustomData, pFrame, pTransceiver->pFrameFragments, fragmentCount);
+
+CleanUp:
+
+    // Put the rewritten headers back so the packets still depayload as received
+    if (STATUS_FAILED(retStatus)) {
+        for (i = 0, index = startIndex; i < filledPackets; i++, index++) {
+            if (STATUS_SUCCEEDED(jitterBufferGetPacket(pTransceiver->pJitterBuffer, index, &pPacket))) {
+                MEMCPY(pPacket->payload, pTransceiver->pFrameFragmentsBackup + i * DEPAY_FRAGMENTS_REWRITE_SIZE,
+                       MIN(pPacket->payloadLength, DEPAY_FRAGMENTS_REWRITE_SIZE));
+            }
+        }
+    }
+
+    return retStatus;
+}
+
 STATUS onFrameReadyFunc(UINT64 customData, UINT16 startIndex, UINT16 endIndex, UINT32 frameSize)
 {
     ENTERS();
@@ -608,6 +673,20 @@ STATUS onFrameReadyFunc(UINT64 customData, UINT16 startIndex, UINT16 endIndex, U
     }
     MUTEX_UNLOCK(pTransceiver->statsLock);
 
+    frame.version = FRAME_CURRENT_VERSION;
+    frame.decodingTs = KVS_CONVERT_TIMESCALE(pPacket->header.timestamp, pTransceiver->pJitterBuffer->clockRate, HUNDREDS_OF_NANOS_IN_A_SECOND);
+    frame.presentationTs = frame.decodingTs;
+    frame.frameData = NULL;
+    frame.size = frameSize;
+    frame.duration = 0;
+    frame.index = index;
+    // TODO: Fill frame flag and track id and index if we need to, currently those are not used by RtcRtpTransceiver
+
+    if (pTransceiver->onFrameFragments != NULL && pTransceiver->depayFragmentsFn != NULL) {
+        CHK_STATUS(deliverFrameFragments(pTransceiver, &frame, startIndex, endIndex));
+        CHK(FALSE, retStatus);
+    }
+
     if (frameSize > pTransceiver->peerFrameBufferSize) {
         MEMFREE(pTransceiver->peerFrameBuffer);
         pTransceiver->peerFrameBufferSize = (UINT32) (frameSize * PEER_FRAME_BUFFER_SIZE_INCREMENT_FACTOR);
@@ -618,14 +697,7 @@ STATUS onFrameReadyFunc(UINT64 customData, UINT16 startIndex, UINT16 endIndex, U
     CHK_STATUS(jitterBufferFillFrameData(pTransceiver->pJitterBuffer, pTransceiver->peerFrameBuffer, frameSize, &filledSize, startIndex, endIndex));
     CHK(frameSize == filledSize, STATUS_INVALID_ARG_LEN);
 
-    frame.version = FRAME_CURRENT_VERSION;
-    frame.decodingTs = KVS_CONVERT_TIMESCALE(pPacket->header.timestamp, pTransceiver->pJitterBuffer->clockRate, HUNDREDS_OF_NANOS_IN_A_SECOND);
-    frame.presentationTs = frame.decodingTs;
     frame.frameData = pTransceiver->peerFrameBuffer;
-    frame.size = frameSize;
-    frame.duration = 0;
-    frame.index = index;
-    // TODO: Fill frame flag and track id and index if we need to, currently those are not used by RtcRtpTransceiver
     if (pTransceiver->onFrame != NULL) {
         pTransceiver->onFrame(pTransceiver->onFrameCustomData, &frame);
     }
@@ -1049,9 +1121,9 @@ STATUS rtcpReportsCallback(UINT32 timerId, UINT64 currentTime, UINT64 customData
     delay = 100 + (RAND() % 200);
     DLOGS("next sender report %u in %" PRIu64 " msec", ssrc, delay);
     // reschedule timer with 200msec +- 100ms
-    CHK_STATUS(timerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, delay * HUNDREDS_OF_NANOS_IN_A_MILLISECOND,
-                                  TIMER_QUEUE_SINGLE_INVOCATION_PERIOD, rtcpReportsCallback, (UINT64) pKvsRtpTransceiver,
-                                  &pKvsRtpTransceiver->rtcpReportsTimerId));
+    CHK_STATUS(kvsTimerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, delay * HUNDREDS_OF_NANOS_IN_A_MILLISECOND,
+                                     TIMER_QUEUE_SINGLE_INVOCATION_PERIOD, rtcpReportsCallback, (UINT64) pKvsRtpTransceiver,
+                                     &pKvsRtpTransceiver->rtcpReportsTimerId));
 
 CleanUp:
     CHK_LOG_ERR(retStatus);
@@ -1258,6 +1330,7 @@ STATUS createPeerConnection(PRtcConfiguration pConfiguration, PRtcPeerConnection
     IceAgentCallbacks iceAgentCallbacks;
     DtlsSessionCallbacks dtlsSessionCallbacks;
     PConnectionListener pConnectionListener = NULL;
+    GccConfig gccConfig;
     UINT64 startTime = 0;
     UINT64 startTimeInMacro = 0;
 
@@ -1270,7 +1343,7 @@ STATUS createPeerConnection(PRtcConfiguration pConfiguration, PRtcPeerConnection
     pKvsPeerConnection = (PKvsPeerConnection) MEMCALLOC(1, SIZEOF(KvsPeerConnection));
     CHK(pKvsPeerConnection != NULL, STATUS_NOT_ENOUGH_MEMORY);
 
-    CHK_STATUS(timerQueueCreate(&pKvsPeerConnection->timerQueueHandle));
+    CHK_STATUS(kvsTimerQueueCreate(&pKvsPeerConnection->timerQueueHandle));
 
     pKvsPeerConnection->peerConnection.version = PEER_CONNECTION_CURRENT_VERSION;
 
@@ -1302,6 +1375,9 @@ STATUS createPeerConnection(PRtcConfiguration pConfiguration, PRtcPeerConnection
     pKvsPeerConnection->jitterBufferMaxLatency = pConfiguration->kvsRtcConfiguration.jitterBufferMaxLatency == 0
         ? DEFAULT_JITTER_BUFFER_MAX_LATENCY
         : pConfiguration->kvsRtcConfiguration.jitterBufferMaxLatency;
+    pKvsPeerConnection->sctpMaxMessageSize = pConfiguration->kvsRtcConfiguration.sctpMaxMessageSize == 0
+        ? DEFAULT_SCTP_MAX_MESSAGE_SIZE
+        : pConfiguration->kvsRtcConfiguration.sctpMaxMessageSize;
     pKvsPeerConnection->useRealTimeJitterBuffer = pConfiguration->kvsRtcConfiguration.useRealTimeJitterBuffer;
     pKvsPeerConnection->useRedForOpus = pConfiguration->kvsRtcConfiguration.useRedForOpus;
     pKvsPeerConnection->redForOpusRedundancy = pConfiguration->kvsRtcConfiguration.redForOpusRedundancy;
@@ -1319,7 +1395,16 @@ STATUS createPeerConnection(PRtcConfiguration pConfiguration, PRtcPeerConnection
     iceAgentCallbacks.newLocalCandidateFn = onNewIceLocalCandidate;
     iceAgentCallbacks.setStunServerIpFn = onSetStunServerIp;
 
-    PROFILE_CALL(CHK_STATUS(createConnectionListener(&pConnectionListener)), "Create connection listener");
+    // Several receive threads serve every peer connection of the process, a single one stays with its peer connection
+    if (pConfiguration->kvsRtcConfiguration.connectionListenerThreadCount > 1) {
+        PROFILE_CALL(CHK_STATUS(attachSharedConnectionListener(pConfiguration->kvsRtcConfiguration.connectionListenerThreadCount,
+                                                               pConfiguration->kvsRtcConfiguration.connectionListenerCpuAffinity, &pConnectionListener)),
+                     "Attach to shared connection listener");
+    } else {
+        PROFILE_CALL(CHK_STATUS(createConnectionListenerWithParams(1, pConfiguration->kvsRtcConfiguration.connectionListenerCpuAffinity,
+                                                                   &pConnectionListener)),
+                     "Create connection listener");
+    }
     // IceAgent will own the lifecycle of pConnectionListener;
     PROFILE_CALL(CHK_STATUS(createIceAgent(pKvsPeerConnection->localIceUfrag, pKvsPeerConnection->localIcePwd, &iceAgentCallbacks, pConfiguration,
                                            pKvsPeerConnection->timerQueueHandle, pConnectionListener, &pKvsPeerConnection->pIceAgent)),
@@ -1331,12 +1416,18 @@ STATUS createPeerConnection(PRtcConfiguration pConfiguration, PRtcPeerConnection
         pKvsPeerConnection->twccLock = MUTEX_CREATE(TRUE);
         pKvsPeerConnection->pTwccManager = (PTwccManager) MEMCALLOC(1, SIZEOF(TwccManager));
         CHK(pKvsPeerConnection->pTwccManager != NULL, STATUS_NOT_ENOUGH_MEMORY);
-        CHK_STATUS(hashTableCreateWithParams(TWCC_HASH_TABLE_BUCKET_COUNT, TWCC_HASH_TABLE_BUCKET_LENGTH,
-                                             &pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable));
+        pKvsPeerConnection->pTwccManager->lastExtSeqNum = TWCC_EXT_SEQ_NUM_BASE;
         // Set default TWCC extension ID so the offer SDP includes the extmap.
         // If the remote peer offers a different ID, it will be overwritten
         // during setRemoteDescription.
         pKvsPeerConnection->twccExtId = TWCC_DEFAULT_EXT_ID;
+
+        if (pConfiguration->kvsRtcConfiguration.enableGccBandwidthEstimation) {
+            MEMSET(&gccConfig, 0x00, SIZEOF(GccConfig));
+            gccConfig.minBitrateBps = pConfiguration->kvsRtcConfiguration.gccMinBitrateBps;
+            gccConfig.maxBitrateBps = pConfiguration->kvsRtcConfiguration.gccMaxBitrateBps;
+            CHK_STATUS(createGccController(&pKvsPeerConnection->pGccController, &gccConfig));
+        }
     }
 
     // TWCC feedback generation (receiver side)
@@ -1350,6 +1441,17 @@ STATUS createPeerConnection(PRtcConfiguration pConfiguration, PRtcPeerConnection
     pKvsPeerConnection->sctpTimerCallbackId = MAX_UINT32;
 #endif
 
+    CHK_STATUS(createPacketPool(RTP_PACKET_POOL_HEADER_SIZE + INBOUND_PACKET_POOL_MAX_PACKET_SIZE,
+                                pConfiguration->kvsRtcConfiguration.inboundPacketPoolSize == 0
+                                    ? DEFAULT_INBOUND_PACKET_POOL_SIZE
+                                    : MIN(pConfiguration->kvsRtcConfiguration.inboundPacketPoolSize, PACKET_POOL_MAX_BLOCK_COUNT),
+                                &pKvsPeerConnection->pInboundPacketPool));
+    CHK_STATUS(createPacketPool(OUTBOUND_PACKET_BUFFER_SIZE(pKvsPeerConnection->MTU),
+                                pConfiguration->kvsRtcConfiguration.outboundPacketPoolSize == 0
+                                    ? DEFAULT_OUTBOUND_PACKET_POOL_SIZE
+                                    : MIN(pConfiguration->kvsRtcConfiguration.outboundPacketPoolSize, PACKET_POOL_MAX_BLOCK_COUNT),
+                                &pKvsPeerConnection->pOutboundPacketPool));
+
     // PCAP dump
     if (pConfiguration->kvsRtcConfiguration.pcapFilePath[0] != '\0') {
         CHK_STATUS(pcapDumpCreate(pConfiguration->kvsRtcConfiguration.pcapFilePath, &pKvsPeerConnection->pPcapDump));
@@ -1422,19 +1524,19 @@ STATUS freePeerConnection(PRtcPeerConnection* ppPeerConnection)
             pKvsPeerConnection->twccFeedbackTimerId = MAX_UINT32;
             MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
             if (twccTimerId != MAX_UINT32) {
-                timerQueueCancelTimer(pKvsPeerConnection->timerQueueHandle, twccTimerId, (UINT64) pKvsPeerConnection);
+                kvsTimerQueueCancelTimer(pKvsPeerConnection->timerQueueHandle, twccTimerId, (UINT64) pKvsPeerConnection);
             }
         }
 #ifdef ENABLE_NATIVE_SCTP
         if (pKvsPeerConnection->sctpTimerCallbackId != MAX_UINT32) {
-            timerQueueCancelTimer(pKvsPeerConnection->timerQueueHandle, pKvsPeerConnection->sctpTimerCallbackId, (UINT64) pKvsPeerConnection);
+            kvsTimerQueueCancelTimer(pKvsPeerConnection->timerQueueHandle, pKvsPeerConnection->sctpTimerCallbackId, (UINT64) pKvsPeerConnection);
             pKvsPeerConnection->sctpTimerCallbackId = MAX_UINT32;
         }
 #endif
         if (pKvsPeerConnection->pPacer != NULL) {
             pacerStop(pKvsPeerConnection->pPacer);
         }
-        timerQueueShutdown(pKvsPeerConnection->timerQueueHandle);
+        kvsTimerQueueShutdown(pKvsPeerConnection->timerQueueHandle);
     }
 
     /* Free structs that have their own thread. SCTP has threads created by SCTP library. IceAgent has the
@@ -1494,7 +1596,7 @@ STATUS freePeerConnection(PRtcPeerConnection* ppPeerConnection)
     }
 
     if (IS_VALID_TIMER_QUEUE_HANDLE(pKvsPeerConnection->timerQueueHandle)) {
-        timerQueueFree(&pKvsPeerConnection->timerQueueHandle);
+        kvsTimerQueueFree(&pKvsPeerConnection->timerQueueHandle);
     }
 
     // Free pacer (after timer queue since pacer uses timers)
@@ -1502,18 +1604,17 @@ STATUS freePeerConnection(PRtcPeerConnection* ppPeerConnection)
         CHK_LOG_ERR(freePacer(&pKvsPeerConnection->pPacer));
     }
 
+    CHK_LOG_ERR(freeGccController(&pKvsPeerConnection->pGccController));
+
     if (pKvsPeerConnection->pTwccManager != NULL) {
         MUTEX_LOCK(pKvsPeerConnection->twccLock);
         twccLocked = TRUE;
 
-        CHK_LOG_ERR(hashTableIterateEntries(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable, 0, freeHashEntry));
-        CHK_LOG_ERR(hashTableFree(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable));
-
         SAFE_MEMFREE(pKvsPeerConnection->pTwccManager);
     }
 
     // Incase the `RemoteSessionDescription` has not already been freed.
-    SAFE_MEMFREE(pKvsPeerConnection->pRemoteSessionDescription);
+    freeSessionDescription(&pKvsPeerConnection->pRemoteSessionDescription);
 
     if (IS_VALID_MUTEX_VALUE(pKvsPeerConnection->twccLock)) {
         if (twccLocked) {
@@ -1544,6 +1645,11 @@ STATUS freePeerConnection(PRtcPeerConnection* ppPeerConnection)
         pcapDumpFree(&pKvsPeerConnection->pPcapDump);
     }
 
+    // Every inbound packet lived in a jitter buffer that was released with the transceivers above
+    CHK_LOG_ERR(freePacketPool(&pKvsPeerConnection->pInboundPacketPool));
+    // Outbound buffers are owned by writeFrame callers and the pacer, both gone by now
+    CHK_LOG_ERR(freePacketPool(&pKvsPeerConnection->pOutboundPacketPool));
+
     PROFILE_WITH_START_TIME_OBJ(startTime, pKvsPeerConnection->peerConnectionDiagnostics.freePeerConnectionTime, "Free peer connection");
     SAFE_MEMFREE(*ppPeerConnection);
 
@@ -1711,6 +1817,7 @@ STATUS peerConnectionEnablePacing(PRtcPeerConnection pRtcPeerConnection, PRtcPac
     // Create the pacer
     CHK_STATUS(createPacer(&pKvsPeerConnection->pPacer, pKvsPeerConnection->timerQueueHandle, &pacerConfig));
     pPacer = pKvsPeerConnection->pPacer;
+    CHK_STATUS(pacerSetPacketPool(pPacer, pKvsPeerConnection->pOutboundPacketPool));
 
     // Drop the peer connection lock before starting the pacer timer to avoid
     // lock-order-inversion: this path acquires peerConnectionObjLock then
@@ -1798,7 +1905,7 @@ STATUS peerConnectionGetLocalDescription(PRtcPeerConnection pRtcPeerConnection,
 
     CHK(pRtcPeerConnection != NULL && pRtcSessionDescriptionInit != NULL, STATUS_NULL_ARG);
 
-    CHK(NULL != (pSessionDescription = (PSessionDescription) MEMCALLOC(1, SIZEOF(SessionDescription))), STATUS_NOT_ENOUGH_MEMORY);
+    CHK_STATUS(createSessionDescription(&pSessionDescription));
 
     if (pKvsPeerConnection->isOffer) {
         pRtcSessionDescriptionInit->type = SDP_TYPE_OFFER;
@@ -1813,7 +1920,7 @@ STATUS peerConnectionGetLocalDescription(PRtcPeerConnection pRtcPeerConnection,
     CHK_STATUS(serializeSessionDescription(pSessionDescription, pRtcSessionDescriptionInit->sdp, &serializeLen));
 
 CleanUp:
-    SAFE_MEMFREE(pSessionDescription);
+    freeSessionDescription(&pSessionDescription);
     CHK_LOG_ERR(retStatus);
 
     LEAVES();
@@ -1832,8 +1939,7 @@ STATUS peerConnectionGetCurrentLocalDescription(PRtcPeerConnection pRtcPeerConne
     // do nothing if remote session description hasn't been received
     CHK(pKvsPeerConnection->pRemoteSessionDescription != NULL, STATUS_SUCCESS);
 
-    pSessionDescription = (PSessionDescription) MEMCALLOC(1, SIZEOF(SessionDescription));
-    CHK(pSessionDescription != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    CHK_STATUS(createSessionDescription(&pSessionDescription));
 
     CHK_STATUS(populateSessionDescription(pKvsPeerConnection, pKvsPeerConnection->pRemoteSessionDescription, pSessionDescription));
 
@@ -1845,7 +1951,7 @@ STATUS peerConnectionGetCurrentLocalDescription(PRtcPeerConnection pRtcPeerConne
 CleanUp:
     CHK_LOG_ERR(retStatus);
 
-    SAFE_MEMFREE(pSessionDescription);
+    freeSessionDescription(&pSessionDescription);
 
     LEAVES();
     return retStatus;
@@ -1887,9 +1993,10 @@ STATUS setRemoteDescription(PRtcPeerConnection pPeerConnection, PRtcSessionDescr
 
     // In master mode, this should be freed once `createAnswer` is invoked for the session.
     // In viewer mode, this should be freed once `setRemoteDescription` is completed for the session.
-    pKvsPeerConnection->pRemoteSessionDescription = (PSessionDescription) MEMCALLOC(1, SIZEOF(SessionDescription));
+    // A renegotiation that never got answered leaves the previous one behind.
+    CHK_STATUS(freeSessionDescription(&pKvsPeerConnection->pRemoteSessionDescription));
+    CHK_STATUS(createSessionDescription(&pKvsPeerConnection->pRemoteSessionDescription));
     pSessionDescription = pKvsPeerConnection->pRemoteSessionDescription;
-    CHK(pSessionDescription != NULL, STATUS_NOT_ENOUGH_MEMORY);
 
     pKvsPeerConnection->dtlsIsServer = FALSE;
     /* Assume cant trickle at first */
@@ -1926,6 +2033,16 @@ STATUS setRemoteDescription(PRtcPeerConnection pPeerConnection, PRtcSessionDescr
             if (!pKvsPeerConnection->isOffer && !ATOMIC_LOAD_BOOL(&pKvsPeerConnection->sctpIsEnabled)) {
                 ATOMIC_STORE_BOOL(&pKvsPeerConnection->sctpIsEnabled, TRUE);
             }
+
+            // RFC 8841: 0 or no attribute at all means the remote takes messages of any size
+            pKvsPeerConnection->remoteSctpMaxMessageSize = 0;
+            for (j = 0; j < pSessionDescription->mediaDescriptions[i].mediaAttributesCount; j++) {
+                if (STRCMP(pSessionDescription->mediaDescriptions[i].sdpAttributes[j].attributeName, "max-message-size") == 0 &&
+                    STATUS_FAILED(STRTOUI32(pSessionDescription->mediaDescriptions[i].sdpAttributes[j].attributeValue, NULL, 10,
+                                            &pKvsPeerConnection->remoteSctpMaxMessageSize))) {
+                    pKvsPeerConnection->remoteSctpMaxMessageSize = 0;
+                }
+            }
         }
 #endif
 
@@ -2018,8 +2135,8 @@ STATUS setRemoteDescription(PRtcPeerConnection pPeerConnection, PRtcSessionDescr
         MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
         if (startTimer) {
             UINT32 timerId = MAX_UINT32;
-            CHK_STATUS(timerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, TWCC_FEEDBACK_INITIAL_DELAY, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD,
-                                          twccFeedbackCallback, (UINT64) pKvsPeerConnection, &timerId));
+            CHK_STATUS(kvsTimerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, TWCC_FEEDBACK_INITIAL_DELAY, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD,
+                                             twccFeedbackCallback, (UINT64) pKvsPeerConnection, &timerId));
             MUTEX_LOCK(pKvsPeerConnection->twccLock);
             pKvsPeerConnection->twccFeedbackTimerId = timerId;
             MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
@@ -2029,7 +2146,7 @@ STATUS setRemoteDescription(PRtcPeerConnection pPeerConnection, PRtcSessionDescr
 
 CleanUp:
     if (pKvsPeerConnection != NULL && pKvsPeerConnection->isOffer) {
-        SAFE_MEMFREE(pKvsPeerConnection->pRemoteSessionDescription);
+        freeSessionDescription(&pKvsPeerConnection->pRemoteSessionDescription);
     }
     CHK_LOG_ERR(retStatus);
 
@@ -2048,9 +2165,7 @@ STATUS createOffer(PRtcPeerConnection pPeerConnection, PRtcSessionDescriptionIni
 
     CHK(pKvsPeerConnection != NULL && pSessionDescriptionInit != NULL, STATUS_NULL_ARG);
 
-    // SessionDescription is large enough structure to not define on the stack and use heap memory
-    pSessionDescription = (PSessionDescription) MEMCALLOC(1, SIZEOF(SessionDescription));
-    CHK(pSessionDescription != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    CHK_STATUS(createSessionDescription(&pSessionDescription));
 
     pSessionDescriptionInit->type = SDP_TYPE_OFFER;
     pKvsPeerConnection->isOffer = TRUE;
@@ -2072,7 +2187,7 @@ STATUS createOffer(PRtcPeerConnection pPeerConnection, PRtcSessionDescriptionIni
         DLOGD("LOCAL_SDP:%s", pSessionDescriptionInit->sdp);
     }
 CleanUp:
-    SAFE_MEMFREE(pSessionDescription);
+    freeSessionDescription(&pSessionDescription);
     CHK_LOG_ERR(retStatus);
 
     LEAVES();
@@ -2100,7 +2215,7 @@ STATUS createAnswer(PRtcPeerConnection pPeerConnection, PRtcSessionDescriptionIn
 
     // Once answer is created, remote SDP is not needed anymore. We also clear only if
     // answer SDP is successfully created
-    SAFE_MEMFREE(pKvsPeerConnection->pRemoteSessionDescription);
+    freeSessionDescription(&pKvsPeerConnection->pRemoteSessionDescription);
 CleanUp:
     CHK_LOG_ERR(retStatus);
 
@@ -2148,6 +2263,7 @@ STATUS addTransceiver(PRtcPeerConnection pPeerConnection, PRtcMediaStreamTrack p
     PKvsPeerConnection pKvsPeerConnection = (PKvsPeerConnection) pPeerConnection;
     PJitterBuffer pJitterBuffer = NULL;
     DepayRtpPayloadFunc depayFunc;
+    DepayRtpPayloadFragmentsFunc depayFragmentsFunc;
     UINT32 clockRate = 0;
     UINT32 ssrc = (UINT32) RAND(), rtxSsrc = (UINT32) RAND();
     RTC_RTP_TRANSCEIVER_DIRECTION direction = RTC_RTP_TRANSCEIVER_DIRECTION_SENDRECV;
@@ -2173,26 +2289,31 @@ STATUS addTransceiver(PRtcPeerConnection pPeerConnection, PRtcMediaStreamTrack p
     switch (pRtcMediaStreamTrack->codec) {
         case RTC_CODEC_OPUS:
             depayFunc = depayOpusFromRtpPayload;
+            depayFragmentsFunc = depayOpusFragmentsFromRtpPayload;
             clockRate = OPUS_CLOCKRATE;
             break;
 
         case RTC_CODEC_MULAW:
         case RTC_CODEC_ALAW:
             depayFunc = depayG711FromRtpPayload;
+            depayFragmentsFunc = depayG711FragmentsFromRtpPayload;
             clockRate = PCM_CLOCKRATE;
             break;
 
         case RTC_CODEC_H264_PROFILE_42E01F_LEVEL_ASYMMETRY_ALLOWED_PACKETIZATION_MODE:
             depayFunc = depayH264FromRtpPayload;
+            depayFragmentsFunc = depayH264FragmentsFromRtpPayload;
             clockRate = VIDEO_CLOCKRATE;
             break;
 
         case RTC_CODEC_VP8:
             depayFunc = depayVP8FromRtpPayload;
+            depayFragmentsFunc = depayVP8FragmentsFromRtpPayload;
             clockRate = VIDEO_CLOCKRATE;
             break;
         case RTC_CODEC_H265:
             depayFunc = depayH265FromRtpPayload;
+            depayFragmentsFunc = depayH265FragmentsFromRtpPayload;
             clockRate = VIDEO_CLOCKRATE;
             break;
 
@@ -2216,6 +2337,7 @@ STATUS addTransceiver(PRtcPeerConnection pPeerConnection, PRtcMediaStreamTrack p
                                       (UINT64) pKvsRtpTransceiver, alwaysSinglePacketFrames, &pJitterBuffer));
     }
     CHK_STATUS(kvsRtpTransceiverSetJitterBuffer(pKvsRtpTransceiver, pJitterBuffer));
+    pKvsRtpTransceiver->depayFragmentsFn = depayFragmentsFunc;
 
     // after pKvsRtpTransceiver is successfully created, jitterBuffer will be freed by pKvsRtpTransceiver.
     pJitterBuffer = NULL;
@@ -2223,8 +2345,8 @@ STATUS addTransceiver(PRtcPeerConnection pPeerConnection, PRtcMediaStreamTrack p
     CHK_STATUS(doubleListInsertItemHead(pKvsPeerConnection->pTransceivers, (UINT64) pKvsRtpTransceiver));
     *ppRtcRtpTransceiver = (PRtcRtpTransceiver) pKvsRtpTransceiver;
 
-    CHK_STATUS(timerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, RTCP_FIRST_REPORT_DELAY, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD,
-                                  rtcpReportsCallback, (UINT64) pKvsRtpTransceiver, &pKvsRtpTransceiver->rtcpReportsTimerId));
+    CHK_STATUS(kvsTimerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, RTCP_FIRST_REPORT_DELAY, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD,
+                                     rtcpReportsCallback, (UINT64) pKvsRtpTransceiver, &pKvsRtpTransceiver->rtcpReportsTimerId));
 
     pKvsRtpTransceiver = NULL;
 
@@ -2335,7 +2457,7 @@ STATUS closePeerConnection(PRtcPeerConnection pPeerConnection)
         pKvsPeerConnection->twccFeedbackTimerId = MAX_UINT32;
         MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
         if (twccTimerId != MAX_UINT32) {
-            timerQueueCancelTimer(pKvsPeerConnection->timerQueueHandle, twccTimerId, (UINT64) pKvsPeerConnection);
+            kvsTimerQueueCancelTimer(pKvsPeerConnection->timerQueueHandle, twccTimerId, (UINT64) pKvsPeerConnection);
         }
     }
 
@@ -2392,6 +2514,9 @@ STATUS initKvsWebRtc(VOID)
 #ifdef ENABLE_DATA_CHANNEL
     CHK_STATUS(initSctpSession());
 #endif
+    CHK_STATUS(createSharedTimerWheel());
+    CHK_STATUS(createCertificatePoolLock());
+    CHK_STATUS(createSharedConnectionListenerLock());
 #ifdef ENABLE_KVS_THREADPOOL
     DLOGI("KVS WebRtc library using thread pool");
     CHK_STATUS(createWebRtcClientInstance());
@@ -2465,6 +2590,11 @@ STATUS deinitKvsWebRtc(VOID)
 
     srtp_shutdown();
 
+    freeSharedTimerWheel();
+    deinitRtcCertificatePool();
+    freeCertificatePoolLock();
+    freeSharedConnectionListenerLock();
+
 #ifdef ENABLE_KVS_THREADPOOL
     cleanupWebRtcClientInstance();
     destroyThreadPoolContext();
@@ -2487,46 +2617,33 @@ static STATUS twccRollingWindowDeletion(PKvsPeerConnection pKvsPeerConnection, P
     UINT16 updatedSeqNum = 0;
     PTwccRtpPacketInfo tempTwccRtpPktInfo = NULL;
     UINT64 ageOfOldest = 0, firstRtpTime = 0;
-    UINT64 twccPacketValue = 0;
     BOOL isCheckComplete = FALSE;
 
     CHK(pKvsPeerConnection != NULL && pRtpPacket != NULL && pKvsPeerConnection->pTwccManager != NULL, STATUS_NULL_ARG);
 
     updatedSeqNum = pKvsPeerConnection->pTwccManager->firstSeqNumInRollingWindow;
     do {
-        // If the seqNum is not present in the hash table, it is ok. We move on to the next
-        if (STATUS_SUCCEEDED(hashTableGet(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable, updatedSeqNum, &twccPacketValue))) {
-            tempTwccRtpPktInfo = (PTwccRtpPacketInfo) twccPacketValue;
-            if (tempTwccRtpPktInfo != NULL) {
-                firstRtpTime = tempTwccRtpPktInfo->localTimeKvs;
-                // Would be the case if the timestamps are not monotonically increasing.
-                if (pRtpPacket->sentTime >= firstRtpTime) {
-                    ageOfOldest = pRtpPacket->sentTime - firstRtpTime;
-                    if (ageOfOldest > TWCC_ESTIMATOR_TIME_WINDOW) {
-                        // If the seqNum is not present in the hash table, move on. However, this case should not happen
-                        // given this function is holding the lock and tempTwccRtpPktInfo is populated because it exists
-                        if (STATUS_SUCCEEDED(hashTableRemove(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable, updatedSeqNum))) {
-                            SAFE_MEMFREE(tempTwccRtpPktInfo);
-                        }
-                        updatedSeqNum++;
-                    } else {
-                        isCheckComplete = TRUE;
-                    }
-                } else {
-                    // Move to the next seqNum to check if we can remove the next one atleast
-                    DLOGV("Non-monotonic timestamp detected for RTP packet seqNum %d [ts: %" PRIu64 ". Current RTP packets' ts: %" PRIu64,
-                          updatedSeqNum, firstRtpTime, pRtpPacket->sentTime);
+        // If the seqNum is not present in the ring, it is ok. We move on to the next
+        if ((tempTwccRtpPktInfo = twccManagerGetPacketInfo(pKvsPeerConnection->pTwccManager, updatedSeqNum)) != NULL) {
+            firstRtpTime = tempTwccRtpPktInfo->localTimeKvs;
+            // Would be the case if the timestamps are not monotonically increasing.
+            if (pRtpPacket->sentTime >= firstRtpTime) {
+                ageOfOldest = pRtpPacket->sentTime - firstRtpTime;
+                if (ageOfOldest > TWCC_ESTIMATOR_TIME_WINDOW) {
+                    twccManagerRemovePacketInfo(pKvsPeerConnection->pTwccManager, tempTwccRtpPktInfo);
                     updatedSeqNum++;
+                } else {
+                    isCheckComplete = TRUE;
                 }
             } else {
-                CHK_STATUS(hashTableRemove(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable, updatedSeqNum));
+                // Move to the next seqNum to check if we can remove the next one atleast
+                DLOGV("Non-monotonic timestamp detected for RTP packet seqNum %d [ts: %" PRIu64 ". Current RTP packets' ts: %" PRIu64,
+                      updatedSeqNum, firstRtpTime, pRtpPacket->sentTime);
                 updatedSeqNum++;
             }
         } else {
             updatedSeqNum++;
         }
-        // reset before next iteration
-        tempTwccRtpPktInfo = NULL;
     } while (!isCheckComplete && updatedSeqNum != (UINT16) (endingSeqNum + 1));
 
     // Update regardless. The loop checks until current RTP packets seq number irrespective of the failure
@@ -2547,19 +2664,17 @@ STATUS twccManagerOnPacketSent(PKvsPeerConnection pKvsPeerConnection, PRtpPacket
     PTwccRtpPacketInfo pTwccRtpPktInfo = NULL;
 
     CHK(pKvsPeerConnection != NULL && pRtpPacket != NULL, STATUS_NULL_ARG);
-    CHK(pKvsPeerConnection->onSenderBandwidthEstimation != NULL && pKvsPeerConnection->pTwccManager != NULL, STATUS_SUCCESS);
+    CHK(TWCC_FEEDBACK_HAS_CONSUMER(pKvsPeerConnection) && pKvsPeerConnection->pTwccManager != NULL, STATUS_SUCCESS);
     CHK(TWCC_EXT_PROFILE == pRtpPacket->header.extensionProfile, STATUS_SUCCESS);
 
     MUTEX_LOCK(pKvsPeerConnection->twccLock);
     locked = TRUE;
 
-    CHK((pTwccRtpPktInfo = MEMCALLOC(1, SIZEOF(TwccRtpPacketInfo))) != NULL, STATUS_NOT_ENOUGH_MEMORY);
-
+    seqNum = TWCC_SEQNUM(pRtpPacket->header.extensionPayload);
+    pTwccRtpPktInfo = twccManagerAddPacketInfo(pKvsPeerConnection->pTwccManager, seqNum);
     pTwccRtpPktInfo->packetSize = pRtpPacket->payloadLength;
     pTwccRtpPktInfo->localTimeKvs = pRtpPacket->sentTime;
     pTwccRtpPktInfo->remoteTimeKvs = TWCC_PACKET_LOST_TIME;
-    seqNum = TWCC_SEQNUM(pRtpPacket->header.extensionPayload);
-    CHK_STATUS(hashTableUpsert(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable, seqNum, (UINT64) pTwccRtpPktInfo));
 
     // Ensure twccRollingWindowDeletion is run in a guarded section
     CHK_STATUS(twccRollingWindowDeletion(pKvsPeerConnection, pRtpPacket, seqNum));
@@ -2581,22 +2696,18 @@ STATUS twccManagerOnPacedPacketSent(PKvsPeerConnection pKvsPeerConnection, UINT1
     PTwccRtpPacketInfo pTwccRtpPktInfo = NULL;
 
     CHK(pKvsPeerConnection != NULL, STATUS_NULL_ARG);
-    CHK((pKvsPeerConnection->onSenderBandwidthEstimation != NULL || pKvsPeerConnection->onTwccPacketReport != NULL) &&
-            pKvsPeerConnection->pTwccManager != NULL,
-        STATUS_SUCCESS);
+    CHK(TWCC_FEEDBACK_HAS_CONSUMER(pKvsPeerConnection) && pKvsPeerConnection->pTwccManager != NULL, STATUS_SUCCESS);
 
     MUTEX_LOCK(pKvsPeerConnection->twccLock);
     locked = TRUE;
 
-    CHK((pTwccRtpPktInfo = MEMCALLOC(1, SIZEOF(TwccRtpPacketInfo))) != NULL, STATUS_NOT_ENOUGH_MEMORY);
-
+    pTwccRtpPktInfo = twccManagerAddPacketInfo(pKvsPeerConnection->pTwccManager, twccSeqNum);
     pTwccRtpPktInfo->packetSize = packetSize;
     pTwccRtpPktInfo->localTimeKvs = sentTimeKvs;
     pTwccRtpPktInfo->remoteTimeKvs = TWCC_PACKET_LOST_TIME;
-    CHK_STATUS(hashTableUpsert(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable, twccSeqNum, (UINT64) pTwccRtpPktInfo));
 
     // Note: We skip twccRollingWindowDeletion here since we don't have the full RtpPacket
-    // The rolling window will be cleaned up during normal TWCC feedback processing
+    // Packets older than the ring are overwritten as newer seqNums take over their slots
 
 CleanUp:
     if (locked) {
@@ -2614,6 +2725,7 @@ STATUS peerConnectionGetMetrics(PRtcPeerConnection pPeerConnection, PPeerConnect
     STATUS retStatus = STATUS_SUCCESS;
     PKvsPeerConnection pKvsPeerConnection = (PKvsPeerConnection) pPeerConnection;
     PWebRtcClientContext pWebRtcClientContext = getWebRtcClientInstance();
+    PacketPoolStats poolStats;
 
     CHK(pKvsPeerConnection != NULL && pPeerConnectionMetrics != NULL, STATUS_NULL_ARG);
     if (pPeerConnectionMetrics->version > PEER_CONNECTION_METRICS_CURRENT_VERSION) {
@@ -2636,6 +2748,16 @@ STATUS peerConnectionGetMetrics(PRtcPeerConnection pPeerConnection, PPeerConnect
     // Cannot record these 2 in here because peer connection object would become NULL after clearing. Need another strategy
     pPeerConnectionMetrics->peerConnectionStats.closePeerConnectionTime = pKvsPeerConnection->peerConnectionDiagnostics.closePeerConnectionTime;
     pPeerConnectionMetrics->peerConnectionStats.freePeerConnectionTime = pKvsPeerConnection->peerConnectionDiagnostics.freePeerConnectionTime;
+    if (pKvsPeerConnection->pInboundPacketPool != NULL) {
+        CHK_STATUS(packetPoolGetStats(pKvsPeerConnection->pInboundPacketPool, &poolStats));
+        pPeerConnectionMetrics->peerConnectionStats.inboundPacketPoolHits = poolStats.hits;
+        pPeerConnectionMetrics->peerConnectionStats.inboundPacketPoolMisses = poolStats.misses;
+    }
+    if (pKvsPeerConnection->pOutboundPacketPool != NULL) {
+        CHK_STATUS(packetPoolGetStats(pKvsPeerConnection->pOutboundPacketPool, &poolStats));
+        pPeerConnectionMetrics->peerConnectionStats.outboundPacketPoolHits = poolStats.hits;
+        pPeerConnectionMetrics->peerConnectionStats.outboundPacketPoolMisses = poolStats.misses;
+    }
 CleanUp:
     releaseHoldOnInstance(pWebRtcClientContext);
     CHK_LOG_ERR(retStatus);
@@ -31,9 +31,14 @@ extern "C" {
 #define CODEC_HASH_TABLE_BUCKET_LENGTH 2
 #define RTX_HASH_TABLE_BUCKET_COUNT    50
 #define RTX_HASH_TABLE_BUCKET_LENGTH   2
-#define TWCC_HASH_TABLE_BUCKET_COUNT   100
-#define TWCC_HASH_TABLE_BUCKET_LENGTH  2
-#define TWCC_DEFAULT_EXT_ID            5 // Default RTP header extension ID for transport-wide-cc
+#define TWCC_PACKET_RING_SIZE          16384 // Sent packets kept for TWCC, covers the 1s estimator window up to 16k packets/s
+#define TWCC_RECEIVER_RING_SIZE        8192  // Received packets kept for TWCC feedback, must be a power of two
+#define TWCC_DEFAULT_EXT_ID            5     // Default RTP header extension ID for transport-wide-cc
+
+// Whether anything consumes TWCC feedback, otherwise sent packets are not tracked
+#define TWCC_FEEDBACK_HAS_CONSUMER(pKvsPeerConnection)                                                                                               \
+    ((pKvsPeerConnection)->onSenderBandwidthEstimation != NULL || (pKvsPeerConnection)->onTwccPacketReport != NULL ||                                \
+     (pKvsPeerConnection)->pGccController != NULL)
 
 #define DATA_CHANNEL_HASH_TABLE_BUCKET_COUNT  200
 #define DATA_CHANNEL_HASH_TABLE_BUCKET_LENGTH 2
@@ -60,28 +65,40 @@ typedef struct {
     UINT64 localTimeKvs;
     UINT64 remoteTimeKvs;
     UINT32 packetSize;
+    UINT32 extSeqNum; // Unwrapped seqNum owning this slot, TWCC_EXT_SEQ_NUM_FREE when empty
 } TwccRtpPacketInfo, *PTwccRtpPacketInfo;
 
 typedef struct {
-    PHashTable pTwccRtpPktInfosHashTable; // Hash table of [seqNum, PTwccPacket]
-    UINT16 firstSeqNumInRollingWindow;    // To monitor the last deleted packet in the rolling window
-    UINT16 lastReportedSeqNum;            // To monitor the last packet's seqNum in the TWCC response
-    UINT16 prevReportedBaseSeqNum;        // To monitor the base seqNum in the TWCC response
+    UINT16 firstSeqNumInRollingWindow; // To monitor the last deleted packet in the rolling window
+    UINT16 lastReportedSeqNum;         // To monitor the last packet's seqNum in the TWCC response
+    UINT16 prevReportedBaseSeqNum;     // To monitor the base seqNum in the TWCC response
+    UINT32 lastExtSeqNum;              // Highest unwrapped seqNum sent so far
+    UINT32 packetInfoCount;            // Number of occupied slots in packetInfos
+    // Sent packets indexed by unwrapped seqNum modulo the ring size
+    TwccRtpPacketInfo packetInfos[TWCC_PACKET_RING_SIZE];
 } TwccManager, *PTwccManager;
 
 // Receiver-side TWCC tracking for feedback generation
 typedef struct {
     UINT64 arrivalTimeKvs; // Local arrival time in 100ns units
+    UINT32 extSeqNum;      // Unwrapped seqNum owning this slot, TWCC_EXT_SEQ_NUM_FREE when empty
 } TwccReceivedPacketInfo, *PTwccReceivedPacketInfo;
 
 typedef struct {
-    PHashTable pReceivedPktsHashTable; // Hash table of [seqNum -> PTwccReceivedPacketInfo]
-    UINT16 firstSeqNum;                // First seq in current feedback window
-    UINT16 lastSeqNum;                 // Last seq received
-    BOOL firstPacketReceived;          // Any packet received yet?
-    UINT8 feedbackPacketCount;         // Counter for fb pkt. count field
-    UINT32 mediaSourceSsrc;            // SSRC we're providing feedback for
-    UINT64 baseTimeKvs;                // Base time for relative arrival timestamps
+    UINT16 firstSeqNum;          // First seq in current feedback window
+    UINT16 lastSeqNum;           // Last seq received
+    BOOL firstPacketReceived;    // Any packet received yet?
+    UINT8 feedbackPacketCount;   // Counter for fb pkt. count field
+    UINT32 mediaSourceSsrc;      // SSRC we're providing feedback for
+    UINT64 baseTimeKvs;          // Base time for relative arrival timestamps
+    UINT32 lastExtSeqNum;        // Highest unwrapped seqNum received so far
+    UINT32 receivedPacketCount;  // Number of occupied slots in receivedPackets
+    PBYTE pFeedbackPacket;       // Feedback packet buffer of TWCC_FEEDBACK_MAX_PACKET_SIZE bytes
+    // Received packets indexed by unwrapped seqNum modulo the ring size
+    TwccReceivedPacketInfo receivedPackets[TWCC_RECEIVER_RING_SIZE];
+    // Status symbol and receive delta of every packet of the feedback being built
+    UINT8 feedbackStatuses[TWCC_RECEIVER_RING_SIZE];
+    INT16 feedbackDeltas[TWCC_RECEIVER_RING_SIZE];
 } TwccReceiverManager, *PTwccReceiverManager;
 
 typedef struct {
@@ -190,6 +207,8 @@ typedef struct {
     UINT64 onSenderBandwidthEstimationCustomData;
     RtcOnTwccPacketReport onTwccPacketReport;
     UINT64 onTwccPacketReportCustomData;
+    PGccController pGccController; // Built-in estimator, NULL unless enableGccBandwidthEstimation is set
+    UINT64 gccReportedBitrate;     // Last GCC target passed to the transceivers, guarded by twccLock
 
     // TWCC feedback generation (receiver side)
     MUTEX twccReceiverLock;
@@ -211,7 +230,13 @@ typedef struct {
     BOOL useRedForOpus;            //!< Enable RFC 2198 RED for Opus (from KvsRtcConfiguration)
     UINT8 redForOpusRedundancy;    //!< Redundancy level (1..9), from KvsRtcConfiguration
 
+    UINT32 sctpMaxMessageSize;       //!< Largest incoming data channel message, from KvsRtcConfiguration
+    UINT32 remoteSctpMaxMessageSize; //!< a=max-message-size of the remote, 0 when unlimited or not advertised
+
     PPcapDumpContext pPcapDump; //!< PCAP dump context, NULL when disabled
+
+    PPacketPool pInboundPacketPool;  //!< Decrypted inbound RTP packets, owned by the jitter buffers once pushed
+    PPacketPool pOutboundPacketPool; //!< Send path packet buffers shared by writeFrame, the pacer and retransmissions
 } KvsPeerConnection, *PKvsPeerConnection;
 
 typedef struct {
@@ -40,6 +40,26 @@ CleanUp:
     return retStatus;
 }
 
+// The rolling buffer keeps its packet, so a paced resend queues a copy. Going through the pacer keeps a burst of NACKs
+// after a loss within the target bitrate instead of causing more loss.
+static STATUS resendEncryptedPacket(PKvsPeerConnection pKvsPeerConnection, PBYTE pRawPacket, UINT32 rawLen)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PBYTE pCopy = NULL;
+
+    if (pKvsPeerConnection->pPacer == NULL || !pacerIsEnabled(pKvsPeerConnection->pPacer)) {
+        return iceAgentSendPacket(pKvsPeerConnection->pIceAgent, pRawPacket, rawLen);
+    }
+
+    CHK(NULL != (pCopy = packetPoolAlloc(pKvsPeerConnection->pOutboundPacketPool, rawLen)), STATUS_NOT_ENOUGH_MEMORY);
+    MEMCPY(pCopy, pRawPacket, rawLen);
+    CHK_STATUS(pacerEnqueuePacket(pKvsPeerConnection->pPacer, PACER_PRIORITY_RETRANSMISSION, pCopy, rawLen, 0));
+
+CleanUp:
+
+    return retStatus;
+}
+
 STATUS resendPacketOnNack(PRtcpPacket pRtcpPacket, PKvsPeerConnection pKvsPeerConnection)
 {
     ENTERS();
@@ -85,13 +105,13 @@ STATUS resendPacketOnNack(PRtcpPacket pRtcpPacket, PKvsPeerConnection pKvsPeerCo
 
         if (pRtpPacket != NULL) {
             if (pSenderTranceiver->sender.payloadType == pSenderTranceiver->sender.rtxPayloadType) {
-                retStatus = iceAgentSendPacket(pKvsPeerConnection->pIceAgent, pRtpPacket->pRawPacket, pRtpPacket->rawPacketLength);
+                retStatus = resendEncryptedPacket(pKvsPeerConnection, pRtpPacket->pRawPacket, pRtpPacket->rawPacketLength);
             } else {
                 CHK_STATUS(constructRetransmitRtpPacketFromBytes(
                     pRtpPacket->pRawPacket, pRtpPacket->rawPacketLength, pSenderTranceiver->sender.rtxSequenceNumber,
                     pSenderTranceiver->sender.rtxPayloadType, pSenderTranceiver->sender.rtxSsrc, &pRtxRtpPacket));
                 pSenderTranceiver->sender.rtxSequenceNumber++;
-                retStatus = writeRtpPacket(pKvsPeerConnection, pRtxRtpPacket);
+                retStatus = writeRtpPacket(pKvsPeerConnection, pRtxRtpPacket, PACER_PRIORITY_RETRANSMISSION);
             }
             // resendPacket
             if (STATUS_SUCCEEDED(retStatus)) {
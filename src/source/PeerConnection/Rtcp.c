@@ -551,6 +551,62 @@ CleanUp:
     return retStatus;
 }
 
+// Unwraps a 16-bit transport-wide seqNum against the highest unwrapped seqNum seen so far. SeqNums within half a cycle
+// behind or ahead of it map into the same or the neighbouring cycle.
+static UINT32 twccUnwrapSeqNum(UINT32 lastExtSeqNum, UINT16 seqNum)
+{
+    return lastExtSeqNum + (UINT32) (INT32) (INT16) (seqNum - (UINT16) lastExtSeqNum);
+}
+
+PTwccRtpPacketInfo twccManagerGetPacketInfo(PTwccManager pTwccManager, UINT16 seqNum)
+{
+    UINT32 extSeqNum;
+    PTwccRtpPacketInfo pTwccRtpPacketInfo;
+
+    if (pTwccManager == NULL) {
+        return NULL;
+    }
+
+    extSeqNum = twccUnwrapSeqNum(pTwccManager->lastExtSeqNum, seqNum);
+    pTwccRtpPacketInfo = &pTwccManager->packetInfos[extSeqNum & (TWCC_PACKET_RING_SIZE - 1)];
+
+    return pTwccRtpPacketInfo->extSeqNum == extSeqNum ? pTwccRtpPacketInfo : NULL;
+}
+
+PTwccRtpPacketInfo twccManagerAddPacketInfo(PTwccManager pTwccManager, UINT16 seqNum)
+{
+    UINT32 extSeqNum;
+    PTwccRtpPacketInfo pTwccRtpPacketInfo;
+
+    if (pTwccManager == NULL) {
+        return NULL;
+    }
+
+    extSeqNum = twccUnwrapSeqNum(pTwccManager->lastExtSeqNum, seqNum);
+    if ((INT32) (extSeqNum - pTwccManager->lastExtSeqNum) > 0) {
+        pTwccManager->lastExtSeqNum = extSeqNum;
+    }
+
+    // A slot still holding a packet from a full ring ago is simply taken over
+    pTwccRtpPacketInfo = &pTwccManager->packetInfos[extSeqNum & (TWCC_PACKET_RING_SIZE - 1)];
+    if (pTwccRtpPacketInfo->extSeqNum == TWCC_EXT_SEQ_NUM_FREE) {
+        pTwccManager->packetInfoCount++;
+    }
+
+    MEMSET(pTwccRtpPacketInfo, 0x00, SIZEOF(TwccRtpPacketInfo));
+    pTwccRtpPacketInfo->extSeqNum = extSeqNum;
+
+    return pTwccRtpPacketInfo;
+}
+
+VOID twccManagerRemovePacketInfo(PTwccManager pTwccManager, PTwccRtpPacketInfo pTwccRtpPacketInfo)
+{
+    if (pTwccManager != NULL && pTwccRtpPacketInfo != NULL && pTwccRtpPacketInfo->extSeqNum != TWCC_EXT_SEQ_NUM_FREE) {
+        pTwccRtpPacketInfo->extSeqNum = TWCC_EXT_SEQ_NUM_FREE;
+        pTwccManager->packetInfoCount--;
+    }
+}
+
 STATUS parseRtcpTwccPacket(PRtcpPacket pRtcpPacket, PTwccManager pTwccManager)
 {
     /*
@@ -591,7 +647,6 @@ STATUS parseRtcpTwccPacket(PRtcpPacket pRtcpPacket, PTwccManager pTwccManager)
     UINT32 i;
     UINT64 referenceTime;
     PTwccRtpPacketInfo pTwccPacket = NULL;
-    UINT64 twccPktValue = 0;
     CHK(pTwccManager != NULL && pRtcpPacket != NULL, STATUS_NULL_ARG);
 
     baseSeqNum = getUnalignedInt16BigEndian(pRtcpPacket->payload + 8);
@@ -634,12 +689,8 @@ STATUS parseRtcpTwccPacket(PRtcpPacket pRtcpPacket, PTwccManager pTwccManager)
                     case TWCC_STATUS_SYMBOL_NOTRECEIVED:
                         DLOGS("runLength packetSeqNum %u not received %lu", packetSeqNum, referenceTime);
                         // If it does not exist it means the packet was already visited
-                        if (STATUS_SUCCEEDED(hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, &twccPktValue))) {
-                            pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-                            if (pTwccPacket != NULL) {
-                                pTwccPacket->remoteTimeKvs = TWCC_PACKET_LOST_TIME;
-                                CHK_STATUS(hashTableUpsert(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, (UINT64) pTwccPacket));
-                            }
+                        if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, packetSeqNum)) != NULL) {
+                            pTwccPacket->remoteTimeKvs = TWCC_PACKET_LOST_TIME;
                         }
                         pTwccManager->lastReportedSeqNum = packetSeqNum;
                         break;
@@ -651,12 +702,8 @@ STATUS parseRtcpTwccPacket(PRtcpPacket pRtcpPacket, PTwccManager pTwccManager)
                     DLOGS("runLength packetSeqNum %u received %lu", packetSeqNum, referenceTime);
 
                     // If it does not exist it means the packet was already visited
-                    if (STATUS_SUCCEEDED(hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, &twccPktValue))) {
-                        pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-                        if (pTwccPacket != NULL) {
-                            pTwccPacket->remoteTimeKvs = referenceTime;
-                            CHK_STATUS(hashTableUpsert(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, (UINT64) pTwccPacket));
-                        }
+                    if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, packetSeqNum)) != NULL) {
+                        pTwccPacket->remoteTimeKvs = referenceTime;
                     }
                     pTwccManager->lastReportedSeqNum = packetSeqNum;
                 }
@@ -683,12 +730,8 @@ STATUS parseRtcpTwccPacket(PRtcpPacket pRtcpPacket, PTwccManager pTwccManager)
                     case TWCC_STATUS_SYMBOL_NOTRECEIVED:
                         DLOGS("statusVector packetSeqNum %u not received %lu", packetSeqNum, referenceTime);
                         // If it does not exist it means the packet was already visited
-                        if (STATUS_SUCCEEDED(hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, &twccPktValue))) {
-                            pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-                            if (pTwccPacket != NULL) {
-                                pTwccPacket->remoteTimeKvs = TWCC_PACKET_LOST_TIME;
-                                CHK_STATUS(hashTableUpsert(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, (UINT64) pTwccPacket));
-                            }
+                        if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, packetSeqNum)) != NULL) {
+                            pTwccPacket->remoteTimeKvs = TWCC_PACKET_LOST_TIME;
                         }
                         pTwccManager->lastReportedSeqNum = packetSeqNum;
                         break;
@@ -699,12 +742,8 @@ STATUS parseRtcpTwccPacket(PRtcpPacket pRtcpPacket, PTwccManager pTwccManager)
                     referenceTime += KVS_CONVERT_TIMESCALE(recvDelta, TWCC_TICKS_PER_SECOND, HUNDREDS_OF_NANOS_IN_A_SECOND);
                     DLOGS("statusVector packetSeqNum %u received %lu", packetSeqNum, referenceTime);
                     // If it does not exist it means the packet was already visited
-                    if (STATUS_SUCCEEDED(hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, &twccPktValue))) {
-                        pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-                        if (pTwccPacket != NULL) {
-                            pTwccPacket->remoteTimeKvs = referenceTime;
-                            CHK_STATUS(hashTableUpsert(pTwccManager->pTwccRtpPktInfosHashTable, packetSeqNum, (UINT64) pTwccPacket));
-                        }
+                    if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, packetSeqNum)) != NULL) {
+                        pTwccPacket->remoteTimeKvs = referenceTime;
                     }
                     pTwccManager->lastReportedSeqNum = packetSeqNum;
                 }
@@ -722,14 +761,13 @@ CleanUp:
     return retStatus;
 }
 
-STATUS updateTwccHashTable(PTwccManager pTwccManager, PINT64 duration, PUINT64 receivedBytes, PUINT64 receivedPackets, PUINT64 sentBytes,
-                           PUINT64 sentPackets)
+STATUS updateTwccPacketInfos(PTwccManager pTwccManager, PINT64 duration, PUINT64 receivedBytes, PUINT64 receivedPackets, PUINT64 sentBytes,
+                             PUINT64 sentPackets)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    UINT64 localStartTimeKvs, localEndTimeKvs = 0;
+    UINT64 localStartTimeKvs = TWCC_PACKET_UNITIALIZED_TIME, localEndTimeKvs = 0;
     UINT16 baseSeqNum = 0;
     BOOL localStartTimeRecorded = FALSE;
-    UINT64 twccPktValue = 0;
     PTwccRtpPacketInfo pTwccPacket = NULL;
     UINT16 seqNum = 0;
 
@@ -751,48 +789,33 @@ STATUS updateTwccHashTable(PTwccManager pTwccManager, PINT64 duration, PUINT64 r
     // from memory
     for (seqNum = baseSeqNum; seqNum != (UINT16) (pTwccManager->lastReportedSeqNum + 1); seqNum++) {
         if (!localStartTimeRecorded) {
-            // This could happen if the prev packet was deleted as part of rolling window or if there
+            // The previous packet could be missing if it was deleted as part of rolling window or if there
             // is an overlap of RTP packet statuses between TWCC packets. This could also fail if it is
             // the first ever packet (seqNum 0)
-            if (hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, seqNum - 1, &twccPktValue) == STATUS_HASH_KEY_NOT_PRESENT) {
-                localStartTimeKvs = TWCC_PACKET_UNITIALIZED_TIME;
-            } else {
-                pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-                if (pTwccPacket != NULL) {
-                    localStartTimeKvs = pTwccPacket->localTimeKvs;
-                    localStartTimeRecorded = TRUE;
-                }
+            if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, seqNum - 1)) != NULL) {
+                localStartTimeKvs = pTwccPacket->localTimeKvs;
+                localStartTimeRecorded = TRUE;
             }
             if (localStartTimeKvs == TWCC_PACKET_UNITIALIZED_TIME) {
                 // time not yet set. If prev seqNum was deleted
-                if (STATUS_SUCCEEDED(hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, seqNum, &twccPktValue))) {
-                    pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-                    if (pTwccPacket != NULL) {
-                        localStartTimeKvs = pTwccPacket->localTimeKvs;
-                        localStartTimeRecorded = TRUE;
-                    }
+                if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, seqNum)) != NULL) {
+                    localStartTimeKvs = pTwccPacket->localTimeKvs;
+                    localStartTimeRecorded = TRUE;
                 }
             }
         }
 
         // The time it would not succeed is if there is an overlap in the RTP packet status between the TWCC
         // packets
-        if (STATUS_SUCCEEDED(hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, seqNum, &twccPktValue))) {
-            pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-            if (pTwccPacket != NULL) {
-                localEndTimeKvs = pTwccPacket->localTimeKvs;
-                *duration = localEndTimeKvs - localStartTimeKvs;
-                *sentBytes += pTwccPacket->packetSize;
-                (*sentPackets)++;
-                if (pTwccPacket->remoteTimeKvs != TWCC_PACKET_LOST_TIME) {
-                    *receivedBytes += pTwccPacket->packetSize;
-                    (*receivedPackets)++;
-                    if (STATUS_SUCCEEDED(hashTableRemove(pTwccManager->pTwccRtpPktInfosHashTable, seqNum))) {
-                        SAFE_MEMFREE(pTwccPacket);
-                    }
-                }
-            } else {
-                CHK_STATUS(hashTableRemove(pTwccManager->pTwccRtpPktInfosHashTable, seqNum));
+        if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, seqNum)) != NULL) {
+            localEndTimeKvs = pTwccPacket->localTimeKvs;
+            *duration = localEndTimeKvs - localStartTimeKvs;
+            *sentBytes += pTwccPacket->packetSize;
+            (*sentPackets)++;
+            if (pTwccPacket->remoteTimeKvs != TWCC_PACKET_LOST_TIME) {
+                *receivedBytes += pTwccPacket->packetSize;
+                (*receivedPackets)++;
+                twccManagerRemovePacketInfo(pTwccManager, pTwccPacket);
             }
         }
     }
@@ -802,6 +825,28 @@ CleanUp:
     return retStatus;
 }
 
+// Passes the GCC target to every transceiver so encoders can follow it
+static VOID reportGccTargetBitrate(PKvsPeerConnection pKvsPeerConnection, UINT64 targetBitrate)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PDoubleListNode pCurNode = NULL;
+    UINT64 item = 0;
+    PKvsRtpTransceiver pTransceiver;
+
+    CHK_STATUS(doubleListGetHeadNode(pKvsPeerConnection->pTransceivers, &pCurNode));
+    while (pCurNode != NULL) {
+        CHK_STATUS(doubleListGetNodeData(pCurNode, &item));
+        pTransceiver = (PKvsRtpTransceiver) item;
+        if (pTransceiver->onBandwidthEstimation != NULL) {
+            pTransceiver->onBandwidthEstimation(pTransceiver->onBandwidthEstimationCustomData, (DOUBLE) targetBitrate);
+        }
+        pCurNode = pCurNode->pNext;
+    }
+
+CleanUp:
+    CHK_LOG_ERR(retStatus);
+}
+
 STATUS onRtcpTwccPacket(PRtcpPacket pRtcpPacket, PKvsPeerConnection pKvsPeerConnection)
 {
     STATUS retStatus = STATUS_SUCCESS;
@@ -813,22 +858,20 @@ STATUS onRtcpTwccPacket(PRtcpPacket pRtcpPacket, PKvsPeerConnection pKvsPeerConn
     PTwccPacketReport pReports = NULL;
     UINT32 reportCount = 0;
     UINT16 seqNum = 0;
-    UINT64 twccPktValue = 0;
     PTwccRtpPacketInfo pTwccPacket = NULL;
+    UINT64 gccTargetBitrate = 0;
+    BOOL gccTargetChanged = FALSE;
 
     CHK(pKvsPeerConnection != NULL && pRtcpPacket != NULL, STATUS_NULL_ARG);
-    // Allow processing if either callback is registered
-    CHK(pKvsPeerConnection->pTwccManager != NULL &&
-            (pKvsPeerConnection->onSenderBandwidthEstimation != NULL || pKvsPeerConnection->onTwccPacketReport != NULL),
-        STATUS_SUCCESS);
+    CHK(pKvsPeerConnection->pTwccManager != NULL && TWCC_FEEDBACK_HAS_CONSUMER(pKvsPeerConnection), STATUS_SUCCESS);
 
     MUTEX_LOCK(pKvsPeerConnection->twccLock);
     locked = TRUE;
     pTwccManager = pKvsPeerConnection->pTwccManager;
     CHK_STATUS(parseRtcpTwccPacket(pRtcpPacket, pTwccManager));
 
-    // Build per-packet reports for the new callback BEFORE updateTwccHashTable removes them
-    if (pKvsPeerConnection->onTwccPacketReport != NULL) {
+    // Build per-packet reports for the callback and GCC BEFORE updateTwccPacketInfos removes them
+    if (pKvsPeerConnection->onTwccPacketReport != NULL || pKvsPeerConnection->pGccController != NULL) {
         // Calculate the number of packets in this report
         UINT16 baseSeqNum = pTwccManager->prevReportedBaseSeqNum;
         UINT16 lastSeqNum = pTwccManager->lastReportedSeqNum;
@@ -839,23 +882,28 @@ STATUS onRtcpTwccPacket(PRtcpPacket pRtcpPacket, PKvsPeerConnection pKvsPeerConn
             if (pReports != NULL) {
                 // Iterate through sequence numbers and build reports
                 for (seqNum = baseSeqNum; seqNum != (UINT16) (lastSeqNum + 1); seqNum++) {
-                    if (STATUS_SUCCEEDED(hashTableGet(pTwccManager->pTwccRtpPktInfosHashTable, seqNum, &twccPktValue))) {
-                        pTwccPacket = (PTwccRtpPacketInfo) twccPktValue;
-                        if (pTwccPacket != NULL) {
-                            pReports[reportCount].seqNum = seqNum;
-                            pReports[reportCount].sendTimeKvs = pTwccPacket->localTimeKvs;
-                            pReports[reportCount].arrivalTimeKvs = pTwccPacket->remoteTimeKvs;
-                            pReports[reportCount].packetSize = pTwccPacket->packetSize;
-                            pReports[reportCount].received = (pTwccPacket->remoteTimeKvs != TWCC_PACKET_LOST_TIME);
-                            reportCount++;
-                        }
+                    if ((pTwccPacket = twccManagerGetPacketInfo(pTwccManager, seqNum)) != NULL) {
+                        pReports[reportCount].seqNum = seqNum;
+                        pReports[reportCount].sendTimeKvs = pTwccPacket->localTimeKvs;
+                        pReports[reportCount].arrivalTimeKvs = pTwccPacket->remoteTimeKvs;
+                        pReports[reportCount].packetSize = pTwccPacket->packetSize;
+                        pReports[reportCount].received = (pTwccPacket->remoteTimeKvs != TWCC_PACKET_LOST_TIME);
+                        reportCount++;
                     }
                 }
             }
         }
     }
 
-    updateTwccHashTable(pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets);
+    updateTwccPacketInfos(pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets);
+
+    // Run the estimator under twccLock so concurrent feedback is applied in order
+    if (pKvsPeerConnection->pGccController != NULL && pReports != NULL && reportCount > 0) {
+        CHK_STATUS(gccOnTwccPacketReports(pKvsPeerConnection->pGccController, pReports, reportCount, 0));
+        gccTargetBitrate = gccGetTargetBitrate(pKvsPeerConnection->pGccController);
+        gccTargetChanged = gccTargetBitrate != pKvsPeerConnection->gccReportedBitrate;
+        pKvsPeerConnection->gccReportedBitrate = gccTargetBitrate;
+    }
 
     // Unlock before callbacks to avoid holding lock during application code
     MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
@@ -873,6 +921,16 @@ STATUS onRtcpTwccPacket(PRtcpPacket pRtcpPacket, PKvsPeerConnection pKvsPeerConn
                                                         sentPackets, receivedPackets, duration);
     }
 
+    // The pacer takes twccLock while sending, so its rate is only updated after releasing it
+    if (gccTargetBitrate != 0) {
+        if (pKvsPeerConnection->pPacer != NULL) {
+            CHK_STATUS(pacerSetTargetBitrate(pKvsPeerConnection->pPacer, gccTargetBitrate));
+        }
+        if (gccTargetChanged) {
+            reportGccTargetBitrate(pKvsPeerConnection, gccTargetBitrate);
+        }
+    }
+
 CleanUp:
     CHK_LOG_ERR(retStatus);
     SAFE_MEMFREE(pReports);
@@ -1160,13 +1218,15 @@ STATUS createTwccReceiverManager(PTwccReceiverManager* ppManager)
     pManager = (PTwccReceiverManager) MEMCALLOC(1, SIZEOF(TwccReceiverManager));
     CHK(pManager != NULL, STATUS_NOT_ENOUGH_MEMORY);
 
-    CHK_STATUS(hashTableCreateWithParams(TWCC_RECEIVER_HASH_BUCKET_COUNT, TWCC_RECEIVER_HASH_BUCKET_LENGTH, &pManager->pReceivedPktsHashTable));
+    pManager->pFeedbackPacket = (PBYTE) MEMALLOC(TWCC_FEEDBACK_MAX_PACKET_SIZE);
+    CHK(pManager->pFeedbackPacket != NULL, STATUS_NOT_ENOUGH_MEMORY);
 
     pManager->firstPacketReceived = FALSE;
     pManager->feedbackPacketCount = 0;
     pManager->firstSeqNum = 0;
     pManager->lastSeqNum = 0;
     pManager->mediaSourceSsrc = 0;
+    pManager->lastExtSeqNum = TWCC_EXT_SEQ_NUM_BASE;
 
     *ppManager = pManager;
     pManager = NULL;
@@ -1178,15 +1238,6 @@ CleanUp:
     return retStatus;
 }
 
-static STATUS twccReceiverFreeHashEntry(UINT64 customData, PHashEntry pHashEntry)
-{
-    UNUSED_PARAM(customData);
-    if (pHashEntry != NULL && pHashEntry->value != 0) {
-        MEMFREE((PVOID) pHashEntry->value);
-    }
-    return STATUS_SUCCESS;
-}
-
 STATUS freeTwccReceiverManager(PTwccReceiverManager* ppManager)
 {
     STATUS retStatus = STATUS_SUCCESS;
@@ -1196,11 +1247,7 @@ STATUS freeTwccReceiverManager(PTwccReceiverManager* ppManager)
     pManager = *ppManager;
     CHK(pManager != NULL, retStatus);
 
-    if (pManager->pReceivedPktsHashTable != NULL) {
-        hashTableIterateEntries(pManager->pReceivedPktsHashTable, 0, twccReceiverFreeHashEntry);
-        hashTableFree(pManager->pReceivedPktsHashTable);
-    }
-
+    SAFE_MEMFREE(pManager->pFeedbackPacket);
     MEMFREE(pManager);
     *ppManager = NULL;
 
@@ -1208,6 +1255,40 @@ CleanUp:
     return retStatus;
 }
 
+PTwccReceivedPacketInfo twccReceiverGetPacketInfo(PTwccReceiverManager pManager, UINT16 seqNum)
+{
+    UINT32 extSeqNum;
+    PTwccReceivedPacketInfo pPacketInfo;
+
+    if (pManager == NULL) {
+        return NULL;
+    }
+
+    extSeqNum = twccUnwrapSeqNum(pManager->lastExtSeqNum, seqNum);
+    pPacketInfo = &pManager->receivedPackets[extSeqNum & (TWCC_RECEIVER_RING_SIZE - 1)];
+
+    return pPacketInfo->extSeqNum == extSeqNum ? pPacketInfo : NULL;
+}
+
+static PTwccReceivedPacketInfo twccReceiverAddPacketInfo(PTwccReceiverManager pManager, UINT16 seqNum)
+{
+    UINT32 extSeqNum;
+    PTwccReceivedPacketInfo pPacketInfo;
+
+    extSeqNum = twccUnwrapSeqNum(pManager->lastExtSeqNum, seqNum);
+    if ((INT32) (extSeqNum - pManager->lastExtSeqNum) > 0) {
+        pManager->lastExtSeqNum = extSeqNum;
+    }
+
+    pPacketInfo = &pManager->receivedPackets[extSeqNum & (TWCC_RECEIVER_RING_SIZE - 1)];
+    if (pPacketInfo->extSeqNum == TWCC_EXT_SEQ_NUM_FREE) {
+        pManager->receivedPacketCount++;
+    }
+    pPacketInfo->extSeqNum = extSeqNum;
+
+    return pPacketInfo;
+}
+
 // Helper function to find a specific extension by ID in one-byte header extension payload (0xBEDE format)
 // Returns pointer to extension data (after ID|L byte) or NULL if not found
 static PBYTE findOneByteExtension(PBYTE pExtPayload, UINT32 extLength, UINT8 targetId, PUINT8 pDataLen)
@@ -1254,7 +1335,6 @@ STATUS twccReceiverOnPacketReceived(PKvsPeerConnection pKvsPeerConnection, PRtpP
     PTwccReceiverManager pManager = NULL;
     PTwccReceivedPacketInfo pPacketInfo = NULL;
     UINT16 twccSeqNum = 0;
-    UINT64 existingValue = 0;
     PBYTE pTwccExtData = NULL;
 
     CHK(pKvsPeerConnection != NULL && pRtpPacket != NULL, STATUS_NULL_ARG);
@@ -1279,33 +1359,19 @@ STATUS twccReceiverOnPacketReceived(PKvsPeerConnection pKvsPeerConnection, PRtpP
     MUTEX_LOCK(pKvsPeerConnection->twccReceiverLock);
 
     // Check if packet already exists (duplicate)
-    if (STATUS_SUCCEEDED(hashTableGet(pManager->pReceivedPktsHashTable, twccSeqNum, &existingValue))) {
+    if (twccReceiverGetPacketInfo(pManager, twccSeqNum) != NULL) {
         // Already tracked, skip
         MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
         CHK(FALSE, retStatus);
     }
 
-    // Allocate packet info
-    pPacketInfo = (PTwccReceivedPacketInfo) MEMCALLOC(1, SIZEOF(TwccReceivedPacketInfo));
-    if (pPacketInfo == NULL) {
-        MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
-        CHK(FALSE, STATUS_NOT_ENOUGH_MEMORY);
-    }
-
     // Set base time once (on first ever packet), then store relative arrival time
     if (pManager->baseTimeKvs == 0) {
         pManager->baseTimeKvs = pRtpPacket->receivedTime;
     }
+    pPacketInfo = twccReceiverAddPacketInfo(pManager, twccSeqNum);
     pPacketInfo->arrivalTimeKvs = pRtpPacket->receivedTime - pManager->baseTimeKvs;
 
-    // Store in hash table
-    retStatus = hashTablePut(pManager->pReceivedPktsHashTable, twccSeqNum, (UINT64) pPacketInfo);
-    if (STATUS_FAILED(retStatus)) {
-        MEMFREE(pPacketInfo);
-        MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
-        CHK(FALSE, retStatus);
-    }
-
     // Update sequence number tracking
     if (!pManager->firstPacketReceived) {
         pManager->firstSeqNum = twccSeqNum;
@@ -1361,35 +1427,32 @@ static TWCC_STATUS_SYMBOL getTwccPacketStatus(UINT64 arrivalTimeKvs, UINT64 refe
     }
 }
 
+// Only the TWCC feedback timer calls this, so the feedback buffers in the receiver manager have a single user
 STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
 {
     STATUS retStatus = STATUS_SUCCESS;
-    BOOL hasSrtpSession = FALSE;
+    BOOL hasSrtpSession = FALSE, locked = FALSE, foundPacket = FALSE;
     PTwccReceiverManager pManager = NULL;
     PBYTE pPacket = NULL;
     UINT32 packetLen = 0;
-    UINT32 allocSize = 0;
     UINT16 baseSeqNum = 0;
     UINT16 packetStatusCount = 0;
     UINT32 currentTime = 0;
-    UINT64 referenceTimeKvs = 0;
+    UINT64 referenceTimeKvs = 0, lastArrivalTimeKvs = 0;
     UINT32 referenceTime24 = 0;
     UINT16 seqNum = 0;
     UINT32 offset = 0;
-    UINT64 packetInfoValue = 0;
     PTwccReceivedPacketInfo pPacketInfo = NULL;
     INT32 deltaTicks = 0;
     TWCC_STATUS_SYMBOL status = TWCC_STATUS_SYMBOL_NOTRECEIVED;
     UINT32 senderSsrc = 0;
-
-    // Arrays to store packet statuses and deltas
-    TWCC_STATUS_SYMBOL* pStatuses = NULL;
-    INT32* pDeltas = NULL;
+    PUINT8 pStatuses = NULL;
+    PINT16 pDeltas = NULL;
     UINT32 i = 0;
-    UINT32 chunkOffset = 0;
-    UINT32 deltaOffset = 0;
     UINT16 runLength = 0;
-    TWCC_STATUS_SYMBOL runStatus = TWCC_STATUS_SYMBOL_NOTRECEIVED;
+    UINT8 runStatus = TWCC_STATUS_SYMBOL_NOTRECEIVED;
+    INT32 minDelta = INT32_MAX, maxDelta = INT32_MIN;
+    UINT32 receivedCount = 0, lostCount = 0;
 
     CHK(pKvsPeerConnection != NULL, STATUS_NULL_ARG);
 
@@ -1400,13 +1463,16 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
 
     pManager = pKvsPeerConnection->pTwccReceiverManager;
     CHK(pManager != NULL, retStatus);
+    pStatuses = pManager->feedbackStatuses;
+    pDeltas = pManager->feedbackDeltas;
+    pPacket = pManager->pFeedbackPacket;
 
     MUTEX_LOCK(pKvsPeerConnection->twccReceiverLock);
+    locked = TRUE;
 
     // Check if we have packets to report
     if (!pManager->firstPacketReceived) {
         DLOGD("TWCC sendFeedback: no packets received yet");
-        MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
         CHK(FALSE, retStatus);
     }
 
@@ -1419,38 +1485,18 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
         packetStatusCount = TWCC_MAX_PACKET_STATUS_COUNT;
     }
 
-    // Allocate arrays for statuses and deltas
-    pStatuses = (TWCC_STATUS_SYMBOL*) MEMCALLOC(packetStatusCount, SIZEOF(TWCC_STATUS_SYMBOL));
-    pDeltas = (INT32*) MEMCALLOC(packetStatusCount, SIZEOF(INT32));
-    if (pStatuses == NULL || pDeltas == NULL) {
-        MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
-        SAFE_MEMFREE(pStatuses);
-        SAFE_MEMFREE(pDeltas);
-        CHK(FALSE, STATUS_NOT_ENOUGH_MEMORY);
-    }
-
     // Find first received packet to use as reference time base
     // Per TWCC spec, reference time should be based on arrival time of first packet in report
     seqNum = baseSeqNum;
-    referenceTimeKvs = 0;
-    BOOL foundPacket = FALSE;
-    for (i = 0; i < packetStatusCount; i++) {
-        if (STATUS_SUCCEEDED(hashTableGet(pManager->pReceivedPktsHashTable, seqNum, &packetInfoValue))) {
-            pPacketInfo = (PTwccReceivedPacketInfo) packetInfoValue;
+    for (i = 0; i < packetStatusCount && !foundPacket; i++, seqNum++) {
+        if ((pPacketInfo = twccReceiverGetPacketInfo(pManager, seqNum)) != NULL) {
             referenceTimeKvs = pPacketInfo->arrivalTimeKvs;
             foundPacket = TRUE;
-            break;
         }
-        seqNum++;
     }
 
     // If no packets found, bail out
-    if (!foundPacket) {
-        MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
-        SAFE_MEMFREE(pStatuses);
-        SAFE_MEMFREE(pDeltas);
-        CHK(FALSE, retStatus);
-    }
+    CHK(foundPacket, retStatus);
 
     // Calculate reference time in 64ms units (24-bit field) for the packet
     // Convert from 100ns to ms, then divide by 64
@@ -1460,21 +1506,17 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
     // Deltas are incremental: delta[i] = arrival[i] - arrival[i-1]
     // First delta uses 64ms-aligned reference (Chrome reconstructs: referenceTime24 * 64ms + delta * 0.25ms)
     // Arrival times are relative to stream start, so values are small and won't overflow
-    UINT64 lastArrivalTimeKvs =
-        (UINT64) (currentTime / TWCC_REFERENCE_TIME_DIVISOR) * TWCC_REFERENCE_TIME_DIVISOR * HUNDREDS_OF_NANOS_IN_A_MILLISECOND;
+    lastArrivalTimeKvs = (UINT64) (currentTime / TWCC_REFERENCE_TIME_DIVISOR) * TWCC_REFERENCE_TIME_DIVISOR * HUNDREDS_OF_NANOS_IN_A_MILLISECOND;
     DLOGD("TWCC ref: refTimeKvs=%llu currentTime=%u refTime24=%u lastArrival=%llu", (unsigned long long) referenceTimeKvs, currentTime,
           referenceTime24, (unsigned long long) lastArrivalTimeKvs);
-    INT32 minDelta = INT32_MAX, maxDelta = INT32_MIN;
-    UINT32 receivedCount = 0, lostCount = 0;
     seqNum = baseSeqNum;
     for (i = 0; i < packetStatusCount; i++) {
-        if (STATUS_SUCCEEDED(hashTableGet(pManager->pReceivedPktsHashTable, seqNum, &packetInfoValue))) {
-            pPacketInfo = (PTwccReceivedPacketInfo) packetInfoValue;
+        if ((pPacketInfo = twccReceiverGetPacketInfo(pManager, seqNum)) != NULL) {
             status = getTwccPacketStatus(pPacketInfo->arrivalTimeKvs, lastArrivalTimeKvs, &deltaTicks);
-            pStatuses[i] = status;
-            pDeltas[i] = deltaTicks;
+            pStatuses[i] = (UINT8) status;
+            pDeltas[i] = (INT16) deltaTicks;
             if (status == TWCC_STATUS_SYMBOL_NOTRECEIVED) {
-                DLOGD("TWCC delta overflow: seq=%u i=%u delta=%d arrival=%llu la    stArrival=%llu", seqNum, i, deltaTicks,
+                DLOGD("TWCC delta overflow: seq=%u i=%u delta=%d arrival=%llu lastArrival=%llu", seqNum, i, deltaTicks,
                       (unsigned long long) pPacketInfo->arrivalTimeKvs, (unsigned long long) lastArrivalTimeKvs);
                 lostCount++;
             } else {
@@ -1485,6 +1527,10 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
                     maxDelta = deltaTicks;
             }
             lastArrivalTimeKvs = pPacketInfo->arrivalTimeKvs; // Update for next packet's delta
+
+            // Every packet of the window is reported now, free its slot for the next window
+            pPacketInfo->extSeqNum = TWCC_EXT_SEQ_NUM_FREE;
+            pManager->receivedPacketCount--;
         } else {
             pStatuses[i] = TWCC_STATUS_SYMBOL_NOTRECEIVED;
             pDeltas[i] = 0;
@@ -1495,37 +1541,6 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
     DLOGD("TWCC feedback: base=%u count=%u received=%u lost=%u minDelta=%d maxDelta=%d", baseSeqNum, packetStatusCount, receivedCount, lostCount,
           minDelta, maxDelta);
 
-    // Calculate packet size:
-    // Header: 20 bytes (4 RTCP header + 4 sender SSRC + 4 media SSRC + 4 base seq + 4 ref time)
-    // Chunks: variable (2 bytes each, worst case is status vector with 7 packets = packetStatusCount/7 chunks)
-    // Deltas: variable (1 byte for small, 2 bytes for large)
-    // Add SRTP overhead
-    allocSize = 20; // Fixed header size
-
-    // Estimate chunk size (worst case: all status vectors with 7 packets each)
-    allocSize += ((packetStatusCount + 6) / 7) * 2;
-
-    // Estimate delta size (worst case: all large deltas)
-    for (i = 0; i < packetStatusCount; i++) {
-        if (pStatuses[i] == TWCC_STATUS_SYMBOL_SMALLDELTA) {
-            allocSize += 1;
-        } else if (pStatuses[i] == TWCC_STATUS_SYMBOL_LARGEDELTA) {
-            allocSize += 2;
-        }
-    }
-
-    // Pad to 32-bit boundary + SRTP overhead
-    allocSize = (allocSize + 3) & ~3;
-    allocSize += SRTP_AUTH_TAG_OVERHEAD + SRTP_MAX_TRAILER_LEN + 4;
-
-    pPacket = (PBYTE) MEMCALLOC(1, allocSize);
-    if (pPacket == NULL) {
-        MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
-        SAFE_MEMFREE(pStatuses);
-        SAFE_MEMFREE(pDeltas);
-        CHK(FALSE, STATUS_NOT_ENOUGH_MEMORY);
-    }
-
     // Get sender SSRC (use first transceiver's receive SSRC or generate one)
     // For simplicity, we'll use a fixed SSRC derived from the connection
     senderSsrc = (UINT32) ((UINT64) pKvsPeerConnection & 0xFFFFFFFF);
@@ -1563,7 +1578,6 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
     pPacket[offset++] = pManager->feedbackPacketCount++;
 
     // Build packet chunks using run-length encoding
-    chunkOffset = offset;
     i = 0;
     while (i < packetStatusCount) {
         // Count run of same status
@@ -1574,49 +1588,38 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
         }
 
         // Write run-length chunk
-        putUnalignedInt16BigEndian(pPacket + chunkOffset, TWCC_MAKE_RUNLEN(runStatus, runLength));
-        chunkOffset += 2;
+        putUnalignedInt16BigEndian(pPacket + offset, TWCC_MAKE_RUNLEN(runStatus, runLength));
+        offset += TWCC_FB_PACKETCHUNK_SIZE;
         i += runLength;
     }
 
     // Build receive deltas
-    deltaOffset = chunkOffset;
     for (i = 0; i < packetStatusCount; i++) {
         if (pStatuses[i] == TWCC_STATUS_SYMBOL_SMALLDELTA) {
-            pPacket[deltaOffset++] = (UINT8) pDeltas[i];
+            pPacket[offset++] = (UINT8) pDeltas[i];
         } else if (pStatuses[i] == TWCC_STATUS_SYMBOL_LARGEDELTA) {
-            putUnalignedInt16BigEndian(pPacket + deltaOffset, (INT16) pDeltas[i]);
-            deltaOffset += 2;
+            putUnalignedInt16BigEndian(pPacket + offset, pDeltas[i]);
+            offset += 2;
         }
     }
 
     // Pad to 32-bit boundary
-    while ((deltaOffset % 4) != 0) {
-        pPacket[deltaOffset++] = 0;
+    while ((offset % 4) != 0) {
+        pPacket[offset++] = 0;
     }
 
-    packetLen = deltaOffset;
+    packetLen = offset;
 
     // Fill in length field (length in 32-bit words minus 1)
     putUnalignedInt16BigEndian(pPacket + 2, (packetLen / 4) - 1);
 
-    // Clear processed packets from hash table
-    seqNum = baseSeqNum;
-    for (i = 0; i < packetStatusCount; i++) {
-        if (STATUS_SUCCEEDED(hashTableGet(pManager->pReceivedPktsHashTable, seqNum, &packetInfoValue))) {
-            pPacketInfo = (PTwccReceivedPacketInfo) packetInfoValue;
-            hashTableRemove(pManager->pReceivedPktsHashTable, seqNum);
-            MEMFREE(pPacketInfo);
-        }
-        seqNum++;
-    }
-
     // Reset tracking for next feedback
     pManager->firstPacketReceived = FALSE;
     pManager->firstSeqNum = 0;
     pManager->lastSeqNum = 0;
 
     MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
+    locked = FALSE;
 
     // PCAP: capture unencrypted outbound RTCP (TWCC feedback)
     if (pKvsPeerConnection->pPcapDump != NULL) {
@@ -1632,9 +1635,9 @@ STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection)
     CHK_STATUS(iceAgentSendPacket(pKvsPeerConnection->pIceAgent, pPacket, packetLen));
 
 CleanUp:
-    SAFE_MEMFREE(pPacket);
-    SAFE_MEMFREE(pStatuses);
-    SAFE_MEMFREE(pDeltas);
+    if (locked) {
+        MUTEX_UNLOCK(pKvsPeerConnection->twccReceiverLock);
+    }
     return retStatus;
 }
 
@@ -1667,8 +1670,8 @@ STATUS twccFeedbackCallback(UINT32 timerId, UINT64 currentTime, UINT64 customDat
     {
         UINT32 newTimerId = MAX_UINT32;
         delay = 80 + (RAND() % 40);
-        CHK_STATUS(timerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, delay * HUNDREDS_OF_NANOS_IN_A_MILLISECOND,
-                                      TIMER_QUEUE_SINGLE_INVOCATION_PERIOD, twccFeedbackCallback, (UINT64) pKvsPeerConnection, &newTimerId));
+        CHK_STATUS(kvsTimerQueueAddTimer(pKvsPeerConnection->timerQueueHandle, delay * HUNDREDS_OF_NANOS_IN_A_MILLISECOND,
+                                         TIMER_QUEUE_SINGLE_INVOCATION_PERIOD, twccFeedbackCallback, (UINT64) pKvsPeerConnection, &newTimerId));
         MUTEX_LOCK(pKvsPeerConnection->twccLock);
         pKvsPeerConnection->twccFeedbackTimerId = newTimerId;
         MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
@@ -12,7 +12,7 @@ STATUS onRtcpRembPacket(PRtcpPacket, PKvsPeerConnection);
 STATUS onRtcpPLIPacket(PRtcpPacket, PKvsPeerConnection);
 STATUS parseRtcpTwccPacket(PRtcpPacket, PTwccManager);
 STATUS onRtcpTwccPacket(PRtcpPacket, PKvsPeerConnection);
-STATUS updateTwccHashTable(PTwccManager, PINT64, PUINT64, PUINT64, PUINT64, PUINT64);
+STATUS updateTwccPacketInfos(PTwccManager, PINT64, PUINT64, PUINT64, PUINT64, PUINT64);
 STATUS sendRtcpPLI(PKvsPeerConnection pKvsPeerConnection, UINT32 senderSsrc, UINT32 mediaSsrc);
 STATUS sendRtcpFIR(PKvsPeerConnection pKvsPeerConnection, UINT32 senderSsrc, UINT32 mediaSsrc, UINT8* pSeqNum);
 
@@ -30,9 +30,17 @@ STATUS rtcpBuildReceiverReport(PKvsRtpTransceiver pKvsRtpTransceiver, UINT64 cur
 STATUS rtcpBuildExtendedReport(PKvsPeerConnection pKvsPeerConnection, PKvsRtpTransceiver pKvsRtpTransceiver, UINT64 currentTime, PBYTE pOutBuffer,
                                PUINT32 pPacketLen);
 
+// TWCC sent packet ring. Slots are indexed by the unwrapped transport-wide seqNum and tagged with it, so a lookup for
+// a seqNum whose slot has since been reused by a newer packet misses instead of returning the newer packet.
+// Not thread safe, callers hold twccLock.
+PTwccRtpPacketInfo twccManagerGetPacketInfo(PTwccManager pTwccManager, UINT16 seqNum);
+PTwccRtpPacketInfo twccManagerAddPacketInfo(PTwccManager pTwccManager, UINT16 seqNum);
+VOID twccManagerRemovePacketInfo(PTwccManager pTwccManager, PTwccRtpPacketInfo pTwccRtpPacketInfo);
+
 // TWCC feedback generation (receiver side)
 STATUS createTwccReceiverManager(PTwccReceiverManager* ppManager);
 STATUS freeTwccReceiverManager(PTwccReceiverManager* ppManager);
+PTwccReceivedPacketInfo twccReceiverGetPacketInfo(PTwccReceiverManager pManager, UINT16 seqNum);
 STATUS twccReceiverOnPacketReceived(PKvsPeerConnection pKvsPeerConnection, PRtpPacket pRtpPacket);
 STATUS sendRtcpTwccFeedback(PKvsPeerConnection pKvsPeerConnection);
 STATUS twccFeedbackCallback(UINT32 timerId, UINT64 currentTime, UINT64 customData);
@@ -46,6 +54,10 @@ STATUS twccFeedbackCallback(UINT32 timerId, UINT64 currentTime, UINT64 customDat
 #define TWCC_PACKET_UNITIALIZED_TIME 0
 #define TWCC_ESTIMATOR_TIME_WINDOW   (1 * HUNDREDS_OF_NANOS_IN_A_SECOND)
 
+// Unwrapped seqNums start one full cycle in so that no packet can ever unwrap to the free slot tag
+#define TWCC_EXT_SEQ_NUM_BASE ((UINT32) 1 << 16)
+#define TWCC_EXT_SEQ_NUM_FREE 0
+
 typedef enum {
     TWCC_STATUS_SYMBOL_NOTRECEIVED = 0,
     TWCC_STATUS_SYMBOL_SMALLDELTA,
@@ -70,12 +82,16 @@ typedef enum {
 #define TWCC_PACKET_STATUS_COUNT(payload)    (getUnalignedInt16BigEndian((payload) + 10))
 
 // TWCC feedback generation constants
-#define TWCC_FEEDBACK_INITIAL_DELAY      (100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
-#define TWCC_FEEDBACK_INTERVAL_MS        100
-#define TWCC_RECEIVER_HASH_BUCKET_COUNT  100
-#define TWCC_RECEIVER_HASH_BUCKET_LENGTH 2
-#define TWCC_REFERENCE_TIME_DIVISOR      64     // 64ms granularity for reference time
-#define TWCC_MAX_PACKET_STATUS_COUNT     0x1FFF // Max run-length count (13 bits)
+#define TWCC_FEEDBACK_INITIAL_DELAY  (100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
+#define TWCC_FEEDBACK_INTERVAL_MS    100
+#define TWCC_REFERENCE_TIME_DIVISOR  64     // 64ms granularity for reference time
+#define TWCC_MAX_PACKET_STATUS_COUNT 0x1FFF // Max run-length count (13 bits)
+#define TWCC_FEEDBACK_HEADER_SIZE    20
+
+// Worst case feedback: one run-length chunk and one large delta per packet, plus padding and SRTP overhead
+#define TWCC_FEEDBACK_MAX_PACKET_SIZE                                                                                                                \
+    (TWCC_FEEDBACK_HEADER_SIZE + TWCC_MAX_PACKET_STATUS_COUNT * (TWCC_FB_PACKETCHUNK_SIZE + SIZEOF(INT16)) + 3 + SRTP_AUTH_TAG_OVERHEAD +            \
+     SRTP_MAX_TRAILER_LEN + 4)
 
 // TWCC chunk encoding macros for feedback generation
 // Run-length chunk: bit 15 = 0, bits 14-13 = status symbol, bits 12-0 = run length
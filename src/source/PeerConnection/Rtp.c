@@ -2,7 +2,6 @@
 
 #include "../Include_i.h"
 
-typedef STATUS (*RtpPayloadFunc)(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
 
 STATUS createKvsRtpTransceiver(RTC_RTP_TRANSCEIVER_DIRECTION direction, PKvsPeerConnection pKvsPeerConnection, UINT32 ssrc, UINT32 rtxSsrc,
                                PRtcMediaStreamTrack pRtcMediaStreamTrack, PJitterBuffer pJitterBuffer, RTC_CODEC rtcCodec,
@@ -161,8 +160,11 @@ STATUS freeKvsRtpTransceiver(PKvsRtpTransceiver* ppKvsRtpTransceiver)
     MUTEX_FREE(pKvsRtpTransceiver->statsLock);
 
     SAFE_MEMFREE(pKvsRtpTransceiver->peerFrameBuffer);
-    SAFE_MEMFREE(pKvsRtpTransceiver->sender.payloadArray.payloadBuffer);
-    SAFE_MEMFREE(pKvsRtpTransceiver->sender.payloadArray.payloadSubLength);
+    SAFE_MEMFREE(pKvsRtpTransceiver->pFrameFragments);
+    SAFE_MEMFREE(pKvsRtpTransceiver->pFrameFragmentsBackup);
+    freePayloadDescriptorArray(&pKvsRtpTransceiver->sender.payloadDescriptors);
+    SAFE_MEMFREE(pKvsRtpTransceiver->sender.pPacketList);
+    SAFE_MEMFREE(pKvsRtpTransceiver->sender.pPacerPackets);
 
     SAFE_MEMFREE(pKvsRtpTransceiver);
 
@@ -202,6 +204,23 @@ CleanUp:
     return retStatus;
 }
 
+STATUS transceiverOnFrameFragments(PRtcRtpTransceiver pRtcRtpTransceiver, UINT64 customData, RtcOnFrameFragments rtcOnFrameFragments)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PKvsRtpTransceiver pKvsRtpTransceiver = (PKvsRtpTransceiver) pRtcRtpTransceiver;
+
+    CHK(pKvsRtpTransceiver != NULL && rtcOnFrameFragments != NULL, STATUS_NULL_ARG);
+
+    pKvsRtpTransceiver->onFrameFragments = rtcOnFrameFragments;
+    pKvsRtpTransceiver->onFrameFragmentsCustomData = customData;
+
+CleanUp:
+
+    LEAVES();
+    return retStatus;
+}
+
 STATUS transceiverOnPartialFrame(PRtcRtpTransceiver pRtcRtpTransceiver, UINT64 customData, RtcOnFrame rtcOnPartialFrame)
 {
     ENTERS();
@@ -287,10 +306,11 @@ STATUS writeFrame(PRtcRtpTransceiver pRtcRtpTransceiver, PFrame pFrame)
     PKvsRtpTransceiver pKvsRtpTransceiver = (PKvsRtpTransceiver) pRtcRtpTransceiver;
     BOOL locked = FALSE, bufferAfterEncrypt = FALSE;
     PRtpPacket pPacketList = NULL, pRtpPacket = NULL;
-    UINT32 i = 0, packetLen = 0, headerLen = 0, allocSize;
+    UINT32 i = 0, j = 0, packetLen = 0, headerLen = 0, allocSize, batchCount = 0, sentCount = 0, packetCount = 0;
     PBYTE rawPacket = NULL;
-    PPayloadArray pPayloadArray = NULL;
-    RtpPayloadFunc rtpPayloadFunc = NULL;
+    PPayloadDescriptorArray pPayloadDescriptors = NULL;
+    RtpPacketizeFunc rtpPacketizeFunc = NULL;
+    BOOL isRedFallback = FALSE;
     UINT64 randomRtpTimeoffset = 0; // TODO: spec requires random rtp time offset
     UINT64 rtpTimestamp = 0;
     UINT64 now = GETTIME();
@@ -303,18 +323,21 @@ STATUS writeFrame(PRtcRtpTransceiver pRtcRtpTransceiver, PFrame pFrame)
 
     // temp vars :(
     UINT64 tmpFrames, tmpTime;
-    UINT16 twsn;
+    UINT16 twsn = 0;
     UINT32 extpayload;
     STATUS sendStatus;
+    UINT64 sentTime;
+    PBYTE sendBuffers[SOCKET_SEND_BATCH_MAX_PACKETS];
+    UINT32 sendBufferLens[SOCKET_SEND_BATCH_MAX_PACKETS];
 
-    // Batch pacing: collect packets for atomic frame enqueue
+    // Encrypted packets of the frame, enqueued to the pacer as one batch or handed to the ICE agent in batched sends
     PPacerPacketInfo pPacerPackets = NULL;
     UINT32 pacerPacketCount = 0;
     BOOL useBatchPacing = FALSE;
 
     CHK(pKvsRtpTransceiver != NULL && pFrame != NULL, STATUS_NULL_ARG);
     pKvsPeerConnection = pKvsRtpTransceiver->pKvsPeerConnection;
-    pPayloadArray = &(pKvsRtpTransceiver->sender.payloadArray);
+    pPayloadDescriptors = &(pKvsRtpTransceiver->sender.payloadDescriptors);
     if (MEDIA_STREAM_TRACK_KIND_VIDEO == pKvsRtpTransceiver->sender.track.kind) {
         frames++;
         if (0 != (pFrame->flags & FRAME_FLAG_KEY_FRAME)) {
@@ -337,29 +360,29 @@ STATUS writeFrame(PRtcRtpTransceiver pRtcRtpTransceiver, PFrame pFrame)
     UINT8 effectivePayloadType = pKvsRtpTransceiver->sender.payloadType;
     switch (pKvsRtpTransceiver->sender.track.codec) {
         case RTC_CODEC_H264_PROFILE_42E01F_LEVEL_ASYMMETRY_ALLOWED_PACKETIZATION_MODE:
-            rtpPayloadFunc = createPayloadForH264;
+            rtpPacketizeFunc = packetizeH264Frame;
             rtpTimestamp = CONVERT_TIMESTAMP_TO_RTP(VIDEO_CLOCKRATE, pFrame->presentationTs);
             break;
 
         case RTC_CODEC_H265:
-            rtpPayloadFunc = createPayloadForH265;
+            rtpPacketizeFunc = packetizeH265Frame;
             rtpTimestamp = CONVERT_TIMESTAMP_TO_RTP(VIDEO_CLOCKRATE, pFrame->presentationTs);
             break;
 
         case RTC_CODEC_OPUS:
-            rtpPayloadFunc = createPayloadForOpus;
+            rtpPacketizeFunc = packetizeOpusFrame;
             rtpTimestamp = CONVERT_TIMESTAMP_TO_RTP(OPUS_CLOCKRATE, pFrame->presentationTs);
             useOpusRed = (pKvsRtpTransceiver->sender.redPayloadType != 0 && pKvsRtpTransceiver->sender.pRedSenderState != NULL);
             break;
 
         case RTC_CODEC_MULAW:
         case RTC_CODEC_ALAW:
-            rtpPayloadFunc = createPayloadForG711;
+            rtpPacketizeFunc = packetizeG711Frame;
             rtpTimestamp = CONVERT_TIMESTAMP_TO_RTP(PCM_CLOCKRATE, pFrame->presentationTs);
             break;
 
         case RTC_CODEC_VP8:
-            rtpPayloadFunc = createPayloadForVP8;
+            rtpPacketizeFunc = packetizeVP8Frame;
             rtpTimestamp = CONVERT_TIMESTAMP_TO_RTP(VIDEO_CLOCKRATE, pFrame->presentationTs);
             break;
 
@@ -369,67 +392,48 @@ STATUS writeFrame(PRtcRtpTransceiver pRtcRtpTransceiver, PFrame pFrame)
 
     rtpTimestamp += randomRtpTimeoffset;
 
+    // Packetize in a single pass over the frame, the descriptors reference the frame data and keep only payload headers
+    resetPayloadDescriptorArray(pPayloadDescriptors);
     if (useOpusRed) {
-        // Two-call pattern: first NULL for size, then with buffer.
-        BOOL isFallback = FALSE;
-        UINT32 subLenCap = 1;
-        CHK_STATUS(createPayloadForOpusRed(pKvsPeerConnection->MTU, (PBYTE) pFrame->frameData, pFrame->size, (UINT32) rtpTimestamp,
-                                           pKvsRtpTransceiver->sender.pRedSenderState, NULL, &(pPayloadArray->payloadLength), NULL, &subLenCap,
-                                           &isFallback));
-        if (pPayloadArray->payloadLength > pPayloadArray->maxPayloadLength) {
-            SAFE_MEMFREE(pPayloadArray->payloadBuffer);
-            pPayloadArray->payloadBuffer = (PBYTE) MEMALLOC(pPayloadArray->payloadLength);
-            pPayloadArray->maxPayloadLength = pPayloadArray->payloadLength;
-        }
-        pPayloadArray->payloadSubLenSize = 1;
-        if (pPayloadArray->maxPayloadSubLenSize < 1) {
-            SAFE_MEMFREE(pPayloadArray->payloadSubLength);
-            pPayloadArray->payloadSubLength = (PUINT32) MEMALLOC(SIZEOF(UINT32));
-            pPayloadArray->maxPayloadSubLenSize = 1;
-        }
-        UINT32 subLenCap2 = 1;
-        CHK_STATUS(createPayloadForOpusRed(pKvsPeerConnection->MTU, (PBYTE) pFrame->frameData, pFrame->size, (UINT32) rtpTimestamp,
-                                           pKvsRtpTransceiver->sender.pRedSenderState, pPayloadArray->payloadBuffer, &(pPayloadArray->payloadLength),
-                                           pPayloadArray->payloadSubLength, &subLenCap2, &isFallback));
-        pPayloadArray->payloadSubLenSize = 1;
-        effectivePayloadType = isFallback ? pKvsRtpTransceiver->sender.opusPayloadTypeForRed : pKvsRtpTransceiver->sender.redPayloadType;
+        CHK_STATUS(packetizeOpusRedFrame(pKvsPeerConnection->MTU, (PBYTE) pFrame->frameData, pFrame->size, (UINT32) rtpTimestamp,
+                                         pKvsRtpTransceiver->sender.pRedSenderState, pPayloadDescriptors, &isRedFallback));
+        effectivePayloadType = isRedFallback ? pKvsRtpTransceiver->sender.opusPayloadTypeForRed : pKvsRtpTransceiver->sender.redPayloadType;
     } else {
-        CHK_STATUS(rtpPayloadFunc(pKvsPeerConnection->MTU, (PBYTE) pFrame->frameData, pFrame->size, NULL, &(pPayloadArray->payloadLength), NULL,
-                                  &(pPayloadArray->payloadSubLenSize)));
-        if (pPayloadArray->payloadLength > pPayloadArray->maxPayloadLength) {
-            SAFE_MEMFREE(pPayloadArray->payloadBuffer);
-            pPayloadArray->payloadBuffer = (PBYTE) MEMALLOC(pPayloadArray->payloadLength);
-            pPayloadArray->maxPayloadLength = pPayloadArray->payloadLength;
-        }
-        if (pPayloadArray->payloadSubLenSize > pPayloadArray->maxPayloadSubLenSize) {
-            SAFE_MEMFREE(pPayloadArray->payloadSubLength);
-            pPayloadArray->payloadSubLength = (PUINT32) MEMALLOC(pPayloadArray->payloadSubLenSize * SIZEOF(UINT32));
-            pPayloadArray->maxPayloadSubLenSize = pPayloadArray->payloadSubLenSize;
-        }
-        CHK_STATUS(rtpPayloadFunc(pKvsPeerConnection->MTU, (PBYTE) pFrame->frameData, pFrame->size, pPayloadArray->payloadBuffer,
-                                  &(pPayloadArray->payloadLength), pPayloadArray->payloadSubLength, &(pPayloadArray->payloadSubLenSize)));
+        CHK_STATUS(rtpPacketizeFunc(pKvsPeerConnection->MTU, (PBYTE) pFrame->frameData, pFrame->size, pPayloadDescriptors));
+    }
+    packetCount = pPayloadDescriptors->descriptorCount;
+
+    if (packetCount > pKvsRtpTransceiver->sender.packetListCapacity) {
+        SAFE_MEMFREE(pKvsRtpTransceiver->sender.pPacketList);
+        pKvsRtpTransceiver->sender.packetListCapacity = 0;
+        pKvsRtpTransceiver->sender.pPacketList = (PRtpPacket) MEMALLOC(packetCount * SIZEOF(RtpPacket));
+        CHK(pKvsRtpTransceiver->sender.pPacketList != NULL, STATUS_NOT_ENOUGH_MEMORY);
+        pKvsRtpTransceiver->sender.packetListCapacity = packetCount;
     }
-    pPacketList = (PRtpPacket) MEMALLOC(pPayloadArray->payloadSubLenSize * SIZEOF(RtpPacket));
+    pPacketList = pKvsRtpTransceiver->sender.pPacketList;
 
     if (!pKvsRtpTransceiver->sender.seqInitialized) {
         pKvsRtpTransceiver->sender.initialSequenceNumber = pKvsRtpTransceiver->sender.sequenceNumber;
         pKvsRtpTransceiver->sender.seqInitialized = TRUE;
     }
-    CHK_STATUS(constructRtpPackets(pPayloadArray, effectivePayloadType, pKvsRtpTransceiver->sender.sequenceNumber, rtpTimestamp,
-                                   pKvsRtpTransceiver->sender.ssrc, pPacketList, pPayloadArray->payloadSubLenSize));
-    pKvsRtpTransceiver->sender.sequenceNumber = GET_UINT16_SEQ_NUM(pKvsRtpTransceiver->sender.sequenceNumber + pPayloadArray->payloadSubLenSize);
+    CHK_STATUS(constructRtpPacketsFromDescriptors(pPayloadDescriptors, effectivePayloadType, pKvsRtpTransceiver->sender.sequenceNumber, rtpTimestamp,
+                                                  pKvsRtpTransceiver->sender.ssrc, pPacketList, packetCount));
+    pKvsRtpTransceiver->sender.sequenceNumber = GET_UINT16_SEQ_NUM(pKvsRtpTransceiver->sender.sequenceNumber + packetCount);
 
     bufferAfterEncrypt = (pKvsRtpTransceiver->sender.payloadType == pKvsRtpTransceiver->sender.rtxPayloadType);
 
-    // Check if batch pacing should be used (video only, pacing enabled)
-    useBatchPacing = (pKvsPeerConnection->pPacer != NULL && pacerIsEnabled(pKvsPeerConnection->pPacer) &&
-                      pKvsRtpTransceiver->sender.track.kind == MEDIA_STREAM_TRACK_KIND_VIDEO);
-    if (useBatchPacing) {
-        pPacerPackets = (PPacerPacketInfo) MEMALLOC(pPayloadArray->payloadSubLenSize * SIZEOF(PacerPacketInfo));
-        CHK(pPacerPackets != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    // Audio goes through the pacer too, ahead of video, so both share one budget
+    useBatchPacing = (pKvsPeerConnection->pPacer != NULL && pacerIsEnabled(pKvsPeerConnection->pPacer));
+    if (packetCount > pKvsRtpTransceiver->sender.pacerPacketsCapacity) {
+        SAFE_MEMFREE(pKvsRtpTransceiver->sender.pPacerPackets);
+        pKvsRtpTransceiver->sender.pacerPacketsCapacity = 0;
+        pKvsRtpTransceiver->sender.pPacerPackets = (PPacerPacketInfo) MEMALLOC(packetCount * SIZEOF(PacerPacketInfo));
+        CHK(pKvsRtpTransceiver->sender.pPacerPackets != NULL, STATUS_NOT_ENOUGH_MEMORY);
+        pKvsRtpTransceiver->sender.pacerPacketsCapacity = packetCount;
     }
+    pPacerPackets = pKvsRtpTransceiver->sender.pPacerPackets;
 
-    for (i = 0; i < pPayloadArray->payloadSubLenSize; i++) {
+    for (i = 0; i < packetCount; i++) {
         pRtpPacket = pPacketList + i;
         if (pKvsRtpTransceiver->pKvsPeerConnection->twccExtId != 0) {
             pRtpPacket->header.extension = TRUE;
@@ -439,13 +443,12 @@ STATUS writeFrame(PRtcRtpTransceiver pRtcRtpTransceiver, PFrame pFrame)
             extpayload = TWCC_PAYLOAD(pKvsRtpTransceiver->pKvsPeerConnection->twccExtId, twsn);
             pRtpPacket->header.extensionPayload = (PBYTE) &extpayload;
         }
-        // Get the required size first
-        CHK_STATUS(createBytesFromRtpPacket(pRtpPacket, NULL, &packetLen));
-
-        // Account for SRTP authentication tag
+        // Gather the RTP header, payload header and frame bytes straight into the buffer that is encrypted in place and sent,
+        // accounting for the SRTP authentication tag
+        packetLen = RTP_GET_RAW_PACKET_SIZE(pRtpPacket);
         allocSize = packetLen + SRTP_AUTH_TAG_OVERHEAD;
-        CHK(NULL != (rawPacket = (PBYTE) MEMALLOC(allocSize)), STATUS_NOT_ENOUGH_MEMORY);
-        CHK_STATUS(createBytesFromRtpPacket(pRtpPacket, rawPacket, &packetLen));
+        CHK(NULL != (rawPacket = packetPoolAlloc(pKvsPeerConnection->pOutboundPacketPool, allocSize)), STATUS_NOT_ENOUGH_MEMORY);
+        CHK_STATUS(createBytesFromRtpPacketDescriptor(pRtpPacket, pPayloadDescriptors, i, rawPacket, &packetLen));
 
         if (!bufferAfterEncrypt) {
             pRtpPacket->pRawPacket = rawPacket;
@@ -460,64 +463,36 @@ STATUS writeFrame(PRtcRtpTransceiver pRtcRtpTransceiver, PFrame pFrame)
 
         CHK_STATUS(encryptRtpPacket(pKvsPeerConnection->pSrtpSession, rawPacket, (PINT32) &packetLen));
 
-        // Check if pacing is enabled (only for video - audio bypasses pacer to avoid latency)
-        if (useBatchPacing) {
-            // Collect packet for batch enqueue after loop completes.
-            // This ensures the pacer sees the full frame atomically, so
-            // deadline-based budget calculation uses the correct queue size.
-            pPacerPackets[pacerPacketCount].pData = rawPacket;
-            pPacerPackets[pacerPacketCount].size = packetLen;
-            pPacerPackets[pacerPacketCount].twccSeqNum = twsn;
-            pacerPacketCount++;
-            rawPacket = NULL; // Will be owned by pacer after batch enqueue
+        if (bufferAfterEncrypt) {
+            pRtpPacket->pRawPacket = rawPacket;
+            pRtpPacket->rawPacketLength = packetLen;
+            CHK_STATUS(rtpRollingBufferAddRtpPacket(pKvsRtpTransceiver->sender.packetBuffer, pRtpPacket));
+        }
 
-            // Update stats (packet will be sent by pacer)
-            headerLen = RTP_HEADER_LEN(pRtpPacket);
-            bytesSent += packetLen - headerLen;
-            packetsSent++;
-            lastPacketSentTimestamp = KVS_CONVERT_TIMESCALE(GETTIME(), HUNDREDS_OF_NANOS_IN_A_SECOND, 1000);
-            headerBytesSent += headerLen;
-        } else {
-            // No pacing - send immediately
-            sendStatus = iceAgentSendPacket(pKvsPeerConnection->pIceAgent, rawPacket, packetLen);
-            if (sendStatus == STATUS_SEND_DATA_FAILED) {
-                packetsDiscardedOnSend++;
-                bytesDiscardedOnSend += packetLen - headerLen;
-                // TODO is frame considered discarded when at least one of its packets is discarded or all of its packets discarded?
-                framesDiscardedOnSend = 1;
-                SAFE_MEMFREE(rawPacket);
-                continue;
-            } else if (sendStatus == STATUS_SUCCESS && pKvsRtpTransceiver->pKvsPeerConnection->twccExtId != 0) {
-                pRtpPacket->sentTime = GETTIME();
-                twccManagerOnPacketSent(pKvsPeerConnection, pRtpPacket);
-            }
-            CHK_STATUS(sendStatus);
+        // Collect the packet so the pacer sees the full frame atomically (deadline-based budget calculation uses the
+        // correct queue size), or so the unpaced path can send the frame with as few syscalls as possible.
+        pPacerPackets[pacerPacketCount].pData = rawPacket;
+        pPacerPackets[pacerPacketCount].size = packetLen;
+        pPacerPackets[pacerPacketCount].twccSeqNum = twsn;
+        pacerPacketCount++;
+        rawPacket = NULL;
 
-            // https://tools.ietf.org/html/rfc3550#section-6.4.1
-            // The total number of payload octets (i.e., not including header or padding) transmitted in RTP data packets by the sender
+        if (useBatchPacing) {
+            // Update stats (packet will be sent by pacer)
             headerLen = RTP_HEADER_LEN(pRtpPacket);
             bytesSent += packetLen - headerLen;
             packetsSent++;
             lastPacketSentTimestamp = KVS_CONVERT_TIMESCALE(GETTIME(), HUNDREDS_OF_NANOS_IN_A_SECOND, 1000);
             headerBytesSent += headerLen;
-
-            SAFE_MEMFREE(rawPacket);
-        }
-
-        if (bufferAfterEncrypt) {
-            // Note: when pacing, rawPacket is NULL here, but the rolling buffer
-            // was already populated before encryption if !bufferAfterEncrypt
-            if (rawPacket != NULL) {
-                pRtpPacket->pRawPacket = rawPacket;
-                pRtpPacket->rawPacketLength = packetLen;
-                CHK_STATUS(rtpRollingBufferAddRtpPacket(pKvsRtpTransceiver->sender.packetBuffer, pRtpPacket));
-            }
         }
     }
 
     // Batch enqueue collected packets to pacer (ensures frame-deadline pacing sees full frame)
     if (useBatchPacing && pacerPacketCount > 0) {
-        sendStatus = pacerEnqueueFrame(pKvsPeerConnection->pPacer, pPacerPackets, pacerPacketCount);
+        sendStatus = pacerEnqueueFrame(pKvsPeerConnection->pPacer,
+                                       pKvsRtpTransceiver->sender.track.kind == MEDIA_STREAM_TRACK_KIND_AUDIO ? PACER_PRIORITY_AUDIO
+                                                                                                               : PACER_PRIORITY_VIDEO,
+                                       pPacerPackets, pacerPacketCount);
         if (STATUS_SUCCEEDED(sendStatus)) {
             pacerPacketCount = 0; // Pacer owns all packet data now
         } else {
@@ -528,6 +503,52 @@ STATUS writeFrame(PRtcRtpTransceiver pRtcRtpTransceiver, PFrame pFrame)
         }
     }
 
+    // No pacing - send the frame immediately, one batched send per SOCKET_SEND_BATCH_MAX_PACKETS packets
+    for (i = 0; !useBatchPacing && i < pacerPacketCount; i += batchCount) {
+        batchCount = MIN(pacerPacketCount - i, SOCKET_SEND_BATCH_MAX_PACKETS);
+        for (j = 0; j < batchCount; j++) {
+            sendBuffers[j] = pPacerPackets[i + j].pData;
+            sendBufferLens[j] = pPacerPackets[i + j].size;
+        }
+
+        // Only the leading sentCount packets left, the rest of the batch is discarded
+        sentCount = 0;
+        sendStatus = iceAgentSendPackets(pKvsPeerConnection->pIceAgent, sendBuffers, sendBufferLens, batchCount, &sentCount);
+        sentTime = GETTIME();
+        lastPacketSentTimestamp = KVS_CONVERT_TIMESCALE(sentTime, HUNDREDS_OF_NANOS_IN_A_SECOND, 1000);
+
+        for (j = 0; j < batchCount; j++) {
+            pRtpPacket = pPacketList + i + j;
+            packetLen = pPacerPackets[i + j].size;
+            headerLen = RTP_HEADER_LEN(pRtpPacket);
+            if (j >= sentCount) {
+                packetsDiscardedOnSend++;
+                bytesDiscardedOnSend += packetLen - headerLen;
+                // TODO is frame considered discarded when at least one of its packets is discarded or all of its packets discarded?
+                framesDiscardedOnSend = 1;
+            } else {
+                if (pKvsPeerConnection->twccExtId != 0) {
+                    // The extension payload was overwritten by later packets of the frame, rebuild it from the recorded sequence number
+                    extpayload = TWCC_PAYLOAD(pKvsPeerConnection->twccExtId, pPacerPackets[i + j].twccSeqNum);
+                    pRtpPacket->header.extensionPayload = (PBYTE) &extpayload;
+                    pRtpPacket->sentTime = sentTime;
+                    twccManagerOnPacketSent(pKvsPeerConnection, pRtpPacket);
+                }
+
+                // https://tools.ietf.org/html/rfc3550#section-6.4.1
+                // The total number of payload octets (i.e., not including header or padding) transmitted in RTP data packets by the sender
+                bytesSent += packetLen - headerLen;
+                packetsSent++;
+                headerBytesSent += headerLen;
+            }
+
+            packetPoolFree(pKvsPeerConnection->pOutboundPacketPool, pPacerPackets[i + j].pData);
+            pPacerPackets[i + j].pData = NULL;
+        }
+
+        CHK_STATUS(sendStatus);
+    }
+
     if (MEDIA_STREAM_TRACK_KIND_VIDEO == pKvsRtpTransceiver->sender.track.kind) {
         framesSent++;
     }
@@ -574,12 +595,12 @@ CleanUp:
     // Free un-enqueued pacer packets (if we jumped to CleanUp before batch enqueue)
     if (pPacerPackets != NULL) {
         for (i = 0; i < pacerPacketCount; i++) {
-            SAFE_MEMFREE(pPacerPackets[i].pData);
+            packetPoolFree(pKvsPeerConnection->pOutboundPacketPool, pPacerPackets[i].pData);
         }
     }
-    SAFE_MEMFREE(pPacerPackets);
-    SAFE_MEMFREE(rawPacket);
-    SAFE_MEMFREE(pPacketList);
+    if (rawPacket != NULL) {
+        packetPoolFree(pKvsPeerConnection->pOutboundPacketPool, rawPacket);
+    }
     if (retStatus != STATUS_SRTP_NOT_READY_YET) {
         CHK_LOG_ERR(retStatus);
     }
@@ -587,7 +608,7 @@ CleanUp:
     return retStatus;
 }
 
-STATUS writeRtpPacket(PKvsPeerConnection pKvsPeerConnection, PRtpPacket pRtpPacket)
+STATUS writeRtpPacket(PKvsPeerConnection pKvsPeerConnection, PRtpPacket pRtpPacket, PACER_PRIORITY priority)
 {
     STATUS retStatus = STATUS_SUCCESS;
     BOOL locked = FALSE;
@@ -598,8 +619,10 @@ STATUS writeRtpPacket(PKvsPeerConnection pKvsPeerConnection, PRtpPacket pRtpPack
 
     MUTEX_LOCK(pKvsPeerConnection->pSrtpSessionLock);
     locked = TRUE;
-    CHK(pKvsPeerConnection->pSrtpSession != NULL, STATUS_SUCCESS);               // Discard packets till SRTP is ready
-    pRawPacket = MEMALLOC(pRtpPacket->rawPacketLength + SRTP_AUTH_TAG_OVERHEAD); // For SRTP authentication tag
+    CHK(pKvsPeerConnection->pSrtpSession != NULL, STATUS_SUCCESS); // Discard packets till SRTP is ready
+    // Extra room for the SRTP authentication tag
+    pRawPacket = packetPoolAlloc(pKvsPeerConnection->pOutboundPacketPool, pRtpPacket->rawPacketLength + SRTP_AUTH_TAG_OVERHEAD);
+    CHK(pRawPacket != NULL, STATUS_NOT_ENOUGH_MEMORY);
     rawLen = pRtpPacket->rawPacketLength;
     MEMCPY(pRawPacket, pRtpPacket->pRawPacket, pRtpPacket->rawPacketLength);
 
@@ -609,13 +632,22 @@ STATUS writeRtpPacket(PKvsPeerConnection pKvsPeerConnection, PRtpPacket pRtpPack
     }
 
     CHK_STATUS(encryptRtpPacket(pKvsPeerConnection->pSrtpSession, pRawPacket, &rawLen));
-    CHK_STATUS(iceAgentSendPacket(pKvsPeerConnection->pIceAgent, pRawPacket, rawLen));
+    if (pKvsPeerConnection->pPacer != NULL && pacerIsEnabled(pKvsPeerConnection->pPacer)) {
+        // The pacer owns the buffer from here on, even when the queue is full
+        retStatus = pacerEnqueuePacket(pKvsPeerConnection->pPacer, priority, pRawPacket, rawLen, 0);
+        pRawPacket = NULL;
+        CHK_STATUS(retStatus);
+    } else {
+        CHK_STATUS(iceAgentSendPacket(pKvsPeerConnection->pIceAgent, pRawPacket, rawLen));
+    }
 
 CleanUp:
     if (locked) {
         MUTEX_UNLOCK(pKvsPeerConnection->pSrtpSessionLock);
     }
-    SAFE_MEMFREE(pRawPacket);
+    if (pRawPacket != NULL) {
+        packetPoolFree(pKvsPeerConnection->pOutboundPacketPool, pRawPacket);
+    }
 
     return retStatus;
 }
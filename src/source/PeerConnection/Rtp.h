@@ -22,6 +22,15 @@ extern "C" {
 #define MAX_ROLLING_BUFFER_DURATION_IN_SECONDS     (DOUBLE) 10
 #define MAX_EXPECTED_BIT_RATE                      (DOUBLE)(240 * 1024 * 1024) // Considering 1Kib = 1024 bits
 
+// Room for the RTP header on top of an MTU sized payload: fixed header, CSRCs and the TWCC header extension
+#define RTP_MAX_HEADER_OVERHEAD 96
+
+// Size of a send path packet buffer for the given MTU, including the SRTP authentication tag
+#define OUTBOUND_PACKET_BUFFER_SIZE(mtu) ((mtu) + RTP_MAX_HEADER_OVERHEAD + SRTP_AUTH_TAG_OVERHEAD)
+
+// Number of preallocated send path packet buffers per peer connection when KvsRtcConfiguration leaves it as 0
+#define DEFAULT_OUTBOUND_PACKET_POOL_SIZE 512
+
 // https://www.w3.org/TR/webrtc-stats/#dom-rtcoutboundrtpstreamstats-huge
 // Huge frames, by definition, are frames that have an encoded size at least 2.5 times the average size of the frames.
 #define HUGE_FRAME_MULTIPLIER 2.5
@@ -40,7 +49,13 @@ typedef struct {
     UINT16 rtxSequenceNumber;
     UINT32 ssrc;
     UINT32 rtxSsrc;
-    PayloadArray payloadArray;
+
+    // Per-frame scratch reused across writeFrame calls, grown on demand
+    PayloadDescriptorArray payloadDescriptors;
+    PRtpPacket pPacketList;
+    UINT32 packetListCapacity;
+    PPacerPacketInfo pPacerPackets;
+    UINT32 pacerPacketsCapacity;
 
     RtcMediaStreamTrack track;
     PRtpRollingBuffer packetBuffer;
@@ -84,6 +99,15 @@ typedef struct {
     UINT64 onPartialFrameCustomData;
     RtcOnFrame onPartialFrame;
 
+    // Zero-copy delivery of complete frames, takes over from onFrame when set
+    UINT64 onFrameFragmentsCustomData;
+    RtcOnFrameFragments onFrameFragments;
+    DepayRtpPayloadFragmentsFunc depayFragmentsFn;
+    PRtcFrameFragment pFrameFragments;
+    UINT32 frameFragmentsCapacity;
+    PBYTE pFrameFragmentsBackup; // DEPAY_FRAGMENTS_REWRITE_SIZE bytes per packet, put back if the frame can't be delivered
+    UINT32 frameFragmentsBackupCapacity;
+
     UINT64 onBandwidthEstimationCustomData;
     RtcOnBandwidthEstimation onBandwidthEstimation;
     UINT64 onPictureLossCustomData;
@@ -142,7 +166,8 @@ STATUS kvsRtpTransceiverSetJitterBuffer(PKvsRtpTransceiver, PJitterBuffer);
 
 #define CONVERT_TIMESTAMP_TO_RTP CONVERT_TIMESTAMP_TO_RTP_PRECISE
 
-STATUS writeRtpPacket(PKvsPeerConnection pKvsPeerConnection, PRtpPacket pRtpPacket);
+// Encrypts and sends a single packet, through the pacer at the given priority when pacing is enabled
+STATUS writeRtpPacket(PKvsPeerConnection pKvsPeerConnection, PRtpPacket pRtpPacket, PACER_PRIORITY priority);
 
 STATUS hasTransceiverWithSsrc(PKvsPeerConnection pKvsPeerConnection, UINT32 ssrc);
 STATUS findTransceiverBySsrc(PKvsPeerConnection pKvsPeerConnection, PKvsRtpTransceiver* ppTransceiver, UINT32 ssrc);
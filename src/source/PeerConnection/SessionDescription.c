@@ -192,7 +192,7 @@ STATUS setPayloadTypesFromOffer(PHashTable codecTable, PHashTable rtxTable, PHas
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     PSdpMediaDescription pMediaDescription = NULL;
-    UINT8 currentAttribute;
+    UINT16 currentAttribute;
     UINT16 currentMedia;
     PCHAR attributeValue, end;
     UINT64 parsedPayloadType, hashmapPayloadType, fmtpVal, aptVal;
@@ -370,6 +370,7 @@ STATUS setTransceiverPayloadTypes(PHashTable codecTable, PHashTable rtxTable, PH
     UINT64 redPt = 0;
     UINT64 opusPt = 0;
     BOOL redNegotiated = FALSE;
+    UINT32 mtu;
 
     if (redTable != NULL && STATUS_SUCCEEDED(hashTableGet(redTable, RTC_RED_CODEC_OPUS, &redPt)) && redPt != 0 &&
         STATUS_SUCCEEDED(hashTableGet(codecTable, RTC_CODEC_OPUS, &opusPt)) && opusPt != 0) {
@@ -427,7 +428,9 @@ STATUS setTransceiverPayloadTypes(PHashTable codecTable, PHashTable rtxTable, PH
                                                      pKvsRtpTransceiver->pRollingBufferConfig->rollingBufferBitratebps / 8 / DEFAULT_MTU_SIZE_BYTES);
 
             DLOGI("The rolling buffer is configured to store %" PRIu64 " packets", rollingBufferCapacity);
-            CHK_STATUS(createRtpRollingBuffer(rollingBufferCapacity, &pKvsRtpTransceiver->sender.packetBuffer));
+            // Packet copies are sized for what the packetizer produces at the connection MTU
+            mtu = pKvsRtpTransceiver->pKvsPeerConnection != NULL ? pKvsRtpTransceiver->pKvsPeerConnection->MTU : DEFAULT_MTU_SIZE_BYTES;
+            CHK_STATUS(createRtpRollingBuffer(rollingBufferCapacity, mtu, &pKvsRtpTransceiver->sender.packetBuffer));
             CHK_STATUS(createRetransmitter(DEFAULT_SEQ_NUM_BUFFER_SIZE, DEFAULT_VALID_INDEX_BUFFER_SIZE, &pKvsRtpTransceiver->sender.retransmitter));
         }
     }
@@ -529,21 +532,13 @@ UINT64 getH264FmtpScore(PCHAR fmtp)
     return score;
 }
 
-// Append a formatted SDP attribute. Expects these locals in the enclosing function:
-//   pSdpMediaDescription (PSdpMediaDescription), attributeCount (UINT32), amountWritten (INT32).
-// name and fmt must be string literals so the error message can concatenate them at compile time.
-#define APPEND_SDP_ATTR(name, fmt, ...)                                                                                                              \
-    do {                                                                                                                                             \
-        STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, (name));                                                           \
-        amountWritten = SNPRINTF(pSdpMediaDescription->sdpAttributes[attributeCount].attributeValue,                                                 \
-                                 SIZEOF(pSdpMediaDescription->sdpAttributes[attributeCount].attributeValue), fmt, __VA_ARGS__);                      \
-        CHK_ERR(amountWritten > 0, STATUS_INTERNAL_ERROR, "Failed writing SDP attr: " name " = " fmt);                                               \
-        attributeCount++;                                                                                                                            \
-    } while (0)
-
-// Populate a single media section from a PKvsRtpTransceiver
+// Append a formatted SDP attribute. Expects pLocalSessionDescription (PSessionDescription) and
+// pSdpMediaDescription (PSdpMediaDescription) locals in the enclosing function.
+#define APPEND_SDP_ATTR(name, fmt, ...) CHK_STATUS(sdpAppendAttributeFormat(pLocalSessionDescription, pSdpMediaDescription, (name), fmt, __VA_ARGS__))
+
+// Populate a single media section, appended to pLocalSessionDescription, from a PKvsRtpTransceiver
 STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtpTransceiver pKvsRtpTransceiver,
-                                  PSdpMediaDescription pSdpMediaDescription, PSessionDescription pRemoteSessionDescription,
+                                  PSessionDescription pLocalSessionDescription, PSessionDescription pRemoteSessionDescription,
                                   PCHAR pCertificateFingerprint, UINT32 mediaSectionId, PCHAR pDtlsRole, PHashTable pUnknownCodecPayloadTypesTable,
                                   PHashTable pUnknownCodecRtpmapTable, UINT32 unknownCodecHashTableKey)
 {
@@ -551,19 +546,16 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
     STATUS retStatus = STATUS_SUCCESS;
     UINT64 payloadType, rtxPayloadType, rtpMapValueRaw;
     BOOL containRtx = FALSE;
-    BOOL directionFound = FALSE;
-    UINT32 i, remoteAttributeCount, attributeCount = 0;
-    PSdpMediaDescription pSdpMediaDescriptionRemote;
-    PCHAR currentFmtp = NULL, rtpMapValue = NULL;
-    CHAR remoteSdpAttributeValue[MAX_SDP_ATTRIBUTE_VALUE_LENGTH];
-    INT32 amountWritten = 0;
+    UINT32 i, remoteAttributeCount;
+    PSdpMediaDescription pSdpMediaDescription = NULL, pSdpMediaDescriptionRemote;
+    PCHAR currentFmtp = NULL, rtpMapValue = NULL, remoteMid = NULL, direction = NULL;
 
     CHK(pKvsRtpTransceiver != NULL, STATUS_NULL_ARG);
     CHK(pKvsPeerConnection->isOffer || pRemoteSessionDescription != NULL, STATUS_NULL_ARG);
 
     PRtcMediaStreamTrack pRtcMediaStreamTrack = &(pKvsRtpTransceiver->sender.track);
 
-    MEMSET(remoteSdpAttributeValue, 0, MAX_SDP_ATTRIBUTE_VALUE_LENGTH);
+    CHK_STATUS(sdpAppendMediaDescription(pLocalSessionDescription, &pSdpMediaDescription));
 
     if (pRtcMediaStreamTrack->codec == RTC_CODEC_UNKNOWN && pUnknownCodecPayloadTypesTable != NULL) {
         CHK_STATUS(hashTableGet(pUnknownCodecPayloadTypesTable, unknownCodecHashTableKey, &payloadType));
@@ -589,13 +581,10 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
         containRtx = (retStatus == STATUS_SUCCESS);
         retStatus = STATUS_SUCCESS;
         if (containRtx) {
-            amountWritten = SNPRINTF(pSdpMediaDescription->mediaName, SIZEOF(pSdpMediaDescription->mediaName),
-                                     "video 9 UDP/TLS/RTP/SAVPF %" PRId64 " %" PRId64, payloadType, rtxPayloadType);
-            CHK_ERR(amountWritten > 0, STATUS_INTERNAL_ERROR, "Full video (with rtx) media name attribute could not be written");
+            CHK_STATUS(sdpArenaFormat(pLocalSessionDescription, &pSdpMediaDescription->mediaName, "video 9 UDP/TLS/RTP/SAVPF %" PRId64 " %" PRId64,
+                                      payloadType, rtxPayloadType));
         } else {
-            amountWritten =
-                SNPRINTF(pSdpMediaDescription->mediaName, SIZEOF(pSdpMediaDescription->mediaName), "video 9 UDP/TLS/RTP/SAVPF %" PRId64, payloadType);
-            CHK_ERR(amountWritten > 0, STATUS_INTERNAL_ERROR, "Full video media name attribute could not be written");
+            CHK_STATUS(sdpArenaFormat(pLocalSessionDescription, &pSdpMediaDescription->mediaName, "video 9 UDP/TLS/RTP/SAVPF %" PRId64, payloadType));
         }
     } else if (pRtcMediaStreamTrack->kind == MEDIA_STREAM_TRACK_KIND_AUDIO) {
         // If RED was negotiated for Opus, advertise both PTs with RED first (so the peer
@@ -604,17 +593,14 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
         BOOL emitRed = (pRtcMediaStreamTrack->codec == RTC_CODEC_OPUS && pKvsPeerConnection->pRedTable != NULL &&
                         STATUS_SUCCEEDED(hashTableGet(pKvsPeerConnection->pRedTable, RTC_RED_CODEC_OPUS, &redPt)) && redPt != 0);
         if (emitRed) {
-            amountWritten = SNPRINTF(pSdpMediaDescription->mediaName, SIZEOF(pSdpMediaDescription->mediaName),
-                                     "audio 9 UDP/TLS/RTP/SAVPF %" PRId64 " %" PRId64, redPt, payloadType);
+            CHK_STATUS(sdpArenaFormat(pLocalSessionDescription, &pSdpMediaDescription->mediaName, "audio 9 UDP/TLS/RTP/SAVPF %" PRId64 " %" PRId64,
+                                      redPt, payloadType));
         } else {
-            amountWritten =
-                SNPRINTF(pSdpMediaDescription->mediaName, SIZEOF(pSdpMediaDescription->mediaName), "audio 9 UDP/TLS/RTP/SAVPF %" PRId64, payloadType);
+            CHK_STATUS(sdpArenaFormat(pLocalSessionDescription, &pSdpMediaDescription->mediaName, "audio 9 UDP/TLS/RTP/SAVPF %" PRId64, payloadType));
         }
-        CHK_ERR(amountWritten > 0, STATUS_INTERNAL_ERROR, "Full audio media name attribute could not be written");
     }
 
-    CHK_STATUS(iceAgentPopulateSdpMediaDescriptionCandidates(pKvsPeerConnection->pIceAgent, pSdpMediaDescription, MAX_SDP_ATTRIBUTE_VALUE_LENGTH,
-                                                             &attributeCount));
+    CHK_STATUS(iceAgentPopulateSdpMediaDescriptionCandidates(pKvsPeerConnection->pIceAgent, pLocalSessionDescription, pSdpMediaDescription));
 
     if (containRtx) {
         APPEND_SDP_ATTR("msid", "%s %sRTX", pRtcMediaStreamTrack->streamId, pRtcMediaStreamTrack->trackId);
@@ -648,10 +634,10 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
     APPEND_SDP_ATTR("setup", "%s", pDtlsRole);
 
     if (!pKvsPeerConnection->isOffer) {
-        // check all session attribute lines to see if a line with mid is present. If it is present, copy its content and break
+        // check all session attribute lines to see if a line with mid is present. If it is present, keep its content and break
         for (i = 0; i < pRemoteSessionDescription->mediaDescriptions[mediaSectionId].mediaAttributesCount; i++) {
             if (STRCMP(pRemoteSessionDescription->mediaDescriptions[mediaSectionId].sdpAttributes[i].attributeName, MID_KEY) == 0) {
-                STRCPY(remoteSdpAttributeValue, pRemoteSessionDescription->mediaDescriptions[mediaSectionId].sdpAttributes[i].attributeValue);
+                remoteMid = pRemoteSessionDescription->mediaDescriptions[mediaSectionId].sdpAttributes[i].attributeValue;
                 break;
             }
         }
@@ -659,9 +645,8 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
 
     // check if we already have a value for the "mid" session attribute from remote description. If we have it, we use it.
     // If we don't have it, we loop over, create and add them
-    if (STRLEN(remoteSdpAttributeValue) > 0) {
-        CHK(STRLEN(remoteSdpAttributeValue) < MAX_SDP_ATTRIBUTE_VALUE_LENGTH, STATUS_BUFFER_TOO_SMALL);
-        APPEND_SDP_ATTR("mid", "%s", remoteSdpAttributeValue);
+    if (remoteMid != NULL && remoteMid[0] != '\0') {
+        APPEND_SDP_ATTR("mid", "%s", remoteMid);
     } else {
         APPEND_SDP_ATTR("mid", "%d", mediaSectionId);
     }
@@ -669,18 +654,18 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
     if (pKvsPeerConnection->isOffer) {
         switch (pKvsRtpTransceiver->transceiver.direction) {
             case RTC_RTP_TRANSCEIVER_DIRECTION_SENDRECV:
-                STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "sendrecv");
+                direction = "sendrecv";
                 break;
             case RTC_RTP_TRANSCEIVER_DIRECTION_SENDONLY:
-                STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "sendonly");
+                direction = "sendonly";
                 break;
             case RTC_RTP_TRANSCEIVER_DIRECTION_RECVONLY:
-                STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "recvonly");
+                direction = "recvonly";
                 break;
             default:
                 // https://www.w3.org/TR/webrtc/#dom-rtcrtptransceiverdirection
                 DLOGW("Incorrect/no transceiver direction set...this attribute will be set to inactive");
-                STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "inactive");
+                direction = "inactive";
         }
     } else {
         pSdpMediaDescriptionRemote = &pRemoteSessionDescription->mediaDescriptions[mediaSectionId];
@@ -688,30 +673,27 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
 
         // in case of a missing m-line, we respond with the same m-line but direction set to inactive
         if (pKvsRtpTransceiver->transceiver.direction == RTC_RTP_TRANSCEIVER_DIRECTION_INACTIVE) {
-            STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "inactive");
-            directionFound = TRUE;
+            direction = "inactive";
         }
-        for (i = 0; i < remoteAttributeCount && directionFound == FALSE; i++) {
+        for (i = 0; i < remoteAttributeCount && direction == NULL; i++) {
             if (STRCMP(pSdpMediaDescriptionRemote->sdpAttributes[i].attributeName, "sendrecv") == 0) {
-                STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "sendrecv");
-                directionFound = TRUE;
+                direction = "sendrecv";
             } else if (STRCMP(pSdpMediaDescriptionRemote->sdpAttributes[i].attributeName, "recvonly") == 0) {
-                STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "sendonly");
-                directionFound = TRUE;
+                direction = "sendonly";
             } else if (STRCMP(pSdpMediaDescriptionRemote->sdpAttributes[i].attributeName, "sendonly") == 0) {
-                STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "recvonly");
-                directionFound = TRUE;
+                direction = "recvonly";
             }
         }
     }
 
-    attributeCount++;
+    // Without a direction in the remote media section there is nothing to answer with, the default sendrecv applies
+    if (direction != NULL) {
+        CHK_STATUS(sdpAppendAttribute(pLocalSessionDescription, pSdpMediaDescription, direction, NULL));
+    }
 
-    STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "rtcp-mux");
-    attributeCount++;
+    CHK_STATUS(sdpAppendAttribute(pLocalSessionDescription, pSdpMediaDescription, "rtcp-mux", NULL));
     if (mediaSectionId != 0) {
-        STRCPY(pSdpMediaDescription->sdpAttributes[attributeCount].attributeName, "rtcp-rsize");
-        attributeCount++;
+        CHK_STATUS(sdpAppendAttribute(pLocalSessionDescription, pSdpMediaDescription, "rtcp-rsize", NULL));
     }
 
     if (pRtcMediaStreamTrack->codec == RTC_CODEC_H264_PROFILE_42E01F_LEVEL_ASYMMETRY_ALLOWED_PACKETIZATION_MODE) {
@@ -802,28 +784,23 @@ STATUS populateSingleMediaSection(PKvsPeerConnection pKvsPeerConnection, PKvsRtp
         APPEND_SDP_ATTR("extmap", "%u %s", pKvsPeerConnection->twccExtId, TWCC_EXT_URL);
     }
 
-    pSdpMediaDescription->mediaAttributesCount = attributeCount;
-
 CleanUp:
 
     LEAVES();
     return retStatus;
 }
 
-STATUS populateSessionDescriptionDataChannel(PKvsPeerConnection pKvsPeerConnection, PSdpMediaDescription pSdpMediaDescription,
+STATUS populateSessionDescriptionDataChannel(PKvsPeerConnection pKvsPeerConnection, PSessionDescription pLocalSessionDescription,
                                              PCHAR pCertificateFingerprint, UINT32 mediaSectionId, PCHAR pDtlsRole)
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    UINT32 attributeCount = 0;
-    INT32 amountWritten = 0;
+    PSdpMediaDescription pSdpMediaDescription = NULL;
 
-    amountWritten =
-        SNPRINTF(pSdpMediaDescription->mediaName, SIZEOF(pSdpMediaDescription->mediaName), "application 9 UDP/DTLS/SCTP webrtc-datachannel");
-    CHK_ERR(amountWritten > 0, STATUS_INTERNAL_ERROR, "Full data channel media name could not be written");
+    CHK_STATUS(sdpAppendMediaDescription(pLocalSessionDescription, &pSdpMediaDescription));
+    pSdpMediaDescription->mediaName = "application 9 UDP/DTLS/SCTP webrtc-datachannel";
 
-    CHK_STATUS(iceAgentPopulateSdpMediaDescriptionCandidates(pKvsPeerConnection->pIceAgent, pSdpMediaDescription, MAX_SDP_ATTRIBUTE_VALUE_LENGTH,
-                                                             &attributeCount));
+    CHK_STATUS(iceAgentPopulateSdpMediaDescriptionCandidates(pKvsPeerConnection->pIceAgent, pLocalSessionDescription, pSdpMediaDescription));
 
     APPEND_SDP_ATTR("rtcp", "%s", "9 IN IP4 0.0.0.0");
     APPEND_SDP_ATTR("ice-ufrag", "%s", pKvsPeerConnection->localIceUfrag);
@@ -837,8 +814,10 @@ STATUS populateSessionDescriptionDataChannel(PKvsPeerConnection pKvsPeerConnecti
     APPEND_SDP_ATTR("setup", "%s", pDtlsRole);
     APPEND_SDP_ATTR("mid", "%d", mediaSectionId);
     APPEND_SDP_ATTR("sctp-port", "%s", "5000");
-
-    pSdpMediaDescription->mediaAttributesCount = attributeCount;
+#ifdef ENABLE_NATIVE_SCTP
+    // Only the native stack enforces the limit on incoming messages
+    APPEND_SDP_ATTR("max-message-size", "%u", pKvsPeerConnection->sctpMaxMessageSize);
+#endif
 
 CleanUp:
 
@@ -911,13 +890,10 @@ STATUS populateSessionDescriptionMedia(PKvsPeerConnection pKvsPeerConnection, PS
             pCurNode = pCurNode->pNext;
             pKvsRtpTransceiver = (PKvsRtpTransceiver) data;
             if (pKvsRtpTransceiver != NULL) {
-                CHK(pLocalSessionDescription->mediaCount < MAX_SDP_SESSION_MEDIA_COUNT, STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT);
                 // If generating answer, need to check if Local Description is present in remote -- if not, we don't need to create a local
                 // description for it or else our Answer will have an extra m-line, for offer the local is the offer itself, don't care about remote
-                CHK_STATUS(populateSingleMediaSection(
-                    pKvsPeerConnection, pKvsRtpTransceiver, &(pLocalSessionDescription->mediaDescriptions[pLocalSessionDescription->mediaCount]),
-                    pRemoteSessionDescription, certificateFingerprint, pLocalSessionDescription->mediaCount, pDtlsRole, NULL, NULL, 0));
-                pLocalSessionDescription->mediaCount++;
+                CHK_STATUS(populateSingleMediaSection(pKvsPeerConnection, pKvsRtpTransceiver, pLocalSessionDescription, pRemoteSessionDescription,
+                                                      certificateFingerprint, pLocalSessionDescription->mediaCount, pDtlsRole, NULL, NULL, 0));
             }
         }
     } else {
@@ -940,11 +916,9 @@ STATUS populateSessionDescriptionMedia(PKvsPeerConnection pKvsPeerConnection, PS
             pCurNode = pCurNode->pNext;
             pKvsRtpTransceiver = (PKvsRtpTransceiver) data;
             if (pKvsRtpTransceiver != NULL) {
-                CHK(pLocalSessionDescription->mediaCount < MAX_SDP_SESSION_MEDIA_COUNT, STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT);
                 if (isPresentInRemote(pKvsRtpTransceiver, pRemoteSessionDescription)) {
                     if (pKvsRtpTransceiver->sender.track.codec == RTC_CODEC_UNKNOWN) {
-                        CHK_STATUS(populateSingleMediaSection(pKvsPeerConnection, pKvsRtpTransceiver,
-                                                              &(pLocalSessionDescription->mediaDescriptions[pLocalSessionDescription->mediaCount]),
+                        CHK_STATUS(populateSingleMediaSection(pKvsPeerConnection, pKvsRtpTransceiver, pLocalSessionDescription,
                                                               pRemoteSessionDescription, certificateFingerprint, pLocalSessionDescription->mediaCount,
                                                               pDtlsRole, pUnknownCodecPayloadTypesTable, pUnknownCodecRtpmapTable,
                                                               unknownCodecHashTableKey));
@@ -955,23 +929,18 @@ STATUS populateSessionDescriptionMedia(PKvsPeerConnection pKvsPeerConnection, PS
                     } else {
                         // in case of a user-added transceiver, the pUnknownCodecPayloadTypesTable, pUnknownCodecRtpmapTable are not populated by
                         // the function findTransceiversByRemoteDescription and are NULL
-                        CHK_STATUS(populateSingleMediaSection(pKvsPeerConnection, pKvsRtpTransceiver,
-                                                              &(pLocalSessionDescription->mediaDescriptions[pLocalSessionDescription->mediaCount]),
+                        CHK_STATUS(populateSingleMediaSection(pKvsPeerConnection, pKvsRtpTransceiver, pLocalSessionDescription,
                                                               pRemoteSessionDescription, certificateFingerprint, pLocalSessionDescription->mediaCount,
                                                               pDtlsRole, NULL, NULL, 0));
                     }
-                    pLocalSessionDescription->mediaCount++;
                 }
             }
         }
     }
 
     if (ATOMIC_LOAD_BOOL(&pKvsPeerConnection->sctpIsEnabled)) {
-        CHK(pLocalSessionDescription->mediaCount < MAX_SDP_SESSION_MEDIA_COUNT, STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT);
-        CHK_STATUS(populateSessionDescriptionDataChannel(pKvsPeerConnection,
-                                                         &(pLocalSessionDescription->mediaDescriptions[pLocalSessionDescription->mediaCount]),
-                                                         certificateFingerprint, pLocalSessionDescription->mediaCount, pDtlsRole));
-        pLocalSessionDescription->mediaCount++;
+        CHK_STATUS(populateSessionDescriptionDataChannel(pKvsPeerConnection, pLocalSessionDescription, certificateFingerprint,
+                                                         pLocalSessionDescription->mediaCount, pDtlsRole));
     }
 
 CleanUp:
@@ -993,19 +962,14 @@ STATUS populateSessionDescription(PKvsPeerConnection pKvsPeerConnection, PSessio
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    CHAR bundleValue[MAX_SDP_ATTRIBUTE_VALUE_LENGTH], wmsValue[MAX_SDP_ATTRIBUTE_VALUE_LENGTH],
-        remoteSdpAttributeValue[MAX_SDP_ATTRIBUTE_VALUE_LENGTH];
-    PCHAR curr = NULL;
-    UINT32 i, sizeRemaining;
+    PCHAR curr = NULL, bundleValue = NULL, remoteBundleValue = NULL;
+    UINT32 i, sizeRemaining, bundleValueSize;
     INT32 charsCopied;
 
     CHK(pKvsPeerConnection != NULL && pLocalSessionDescription != NULL, STATUS_NULL_ARG);
     CHK(pKvsPeerConnection->isOffer || pRemoteSessionDescription != NULL, STATUS_NULL_ARG);
 
     CHK_STATUS(populateSessionDescriptionMedia(pKvsPeerConnection, pRemoteSessionDescription, pLocalSessionDescription));
-    MEMSET(bundleValue, 0, MAX_SDP_ATTRIBUTE_VALUE_LENGTH);
-    MEMSET(wmsValue, 0, MAX_SDP_ATTRIBUTE_VALUE_LENGTH);
-    MEMSET(remoteSdpAttributeValue, 0, MAX_SDP_ATTRIBUTE_VALUE_LENGTH);
     STRCPY(pLocalSessionDescription->sdpOrigin.userName, "-");
     pLocalSessionDescription->sdpOrigin.sessionId = RAND();
     pLocalSessionDescription->sdpOrigin.sessionVersion = 2;
@@ -1013,32 +977,17 @@ STATUS populateSessionDescription(PKvsPeerConnection pKvsPeerConnection, PSessio
     STRCPY(pLocalSessionDescription->sdpOrigin.sdpConnectionInformation.addressType, "IP4");
     STRCPY(pLocalSessionDescription->sdpOrigin.sdpConnectionInformation.connectionAddress, "127.0.0.1");
 
-    STRCPY(pLocalSessionDescription->sessionName, "-");
+    pLocalSessionDescription->sessionName = "-";
 
     pLocalSessionDescription->timeDescriptionCount = 1;
     pLocalSessionDescription->sdpTimeDescription[0].startTime = 0;
     pLocalSessionDescription->sdpTimeDescription[0].stopTime = 0;
 
-    STRCPY(pLocalSessionDescription->sdpAttributes[0].attributeName, "group");
-    STRCPY(pLocalSessionDescription->sdpAttributes[0].attributeValue, BUNDLE_KEY);
-    pLocalSessionDescription->sessionAttributesCount++;
-    if (pKvsPeerConnection->canTrickleIce.value) {
-        STRCPY(pLocalSessionDescription->sdpAttributes[pLocalSessionDescription->sessionAttributesCount].attributeName, "ice-options");
-        STRCPY(pLocalSessionDescription->sdpAttributes[pLocalSessionDescription->sessionAttributesCount].attributeValue, "trickle");
-        pLocalSessionDescription->sessionAttributesCount++;
-    }
-
-    if (pKvsPeerConnection->pIceAgent->isLiteAgent) {
-        STRCPY(pLocalSessionDescription->sdpAttributes[pLocalSessionDescription->sessionAttributesCount].attributeName, "ice-lite");
-        pLocalSessionDescription->sdpAttributes[pLocalSessionDescription->sessionAttributesCount].attributeValue[0] = '\0';
-        pLocalSessionDescription->sessionAttributesCount++;
-    }
-
-    // check all session attribute lines to see if a line with BUNDLE is present. If it is present, copy its content and break
+    // check all session attribute lines to see if a line with BUNDLE is present. If it is present, keep its content and break
     if (!pKvsPeerConnection->isOffer) {
         for (i = 0; i < pRemoteSessionDescription->sessionAttributesCount; i++) {
             if (STRSTR(pRemoteSessionDescription->sdpAttributes[i].attributeValue, BUNDLE_KEY) != NULL) {
-                STRCPY(remoteSdpAttributeValue, pRemoteSessionDescription->sdpAttributes[i].attributeValue + ARRAY_SIZE(BUNDLE_KEY) - 1);
+                remoteBundleValue = pRemoteSessionDescription->sdpAttributes[i].attributeValue + ARRAY_SIZE(BUNDLE_KEY) - 1;
                 break;
             }
         }
@@ -1046,13 +995,14 @@ STATUS populateSessionDescription(PKvsPeerConnection pKvsPeerConnection, PSessio
 
     // check if we already have a value for the "group" session attribute from remote description. If we have it, we use it.
     // If we don't have it, we loop over, create and add them
-    if (STRLEN(remoteSdpAttributeValue) > 0) {
-        CHK(STRLEN(remoteSdpAttributeValue) < MAX_SDP_ATTRIBUTE_VALUE_LENGTH, STATUS_BUFFER_TOO_SMALL);
-        STRCAT(pLocalSessionDescription->sdpAttributes[0].attributeValue, remoteSdpAttributeValue);
+    if (remoteBundleValue != NULL && remoteBundleValue[0] != '\0') {
+        CHK_STATUS(sdpArenaFormat(pLocalSessionDescription, &bundleValue, BUNDLE_KEY "%s", remoteBundleValue));
     } else {
-        for (curr = (pLocalSessionDescription->sdpAttributes[0].attributeValue + ARRAY_SIZE(BUNDLE_KEY) - 1), i = 0;
-             i < pLocalSessionDescription->mediaCount; i++) {
-            sizeRemaining = MAX_SDP_ATTRIBUTE_VALUE_LENGTH - (curr - pLocalSessionDescription->sdpAttributes[0].attributeValue);
+        bundleValueSize = ARRAY_SIZE(BUNDLE_KEY) + pLocalSessionDescription->mediaCount * (ARRAY_SIZE(" 65535") - 1);
+        CHK_STATUS(sdpArenaAlloc(pLocalSessionDescription, bundleValueSize, (PVOID*) &bundleValue));
+        STRCPY(bundleValue, BUNDLE_KEY);
+        for (curr = (bundleValue + ARRAY_SIZE(BUNDLE_KEY) - 1), i = 0; i < pLocalSessionDescription->mediaCount; i++) {
+            sizeRemaining = bundleValueSize - (curr - bundleValue);
             charsCopied = SNPRINTF(curr, sizeRemaining, " %d", i);
 
             CHK(charsCopied > 0 && (UINT32) charsCopied < sizeRemaining, STATUS_BUFFER_TOO_SMALL);
@@ -1061,15 +1011,22 @@ STATUS populateSessionDescription(PKvsPeerConnection pKvsPeerConnection, PSessio
         }
     }
 
+    CHK_STATUS(sdpAppendAttribute(pLocalSessionDescription, NULL, "group", bundleValue));
+    if (pKvsPeerConnection->canTrickleIce.value) {
+        CHK_STATUS(sdpAppendAttribute(pLocalSessionDescription, NULL, "ice-options", "trickle"));
+    }
+
+    if (pKvsPeerConnection->pIceAgent->isLiteAgent) {
+        CHK_STATUS(sdpAppendAttribute(pLocalSessionDescription, NULL, "ice-lite", NULL));
+    }
+
     for (i = 0; i < pLocalSessionDescription->mediaCount; i++) {
         STRCPY(pLocalSessionDescription->mediaDescriptions[i].sdpConnectionInformation.networkType, "IN");
         STRCPY(pLocalSessionDescription->mediaDescriptions[i].sdpConnectionInformation.addressType, "IP4");
         STRCPY(pLocalSessionDescription->mediaDescriptions[i].sdpConnectionInformation.connectionAddress, "127.0.0.1");
     }
 
-    STRCPY(pLocalSessionDescription->sdpAttributes[pLocalSessionDescription->sessionAttributesCount].attributeName, "msid-semantic");
-    STRCPY(pLocalSessionDescription->sdpAttributes[pLocalSessionDescription->sessionAttributesCount].attributeValue, " WMS myKvsVideoStream");
-    pLocalSessionDescription->sessionAttributesCount++;
+    CHK_STATUS(sdpAppendAttribute(pLocalSessionDescription, NULL, "msid-semantic", " WMS myKvsVideoStream"));
 
 CleanUp:
 
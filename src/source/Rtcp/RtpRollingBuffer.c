@@ -2,17 +2,19 @@
 
 #include "../Include_i.h"
 
-STATUS createRtpRollingBuffer(UINT32 capacity, PRtpRollingBuffer* ppRtpRollingBuffer)
+STATUS createRtpRollingBuffer(UINT32 capacity, UINT32 mtu, PRtpRollingBuffer* ppRtpRollingBuffer)
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     PRtpRollingBuffer pRtpRollingBuffer = NULL;
-    CHK(capacity != 0, STATUS_INVALID_ARG);
+    CHK(capacity != 0 && mtu != 0, STATUS_INVALID_ARG);
     CHK(ppRtpRollingBuffer != NULL, STATUS_NULL_ARG);
 
-    pRtpRollingBuffer = (PRtpRollingBuffer) MEMALLOC(SIZEOF(RtpRollingBuffer));
+    pRtpRollingBuffer = (PRtpRollingBuffer) MEMCALLOC(1, SIZEOF(RtpRollingBuffer));
     CHK(pRtpRollingBuffer != NULL, STATUS_NOT_ENOUGH_MEMORY);
     CHK_STATUS(createRollingBuffer(capacity, freeRtpRollingBufferData, &pRtpRollingBuffer->pRollingBuffer));
+    pRtpRollingBuffer->poolBlockSize = RTP_PACKET_POOL_HEADER_SIZE + OUTBOUND_PACKET_BUFFER_SIZE(mtu);
+    pRtpRollingBuffer->poolBlockCount = MIN(capacity, RTP_ROLLING_BUFFER_MAX_POOLED_PACKETS);
 
 CleanUp:
     if (ppRtpRollingBuffer != NULL) {
@@ -31,6 +33,7 @@ STATUS freeRtpRollingBuffer(PRtpRollingBuffer* ppRtpRollingBuffer)
 
     if (*ppRtpRollingBuffer != NULL) {
         freeRollingBuffer(&(*ppRtpRollingBuffer)->pRollingBuffer);
+        freePacketPool(&(*ppRtpRollingBuffer)->pPacketPool);
     }
     SAFE_MEMFREE(*ppRtpRollingBuffer);
 CleanUp:
@@ -56,22 +59,22 @@ STATUS rtpRollingBufferAddRtpPacket(PRtpRollingBuffer pRollingBuffer, PRtpPacket
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     PRtpPacket pRtpPacketCopy = NULL;
-    PBYTE pRawPacketCopy = NULL;
     UINT64 index = 0;
     CHK(pRollingBuffer != NULL && pRtpPacket != NULL, STATUS_NULL_ARG);
 
-    pRawPacketCopy = (PBYTE) MEMALLOC(pRtpPacket->rawPacketLength);
-    CHK(pRawPacketCopy != NULL, STATUS_NOT_ENOUGH_MEMORY);
-    MEMCPY(pRawPacketCopy, pRtpPacket->pRawPacket, pRtpPacket->rawPacketLength);
-    CHK_STATUS(createRtpPacketFromBytes(pRawPacketCopy, pRtpPacket->rawPacketLength, &pRtpPacketCopy));
-    // pRtpPacketCopy took ownership of pRawPacketCopy
-    pRawPacketCopy = NULL;
+    // Adds are serialized by the sender, the first one sets up the pool
+    if (pRollingBuffer->pPacketPool == NULL) {
+        CHK_STATUS(createPacketPool(pRollingBuffer->poolBlockSize, pRollingBuffer->poolBlockCount, &pRollingBuffer->pPacketPool));
+    }
+
+    CHK_STATUS(createRtpPacketFromPool(pRollingBuffer->pPacketPool, pRtpPacket->pRawPacket, pRtpPacket->rawPacketLength, &pRtpPacketCopy));
 
     CHK_STATUS(rollingBufferAppendData(pRollingBuffer->pRollingBuffer, (UINT64) pRtpPacketCopy, &index));
     pRollingBuffer->lastIndex = index;
+    pRtpPacketCopy = NULL;
 
 CleanUp:
-    SAFE_MEMFREE(pRawPacketCopy);
+    freeRtpPacket(&pRtpPacketCopy);
     CHK_LOG_ERR(retStatus);
 
     LEAVES();
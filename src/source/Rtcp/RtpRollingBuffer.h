@@ -10,13 +10,23 @@ RTCP Rolling Buffer include file
 extern "C" {
 #endif
 
+// Upper bound on the number of preallocated packet copies per rolling buffer, older packets beyond it live on the heap
+#define RTP_ROLLING_BUFFER_MAX_POOLED_PACKETS 512
+
 typedef struct {
     PRollingBuffer pRollingBuffer;
     // index of last rtp packet in rolling buffer
     UINT64 lastIndex;
+    // backs the packet copies so the steady add/evict churn does not go through the heap,
+    // created by the first add so transceivers that never send don't hold a slab
+    PPacketPool pPacketPool;
+    // size of a pooled packet copy, derived from the MTU the packets are produced with
+    UINT32 poolBlockSize;
+    // number of packet copies the pool holds
+    UINT32 poolBlockCount;
 } RtpRollingBuffer, *PRtpRollingBuffer;
 
-STATUS createRtpRollingBuffer(UINT32, PRtpRollingBuffer*);
+STATUS createRtpRollingBuffer(UINT32, UINT32, PRtpRollingBuffer*);
 STATUS freeRtpRollingBuffer(PRtpRollingBuffer*);
 STATUS freeRtpRollingBufferData(PUINT64);
 STATUS rtpRollingBufferAddRtpPacket(PRtpRollingBuffer, PRtpPacket);
@@ -0,0 +1,178 @@
+#define LOG_CLASS "AnnexBScanner"
+
+#include "../../Include_i.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ANNEXB_SCANNER_X86
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#define ANNEXB_SCANNER_NEON
+#include <arm_neon.h>
+#endif
+
+// Start codes are 00 00 01, so every vector step looks 2 bytes past its block
+#define ANNEXB_START_CODE_LOOKAHEAD 2
+
+static UINT32 annexBFindStartCodeScalar(PBYTE pData, UINT32 offset, UINT32 length)
+{
+    // Look at the byte where the 0x01 would be. Anything other than 0 or a matched 01 means no start code can end
+    // within the next 2 bytes, so the search can jump 3 bytes ahead
+    offset += ANNEXB_START_CODE_LOOKAHEAD;
+    while (offset < length) {
+        if (pData[offset] == 0) {
+            offset++;
+        } else if (pData[offset] == 1 && pData[offset - 1] == 0 && pData[offset - 2] == 0) {
+            return offset - ANNEXB_START_CODE_LOOKAHEAD;
+        } else {
+            offset += 3;
+        }
+    }
+
+    return length;
+}
+
+#if defined(ANNEXB_SCANNER_X86)
+__attribute__((target("avx2"))) static UINT32 annexBFindStartCodeAvx2(PBYTE pData, UINT32 length)
+{
+    UINT32 offset = 0, mask;
+    __m256i zero = _mm256_setzero_si256(), one = _mm256_set1_epi8(1), b0, b1, b2;
+
+    while (offset + 32 + ANNEXB_START_CODE_LOOKAHEAD <= length) {
+        b0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i*) (pData + offset)), zero);
+        b1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i*) (pData + offset + 1)), zero);
+        b2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i*) (pData + offset + 2)), one);
+        mask = (UINT32) _mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(b0, b1), b2));
+        if (mask != 0) {
+            return offset + (UINT32) __builtin_ctz(mask);
+        }
+        offset += 32;
+    }
+
+    return annexBFindStartCodeScalar(pData, offset, length);
+}
+
+static UINT32 annexBFindStartCodeSse2(PBYTE pData, UINT32 length)
+{
+    UINT32 offset = 0, mask;
+    __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi8(1), b0, b1, b2;
+
+    while (offset + 16 + ANNEXB_START_CODE_LOOKAHEAD <= length) {
+        b0 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i*) (pData + offset)), zero);
+        b1 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i*) (pData + offset + 1)), zero);
+        b2 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i*) (pData + offset + 2)), one);
+        mask = (UINT32) _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2));
+        if (mask != 0) {
+            return offset + (UINT32) __builtin_ctz(mask);
+        }
+        offset += 16;
+    }
+
+    return annexBFindStartCodeScalar(pData, offset, length);
+}
+#elif defined(ANNEXB_SCANNER_NEON)
+static UINT32 annexBFindStartCodeNeon(PBYTE pData, UINT32 length)
+{
+    UINT32 offset = 0;
+    UINT64 mask;
+    uint8x16_t zero = vdupq_n_u8(0), one = vdupq_n_u8(1), matches;
+
+    while (offset + 16 + ANNEXB_START_CODE_LOOKAHEAD <= length) {
+        matches = vandq_u8(vandq_u8(vceqq_u8(vld1q_u8(pData + offset), zero), vceqq_u8(vld1q_u8(pData + offset + 1), zero)),
+                           vceqq_u8(vld1q_u8(pData + offset + 2), one));
+        // Narrow every 0xFF/0x00 lane to a nibble so the whole compare result fits in one 64-bit scalar
+        mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+        if (mask != 0) {
+            return offset + (UINT32) (__builtin_ctzll(mask) >> 2);
+        }
+        offset += 16;
+    }
+
+    return annexBFindStartCodeScalar(pData, offset, length);
+}
+#endif
+
+UINT32 annexBFindStartCode(PBYTE pData, UINT32 length)
+{
+    if (pData == NULL || length < 3) {
+        return length;
+    }
+
+#if defined(ANNEXB_SCANNER_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return annexBFindStartCodeAvx2(pData, length);
+    }
+    return annexBFindStartCodeSse2(pData, length);
+#elif defined(ANNEXB_SCANNER_NEON)
+    return annexBFindStartCodeNeon(pData, length);
+#else
+    return annexBFindStartCodeScalar(pData, 0, length);
+#endif
+}
+
+STATUS annexBSkipStartCode(PBYTE pData, UINT32 length, PUINT32 pStartCodeLength)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 offset = 0;
+
+    CHK(pData != NULL && pStartCodeLength != NULL, STATUS_NULL_ARG);
+
+    // Annex-B Nalu will have 0x000000001 or 0x000001 start code, at most 4 bytes
+    while (offset < 4 && offset < length && pData[offset] == 0) {
+        offset++;
+    }
+
+    CHK(offset < length && offset < 4 && offset >= 2 && pData[offset] == 1, STATUS_RTP_INVALID_NALU);
+    *pStartCodeLength = offset + 1;
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS annexBScanNalus(PBYTE pFrame, UINT32 frameLength, PAnnexBNalu pNalus, UINT32 maxNaluCount, PUINT32 pNaluCount, PUINT32 pScannedLength)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 offset = 0, naluStart, naluEnd, startCodeLength, naluCount = 0;
+
+    CHK(pFrame != NULL && pNalus != NULL && pNaluCount != NULL && pScannedLength != NULL, STATUS_NULL_ARG);
+
+    while (offset < frameLength && naluCount < maxNaluCount) {
+        CHK_STATUS(annexBSkipStartCode(pFrame + offset, frameLength - offset, &startCodeLength));
+        naluStart = offset + startCodeLength;
+        if (naluStart == frameLength) {
+            offset = frameLength;
+            break;
+        }
+
+        naluEnd = naluStart + annexBFindStartCode(pFrame + naluStart, frameLength - naluStart);
+        // The zero in front of 00 00 01 belongs to a 4-byte start code rather than to this NAL unit.
+        // Not validating runs of more zeros because some devices produce data with trailing zeros.
+        if (naluEnd < frameLength && naluEnd > naluStart && pFrame[naluEnd - 1] == 0) {
+            naluEnd--;
+        }
+
+        pNalus[naluCount].offset = naluStart;
+        pNalus[naluCount].length = naluEnd - naluStart;
+        naluCount++;
+        offset = naluEnd;
+    }
+
+CleanUp:
+
+    if (pNaluCount != NULL) {
+        *pNaluCount = naluCount;
+    }
+
+    if (pScannedLength != NULL) {
+        *pScannedLength = offset;
+    }
+
+    // As we might hit error often in a "bad" frame scenario, we can't use CHK_LOG_ERR as it will be too frequent
+    if (STATUS_FAILED(retStatus)) {
+        DLOGD("Warning: Failed to scan Annex-B frame with 0x%08x", retStatus);
+    }
+
+    LEAVES();
+    return retStatus;
+}
@@ -0,0 +1,63 @@
+/*******************************************
+Annex-B start code scanner include file
+*******************************************/
+#ifndef __KINESIS_VIDEO_WEBRTC_CLIENT_ANNEXBSCANNER_H
+#define __KINESIS_VIDEO_WEBRTC_CLIENT_ANNEXBSCANNER_H
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Location of one NAL unit inside an Annex-B byte stream, start code excluded
+typedef struct {
+    UINT32 offset;
+    UINT32 length;
+} AnnexBNalu, *PAnnexBNalu;
+
+/**
+ * Finds the first 0x000001 start code in the buffer. Uses AVX2/SSE2 on x86-64 and NEON on arm64,
+ * otherwise a scalar search that skips 3 bytes at a time.
+ *
+ * @param - PBYTE - IN - Buffer to search
+ * @param - UINT32 - IN - Buffer length
+ *
+ * @return - UINT32 - offset of the first 0x00 of the start code, or length if there is none
+ */
+UINT32 annexBFindStartCode(PBYTE, UINT32);
+
+/**
+ * Validates the 0x000001 / 0x00000001 start code at the beginning of the buffer
+ *
+ * @param - PBYTE - IN - Buffer beginning with a start code
+ * @param - UINT32 - IN - Buffer length
+ * @param - PUINT32 - OUT - Start code length including the 0x01
+ *
+ * @return - STATUS code of the execution. STATUS_RTP_INVALID_NALU if the buffer does not start with a start code
+ */
+STATUS annexBSkipStartCode(PBYTE, UINT32, PUINT32);
+
+/**
+ * Returns the boundaries of every NAL unit of an Annex-B frame in a single pass. Each NAL unit excludes its start code,
+ * including the optional leading zero of a 4-byte start code that follows it. A start code at the very end of the frame
+ * does not produce a NAL unit.
+ *
+ * When the frame holds more NAL units than the array, scanning stops after maxNaluCount entries and the scanned length
+ * is less than the frame length; calling again on the remainder continues where it left off.
+ *
+ * @param - PBYTE - IN - Annex-B frame
+ * @param - UINT32 - IN - Frame length
+ * @param - PAnnexBNalu - OUT - NAL unit array
+ * @param - UINT32 - IN - NAL unit array capacity
+ * @param - PUINT32 - OUT - Number of NAL units written
+ * @param - PUINT32 - OUT - Number of frame bytes covered by the returned NAL units
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS annexBScanNalus(PBYTE, UINT32, PAnnexBNalu, UINT32, PUINT32, PUINT32);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //__KINESIS_VIDEO_WEBRTC_CLIENT_ANNEXBSCANNER_H
@@ -44,6 +44,25 @@ CleanUp:
     return retStatus;
 }
 
+STATUS packetizeG711Frame(UINT32 mtu, PBYTE g711Frame, UINT32 g711FrameLength, PPayloadDescriptorArray pDescriptorArray)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 remainingLength, curLength;
+
+    CHK(g711Frame != NULL && pDescriptorArray != NULL, STATUS_NULL_ARG);
+    CHK(mtu > 0, STATUS_RTP_INPUT_MTU_TOO_SMALL);
+
+    for (remainingLength = g711FrameLength; remainingLength > 0; remainingLength -= curLength) {
+        curLength = MIN(mtu, remainingLength);
+        CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, 0, g711Frame + g711FrameLength - remainingLength, curLength, NULL));
+    }
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
 STATUS depayG711FromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PBYTE pG711Data, PUINT32 pG711Length, PBOOL pIsStart)
 {
     ENTERS();
@@ -77,3 +96,27 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+STATUS depayG711FragmentsFromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PRtcFrameFragment pFragments, PUINT32 pFragmentCount, PBOOL pIsStart)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 capacity = 0, fragmentCount = 0;
+
+    CHK(pRawPacket != NULL && pFragmentCount != NULL, STATUS_NULL_ARG);
+    capacity = *pFragmentCount;
+
+    CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket, packetLength, FALSE));
+
+CleanUp:
+    if (pFragmentCount != NULL) {
+        *pFragmentCount = fragmentCount;
+    }
+
+    if (pIsStart != NULL) {
+        *pIsStart = TRUE;
+    }
+
+    LEAVES();
+    return retStatus;
+}
@@ -11,7 +11,9 @@ extern "C" {
 #endif
 
 STATUS createPayloadForG711(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
+STATUS packetizeG711Frame(UINT32, PBYTE, UINT32, PPayloadDescriptorArray);
 STATUS depayG711FromRtpPayload(PBYTE, UINT32, PBYTE, PUINT32, PBOOL);
+STATUS depayG711FragmentsFromRtpPayload(PBYTE, UINT32, PRtcFrameFragment, PUINT32, PBOOL);
 
 #ifdef __cplusplus
 }
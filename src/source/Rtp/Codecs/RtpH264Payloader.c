@@ -161,16 +161,14 @@ STATUS createPayloadForH264(UINT32 mtu, PBYTE nalus, UINT32 nalusLength, PBYTE p
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    PBYTE curPtrInNalus = nalus;
-    UINT32 remainNalusLength = nalusLength;
-    UINT32 nextNaluLength = 0;
-    UINT32 startIndex = 0;
+    UINT32 scannedLength = 0;
     UINT32 singlePayloadLength = 0;
     UINT32 singlePayloadSubLenSize = 0;
     BOOL sizeCalculationOnly = (payloadBuffer == NULL);
-    PayloadArray payloadArray;
+    PayloadArray payloadArray = {0};
 
     // Arrays to collect NAL units for aggregation
+    AnnexBNalu annexBNalus[MAX_NALUS_PER_FRAME];
     NaluInfo naluInfos[MAX_NALUS_PER_FRAME];
     UINT32 naluCount = 0;
     UINT32 i;
@@ -198,30 +196,19 @@ STATUS createPayloadForH264(UINT32 mtu, PBYTE nalus, UINT32 nalusLength, PBYTE p
     payloadArray.payloadSubLength = pPayloadSubLength;
 
     // First pass: collect all NAL units
-    while (remainNalusLength > 0 && naluCount < MAX_NALUS_PER_FRAME) {
-        CHK_STATUS(getNextNaluLength(curPtrInNalus, remainNalusLength, &startIndex, &nextNaluLength));
-
-        curPtrInNalus += startIndex;
-        remainNalusLength -= startIndex;
-
-        if (remainNalusLength == 0) {
-            break;
-        }
-
-        naluInfos[naluCount].pNalu = curPtrInNalus;
-        naluInfos[naluCount].length = nextNaluLength;
-        naluCount++;
-
-        remainNalusLength -= nextNaluLength;
-        curPtrInNalus += nextNaluLength;
-    }
+    CHK_STATUS(annexBScanNalus(nalus, nalusLength, annexBNalus, MAX_NALUS_PER_FRAME, &naluCount, &scannedLength));
 
     // Check if we exceeded the limit
-    if (remainNalusLength > 0 && naluCount >= MAX_NALUS_PER_FRAME) {
+    if (scannedLength < nalusLength) {
         DLOGE("Frame has more than %u NAL units, cannot process", MAX_NALUS_PER_FRAME);
         CHK(FALSE, STATUS_INVALID_ARG);
     }
 
+    for (i = 0; i < naluCount; i++) {
+        naluInfos[i].pNalu = nalus + annexBNalus[i].offset;
+        naluInfos[i].length = annexBNalus[i].length;
+    }
+
     CHK(naluCount > 0, retStatus);
 
     // Second pass: decide aggregation strategy and create payloads
@@ -388,47 +375,20 @@ STATUS getNextNaluLength(PBYTE nalus, UINT32 nalusLength, PUINT32 pStart, PUINT3
     ENTERS();
 
     STATUS retStatus = STATUS_SUCCESS;
-    UINT32 zeroCount = 0, offset = 0;
-    BOOL naluFound = FALSE;
-    PBYTE pCurrent = NULL;
+    AnnexBNalu nalu;
+    UINT32 naluCount = 0, scannedLength = 0;
 
     CHK(nalus != NULL && pStart != NULL && pNaluLength != NULL, STATUS_NULL_ARG);
 
-    // Annex-B Nalu will have 0x000000001 or 0x000001 start code, at most 4 bytes
-    while (offset < 4 && offset < nalusLength && nalus[offset] == 0) {
-        offset++;
-    }
-
-    CHK(offset < nalusLength && offset < 4 && offset >= 2 && nalus[offset] == 1, STATUS_RTP_INVALID_NALU);
-    *pStart = ++offset;
-    pCurrent = nalus + offset;
-
-    /* Not doing validation on number of consecutive zeros being less than 4 because some device can produce
-     * data with trailing zeros. */
-    while (offset < nalusLength) {
-        if (*pCurrent == 0) {
-            /* Maybe next byte is 1 */
-            offset++;
-            pCurrent++;
-
-        } else if (*pCurrent == 1) {
-            if (*(pCurrent - 1) == 0 && *(pCurrent - 2) == 0) {
-                zeroCount = *(pCurrent - 3) == 0 ? 3 : 2;
-                naluFound = TRUE;
-                break;
-            }
-
-            /* The jump is always 3 because of the 1 previously matched.
-             * All the 0's must be after this '1' matched at offset */
-            offset += 3;
-            pCurrent += 3;
-        } else {
-            /* Can jump 3 bytes forward */
-            offset += 3;
-            pCurrent += 3;
-        }
+    CHK_STATUS(annexBScanNalus(nalus, nalusLength, &nalu, 1, &naluCount, &scannedLength));
+    if (naluCount == 0) {
+        // Start code at the very end of the buffer
+        CHK_STATUS(annexBSkipStartCode(nalus, nalusLength, pStart));
+        *pNaluLength = 0;
+    } else {
+        *pStart = nalu.offset;
+        *pNaluLength = nalu.length;
     }
-    *pNaluLength = MIN(offset, nalusLength) - *pStart - (naluFound ? zeroCount : 0);
 
 CleanUp:
 
@@ -534,6 +494,110 @@ CleanUp:
     return retStatus;
 }
 
+// Appends the NAL units collected for aggregation: a lone NAL unit as a single NAL unit packet, several as one STAP-A
+static STATUS packetizeH264Aggregate(PBYTE nalus, PAnnexBNalu pNalus, UINT32 naluCount, UINT32 stapSize, PPayloadDescriptorArray pDescriptorArray)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PBYTE pStap = NULL, pPayload, pNalu;
+    UINT8 maxNri = 0;
+    UINT32 i;
+
+    if (naluCount == 1) {
+        // Single NALU https://tools.ietf.org/html/rfc6184#section-5.6
+        CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, 0, nalus + pNalus[0].offset, pNalus[0].length, NULL));
+        CHK(FALSE, retStatus);
+    }
+
+    // STAP-A https://tools.ietf.org/html/rfc6184#section-5.7.1 is small, so it is assembled whole in the scratch buffer
+    CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, stapSize, NULL, 0, &pStap));
+    pPayload = pStap + STAP_A_HEADER_SIZE;
+    for (i = 0; i < naluCount; i++) {
+        pNalu = nalus + pNalus[i].offset;
+        maxNri = MAX(maxNri, pNalu[0] & 0x60);
+        putUnalignedInt16BigEndian(pPayload, (UINT16) pNalus[i].length);
+        pPayload += SIZEOF(UINT16);
+        MEMCPY(pPayload, pNalu, pNalus[i].length);
+        pPayload += pNalus[i].length;
+    }
+    pStap[0] = STAP_A_INDICATOR | maxNri;
+
+CleanUp:
+    return retStatus;
+}
+
+STATUS packetizeH264Frame(UINT32 mtu, PBYTE nalus, UINT32 nalusLength, PPayloadDescriptorArray pDescriptorArray)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    AnnexBNalu annexBNalus[MAX_NALUS_PER_FRAME];
+    PBYTE curPtrInNalus = nalus, pNalu, pPayload;
+    UINT32 remainNalusLength = nalusLength, scannedLength = 0, naluCount = 0, naluLength, i;
+    UINT32 stapStartIndex = 0, stapNaluCount = 0, stapSize = STAP_A_HEADER_SIZE, remainingNaluLength, curPayloadSize;
+
+    CHK(nalus != NULL && pDescriptorArray != NULL, STATUS_NULL_ARG);
+    CHK(mtu > FU_A_HEADER_SIZE, STATUS_RTP_INPUT_MTU_TOO_SMALL);
+
+    while (remainNalusLength != 0) {
+        CHK_STATUS(annexBScanNalus(curPtrInNalus, remainNalusLength, annexBNalus, ARRAY_SIZE(annexBNalus), &naluCount, &scannedLength));
+
+        for (i = 0; i < naluCount; i++) {
+            pNalu = curPtrInNalus + annexBNalus[i].offset;
+            naluLength = annexBNalus[i].length;
+
+            // Flush the pending aggregation when this NAL unit has to be fragmented or no longer fits next to it
+            if (stapNaluCount > 0 && (naluLength > mtu || stapSize + STAP_A_NALU_OVERHEAD + naluLength > mtu)) {
+                CHK_STATUS(packetizeH264Aggregate(curPtrInNalus, &annexBNalus[stapStartIndex], stapNaluCount, stapSize, pDescriptorArray));
+                stapNaluCount = 0;
+            }
+
+            if (naluLength <= mtu) {
+                if (stapNaluCount == 0) {
+                    stapStartIndex = i;
+                    stapSize = STAP_A_HEADER_SIZE;
+                }
+                stapNaluCount++;
+                stapSize += STAP_A_NALU_OVERHEAD + naluLength;
+                continue;
+            }
+
+            // FU-A https://tools.ietf.org/html/rfc6184#section-5.8, the NAL unit header is carried by the FU header
+            for (remainingNaluLength = naluLength - 1; remainingNaluLength != 0; remainingNaluLength -= curPayloadSize) {
+                curPayloadSize = MIN(mtu - FU_A_HEADER_SIZE, remainingNaluLength);
+                CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, FU_A_HEADER_SIZE, pNalu + naluLength - remainingNaluLength, curPayloadSize,
+                                                   &pPayload));
+                pPayload[0] = FU_A_INDICATOR | (pNalu[0] & 0x60);
+                pPayload[1] = pNalu[0] & NAL_TYPE_MASK;
+                if (remainingNaluLength == naluLength - 1) {
+                    // Set for starting bit
+                    pPayload[1] |= 1 << 7;
+                } else if (remainingNaluLength == curPayloadSize) {
+                    // Set for ending bit
+                    pPayload[1] |= 1 << 6;
+                }
+            }
+        }
+
+        // Aggregation does not span scans as the next scan reuses the NAL unit array
+        if (stapNaluCount > 0) {
+            CHK_STATUS(packetizeH264Aggregate(curPtrInNalus, &annexBNalus[stapStartIndex], stapNaluCount, stapSize, pDescriptorArray));
+            stapNaluCount = 0;
+        }
+
+        remainNalusLength -= scannedLength;
+        curPtrInNalus += scannedLength;
+    }
+
+CleanUp:
+
+    // As we might hit error often in a "bad" frame scenario, we can't use CHK_LOG_ERR as it will be too frequent
+    if (STATUS_FAILED(retStatus)) {
+        DLOGD("Warning: Failed to packetize H264 frame with 0x%08x", retStatus);
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
 STATUS depayH264FromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PBYTE pNaluData, PUINT32 pNaluLength, PBOOL pIsStart)
 {
     ENTERS();
@@ -743,3 +807,76 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+STATUS depayH264FragmentsFromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PRtcFrameFragment pFragments, PUINT32 pFragmentCount, PBOOL pIsStart)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 naluLength = 0, capacity = 0, fragmentCount = 0, headerSize = 0;
+    UINT8 indicator = 0;
+    UINT16 subNaluSize = 0;
+    PBYTE pCurPtr = pRawPacket;
+    PBYTE pEnd = pRawPacket + packetLength;
+    static BYTE start4ByteCode[] = {0x00, 0x00, 0x00, 0x01};
+    static BYTE start3ByteCode[] = {0x00, 0x00, 0x01};
+
+    // Same start code choice as depayH264FromRtpPayload
+    BOOL useShortStartCode = (pIsStart != NULL && *pIsStart == FALSE);
+    PBYTE startCode = useShortStartCode ? start3ByteCode : start4ByteCode;
+    UINT32 startCodeSize = useShortStartCode ? SIZEOF(start3ByteCode) : SIZEOF(start4ByteCode);
+
+    CHK(pRawPacket != NULL && pFragmentCount != NULL, STATUS_NULL_ARG);
+    capacity = *pFragmentCount;
+    CHK(packetLength > 0, retStatus);
+
+    // Frame start detection stays in one place
+    CHK_STATUS(depayH264FromRtpPayload(pRawPacket, packetLength, NULL, &naluLength, pIsStart));
+
+    indicator = *pRawPacket & NAL_TYPE_MASK;
+    switch (indicator) {
+        case FU_A_INDICATOR:
+        case FU_B_INDICATOR:
+            headerSize = indicator == FU_A_INDICATOR ? FU_A_HEADER_SIZE : FU_B_HEADER_SIZE;
+            CHK(packetLength > headerSize, STATUS_RTP_INVALID_NALU);
+            if ((pRawPacket[1] & (1 << 7)) != 0) {
+                CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, startCode, startCodeSize, TRUE));
+                CHK_STATUS(
+                    appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket + headerSize - 1, packetLength - headerSize + 1, FALSE));
+                // The NAL header is rebuilt over the byte in front of the FU payload so the fragment stays in the packet.
+                // Done last so a fill that runs out of fragments leaves the packet untouched.
+                if (pFragments != NULL) {
+                    pRawPacket[headerSize - 1] = (pRawPacket[0] & 0x60) | (pRawPacket[1] & 0x1f);
+                }
+            } else {
+                CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket + headerSize, packetLength - headerSize, FALSE));
+            }
+            break;
+        case STAP_A_INDICATOR:
+        case STAP_B_INDICATOR:
+            pCurPtr += indicator == STAP_A_INDICATOR ? STAP_A_HEADER_SIZE : STAP_B_HEADER_SIZE;
+            do {
+                CHK(pCurPtr + SIZEOF(UINT16) <= pEnd, STATUS_RTP_INVALID_NALU);
+                subNaluSize = getUnalignedInt16BigEndian(pCurPtr);
+                pCurPtr += SIZEOF(UINT16);
+                CHK(pCurPtr + subNaluSize <= pEnd, STATUS_RTP_INVALID_NALU);
+                CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, startCode, startCodeSize, TRUE));
+                CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pCurPtr, subNaluSize, FALSE));
+                // Only the first aggregated NAL unit may take the 4-byte start code
+                startCode = start3ByteCode;
+                startCodeSize = SIZEOF(start3ByteCode);
+                pCurPtr += subNaluSize;
+            } while (subNaluSize > 0 && pCurPtr < pEnd);
+            break;
+        default:
+            CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, startCode, startCodeSize, TRUE));
+            CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket, packetLength, FALSE));
+    }
+
+CleanUp:
+    if (pFragmentCount != NULL) {
+        *pFragmentCount = fragmentCount;
+    }
+
+    LEAVES();
+    return retStatus;
+}
@@ -46,8 +46,24 @@ extern "C" {
 STATUS createPayloadForH264(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
 STATUS getNextNaluLength(PBYTE, UINT32, PUINT32, PUINT32);
 STATUS createPayloadFromNalu(UINT32, PBYTE, UINT32, PPayloadArray, PUINT32, PUINT32);
+STATUS packetizeH264Frame(UINT32, PBYTE, UINT32, PPayloadDescriptorArray);
 STATUS depayH264FromRtpPayload(PBYTE, UINT32, PBYTE, PUINT32, PBOOL);
 
+/**
+ * Zero-copy counterpart of depayH264FromRtpPayload: describes the Annex-B output as start code fragments and slices of
+ * the packet. The NAL header of an FU start fragment is rebuilt in place over the byte preceding the FU payload, so
+ * the packet can't be depayloaded again after a successful fill.
+ *
+ * @param - PBYTE - IN - RTP payload
+ * @param - UINT32 - IN - RTP payload length
+ * @param - PRtcFrameFragment - OUT/OPT - Fragments, NULL to only count them
+ * @param - PUINT32 - IN/OUT - Fragment array capacity in, fragments written or needed out
+ * @param - PBOOL - IN/OUT/OPT - Same as for depayH264FromRtpPayload
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS depayH264FragmentsFromRtpPayload(PBYTE, UINT32, PRtcFrameFragment, PUINT32, PBOOL);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,6 +2,9 @@
 
 #include "../../Include_i.h"
 
+// Number of NAL unit boundaries fetched from the Annex-B scanner at a time
+#define H265_MAX_NALUS_PER_SCAN 64
+
 STATUS createPayloadForH265(UINT32 mtu, PBYTE nalus, UINT32 nalusLength, PBYTE payloadBuffer, PUINT32 pPayloadLength, PUINT32 pPayloadSubLength,
                             PUINT32 pPayloadSubLenSize)
 {
@@ -9,12 +12,13 @@ STATUS createPayloadForH265(UINT32 mtu, PBYTE nalus, UINT32 nalusLength, PBYTE p
     STATUS retStatus = STATUS_SUCCESS;
     PBYTE curPtrInNalus = nalus;
     UINT32 remainNalusLength = nalusLength;
-    UINT32 nextNaluLength = 0;
-    UINT32 startIndex = 0;
+    UINT32 scannedLength = 0;
+    UINT32 naluCount = 0, i;
+    AnnexBNalu annexBNalus[H265_MAX_NALUS_PER_SCAN];
     UINT32 singlePayloadLength = 0;
     UINT32 singlePayloadSubLenSize = 0;
     BOOL sizeCalculationOnly = (payloadBuffer == NULL);
-    PayloadArray payloadArray;
+    PayloadArray payloadArray = {0};
 
     CHK(nalus != NULL && pPayloadSubLenSize != NULL && pPayloadLength != NULL && (sizeCalculationOnly || pPayloadSubLength != NULL), STATUS_NULL_ARG);
     CHK(mtu > H265_FU_HEADER_SIZE, STATUS_RTP_INPUT_MTU_TOO_SMALL);
@@ -33,29 +37,31 @@ STATUS createPayloadForH265(UINT32 mtu, PBYTE nalus, UINT32 nalusLength, PBYTE p
     payloadArray.payloadBuffer = payloadBuffer;
     payloadArray.payloadSubLength = pPayloadSubLength;
 
-    do {
-        CHK_STATUS(getNextNaluLengthH265(curPtrInNalus, remainNalusLength, &startIndex, &nextNaluLength));
-
-        curPtrInNalus += startIndex;
-
-        remainNalusLength -= startIndex;
-
-        CHK(remainNalusLength != 0, retStatus);
+    // An empty frame has no start code
+    CHK(remainNalusLength != 0, STATUS_RTP_INVALID_NALU);
 
-        if (sizeCalculationOnly) {
-            CHK_STATUS(createPayloadFromNaluH265(mtu, curPtrInNalus, nextNaluLength, NULL, &singlePayloadLength, &singlePayloadSubLenSize));
-            payloadArray.payloadLength += singlePayloadLength;
-            payloadArray.payloadSubLenSize += singlePayloadSubLenSize;
-        } else {
-            CHK_STATUS(createPayloadFromNaluH265(mtu, curPtrInNalus, nextNaluLength, &payloadArray, &singlePayloadLength, &singlePayloadSubLenSize));
-            payloadArray.payloadBuffer += singlePayloadLength;
-            payloadArray.payloadSubLength += singlePayloadSubLenSize;
-            payloadArray.maxPayloadLength -= singlePayloadLength;
-            payloadArray.maxPayloadSubLenSize -= singlePayloadSubLenSize;
+    // Boundaries come from the scanner a batch at a time; a frame with more NAL units than the batch takes several scans
+    do {
+        CHK_STATUS(annexBScanNalus(curPtrInNalus, remainNalusLength, annexBNalus, ARRAY_SIZE(annexBNalus), &naluCount, &scannedLength));
+
+        for (i = 0; i < naluCount; i++) {
+            if (sizeCalculationOnly) {
+                CHK_STATUS(createPayloadFromNaluH265(mtu, curPtrInNalus + annexBNalus[i].offset, annexBNalus[i].length, NULL, &singlePayloadLength,
+                                                     &singlePayloadSubLenSize));
+                payloadArray.payloadLength += singlePayloadLength;
+                payloadArray.payloadSubLenSize += singlePayloadSubLenSize;
+            } else {
+                CHK_STATUS(createPayloadFromNaluH265(mtu, curPtrInNalus + annexBNalus[i].offset, annexBNalus[i].length, &payloadArray,
+                                                     &singlePayloadLength, &singlePayloadSubLenSize));
+                payloadArray.payloadBuffer += singlePayloadLength;
+                payloadArray.payloadSubLength += singlePayloadSubLenSize;
+                payloadArray.maxPayloadLength -= singlePayloadLength;
+                payloadArray.maxPayloadSubLenSize -= singlePayloadSubLenSize;
+            }
         }
 
-        remainNalusLength -= nextNaluLength;
-        curPtrInNalus += nextNaluLength;
+        remainNalusLength -= scannedLength;
+        curPtrInNalus += scannedLength;
     } while (remainNalusLength != 0);
 
 CleanUp:
@@ -78,47 +84,20 @@ STATUS getNextNaluLengthH265(PBYTE nalus, UINT32 nalusLength, PUINT32 pStart, PU
     ENTERS();
 
     STATUS retStatus = STATUS_SUCCESS;
-    UINT32 zeroCount = 0, offset = 0;
-    BOOL naluFound = FALSE;
-    PBYTE pCurrent = NULL;
+    AnnexBNalu nalu;
+    UINT32 naluCount = 0, scannedLength = 0;
 
     CHK(nalus != NULL && pStart != NULL && pNaluLength != NULL, STATUS_NULL_ARG);
 
-    // Annex-B Nalu will have 0x000000001 or 0x000001 start code, at most 4 bytes
-    while (offset < 4 && offset < nalusLength && nalus[offset] == 0) {
-        offset++;
-    }
-
-    CHK(offset < nalusLength && offset < 4 && offset >= 2 && nalus[offset] == 1, STATUS_RTP_INVALID_NALU);
-    *pStart = ++offset;
-    pCurrent = nalus + offset;
-
-    /* Not doing validation on number of consecutive zeros being less than 4 because some device can produce
-     * data with trailing zeros. */
-    while (offset < nalusLength) {
-        if (*pCurrent == 0) {
-            /* Maybe next byte is 1 */
-            offset++;
-            pCurrent++;
-
-        } else if (*pCurrent == 1) {
-            if (*(pCurrent - 1) == 0 && *(pCurrent - 2) == 0) {
-                zeroCount = *(pCurrent - 3) == 0 ? 3 : 2;
-                naluFound = TRUE;
-                break;
-            }
-
-            /* The jump is always 3 because of the 1 previously matched.
-             * All the 0's must be after this '1' matched at offset */
-            offset += 3;
-            pCurrent += 3;
-        } else {
-            /* Can jump 3 bytes forward */
-            offset += 3;
-            pCurrent += 3;
-        }
+    CHK_STATUS(annexBScanNalus(nalus, nalusLength, &nalu, 1, &naluCount, &scannedLength));
+    if (naluCount == 0) {
+        // Start code at the very end of the buffer
+        CHK_STATUS(annexBSkipStartCode(nalus, nalusLength, pStart));
+        *pNaluLength = 0;
+    } else {
+        *pStart = nalu.offset;
+        *pNaluLength = nalu.length;
     }
-    *pNaluLength = MIN(offset, nalusLength) - *pStart - (naluFound ? zeroCount : 0);
 
 CleanUp:
 
@@ -221,6 +200,66 @@ CleanUp:
     return retStatus;
 }
 
+STATUS packetizeH265Frame(UINT32 mtu, PBYTE nalus, UINT32 nalusLength, PPayloadDescriptorArray pDescriptorArray)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    AnnexBNalu annexBNalus[H265_MAX_NALUS_PER_SCAN];
+    PBYTE curPtrInNalus = nalus, pNalu, pPayload;
+    UINT32 remainNalusLength = nalusLength, scannedLength = 0, naluCount = 0, naluLength, i;
+    UINT32 remainingNaluLength, curPayloadSize;
+
+    CHK(nalus != NULL && pDescriptorArray != NULL, STATUS_NULL_ARG);
+    CHK(mtu > H265_FU_HEADER_SIZE, STATUS_RTP_INPUT_MTU_TOO_SMALL);
+
+    // An empty frame has no start code
+    CHK(remainNalusLength != 0, STATUS_RTP_INVALID_NALU);
+
+    do {
+        CHK_STATUS(annexBScanNalus(curPtrInNalus, remainNalusLength, annexBNalus, ARRAY_SIZE(annexBNalus), &naluCount, &scannedLength));
+
+        for (i = 0; i < naluCount; i++) {
+            pNalu = curPtrInNalus + annexBNalus[i].offset;
+            naluLength = annexBNalus[i].length;
+
+            if (naluLength <= mtu) {
+                // Single NALU https://www.rfc-editor.org/rfc/rfc7798.html#section-4.4.1
+                CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, 0, pNalu, naluLength, NULL));
+                continue;
+            }
+
+            // Fragmentation units: https://www.rfc-editor.org/rfc/rfc7798.html#section-4.4.3, the 2 byte NAL unit header is
+            // carried by the payload header and the FU header
+            for (remainingNaluLength = naluLength - 2; remainingNaluLength != 0; remainingNaluLength -= curPayloadSize) {
+                curPayloadSize = MIN(mtu - H265_FU_HEADER_SIZE, remainingNaluLength);
+                CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, H265_FU_HEADER_SIZE, pNalu + naluLength - remainingNaluLength, curPayloadSize,
+                                                   &pPayload));
+                pPayload[0] = (H265_FU_TYPE_ID << 1) | (pNalu[0] & 0x81);
+                pPayload[1] = pNalu[1];
+                pPayload[2] = (pNalu[0] & 0x7E) >> 1;
+                if (remainingNaluLength == naluLength - 2) {
+                    pPayload[2] |= (1 << 7); // Set for starting bit
+                } else if (remainingNaluLength == curPayloadSize) {
+                    pPayload[2] |= (1 << 6); // Set for ending bit
+                }
+            }
+        }
+
+        remainNalusLength -= scannedLength;
+        curPtrInNalus += scannedLength;
+    } while (remainNalusLength != 0);
+
+CleanUp:
+
+    // As we might hit error often in a "bad" frame scenario, we can't use CHK_LOG_ERR as it will be too frequent
+    if (STATUS_FAILED(retStatus)) {
+        DLOGD("Warning: Failed to packetize H265 frame with 0x%08x", retStatus);
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
 STATUS depayH265FromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PBYTE pNaluData, PUINT32 pNaluLength, PBOOL pIsStart)
 {
     ENTERS();
@@ -281,3 +320,50 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+STATUS depayH265FragmentsFromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PRtcFrameFragment pFragments, PUINT32 pFragmentCount, PBOOL pIsStart)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 capacity = 0, fragmentCount = 0;
+    BOOL isStartingPacket = TRUE;
+    BYTE layerIdTid;
+    static BYTE start4ByteCode[] = {0x00, 0x00, 0x00, 0x01};
+
+    CHK(pRawPacket != NULL && pFragmentCount != NULL, STATUS_NULL_ARG);
+    capacity = *pFragmentCount;
+    CHK(packetLength > 0, retStatus);
+
+    if (((pRawPacket[0] >> 1) & 0x3F) == H265_FU_TYPE_ID) {
+        CHK(packetLength > H265_FU_HEADER_SIZE, STATUS_RTP_INVALID_NALU);
+        isStartingPacket = (pRawPacket[2] & 0x80) != 0;
+        if (isStartingPacket) {
+            CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, start4ByteCode, SIZEOF(start4ByteCode), TRUE));
+            CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket + 1, packetLength - 1, FALSE));
+            // The two byte NAL header is rebuilt over the end of the payload header and the FU header, last so a failed fill leaves it
+            if (pFragments != NULL) {
+                layerIdTid = pRawPacket[1];
+                pRawPacket[1] = ((pRawPacket[2] & 0x3F) << 1) | (pRawPacket[0] & 0x81);
+                pRawPacket[2] = layerIdTid;
+            }
+        } else {
+            CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket + H265_FU_HEADER_SIZE, packetLength - H265_FU_HEADER_SIZE,
+                                           FALSE));
+        }
+    } else {
+        CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, start4ByteCode, SIZEOF(start4ByteCode), TRUE));
+        CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket, packetLength, FALSE));
+    }
+
+CleanUp:
+    if (pFragmentCount != NULL) {
+        *pFragmentCount = fragmentCount;
+    }
+
+    if (pIsStart != NULL) {
+        *pIsStart = isStartingPacket;
+    }
+
+    LEAVES();
+    return retStatus;
+}
@@ -33,7 +33,9 @@ extern "C" {
 STATUS createPayloadForH265(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
 STATUS getNextNaluLengthH265(PBYTE, UINT32, PUINT32, PUINT32);
 STATUS createPayloadFromNaluH265(UINT32, PBYTE, UINT32, PPayloadArray, PUINT32, PUINT32);
+STATUS packetizeH265Frame(UINT32, PBYTE, UINT32, PPayloadDescriptorArray);
 STATUS depayH265FromRtpPayload(PBYTE, UINT32, PBYTE, PUINT32, PBOOL);
+STATUS depayH265FragmentsFromRtpPayload(PBYTE, UINT32, PRtcFrameFragment, PUINT32, PBOOL);
 
 #ifdef __cplusplus
 }
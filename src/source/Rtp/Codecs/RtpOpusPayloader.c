@@ -40,6 +40,21 @@ CleanUp:
     return retStatus;
 }
 
+STATUS packetizeOpusFrame(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLength, PPayloadDescriptorArray pDescriptorArray)
+{
+    UNUSED_PARAM(mtu);
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(opusFrame != NULL && pDescriptorArray != NULL, STATUS_NULL_ARG);
+
+    CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, 0, opusFrame, opusFrameLength, NULL));
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
 STATUS depayOpusFromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PBYTE pOpusData, PUINT32 pOpusLength, PBOOL pIsStart)
 {
     ENTERS();
@@ -73,3 +88,27 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+STATUS depayOpusFragmentsFromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PRtcFrameFragment pFragments, PUINT32 pFragmentCount, PBOOL pIsStart)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 capacity = 0, fragmentCount = 0;
+
+    CHK(pRawPacket != NULL && pFragmentCount != NULL, STATUS_NULL_ARG);
+    capacity = *pFragmentCount;
+
+    CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket, packetLength, FALSE));
+
+CleanUp:
+    if (pFragmentCount != NULL) {
+        *pFragmentCount = fragmentCount;
+    }
+
+    if (pIsStart != NULL) {
+        *pIsStart = TRUE;
+    }
+
+    LEAVES();
+    return retStatus;
+}
@@ -11,7 +11,9 @@ extern "C" {
 #endif
 
 STATUS createPayloadForOpus(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
+STATUS packetizeOpusFrame(UINT32, PBYTE, UINT32, PPayloadDescriptorArray);
 STATUS depayOpusFromRtpPayload(PBYTE, UINT32, PBYTE, PUINT32, PBOOL);
+STATUS depayOpusFragmentsFromRtpPayload(PBYTE, UINT32, PRtcFrameFragment, PUINT32, PBOOL);
 
 #ifdef __cplusplus
 }
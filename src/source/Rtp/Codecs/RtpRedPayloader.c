@@ -98,6 +98,73 @@ static VOID selectRedundantBlocks(PRedSenderState pState, UINT32 rtpTimestamp, U
     *pBodyBytes = bodyBytes;
 }
 
+// Writes the RED header chain followed by the chosen redundant payloads (oldest first). The primary payload that
+// completes the body is left to the caller.
+static VOID writeRedHeadersAndRedundancy(PRedSenderState pState, UINT32 rtpTimestamp, PUINT32 pChosenIndices, UINT32 chosenCount, PBYTE pOut)
+{
+    UINT8 opusPt = pState->opusPayloadType;
+    UINT32 i;
+
+    // Write all non-last RED headers.
+    for (i = 0; i < chosenCount; i++) {
+        PRedSenderSlot pSlot = &pState->slots[pChosenIndices[i]];
+        UINT32 tsDelta = rtpTimestamp - pSlot->rtpTimestamp;
+        UINT32 blockLen = pSlot->payloadLen;
+        pOut[0] = (BYTE) (0x80 | (opusPt & 0x7F));
+        pOut[1] = (BYTE) (((tsDelta & 0x3FFF) >> 6) & 0xFF);
+        pOut[2] = (BYTE) ((((tsDelta & 0x3F) << 2) | ((blockLen >> 8) & 0x3)) & 0xFF);
+        pOut[3] = (BYTE) (blockLen & 0xFF);
+        pOut += RED_HEADER_LEN_NON_LAST;
+    }
+
+    // Primary header (F=0, PT only).
+    pOut[0] = (BYTE) (opusPt & 0x7F);
+    pOut += RED_HEADER_LEN_LAST;
+
+    // Redundant payloads (oldest first).
+    for (i = 0; i < chosenCount; i++) {
+        PRedSenderSlot pSlot = &pState->slots[pChosenIndices[i]];
+        MEMCPY(pOut, pSlot->payload, pSlot->payloadLen);
+        pOut += pSlot->payloadLen;
+    }
+}
+
+// Mutates the ring: writes the just-sent primary into the newest slot.
+// nextSlot points at the oldest; overwrite it and advance.
+static VOID rememberRedPrimary(PRedSenderState pState, UINT32 rtpTimestamp, PBYTE opusFrame, UINT32 opusFrameLength)
+{
+    PRedSenderSlot pNewest = &pState->slots[pState->nextSlot];
+    pNewest->rtpTimestamp = rtpTimestamp;
+    pNewest->payloadLen = opusFrameLength;
+    MEMCPY(pNewest->payload, opusFrame, opusFrameLength);
+    pState->nextSlot = (pState->nextSlot + 1) % pState->redundancyLevel;
+}
+
+// Fallback to bare Opus when primary exceeds RED's 10-bit block length field, otherwise choose the redundant blocks
+static VOID planRedPayload(UINT32 mtu, UINT32 opusFrameLength, UINT32 rtpTimestamp, PRedSenderState pState, PUINT32 pChosenIndices,
+                           PUINT32 pChosenCount, PUINT32 pBodyBytes, PBOOL pFallback)
+{
+    UINT32 mtuBudget;
+
+    // Reserve MTU headroom for the outer RTP header and SRTP auth tag. The caller passes
+    // the raw MTU and we approximate the per-packet overhead the same way libwebrtc does.
+    // RTP_HEADER is at minimum 12 bytes; TWCC adds up to 8 bytes of extension header; we
+    // subtract a comfortable 24 to cover both.
+    if (mtu > (UINT32) (SRTP_AUTH_TAG_OVERHEAD + 24)) {
+        mtuBudget = mtu - SRTP_AUTH_TAG_OVERHEAD - 24;
+    } else {
+        mtuBudget = 0;
+    }
+
+    *pChosenCount = 0;
+    *pFallback = opusFrameLength > RED_MAX_BLOCK_LEN;
+    if (*pFallback) {
+        *pBodyBytes = opusFrameLength;
+    } else {
+        selectRedundantBlocks(pState, rtpTimestamp, mtuBudget, opusFrameLength, pChosenIndices, pChosenCount, pBodyBytes);
+    }
+}
+
 STATUS createPayloadForOpusRed(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLength, UINT32 rtpTimestamp, PRedSenderState pState, PBYTE payloadBuffer,
                                PUINT32 pPayloadLength, PUINT32 pPayloadSubLength, PUINT32 pPayloadSubLenSize, PBOOL pIsFallbackToPlainOpus)
 {
@@ -108,8 +175,6 @@ STATUS createPayloadForOpusRed(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLeng
     UINT32 chosenIndices[RED_MAX_BLOCKS];
     UINT32 chosenCount = 0;
     UINT32 bodyBytes = 0;
-    UINT32 mtuBudget;
-    UINT32 i;
     PBYTE pOut;
 
     CHK(pState != NULL && opusFrame != NULL && pPayloadLength != NULL && pPayloadSubLenSize != NULL && pIsFallbackToPlainOpus != NULL &&
@@ -117,23 +182,7 @@ STATUS createPayloadForOpusRed(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLeng
         STATUS_NULL_ARG);
     CHK(opusFrameLength > 0, STATUS_INVALID_ARG);
 
-    // Reserve MTU headroom for the outer RTP header and SRTP auth tag. The caller passes
-    // the raw MTU and we approximate the per-packet overhead the same way libwebrtc does.
-    // RTP_HEADER is at minimum 12 bytes; TWCC adds up to 8 bytes of extension header; we
-    // subtract a comfortable 24 to cover both.
-    if (mtu > (UINT32) (SRTP_AUTH_TAG_OVERHEAD + 24)) {
-        mtuBudget = mtu - SRTP_AUTH_TAG_OVERHEAD - 24;
-    } else {
-        mtuBudget = 0;
-    }
-
-    // Fallback to bare Opus when primary exceeds RED's 10-bit block length field.
-    if (opusFrameLength > RED_MAX_BLOCK_LEN) {
-        fallback = TRUE;
-        bodyBytes = opusFrameLength;
-    } else {
-        selectRedundantBlocks(pState, rtpTimestamp, mtuBudget, opusFrameLength, chosenIndices, &chosenCount, &bodyBytes);
-    }
+    planRedPayload(mtu, opusFrameLength, rtpTimestamp, pState, chosenIndices, &chosenCount, &bodyBytes, &fallback);
 
     if (sizeCalculationOnly) {
         *pPayloadLength = bodyBytes;
@@ -152,42 +201,13 @@ STATUS createPayloadForOpusRed(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLeng
         // Fallback packets must NOT pollute the redundancy ring: they represent an
         // out-of-band Opus payload whose size is incompatible with RED's wire format.
     } else {
-        UINT8 opusPt = pState->opusPayloadType;
-
-        // Write all non-last RED headers.
-        for (i = 0; i < chosenCount; i++) {
-            PRedSenderSlot pSlot = &pState->slots[chosenIndices[i]];
-            UINT32 tsDelta = rtpTimestamp - pSlot->rtpTimestamp;
-            UINT32 blockLen = pSlot->payloadLen;
-            pOut[0] = (BYTE) (0x80 | (opusPt & 0x7F));
-            pOut[1] = (BYTE) (((tsDelta & 0x3FFF) >> 6) & 0xFF);
-            pOut[2] = (BYTE) ((((tsDelta & 0x3F) << 2) | ((blockLen >> 8) & 0x3)) & 0xFF);
-            pOut[3] = (BYTE) (blockLen & 0xFF);
-            pOut += RED_HEADER_LEN_NON_LAST;
-        }
-
-        // Primary header (F=0, PT only).
-        pOut[0] = (BYTE) (opusPt & 0x7F);
-        pOut += RED_HEADER_LEN_LAST;
-
-        // Redundant payloads (oldest first).
-        for (i = 0; i < chosenCount; i++) {
-            PRedSenderSlot pSlot = &pState->slots[chosenIndices[i]];
-            MEMCPY(pOut, pSlot->payload, pSlot->payloadLen);
-            pOut += pSlot->payloadLen;
-        }
-
-        // Primary payload.
+        // RED headers and redundant payloads, then the primary payload
+        writeRedHeadersAndRedundancy(pState, rtpTimestamp, chosenIndices, chosenCount, pOut);
+        pOut += bodyBytes - opusFrameLength;
         MEMCPY(pOut, opusFrame, opusFrameLength);
         pOut += opusFrameLength;
 
-        // Now mutate the ring: write the just-sent primary into the newest slot.
-        // nextSlot points at the oldest; overwrite it and advance.
-        PRedSenderSlot pNewest = &pState->slots[pState->nextSlot];
-        pNewest->rtpTimestamp = rtpTimestamp;
-        pNewest->payloadLen = opusFrameLength;
-        MEMCPY(pNewest->payload, opusFrame, opusFrameLength);
-        pState->nextSlot = (pState->nextSlot + 1) % pState->redundancyLevel;
+        rememberRedPrimary(pState, rtpTimestamp, opusFrame, opusFrameLength);
     }
 
     *pPayloadLength = bodyBytes;
@@ -199,6 +219,40 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+STATUS packetizeOpusRedFrame(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLength, UINT32 rtpTimestamp, PRedSenderState pState,
+                             PPayloadDescriptorArray pDescriptorArray, PBOOL pIsFallbackToPlainOpus)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    BOOL fallback = FALSE;
+    UINT32 chosenIndices[RED_MAX_BLOCKS];
+    UINT32 chosenCount = 0;
+    UINT32 bodyBytes = 0;
+    PBYTE pHeader = NULL;
+
+    CHK(pState != NULL && opusFrame != NULL && pDescriptorArray != NULL && pIsFallbackToPlainOpus != NULL, STATUS_NULL_ARG);
+    CHK(opusFrameLength > 0, STATUS_INVALID_ARG);
+
+    planRedPayload(mtu, opusFrameLength, rtpTimestamp, pState, chosenIndices, &chosenCount, &bodyBytes, &fallback);
+
+    if (fallback) {
+        // Fallback packets must NOT pollute the redundancy ring
+        CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, 0, opusFrame, opusFrameLength, NULL));
+    } else {
+        // Headers and redundant blocks are copied out of the ring, the primary payload is referenced in place
+        CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, bodyBytes - opusFrameLength, opusFrame, opusFrameLength, &pHeader));
+        writeRedHeadersAndRedundancy(pState, rtpTimestamp, chosenIndices, chosenCount, pHeader);
+        rememberRedPrimary(pState, rtpTimestamp, opusFrame, opusFrameLength);
+    }
+
+    *pIsFallbackToPlainOpus = fallback;
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
 typedef struct {
     UINT8 payloadType;
     UINT32 tsOffset; // 0 for primary
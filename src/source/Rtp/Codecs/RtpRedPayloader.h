@@ -67,6 +67,17 @@ STATUS freeRedSenderState(PRedSenderState* ppState);
 STATUS createPayloadForOpusRed(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLength, UINT32 rtpTimestamp, PRedSenderState pState, PBYTE payloadBuffer,
                                PUINT32 pPayloadLength, PUINT32 pPayloadSubLength, PUINT32 pPayloadSubLenSize, PBOOL pIsFallbackToPlainOpus);
 
+/**
+ * Single-pass counterpart of createPayloadForOpusRed for the send path. Appends one descriptor whose header holds the
+ * RED header chain and the redundant blocks, followed by a reference to the primary Opus frame. Always mutates the ring
+ * unless falling back to bare Opus.
+ *
+ * @param pDescriptorArray         descriptor array the payload is appended to
+ * @param pIsFallbackToPlainOpus   out: TRUE if the payload is bare Opus and must be sent with the Opus PT
+ */
+STATUS packetizeOpusRedFrame(UINT32 mtu, PBYTE opusFrame, UINT32 opusFrameLength, UINT32 rtpTimestamp, PRedSenderState pState,
+                             PPayloadDescriptorArray pDescriptorArray, PBOOL pIsFallbackToPlainOpus);
+
 /**
  * Split a RED-wrapped RTP packet into synthetic per-Opus-frame RTP packets.
  * Each produced packet owns a freshly-allocated pRawPacket buffer; the caller
@@ -51,6 +51,28 @@ CleanUp:
     return retStatus;
 }
 
+STATUS packetizeVP8Frame(UINT32 mtu, PBYTE pData, UINT32 dataLen, PPayloadDescriptorArray pDescriptorArray)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 payloadRemaining, payloadLenConsumed;
+    PBYTE pPayload = NULL;
+
+    CHK(pData != NULL && pDescriptorArray != NULL, STATUS_NULL_ARG);
+    CHK(mtu > VP8_PAYLOAD_DESCRIPTOR_SIZE, STATUS_RTP_INPUT_MTU_TOO_SMALL);
+
+    for (payloadRemaining = dataLen; payloadRemaining > 0; payloadRemaining -= payloadLenConsumed) {
+        payloadLenConsumed = MIN(mtu - VP8_PAYLOAD_DESCRIPTOR_SIZE, payloadRemaining);
+        CHK_STATUS(appendPayloadDescriptor(pDescriptorArray, VP8_PAYLOAD_DESCRIPTOR_SIZE, pData + dataLen - payloadRemaining, payloadLenConsumed,
+                                           &pPayload));
+        *pPayload = payloadRemaining == dataLen ? VP8_PAYLOAD_DESCRIPTOR_START_OF_PARTITION_VALUE : 0;
+    }
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
 STATUS depayVP8FromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PBYTE pVp8Data, PUINT32 pVp8Length, PBOOL pIsStart)
 {
     ENTERS();
@@ -115,3 +137,27 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+STATUS depayVP8FragmentsFromRtpPayload(PBYTE pRawPacket, UINT32 packetLength, PRtcFrameFragment pFragments, PUINT32 pFragmentCount, PBOOL pIsStart)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 vp8Length = 0, capacity = 0, fragmentCount = 0;
+
+    CHK(pRawPacket != NULL && pFragmentCount != NULL, STATUS_NULL_ARG);
+    capacity = *pFragmentCount;
+    CHK(packetLength > 0, retStatus);
+
+    // The payload descriptor is all there is to strip, the partition data follows it unchanged
+    CHK_STATUS(depayVP8FromRtpPayload(pRawPacket, packetLength, NULL, &vp8Length, pIsStart));
+    CHK(vp8Length <= packetLength, STATUS_RTP_INPUT_PACKET_TOO_SMALL);
+    CHK_STATUS(appendFrameFragment(pFragments, capacity, &fragmentCount, pRawPacket + packetLength - vp8Length, vp8Length, FALSE));
+
+CleanUp:
+    if (pFragmentCount != NULL) {
+        *pFragmentCount = fragmentCount;
+    }
+
+    LEAVES();
+    return retStatus;
+}
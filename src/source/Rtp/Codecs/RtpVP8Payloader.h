@@ -14,7 +14,9 @@ extern "C" {
 #define VP8_PAYLOAD_DESCRIPTOR_START_OF_PARTITION_VALUE 0X10
 
 STATUS createPayloadForVP8(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
+STATUS packetizeVP8Frame(UINT32, PBYTE, UINT32, PPayloadDescriptorArray);
 STATUS depayVP8FromRtpPayload(PBYTE, UINT32, PBYTE, PUINT32, PBOOL);
+STATUS depayVP8FragmentsFromRtpPayload(PBYTE, UINT32, PRtcFrameFragment, PUINT32, PBOOL);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,146 @@
+/*******************************************
+PacketPool - fixed-size packet buffer slab
+*******************************************/
+
+#define LOG_CLASS "PacketPool"
+#include "../Include_i.h"
+
+#define PACKET_POOL_HEAD(tag, index) (((tag) << PACKET_POOL_INDEX_BITS) | (index))
+#define PACKET_POOL_HEAD_TAG(head)   ((head) >> PACKET_POOL_INDEX_BITS)
+#define PACKET_POOL_HEAD_INDEX(head) ((head) & PACKET_POOL_INDEX_MASK)
+
+STATUS createPacketPool(UINT32 blockSize, UINT32 blockCount, PPacketPool* ppPacketPool)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PPacketPool pPacketPool = NULL;
+    UINT32 i;
+
+    CHK(ppPacketPool != NULL, STATUS_NULL_ARG);
+    CHK(blockSize > 0 && blockCount > 0 && blockCount <= PACKET_POOL_MAX_BLOCK_COUNT, STATUS_INVALID_ARG);
+
+    pPacketPool = (PPacketPool) MEMCALLOC(1, SIZEOF(PacketPool));
+    CHK(pPacketPool != NULL, STATUS_NOT_ENOUGH_MEMORY);
+
+    pPacketPool->blockSize = blockSize;
+    pPacketPool->blockStride = ROUND_UP(blockSize, PACKET_POOL_BLOCK_ALIGNMENT);
+    pPacketPool->blockCount = blockCount;
+
+    pPacketPool->pSlab = (PBYTE) MEMALLOC((SIZE_T) pPacketPool->blockStride * blockCount);
+    CHK(pPacketPool->pSlab != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    pPacketPool->pSlabEnd = pPacketPool->pSlab + (SIZE_T) pPacketPool->blockStride * blockCount;
+
+    pPacketPool->pNextFree = (volatile SIZE_T*) MEMCALLOC(blockCount, SIZEOF(SIZE_T));
+    CHK(pPacketPool->pNextFree != NULL, STATUS_NOT_ENOUGH_MEMORY);
+
+    // Chain every block into the free list: block i (1-based) links to block i + 1, the last one terminates
+    for (i = 1; i < blockCount; i++) {
+        pPacketPool->pNextFree[i - 1] = i + 1;
+    }
+    ATOMIC_STORE(&pPacketPool->freeHead, PACKET_POOL_HEAD((SIZE_T) 0, (SIZE_T) 1));
+
+    *ppPacketPool = pPacketPool;
+    pPacketPool = NULL;
+
+CleanUp:
+    if (pPacketPool != NULL) {
+        freePacketPool(&pPacketPool);
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS freePacketPool(PPacketPool* ppPacketPool)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PPacketPool pPacketPool = NULL;
+
+    CHK(ppPacketPool != NULL, STATUS_NULL_ARG);
+    pPacketPool = *ppPacketPool;
+    CHK(pPacketPool != NULL, retStatus);
+
+    if (ATOMIC_LOAD(&pPacketPool->blocksInUse) != 0) {
+        DLOGW("Freeing packet pool with %u blocks still in use", (UINT32) ATOMIC_LOAD(&pPacketPool->blocksInUse));
+    }
+
+    SAFE_MEMFREE(pPacketPool->pSlab);
+    if (pPacketPool->pNextFree != NULL) {
+        MEMFREE((PVOID) pPacketPool->pNextFree);
+    }
+    MEMFREE(pPacketPool);
+    *ppPacketPool = NULL;
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
+PBYTE packetPoolAlloc(PPacketPool pPacketPool, UINT32 size)
+{
+    SIZE_T head, index, next;
+
+    if (pPacketPool == NULL) {
+        return (PBYTE) MEMALLOC(size);
+    }
+
+    if (size <= pPacketPool->blockSize) {
+        head = ATOMIC_LOAD(&pPacketPool->freeHead);
+        while ((index = PACKET_POOL_HEAD_INDEX(head)) != 0) {
+            // A stale next link is harmless: the tag bump by whoever raced us makes the CAS below fail
+            next = ATOMIC_LOAD(&pPacketPool->pNextFree[index - 1]);
+            if (ATOMIC_COMPARE_EXCHANGE(&pPacketPool->freeHead, &head, PACKET_POOL_HEAD(PACKET_POOL_HEAD_TAG(head) + 1, next))) {
+                ATOMIC_INCREMENT(&pPacketPool->hits);
+                ATOMIC_INCREMENT(&pPacketPool->blocksInUse);
+                return pPacketPool->pSlab + (index - 1) * pPacketPool->blockStride;
+            }
+        }
+    }
+
+    ATOMIC_INCREMENT(&pPacketPool->misses);
+    return (PBYTE) MEMALLOC(size);
+}
+
+VOID packetPoolFree(PPacketPool pPacketPool, PBYTE pBuffer)
+{
+    SIZE_T head, index;
+
+    if (pBuffer == NULL) {
+        return;
+    }
+
+    if (!packetPoolOwns(pPacketPool, pBuffer)) {
+        MEMFREE(pBuffer);
+        return;
+    }
+
+    index = (SIZE_T) (pBuffer - pPacketPool->pSlab) / pPacketPool->blockStride + 1;
+    head = ATOMIC_LOAD(&pPacketPool->freeHead);
+    do {
+        ATOMIC_STORE(&pPacketPool->pNextFree[index - 1], PACKET_POOL_HEAD_INDEX(head));
+    } while (!ATOMIC_COMPARE_EXCHANGE(&pPacketPool->freeHead, &head, PACKET_POOL_HEAD(PACKET_POOL_HEAD_TAG(head) + 1, index)));
+
+    ATOMIC_DECREMENT(&pPacketPool->blocksInUse);
+}
+
+BOOL packetPoolOwns(PPacketPool pPacketPool, PBYTE pBuffer)
+{
+    return pPacketPool != NULL && pBuffer >= pPacketPool->pSlab && pBuffer < pPacketPool->pSlabEnd;
+}
+
+STATUS packetPoolGetStats(PPacketPool pPacketPool, PPacketPoolStats pStats)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pPacketPool != NULL && pStats != NULL, STATUS_NULL_ARG);
+
+    pStats->hits = (UINT64) ATOMIC_LOAD(&pPacketPool->hits);
+    pStats->misses = (UINT64) ATOMIC_LOAD(&pPacketPool->misses);
+    pStats->blocksInUse = (UINT32) ATOMIC_LOAD(&pPacketPool->blocksInUse);
+    pStats->blockCount = pPacketPool->blockCount;
+    pStats->blockSize = pPacketPool->blockSize;
+
+CleanUp:
+    return retStatus;
+}
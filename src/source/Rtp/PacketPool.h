@@ -0,0 +1,118 @@
+/*******************************************
+PacketPool - fixed-size packet buffer slab
+*******************************************/
+#ifndef __KINESIS_VIDEO_WEBRTC_CLIENT_RTP_PACKETPOOL_H
+#define __KINESIS_VIDEO_WEBRTC_CLIENT_RTP_PACKETPOOL_H
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The free list head packs a 1-based block index in the low bits and an ABA generation tag in the rest
+#define PACKET_POOL_INDEX_BITS      16
+#define PACKET_POOL_INDEX_MASK      ((SIZE_T) 0xFFFF)
+#define PACKET_POOL_MAX_BLOCK_COUNT 0xFFFF
+
+// Blocks may hold an RtpPacket header followed by its raw bytes so they must be aligned for UINT64 members
+#define PACKET_POOL_BLOCK_ALIGNMENT 8
+
+// Inbound RTP packets larger than this are served from the heap
+#define INBOUND_PACKET_POOL_MAX_PACKET_SIZE 1500
+
+// Number of preallocated inbound RTP packets per peer connection when KvsRtcConfiguration leaves it as 0
+#define DEFAULT_INBOUND_PACKET_POOL_SIZE 256
+
+/**
+ * Packet pool statistics
+ */
+typedef struct {
+    UINT64 hits;        //!< Allocations served from the slab
+    UINT64 misses;      //!< Allocations that fell back to the heap because the slab was exhausted or the request was too large
+    UINT32 blockCount;  //!< Number of blocks in the slab
+    UINT32 blockSize;   //!< Usable bytes per block
+    UINT32 blocksInUse; //!< Slab blocks currently handed out
+} PacketPoolStats, *PPacketPoolStats;
+
+/**
+ * Fixed-size block allocator backed by a single preallocated slab.
+ *
+ * Allocation and release are lock-free so blocks can be allocated on one thread (e.g. the receive thread)
+ * and released on another (e.g. the jitter buffer consumer or the timer thread). Requests that do not fit
+ * or arrive while the slab is exhausted fall back to MEMALLOC; packetPoolFree tells the two apart by address
+ * so callers never need to track where a block came from.
+ */
+typedef struct {
+    // Atomics are kept at the top of the struct so they stay aligned regardless of application packing
+    volatile SIZE_T freeHead;    //!< (generation tag << PACKET_POOL_INDEX_BITS) | 1-based index of the first free block
+    volatile SIZE_T hits;        //!< Allocations served from the slab
+    volatile SIZE_T misses;      //!< Allocations served from the heap
+    volatile SIZE_T blocksInUse; //!< Slab blocks currently handed out
+
+    UINT32 blockSize;          //!< Usable bytes per block
+    UINT32 blockStride;        //!< Distance between consecutive blocks in the slab
+    UINT32 blockCount;         //!< Number of blocks in the slab
+    PBYTE pSlab;               //!< Start of the slab
+    PBYTE pSlabEnd;            //!< One past the last byte of the slab
+    volatile SIZE_T* pNextFree; //!< Per-block free list link (1-based index, 0 terminates the list)
+} PacketPool, *PPacketPool;
+
+/**
+ * Create a packet pool
+ *
+ * @param[in] blockSize Usable bytes per block
+ * @param[in] blockCount Number of blocks to preallocate (1..PACKET_POOL_MAX_BLOCK_COUNT)
+ * @param[out] ppPacketPool Pointer to receive the new pool
+ * @return STATUS code
+ */
+STATUS createPacketPool(UINT32 blockSize, UINT32 blockCount, PPacketPool* ppPacketPool);
+
+/**
+ * Free a packet pool. All slab blocks must have been released back to the pool.
+ *
+ * @param[in,out] ppPacketPool Pointer to pool to free
+ * @return STATUS code
+ */
+STATUS freePacketPool(PPacketPool* ppPacketPool);
+
+/**
+ * Allocate a buffer of at least size bytes. Served from the slab when possible, from the heap otherwise.
+ * A NULL pool always allocates from the heap without touching any counters.
+ *
+ * @param[in] pPacketPool Pool instance, may be NULL
+ * @param[in] size Requested size in bytes
+ * @return Buffer pointer or NULL when the heap fallback fails
+ */
+PBYTE packetPoolAlloc(PPacketPool pPacketPool, UINT32 size);
+
+/**
+ * Release a buffer returned by packetPoolAlloc. Safe to call from any thread.
+ *
+ * @param[in] pPacketPool Pool instance the buffer was allocated from, may be NULL
+ * @param[in] pBuffer Buffer to release, may be NULL
+ */
+VOID packetPoolFree(PPacketPool pPacketPool, PBYTE pBuffer);
+
+/**
+ * Check whether a buffer lives in the pool slab
+ *
+ * @param[in] pPacketPool Pool instance, may be NULL
+ * @param[in] pBuffer Buffer to check
+ * @return TRUE if pBuffer points into the slab
+ */
+BOOL packetPoolOwns(PPacketPool pPacketPool, PBYTE pBuffer);
+
+/**
+ * Get packet pool statistics
+ *
+ * @param[in] pPacketPool Pool instance
+ * @param[out] pStats Statistics structure to fill
+ * @return STATUS code
+ */
+STATUS packetPoolGetStats(PPacketPool pPacketPool, PPacketPoolStats pStats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //__KINESIS_VIDEO_WEBRTC_CLIENT_RTP_PACKETPOOL_H
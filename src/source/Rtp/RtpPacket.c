@@ -12,6 +12,7 @@ STATUS createRtpPacket(UINT8 version, BOOL padding, BOOL extension, UINT8 csrcCo
     CHK(pRtpPacket != NULL, STATUS_NOT_ENOUGH_MEMORY);
     pRtpPacket->pRawPacket = NULL;
     pRtpPacket->rawPacketLength = 0;
+    pRtpPacket->pPacketPool = NULL;
     CHK_STATUS(setRtpPacket(version, padding, extension, csrcCount, marker, payloadType, sequenceNumber, timestamp, ssrc, csrcArray, extensionProfile,
                             extensionLength, extensionPayload, payload, payloadLength, pRtpPacket));
 
@@ -71,6 +72,12 @@ STATUS freeRtpPacket(PRtpPacket* ppRtpPacket)
 
     CHK(ppRtpPacket != NULL, STATUS_NULL_ARG);
 
+    if (*ppRtpPacket != NULL && (*ppRtpPacket)->pPacketPool != NULL) {
+        // Header and raw bytes share a single pool block
+        packetPoolFree((*ppRtpPacket)->pPacketPool, (PBYTE) *ppRtpPacket);
+        *ppRtpPacket = NULL;
+    }
+
     if (*ppRtpPacket != NULL) {
         SAFE_MEMFREE((*ppRtpPacket)->pRawPacket);
     }
@@ -92,6 +99,7 @@ STATUS createRtpPacketFromBytes(PBYTE rawPacket, UINT32 packetLength, PRtpPacket
     CHK(pRtpPacket != NULL, STATUS_NOT_ENOUGH_MEMORY);
     pRtpPacket->pRawPacket = rawPacket;
     pRtpPacket->rawPacketLength = packetLength;
+    pRtpPacket->pPacketPool = NULL;
     CHK_STATUS(setRtpPacketFromBytes(rawPacket, packetLength, pRtpPacket));
 
 CleanUp:
@@ -113,6 +121,53 @@ CleanUp:
     return retStatus;
 }
 
+STATUS createRtpPacketFromPool(PPacketPool pPacketPool, PBYTE rawPacket, UINT32 packetLength, PRtpPacket* ppRtpPacket)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PBYTE pBlock = NULL;
+    PRtpPacket pRtpPacket = NULL;
+
+    CHK(rawPacket != NULL && ppRtpPacket != NULL, STATUS_NULL_ARG);
+    CHK(packetLength >= MIN_HEADER_LENGTH, STATUS_RTP_INPUT_PACKET_TOO_SMALL);
+
+    // Without a pool this is a plain createRtpPacketFromBytes over a private copy of the bytes
+    if (pPacketPool == NULL) {
+        pBlock = (PBYTE) MEMALLOC(packetLength);
+        CHK(pBlock != NULL, STATUS_NOT_ENOUGH_MEMORY);
+        MEMCPY(pBlock, rawPacket, packetLength);
+        CHK_STATUS(createRtpPacketFromBytes(pBlock, packetLength, ppRtpPacket));
+        pBlock = NULL;
+        CHK(FALSE, retStatus);
+    }
+
+    // One block holds the RtpPacket followed by a private copy of the bytes. Oversized packets or an exhausted
+    // pool get a heap block with the same layout, which packetPoolFree releases with MEMFREE.
+    pBlock = packetPoolAlloc(pPacketPool, RTP_PACKET_POOL_HEADER_SIZE + packetLength);
+    CHK(pBlock != NULL, STATUS_NOT_ENOUGH_MEMORY);
+
+    pRtpPacket = (PRtpPacket) pBlock;
+    pRtpPacket->pRawPacket = pBlock + RTP_PACKET_POOL_HEADER_SIZE;
+    pRtpPacket->rawPacketLength = packetLength;
+    pRtpPacket->receivedTime = 0;
+    pRtpPacket->sentTime = 0;
+    pRtpPacket->isSynthetic = FALSE;
+    pRtpPacket->pPacketPool = pPacketPool;
+    MEMCPY(pRtpPacket->pRawPacket, rawPacket, packetLength);
+    CHK_STATUS(setRtpPacketFromBytes(pRtpPacket->pRawPacket, packetLength, pRtpPacket));
+
+    *ppRtpPacket = pRtpPacket;
+    pBlock = NULL;
+
+CleanUp:
+    packetPoolFree(pPacketPool, pBlock);
+
+    CHK_LOG_ERR(retStatus);
+
+    LEAVES();
+    return retStatus;
+}
+
 STATUS constructRetransmitRtpPacketFromBytes(PBYTE rawPacket, UINT32 packetLength, UINT16 sequenceNum, UINT8 payloadType, UINT32 ssrc,
                                              PRtpPacket* ppRtpPacket)
 {
@@ -122,6 +177,7 @@ STATUS constructRetransmitRtpPacketFromBytes(PBYTE rawPacket, UINT32 packetLengt
     PRtpPacket pRtpPacket = (PRtpPacket) MEMALLOC(SIZEOF(RtpPacket));
 
     CHK(pRtpPacket != NULL, STATUS_NOT_ENOUGH_MEMORY);
+    pRtpPacket->pPacketPool = NULL;
     CHK_STATUS(setRtpPacketFromBytes(rawPacket, packetLength, pRtpPacket));
     pPayload = (PBYTE) MEMALLOC(pRtpPacket->payloadLength + SIZEOF(UINT16));
     CHK(pPayload != NULL, STATUS_NOT_ENOUGH_MEMORY);
@@ -350,3 +406,199 @@ CleanUp:
     LEAVES();
     return retStatus;
 }
+
+VOID resetPayloadDescriptorArray(PPayloadDescriptorArray pDescriptorArray)
+{
+    if (pDescriptorArray != NULL) {
+        pDescriptorArray->descriptorCount = 0;
+        pDescriptorArray->scratchLength = 0;
+        pDescriptorArray->payloadLength = 0;
+    }
+}
+
+VOID freePayloadDescriptorArray(PPayloadDescriptorArray pDescriptorArray)
+{
+    if (pDescriptorArray != NULL) {
+        SAFE_MEMFREE(pDescriptorArray->descriptors);
+        SAFE_MEMFREE(pDescriptorArray->scratchBuffer);
+        MEMSET(pDescriptorArray, 0x00, SIZEOF(PayloadDescriptorArray));
+    }
+}
+
+STATUS appendPayloadDescriptor(PPayloadDescriptorArray pDescriptorArray, UINT32 headerLength, PBYTE pFrameData, UINT32 frameDataLength,
+                               PBYTE* ppHeader)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PPayloadDescriptor pDescriptor = NULL;
+    PVOID pNewBuffer = NULL;
+    UINT32 newCapacity;
+
+    CHK(pDescriptorArray != NULL && (pFrameData != NULL || frameDataLength == 0), STATUS_NULL_ARG);
+
+    if (pDescriptorArray->descriptorCount == pDescriptorArray->maxDescriptorCount) {
+        newCapacity = MAX(PAYLOAD_DESCRIPTOR_ARRAY_DEFAULT_COUNT, pDescriptorArray->maxDescriptorCount * 2);
+        CHK(NULL != (pNewBuffer = MEMREALLOC(pDescriptorArray->descriptors, newCapacity * SIZEOF(PayloadDescriptor))), STATUS_NOT_ENOUGH_MEMORY);
+        pDescriptorArray->descriptors = (PPayloadDescriptor) pNewBuffer;
+        pDescriptorArray->maxDescriptorCount = newCapacity;
+    }
+
+    if (pDescriptorArray->scratchLength + headerLength > pDescriptorArray->maxScratchLength) {
+        newCapacity = MAX(PAYLOAD_DESCRIPTOR_ARRAY_DEFAULT_SCRATCH, pDescriptorArray->maxScratchLength * 2);
+        newCapacity = MAX(newCapacity, pDescriptorArray->scratchLength + headerLength);
+        CHK(NULL != (pNewBuffer = MEMREALLOC(pDescriptorArray->scratchBuffer, newCapacity)), STATUS_NOT_ENOUGH_MEMORY);
+        pDescriptorArray->scratchBuffer = (PBYTE) pNewBuffer;
+        pDescriptorArray->maxScratchLength = newCapacity;
+    }
+
+    pDescriptor = &pDescriptorArray->descriptors[pDescriptorArray->descriptorCount++];
+    pDescriptor->headerOffset = pDescriptorArray->scratchLength;
+    pDescriptor->headerLength = headerLength;
+    pDescriptor->pFrameData = pFrameData;
+    pDescriptor->frameDataLength = frameDataLength;
+
+    pDescriptorArray->scratchLength += headerLength;
+    pDescriptorArray->payloadLength += headerLength + frameDataLength;
+
+    if (ppHeader != NULL) {
+        *ppHeader = pDescriptorArray->scratchBuffer + pDescriptor->headerOffset;
+    }
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS flattenPayloadDescriptors(PPayloadDescriptorArray pDescriptorArray, PPayloadArray pPayloadArray)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PPayloadDescriptor pDescriptor = NULL;
+    PBYTE pCurPtr = NULL;
+    UINT32 i;
+
+    CHK(pDescriptorArray != NULL && pPayloadArray != NULL, STATUS_NULL_ARG);
+
+    if (pDescriptorArray->payloadLength > pPayloadArray->maxPayloadLength) {
+        SAFE_MEMFREE(pPayloadArray->payloadBuffer);
+        pPayloadArray->maxPayloadLength = 0;
+        CHK(NULL != (pPayloadArray->payloadBuffer = (PBYTE) MEMALLOC(pDescriptorArray->payloadLength)), STATUS_NOT_ENOUGH_MEMORY);
+        pPayloadArray->maxPayloadLength = pDescriptorArray->payloadLength;
+    }
+
+    if (pDescriptorArray->descriptorCount > pPayloadArray->maxPayloadSubLenSize) {
+        SAFE_MEMFREE(pPayloadArray->payloadSubLength);
+        pPayloadArray->maxPayloadSubLenSize = 0;
+        CHK(NULL != (pPayloadArray->payloadSubLength = (PUINT32) MEMALLOC(pDescriptorArray->descriptorCount * SIZEOF(UINT32))),
+            STATUS_NOT_ENOUGH_MEMORY);
+        pPayloadArray->maxPayloadSubLenSize = pDescriptorArray->descriptorCount;
+    }
+
+    pCurPtr = pPayloadArray->payloadBuffer;
+    for (i = 0; i < pDescriptorArray->descriptorCount; i++) {
+        pDescriptor = &pDescriptorArray->descriptors[i];
+        if (pDescriptor->headerLength > 0) {
+            MEMCPY(pCurPtr, pDescriptorArray->scratchBuffer + pDescriptor->headerOffset, pDescriptor->headerLength);
+            pCurPtr += pDescriptor->headerLength;
+        }
+        if (pDescriptor->frameDataLength > 0) {
+            MEMCPY(pCurPtr, pDescriptor->pFrameData, pDescriptor->frameDataLength);
+            pCurPtr += pDescriptor->frameDataLength;
+        }
+        pPayloadArray->payloadSubLength[i] = pDescriptor->headerLength + pDescriptor->frameDataLength;
+    }
+
+    pPayloadArray->payloadLength = pDescriptorArray->payloadLength;
+    pPayloadArray->payloadSubLenSize = pDescriptorArray->descriptorCount;
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
+STATUS constructRtpPacketsFromDescriptors(PPayloadDescriptorArray pDescriptorArray, UINT8 payloadType, UINT16 startSequenceNumber, UINT32 timestamp,
+                                          UINT32 ssrc, PRtpPacket pPackets, UINT32 packetCount)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT16 sequenceNumber = startSequenceNumber;
+    PPayloadDescriptor pDescriptor = NULL;
+    UINT32 i = 0;
+
+    CHK(pDescriptorArray != NULL && pDescriptorArray->payloadLength > 0, retStatus);
+    CHK(pPackets != NULL, STATUS_NULL_ARG);
+    CHK(pDescriptorArray->descriptorCount <= packetCount, STATUS_BUFFER_TOO_SMALL);
+
+    for (i = 0; i < pDescriptorArray->descriptorCount; i++) {
+        pDescriptor = &pDescriptorArray->descriptors[i];
+        CHK_STATUS(setRtpPacket(2, FALSE, FALSE, 0, i == pDescriptorArray->descriptorCount - 1, payloadType, sequenceNumber, timestamp, ssrc, NULL,
+                                0, 0, NULL, NULL, pDescriptor->headerLength + pDescriptor->frameDataLength, pPackets + i));
+
+        sequenceNumber = GET_UINT16_SEQ_NUM(sequenceNumber + 1);
+    }
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
+STATUS createBytesFromRtpPacketDescriptor(PRtpPacket pRtpPacket, PPayloadDescriptorArray pDescriptorArray, UINT32 descriptorIndex, PBYTE pRawPacket,
+                                          PUINT32 pPacketLength)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PPayloadDescriptor pDescriptor = NULL;
+    UINT32 packetLength = 0;
+    PBYTE pCurPtr = NULL;
+
+    CHK(pRtpPacket != NULL && pDescriptorArray != NULL && pPacketLength != NULL, STATUS_NULL_ARG);
+    CHK(descriptorIndex < pDescriptorArray->descriptorCount, STATUS_INVALID_ARG);
+
+    pDescriptor = &pDescriptorArray->descriptors[descriptorIndex];
+    CHK(pRtpPacket->payload == NULL && pRtpPacket->payloadLength == pDescriptor->headerLength + pDescriptor->frameDataLength, STATUS_INVALID_ARG);
+
+    packetLength = RTP_GET_RAW_PACKET_SIZE(pRtpPacket);
+
+    // Check if we are trying to calculate the required size only
+    CHK(pRawPacket != NULL, retStatus);
+    CHK(*pPacketLength >= packetLength, STATUS_NOT_ENOUGH_MEMORY);
+
+    // Without a payload pointer only the RTP header is written, the payload is gathered from its two parts
+    CHK_STATUS(setBytesFromRtpPacket(pRtpPacket, pRawPacket, packetLength));
+    pCurPtr = pRawPacket + RTP_HEADER_LEN(pRtpPacket);
+    if (pDescriptor->headerLength > 0) {
+        MEMCPY(pCurPtr, pDescriptorArray->scratchBuffer + pDescriptor->headerOffset, pDescriptor->headerLength);
+        pCurPtr += pDescriptor->headerLength;
+    }
+    if (pDescriptor->frameDataLength > 0) {
+        MEMCPY(pCurPtr, pDescriptor->pFrameData, pDescriptor->frameDataLength);
+    }
+
+CleanUp:
+
+    if (pPacketLength != NULL) {
+        *pPacketLength = packetLength;
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS appendFrameFragment(PRtcFrameFragment pFragments, UINT32 capacity, PUINT32 pCount, PBYTE pData, UINT32 size, BOOL startCode)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pCount != NULL, STATUS_NULL_ARG);
+    CHK(size > 0, retStatus);
+
+    if (pFragments != NULL) {
+        CHK(*pCount < capacity, STATUS_BUFFER_TOO_SMALL);
+        pFragments[*pCount].pData = pData;
+        pFragments[*pCount].size = size;
+        pFragments[*pCount].startCode = startCode;
+    }
+    (*pCount)++;
+
+CleanUp:
+
+    return retStatus;
+}
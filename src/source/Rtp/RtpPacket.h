@@ -32,6 +32,9 @@ extern "C" {
 
 #define RTP_GET_RAW_PACKET_SIZE(pRtpPacket) (RTP_HEADER_LEN(pRtpPacket) + ((pRtpPacket)->payloadLength))
 
+// Offset of the raw bytes inside a block produced by createRtpPacketFromPool
+#define RTP_PACKET_POOL_HEADER_SIZE ROUND_UP(SIZEOF(RtpPacket), PACKET_POOL_BLOCK_ALIGNMENT)
+
 #define GET_UINT16_SEQ_NUM(seqIndex) ((UINT16) ((seqIndex) % (MAX_UINT16 + 1)))
 
 /*
@@ -50,6 +53,10 @@ extern "C" {
 #define TWCC_SEQNUM(extPayload)          ((UINT16) getUnalignedInt16BigEndian(extPayload + 1))
 
 typedef STATUS (*DepayRtpPayloadFunc)(PBYTE, UINT32, PBYTE, PUINT32, PBOOL);
+// Describes the depayloaded payload as fragments of the packet instead of copying it. With NULL fragments only the count is returned.
+// A fill may rebuild a NAL header over the first DEPAY_FRAGMENTS_REWRITE_SIZE bytes of the payload, a count writes nothing.
+typedef STATUS (*DepayRtpPayloadFragmentsFunc)(PBYTE, UINT32, PRtcFrameFragment, PUINT32, PBOOL);
+#define DEPAY_FRAGMENTS_REWRITE_SIZE 4
 
 /*
  *  0                   1                   2                   3
@@ -95,6 +102,38 @@ struct __Payloads {
 typedef struct __Payloads PayloadArray;
 typedef PayloadArray* PPayloadArray;
 
+// Initial capacities of a PayloadDescriptorArray, doubled whenever a frame needs more
+#define PAYLOAD_DESCRIPTOR_ARRAY_DEFAULT_COUNT   64
+#define PAYLOAD_DESCRIPTOR_ARRAY_DEFAULT_SCRATCH 1500
+
+/*
+ * One outbound RTP payload produced by a packetizer: the payload header bytes stored in the descriptor array's scratch
+ * buffer followed by a run of frame bytes that is referenced instead of copied. The header is the FU-A/FU indicator and
+ * header, the VP8 payload descriptor, or a whole aggregated payload such as STAP-A or RED. Either part can be empty.
+ */
+typedef struct {
+    UINT32 headerOffset;    //!< Offset of the payload header in the scratch buffer
+    UINT32 headerLength;    //!< Length of the payload header
+    PBYTE pFrameData;       //!< Frame bytes following the header. NULL if the whole payload is in the scratch buffer
+    UINT32 frameDataLength; //!< Number of frame bytes following the header
+} PayloadDescriptor, *PPayloadDescriptor;
+
+/*
+ * Reusable per-sender output of a packetizer. The packetizer appends one descriptor per RTP packet in a single pass over
+ * the frame, growing the arrays as it goes. Headers are addressed by offset so growing the scratch buffer keeps them valid.
+ */
+typedef struct {
+    PPayloadDescriptor descriptors;
+    UINT32 descriptorCount;
+    UINT32 maxDescriptorCount;
+    PBYTE scratchBuffer;
+    UINT32 scratchLength;
+    UINT32 maxScratchLength;
+    UINT32 payloadLength; //!< Sum of all header and frame data lengths
+} PayloadDescriptorArray, *PPayloadDescriptorArray;
+
+typedef STATUS (*RtpPacketizeFunc)(UINT32, PBYTE, UINT32, PPayloadDescriptorArray);
+
 typedef struct __RtpPacket RtpPacket;
 struct __RtpPacket {
     RtpPacketHeader header;
@@ -111,6 +150,9 @@ struct __RtpPacket {
     // sequence number, but they represent a prior Opus frame and must lose any
     // dedup race against a real packet carrying the same seqnum.
     BOOL isSynthetic;
+    // Set for packets created by createRtpPacketFromPool: the RtpPacket and its raw bytes share one block of this pool
+    // and freeRtpPacket hands the block back to it.
+    PPacketPool pPacketPool;
 };
 typedef RtpPacket* PRtpPacket;
 
@@ -118,12 +160,96 @@ STATUS createRtpPacket(UINT8, BOOL, BOOL, UINT8, BOOL, UINT8, UINT16, UINT32, UI
 STATUS setRtpPacket(UINT8, BOOL, BOOL, UINT8, BOOL, UINT8, UINT16, UINT32, UINT32, PUINT32, UINT16, UINT32, PBYTE, PBYTE, UINT32, PRtpPacket);
 STATUS freeRtpPacket(PRtpPacket*);
 STATUS createRtpPacketFromBytes(PBYTE, UINT32, PRtpPacket*);
+STATUS createRtpPacketFromPool(PPacketPool, PBYTE, UINT32, PRtpPacket*);
 STATUS constructRetransmitRtpPacketFromBytes(PBYTE, UINT32, UINT16, UINT8, UINT32, PRtpPacket*);
 STATUS setRtpPacketFromBytes(PBYTE, UINT32, PRtpPacket);
 STATUS createBytesFromRtpPacket(PRtpPacket, PBYTE, PUINT32);
 STATUS setBytesFromRtpPacket(PRtpPacket, PBYTE, UINT32);
 STATUS constructRtpPackets(PPayloadArray, UINT8, UINT16, UINT32, UINT32, PRtpPacket, UINT32);
 
+/**
+ * Drops the descriptors of the previous frame, keeping the allocations for reuse
+ *
+ * @param - PPayloadDescriptorArray - IN - Descriptor array
+ */
+VOID resetPayloadDescriptorArray(PPayloadDescriptorArray);
+
+/**
+ * Frees the buffers owned by the descriptor array. The array itself is not freed.
+ *
+ * @param - PPayloadDescriptorArray - IN - Descriptor array
+ */
+VOID freePayloadDescriptorArray(PPayloadDescriptorArray);
+
+/**
+ * Appends one payload to the descriptor array, growing it when full
+ *
+ * @param - PPayloadDescriptorArray - IN - Descriptor array
+ * @param - UINT32 - IN - Number of payload header bytes to reserve in the scratch buffer
+ * @param - PBYTE - IN - Frame bytes following the header, may be NULL if the length is 0
+ * @param - UINT32 - IN - Number of frame bytes following the header
+ * @param - PBYTE* - OUT/OPT - Reserved header bytes, valid until the next append
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS appendPayloadDescriptor(PPayloadDescriptorArray, UINT32, PBYTE, UINT32, PBYTE*);
+
+/**
+ * Copies the payloads described by the descriptor array into a contiguous PayloadArray, growing it when needed
+ *
+ * @param - PPayloadDescriptorArray - IN - Descriptor array filled by a packetizer
+ * @param - PPayloadArray - IN/OUT - Payload array, buffers may be reallocated
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS flattenPayloadDescriptors(PPayloadDescriptorArray, PPayloadArray);
+
+/**
+ * Sets up one RTP packet per descriptor. The packets carry no payload pointer, only its length; the payload bytes are
+ * gathered from the descriptors when the packets are serialized with createBytesFromRtpPacketDescriptor.
+ *
+ * @param - PPayloadDescriptorArray - IN - Descriptor array filled by a packetizer
+ * @param - UINT8 - IN - Payload type
+ * @param - UINT16 - IN - Sequence number of the first packet
+ * @param - UINT32 - IN - RTP timestamp
+ * @param - UINT32 - IN - SSRC
+ * @param - PRtpPacket - OUT - Packets, one per descriptor
+ * @param - UINT32 - IN - Number of packets available
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS constructRtpPacketsFromDescriptors(PPayloadDescriptorArray, UINT8, UINT16, UINT32, UINT32, PRtpPacket, UINT32);
+
+/**
+ * Serializes an RTP packet whose payload is described by a descriptor: the RTP header, the payload header from the
+ * scratch buffer and the referenced frame bytes are written straight into the output buffer, so the frame bytes are
+ * copied once on their way to the socket.
+ *
+ * @param - PRtpPacket - IN - Packet set up by constructRtpPacketsFromDescriptors
+ * @param - PPayloadDescriptorArray - IN - Descriptor array
+ * @param - UINT32 - IN - Index of the packet's descriptor
+ * @param - PBYTE - OUT/OPT - Output buffer, NULL to only compute the size
+ * @param - PUINT32 - IN/OUT - Output buffer size in, packet size out
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS createBytesFromRtpPacketDescriptor(PRtpPacket, PPayloadDescriptorArray, UINT32, PBYTE, PUINT32);
+
+/**
+ * Appends a fragment for a DepayRtpPayloadFragmentsFunc, or only counts it when the fragment array is NULL. Empty
+ * fragments are skipped.
+ *
+ * @param - PRtcFrameFragment - OUT/OPT - Fragment array, NULL to only count
+ * @param - UINT32 - IN - Number of fragments the array can hold
+ * @param - PUINT32 - IN/OUT - Number of fragments so far
+ * @param - PBYTE - IN - Fragment bytes
+ * @param - UINT32 - IN - Fragment size
+ * @param - BOOL - IN - Whether the fragment is an Annex-B start code
+ *
+ * @return - STATUS code of the execution. STATUS_BUFFER_TOO_SMALL when the array is full
+ */
+STATUS appendFrameFragment(PRtcFrameFragment, UINT32, PUINT32, PBYTE, UINT32, BOOL);
+
 #ifdef __cplusplus
 }
 #endif
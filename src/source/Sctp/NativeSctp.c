@@ -148,7 +148,7 @@ STATUS putSctpPacket(PSctpSession pSctpSession, PBYTE buf, UINT32 bufLen)
     locked = TRUE;
 
     // Check timers before processing
-    nowMs = GETTIME() / (10 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    nowMs = SCTP_NOW_MS();
     sctpAssocCheckTimers(&pSctpSession->assoc, nowMs, sctpOutboundBridge, (UINT64) pSctpSession);
 
     CHK_STATUS(sctpAssocHandlePacket(&pSctpSession->assoc, buf, bufLen, sctpOutboundBridge, (UINT64) pSctpSession, sctpMessageBridge,
@@ -178,7 +178,7 @@ STATUS sctpSessionTickTimers(PSctpSession pSctpSession)
     MUTEX_LOCK(pSctpSession->lock);
     locked = TRUE;
 
-    nowMs = GETTIME() / (10 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    nowMs = SCTP_NOW_MS();
     sctpAssocCheckTimers(&pSctpSession->assoc, nowMs, sctpOutboundBridge, (UINT64) pSctpSession);
 
 CleanUp:
@@ -189,6 +189,23 @@ CleanUp:
     return retStatus;
 }
 
+STATUS sctpSessionSetMaxMessageSize(PSctpSession pSctpSession, UINT32 maxMessageSize)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pSctpSession != NULL, STATUS_NULL_ARG);
+    CHK(maxMessageSize != 0, STATUS_INVALID_ARG);
+
+    MUTEX_LOCK(pSctpSession->lock);
+    pSctpSession->assoc.maxMessageSize = maxMessageSize;
+    MUTEX_UNLOCK(pSctpSession->lock);
+
+CleanUp:
+    LEAVES();
+    return retStatus;
+}
+
 STATUS sctpSessionWriteMessage(PSctpSession pSctpSession, UINT32 streamId, BOOL isBinary, PBYTE pMessage, UINT32 pMessageLen)
 {
     ENTERS();
@@ -93,6 +93,7 @@ STATUS sctpSessionWriteDcep(PSctpSession, UINT32, PCHAR, UINT32, PRtcDataChannel
 
 #ifdef ENABLE_NATIVE_SCTP
 STATUS sctpSessionTickTimers(PSctpSession);
+STATUS sctpSessionSetMaxMessageSize(PSctpSession, UINT32);
 #else
 // Callbacks used by usrsctp
 INT32 onSctpOutboundPacket(PVOID, PVOID, SIZE_T, UINT8, UINT8);
@@ -1,8 +1,6 @@
 #define LOG_CLASS "SctpAssoc"
 #include "../Include_i.h"
 
-#define SCTP_NOW_MS() (GETTIME() / (10 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND))
-
 // Comparisons for wrapping TSNs (RFC 9260 serial number arithmetic)
 #define TSN_LT(a, b)  ((INT32) ((a) - (b)) < 0)
 #define TSN_LTE(a, b) ((INT32) ((a) - (b)) <= 0)
@@ -29,8 +27,140 @@ static VOID sctpSendPacket(PSctpAssociation pAssoc, UINT32 packetLen, SctpAssocO
     outboundFn(outboundCustomData, pAssoc->outPacket, packetLen);
 }
 
+// Forward declarations
+static VOID sctpBundleSack(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData);
+static STATUS sctpBundleData(PSctpAssociation pAssoc, UINT16 streamId, UINT32 ppid, BOOL unordered, PBYTE pPayload, UINT32 payloadLen,
+                             UINT16 maxRetransmits, UINT64 lifetimeMs, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData);
+
+/******************************************************************************
+ * Bundling (RFC 9260 §6.10)
+ *
+ * SACK and DATA chunks accumulate in pAssoc->bundle and leave as one packet when
+ * the next chunk would not fit the MTU, or when the public call producing them
+ * returns. The bundle is therefore always empty between calls.
+ *****************************************************************************/
+
+static UINT32 sctpBundleCapacity(PSctpAssociation pAssoc)
+{
+    return MIN(pAssoc->mtu, SCTP_MAX_PACKET_SIZE);
+}
+
+static VOID sctpBundleSend(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
+{
+    if (pAssoc->bundleLen > SCTP_COMMON_HEADER_SIZE) {
+        sctpFinalizePacket(pAssoc->bundle, pAssoc->bundleLen);
+        outboundFn(outboundCustomData, pAssoc->bundle, pAssoc->bundleLen);
+    }
+    pAssoc->bundleLen = 0;
+}
+
+static VOID sctpBundleFlush(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
+{
+    // Outgoing DATA carries a SACK that is owed anyway for free
+    if (pAssoc->needSack && pAssoc->bundleLen > SCTP_COMMON_HEADER_SIZE) {
+        sctpBundleSack(pAssoc, outboundFn, outboundCustomData);
+    }
+    sctpBundleSend(pAssoc, outboundFn, outboundCustomData);
+}
+
+// Returns where a chunk of chunkLen (padded) bytes goes, sending what is bundled so far first if it would not fit
+static PBYTE sctpBundleReserve(PSctpAssociation pAssoc, UINT32 chunkLen, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
+{
+    if (pAssoc->bundleLen != 0 && pAssoc->bundleLen + chunkLen > sctpBundleCapacity(pAssoc)) {
+        sctpBundleFlush(pAssoc, outboundFn, outboundCustomData);
+    }
+    if (pAssoc->bundleLen == 0) {
+        pAssoc->bundleLen = sctpWriteCommonHeader(pAssoc->bundle, pAssoc->localPort, pAssoc->remotePort, pAssoc->peerVerificationTag);
+    }
+    return pAssoc->bundle + pAssoc->bundleLen;
+}
+
+/******************************************************************************
+ * Outstanding ring
+ *
+ * DATA chunks in flight live in pAssoc->outstanding at their TSN modulo
+ * SCTP_MAX_OUTSTANDING. The TSNs in flight are exactly (cumulativeAckTsn, nextTsn),
+ * so SACK and T3 processing only walk that window instead of the whole array.
+ *****************************************************************************/
+
+static UINT32 sctpOutstandingRoom(PSctpAssociation pAssoc)
+{
+    return SCTP_MAX_OUTSTANDING - (pAssoc->nextTsn - pAssoc->cumulativeAckTsn - 1);
+}
+
+static UINT32 sctpFragmentCount(PSctpAssociation pAssoc, UINT32 payloadLen)
+{
+    UINT32 maxDataPayload = pAssoc->mtu - SCTP_COMMON_HEADER_SIZE - SCTP_DATA_HEADER_SIZE;
+
+    return payloadLen <= maxDataPayload ? 1 : (payloadLen + maxDataPayload - 1) / maxDataPayload;
+}
+
+// Frees an entry that was acked or abandoned
+static VOID sctpOutstandingRelease(PSctpAssociation pAssoc, PSctpOutstandingData pEntry)
+{
+    pAssoc->flightSize -= pEntry->payloadLen;
+    if (pEntry->payload != NULL) {
+        MEMFREE(pEntry->payload);
+        pEntry->payload = NULL;
+    }
+    pEntry->inUse = FALSE;
+    pAssoc->outstandingCount--;
+}
+
+static VOID sctpBundleRetransmit(PSctpAssociation pAssoc, PSctpOutstandingData pEntry, SctpAssocOutboundPacketFn outboundFn,
+                                 UINT64 outboundCustomData)
+{
+    PBYTE pChunk;
+
+    if (pEntry->payload == NULL) {
+        return;
+    }
+
+    pChunk = sctpBundleReserve(pAssoc, SCTP_PAD4(SCTP_DATA_HEADER_SIZE + pEntry->payloadLen), outboundFn, outboundCustomData);
+    pAssoc->bundleLen +=
+        sctpWriteDataChunk(pChunk, pEntry->tsn, pEntry->streamId, pEntry->ssn, pEntry->ppid, pEntry->unordered, pEntry->payload, pEntry->payloadLen);
+    pChunk[1] = pEntry->flags;
+}
+
+// Holds a message the congestion window or the outstanding ring has no room for, see sctpDrainPendingQueue
+static VOID sctpQueuePending(PSctpAssociation pAssoc, UINT16 streamId, UINT32 ppid, BOOL unordered, PBYTE pPayload, UINT32 payloadLen,
+                             UINT16 maxRetransmits, UINT64 lifetimeMs)
+{
+    UINT32 slot;
+
+    if (pAssoc->pendingQueueCount >= SCTP_MAX_PENDING_SENDS) {
+        DLOGD("SCTP: Congestion window full, pending queue full, dropping (flightSize=%u cwnd=%u peerArwnd=%u)", pAssoc->flightSize, pAssoc->cwnd,
+              pAssoc->peerArwnd);
+        return;
+    }
+
+    for (slot = 0; slot < SCTP_MAX_PENDING_SENDS; slot++) {
+        if (!pAssoc->pendingQueue[slot].inUse) {
+            break;
+        }
+    }
+    if (slot >= SCTP_MAX_PENDING_SENDS) {
+        return;
+    }
+
+    pAssoc->pendingQueue[slot].streamId = streamId;
+    pAssoc->pendingQueue[slot].ppid = ppid;
+    pAssoc->pendingQueue[slot].unordered = unordered;
+    pAssoc->pendingQueue[slot].maxRetransmits = maxRetransmits;
+    pAssoc->pendingQueue[slot].lifetimeMs = lifetimeMs;
+    pAssoc->pendingQueue[slot].payloadLen = payloadLen;
+    pAssoc->pendingQueue[slot].payload = (PBYTE) MEMALLOC(payloadLen);
+    if (pAssoc->pendingQueue[slot].payload != NULL) {
+        MEMCPY(pAssoc->pendingQueue[slot].payload, pPayload, payloadLen);
+        pAssoc->pendingQueue[slot].inUse = TRUE;
+        pAssoc->pendingQueueCount++;
+        DLOGD("SCTP: Congestion window full, queued (slot=%u flightSize=%u cwnd=%u)", slot, pAssoc->flightSize, pAssoc->cwnd);
+    } else {
+        DLOGW("SCTP: OOM queuing congested message, dropping (stream=%u)", streamId);
+    }
+}
+
 // Flush queued messages after association reaches ESTABLISHED.
-// sctpAssocSend() is declared in SctpAssoc.h, so it's visible here.
 static VOID sctpFlushSendQueue(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
 {
     UINT32 i;
@@ -40,17 +170,19 @@ static VOID sctpFlushSendQueue(PSctpAssociation pAssoc, SctpAssocOutboundPacketF
         }
         DLOGD("SCTP: Flushing queued message for stream %u (ppid=%u, len=%u)", pAssoc->sendQueue[i].streamId, pAssoc->sendQueue[i].ppid,
               pAssoc->sendQueue[i].payloadLen);
-        sctpAssocSend(pAssoc, pAssoc->sendQueue[i].streamId, pAssoc->sendQueue[i].ppid, pAssoc->sendQueue[i].unordered, pAssoc->sendQueue[i].payload,
-                      pAssoc->sendQueue[i].payloadLen, pAssoc->sendQueue[i].maxRetransmits, pAssoc->sendQueue[i].lifetimeMs, outboundFn,
-                      outboundCustomData);
+        sctpBundleData(pAssoc, pAssoc->sendQueue[i].streamId, pAssoc->sendQueue[i].ppid, pAssoc->sendQueue[i].unordered, pAssoc->sendQueue[i].payload,
+                       pAssoc->sendQueue[i].payloadLen, pAssoc->sendQueue[i].maxRetransmits, pAssoc->sendQueue[i].lifetimeMs, outboundFn,
+                       outboundCustomData);
         pAssoc->sendQueue[i].inUse = FALSE;
         pAssoc->sendQueueCount--;
     }
 }
 
-static VOID sctpSendSack(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
+// Puts a SACK at the front of the bundle, ahead of any DATA as control chunks must be, and stops the delayed SACK timer
+static VOID sctpBundleSack(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
 {
-    UINT32 offset;
+    UINT32 sackLen;
+    PBYTE pChunks;
     UINT16 gapStarts[SCTP_MAX_GAP_BLOCKS];
     UINT16 gapEnds[SCTP_MAX_GAP_BLOCKS];
     UINT16 numGaps = 0;
@@ -58,6 +190,11 @@ static VOID sctpSendSack(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outb
     UINT32 sortedTsns[SCTP_MAX_RECEIVED];
     UINT32 sortedCount;
 
+    pAssoc->needSack = FALSE;
+    pAssoc->sackImmediately = FALSE;
+    pAssoc->sackPacketCount = 0;
+    pAssoc->sackDelayExpiry = 0;
+
     if (!pAssoc->peerCumulativeTsnValid) {
         return;
     }
@@ -98,11 +235,18 @@ static VOID sctpSendSack(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outb
         }
     }
 
-    offset = sctpWriteCommonHeader(pAssoc->outPacket, pAssoc->localPort, pAssoc->remotePort, pAssoc->peerVerificationTag);
-    offset += sctpWriteSackChunk(pAssoc->outPacket + offset, pAssoc->peerCumulativeTsn, SCTP_DEFAULT_ARWND, gapStarts, gapEnds, numGaps);
+    sackLen = SCTP_SACK_HEADER_SIZE + numGaps * 4;
+    if (pAssoc->bundleLen != 0 && pAssoc->bundleLen + sackLen > sctpBundleCapacity(pAssoc)) {
+        sctpBundleSend(pAssoc, outboundFn, outboundCustomData);
+    }
+    if (pAssoc->bundleLen == 0) {
+        pAssoc->bundleLen = sctpWriteCommonHeader(pAssoc->bundle, pAssoc->localPort, pAssoc->remotePort, pAssoc->peerVerificationTag);
+    }
 
-    sctpSendPacket(pAssoc, offset, outboundFn, outboundCustomData);
-    pAssoc->needSack = FALSE;
+    pChunks = pAssoc->bundle + SCTP_COMMON_HEADER_SIZE;
+    MEMMOVE(pChunks + sackLen, pChunks, pAssoc->bundleLen - SCTP_COMMON_HEADER_SIZE);
+    sctpWriteSackChunk(pChunks, pAssoc->peerCumulativeTsn, SCTP_DEFAULT_ARWND, gapStarts, gapEnds, numGaps);
+    pAssoc->bundleLen += sackLen;
 }
 
 static STATUS sctpHandleInit(PSctpAssociation pAssoc, PBYTE pValue, UINT32 valueLen, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
@@ -277,13 +421,215 @@ static STATUS sctpHandleCookieAck(PSctpAssociation pAssoc, SctpAssocOutboundPack
     return STATUS_SUCCESS;
 }
 
-static STATUS sctpHandleData(PSctpAssociation pAssoc, UINT8 flags, PBYTE pValue, UINT32 valueLen, SctpAssocOutboundPacketFn outboundFn,
-                             UINT64 outboundCustomData, SctpAssocMessageFn messageFn, UINT64 messageCustomData)
+/******************************************************************************
+ * Reassembly
+ *****************************************************************************/
+
+static VOID sctpReassemblyFree(PSctpReassembly pReassembly)
+{
+    PSctpReassemblyBlock pBlock, pNext;
+
+    for (pBlock = pReassembly->pHead; pBlock != NULL; pBlock = pNext) {
+        pNext = pBlock->pNext;
+        MEMFREE(pBlock);
+    }
+    MEMSET(pReassembly, 0x00, SIZEOF(SctpReassembly));
+}
+
+// Drops what was reassembled so far. The context stays so the remaining fragments are still recognized and acked.
+static VOID sctpReassemblyDiscard(PSctpReassembly pReassembly)
+{
+    PSctpReassemblyBlock pBlock, pNext;
+
+    for (pBlock = pReassembly->pHead; pBlock != NULL; pBlock = pNext) {
+        pNext = pBlock->pNext;
+        MEMFREE(pBlock);
+    }
+    pReassembly->pHead = NULL;
+    pReassembly->pTail = NULL;
+    pReassembly->discarding = TRUE;
+}
+
+static VOID sctpReassemblyAppend(PSctpAssociation pAssoc, PSctpReassembly pReassembly, PBYTE pPayload, UINT32 payloadLen)
+{
+    PSctpReassemblyBlock pBlock;
+    UINT32 copyLen;
+
+    if (!pReassembly->discarding && pReassembly->len + payloadLen > pAssoc->maxMessageSize) {
+        DLOGW("SCTP: Message on stream %u is larger than the maximum message size %u, dropping it", pReassembly->streamId, pAssoc->maxMessageSize);
+        sctpReassemblyDiscard(pReassembly);
+    }
+    pReassembly->len += payloadLen;
+
+    while (!pReassembly->discarding && payloadLen > 0) {
+        pBlock = pReassembly->pTail;
+        if (pBlock == NULL || pBlock->len == SCTP_REASSEMBLY_BLOCK_SIZE) {
+            pBlock = (PSctpReassemblyBlock) MEMALLOC(SIZEOF(SctpReassemblyBlock));
+            if (pBlock == NULL) {
+                DLOGW("SCTP: OOM reassembling a message on stream %u, dropping it", pReassembly->streamId);
+                sctpReassemblyDiscard(pReassembly);
+                break;
+            }
+            pBlock->pNext = NULL;
+            pBlock->len = 0;
+            if (pReassembly->pTail == NULL) {
+                pReassembly->pHead = pBlock;
+            } else {
+                pReassembly->pTail->pNext = pBlock;
+            }
+            pReassembly->pTail = pBlock;
+        }
+
+        copyLen = MIN(payloadLen, SCTP_REASSEMBLY_BLOCK_SIZE - pBlock->len);
+        MEMCPY(pBlock->data + pBlock->len, pPayload, copyLen);
+        pBlock->len += copyLen;
+        pPayload += copyLen;
+        payloadLen -= copyLen;
+    }
+}
+
+// Holds a fragment that got ahead of the fragment before it, keeping the list sorted by TSN
+static BOOL sctpReassemblyHold(PSctpAssociation pAssoc, UINT32 tsn, UINT16 streamId, BOOL isEnd, PBYTE pPayload, UINT32 payloadLen)
+{
+    PSctpHeldFragment pHeld, *ppPrev;
+
+    pHeld = (PSctpHeldFragment) MEMALLOC(SIZEOF(SctpHeldFragment) + payloadLen);
+    if (pHeld == NULL) {
+        return FALSE;
+    }
+    pHeld->tsn = tsn;
+    pHeld->streamId = streamId;
+    pHeld->isEnd = isEnd;
+    pHeld->len = payloadLen;
+    pHeld->pData = (PBYTE) (pHeld + 1);
+    MEMCPY(pHeld->pData, pPayload, payloadLen);
+
+    for (ppPrev = &pAssoc->pHeldFragments; *ppPrev != NULL && TSN_LT((*ppPrev)->tsn, tsn); ppPrev = &(*ppPrev)->pNext) {
+    }
+    pHeld->pNext = *ppPrev;
+    *ppPrev = pHeld;
+
+    return TRUE;
+}
+
+// Frees the held fragments up to and including tsn
+static VOID sctpReassemblyReleaseHeld(PSctpAssociation pAssoc, UINT32 tsn)
+{
+    PSctpHeldFragment pHeld;
+
+    while ((pHeld = pAssoc->pHeldFragments) != NULL && TSN_LTE(pHeld->tsn, tsn)) {
+        pAssoc->pHeldFragments = pHeld->pNext;
+        MEMFREE(pHeld);
+    }
+}
+
+// Adds a fragment to the message it belongs to, a BEGIN fragment starts a new one. A fragment ahead of the earlier
+// fragments of its message is held until they are in, and the held fragments following a fragment are spliced in
+// after it. Returns FALSE when the fragment could not be taken: no context is free for a new message, or no memory
+// to hold it. *ppComplete is set to the message when its END fragment is in.
+static BOOL sctpReassemblyAdd(PSctpAssociation pAssoc, UINT32 tsn, UINT16 streamId, UINT32 ppid, BOOL isBegin, BOOL isEnd, PBYTE pPayload,
+                              UINT32 payloadLen, PSctpReassembly* ppComplete)
+{
+    PSctpReassembly pReassembly = NULL;
+    PSctpHeldFragment pHeld, *ppPrev;
+    UINT32 i;
+
+    *ppComplete = NULL;
+    for (i = 0; i < SCTP_MAX_REASSEMBLY_CONTEXTS && pReassembly == NULL; i++) {
+        if (isBegin ? !pAssoc->reassembly[i].inUse
+                    : pAssoc->reassembly[i].inUse && pAssoc->reassembly[i].nextTsn == tsn && pAssoc->reassembly[i].streamId == streamId) {
+            pReassembly = &pAssoc->reassembly[i];
+        }
+    }
+
+    if (pReassembly == NULL) {
+        return isBegin ? FALSE : sctpReassemblyHold(pAssoc, tsn, streamId, isEnd, pPayload, payloadLen);
+    }
+
+    if (isBegin) {
+        pReassembly->inUse = TRUE;
+        pReassembly->streamId = streamId;
+        pReassembly->ppid = ppid;
+    }
+    pReassembly->nextTsn = tsn + 1;
+    sctpReassemblyAppend(pAssoc, pReassembly, pPayload, payloadLen);
+
+    // Splice in the fragments that were waiting for this one
+    ppPrev = &pAssoc->pHeldFragments;
+    while (!isEnd && (pHeld = *ppPrev) != NULL && TSN_LTE(pHeld->tsn, pReassembly->nextTsn)) {
+        if (pHeld->tsn != pReassembly->nextTsn || pHeld->streamId != streamId) {
+            ppPrev = &pHeld->pNext;
+            continue;
+        }
+        *ppPrev = pHeld->pNext;
+        pReassembly->nextTsn++;
+        sctpReassemblyAppend(pAssoc, pReassembly, pHeld->pData, pHeld->len);
+        isEnd = pHeld->isEnd;
+        MEMFREE(pHeld);
+    }
+
+    if (isEnd) {
+        *ppComplete = pReassembly;
+    }
+
+    return TRUE;
+}
+
+static VOID sctpReassemblyDeliver(PSctpReassembly pReassembly, SctpAssocMessageFn messageFn, UINT64 messageCustomData)
+{
+    PSctpReassemblyBlock pBlock;
+    PBYTE pMessage;
+    UINT32 offset = 0;
+
+    if (pReassembly->discarding || messageFn == NULL) {
+        // Nothing to deliver
+    } else if (pReassembly->pHead == pReassembly->pTail) {
+        // Fits a single block, delivered from there
+        messageFn(messageCustomData, pReassembly->streamId, pReassembly->ppid, pReassembly->pHead == NULL ? NULL : pReassembly->pHead->data,
+                  pReassembly->len);
+    } else if ((pMessage = (PBYTE) MEMALLOC(pReassembly->len)) != NULL) {
+        for (pBlock = pReassembly->pHead; pBlock != NULL; pBlock = pBlock->pNext) {
+            MEMCPY(pMessage + offset, pBlock->data, pBlock->len);
+            offset += pBlock->len;
+        }
+        messageFn(messageCustomData, pReassembly->streamId, pReassembly->ppid, pMessage, pReassembly->len);
+        MEMFREE(pMessage);
+    } else {
+        DLOGW("SCTP: OOM delivering a %u byte message on stream %u", pReassembly->len, pReassembly->streamId);
+    }
+
+    sctpReassemblyFree(pReassembly);
+}
+
+// An out-of-order TSN is taken once. A retransmission of one already held must not be delivered again, and one there
+// is no room to track is left for the peer to retransmit once the gap closes. Either way the peer gets a SACK.
+static BOOL sctpCanTakeOutOfOrderTsn(PSctpAssociation pAssoc, UINT32 tsn)
+{
+    UINT32 i;
+
+    if (pAssoc->receivedTsnCount >= SCTP_MAX_RECEIVED) {
+        return FALSE;
+    }
+
+    for (i = 0; i < pAssoc->receivedTsnCount; i++) {
+        if (pAssoc->receivedTsns[i] == tsn) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static STATUS sctpHandleData(PSctpAssociation pAssoc, UINT8 flags, PBYTE pValue, UINT32 valueLen, SctpAssocMessageFn messageFn,
+                             UINT64 messageCustomData)
 {
     UINT32 tsn, ppid;
-    UINT16 streamId, ssn;
+    UINT16 streamId;
     PBYTE pPayload;
     UINT32 payloadLen;
+    BOOL isBegin = (flags & SCTP_DATA_FLAG_BEGIN) != 0;
+    BOOL isEnd = (flags & SCTP_DATA_FLAG_END) != 0;
+    PSctpReassembly pReassembly = NULL;
 
     if (valueLen < 12) { // TSN(4) + SID(2) + SSN(2) + PPID(4) = 12 minimum
         return STATUS_SUCCESS;
@@ -295,7 +641,6 @@ static STATUS sctpHandleData(PSctpAssociation pAssoc, UINT8 flags, PBYTE pValue,
 
     tsn = (UINT32) getUnalignedInt32BigEndian((PINT32) (pValue + 0));
     streamId = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + 4));
-    ssn = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + 6));
     ppid = (UINT32) getUnalignedInt32BigEndian((PINT32) (pValue + 8));
     pPayload = pValue + 12;
     payloadLen = valueLen - 12;
@@ -306,10 +651,34 @@ static STATUS sctpHandleData(PSctpAssociation pAssoc, UINT8 flags, PBYTE pValue,
         pAssoc->peerCumulativeTsnValid = TRUE;
     }
 
+    if (TSN_LTE(tsn, pAssoc->peerCumulativeTsn)) {
+        // Duplicate or old TSN — ignore but still SACK
+        pAssoc->needSack = TRUE;
+        pAssoc->sackImmediately = TRUE;
+        return STATUS_SUCCESS;
+    }
+
+    if (tsn != pAssoc->peerCumulativeTsn + 1 && !sctpCanTakeOutOfOrderTsn(pAssoc, tsn)) {
+        pAssoc->needSack = TRUE;
+        pAssoc->sackImmediately = TRUE;
+        return STATUS_SUCCESS;
+    }
+
+    // A fragment that could not be taken is left unacked, the peer retransmits it
+    if (!(isBegin && isEnd) && !sctpReassemblyAdd(pAssoc, tsn, streamId, ppid, isBegin, isEnd, pPayload, payloadLen, &pReassembly)) {
+        DLOGV("SCTP: No room for fragment TSN %u on stream %u, not acking it", tsn, streamId);
+        return STATUS_SUCCESS;
+    }
+
     if (tsn == pAssoc->peerCumulativeTsn + 1) {
         // In-order: advance cumulative TSN
         pAssoc->peerCumulativeTsn = tsn;
 
+        // Closing a gap is worth telling the peer right away too
+        if (pAssoc->receivedTsnCount > 0) {
+            pAssoc->sackImmediately = TRUE;
+        }
+
         // Check if any out-of-order TSNs are now consecutive
         BOOL advanced = TRUE;
         while (advanced) {
@@ -326,67 +695,27 @@ static STATUS sctpHandleData(PSctpAssociation pAssoc, UINT8 flags, PBYTE pValue,
                 }
             }
         }
-    } else if (TSN_GT(tsn, pAssoc->peerCumulativeTsn + 1)) {
-        // Out-of-order: add to received list if not duplicate
-        BOOL duplicate = FALSE;
-        UINT32 k;
-        for (k = 0; k < pAssoc->receivedTsnCount; k++) {
-            if (pAssoc->receivedTsns[k] == tsn) {
-                duplicate = TRUE;
-                break;
-            }
-        }
-        if (!duplicate && pAssoc->receivedTsnCount < SCTP_MAX_RECEIVED) {
-            pAssoc->receivedTsns[pAssoc->receivedTsnCount++] = tsn;
-        }
+
+        // Whatever is still held below the cumulative TSN lost the start of its message to a FORWARD-TSN
+        sctpReassemblyReleaseHeld(pAssoc, pAssoc->peerCumulativeTsn);
     } else {
-        // Duplicate or old TSN — ignore but still SACK
-        pAssoc->needSack = TRUE;
-        sctpSendSack(pAssoc, outboundFn, outboundCustomData);
-        return STATUS_SUCCESS;
+        pAssoc->receivedTsns[pAssoc->receivedTsnCount++] = tsn;
+        // Report the gap right away so the peer can fast retransmit (RFC 9260 §6.7)
+        pAssoc->sackImmediately = TRUE;
     }
 
     pAssoc->needSack = TRUE;
 
-    // Deliver message to callback — handle both complete and fragmented messages
-    if (messageFn != NULL) {
-        BOOL isBegin = (flags & SCTP_DATA_FLAG_BEGIN) != 0;
-        BOOL isEnd = (flags & SCTP_DATA_FLAG_END) != 0;
-
-        if (isBegin && isEnd) {
-            // Complete unfragmented message — deliver immediately
+    // Deliver message to callback. An unfragmented message is handed over straight from the packet.
+    if (isBegin && isEnd) {
+        if (messageFn != NULL) {
             messageFn(messageCustomData, streamId, ppid, pPayload, payloadLen);
-        } else if (isBegin) {
-            // First fragment — start reassembly
-            if (pAssoc->reassemblyBuf == NULL) {
-                pAssoc->reassemblyBuf = (PBYTE) MEMALLOC(SCTP_MAX_REASSEMBLY_SIZE);
-            }
-            if (pAssoc->reassemblyBuf != NULL && payloadLen <= SCTP_MAX_REASSEMBLY_SIZE) {
-                MEMCPY(pAssoc->reassemblyBuf, pPayload, payloadLen);
-                pAssoc->reassemblyLen = payloadLen;
-                pAssoc->reassemblyStreamId = streamId;
-                pAssoc->reassemblySsn = ssn;
-                pAssoc->reassemblyPpid = ppid;
-                pAssoc->reassemblyInProgress = TRUE;
-            }
-        } else if (pAssoc->reassemblyInProgress) {
-            // Middle or last fragment — append
-            if (pAssoc->reassemblyBuf != NULL && pAssoc->reassemblyLen + payloadLen <= SCTP_MAX_REASSEMBLY_SIZE) {
-                MEMCPY(pAssoc->reassemblyBuf + pAssoc->reassemblyLen, pPayload, payloadLen);
-                pAssoc->reassemblyLen += payloadLen;
-            }
-            if (isEnd) {
-                // Last fragment — deliver complete message
-                messageFn(messageCustomData, pAssoc->reassemblyStreamId, pAssoc->reassemblyPpid, pAssoc->reassemblyBuf, pAssoc->reassemblyLen);
-                pAssoc->reassemblyInProgress = FALSE;
-                pAssoc->reassemblyLen = 0;
-            }
         }
+    } else if (pReassembly != NULL) {
+        sctpReassemblyDeliver(pReassembly, messageFn, messageCustomData);
     }
 
-    // Send SACK immediately
-    sctpSendSack(pAssoc, outboundFn, outboundCustomData);
-
+    // The SACK is decided on once the whole packet is processed, see sctpAssocHandlePacket
     return STATUS_SUCCESS;
 }
 
@@ -398,8 +727,9 @@ static VOID sctpDrainPendingQueue(PSctpAssociation pAssoc, SctpAssocOutboundPack
         if (!pAssoc->pendingQueue[slot].inUse) {
             continue;
         }
-        if (pAssoc->flightSize >= pAssoc->cwnd || pAssoc->flightSize >= pAssoc->peerArwnd || pAssoc->outstandingCount >= SCTP_MAX_OUTSTANDING) {
-            break; // still congested or outstanding table full — leave remaining entries in queue
+        if (pAssoc->flightSize >= pAssoc->cwnd || pAssoc->flightSize >= pAssoc->peerArwnd ||
+            sctpOutstandingRoom(pAssoc) < sctpFragmentCount(pAssoc, pAssoc->pendingQueue[slot].payloadLen)) {
+            break; // still congested or outstanding ring full — leave remaining entries in queue
         }
         // Snapshot and evict before calling sctpAssocSend, which may re-queue if still congested
         UINT16 streamId = pAssoc->pendingQueue[slot].streamId;
@@ -413,18 +743,84 @@ static VOID sctpDrainPendingQueue(PSctpAssociation pAssoc, SctpAssocOutboundPack
         pAssoc->pendingQueue[slot].inUse = FALSE;
         pAssoc->pendingQueueCount--;
 
-        // sctpAssocSend makes its own copy if it re-queues, so freeing payload after is safe
-        sctpAssocSend(pAssoc, streamId, ppid, unordered, payload, payloadLen, maxRetransmits, lifetimeMs, outboundFn, outboundCustomData);
+        // sctpBundleData makes its own copy if it re-queues, so freeing payload after is safe
+        sctpBundleData(pAssoc, streamId, ppid, unordered, payload, payloadLen, maxRetransmits, lifetimeMs, outboundFn, outboundCustomData);
         MEMFREE(payload);
     }
 }
 
+// Frees the chunks a SACK newly acknowledges, for TSNs in [startTsn, endTsn]. Returns the bytes acked.
+static UINT32 sctpAckRange(PSctpAssociation pAssoc, UINT32 startTsn, UINT32 endTsn, PUINT32 pHighestNewlyAcked)
+{
+    PSctpOutstandingData pEntry;
+    UINT32 tsn, bytesAcked = 0;
+
+    for (tsn = startTsn; TSN_LTE(tsn, endTsn); tsn++) {
+        pEntry = SCTP_OUTSTANDING_ENTRY(pAssoc, tsn);
+        if (!pEntry->inUse) {
+            continue;
+        }
+        bytesAcked += pEntry->payloadLen;
+        if (TSN_GT(tsn, *pHighestNewlyAcked)) {
+            *pHighestNewlyAcked = tsn;
+        }
+        sctpOutstandingRelease(pAssoc, pEntry);
+    }
+
+    return bytesAcked;
+}
+
+// RFC 9260 §7.2.4: TSNs still missing below the highest newly acked TSN (HTNA) get a miss indication, and the ones
+// reported missing three times are retransmitted right away, as many as fit one packet. Returns whether any was.
+static BOOL sctpFastRetransmit(PSctpAssociation pAssoc, UINT32 highestNewlyAcked, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
+{
+    PSctpOutstandingData pEntry;
+    UINT32 tsn, chunkLen;
+    UINT32 budget = sctpBundleCapacity(pAssoc) - SCTP_COMMON_HEADER_SIZE;
+    BOOL retransmitted = FALSE;
+
+    for (tsn = pAssoc->cumulativeAckTsn + 1; TSN_LT(tsn, highestNewlyAcked); tsn++) {
+        pEntry = SCTP_OUTSTANDING_ENTRY(pAssoc, tsn);
+        if (!pEntry->inUse) {
+            continue;
+        }
+        pEntry->missingReports++;
+        if (pEntry->missingReports < SCTP_FAST_RTX_REPORTS || pEntry->fastRetransmitted) {
+            continue;
+        }
+
+        // Left for the next SACK to pick up if this packet is full
+        chunkLen = SCTP_PAD4(SCTP_DATA_HEADER_SIZE + pEntry->payloadLen);
+        if (chunkLen > budget) {
+            continue;
+        }
+        budget -= chunkLen;
+
+        // Enter fast recovery once, the window is not cut again for losses from the same flight
+        if (!pAssoc->inFastRecovery) {
+            pAssoc->ssthresh = MAX(pAssoc->cwnd / 2, 4 * pAssoc->mtu);
+            pAssoc->cwnd = pAssoc->ssthresh;
+            pAssoc->inFastRecovery = TRUE;
+            pAssoc->fastRecoveryExitTsn = pAssoc->nextTsn - 1;
+        }
+
+        pEntry->fastRetransmitted = TRUE;
+        pEntry->retransmitCount++;
+        sctpBundleRetransmit(pAssoc, pEntry, outboundFn, outboundCustomData);
+        retransmitted = TRUE;
+        DLOGD("SCTP: Fast retransmit of TSN %u", tsn);
+    }
+
+    return retransmitted;
+}
+
 static STATUS sctpHandleSack(PSctpAssociation pAssoc, PBYTE pValue, UINT32 valueLen, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
 {
-    UINT32 cumTsn, peerArwnd;
-    UINT16 numGaps, numDups;
+    UINT32 cumTsn, peerArwnd, highestTsn, highestNewlyAcked, gapOffset;
+    UINT16 numGaps, gapStart, gapEnd;
     UINT32 i;
     UINT32 bytesNewlyAcked = 0;
+    BOOL fastRetransmitted = FALSE;
 
     if (valueLen < 12) {
         return STATUS_SUCCESS;
@@ -433,66 +829,47 @@ static STATUS sctpHandleSack(PSctpAssociation pAssoc, PBYTE pValue, UINT32 value
     cumTsn = (UINT32) getUnalignedInt32BigEndian((PINT32) (pValue + 0));
     peerArwnd = (UINT32) getUnalignedInt32BigEndian((PINT32) (pValue + 4));
     numGaps = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + 8));
-    numDups = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + 10));
+
+    // A SACK older than one already processed has nothing new and may have been reordered
+    if (TSN_LT(cumTsn, pAssoc->cumulativeAckTsn)) {
+        return STATUS_SUCCESS;
+    }
 
     pAssoc->peerArwnd = peerArwnd;
 
-    // Mark outstanding DATA chunks as acked
-    for (i = 0; i < SCTP_MAX_OUTSTANDING; i++) {
-        if (!pAssoc->outstanding[i].inUse || pAssoc->outstanding[i].acked) {
-            continue;
-        }
-        if (TSN_LTE(pAssoc->outstanding[i].tsn, cumTsn)) {
-            pAssoc->outstanding[i].acked = TRUE;
-            bytesNewlyAcked += pAssoc->outstanding[i].payloadLen;
-            pAssoc->flightSize -= pAssoc->outstanding[i].payloadLen;
-            if (pAssoc->outstanding[i].payload != NULL) {
-                MEMFREE(pAssoc->outstanding[i].payload);
-                pAssoc->outstanding[i].payload = NULL;
-            }
-            pAssoc->outstanding[i].inUse = FALSE;
-            pAssoc->outstandingCount--;
-        }
+    // Nothing beyond the last TSN sent can be acked, clamping keeps the walks inside the ring window
+    highestTsn = pAssoc->nextTsn - 1;
+    if (TSN_GT(cumTsn, highestTsn)) {
+        cumTsn = highestTsn;
     }
 
-    // Also process gap ack blocks
+    highestNewlyAcked = pAssoc->cumulativeAckTsn;
+    bytesNewlyAcked += sctpAckRange(pAssoc, pAssoc->cumulativeAckTsn + 1, cumTsn, &highestNewlyAcked);
+    pAssoc->cumulativeAckTsn = cumTsn;
+
+    // Gap ack blocks are offsets from the cumulative TSN ack
     if (numGaps > 0 && valueLen >= 12 + numGaps * 4) {
-        UINT32 gapOffset = 12;
-        for (i = 0; i < numGaps; i++) {
-            UINT16 gapStart = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + gapOffset));
-            UINT16 gapEnd = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + gapOffset + 2));
-            gapOffset += 4;
-
-            UINT32 gapTsnStart = cumTsn + gapStart;
-            UINT32 gapTsnEnd = cumTsn + gapEnd;
-            UINT32 j;
-
-            for (j = 0; j < SCTP_MAX_OUTSTANDING; j++) {
-                if (!pAssoc->outstanding[j].inUse || pAssoc->outstanding[j].acked) {
-                    continue;
-                }
-                if (TSN_GTE(pAssoc->outstanding[j].tsn, gapTsnStart) && TSN_LTE(pAssoc->outstanding[j].tsn, gapTsnEnd)) {
-                    pAssoc->outstanding[j].acked = TRUE;
-                    bytesNewlyAcked += pAssoc->outstanding[j].payloadLen;
-                    pAssoc->flightSize -= pAssoc->outstanding[j].payloadLen;
-                    if (pAssoc->outstanding[j].payload != NULL) {
-                        MEMFREE(pAssoc->outstanding[j].payload);
-                        pAssoc->outstanding[j].payload = NULL;
-                    }
-                    pAssoc->outstanding[j].inUse = FALSE;
-                    pAssoc->outstandingCount--;
-                }
+        for (i = 0, gapOffset = 12; i < numGaps; i++, gapOffset += 4) {
+            gapStart = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + gapOffset));
+            gapEnd = (UINT16) getUnalignedInt16BigEndian((PINT16) (pValue + gapOffset + 2));
+            if (gapStart == 0 || gapEnd < gapStart) {
+                continue;
             }
+            bytesNewlyAcked += sctpAckRange(pAssoc, cumTsn + gapStart, TSN_GT(cumTsn + gapEnd, highestTsn) ? highestTsn : cumTsn + gapEnd,
+                                            &highestNewlyAcked);
         }
     }
 
-    // Update cumulative ack
-    if (TSN_GT(cumTsn, pAssoc->cumulativeAckTsn)) {
-        pAssoc->cumulativeAckTsn = cumTsn;
+    if (TSN_GT(highestNewlyAcked, cumTsn)) {
+        fastRetransmitted = sctpFastRetransmit(pAssoc, highestNewlyAcked, outboundFn, outboundCustomData);
     }
 
-    // Congestion control: slow start
-    if (bytesNewlyAcked > 0) {
+    if (pAssoc->inFastRecovery && TSN_GTE(pAssoc->cumulativeAckTsn, pAssoc->fastRecoveryExitTsn)) {
+        pAssoc->inFastRecovery = FALSE;
+    }
+
+    // Congestion control: the window does not grow during fast recovery
+    if (bytesNewlyAcked > 0 && !pAssoc->inFastRecovery) {
         if (pAssoc->cwnd <= pAssoc->ssthresh) {
             // Slow start
             UINT32 increase = bytesNewlyAcked;
@@ -504,6 +881,9 @@ static STATUS sctpHandleSack(PSctpAssociation pAssoc, PBYTE pValue, UINT32 value
             // Congestion avoidance
             pAssoc->cwnd += pAssoc->mtu;
         }
+    }
+
+    if (bytesNewlyAcked > 0 || fastRetransmitted) {
         // Stop T3 if nothing outstanding
         if (pAssoc->outstandingCount == 0) {
             pAssoc->t3RtxExpiry = 0;
@@ -521,8 +901,7 @@ static STATUS sctpHandleSack(PSctpAssociation pAssoc, PBYTE pValue, UINT32 value
     return STATUS_SUCCESS;
 }
 
-static STATUS sctpHandleForwardTsn(PSctpAssociation pAssoc, PBYTE pValue, UINT32 valueLen, SctpAssocOutboundPacketFn outboundFn,
-                                   UINT64 outboundCustomData)
+static STATUS sctpHandleForwardTsn(PSctpAssociation pAssoc, PBYTE pValue, UINT32 valueLen)
 {
     UINT32 newCumTsn;
 
@@ -535,8 +914,17 @@ static STATUS sctpHandleForwardTsn(PSctpAssociation pAssoc, PBYTE pValue, UINT32
     if (TSN_GT(newCumTsn, pAssoc->peerCumulativeTsn)) {
         pAssoc->peerCumulativeTsn = newCumTsn;
 
+        // The rest of these messages was abandoned
+        UINT32 i;
+        for (i = 0; i < SCTP_MAX_REASSEMBLY_CONTEXTS; i++) {
+            if (pAssoc->reassembly[i].inUse && TSN_LTE(pAssoc->reassembly[i].nextTsn, newCumTsn)) {
+                sctpReassemblyFree(&pAssoc->reassembly[i]);
+            }
+        }
+        sctpReassemblyReleaseHeld(pAssoc, newCumTsn);
+
         // Remove any received TSNs <= newCumTsn
-        UINT32 i = 0;
+        i = 0;
         while (i < pAssoc->receivedTsnCount) {
             if (TSN_LTE(pAssoc->receivedTsns[i], newCumTsn)) {
                 pAssoc->receivedTsns[i] = pAssoc->receivedTsns[pAssoc->receivedTsnCount - 1];
@@ -563,9 +951,9 @@ static STATUS sctpHandleForwardTsn(PSctpAssociation pAssoc, PBYTE pValue, UINT32
         }
     }
 
-    // Send SACK in response
+    // SACK in response
     pAssoc->needSack = TRUE;
-    sctpSendSack(pAssoc, outboundFn, outboundCustomData);
+    pAssoc->sackImmediately = TRUE;
 
     return STATUS_SUCCESS;
 }
@@ -604,6 +992,7 @@ typedef struct {
     UINT64 outboundCustomData;
     SctpAssocMessageFn messageFn;
     UINT64 messageCustomData;
+    BOOL dataReceived;
 } SctpChunkDispatchContext;
 
 static STATUS sctpChunkDispatch(UINT8 type, UINT8 flags, PBYTE pValue, UINT32 valueLen, UINT64 customData)
@@ -625,14 +1014,14 @@ static STATUS sctpChunkDispatch(UINT8 type, UINT8 flags, PBYTE pValue, UINT32 va
             CHK_STATUS(sctpHandleCookieAck(pCtx->pAssoc, pCtx->outboundFn, pCtx->outboundCustomData));
             break;
         case SCTP_CHUNK_DATA:
-            CHK_STATUS(sctpHandleData(pCtx->pAssoc, flags, pValue, valueLen, pCtx->outboundFn, pCtx->outboundCustomData, pCtx->messageFn,
-                                      pCtx->messageCustomData));
+            pCtx->dataReceived = TRUE;
+            CHK_STATUS(sctpHandleData(pCtx->pAssoc, flags, pValue, valueLen, pCtx->messageFn, pCtx->messageCustomData));
             break;
         case SCTP_CHUNK_SACK:
             CHK_STATUS(sctpHandleSack(pCtx->pAssoc, pValue, valueLen, pCtx->outboundFn, pCtx->outboundCustomData));
             break;
         case SCTP_CHUNK_FORWARD_TSN:
-            CHK_STATUS(sctpHandleForwardTsn(pCtx->pAssoc, pValue, valueLen, pCtx->outboundFn, pCtx->outboundCustomData));
+            CHK_STATUS(sctpHandleForwardTsn(pCtx->pAssoc, pValue, valueLen));
             break;
         case SCTP_CHUNK_HEARTBEAT:
             // Respond with HEARTBEAT-ACK (echo the same data)
@@ -692,6 +1081,7 @@ VOID sctpAssocInit(PSctpAssociation pAssoc, UINT16 localPort, UINT16 remotePort,
     pAssoc->peerArwnd = SCTP_DEFAULT_ARWND;
     pAssoc->rtoMs = SCTP_RTO_INITIAL_MS;
     pAssoc->srttMs = 0;
+    pAssoc->maxMessageSize = DEFAULT_SCTP_MAX_MESSAGE_SIZE;
     pAssoc->tieTag = ((UINT64) sctpGenerateTag() << 32) | sctpGenerateTag();
 }
 
@@ -736,22 +1126,51 @@ STATUS sctpAssocHandlePacket(PSctpAssociation pAssoc, PBYTE pBuf, UINT32 bufLen,
     ctx.outboundCustomData = outboundCustomData;
     ctx.messageFn = messageFn;
     ctx.messageCustomData = messageCustomData;
+    ctx.dataReceived = FALSE;
 
     CHK_STATUS(sctpParseChunks(pBuf, bufLen, sctpChunkDispatch, (UINT64) &ctx));
 
+    // Delayed SACK (RFC 9260 §6.2): every second DATA-bearing packet or within SCTP_SACK_DELAY_MS, gaps and duplicates right away
+    if (pAssoc->needSack) {
+        if (ctx.dataReceived) {
+            pAssoc->sackPacketCount++;
+        }
+        if (pAssoc->sackImmediately || pAssoc->sackPacketCount >= SCTP_SACK_EVERY_N) {
+            sctpBundleSack(pAssoc, outboundFn, outboundCustomData);
+        } else if (pAssoc->sackDelayExpiry == 0) {
+            pAssoc->sackDelayExpiry = SCTP_NOW_MS() + SCTP_SACK_DELAY_MS;
+        }
+    }
+
 CleanUp:
+    sctpBundleFlush(pAssoc, outboundFn, outboundCustomData);
     return retStatus;
 }
 
 STATUS sctpAssocSend(PSctpAssociation pAssoc, UINT16 streamId, UINT32 ppid, BOOL unordered, PBYTE pPayload, UINT32 payloadLen, UINT16 maxRetransmits,
                      UINT64 lifetimeMs, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
 {
-    UINT32 offset;
+    STATUS retStatus = sctpBundleData(pAssoc, streamId, ppid, unordered, pPayload, payloadLen, maxRetransmits, lifetimeMs, outboundFn,
+                                      outboundCustomData);
+
+    sctpBundleFlush(pAssoc, outboundFn, outboundCustomData);
+
+    return retStatus;
+}
+
+// Does the work of sctpAssocSend but leaves the DATA chunks in the bundle, so callers sending several messages in a row
+// get them packed into as few packets as the MTU allows
+static STATUS sctpBundleData(PSctpAssociation pAssoc, UINT16 streamId, UINT32 ppid, BOOL unordered, PBYTE pPayload, UINT32 payloadLen,
+                             UINT16 maxRetransmits, UINT64 lifetimeMs, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
+{
+    PBYTE pChunk;
+    PSctpOutstandingData pEntry;
     UINT32 tsn;
     UINT16 ssn = 0;
+    UINT8 flags;
     UINT32 i;
     UINT64 nowMs = SCTP_NOW_MS();
-    UINT32 maxDataPayload;
+    UINT32 maxDataPayload, fragmentCount, fragmentLen, fragmentOffset = 0;
 
     if (pAssoc->state != SCTP_ASSOC_ESTABLISHED) {
         // Queue the message for later delivery (association not yet established)
@@ -776,41 +1195,24 @@ STATUS sctpAssocSend(PSctpAssociation pAssoc, UINT16 streamId, UINT32 ppid, BOOL
         return STATUS_SUCCESS; // Don't fail the session, just drop
     }
 
+    // Fragment if payload exceeds MTU
+    maxDataPayload = pAssoc->mtu - SCTP_COMMON_HEADER_SIZE - SCTP_DATA_HEADER_SIZE;
+    fragmentCount = sctpFragmentCount(pAssoc, payloadLen);
+    if (fragmentCount > SCTP_MAX_OUTSTANDING) {
+        DLOGW("SCTP: Message of %u bytes can never fit the outstanding window, dropping (stream=%u)", payloadLen, streamId);
+        return STATUS_SUCCESS;
+    }
+
     // Enforce congestion window.
     // On a slow device the cwnd starts at 3*MTU (~3.5 KB) and grows only via SACKs.
-    // Ignoring this check fills the outstanding table (flightSize → 65536), starves
+    // Ignoring this check fills the outstanding ring (flightSize → 65536), starves
     // putSctpPacket/sctpSessionTickTimers of their mutex turn, and freezes the session.
     // Instead of dropping, queue the message; sctpDrainPendingQueue() sends it once a
     // SACK opens the window.  If the queue is also full we drop (log + silent discard).
-    if (pAssoc->flightSize >= pAssoc->cwnd || pAssoc->flightSize >= pAssoc->peerArwnd) {
-        if (pAssoc->pendingQueueCount < SCTP_MAX_PENDING_SENDS) {
-            UINT32 slot;
-            for (slot = 0; slot < SCTP_MAX_PENDING_SENDS; slot++) {
-                if (!pAssoc->pendingQueue[slot].inUse) {
-                    break;
-                }
-            }
-            if (slot < SCTP_MAX_PENDING_SENDS) {
-                pAssoc->pendingQueue[slot].streamId = streamId;
-                pAssoc->pendingQueue[slot].ppid = ppid;
-                pAssoc->pendingQueue[slot].unordered = unordered;
-                pAssoc->pendingQueue[slot].maxRetransmits = maxRetransmits;
-                pAssoc->pendingQueue[slot].lifetimeMs = lifetimeMs;
-                pAssoc->pendingQueue[slot].payloadLen = payloadLen;
-                pAssoc->pendingQueue[slot].payload = (PBYTE) MEMALLOC(payloadLen);
-                if (pAssoc->pendingQueue[slot].payload != NULL) {
-                    MEMCPY(pAssoc->pendingQueue[slot].payload, pPayload, payloadLen);
-                    pAssoc->pendingQueue[slot].inUse = TRUE;
-                    pAssoc->pendingQueueCount++;
-                    DLOGD("SCTP: Congestion window full, queued (slot=%u flightSize=%u cwnd=%u)", slot, pAssoc->flightSize, pAssoc->cwnd);
-                } else {
-                    DLOGW("SCTP: OOM queuing congested message, dropping (stream=%u)", streamId);
-                }
-            }
-        } else {
-            DLOGD("SCTP: Congestion window full, pending queue full, dropping (flightSize=%u cwnd=%u peerArwnd=%u)", pAssoc->flightSize, pAssoc->cwnd,
-                  pAssoc->peerArwnd);
-        }
+    // The ring must have room for every fragment too, checked before consuming TSN/SSN
+    // so a queued message does not leak sequence numbers.
+    if (pAssoc->flightSize >= pAssoc->cwnd || pAssoc->flightSize >= pAssoc->peerArwnd || sctpOutstandingRoom(pAssoc) < fragmentCount) {
+        sctpQueuePending(pAssoc, streamId, ppid, unordered, pPayload, payloadLen, maxRetransmits, lifetimeMs);
         return STATUS_SUCCESS;
     }
 
@@ -821,173 +1223,52 @@ STATUS sctpAssocSend(PSctpAssociation pAssoc, UINT16 streamId, UINT32 ppid, BOOL
         }
     }
 
-    // Fragment if payload exceeds MTU
-    maxDataPayload = pAssoc->mtu - SCTP_COMMON_HEADER_SIZE - SCTP_DATA_HEADER_SIZE;
-
-    if (payloadLen <= maxDataPayload) {
-        // Single fragment — common case
-
-        // Find a free outstanding slot BEFORE consuming TSN/SSN so that if the table
-        // is full we can queue to pendingQueue without leaking sequence numbers.
-        for (i = 0; i < SCTP_MAX_OUTSTANDING; i++) {
-            if (!pAssoc->outstanding[i].inUse) {
-                break;
-            }
+    for (i = 0; i < fragmentCount; i++) {
+        fragmentLen = MIN(maxDataPayload, payloadLen - fragmentOffset);
+        flags = unordered ? SCTP_DATA_FLAG_UNORDERED : 0;
+        if (i == 0) {
+            flags |= SCTP_DATA_FLAG_BEGIN;
         }
-        if (i >= SCTP_MAX_OUTSTANDING) {
-            // Outstanding table full — revert SSN and queue to pending so the message
-            // is sent once a SACK frees a slot (same path as congestion window full).
-            if (!unordered && streamId < SCTP_MAX_STREAMS) {
-                pAssoc->nextSsn[streamId]--;
-            }
-            if (pAssoc->pendingQueueCount < SCTP_MAX_PENDING_SENDS) {
-                UINT32 slot;
-                for (slot = 0; slot < SCTP_MAX_PENDING_SENDS; slot++) {
-                    if (!pAssoc->pendingQueue[slot].inUse) {
-                        break;
-                    }
-                }
-                if (slot < SCTP_MAX_PENDING_SENDS) {
-                    pAssoc->pendingQueue[slot].streamId = streamId;
-                    pAssoc->pendingQueue[slot].ppid = ppid;
-                    pAssoc->pendingQueue[slot].unordered = unordered;
-                    pAssoc->pendingQueue[slot].maxRetransmits = maxRetransmits;
-                    pAssoc->pendingQueue[slot].lifetimeMs = lifetimeMs;
-                    pAssoc->pendingQueue[slot].payloadLen = payloadLen;
-                    pAssoc->pendingQueue[slot].payload = (PBYTE) MEMALLOC(payloadLen);
-                    if (pAssoc->pendingQueue[slot].payload != NULL) {
-                        MEMCPY(pAssoc->pendingQueue[slot].payload, pPayload, payloadLen);
-                        pAssoc->pendingQueue[slot].inUse = TRUE;
-                        pAssoc->pendingQueueCount++;
-                        DLOGD("SCTP: Outstanding table full, queued to pending (slot=%u stream=%u)", slot, streamId);
-                    } else {
-                        DLOGW("SCTP: OOM queuing outstanding-full message, dropping (stream=%u)", streamId);
-                    }
-                }
-            } else {
-                DLOGD("SCTP: Outstanding table full, pending also full, dropping (stream=%u)", streamId);
-            }
-            return STATUS_SUCCESS;
+        if (i == fragmentCount - 1) {
+            flags |= SCTP_DATA_FLAG_END;
         }
 
         tsn = pAssoc->nextTsn++;
-
-        pAssoc->outstanding[i].tsn = tsn;
-        pAssoc->outstanding[i].streamId = streamId;
-        pAssoc->outstanding[i].ssn = ssn;
-        pAssoc->outstanding[i].ppid = ppid;
-        pAssoc->outstanding[i].payloadLen = payloadLen;
-        pAssoc->outstanding[i].unordered = unordered;
-        pAssoc->outstanding[i].sentTime = nowMs;
-        pAssoc->outstanding[i].retransmitCount = 0;
-        pAssoc->outstanding[i].acked = FALSE;
-        pAssoc->outstanding[i].abandoned = FALSE;
-        pAssoc->outstanding[i].maxRetransmits = maxRetransmits;
-        pAssoc->outstanding[i].lifetimeMs = lifetimeMs;
-        pAssoc->outstanding[i].creationTime = nowMs;
-        pAssoc->outstanding[i].inUse = TRUE;
+        pEntry = SCTP_OUTSTANDING_ENTRY(pAssoc, tsn);
+        MEMSET(pEntry, 0, SIZEOF(SctpOutstandingData));
+        pEntry->tsn = tsn;
+        pEntry->streamId = streamId;
+        pEntry->ssn = ssn;
+        pEntry->ppid = ppid;
+        pEntry->payloadLen = fragmentLen;
+        pEntry->unordered = unordered;
+        pEntry->flags = flags;
+        pEntry->sentTime = nowMs;
+        pEntry->maxRetransmits = maxRetransmits;
+        pEntry->lifetimeMs = lifetimeMs;
+        pEntry->creationTime = nowMs;
+        pEntry->inUse = TRUE;
 
         // Copy payload for retransmit
-        pAssoc->outstanding[i].payload = (PBYTE) MEMALLOC(payloadLen);
-        if (pAssoc->outstanding[i].payload != NULL) {
-            MEMCPY(pAssoc->outstanding[i].payload, pPayload, payloadLen);
+        pEntry->payload = (PBYTE) MEMALLOC(fragmentLen);
+        if (pEntry->payload != NULL) {
+            MEMCPY(pEntry->payload, pPayload + fragmentOffset, fragmentLen);
         }
 
         pAssoc->outstandingCount++;
-        pAssoc->flightSize += payloadLen;
-
-        // Send DATA chunk
-        offset = sctpWriteCommonHeader(pAssoc->outPacket, pAssoc->localPort, pAssoc->remotePort, pAssoc->peerVerificationTag);
-        offset += sctpWriteDataChunk(pAssoc->outPacket + offset, tsn, streamId, ssn, ppid, unordered, pPayload, payloadLen);
-        sctpSendPacket(pAssoc, offset, outboundFn, outboundCustomData);
-
-        // Start T3-rtx if not running
-        if (pAssoc->t3RtxExpiry == 0) {
-            pAssoc->t3RtxExpiry = nowMs + pAssoc->rtoMs;
-        }
-    } else {
-        // Fragmentation — split payload across multiple DATA chunks
-        UINT32 remaining = payloadLen;
-        UINT32 fragmentOffset = 0;
-        BOOL isFirst = TRUE;
-
-        while (remaining > 0) {
-            UINT32 fragmentLen = (remaining > maxDataPayload) ? maxDataPayload : remaining;
-            BOOL isLast = (remaining - fragmentLen == 0);
-            UINT8 fragFlags = 0;
-
-            if (isFirst) {
-                fragFlags |= SCTP_DATA_FLAG_BEGIN;
-            }
-            if (isLast) {
-                fragFlags |= SCTP_DATA_FLAG_END;
-            }
-            if (unordered) {
-                fragFlags |= SCTP_DATA_FLAG_UNORDERED;
-            }
+        pAssoc->flightSize += fragmentLen;
 
-            tsn = pAssoc->nextTsn++;
+        // Bundle DATA chunk
+        pChunk = sctpBundleReserve(pAssoc, SCTP_PAD4(SCTP_DATA_HEADER_SIZE + fragmentLen), outboundFn, outboundCustomData);
+        pAssoc->bundleLen += sctpWriteDataChunk(pChunk, tsn, streamId, ssn, ppid, unordered, pPayload + fragmentOffset, fragmentLen);
+        pChunk[1] = flags;
 
-            // Store in outstanding
-            for (i = 0; i < SCTP_MAX_OUTSTANDING; i++) {
-                if (!pAssoc->outstanding[i].inUse) {
-                    break;
-                }
-            }
-            if (i >= SCTP_MAX_OUTSTANDING) {
-                DLOGW("SCTP: Outstanding table full during fragmentation, dropping (stream=%u)", streamId);
-                return STATUS_SUCCESS;
-            }
-
-            pAssoc->outstanding[i].tsn = tsn;
-            pAssoc->outstanding[i].streamId = streamId;
-            pAssoc->outstanding[i].ssn = ssn;
-            pAssoc->outstanding[i].ppid = ppid;
-            pAssoc->outstanding[i].payloadLen = fragmentLen;
-            pAssoc->outstanding[i].unordered = unordered;
-            pAssoc->outstanding[i].sentTime = nowMs;
-            pAssoc->outstanding[i].retransmitCount = 0;
-            pAssoc->outstanding[i].acked = FALSE;
-            pAssoc->outstanding[i].abandoned = FALSE;
-            pAssoc->outstanding[i].maxRetransmits = maxRetransmits;
-            pAssoc->outstanding[i].lifetimeMs = lifetimeMs;
-            pAssoc->outstanding[i].creationTime = nowMs;
-            pAssoc->outstanding[i].inUse = TRUE;
-
-            pAssoc->outstanding[i].payload = (PBYTE) MEMALLOC(fragmentLen);
-            if (pAssoc->outstanding[i].payload != NULL) {
-                MEMCPY(pAssoc->outstanding[i].payload, pPayload + fragmentOffset, fragmentLen);
-            }
-
-            pAssoc->outstandingCount++;
-            pAssoc->flightSize += fragmentLen;
-
-            // Build and send DATA chunk with manual flags
-            offset = sctpWriteCommonHeader(pAssoc->outPacket, pAssoc->localPort, pAssoc->remotePort, pAssoc->peerVerificationTag);
-
-            UINT32 chunkLen = SCTP_DATA_HEADER_SIZE + fragmentLen;
-            PBYTE pChunk = pAssoc->outPacket + offset;
-            pChunk[0] = SCTP_CHUNK_DATA;
-            pChunk[1] = fragFlags;
-            putUnalignedInt16BigEndian(pChunk + 2, (INT16) chunkLen);
-            putUnalignedInt32BigEndian(pChunk + 4, (INT32) tsn);
-            putUnalignedInt16BigEndian(pChunk + 8, (INT16) streamId);
-            putUnalignedInt16BigEndian(pChunk + 10, (INT16) ssn);
-            putUnalignedInt32BigEndian(pChunk + 12, (INT32) ppid);
-            MEMCPY(pChunk + SCTP_DATA_HEADER_SIZE, pPayload + fragmentOffset, fragmentLen);
-            offset += ((chunkLen + 3) & ~3u);
-
-            sctpSendPacket(pAssoc, offset, outboundFn, outboundCustomData);
-
-            fragmentOffset += fragmentLen;
-            remaining -= fragmentLen;
-            isFirst = FALSE;
-        }
+        fragmentOffset += fragmentLen;
+    }
 
-        // Start T3-rtx if not running
-        if (pAssoc->t3RtxExpiry == 0) {
-            pAssoc->t3RtxExpiry = nowMs + pAssoc->rtoMs;
-        }
+    // Start T3-rtx if not running
+    if (pAssoc->t3RtxExpiry == 0) {
+        pAssoc->t3RtxExpiry = nowMs + pAssoc->rtoMs;
     }
 
     return STATUS_SUCCESS;
@@ -995,7 +1276,13 @@ STATUS sctpAssocSend(PSctpAssociation pAssoc, UINT16 streamId, UINT32 ppid, BOOL
 
 STATUS sctpAssocCheckTimers(PSctpAssociation pAssoc, UINT64 nowMs, SctpAssocOutboundPacketFn outboundFn, UINT64 outboundCustomData)
 {
-    UINT32 offset, i;
+    UINT32 offset, tsn;
+    PSctpOutstandingData pEntry;
+
+    // Delayed SACK timer
+    if (pAssoc->sackDelayExpiry != 0 && nowMs >= pAssoc->sackDelayExpiry) {
+        sctpBundleSack(pAssoc, outboundFn, outboundCustomData);
+    }
 
     // T1-init timer (INIT / COOKIE-ECHO retransmit)
     if (pAssoc->t1InitExpiry != 0 && nowMs >= pAssoc->t1InitExpiry) {
@@ -1043,49 +1330,39 @@ STATUS sctpAssocCheckTimers(PSctpAssociation pAssoc, UINT64 nowMs, SctpAssocOutb
             pAssoc->rtoMs = SCTP_RTO_MAX_MS;
         }
 
-        // Retransmit un-acked DATA chunks or abandon them (PR-SCTP)
-        for (i = 0; i < SCTP_MAX_OUTSTANDING; i++) {
-            if (!pAssoc->outstanding[i].inUse || pAssoc->outstanding[i].acked || pAssoc->outstanding[i].abandoned) {
+        // Fast recovery is over, the window was just reset
+        pAssoc->inFastRecovery = FALSE;
+
+        // Retransmit un-acked DATA chunks in TSN order or abandon them (PR-SCTP)
+        for (tsn = pAssoc->cumulativeAckTsn + 1; TSN_LT(tsn, pAssoc->nextTsn); tsn++) {
+            pEntry = SCTP_OUTSTANDING_ENTRY(pAssoc, tsn);
+            if (!pEntry->inUse) {
                 continue;
             }
 
-            pAssoc->outstanding[i].retransmitCount++;
+            pEntry->retransmitCount++;
+            pEntry->missingReports = 0;
 
             // PR-SCTP: check if should be abandoned
             BOOL shouldAbandon = FALSE;
-            if (pAssoc->outstanding[i].maxRetransmits != 0xFFFF && pAssoc->outstanding[i].retransmitCount > pAssoc->outstanding[i].maxRetransmits) {
+            if (pEntry->maxRetransmits != 0xFFFF && pEntry->retransmitCount > pEntry->maxRetransmits) {
                 shouldAbandon = TRUE;
             }
-            if (pAssoc->outstanding[i].lifetimeMs > 0 && nowMs - pAssoc->outstanding[i].creationTime > pAssoc->outstanding[i].lifetimeMs) {
+            if (pEntry->lifetimeMs > 0 && nowMs - pEntry->creationTime > pEntry->lifetimeMs) {
                 shouldAbandon = TRUE;
             }
 
             if (shouldAbandon) {
-                pAssoc->outstanding[i].abandoned = TRUE;
-                pAssoc->flightSize -= pAssoc->outstanding[i].payloadLen;
-
                 // Advance Advanced.Peer.Ack.Point
-                if (TSN_GT(pAssoc->outstanding[i].tsn, pAssoc->advancedPeerAckPoint)) {
-                    pAssoc->advancedPeerAckPoint = pAssoc->outstanding[i].tsn;
-                }
-
-                if (pAssoc->outstanding[i].payload != NULL) {
-                    MEMFREE(pAssoc->outstanding[i].payload);
-                    pAssoc->outstanding[i].payload = NULL;
+                if (TSN_GT(tsn, pAssoc->advancedPeerAckPoint)) {
+                    pAssoc->advancedPeerAckPoint = tsn;
                 }
-                pAssoc->outstanding[i].inUse = FALSE;
-                pAssoc->outstandingCount--;
+                sctpOutstandingRelease(pAssoc, pEntry);
                 continue;
             }
 
-            // Retransmit
-            if (pAssoc->outstanding[i].payload != NULL) {
-                offset = sctpWriteCommonHeader(pAssoc->outPacket, pAssoc->localPort, pAssoc->remotePort, pAssoc->peerVerificationTag);
-                offset += sctpWriteDataChunk(pAssoc->outPacket + offset, pAssoc->outstanding[i].tsn, pAssoc->outstanding[i].streamId,
-                                             pAssoc->outstanding[i].ssn, pAssoc->outstanding[i].ppid, pAssoc->outstanding[i].unordered,
-                                             pAssoc->outstanding[i].payload, pAssoc->outstanding[i].payloadLen);
-                sctpSendPacket(pAssoc, offset, outboundFn, outboundCustomData);
-            }
+            // Retransmit, bundled with the other expired chunks
+            sctpBundleRetransmit(pAssoc, pEntry, outboundFn, outboundCustomData);
         }
 
         // Send FORWARD-TSN if any chunks were abandoned
@@ -1103,6 +1380,8 @@ STATUS sctpAssocCheckTimers(PSctpAssociation pAssoc, UINT64 nowMs, SctpAssocOutb
         }
     }
 
+    sctpBundleFlush(pAssoc, outboundFn, outboundCustomData);
+
     return STATUS_SUCCESS;
 }
 
@@ -1126,6 +1405,7 @@ STATUS sctpAssocShutdown(PSctpAssociation pAssoc, SctpAssocOutboundPacketFn outb
 
 VOID sctpAssocCleanup(PSctpAssociation pAssoc)
 {
+    PSctpHeldFragment pHeld;
     UINT32 i;
     for (i = 0; i < SCTP_MAX_OUTSTANDING; i++) {
         if (pAssoc->outstanding[i].inUse && pAssoc->outstanding[i].payload != NULL) {
@@ -1146,9 +1426,11 @@ VOID sctpAssocCleanup(PSctpAssociation pAssoc)
     }
     pAssoc->pendingQueueCount = 0;
 
-    if (pAssoc->reassemblyBuf != NULL) {
-        MEMFREE(pAssoc->reassemblyBuf);
-        pAssoc->reassemblyBuf = NULL;
+    for (i = 0; i < SCTP_MAX_REASSEMBLY_CONTEXTS; i++) {
+        sctpReassemblyFree(&pAssoc->reassembly[i]);
+    }
+    while ((pHeld = pAssoc->pHeldFragments) != NULL) {
+        pAssoc->pHeldFragments = pHeld->pNext;
+        MEMFREE(pHeld);
     }
-    pAssoc->reassemblyInProgress = FALSE;
 }
@@ -1,6 +1,24 @@
 #define LOG_CLASS "SctpCrc32c"
 #include "../Include_i.h"
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SCTP_CRC32C_HW_SSE42
+#include <nmmintrin.h>
+#define SCTP_CRC32C_HW_TARGET __attribute__((target("sse4.2")))
+#elif defined(__aarch64__) && (defined(__linux__) || defined(__APPLE__)) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 10))
+#define SCTP_CRC32C_HW_ARMV8
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#if defined(__clang__)
+#define SCTP_CRC32C_HW_TARGET __attribute__((target("crc")))
+#else
+#define SCTP_CRC32C_HW_TARGET __attribute__((target("+crc")))
+#endif
+#endif
+
 // CRC32c lookup table using Castagnoli polynomial 0x82F63B78 (reflected form of 0x1EDC6F41)
 static const UINT32 sCrc32cTable[256] = {
     0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C, 0x26A1E7E8, 0xD4CA64EB, 0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B,
@@ -27,12 +45,186 @@ static const UINT32 sCrc32cTable[256] = {
     0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351,
 };
 
-UINT32 sctpCrc32c(PBYTE pData, UINT32 length)
+// Extra tables for slicing-by-8: sCrc32cSlicingTable[k][b] is the CRC of byte b followed by k zero bytes.
+// Row 0 is sCrc32cTable; the rest is derived from it the first time sctpCrc32c is called.
+static UINT32 sCrc32cSlicingTable[8][256];
+
+typedef UINT32 (*SctpCrc32cUpdateFunc)(UINT32, PBYTE, UINT32);
+
+static UINT32 sctpCrc32cUpdateBytewise(UINT32 crc, PBYTE pData, UINT32 length)
 {
-    UINT32 crc = 0xFFFFFFFF;
     UINT32 i;
     for (i = 0; i < length; i++) {
         crc = sCrc32cTable[(crc ^ pData[i]) & 0xFF] ^ (crc >> 8);
     }
-    return crc ^ 0xFFFFFFFF;
+    return crc;
+}
+
+static UINT32 sctpCrc32cUpdateSlicingBy8(UINT32 crc, PBYTE pData, UINT32 length)
+{
+    UINT32 lo, hi;
+
+    while (length >= 8) {
+        // The CRC is reflected, so the input words are consumed in little-endian byte order regardless of the host
+        lo = crc ^ ((UINT32) pData[0] | ((UINT32) pData[1] << 8) | ((UINT32) pData[2] << 16) | ((UINT32) pData[3] << 24));
+        hi = (UINT32) pData[4] | ((UINT32) pData[5] << 8) | ((UINT32) pData[6] << 16) | ((UINT32) pData[7] << 24);
+        crc = sCrc32cSlicingTable[7][lo & 0xFF] ^ sCrc32cSlicingTable[6][(lo >> 8) & 0xFF] ^ sCrc32cSlicingTable[5][(lo >> 16) & 0xFF] ^
+            sCrc32cSlicingTable[4][lo >> 24] ^ sCrc32cSlicingTable[3][hi & 0xFF] ^ sCrc32cSlicingTable[2][(hi >> 8) & 0xFF] ^
+            sCrc32cSlicingTable[1][(hi >> 16) & 0xFF] ^ sCrc32cSlicingTable[0][hi >> 24];
+        pData += 8;
+        length -= 8;
+    }
+
+    return sctpCrc32cUpdateBytewise(crc, pData, length);
+}
+
+#if defined(SCTP_CRC32C_HW_SSE42)
+SCTP_CRC32C_HW_TARGET static UINT32 sctpCrc32cUpdateHardware(UINT32 crc, PBYTE pData, UINT32 length)
+{
+    UINT64 crc64, word;
+
+    // Align to 8 bytes so the wide loads below never straddle a cache line
+    while (length > 0 && ((UINT_PTR) pData & 7) != 0) {
+        crc = _mm_crc32_u8(crc, *pData++);
+        length--;
+    }
+
+    crc64 = crc;
+    while (length >= 8) {
+        MEMCPY(&word, pData, SIZEOF(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        pData += 8;
+        length -= 8;
+    }
+    crc = (UINT32) crc64;
+
+    while (length > 0) {
+        crc = _mm_crc32_u8(crc, *pData++);
+        length--;
+    }
+
+    return crc;
+}
+
+static BOOL sctpCrc32cDetectHardware(VOID)
+{
+    return __builtin_cpu_supports("sse4.2") ? TRUE : FALSE;
+}
+#elif defined(SCTP_CRC32C_HW_ARMV8)
+SCTP_CRC32C_HW_TARGET static UINT32 sctpCrc32cUpdateHardware(UINT32 crc, PBYTE pData, UINT32 length)
+{
+    UINT64 word;
+
+    while (length > 0 && ((UINT_PTR) pData & 7) != 0) {
+        crc = __crc32cb(crc, *pData++);
+        length--;
+    }
+
+    while (length >= 8) {
+        MEMCPY(&word, pData, SIZEOF(word));
+        crc = __crc32cd(crc, word);
+        pData += 8;
+        length -= 8;
+    }
+
+    while (length > 0) {
+        crc = __crc32cb(crc, *pData++);
+        length--;
+    }
+
+    return crc;
+}
+
+static BOOL sctpCrc32cDetectHardware(VOID)
+{
+#if defined(__APPLE__)
+    // Every Apple arm64 core implements the ARMv8 CRC extension
+    return TRUE;
+#else
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0 ? TRUE : FALSE;
+#endif
+}
+#else
+static UINT32 sctpCrc32cUpdateHardware(UINT32 crc, PBYTE pData, UINT32 length)
+{
+    return sctpCrc32cUpdateSlicingBy8(crc, pData, length);
+}
+
+static BOOL sctpCrc32cDetectHardware(VOID)
+{
+    return FALSE;
+}
+#endif
+
+#define SCTP_CRC32C_STATE_UNINITIALIZED 0
+#define SCTP_CRC32C_STATE_INITIALIZING  1
+#define SCTP_CRC32C_STATE_READY         2
+
+static volatile SIZE_T gSctpCrc32cState = SCTP_CRC32C_STATE_UNINITIALIZED;
+static BOOL gSctpCrc32cHardwareAvailable = FALSE;
+
+// Resolves the implementation once. Callers racing with the thread doing the setup fall back to the byte-wise
+// table, which needs no initialization, so nobody ever blocks or sees a partially built slicing table.
+static SctpCrc32cUpdateFunc sctpCrc32cResolve(VOID)
+{
+    SIZE_T expected = SCTP_CRC32C_STATE_UNINITIALIZED;
+    UINT32 i, k;
+
+    if (ATOMIC_LOAD(&gSctpCrc32cState) != SCTP_CRC32C_STATE_READY) {
+        if (!ATOMIC_COMPARE_EXCHANGE(&gSctpCrc32cState, &expected, SCTP_CRC32C_STATE_INITIALIZING)) {
+            return sctpCrc32cUpdateBytewise;
+        }
+
+        for (i = 0; i < 256; i++) {
+            sCrc32cSlicingTable[0][i] = sCrc32cTable[i];
+        }
+        for (k = 1; k < 8; k++) {
+            for (i = 0; i < 256; i++) {
+                sCrc32cSlicingTable[k][i] = (sCrc32cSlicingTable[k - 1][i] >> 8) ^ sCrc32cTable[sCrc32cSlicingTable[k - 1][i] & 0xFF];
+            }
+        }
+        gSctpCrc32cHardwareAvailable = sctpCrc32cDetectHardware();
+        DLOGD("SCTP CRC32c using %s implementation", gSctpCrc32cHardwareAvailable ? "hardware" : "slicing-by-8");
+
+        ATOMIC_STORE(&gSctpCrc32cState, SCTP_CRC32C_STATE_READY);
+    }
+
+    return gSctpCrc32cHardwareAvailable ? sctpCrc32cUpdateHardware : sctpCrc32cUpdateSlicingBy8;
+}
+
+UINT32 sctpCrc32c(PBYTE pData, UINT32 length)
+{
+    return sctpCrc32cResolve()(0xFFFFFFFF, pData, length) ^ 0xFFFFFFFF;
+}
+
+UINT32 sctpCrc32cBytewise(PBYTE pData, UINT32 length)
+{
+    return sctpCrc32cUpdateBytewise(0xFFFFFFFF, pData, length) ^ 0xFFFFFFFF;
+}
+
+UINT32 sctpCrc32cSlicingBy8(PBYTE pData, UINT32 length)
+{
+    // Make sure the slicing tables are built before using them directly
+    sctpCrc32cResolve();
+    if (ATOMIC_LOAD(&gSctpCrc32cState) != SCTP_CRC32C_STATE_READY) {
+        return sctpCrc32cBytewise(pData, length);
+    }
+
+    return sctpCrc32cUpdateSlicingBy8(0xFFFFFFFF, pData, length) ^ 0xFFFFFFFF;
+}
+
+UINT32 sctpCrc32cHardware(PBYTE pData, UINT32 length)
+{
+    sctpCrc32cResolve();
+    if (ATOMIC_LOAD(&gSctpCrc32cState) != SCTP_CRC32C_STATE_READY) {
+        return sctpCrc32cBytewise(pData, length);
+    }
+
+    return (gSctpCrc32cHardwareAvailable ? sctpCrc32cUpdateHardware : sctpCrc32cUpdateSlicingBy8)(0xFFFFFFFF, pData, length) ^ 0xFFFFFFFF;
+}
+
+BOOL sctpCrc32cHardwareAvailable(VOID)
+{
+    sctpCrc32cResolve();
+    return gSctpCrc32cHardwareAvailable;
 }
@@ -13,9 +13,32 @@ extern "C" {
  * Compute CRC32c (Castagnoli) checksum for SCTP.
  * Uses polynomial 0x1EDC6F41 (reflected: 0x82F63B78).
  * This is different from the standard CRC32 (ISO polynomial 0xEDB88320) used by kvspic.
+ *
+ * The implementation is picked at runtime on first use: the SSE4.2 crc32 instruction on x86-64, the
+ * ARMv8 CRC extension on arm64, otherwise a slicing-by-8 table lookup.
  */
 UINT32 sctpCrc32c(PBYTE pData, UINT32 length);
 
+/**
+ * Reference byte-at-a-time table implementation
+ */
+UINT32 sctpCrc32cBytewise(PBYTE pData, UINT32 length);
+
+/**
+ * Portable slicing-by-8 implementation, processes 8 bytes per iteration
+ */
+UINT32 sctpCrc32cSlicingBy8(PBYTE pData, UINT32 length);
+
+/**
+ * Hardware CRC32c. Falls back to slicing-by-8 when the CPU lacks the instruction.
+ */
+UINT32 sctpCrc32cHardware(PBYTE pData, UINT32 length);
+
+/**
+ * @return - BOOL - TRUE if sctpCrc32c is backed by a CPU instruction
+ */
+BOOL sctpCrc32cHardwareAvailable(VOID);
+
 #ifdef __cplusplus
 }
 #endif
@@ -65,10 +65,11 @@ extern "C" {
 /******************************************************************************
  * Outstanding / receive buffer limits
  *****************************************************************************/
-#define SCTP_MAX_OUTSTANDING     2048
-#define SCTP_MAX_RECEIVED        2048
-#define SCTP_MAX_GAP_BLOCKS      128
-#define SCTP_MAX_REASSEMBLY_SIZE 65536 // 64KB max reassembled message
+#define SCTP_MAX_OUTSTANDING         2048 // power of two, the outstanding ring is indexed by TSN modulo this
+#define SCTP_MAX_RECEIVED            2048
+#define SCTP_MAX_GAP_BLOCKS          128
+#define SCTP_MAX_REASSEMBLY_CONTEXTS 16    // fragmented messages being reassembled at once, across all streams
+#define SCTP_REASSEMBLY_BLOCK_SIZE   16384 // reassembly buffers grow by this much
 
 /******************************************************************************
  * Cookie
@@ -80,11 +81,15 @@ extern "C" {
 /******************************************************************************
  * Timer defaults (milliseconds)
  *****************************************************************************/
+#define SCTP_NOW_MS()         (GETTIME() / HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
 #define SCTP_RTO_INITIAL_MS   1000
 #define SCTP_RTO_MIN_MS       1000
 #define SCTP_RTO_MAX_MS       60000
 #define SCTP_MAX_INIT_RETRANS 8
 #define SCTP_MAX_DATA_RETRANS 10
+#define SCTP_SACK_DELAY_MS    200 // RFC 9260 §6.2 delayed SACK
+#define SCTP_SACK_EVERY_N     2   // DATA-bearing packets acknowledged by one SACK
+#define SCTP_FAST_RTX_REPORTS 3   // RFC 9260 §7.2.4 miss indications before a fast retransmit
 
 /******************************************************************************
  * Association states (RFC 9260 §4)
@@ -130,15 +135,16 @@ typedef struct {
     PBYTE payload;
     UINT32 payloadLen;
     BOOL unordered;
+    UINT8 flags;     // B/E/U bits, so retransmissions keep the fragment boundaries
     UINT64 sentTime; // for RTT measurement (ms since epoch)
     UINT32 retransmitCount;
-    BOOL acked;
-    BOOL abandoned;        // PR-SCTP: message expired
-    UINT16 maxRetransmits; // 0xFFFF = unlimited
-    UINT64 lifetimeMs;     // 0 = unlimited
-    UINT64 creationTime;   // for lifetime check (ms since epoch)
-    BOOL inUse;            // slot is occupied
-} SctpOutstandingData;
+    UINT32 missingReports;  // SACKs that reported this TSN missing
+    BOOL fastRetransmitted; // a TSN is fast retransmitted at most once
+    UINT16 maxRetransmits;  // 0xFFFF = unlimited
+    UINT64 lifetimeMs;      // 0 = unlimited
+    UINT64 creationTime;    // for lifetime check (ms since epoch)
+    BOOL inUse;             // in flight: neither acked nor abandoned
+} SctpOutstandingData, *PSctpOutstandingData;
 
 /******************************************************************************
  * Received DATA chunk (for reassembly)
@@ -156,6 +162,41 @@ typedef struct {
     BOOL inUse;
 } SctpReceivedData;
 
+/******************************************************************************
+ * Fragmented message being reassembled (receive side)
+ *
+ * Fragments of a message carry consecutive TSNs, so a fragment belongs to the
+ * context expecting its TSN. Payload is appended to a list of fixed size blocks,
+ * so a growing message is never copied until it is complete.
+ *****************************************************************************/
+typedef struct __SctpReassemblyBlock {
+    struct __SctpReassemblyBlock* pNext;
+    UINT32 len;
+    BYTE data[SCTP_REASSEMBLY_BLOCK_SIZE];
+} SctpReassemblyBlock, *PSctpReassemblyBlock;
+
+// A fragment that arrived ahead of the fragment before it. It is acked and held, sorted by TSN, until the message
+// it belongs to reaches it.
+typedef struct __SctpHeldFragment {
+    struct __SctpHeldFragment* pNext;
+    UINT32 tsn;
+    UINT16 streamId;
+    BOOL isEnd;
+    UINT32 len;
+    PBYTE pData; // follows the struct in the same allocation
+} SctpHeldFragment, *PSctpHeldFragment;
+
+typedef struct {
+    BOOL inUse;
+    BOOL discarding; // over the maximum message size, the remaining fragments are acked but dropped
+    UINT16 streamId;
+    UINT32 ppid;
+    UINT32 nextTsn; // TSN of the next fragment
+    UINT32 len;
+    PSctpReassemblyBlock pHead;
+    PSctpReassemblyBlock pTail;
+} SctpReassembly, *PSctpReassembly;
+
 /******************************************************************************
  * Callback types for association outbound packets and inbound messages
  *****************************************************************************/
@@ -175,6 +216,7 @@ typedef struct {
     // TSN tracking (send side)
     UINT32 nextTsn;
     UINT32 cumulativeAckTsn; // last TSN acked by peer (initially nextTsn - 1)
+    // Ring of the TSNs in (cumulativeAckTsn, nextTsn), see SCTP_OUTSTANDING_ENTRY
     SctpOutstandingData outstanding[SCTP_MAX_OUTSTANDING];
     UINT32 outstandingCount;
 
@@ -187,6 +229,9 @@ typedef struct {
     UINT32 receivedTsns[SCTP_MAX_RECEIVED]; // out-of-order TSNs
     UINT32 receivedTsnCount;
     BOOL needSack;
+    BOOL sackImmediately;   // a gap or duplicate was seen, the peer should hear about it now
+    UINT32 sackPacketCount; // DATA-bearing packets received since the last SACK
+    UINT64 sackDelayExpiry; // delayed SACK timer (absolute ms), 0 when stopped
 
     // Congestion control
     UINT32 cwnd;
@@ -202,10 +247,19 @@ typedef struct {
     UINT32 rtoMs;
     UINT32 srttMs;
 
+    // Fast recovery (RFC 9260 §7.2.4)
+    BOOL inFastRecovery;
+    UINT32 fastRecoveryExitTsn; // highest TSN outstanding when fast recovery started
+
     // Outbound packet buffer
     BYTE outPacket[SCTP_MAX_PACKET_SIZE];
     UINT32 outPacketLen;
 
+    // Packet SACK and DATA chunks are bundled into until it is full or the current call returns.
+    // Kept apart from outPacket so standalone control packets can go out while chunks are being bundled.
+    BYTE bundle[SCTP_MAX_PACKET_SIZE];
+    UINT32 bundleLen; // 0 when empty, otherwise includes the common header
+
     // Cookie state (for handshake)
     SctpCookie cookie;
     BYTE cookieEchoData[SCTP_COOKIE_SIZE]; // raw cookie bytes for retransmit
@@ -219,12 +273,9 @@ typedef struct {
     UINT32 advancedPeerAckPoint;
 
     // Fragment reassembly (receive side)
-    PBYTE reassemblyBuf;
-    UINT32 reassemblyLen;
-    UINT16 reassemblyStreamId;
-    UINT16 reassemblySsn;
-    UINT32 reassemblyPpid;
-    BOOL reassemblyInProgress;
+    SctpReassembly reassembly[SCTP_MAX_REASSEMBLY_CONTEXTS];
+    PSctpHeldFragment pHeldFragments; // out-of-order fragments, sorted by TSN
+    UINT32 maxMessageSize;            // larger incoming messages are dropped, advertised as a=max-message-size
 
     // Queued messages (sent before ESTABLISHED)
 #define SCTP_MAX_QUEUED_MESSAGES 32
@@ -257,6 +308,10 @@ typedef struct {
     UINT32 pendingQueueCount;
 } SctpAssociation, *PSctpAssociation;
 
+// Outstanding entry of a TSN. Only meaningful for TSNs in (cumulativeAckTsn, nextTsn), which never span more
+// than SCTP_MAX_OUTSTANDING TSNs, and only while the entry is inUse.
+#define SCTP_OUTSTANDING_ENTRY(pAssoc, tsn) (&(pAssoc)->outstanding[(tsn) & (SCTP_MAX_OUTSTANDING - 1)])
+
 #ifdef __cplusplus
 }
 #endif
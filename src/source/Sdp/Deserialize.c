@@ -5,36 +5,40 @@ STATUS parseMediaName(PSessionDescription pSessionDescription, PCHAR pch, UINT32
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    CHK(pSessionDescription->mediaCount < MAX_SDP_SESSION_MEDIA_COUNT, STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT);
+    PSdpMediaDescription pMediaDescription = NULL;
 
-    STRNCPY(pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount].mediaName, (pch + SDP_ATTRIBUTE_LENGTH),
-            MIN(MAX_SDP_MEDIA_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
-    pSessionDescription->mediaCount++;
+    UNUSED_PARAM(lineLen);
+    CHK_STATUS(sdpAppendMediaDescription(pSessionDescription, &pMediaDescription));
+    pMediaDescription->mediaName = pch + SDP_ATTRIBUTE_LENGTH;
 
 CleanUp:
     LEAVES();
     return retStatus;
 }
 
+static STATUS parseAttribute(PSessionDescription pSessionDescription, PSdpMediaDescription pMediaDescription, PCHAR pch, UINT32 lineLen)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PCHAR search, value = NULL;
+
+    if ((search = STRNCHR(pch, lineLen, ':')) != NULL) {
+        *search = '\0';
+        value = search + 1;
+    }
+
+    CHK_STATUS(sdpAppendAttribute(pSessionDescription, pMediaDescription, pch + SDP_ATTRIBUTE_LENGTH, value));
+
+CleanUp:
+
+    return retStatus;
+}
+
 STATUS parseSessionAttributes(PSessionDescription pSessionDescription, PCHAR pch, UINT32 lineLen)
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    PCHAR search;
-
-    CHK(pSessionDescription->sessionAttributesCount < MAX_SDP_ATTRIBUTES_COUNT, STATUS_SDP_ATTRIBUTE_MAX_EXCEEDED);
-
-    if ((search = STRNCHR(pch, lineLen, ':')) == NULL) {
-        STRNCPY(pSessionDescription->sdpAttributes[pSessionDescription->sessionAttributesCount].attributeName, pch + SDP_ATTRIBUTE_LENGTH,
-                MIN(MAX_SDP_ATTRIBUTE_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
-    } else {
-        STRNCPY(pSessionDescription->sdpAttributes[pSessionDescription->sessionAttributesCount].attributeName, pch + SDP_ATTRIBUTE_LENGTH,
-                (search - (pch + SDP_ATTRIBUTE_LENGTH)));
-        STRNCPY(pSessionDescription->sdpAttributes[pSessionDescription->sessionAttributesCount].attributeValue, search + 1,
-                MIN(MAX_SDP_ATTRIBUTE_VALUE_LENGTH, lineLen - (search - pch + 1)));
-    }
 
-    pSessionDescription->sessionAttributesCount++;
+    CHK_STATUS(parseAttribute(pSessionDescription, NULL, pch, lineLen));
 
 CleanUp:
 
@@ -46,23 +50,8 @@ STATUS parseMediaAttributes(PSessionDescription pSessionDescription, PCHAR pch,
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    PCHAR search;
-    UINT16 currentMediaAttributesCount;
 
-    currentMediaAttributesCount = pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1].mediaAttributesCount;
-
-    CHK(currentMediaAttributesCount < MAX_SDP_ATTRIBUTES_COUNT, STATUS_SDP_ATTRIBUTE_MAX_EXCEEDED);
-
-    if ((search = STRNCHR(pch, lineLen, ':')) == NULL) {
-        STRNCPY(pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1].sdpAttributes[currentMediaAttributesCount].attributeName,
-                pch + SDP_ATTRIBUTE_LENGTH, MIN(MAX_SDP_ATTRIBUTE_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
-    } else {
-        STRNCPY(pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1].sdpAttributes[currentMediaAttributesCount].attributeName,
-                pch + SDP_ATTRIBUTE_LENGTH, (search - (pch + SDP_ATTRIBUTE_LENGTH)));
-        STRNCPY(pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1].sdpAttributes[currentMediaAttributesCount].attributeValue,
-                search + 1, MIN(MAX_SDP_ATTRIBUTE_VALUE_LENGTH, lineLen - (search - pch + 1)));
-    }
-    pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1].mediaAttributesCount++;
+    CHK_STATUS(parseAttribute(pSessionDescription, &pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1], pch, lineLen));
 
 CleanUp:
 
@@ -75,11 +64,15 @@ STATUS deserializeSessionDescription(PSessionDescription pSessionDescription, PC
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
     PCHAR curr, tail, next;
-    UINT32 lineLen;
+    UINT32 lineLen, sdpLen;
+    CHK(pSessionDescription != NULL, STATUS_NULL_ARG);
     CHK(sdpBytes != NULL, STATUS_SESSION_DESCRIPTION_INVALID_SESSION_DESCRIPTION);
 
-    curr = sdpBytes;
-    tail = sdpBytes + STRLEN(sdpBytes);
+    // One copy of the whole SDP, every string we keep is a NUL-terminated slice of it
+    sdpLen = (UINT32) STRLEN(sdpBytes);
+    CHK_STATUS(sdpArenaAlloc(pSessionDescription, sdpLen + 1, (PVOID*) &curr));
+    MEMCPY(curr, sdpBytes, sdpLen + 1);
+    tail = curr + sdpLen;
 
     while ((next = STRNCHR(curr, tail - curr, '\n')) != NULL) {
         lineLen = (UINT32) (next - curr);
@@ -87,6 +80,7 @@ STATUS deserializeSessionDescription(PSessionDescription pSessionDescription, PC
         if (lineLen > 0 && curr[lineLen - 1] == '\r') {
             lineLen--;
         }
+        curr[lineLen] = '\0';
 
         if (0 == STRNCMP(curr, SDP_MEDIA_NAME_MARKER, (ARRAY_SIZE(SDP_MEDIA_NAME_MARKER) - 1))) {
             CHK_STATUS(parseMediaName(pSessionDescription, curr, lineLen));
@@ -99,37 +93,32 @@ STATUS deserializeSessionDescription(PSessionDescription pSessionDescription, PC
 
             // Media Title
             if (0 == STRNCMP(curr, SDP_INFORMATION_MARKER, (ARRAY_SIZE(SDP_INFORMATION_MARKER) - 1))) {
-                STRNCPY(pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1].mediaTitle, (curr + SDP_ATTRIBUTE_LENGTH),
-                        MIN(MAX_SDP_MEDIA_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
+                pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount - 1].mediaTitle = curr + SDP_ATTRIBUTE_LENGTH;
             }
         } else {
             // SDP Session Name
             if (0 == STRNCMP(curr, SDP_SESSION_NAME_MARKER, (ARRAY_SIZE(SDP_SESSION_NAME_MARKER) - 1))) {
-                STRNCPY(pSessionDescription->sessionName, (curr + SDP_ATTRIBUTE_LENGTH),
-                        MIN(MAX_SDP_MEDIA_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
+                pSessionDescription->sessionName = curr + SDP_ATTRIBUTE_LENGTH;
             }
 
             // SDP Session Name
             if (0 == STRNCMP(curr, SDP_INFORMATION_MARKER, (ARRAY_SIZE(SDP_INFORMATION_MARKER) - 1))) {
-                STRNCPY(pSessionDescription->sessionInformation, (curr + SDP_ATTRIBUTE_LENGTH),
-                        MIN(MAX_SDP_MEDIA_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
+                pSessionDescription->sessionInformation = curr + SDP_ATTRIBUTE_LENGTH;
             }
 
             // SDP URI
             if (0 == STRNCMP(curr, SDP_URI_MARKER, (ARRAY_SIZE(SDP_URI_MARKER) - 1))) {
-                STRNCPY(pSessionDescription->uri, (curr + SDP_ATTRIBUTE_LENGTH), MIN(MAX_SDP_MEDIA_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
+                pSessionDescription->uri = curr + SDP_ATTRIBUTE_LENGTH;
             }
 
             // SDP Email Address
             if (0 == STRNCMP(curr, SDP_EMAIL_ADDRESS_MARKER, (ARRAY_SIZE(SDP_EMAIL_ADDRESS_MARKER) - 1))) {
-                STRNCPY(pSessionDescription->emailAddress, (curr + SDP_ATTRIBUTE_LENGTH),
-                        MIN(MAX_SDP_MEDIA_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
+                pSessionDescription->emailAddress = curr + SDP_ATTRIBUTE_LENGTH;
             }
 
             // SDP Phone number
             if (0 == STRNCMP(curr, SDP_PHONE_NUMBER_MARKER, (ARRAY_SIZE(SDP_PHONE_NUMBER_MARKER) - 1))) {
-                STRNCPY(pSessionDescription->phoneNumber, (curr + SDP_ATTRIBUTE_LENGTH),
-                        MIN(MAX_SDP_MEDIA_NAME_LENGTH, lineLen - SDP_ATTRIBUTE_LENGTH));
+                pSessionDescription->phoneNumber = curr + SDP_ATTRIBUTE_LENGTH;
             }
 
             if (0 == STRNCMP(curr, SDP_VERSION_MARKER, (ARRAY_SIZE(SDP_VERSION_MARKER) - 1))) {
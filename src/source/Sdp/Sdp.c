@@ -0,0 +1,226 @@
+#define LOG_CLASS "SDP"
+#include "../Include_i.h"
+
+// Keeps the block data 8-byte aligned on 32-bit platforms too
+#define SDP_ARENA_BLOCK_HEADER_SIZE ROUND_UP(SIZEOF(SdpArenaBlock), SIZEOF(UINT64))
+
+STATUS createSessionDescription(PSessionDescription* ppSessionDescription)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PSessionDescription pSessionDescription = NULL;
+
+    CHK(ppSessionDescription != NULL, STATUS_NULL_ARG);
+    CHK(NULL != (pSessionDescription = (PSessionDescription) MEMCALLOC(1, SIZEOF(SessionDescription))), STATUS_NOT_ENOUGH_MEMORY);
+
+    *ppSessionDescription = pSessionDescription;
+
+CleanUp:
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS freeSessionDescription(PSessionDescription* ppSessionDescription)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PSessionDescription pSessionDescription = NULL;
+
+    CHK(ppSessionDescription != NULL, STATUS_NULL_ARG);
+    pSessionDescription = *ppSessionDescription;
+    CHK(pSessionDescription != NULL, retStatus);
+
+    CHK_STATUS(resetSessionDescription(pSessionDescription));
+    MEMFREE(pSessionDescription);
+    *ppSessionDescription = NULL;
+
+CleanUp:
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS resetSessionDescription(PSessionDescription pSessionDescription)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PSdpArenaBlock pBlock, pNextBlock;
+
+    CHK(pSessionDescription != NULL, STATUS_NULL_ARG);
+
+    for (pBlock = pSessionDescription->pArena; pBlock != NULL; pBlock = pNextBlock) {
+        pNextBlock = pBlock->pNext;
+        MEMFREE(pBlock);
+    }
+
+    MEMSET(pSessionDescription, 0x00, SIZEOF(SessionDescription));
+
+CleanUp:
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS sdpArenaAlloc(PSessionDescription pSessionDescription, UINT32 size, PVOID* ppData)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PSdpArenaBlock pBlock = NULL;
+    BOOL dedicated;
+
+    CHK(pSessionDescription != NULL && ppData != NULL, STATUS_NULL_ARG);
+
+    size = ROUND_UP(size, SIZEOF(UINT64));
+    pBlock = pSessionDescription->pArena;
+    if (pBlock == NULL || pBlock->size - pBlock->used < size) {
+        // Large requests get a block of their own behind the current one, so its free space isn't abandoned
+        dedicated = size > SDP_ARENA_BLOCK_SIZE / 2;
+        CHK(NULL != (pBlock = (PSdpArenaBlock) MEMALLOC(SDP_ARENA_BLOCK_HEADER_SIZE + MAX(size, SDP_ARENA_BLOCK_SIZE))), STATUS_NOT_ENOUGH_MEMORY);
+        pBlock->size = MAX(size, SDP_ARENA_BLOCK_SIZE);
+        pBlock->used = 0;
+        if (dedicated && pSessionDescription->pArena != NULL) {
+            pBlock->pNext = pSessionDescription->pArena->pNext;
+            pSessionDescription->pArena->pNext = pBlock;
+        } else {
+            pBlock->pNext = pSessionDescription->pArena;
+            pSessionDescription->pArena = pBlock;
+        }
+    }
+
+    *ppData = (PBYTE) pBlock + SDP_ARENA_BLOCK_HEADER_SIZE + pBlock->used;
+    pBlock->used += size;
+
+CleanUp:
+
+    return retStatus;
+}
+
+static STATUS sdpArenaFormatV(PSessionDescription pSessionDescription, PCHAR* ppString, PCHAR format, va_list args)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    va_list sizeArgs;
+    INT32 length;
+
+    va_copy(sizeArgs, args);
+    length = vsnprintf(NULL, 0, format, sizeArgs);
+    va_end(sizeArgs);
+    CHK_ERR(length >= 0, STATUS_INTERNAL_ERROR, "Failed formatting SDP string: %s", format);
+
+    CHK_STATUS(sdpArenaAlloc(pSessionDescription, (UINT32) length + 1, (PVOID*) ppString));
+    vsnprintf(*ppString, (SIZE_T) length + 1, format, args);
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS sdpArenaFormat(PSessionDescription pSessionDescription, PCHAR* ppString, PCHAR format, ...)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    va_list args;
+
+    CHK(pSessionDescription != NULL && ppString != NULL && format != NULL, STATUS_NULL_ARG);
+
+    va_start(args, format);
+    retStatus = sdpArenaFormatV(pSessionDescription, ppString, format, args);
+    va_end(args);
+
+CleanUp:
+
+    return retStatus;
+}
+
+// Makes room for one more element, doubling the array into fresh arena memory. The old array stays in the arena until it is released.
+static STATUS sdpArenaGrowArray(PSessionDescription pSessionDescription, PVOID* ppArray, PUINT16 pCapacity, UINT16 count, UINT16 initialCapacity,
+                                UINT32 elementSize)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PVOID pNewArray = NULL;
+    UINT16 newCapacity;
+
+    CHK(count == *pCapacity, retStatus);
+
+    newCapacity = *pCapacity == 0 ? initialCapacity : (UINT16) MIN((UINT32) *pCapacity * 2, MAX_UINT16);
+    CHK_STATUS(sdpArenaAlloc(pSessionDescription, newCapacity * elementSize, &pNewArray));
+    if (count != 0) {
+        MEMCPY(pNewArray, *ppArray, count * elementSize);
+    }
+
+    *ppArray = pNewArray;
+    *pCapacity = newCapacity;
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS sdpAppendMediaDescription(PSessionDescription pSessionDescription, PSdpMediaDescription* ppMediaDescription)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PSdpMediaDescription pMediaDescription;
+
+    CHK(pSessionDescription != NULL && ppMediaDescription != NULL, STATUS_NULL_ARG);
+    CHK(pSessionDescription->mediaCount < MAX_SDP_SESSION_MEDIA_COUNT, STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT);
+
+    CHK_STATUS(sdpArenaGrowArray(pSessionDescription, (PVOID*) &pSessionDescription->mediaDescriptions, &pSessionDescription->mediaCapacity,
+                                 pSessionDescription->mediaCount, SDP_DEFAULT_MEDIA_CAPACITY, SIZEOF(SdpMediaDescription)));
+
+    pMediaDescription = &pSessionDescription->mediaDescriptions[pSessionDescription->mediaCount++];
+    MEMSET(pMediaDescription, 0x00, SIZEOF(SdpMediaDescription));
+    *ppMediaDescription = pMediaDescription;
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS sdpAppendAttribute(PSessionDescription pSessionDescription, PSdpMediaDescription pMediaDescription, PCHAR pName, PCHAR pValue)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PSdpAttributes* ppAttributes;
+    PUINT16 pCount, pCapacity;
+
+    CHK(pSessionDescription != NULL && pName != NULL, STATUS_NULL_ARG);
+
+    if (pMediaDescription == NULL) {
+        ppAttributes = &pSessionDescription->sdpAttributes;
+        pCount = &pSessionDescription->sessionAttributesCount;
+        pCapacity = &pSessionDescription->sessionAttributesCapacity;
+    } else {
+        ppAttributes = &pMediaDescription->sdpAttributes;
+        pCount = &pMediaDescription->mediaAttributesCount;
+        pCapacity = &pMediaDescription->mediaAttributesCapacity;
+    }
+
+    CHK(*pCount < MAX_SDP_ATTRIBUTES_COUNT, STATUS_SDP_ATTRIBUTE_MAX_EXCEEDED);
+    CHK_STATUS(
+        sdpArenaGrowArray(pSessionDescription, (PVOID*) ppAttributes, pCapacity, *pCount, SDP_DEFAULT_ATTRIBUTES_CAPACITY, SIZEOF(SdpAttributes)));
+
+    (*ppAttributes)[*pCount].attributeName = pName;
+    (*ppAttributes)[*pCount].attributeValue = pValue == NULL ? "" : pValue;
+    (*pCount)++;
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS sdpAppendAttributeFormat(PSessionDescription pSessionDescription, PSdpMediaDescription pMediaDescription, PCHAR pName, PCHAR format, ...)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PCHAR pValue = NULL;
+    va_list args;
+
+    CHK(pSessionDescription != NULL && pName != NULL && format != NULL, STATUS_NULL_ARG);
+
+    va_start(args, format);
+    retStatus = sdpArenaFormatV(pSessionDescription, &pValue, format, args);
+    va_end(args);
+    CHK_STATUS(retStatus);
+
+    CHK_STATUS(sdpAppendAttribute(pSessionDescription, pMediaDescription, pName, pValue));
+
+CleanUp:
+
+    return retStatus;
+}
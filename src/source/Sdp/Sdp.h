@@ -66,31 +66,10 @@ extern "C" {
 // https://datatracker.ietf.org/doc/html/rfc4566#section-5.2 -- the SDK sets it to "-" and the SDK does not parse incoming username either
 #define MAX_SDP_SESSION_USERNAME_LENGTH 32
 
-// https://datatracker.ietf.org/doc/html/rfc4566#section-6 -- name length restricted based on current supported attribute set
-#define MAX_SDP_ATTRIBUTE_NAME_LENGTH 32
-
-// One of the attributes is streamId + trackId which sums up to 512 maximum characters
+// Parsed attribute values are not bounded, this sizes the values we generate ourselves. One of them is streamId + trackId
+// which sums up to 512 maximum characters
 #define MAX_SDP_ATTRIBUTE_VALUE_LENGTH 512
 
-#define MAX_SDP_MEDIA_NAME_LENGTH 255
-
-/* https://tools.ietf.org/html/rfc4566#section-5.4. Given these are free-form textual strings, that is, the length could be anything.
- * Although our SDK parses this information, the SDK does not use it. Leaving this attribute in if SDK uses it in
- * the future, but keeping it at smaller size to ensure structure memory efficiency
- */
-#define MAX_SDP_MEDIA_TITLE_LENGTH 127
-
-/* https://tools.ietf.org/html/rfc4566#section-5.4. Given these are free-form textual strings, that is, the length could be anything.
- * Although our SDK parses this information, the SDK does not use it. Leaving this attribute in if SDK uses it in
- * the future, but keeping it at smaller size to ensure structure memory efficiency
- */
-#define MAX_SDP_SESSION_INFORMATION_LENGTH 127
-
-#define MAX_SDP_SESSION_NAME_LENGTH          255
-#define MAX_SDP_SESSION_URI_LENGTH           255
-#define MAX_SDP_SESSION_EMAIL_ADDRESS_LENGTH 255
-#define MAX_SDP_SESSION_PHONE_NUMBER_LENGTH  255
-
 #define MAX_SDP_TOKEN_LENGTH 128
 #define MAX_SDP_FMTP_VALUES  64
 
@@ -99,13 +78,20 @@ extern "C" {
 /**
  * https://tools.ietf.org/html/rfc4566#section-5.14
  *
- * reserving enough for audio, video, text, application and message for now
+ * Media sections are allocated on demand, this only bounds what a single description may make us allocate
  */
-#define MAX_SDP_SESSION_MEDIA_COUNT   5
+#define MAX_SDP_SESSION_MEDIA_COUNT   256
 #define MAX_SDP_MEDIA_BANDWIDTH_COUNT 2
 
 #define MAX_SDP_ATTRIBUTES_COUNT 256
 
+// Size of the arena blocks backing a SessionDescription. Larger requests, like the copy of a remote SDP, get a block of their own.
+#define SDP_ARENA_BLOCK_SIZE 8192
+
+// Initial capacities of the attribute and media section arrays, both double when full
+#define SDP_DEFAULT_ATTRIBUTES_CAPACITY 16
+#define SDP_DEFAULT_MEDIA_CAPACITY      4
+
 /*
  * c=<nettype> <addrtype> <connection-address>
  * https://tools.ietf.org/html/rfc4566#section-5.7
@@ -154,34 +140,47 @@ typedef struct {
  * a=<attribute>
  * a=<attribute>:<value>
  * https://tools.ietf.org/html/rfc4566#section-5.13
+ *
+ * Both strings live in the arena of the owning SessionDescription. attributeValue is an empty string, never NULL,
+ * for property attributes.
  */
 typedef struct {
-    CHAR attributeName[MAX_SDP_ATTRIBUTE_NAME_LENGTH + 1];
-    CHAR attributeValue[MAX_SDP_ATTRIBUTE_VALUE_LENGTH + 1];
+    PCHAR attributeName;
+    PCHAR attributeValue;
 } SdpAttributes, *PSdpAttributes;
 
 typedef struct {
     // m=<media> <port>/<number of ports> <proto> <fmt> ...
     // https://tools.ietf.org/html/rfc4566#section-5.14
-    CHAR mediaName[MAX_SDP_MEDIA_NAME_LENGTH + 1];
+    PCHAR mediaName;
 
     // i=<session description>
     // https://tools.ietf.org/html/rfc4566#section-5.4. Given these are free-form strings, the length could be anything.
     // Although our SDK parses this information, the SDK does not use it. Leaving this attribute in if SDK uses it in
     // the future
-    CHAR mediaTitle[MAX_SDP_MEDIA_TITLE_LENGTH + 1];
+    PCHAR mediaTitle;
 
     SdpConnectionInformation sdpConnectionInformation;
 
     SdpEncryptionKey sdpEncryptionKey;
 
-    SdpAttributes sdpAttributes[MAX_SDP_ATTRIBUTES_COUNT];
+    PSdpAttributes sdpAttributes;
+
+    UINT16 mediaAttributesCount;
 
-    UINT8 mediaAttributesCount;
+    UINT16 mediaAttributesCapacity;
 
     UINT8 mediaBandwidthCount;
 } SdpMediaDescription, *PSdpMediaDescription;
 
+typedef struct __SdpArenaBlock SdpArenaBlock, *PSdpArenaBlock;
+struct __SdpArenaBlock {
+    PSdpArenaBlock pNext;
+    UINT32 size;
+    UINT32 used;
+    // Block data follows
+};
+
 typedef struct {
     // https://tools.ietf.org/html/rfc4566#section-5.1
     UINT64 version;
@@ -190,23 +189,23 @@ typedef struct {
 
     // s=<session name>
     // https://tools.ietf.org/html/rfc4566#section-5.3
-    CHAR sessionName[MAX_SDP_SESSION_NAME_LENGTH + 1];
+    PCHAR sessionName;
 
     // i=<session description>
     // https://tools.ietf.org/html/rfc4566#section-5.4
-    CHAR sessionInformation[MAX_SDP_SESSION_INFORMATION_LENGTH + 1];
+    PCHAR sessionInformation;
 
     // u=<uri>
     // https://tools.ietf.org/html/rfc4566#section-5.5
-    CHAR uri[MAX_SDP_SESSION_URI_LENGTH + 1];
+    PCHAR uri;
 
     // e=<email-address>
     // https://tools.ietf.org/html/rfc4566#section-5.6
-    CHAR emailAddress[MAX_SDP_SESSION_EMAIL_ADDRESS_LENGTH + 1];
+    PCHAR emailAddress;
 
     // p=<phone-number>
     // https://tools.ietf.org/html/rfc4566#section-5.6
-    CHAR phoneNumber[MAX_SDP_SESSION_PHONE_NUMBER_LENGTH + 1];
+    PCHAR phoneNumber;
 
     SdpConnectionInformation sdpConnectionInformation;
 
@@ -216,27 +215,122 @@ typedef struct {
 
     SdpEncryptionKey sdpEncryptionKey;
 
-    SdpAttributes sdpAttributes[MAX_SDP_ATTRIBUTES_COUNT];
+    PSdpAttributes sdpAttributes;
 
-    SdpMediaDescription mediaDescriptions[MAX_SDP_SESSION_MEDIA_COUNT];
+    PSdpMediaDescription mediaDescriptions;
 
     UINT16 sessionAttributesCount;
 
+    UINT16 sessionAttributesCapacity;
+
     UINT16 mediaCount;
 
+    UINT16 mediaCapacity;
+
     UINT8 timezoneCount;
 
     UINT8 timeDescriptionCount;
 
     UINT8 bandwidthCount;
+
+    // Every string and array above is carved out of these blocks and released with them
+    PSdpArenaBlock pArena;
 } SessionDescription, *PSessionDescription;
 
-// Return code maps to an errno just for SDP parsing
+/**
+ * Allocates an empty SessionDescription. A zeroed SessionDescription is just as valid, this is a convenience for heap instances.
+ *
+ * @param - PSessionDescription* - OUT - The new SessionDescription
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS createSessionDescription(PSessionDescription*);
+
+/**
+ * Frees a SessionDescription created with createSessionDescription along with its arena
+ *
+ * @param - PSessionDescription* - IN/OUT - SessionDescription to free, set to NULL
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS freeSessionDescription(PSessionDescription*);
+
+/**
+ * Releases the arena of a SessionDescription and zeroes it so it can be filled again. Needed for SessionDescriptions
+ * that are not allocated with createSessionDescription.
+ *
+ * @param - PSessionDescription - IN - SessionDescription to reset
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS resetSessionDescription(PSessionDescription);
+
+/**
+ * Allocates from the arena of a SessionDescription. The memory is 8-byte aligned, not zeroed, and lives until the
+ * SessionDescription is freed or reset.
+ *
+ * @param - PSessionDescription - IN - Owner of the arena
+ * @param - UINT32 - IN - Size to allocate
+ * @param - PVOID* - OUT - Allocated memory
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS sdpArenaAlloc(PSessionDescription, UINT32, PVOID*);
+
+/**
+ * Formats a string into the arena of a SessionDescription
+ *
+ * @param - PSessionDescription - IN - Owner of the arena
+ * @param - PCHAR* - OUT - The formatted string
+ * @param - PCHAR - IN - printf style format followed by its arguments
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS sdpArenaFormat(PSessionDescription, PCHAR*, PCHAR, ...);
+
+/**
+ * Appends a zeroed media section, growing the media array if needed. Growing moves the array, so media section
+ * pointers are only valid until the next append.
+ *
+ * @param - PSessionDescription - IN - SessionDescription to append to
+ * @param - PSdpMediaDescription* - OUT - The new media section
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS sdpAppendMediaDescription(PSessionDescription, PSdpMediaDescription*);
+
+/**
+ * Appends an attribute to a media section, or to the session when the media section is NULL. Name and value are
+ * referenced as is, they must outlive the SessionDescription, be in its arena, or be string literals.
+ *
+ * @param - PSessionDescription - IN - Owner of the arena
+ * @param - PSdpMediaDescription - IN/OPT - Media section, NULL for a session attribute
+ * @param - PCHAR - IN - Attribute name
+ * @param - PCHAR - IN/OPT - Attribute value, NULL for a property attribute
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS sdpAppendAttribute(PSessionDescription, PSdpMediaDescription, PCHAR, PCHAR);
+
+/**
+ * Same as sdpAppendAttribute with the value formatted into the arena
+ *
+ * @param - PSessionDescription - IN - Owner of the arena
+ * @param - PSdpMediaDescription - IN/OPT - Media section, NULL for a session attribute
+ * @param - PCHAR - IN - Attribute name
+ * @param - PCHAR - IN - printf style format of the value followed by its arguments
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS sdpAppendAttributeFormat(PSessionDescription, PSdpMediaDescription, PCHAR, PCHAR, ...);
+
+// Return code maps to an errno just for SDP parsing. The SDP is copied once into the arena and all strings point into that copy.
 STATUS deserializeSessionDescription(PSessionDescription, PCHAR);
 
 // Return code maps to a code if we are trying to serialize an invalid session_description
 STATUS serializeSessionDescription(PSessionDescription, PCHAR, PUINT32);
 
+// Line parsers, pch must be a NUL-terminated line of the arena copy of the SDP. Attributes are split in place.
 STATUS parseMediaName(PSessionDescription, PCHAR, UINT32);
 STATUS parseSessionAttributes(PSessionDescription, PCHAR, UINT32);
 STATUS parseMediaAttributes(PSessionDescription, PCHAR, UINT32);
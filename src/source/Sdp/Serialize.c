@@ -56,7 +56,7 @@ STATUS serializeSessionName(PCHAR sessionName, PCHAR* ppOutputData, PUINT32 pTot
     STATUS retStatus = STATUS_SUCCESS;
     UINT32 currentWriteSize = 0;
 
-    if (sessionName[0] != '\0') {
+    if (sessionName != NULL && sessionName[0] != '\0') {
         currentWriteSize = SNPRINTF(*ppOutputData, (*ppOutputData) == NULL ? 0 : *pBufferSize - *pTotalWritten,
                                     SDP_SESSION_NAME_MARKER "%s" SDP_LINE_SEPARATOR, sessionName);
 
@@ -98,7 +98,7 @@ STATUS serializeAttribute(PSdpAttributes pSDPAttributes, PCHAR* ppOutputData, PU
     STATUS retStatus = STATUS_SUCCESS;
     UINT32 currentWriteSize = 0;
 
-    if (pSDPAttributes->attributeValue[0] == '\0') {
+    if (pSDPAttributes->attributeValue == NULL || pSDPAttributes->attributeValue[0] == '\0') {
         currentWriteSize = SNPRINTF(*ppOutputData, (*ppOutputData) == NULL ? 0 : *pBufferSize - *pTotalWritten,
                                     SDP_ATTRIBUTE_MARKER "%s" SDP_LINE_SEPARATOR, pSDPAttributes->attributeName);
     } else {
@@ -121,7 +121,7 @@ STATUS serializeMediaName(PCHAR pMediaName, PCHAR* ppOutputData, PUINT32 pTotalW
     STATUS retStatus = STATUS_SUCCESS;
     UINT32 currentWriteSize = 0;
 
-    if (pMediaName[0] != '\0') {
+    if (pMediaName != NULL && pMediaName[0] != '\0') {
         currentWriteSize = snprintf(*ppOutputData, (*ppOutputData) == NULL ? 0 : *pBufferSize - *pTotalWritten,
                                     SDP_MEDIA_NAME_MARKER "%s" SDP_LINE_SEPARATOR, pMediaName);
 
@@ -72,7 +72,32 @@ STATUS serializeStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32 passw
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    UINT32 i, encodedLen = 0, packetSize = 0, remaining = 0, crc32, hmacLen;
+    KvsHmacSha1Key hmacKey;
+
+    MEMSET(&hmacKey, 0x00, SIZEOF(hmacKey));
+    CHK(pStunPacket != NULL && (!generateMessageIntegrity || password != NULL) && pSize != NULL, STATUS_NULL_ARG);
+    CHK(password == NULL || passwordLen != 0, STATUS_INVALID_ARG);
+
+    // Sizing alone never touches the key
+    if (generateMessageIntegrity && pBuffer != NULL) {
+        CHK_STATUS(kvsHmacSha1KeyInit(&hmacKey, password, passwordLen));
+    }
+
+    CHK_STATUS(serializeStunPacketWithKey(pStunPacket, generateMessageIntegrity ? &hmacKey : NULL, generateFingerprint, pBuffer, pSize));
+
+CleanUp:
+
+    kvsHmacSha1KeyFree(&hmacKey);
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS serializeStunPacketWithKey(PStunPacket pStunPacket, PKvsHmacSha1Key pHmacKey, BOOL generateFingerprint, PBYTE pBuffer, PUINT32 pSize)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 i, encodedLen = 0, packetSize = 0, remaining = 0, crc32;
     UINT16 size;
     PBYTE pCurrentBufferPosition = pBuffer;
     PStunAttributeHeader pStunAttributeHeader;
@@ -92,17 +117,13 @@ STATUS serializeStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32 passw
     BOOL fingerprintFound = FALSE, messaageIntegrityFound = FALSE;
     INT64 data64;
 
-    CHK(pStunPacket != NULL && (!generateMessageIntegrity || password != NULL) && pSize != NULL, STATUS_NULL_ARG);
-    CHK(password == NULL || passwordLen != 0, STATUS_INVALID_ARG);
+    CHK(pStunPacket != NULL && pSize != NULL, STATUS_NULL_ARG);
     CHK(pStunPacket->header.magicCookie == STUN_HEADER_MAGIC_COOKIE, STATUS_STUN_MAGIC_COOKIE_MISMATCH);
 
     packetSize += STUN_HEADER_LEN;
     if (pBuffer != NULL) {
-        // If the buffer is specified then we use the length
-        packetSize = *pSize;
-
-        // Set the remaining size first
-        remaining = packetSize;
+        // If the buffer is specified then its length is the capacity, every attribute checks it before writing
+        remaining = *pSize;
 
         CHK(remaining >= STUN_HEADER_LEN, STATUS_NOT_ENOUGH_MEMORY);
 
@@ -454,7 +475,7 @@ STATUS serializeStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32 passw
     }
 
     // Check if we need to generate the message integrity attribute
-    if (generateMessageIntegrity) {
+    if (pHmacKey != NULL) {
         encodedLen = STUN_ATTRIBUTE_HEADER_LEN + STUN_HMAC_VALUE_LEN;
 
         if (pBuffer != NULL) {
@@ -472,7 +493,7 @@ STATUS serializeStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32 passw
 
             // Calculate the HMAC for the integrity of the packet including STUN header and excluding the integrity attribute
             size = (UINT16) (pCurrentBufferPosition - pBuffer);
-            KVS_SHA1_HMAC(password, (INT32) passwordLen, pBuffer, size, pCurrentBufferPosition + STUN_ATTRIBUTE_HEADER_LEN, &hmacLen);
+            CHK_STATUS(kvsHmacSha1(pHmacKey, pBuffer, size, pCurrentBufferPosition + STUN_ATTRIBUTE_HEADER_LEN));
 
             // Advance the current position
             pCurrentBufferPosition += encodedLen;
@@ -518,14 +539,10 @@ STATUS serializeStunPacket(PStunPacket pStunPacket, PBYTE password, UINT32 passw
 
     // Package the length if buffer is not NULL
     if (pBuffer != NULL) {
-        encodedLen = (UINT16) (packetSize - STUN_HEADER_LEN);
-        putInt16((PINT16) (pBuffer + STUN_HEADER_TYPE_LEN), (UINT16) encodedLen);
+        packetSize = (UINT32) (pCurrentBufferPosition - pBuffer);
+        putInt16((PINT16) (pBuffer + STUN_HEADER_TYPE_LEN), (UINT16) (packetSize - STUN_HEADER_LEN));
     }
 
-    // Validate the overall size if buffer is specified
-    CHK_ERR(pBuffer == NULL || packetSize == (UINT32) (pCurrentBufferPosition - pBuffer), STATUS_INTERNAL_ERROR,
-            "Internal error: Invalid offset calculation.");
-
 CleanUp:
 
     if (STATUS_SUCCEEDED(retStatus) && pSize != NULL) {
@@ -536,13 +553,206 @@ CleanUp:
     return retStatus;
 }
 
+STATUS stunPacketTemplateInit(PStunPacket pStunPacket, PKvsHmacSha1Key pHmacKey, PStunPacketTemplate pTemplate)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 offset;
+    UINT16 type, length;
+
+    CHK(pStunPacket != NULL && pTemplate != NULL, STATUS_NULL_ARG);
+
+    MEMSET(pTemplate, 0x00, SIZEOF(StunPacketTemplate));
+    pTemplate->packetLen = SIZEOF(pTemplate->packet);
+    CHK_STATUS(serializeStunPacketWithKey(pStunPacket, pHmacKey, TRUE, pTemplate->packet, &pTemplate->packetLen));
+
+    // Record where the per-send values live. Offsets are never 0 as the header comes first.
+    for (offset = STUN_HEADER_LEN; offset + STUN_ATTRIBUTE_HEADER_LEN <= pTemplate->packetLen;
+         offset += STUN_ATTRIBUTE_HEADER_LEN + ROUND_UP(length, 4)) {
+        type = (UINT16) getInt16(*(PINT16) (pTemplate->packet + offset));
+        length = (UINT16) getInt16(*(PINT16) (pTemplate->packet + offset + STUN_ATTRIBUTE_HEADER_TYPE_LEN));
+        switch (type) {
+            case STUN_ATTRIBUTE_TYPE_PRIORITY:
+                pTemplate->priorityOffset = offset + STUN_ATTRIBUTE_HEADER_LEN;
+                break;
+            case STUN_ATTRIBUTE_TYPE_MESSAGE_INTEGRITY:
+                pTemplate->integrityOffset = offset;
+                break;
+            case STUN_ATTRIBUTE_TYPE_FINGERPRINT:
+                pTemplate->fingerprintOffset = offset;
+                break;
+            default:
+                break;
+        }
+    }
+
+    pTemplate->pStunPacket = pStunPacket;
+    pTemplate->attributesCount = pStunPacket->attributesCount;
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus) && pTemplate != NULL) {
+        pTemplate->packetLen = 0;
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS stunPacketTemplateUpdate(PStunPacketTemplate pTemplate, PKvsHmacSha1Key pHmacKey, PBYTE pTransactionId, UINT32 priority)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 crc32;
+
+    CHK(pTemplate != NULL && pTransactionId != NULL, STATUS_NULL_ARG);
+    CHK(pTemplate->packetLen != 0, STATUS_INVALID_OPERATION);
+    CHK(pTemplate->integrityOffset == 0 || pHmacKey != NULL, STATUS_NULL_ARG);
+
+    MEMCPY(pTemplate->packet + STUN_PACKET_TRANSACTION_ID_OFFSET, pTransactionId, STUN_TRANSACTION_ID_LEN);
+    if (pTemplate->priorityOffset != 0) {
+        putInt32((PINT32) (pTemplate->packet + pTemplate->priorityOffset), priority);
+    }
+
+    if (pTemplate->integrityOffset != 0) {
+        // The integrity covers a header whose length ends with the integrity attribute itself
+        putInt16((PINT16) (pTemplate->packet + STUN_HEADER_TYPE_LEN),
+                 (UINT16) (pTemplate->integrityOffset + STUN_ATTRIBUTE_HEADER_LEN + STUN_HMAC_VALUE_LEN - STUN_HEADER_LEN));
+        CHK_STATUS(kvsHmacSha1(pHmacKey, pTemplate->packet, pTemplate->integrityOffset,
+                               pTemplate->packet + pTemplate->integrityOffset + STUN_ATTRIBUTE_HEADER_LEN));
+        putInt16((PINT16) (pTemplate->packet + STUN_HEADER_TYPE_LEN), (UINT16) (pTemplate->packetLen - STUN_HEADER_LEN));
+    }
+
+    if (pTemplate->fingerprintOffset != 0) {
+        crc32 = COMPUTE_CRC32(pTemplate->packet, pTemplate->fingerprintOffset) ^ STUN_FINGERPRINT_ATTRIBUTE_XOR_VALUE;
+        putInt32((PINT32) (pTemplate->packet + pTemplate->fingerprintOffset + STUN_ATTRIBUTE_HEADER_LEN), crc32);
+    }
+
+CleanUp:
+
+    return retStatus;
+}
+
+// Validates the length of a serialized attribute against its type and the rest of the buffer, and its position relative to
+// MESSAGE-INTEGRITY and FINGERPRINT. Unknown attributes only need to fit and are reported through pKnown.
+static STATUS validateStunAttribute(PBYTE pAttribute, UINT32 remaining, BOOL messageIntegrityFound, BOOL fingerprintFound, PBOOL pKnown)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT16 type, length, ipFamily;
+    BOOL known = TRUE;
+
+    CHK(remaining >= STUN_ATTRIBUTE_HEADER_LEN, STATUS_INVALID_ARG);
+
+    type = (UINT16) getInt16(*(PUINT16) pAttribute);
+    length = (UINT16) getInt16(*(PUINT16) (pAttribute + STUN_ATTRIBUTE_HEADER_TYPE_LEN));
+
+    // The value has to be within the buffer, only the padding of the last attribute may be missing
+    CHK(length <= remaining - STUN_ATTRIBUTE_HEADER_LEN, STATUS_INVALID_ARG);
+
+    switch (type) {
+        case STUN_ATTRIBUTE_TYPE_MAPPED_ADDRESS:
+        case STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS:
+        case STUN_ATTRIBUTE_TYPE_RESPONSE_ADDRESS:
+        case STUN_ATTRIBUTE_TYPE_SOURCE_ADDRESS:
+        case STUN_ATTRIBUTE_TYPE_REFLECTED_FROM:
+        case STUN_ATTRIBUTE_TYPE_XOR_RELAYED_ADDRESS:
+        case STUN_ATTRIBUTE_TYPE_XOR_PEER_ADDRESS:
+        case STUN_ATTRIBUTE_TYPE_CHANGED_ADDRESS:
+            CHK(length >= STUN_ATTRIBUTE_ADDRESS_HEADER_LEN, STATUS_STUN_INVALID_ADDRESS_ATTRIBUTE_LENGTH);
+            ipFamily = (UINT16) getInt16(*(PUINT16) (pAttribute + STUN_ATTRIBUTE_HEADER_LEN)) & (UINT16) 0x00ff;
+
+            // Address family and the port
+            CHK(length == STUN_ATTRIBUTE_ADDRESS_HEADER_LEN + ((ipFamily == KVS_IP_FAMILY_TYPE_IPV4) ? IPV4_ADDRESS_LENGTH : IPV6_ADDRESS_LENGTH),
+                STATUS_STUN_INVALID_ADDRESS_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_USERNAME:
+            CHK(length <= STUN_MAX_USERNAME_LEN, STATUS_STUN_INVALID_USERNAME_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_PRIORITY:
+            CHK(length == STUN_ATTRIBUTE_PRIORITY_LEN, STATUS_STUN_INVALID_PRIORITY_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_USE_CANDIDATE:
+        case STUN_ATTRIBUTE_TYPE_DONT_FRAGMENT:
+            CHK(length == STUN_ATTRIBUTE_FLAG_LEN, STATUS_STUN_INVALID_USE_CANDIDATE_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_LIFETIME:
+            CHK(length == STUN_ATTRIBUTE_LIFETIME_LEN, STATUS_STUN_INVALID_LIFETIME_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_CHANGE_REQUEST:
+            CHK(length == STUN_ATTRIBUTE_CHANGE_REQUEST_FLAG_LEN, STATUS_STUN_INVALID_CHANGE_REQUEST_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_REQUESTED_TRANSPORT:
+            CHK(length == STUN_ATTRIBUTE_REQUESTED_TRANSPORT_PROTOCOL_LEN, STATUS_STUN_INVALID_REQUESTED_TRANSPORT_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_REALM:
+            CHK(length <= STUN_MAX_REALM_LEN, STATUS_STUN_INVALID_REALM_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_NONCE:
+            CHK(length <= STUN_MAX_NONCE_LEN, STATUS_STUN_INVALID_NONCE_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_ERROR_CODE:
+            // The class and the number precede the phrase
+            CHK(length >= STUN_ERROR_CODE_PACKET_ERROR_PHRASE_OFFSET && length <= STUN_MAX_ERROR_PHRASE_LEN,
+                STATUS_STUN_INVALID_ERROR_CODE_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED:
+        case STUN_ATTRIBUTE_TYPE_ICE_CONTROLLING:
+            CHK(length == STUN_ATTRIBUTE_ICE_CONTROL_LEN, STATUS_STUN_INVALID_ICE_CONTROL_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_DATA:
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_CHANNEL_NUMBER:
+            CHK(length == STUN_ATTRIBUTE_CHANNEL_NUMBER_LEN, STATUS_STUN_INVALID_CHANNEL_NUMBER_ATTRIBUTE_LENGTH);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_MESSAGE_INTEGRITY:
+            CHK(length == STUN_HMAC_VALUE_LEN, STATUS_STUN_INVALID_MESSAGE_INTEGRITY_ATTRIBUTE_LENGTH);
+            CHK(!messageIntegrityFound, STATUS_STUN_MULTIPLE_MESSAGE_INTEGRITY_ATTRIBUTES);
+            CHK(!fingerprintFound, STATUS_STUN_MESSAGE_INTEGRITY_AFTER_FINGERPRINT);
+            break;
+
+        case STUN_ATTRIBUTE_TYPE_FINGERPRINT:
+            CHK(length == STUN_ATTRIBUTE_FINGERPRINT_LEN, STATUS_STUN_INVALID_FINGERPRINT_ATTRIBUTE_LENGTH);
+            CHK(!fingerprintFound, STATUS_STUN_MULTIPLE_FINGERPRINT_ATTRIBUTES);
+            break;
+
+        default:
+            known = FALSE;
+            break;
+    }
+
+    // Only FINGERPRINT may follow MESSAGE-INTEGRITY and nothing known may follow FINGERPRINT
+    CHK(!known || type == STUN_ATTRIBUTE_TYPE_MESSAGE_INTEGRITY || type == STUN_ATTRIBUTE_TYPE_FINGERPRINT ||
+            (!fingerprintFound && !messageIntegrityFound),
+        STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
+
+CleanUp:
+
+    if (pKnown != NULL) {
+        *pKnown = known;
+    }
+
+    return retStatus;
+}
+
 STATUS deserializeStunPacket(PBYTE pStunBuffer, UINT32 bufferSize, PBYTE password, UINT32 passwordLen, PStunPacket* ppStunPacket)
 {
     ENTERS();
     STATUS retStatus = STATUS_SUCCESS;
-    UINT32 attributeCount = 0, allocationSize, attributeSize, i = 0, j, magicCookie, hmacLen, crc32, data;
+    UINT32 attributeCount = 0, allocationSize, attributeSize, i = 0, j, magicCookie, hmacLen, crc32, data, remaining;
     UINT32 stunMagicCookie = STUN_HEADER_MAGIC_COOKIE;
-    UINT16 size, paddedLength, ipFamily, messageLength;
+    UINT16 size, paddedLength, messageLength;
     INT64 data64;
     PStunAttributeHeader pStunAttributeHeader, pStunAttributes, pDestAttribute;
     PStunHeader pStunHeader = (PStunHeader) pStunBuffer;
@@ -589,6 +799,10 @@ STATUS deserializeStunPacket(PBYTE pStunBuffer, UINT32 bufferSize, PBYTE passwor
     pStunAttributeHeader = pStunAttributes;
     allocationSize = SIZEOF(StunPacket);
     while ((PBYTE) pStunAttributeHeader < (PBYTE) pStunAttributes + messageLength) {
+        // Validate the length and the position of the attribute before reading it
+        remaining = (UINT32) (pStunBuffer + bufferSize - (PBYTE) pStunAttributeHeader);
+        CHK_STATUS(validateStunAttribute((PBYTE) pStunAttributeHeader, remaining, messaageIntegrityFound, fingerprintFound, NULL));
+
         // Copy/Swap tne attribute header
         stunAttributeHeader.type = (STUN_ATTRIBUTE_TYPE) getInt16(*(PUINT16) pStunAttributeHeader);
         stunAttributeHeader.length = (UINT16) getInt16(*(PUINT16) ((PBYTE) pStunAttributeHeader + STUN_ATTRIBUTE_HEADER_TYPE_LEN));
@@ -599,7 +813,7 @@ STATUS deserializeStunPacket(PBYTE pStunBuffer, UINT32 bufferSize, PBYTE passwor
         // Calculate the padded size
         paddedLength = (UINT16) ROUND_UP(stunAttributeHeader.length, 4);
 
-        // Check the type, get the allocation size and validate the length for each attribute
+        // Get the allocation size for each attribute
         switch (stunAttributeHeader.type) {
             case STUN_ATTRIBUTE_TYPE_MAPPED_ADDRESS:
             case STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS:
@@ -610,142 +824,66 @@ STATUS deserializeStunPacket(PBYTE pStunBuffer, UINT32 bufferSize, PBYTE passwor
             case STUN_ATTRIBUTE_TYPE_XOR_PEER_ADDRESS:
             case STUN_ATTRIBUTE_TYPE_CHANGED_ADDRESS:
                 attributeSize = SIZEOF(StunAttributeAddress);
-
-                // Cast, swap and get the size
-                pStunAttributeAddress = (PStunAttributeAddress) pStunAttributeHeader;
-                ipFamily = (UINT16) getInt16(pStunAttributeAddress->address.family) & (UINT16) 0x00ff;
-
-                // Address family and the port
-                size = STUN_ATTRIBUTE_ADDRESS_HEADER_LEN + ((ipFamily == KVS_IP_FAMILY_TYPE_IPV4) ? IPV4_ADDRESS_LENGTH : IPV6_ADDRESS_LENGTH);
-
-                CHK(stunAttributeHeader.length == size, STATUS_STUN_INVALID_ADDRESS_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
                 break;
 
             case STUN_ATTRIBUTE_TYPE_USERNAME:
-                attributeSize = SIZEOF(StunAttributeUsername);
-
-                // Validate the size of the length against the max value of username
-                CHK(stunAttributeHeader.length <= STUN_MAX_USERNAME_LEN, STATUS_STUN_INVALID_USERNAME_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 // Add the length of the string itself
-                attributeSize += paddedLength;
+                attributeSize = SIZEOF(StunAttributeUsername) + paddedLength;
                 break;
 
             case STUN_ATTRIBUTE_TYPE_PRIORITY:
                 attributeSize = SIZEOF(StunAttributePriority);
-
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_PRIORITY_LEN, STATUS_STUN_INVALID_PRIORITY_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 break;
 
             case STUN_ATTRIBUTE_TYPE_USE_CANDIDATE:
             case STUN_ATTRIBUTE_TYPE_DONT_FRAGMENT:
                 attributeSize = SIZEOF(StunAttributeFlag);
-
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_FLAG_LEN, STATUS_STUN_INVALID_USE_CANDIDATE_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 break;
 
             case STUN_ATTRIBUTE_TYPE_LIFETIME:
                 attributeSize = SIZEOF(StunAttributeLifetime);
-
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_LIFETIME_LEN, STATUS_STUN_INVALID_LIFETIME_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 break;
 
             case STUN_ATTRIBUTE_TYPE_CHANGE_REQUEST:
                 attributeSize = SIZEOF(StunAttributeChangeRequest);
-
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_CHANGE_REQUEST_FLAG_LEN, STATUS_STUN_INVALID_CHANGE_REQUEST_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 break;
 
             case STUN_ATTRIBUTE_TYPE_REQUESTED_TRANSPORT:
                 attributeSize = SIZEOF(StunAttributeRequestedTransport);
-
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_REQUESTED_TRANSPORT_PROTOCOL_LEN,
-                    STATUS_STUN_INVALID_REQUESTED_TRANSPORT_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 break;
 
             case STUN_ATTRIBUTE_TYPE_REALM:
-                attributeSize = SIZEOF(StunAttributeRealm);
-
-                // Validate the size of the length against the max value of realm
-                CHK(stunAttributeHeader.length <= STUN_MAX_REALM_LEN, STATUS_STUN_INVALID_REALM_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
-                // Add the length of the string itself
-                attributeSize += paddedLength;
+                attributeSize = SIZEOF(StunAttributeRealm) + paddedLength;
                 break;
 
             case STUN_ATTRIBUTE_TYPE_NONCE:
-                attributeSize = SIZEOF(StunAttributeNonce);
-
-                // Validate the size of the length against the max value of nonce
-                CHK(stunAttributeHeader.length <= STUN_MAX_NONCE_LEN, STATUS_STUN_INVALID_NONCE_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
-                // Add the length of the string itself
-                attributeSize += paddedLength;
+                attributeSize = SIZEOF(StunAttributeNonce) + paddedLength;
                 break;
 
             case STUN_ATTRIBUTE_TYPE_ERROR_CODE:
-                attributeSize = SIZEOF(StunAttributeErrorCode);
-
-                // Validate the size of the length against the max value of error phrase
-                CHK(stunAttributeHeader.length <= STUN_MAX_ERROR_PHRASE_LEN, STATUS_STUN_INVALID_ERROR_CODE_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
-                // Add the length of the string itself
-                attributeSize += paddedLength;
+                attributeSize = SIZEOF(StunAttributeErrorCode) + paddedLength;
                 break;
 
             case STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED:
             case STUN_ATTRIBUTE_TYPE_ICE_CONTROLLING:
                 attributeSize = SIZEOF(StunAttributeIceControl);
-
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_ICE_CONTROL_LEN, STATUS_STUN_INVALID_ICE_CONTROL_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 break;
 
             case STUN_ATTRIBUTE_TYPE_DATA:
-                attributeSize = SIZEOF(StunAttributeData);
-
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
-                // Add the length of the data itself
-                attributeSize += paddedLength;
+                attributeSize = SIZEOF(StunAttributeData) + paddedLength;
                 break;
 
             case STUN_ATTRIBUTE_TYPE_CHANNEL_NUMBER:
                 attributeSize = SIZEOF(StunAttributeChannelNumber);
-
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_CHANNEL_NUMBER_LEN, STATUS_STUN_INVALID_CHANNEL_NUMBER_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound && !messaageIntegrityFound, STATUS_STUN_ATTRIBUTES_AFTER_FINGERPRINT_MESSAGE_INTEGRITY);
-
                 break;
 
             case STUN_ATTRIBUTE_TYPE_MESSAGE_INTEGRITY:
                 attributeSize = SIZEOF(StunAttributeMessageIntegrity);
-                CHK(stunAttributeHeader.length == STUN_HMAC_VALUE_LEN, STATUS_STUN_INVALID_MESSAGE_INTEGRITY_ATTRIBUTE_LENGTH);
-                CHK(!messaageIntegrityFound, STATUS_STUN_MULTIPLE_MESSAGE_INTEGRITY_ATTRIBUTES);
-                CHK(!fingerprintFound, STATUS_STUN_MESSAGE_INTEGRITY_AFTER_FINGERPRINT);
                 messaageIntegrityFound = TRUE;
                 break;
 
             case STUN_ATTRIBUTE_TYPE_FINGERPRINT:
                 attributeSize = SIZEOF(StunAttributeFingerprint);
-                CHK(stunAttributeHeader.length == STUN_ATTRIBUTE_FINGERPRINT_LEN, STATUS_STUN_INVALID_FINGERPRINT_ATTRIBUTE_LENGTH);
-                CHK(!fingerprintFound, STATUS_STUN_MULTIPLE_FINGERPRINT_ATTRIBUTES);
                 fingerprintFound = TRUE;
                 break;
 
@@ -1103,12 +1241,39 @@ CleanUp:
 STATUS createStunPacket(STUN_PACKET_TYPE stunPacketType, PBYTE transactionId, PStunPacket* ppStunPacket)
 {
     ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PBYTE pStorage = NULL;
+
+    CHK(ppStunPacket != NULL, STATUS_NULL_ARG);
+    CHK(NULL != (pStorage = (PBYTE) MEMALLOC(STUN_PACKET_ALLOCATION_SIZE)), STATUS_NOT_ENOUGH_MEMORY);
+    CHK_STATUS(initStunPacket(stunPacketType, transactionId, pStorage, STUN_PACKET_ALLOCATION_SIZE, ppStunPacket));
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus)) {
+        SAFE_MEMFREE(pStorage);
+    }
+
+    if (ppStunPacket != NULL) {
+        *ppStunPacket = (PStunPacket) pStorage;
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS initStunPacket(STUN_PACKET_TYPE stunPacketType, PBYTE transactionId, PBYTE pStorage, UINT32 storageSize, PStunPacket* ppStunPacket)
+{
     STATUS retStatus = STATUS_SUCCESS;
     UINT32 i;
     PStunPacket pStunPacket = NULL;
 
-    CHK(ppStunPacket != NULL, STATUS_NULL_ARG);
-    CHK(NULL != (pStunPacket = (PStunPacket) MEMCALLOC(1, STUN_PACKET_ALLOCATION_SIZE)), STATUS_NOT_ENOUGH_MEMORY);
+    CHK(pStorage != NULL && ppStunPacket != NULL, STATUS_NULL_ARG);
+    CHK(storageSize >= SIZEOF(StunPacket) + STUN_ATTRIBUTE_MAX_COUNT * SIZEOF(PStunAttributeHeader), STATUS_INVALID_ARG);
+
+    // The attribute pointers are expected to be NULL-ified
+    MEMSET(pStorage, 0x00, storageSize);
+    pStunPacket = (PStunPacket) pStorage;
     pStunPacket->attributesCount = 0;
     pStunPacket->header.messageLength = 0;
     pStunPacket->header.magicCookie = STUN_HEADER_MAGIC_COOKIE;
@@ -1123,25 +1288,16 @@ STATUS createStunPacket(STUN_PACKET_TYPE stunPacketType, PBYTE transactionId, PS
         MEMCPY(pStunPacket->header.transactionId, transactionId, STUN_TRANSACTION_ID_LEN);
     }
 
-    // Set the address - calloc should have NULL-ified the actual pointers
+    // Set the address of the attribute array following the structure
     pStunPacket->attributeList = (PStunAttributeHeader*) (pStunPacket + 1);
 
     // Store the actual allocation size
-    pStunPacket->allocationSize = STUN_PACKET_ALLOCATION_SIZE;
+    pStunPacket->allocationSize = storageSize;
 
     *ppStunPacket = pStunPacket;
 
 CleanUp:
 
-    if (STATUS_FAILED(retStatus)) {
-        freeStunPacket(&pStunPacket);
-    }
-
-    if (ppStunPacket != NULL) {
-        *ppStunPacket = pStunPacket;
-    }
-
-    LEAVES();
     return retStatus;
 }
 
@@ -1223,6 +1379,155 @@ CleanUp:
     return retStatus;
 }
 
+STATUS stunPacketViewInit(PBYTE pStunBuffer, UINT32 bufferSize, PKvsHmacSha1Key pHmacKey, PStunPacketView pView)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PBYTE pAttribute, pEnd;
+    PStunAttributeView pAttributeView;
+    BYTE hmac[STUN_HMAC_VALUE_LEN];
+    UINT32 crc32;
+    UINT16 length = 0;
+    BOOL known, messageIntegrityFound = FALSE, fingerprintFound = FALSE;
+
+    CHK(pStunBuffer != NULL && pView != NULL, STATUS_NULL_ARG);
+    CHK(bufferSize >= STUN_HEADER_LEN, STATUS_INVALID_ARG);
+
+    pView->attributesCount = 0;
+    pView->stunMessageType = (UINT16) getInt16(*(PUINT16) pStunBuffer);
+    pView->messageLength = (UINT16) getInt16(*(PUINT16) (pStunBuffer + STUN_HEADER_TYPE_LEN));
+    pView->transactionId = pStunBuffer + STUN_PACKET_TRANSACTION_ID_OFFSET;
+
+    CHK(bufferSize >= (UINT32) pView->messageLength + STUN_HEADER_LEN, STATUS_INVALID_ARG);
+    CHK((UINT32) getInt32(*(PUINT32) (pStunBuffer + STUN_HEADER_TYPE_LEN + STUN_HEADER_DATA_LEN)) == STUN_HEADER_MAGIC_COOKIE,
+        STATUS_STUN_MAGIC_COOKIE_MISMATCH);
+
+    pEnd = pStunBuffer + STUN_HEADER_LEN + pView->messageLength;
+    for (pAttribute = pStunBuffer + STUN_HEADER_LEN; pAttribute < pEnd; pAttribute += STUN_ATTRIBUTE_HEADER_LEN + ROUND_UP(length, 4)) {
+        // Attributes have to end within the message length, the bytes past it are not part of the packet
+        CHK_STATUS(validateStunAttribute(pAttribute, (UINT32) (pEnd - pAttribute), messageIntegrityFound, fingerprintFound, &known));
+        length = (UINT16) getInt16(*(PUINT16) (pAttribute + STUN_ATTRIBUTE_HEADER_TYPE_LEN));
+        if (!known) {
+            continue;
+        }
+
+        CHK(pView->attributesCount < STUN_ATTRIBUTE_MAX_COUNT, STATUS_STUN_MAX_ATTRIBUTE_COUNT);
+        pAttributeView = &pView->attributes[pView->attributesCount++];
+        pAttributeView->type = (UINT16) getInt16(*(PUINT16) pAttribute);
+        pAttributeView->length = length;
+        pAttributeView->pValue = pAttribute + STUN_ATTRIBUTE_HEADER_LEN;
+
+        if (pAttributeView->type == STUN_ATTRIBUTE_TYPE_MESSAGE_INTEGRITY) {
+            CHK(pHmacKey != NULL, STATUS_NULL_ARG);
+
+            // The header length has to end with the integrity attribute while the HMAC is calculated
+            putInt16((PINT16) (pStunBuffer + STUN_HEADER_TYPE_LEN),
+                     (UINT16) (pAttributeView->pValue + STUN_HMAC_VALUE_LEN - pStunBuffer - STUN_HEADER_LEN));
+            retStatus = kvsHmacSha1(pHmacKey, pStunBuffer, (UINT32) (pAttribute - pStunBuffer), hmac);
+            putInt16((PINT16) (pStunBuffer + STUN_HEADER_TYPE_LEN), pView->messageLength);
+            CHK_STATUS(retStatus);
+
+            CHK(0 == MEMCMP(hmac, pAttributeView->pValue, STUN_HMAC_VALUE_LEN), STATUS_STUN_MESSAGE_INTEGRITY_MISMATCH);
+            messageIntegrityFound = TRUE;
+        } else if (pAttributeView->type == STUN_ATTRIBUTE_TYPE_FINGERPRINT) {
+            // Same for the fingerprint which covers the integrity attribute too
+            putInt16((PINT16) (pStunBuffer + STUN_HEADER_TYPE_LEN),
+                     (UINT16) (pAttributeView->pValue + STUN_ATTRIBUTE_FINGERPRINT_LEN - pStunBuffer - STUN_HEADER_LEN));
+            crc32 = COMPUTE_CRC32(pStunBuffer, (UINT32) (pAttribute - pStunBuffer)) ^ STUN_FINGERPRINT_ATTRIBUTE_XOR_VALUE;
+            putInt16((PINT16) (pStunBuffer + STUN_HEADER_TYPE_LEN), pView->messageLength);
+
+            CHK(crc32 == (UINT32) getInt32(*(PUINT32) pAttributeView->pValue), STATUS_STUN_FINGERPRINT_MISMATCH);
+            fingerprintFound = TRUE;
+        }
+    }
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus) && pView != NULL) {
+        pView->attributesCount = 0;
+    }
+
+    CHK_LOG_ERR(retStatus);
+
+    return retStatus;
+}
+
+STATUS stunPacketViewGetAttribute(PStunPacketView pView, STUN_ATTRIBUTE_TYPE attributeType, PStunAttributeView* ppAttribute)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PStunAttributeView pTargetAttribute = NULL;
+    UINT32 i;
+
+    CHK(pView != NULL && ppAttribute != NULL, STATUS_NULL_ARG);
+
+    for (i = 0; i < pView->attributesCount && pTargetAttribute == NULL; ++i) {
+        if (pView->attributes[i].type == attributeType) {
+            pTargetAttribute = &pView->attributes[i];
+        }
+    }
+
+CleanUp:
+
+    if (ppAttribute != NULL) {
+        *ppAttribute = pTargetAttribute;
+    }
+
+    return retStatus;
+}
+
+STATUS stunAttributeViewGetAddress(PStunPacketView pView, PStunAttributeView pAttribute, PKvsIpAddress pAddress)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pView != NULL && pAttribute != NULL && pAddress != NULL, STATUS_NULL_ARG);
+
+    // Address attribute lengths are validated against the family when the view is built
+    CHK(pAttribute->length > STUN_ATTRIBUTE_ADDRESS_HEADER_LEN && pAttribute->length <= STUN_ATTRIBUTE_ADDRESS_HEADER_LEN + IPV6_ADDRESS_LENGTH,
+        STATUS_STUN_INVALID_ADDRESS_ATTRIBUTE_LENGTH);
+
+    MEMSET(pAddress, 0x00, SIZEOF(KvsIpAddress));
+    pAddress->family = (UINT16) getInt16(*(PUINT16) pAttribute->pValue) & (UINT16) 0x00ff;
+    MEMCPY(&pAddress->port, pAttribute->pValue + STUN_ATTRIBUTE_ADDRESS_FAMILY_LEN, STUN_ATTRIBUTE_ADDRESS_PORT_LEN);
+    MEMCPY(pAddress->address, pAttribute->pValue + STUN_ATTRIBUTE_ADDRESS_HEADER_LEN, pAttribute->length - STUN_ATTRIBUTE_ADDRESS_HEADER_LEN);
+
+    if (pAttribute->type == STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS || pAttribute->type == STUN_ATTRIBUTE_TYPE_XOR_RELAYED_ADDRESS) {
+        CHK_STATUS(xorIpAddress(pAddress, pView->transactionId));
+    }
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS stunAttributeViewGetUint32(PStunAttributeView pAttribute, PUINT32 pValue)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pAttribute != NULL && pValue != NULL, STATUS_NULL_ARG);
+    CHK(pAttribute->length == SIZEOF(UINT32), STATUS_INVALID_ARG);
+
+    *pValue = (UINT32) getInt32(*(PUINT32) pAttribute->pValue);
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS stunAttributeViewGetErrorCode(PStunAttributeView pAttribute, PUINT16 pErrorCode)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+
+    CHK(pAttribute != NULL && pErrorCode != NULL, STATUS_NULL_ARG);
+    CHK(pAttribute->type == STUN_ATTRIBUTE_TYPE_ERROR_CODE && pAttribute->length >= STUN_ERROR_CODE_PACKET_ERROR_PHRASE_OFFSET,
+        STATUS_STUN_INVALID_ERROR_CODE_ATTRIBUTE_LENGTH);
+
+    *pErrorCode = GET_STUN_ERROR_CODE(pAttribute->pValue + STUN_ERROR_CODE_PACKET_ERROR_CLASS_OFFSET,
+                                      pAttribute->pValue + STUN_ERROR_CODE_PACKET_ERROR_CODE_OFFSET);
+
+CleanUp:
+
+    return retStatus;
+}
+
 STATUS getStunAttribute(PStunPacket pStunPacket, STUN_ATTRIBUTE_TYPE attributeType, PStunAttributeHeader* ppStunAttribute)
 {
     STATUS retStatus = STATUS_SUCCESS;
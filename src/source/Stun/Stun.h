@@ -102,6 +102,11 @@ extern "C" {
  */
 #define STUN_PACKET_ALLOCATION_SIZE 2048
 
+/**
+ * Storage for a binding response built with initStunPacket: the address and ICE control or error code attributes
+ */
+#define STUN_BINDING_RESPONSE_STORAGE_SIZE 512
+
 #define STUN_SEND_INDICATION_OVERHEAD_SIZE                36
 #define STUN_SEND_INDICATION_APPLICATION_DATA_OFFSET      36
 #define STUN_SEND_INDICATION_APPLICATION_DATA_LEN_OFFSET  34
@@ -379,8 +384,153 @@ typedef struct {
     PStunAttributeHeader* attributeList;
 } StunPacket, *PStunPacket;
 
+/**
+ * A STUN packet serialized once and re-sent with only the transaction id and the priority changing.
+ * MESSAGE-INTEGRITY and FINGERPRINT are recomputed over the patched bytes, nothing else is re-encoded.
+ */
+typedef struct {
+    // Serialized packet, always ending with a FINGERPRINT
+    BYTE packet[STUN_PACKET_ALLOCATION_SIZE];
+
+    // Serialized length, 0 when the template has not been built
+    UINT32 packetLen;
+
+    // Offset of the PRIORITY value, 0 when the packet carries none
+    UINT32 priorityOffset;
+
+    // Offsets of the MESSAGE-INTEGRITY and FINGERPRINT attribute headers, 0 when absent
+    UINT32 integrityOffset;
+    UINT32 fingerprintOffset;
+
+    // Packet the template was built from and its attribute count at the time, to detect a stale template
+    PStunPacket pStunPacket;
+    UINT32 attributesCount;
+} StunPacketTemplate, *PStunPacketTemplate;
+
+/**
+ * Attribute of a STUN packet view. The value is in network byte order and points into the viewed buffer.
+ */
+typedef struct {
+    // Attribute type
+    UINT16 type;
+
+    // Unpadded value length
+    UINT16 length;
+
+    // Attribute value
+    PBYTE pValue;
+} StunAttributeView, *PStunAttributeView;
+
+/**
+ * Read-only view of a serialized STUN packet, validated in place.
+ *
+ * NOTE: Nothing is copied out of the buffer, the view is only valid as long as the buffer it was built over.
+ */
+typedef struct {
+    // Host order message type and length from the header
+    UINT16 stunMessageType;
+    UINT16 messageLength;
+
+    // Transaction id in the buffer
+    PBYTE transactionId;
+
+    // Known attributes in packet order. Unknown attributes are skipped, the same as deserializeStunPacket does
+    UINT32 attributesCount;
+    StunAttributeView attributes[STUN_ATTRIBUTE_MAX_COUNT];
+} StunPacketView, *PStunPacketView;
+
+/**
+ * Serializes a STUN packet. Sizing only when the buffer is NULL, otherwise a single pass into the buffer.
+ *
+ * @param - PStunPacket - IN - Packet to serialize
+ * @param - PBYTE - IN - Password for MESSAGE-INTEGRITY, can be NULL when no integrity is generated
+ * @param - UINT32 - IN - Password length
+ * @param - BOOL - IN - Whether to append MESSAGE-INTEGRITY
+ * @param - BOOL - IN - Whether to append FINGERPRINT
+ * @param - PBYTE - OUT/OPT - Buffer to serialize into
+ * @param - PUINT32 - IN/OUT - IN - buffer size when the buffer is not NULL, OUT - serialized size
+ *
+ * @return - STATUS code of the execution
+ */
 STATUS serializeStunPacket(PStunPacket, PBYTE, UINT32, BOOL, BOOL, PBYTE, PUINT32);
+
+/**
+ * Same as serializeStunPacket with the HMAC key schedule precomputed. MESSAGE-INTEGRITY is appended when the key is not NULL.
+ */
+STATUS serializeStunPacketWithKey(PStunPacket, PKvsHmacSha1Key, BOOL, PBYTE, PUINT32);
+
+/**
+ * Builds a template from a STUN packet. FINGERPRINT is always appended.
+ *
+ * @param - PStunPacket - IN - Packet to serialize
+ * @param - PKvsHmacSha1Key - IN/OPT - MESSAGE-INTEGRITY key, the packet carries no integrity when NULL
+ * @param - PStunPacketTemplate - OUT - Template to build
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS stunPacketTemplateInit(PStunPacket, PKvsHmacSha1Key, PStunPacketTemplate);
+
+/**
+ * Patches the transaction id and priority of a template in place and refreshes its MESSAGE-INTEGRITY and FINGERPRINT.
+ *
+ * @param - PStunPacketTemplate - IN/OUT - Template built by stunPacketTemplateInit
+ * @param - PKvsHmacSha1Key - IN/OPT - MESSAGE-INTEGRITY key, required when the template carries integrity
+ * @param - PBYTE - IN - STUN_TRANSACTION_ID_LEN bytes of transaction id
+ * @param - UINT32 - IN - Priority, ignored when the template carries no PRIORITY
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS stunPacketTemplateUpdate(PStunPacketTemplate, PKvsHmacSha1Key, PBYTE, UINT32);
+
 STATUS deserializeStunPacket(PBYTE, UINT32, PBYTE, UINT32, PStunPacket*);
+/**
+ * Validates a serialized STUN packet in place and builds a view over it without allocating.
+ * MESSAGE-INTEGRITY and FINGERPRINT are verified over the buffer itself, which is why the
+ * header length in the buffer is briefly patched while they are computed.
+ *
+ * @param - PBYTE - IN - Serialized packet
+ * @param - UINT32 - IN - Buffer size
+ * @param - PKvsHmacSha1Key - IN/OPT - MESSAGE-INTEGRITY key, required when the packet carries integrity
+ * @param - PStunPacketView - OUT - View to build
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS stunPacketViewInit(PBYTE, UINT32, PKvsHmacSha1Key, PStunPacketView);
+
+/**
+ * Returns the first attribute of the type in the view, NULL when the packet has none
+ */
+STATUS stunPacketViewGetAttribute(PStunPacketView, STUN_ATTRIBUTE_TYPE, PStunAttributeView*);
+
+/**
+ * Decodes an address attribute of the view, undoing the XOR for XOR-MAPPED-ADDRESS and XOR-RELAYED-ADDRESS
+ */
+STATUS stunAttributeViewGetAddress(PStunPacketView, PStunAttributeView, PKvsIpAddress);
+
+/**
+ * Decodes a 32 bit attribute value such as PRIORITY or LIFETIME
+ */
+STATUS stunAttributeViewGetUint32(PStunAttributeView, PUINT32);
+
+/**
+ * Decodes the error code of an ERROR-CODE attribute. The phrase follows at STUN_ERROR_CODE_PACKET_ERROR_PHRASE_OFFSET in the value.
+ */
+STATUS stunAttributeViewGetErrorCode(PStunAttributeView, PUINT16);
+
+/**
+ * Lays out an empty STUN packet in caller provided storage so small packets can be built on the stack.
+ * The packet must not be freed with freeStunPacket.
+ *
+ * @param - STUN_PACKET_TYPE - IN - Packet type
+ * @param - PBYTE - IN/OPT - Transaction id, a random one is generated when NULL
+ * @param - PBYTE - IN - Storage, pointer aligned
+ * @param - UINT32 - IN - Storage size
+ * @param - PStunPacket* - OUT - Packet laid out at the start of the storage
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS initStunPacket(STUN_PACKET_TYPE, PBYTE, PBYTE, UINT32, PStunPacket*);
+
 STATUS freeStunPacket(PStunPacket*);
 STATUS createStunPacket(STUN_PACKET_TYPE, PBYTE, PStunPacket*);
 STATUS appendStunAddressAttribute(PStunPacket, STUN_ATTRIBUTE_TYPE, PKvsIpAddress);
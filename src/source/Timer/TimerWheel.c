@@ -0,0 +1,668 @@
+/**
+ * Hierarchical timer wheel shared by every peer connection
+ */
+#define LOG_CLASS "TimerWheel"
+
+#include "../Include_i.h"
+
+static PTimerWheel gSharedTimerWheel = NULL;
+
+static UINT32 timerWheelListForTick(PTimerWheelWorker pWorker, UINT64 expiryTick)
+{
+    UINT64 delta = expiryTick > pWorker->currentTick ? expiryTick - pWorker->currentTick : 0;
+    UINT32 level, shift = TIMER_WHEEL_LEVEL0_BITS, list = TIMER_WHEEL_LEVEL0_SLOTS;
+
+    if (delta < TIMER_WHEEL_LEVEL0_SLOTS) {
+        // Timers already due land in the slot of the next tick to process
+        return (UINT32) (MAX(expiryTick, pWorker->currentTick) & (TIMER_WHEEL_LEVEL0_SLOTS - 1));
+    }
+
+    // Timers beyond the range of the wheel wait in the last slot it can address and get placed again when cascaded
+    if (delta >= TIMER_WHEEL_MAX_TICKS) {
+        expiryTick = pWorker->currentTick + TIMER_WHEEL_MAX_TICKS - 1;
+        delta = TIMER_WHEEL_MAX_TICKS - 1;
+    }
+
+    for (level = 1; level < TIMER_WHEEL_LEVEL_COUNT - 1 && delta >= ((UINT64) 1 << (shift + TIMER_WHEEL_LEVELN_BITS)); level++) {
+        shift += TIMER_WHEEL_LEVELN_BITS;
+        list += TIMER_WHEEL_LEVELN_SLOTS;
+    }
+
+    return list + (UINT32) ((expiryTick >> shift) & (TIMER_WHEEL_LEVELN_SLOTS - 1));
+}
+
+static VOID timerWheelLink(PTimerWheelWorker pWorker, UINT32 list, UINT32 index)
+{
+    PTimerWheelEntry pEntry = &pWorker->pEntries[index];
+
+    pEntry->list = list;
+    pEntry->prev = TIMER_WHEEL_INVALID_INDEX;
+    pEntry->next = pWorker->lists[list];
+    if (pEntry->next != TIMER_WHEEL_INVALID_INDEX) {
+        pWorker->pEntries[pEntry->next].prev = index;
+    }
+    pWorker->lists[list] = index;
+}
+
+static VOID timerWheelUnlink(PTimerWheelWorker pWorker, UINT32 index)
+{
+    PTimerWheelEntry pEntry = &pWorker->pEntries[index];
+
+    if (pEntry->prev != TIMER_WHEEL_INVALID_INDEX) {
+        pWorker->pEntries[pEntry->prev].next = pEntry->next;
+    } else {
+        pWorker->lists[pEntry->list] = pEntry->next;
+    }
+    if (pEntry->next != TIMER_WHEEL_INVALID_INDEX) {
+        pWorker->pEntries[pEntry->next].prev = pEntry->prev;
+    }
+    pEntry->next = pEntry->prev = TIMER_WHEEL_INVALID_INDEX;
+}
+
+static VOID timerWheelSchedule(PTimerWheelWorker pWorker, UINT32 index, UINT64 expiryTick)
+{
+    pWorker->pEntries[index].state = TIMER_WHEEL_ENTRY_SCHEDULED;
+    pWorker->pEntries[index].expiryTick = expiryTick;
+    timerWheelLink(pWorker, timerWheelListForTick(pWorker, expiryTick), index);
+
+    // Wake the worker up early if it sleeps past the new timer
+    if (expiryTick < pWorker->wakeTick) {
+        CVAR_SIGNAL(pWorker->cvar);
+    }
+}
+
+static VOID timerWheelReleaseEntry(PTimerWheelWorker pWorker, UINT32 index)
+{
+    PTimerWheelEntry pEntry = &pWorker->pEntries[index];
+
+    MEMSET(pEntry, 0x00, SIZEOF(TimerWheelEntry));
+    pEntry->state = TIMER_WHEEL_ENTRY_FREE;
+    pEntry->prev = pEntry->list = TIMER_WHEEL_INVALID_INDEX;
+    pEntry->next = pWorker->freeHead;
+    pWorker->freeHead = index;
+    pWorker->activeTimerCount--;
+}
+
+static STATUS timerWheelGrowEntries(PTimerWheelWorker pWorker)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheelEntry pEntries;
+    UINT32 i, entryCount = pWorker->entryCount == 0 ? TIMER_WHEEL_DEFAULT_TIMER_COUNT : pWorker->entryCount * 2;
+
+    CHK(entryCount > pWorker->entryCount && entryCount < TIMER_WHEEL_INVALID_INDEX, STATUS_MAX_TIMER_COUNT_REACHED);
+    CHK(NULL != (pEntries = (PTimerWheelEntry) MEMREALLOC(pWorker->pEntries, entryCount * SIZEOF(TimerWheelEntry))), STATUS_NOT_ENOUGH_MEMORY);
+
+    MEMSET(pEntries + pWorker->entryCount, 0x00, (entryCount - pWorker->entryCount) * SIZEOF(TimerWheelEntry));
+    for (i = entryCount; i > pWorker->entryCount; i--) {
+        pEntries[i - 1].state = TIMER_WHEEL_ENTRY_FREE;
+        pEntries[i - 1].prev = pEntries[i - 1].list = TIMER_WHEEL_INVALID_INDEX;
+        pEntries[i - 1].next = pWorker->freeHead;
+        pWorker->freeHead = i - 1;
+    }
+
+    pWorker->pEntries = pEntries;
+    pWorker->entryCount = entryCount;
+
+CleanUp:
+
+    return retStatus;
+}
+
+static UINT64 timerWheelTimeToTick(PTimerWheelWorker pWorker, UINT64 time)
+{
+    return time <= pWorker->startTime ? 0 : (time - pWorker->startTime + TIMER_WHEEL_TICK_DURATION - 1) / TIMER_WHEEL_TICK_DURATION;
+}
+
+static UINT64 timerWheelPeriodToTicks(UINT64 period)
+{
+    return MAX((period + TIMER_WHEEL_TICK_DURATION - 1) / TIMER_WHEEL_TICK_DURATION, 1);
+}
+
+// Moves the timers of one higher level slot down now that the lower levels have wrapped around
+static VOID timerWheelCascade(PTimerWheelWorker pWorker)
+{
+    UINT32 level, shift = TIMER_WHEEL_LEVEL0_BITS, list, index;
+
+    for (level = 1; level < TIMER_WHEEL_LEVEL_COUNT; level++) {
+        list = TIMER_WHEEL_LEVEL0_SLOTS + (level - 1) * TIMER_WHEEL_LEVELN_SLOTS +
+            (UINT32) ((pWorker->currentTick >> shift) & (TIMER_WHEEL_LEVELN_SLOTS - 1));
+        while ((index = pWorker->lists[list]) != TIMER_WHEEL_INVALID_INDEX) {
+            timerWheelUnlink(pWorker, index);
+            timerWheelLink(pWorker, timerWheelListForTick(pWorker, pWorker->pEntries[index].expiryTick), index);
+        }
+
+        // Only carry on to the next level when this one wrapped around as well
+        if (((pWorker->currentTick >> shift) & (TIMER_WHEEL_LEVELN_SLOTS - 1)) != 0) {
+            break;
+        }
+        shift += TIMER_WHEEL_LEVELN_BITS;
+    }
+}
+
+// Waits for the callback in flight on another thread when it belongs to the queue, or to the timer of the queue when given
+static VOID timerWheelWaitForCallback(PTimerWheelWorker pWorker, PTimerWheelQueue pQueue, UINT32 index)
+{
+    // A callback cancelling timers or shutting its own queue down must not wait for itself
+    if (GETTID() == pWorker->workerTid) {
+        return;
+    }
+
+    while (pWorker->pRunningQueue == pQueue && (index == TIMER_WHEEL_INVALID_INDEX || pWorker->runningIndex == index)) {
+        CVAR_WAIT(pWorker->callbackCvar, pWorker->lock, INFINITE_TIME_VALUE);
+    }
+}
+
+// Called with the worker lock held, which is released around each callback
+static VOID timerWheelRunTick(PTimerWheelWorker pWorker, UINT64 nowTick)
+{
+    STATUS status;
+    UINT32 index, list = (UINT32) (pWorker->currentTick & (TIMER_WHEEL_LEVEL0_SLOTS - 1));
+    UINT64 tick = pWorker->currentTick, customData;
+    PTimerWheelEntry pEntry;
+    TimerCallbackFunc timerCallbackFn;
+
+    if (list == 0) {
+        timerWheelCascade(pWorker);
+    }
+
+    while ((index = pWorker->lists[list]) != TIMER_WHEEL_INVALID_INDEX) {
+        timerWheelUnlink(pWorker, index);
+        timerWheelLink(pWorker, TIMER_WHEEL_EXPIRED_LIST, index);
+    }
+
+    // Timers added from the callbacks below, or by other threads while the lock is released, go after this tick.
+    // Entries still waiting on the expired list can be cancelled in the meantime, which unlinks them.
+    pWorker->currentTick = tick + 1;
+
+    while ((index = pWorker->lists[TIMER_WHEEL_EXPIRED_LIST]) != TIMER_WHEEL_INVALID_INDEX) {
+        timerWheelUnlink(pWorker, index);
+        pEntry = &pWorker->pEntries[index];
+
+        // Clamped timers picked up by a cascade are not due yet
+        if (pEntry->expiryTick > tick) {
+            timerWheelLink(pWorker, timerWheelListForTick(pWorker, pEntry->expiryTick), index);
+            continue;
+        }
+
+        pEntry->state = TIMER_WHEEL_ENTRY_RUNNING;
+        timerCallbackFn = pEntry->timerCallbackFn;
+        customData = pEntry->customData;
+        pWorker->runningIndex = index;
+        pWorker->pRunningQueue = pEntry->pQueue;
+
+        MUTEX_UNLOCK(pWorker->lock);
+        status = timerCallbackFn(index, GETTIME(), customData);
+        MUTEX_LOCK(pWorker->lock);
+
+        pWorker->runningIndex = TIMER_WHEEL_INVALID_INDEX;
+        pWorker->pRunningQueue = NULL;
+        CVAR_BROADCAST(pWorker->callbackCvar);
+        if (STATUS_FAILED(status) && status != STATUS_TIMER_QUEUE_STOP_SCHEDULING) {
+            DLOGW("Timer callback returned 0x%08x", status);
+        }
+
+        // Timers may have been added and the pool reallocated, this one cancelled or its queue shut down meanwhile
+        pEntry = &pWorker->pEntries[index];
+        if (pEntry->timerCallbackFn == NULL || status == STATUS_TIMER_QUEUE_STOP_SCHEDULING || pEntry->period == TIMER_QUEUE_SINGLE_INVOCATION_PERIOD) {
+            timerWheelReleaseEntry(pWorker, index);
+        } else {
+            // Periodic timers run again one period after this run instead of catching up on missed ticks
+            timerWheelSchedule(pWorker, index, MAX(tick, nowTick) + timerWheelPeriodToTicks(pEntry->period));
+        }
+    }
+}
+
+// Next tick that needs processing: the next non-empty level 0 slot, or the next cascade
+static UINT64 timerWheelNextTick(PTimerWheelWorker pWorker)
+{
+    UINT64 tick = pWorker->currentTick;
+
+    if (pWorker->activeTimerCount == 0) {
+        return MAX_UINT64;
+    }
+
+    while ((tick & (TIMER_WHEEL_LEVEL0_SLOTS - 1)) != 0 && pWorker->lists[tick & (TIMER_WHEEL_LEVEL0_SLOTS - 1)] == TIMER_WHEEL_INVALID_INDEX) {
+        tick++;
+    }
+
+    return tick;
+}
+
+static PVOID timerWheelWorkerRoutine(PVOID args)
+{
+    PTimerWheelWorker pWorker = (PTimerWheelWorker) args;
+    UINT64 now, nowTick, nextTick, wakeTime;
+
+    MUTEX_LOCK(pWorker->lock);
+    while (!ATOMIC_LOAD_BOOL(&pWorker->shutdown)) {
+        now = GETTIME();
+        nowTick = now <= pWorker->startTime ? 0 : (now - pWorker->startTime) / TIMER_WHEEL_TICK_DURATION;
+
+        // Without timers the wheel simply follows the clock
+        if (pWorker->activeTimerCount == 0) {
+            pWorker->currentTick = MAX(pWorker->currentTick, nowTick);
+        }
+
+        while (pWorker->currentTick <= nowTick && pWorker->activeTimerCount != 0 && !ATOMIC_LOAD_BOOL(&pWorker->shutdown)) {
+            // Skip empty level 0 slots, never past a cascade
+            nextTick = timerWheelNextTick(pWorker);
+            if (nextTick > pWorker->currentTick) {
+                pWorker->currentTick = MIN(nextTick, nowTick + 1);
+            } else {
+                timerWheelRunTick(pWorker, nowTick);
+            }
+        }
+
+        pWorker->wakeTick = timerWheelNextTick(pWorker);
+        if (pWorker->wakeTick == MAX_UINT64) {
+            CVAR_WAIT(pWorker->cvar, pWorker->lock, INFINITE_TIME_VALUE);
+        } else {
+            wakeTime = pWorker->startTime + pWorker->wakeTick * TIMER_WHEEL_TICK_DURATION;
+            now = GETTIME();
+            if (wakeTime > now) {
+                CVAR_WAIT(pWorker->cvar, pWorker->lock, wakeTime - now);
+            }
+        }
+        pWorker->wakeTick = MAX_UINT64;
+    }
+    MUTEX_UNLOCK(pWorker->lock);
+
+    return NULL;
+}
+
+STATUS createTimerWheel(UINT32 workerCount, PTimerWheel* ppTimerWheel)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheel pTimerWheel = NULL;
+    PTimerWheelWorker pWorker;
+    UINT32 i, j;
+
+    CHK(ppTimerWheel != NULL, STATUS_NULL_ARG);
+    CHK(workerCount > 0 && workerCount <= TIMER_WHEEL_MAX_WORKER_COUNT, STATUS_INVALID_ARG);
+
+    CHK(NULL != (pTimerWheel = (PTimerWheel) MEMCALLOC(1, SIZEOF(TimerWheel))), STATUS_NOT_ENOUGH_MEMORY);
+    CHK(NULL != (pTimerWheel->pWorkers = (PTimerWheelWorker) MEMCALLOC(workerCount, SIZEOF(TimerWheelWorker))), STATUS_NOT_ENOUGH_MEMORY);
+
+    for (i = 0; i < workerCount; i++) {
+        pWorker = &pTimerWheel->pWorkers[i];
+        pWorker->lock = INVALID_MUTEX_VALUE;
+        pWorker->cvar = INVALID_CVAR_VALUE;
+        pWorker->callbackCvar = INVALID_CVAR_VALUE;
+        pWorker->workerTid = INVALID_TID_VALUE;
+    }
+
+    // Count workers as they are set up so freeTimerWheel only tears down what exists
+    for (i = 0; i < workerCount; i++) {
+        pWorker = &pTimerWheel->pWorkers[i];
+        pTimerWheel->workerCount++;
+        pWorker->lock = MUTEX_CREATE(TRUE);
+        pWorker->cvar = CVAR_CREATE();
+        pWorker->callbackCvar = CVAR_CREATE();
+        CHK(IS_VALID_MUTEX_VALUE(pWorker->lock) && IS_VALID_CVAR_VALUE(pWorker->cvar) && IS_VALID_CVAR_VALUE(pWorker->callbackCvar),
+            STATUS_INVALID_OPERATION);
+        ATOMIC_STORE_BOOL(&pWorker->shutdown, FALSE);
+        pWorker->startTime = GETTIME();
+        pWorker->wakeTick = MAX_UINT64;
+        pWorker->runningIndex = TIMER_WHEEL_INVALID_INDEX;
+        pWorker->freeHead = TIMER_WHEEL_INVALID_INDEX;
+        for (j = 0; j < TIMER_WHEEL_LIST_COUNT; j++) {
+            pWorker->lists[j] = TIMER_WHEEL_INVALID_INDEX;
+        }
+        CHK_STATUS(timerWheelGrowEntries(pWorker));
+        CHK_STATUS(THREAD_CREATE(&pWorker->workerTid, timerWheelWorkerRoutine, (PVOID) pWorker));
+    }
+
+    DLOGI("Created timer wheel with %u workers", workerCount);
+
+CleanUp:
+
+    CHK_LOG_ERR(retStatus);
+
+    if (STATUS_FAILED(retStatus)) {
+        freeTimerWheel(&pTimerWheel);
+    }
+
+    if (ppTimerWheel != NULL) {
+        *ppTimerWheel = pTimerWheel;
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS freeTimerWheel(PTimerWheel* ppTimerWheel)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheel pTimerWheel;
+    PTimerWheelWorker pWorker;
+    UINT32 i;
+
+    CHK(ppTimerWheel != NULL, STATUS_NULL_ARG);
+    pTimerWheel = *ppTimerWheel;
+    CHK(pTimerWheel != NULL, retStatus);
+
+    for (i = 0; i < pTimerWheel->workerCount; i++) {
+        pWorker = &pTimerWheel->pWorkers[i];
+        if (IS_VALID_TID_VALUE(pWorker->workerTid)) {
+            MUTEX_LOCK(pWorker->lock);
+            ATOMIC_STORE_BOOL(&pWorker->shutdown, TRUE);
+            CVAR_SIGNAL(pWorker->cvar);
+            MUTEX_UNLOCK(pWorker->lock);
+            THREAD_JOIN(pWorker->workerTid, NULL);
+        }
+
+        if (pWorker->queueCount != 0) {
+            DLOGW("Freeing timer wheel with %u queues still attached to worker %u", pWorker->queueCount, i);
+        }
+
+        if (IS_VALID_CVAR_VALUE(pWorker->cvar)) {
+            CVAR_FREE(pWorker->cvar);
+        }
+        if (IS_VALID_CVAR_VALUE(pWorker->callbackCvar)) {
+            CVAR_FREE(pWorker->callbackCvar);
+        }
+        if (IS_VALID_MUTEX_VALUE(pWorker->lock)) {
+            MUTEX_FREE(pWorker->lock);
+        }
+        SAFE_MEMFREE(pWorker->pEntries);
+    }
+
+    SAFE_MEMFREE(pTimerWheel->pWorkers);
+    SAFE_MEMFREE(*ppTimerWheel);
+
+CleanUp:
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS timerWheelCreateQueue(PTimerWheel pTimerWheel, PTIMER_QUEUE_HANDLE pHandle)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheelQueue pQueue = NULL;
+    PTimerWheelWorker pWorker;
+    UINT32 i;
+
+    CHK(pTimerWheel != NULL && pHandle != NULL, STATUS_NULL_ARG);
+    CHK(NULL != (pQueue = (PTimerWheelQueue) MEMCALLOC(1, SIZEOF(TimerWheelQueue))), STATUS_NOT_ENOUGH_MEMORY);
+
+    // Pin the queue to the worker with the fewest queues so its timers stay serialized on one thread
+    pWorker = &pTimerWheel->pWorkers[0];
+    for (i = 1; i < pTimerWheel->workerCount; i++) {
+        if (pTimerWheel->pWorkers[i].queueCount < pWorker->queueCount) {
+            pWorker = &pTimerWheel->pWorkers[i];
+        }
+    }
+
+    MUTEX_LOCK(pWorker->lock);
+    pWorker->queueCount++;
+    MUTEX_UNLOCK(pWorker->lock);
+
+    pQueue->pTimerWheel = pTimerWheel;
+    pQueue->pWorker = pWorker;
+    *pHandle = TO_TIMER_WHEEL_QUEUE_HANDLE(pQueue);
+
+CleanUp:
+
+    if (STATUS_FAILED(retStatus)) {
+        SAFE_MEMFREE(pQueue);
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+PTimerWheel getSharedTimerWheel(VOID)
+{
+    return gSharedTimerWheel;
+}
+
+STATUS createSharedTimerWheel(VOID)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    PCHAR pWorkerCount;
+    UINT32 workerCount = 0;
+
+    CHK_WARN(gSharedTimerWheel == NULL, STATUS_INVALID_OPERATION, "Timer wheel already set up");
+
+    // Opt-in, peer connections keep a timer queue each unless the env is set
+    if (NULL != (pWorkerCount = GETENV(WEBRTC_TIMER_WHEEL_THREADS_ENV_VAR)) && STATUS_SUCCESS != STRTOUI32(pWorkerCount, NULL, 10, &workerCount)) {
+        DLOGW("Ignoring invalid %s value %s", WEBRTC_TIMER_WHEEL_THREADS_ENV_VAR, pWorkerCount);
+        workerCount = 0;
+    }
+    CHK(workerCount != 0, retStatus);
+
+    CHK_STATUS(createTimerWheel(MIN(workerCount, TIMER_WHEEL_MAX_WORKER_COUNT), &gSharedTimerWheel));
+
+CleanUp:
+
+    return retStatus;
+}
+
+STATUS freeSharedTimerWheel(VOID)
+{
+    return freeTimerWheel(&gSharedTimerWheel);
+}
+
+STATUS kvsTimerQueueCreate(PTIMER_QUEUE_HANDLE pHandle)
+{
+    if (gSharedTimerWheel != NULL) {
+        return timerWheelCreateQueue(gSharedTimerWheel, pHandle);
+    }
+
+    return timerQueueCreate(pHandle);
+}
+
+STATUS kvsTimerQueueShutdown(TIMER_QUEUE_HANDLE handle)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheelQueue pQueue;
+    PTimerWheelWorker pWorker;
+    PTimerWheelEntry pEntry;
+    UINT32 i;
+
+    if (!IS_TIMER_WHEEL_QUEUE_HANDLE(handle)) {
+        return timerQueueShutdown(handle);
+    }
+
+    pQueue = FROM_TIMER_WHEEL_QUEUE_HANDLE(handle);
+    pWorker = pQueue->pWorker;
+
+    MUTEX_LOCK(pWorker->lock);
+    pQueue->shutdown = TRUE;
+    for (i = 0; i < pWorker->entryCount; i++) {
+        pEntry = &pWorker->pEntries[i];
+        if (pEntry->pQueue != pQueue) {
+            continue;
+        }
+
+        if (pEntry->state == TIMER_WHEEL_ENTRY_SCHEDULED) {
+            timerWheelUnlink(pWorker, i);
+            timerWheelReleaseEntry(pWorker, i);
+        } else if (pEntry->state == TIMER_WHEEL_ENTRY_RUNNING) {
+            // Released by the worker once the callback returns
+            pEntry->timerCallbackFn = NULL;
+            pEntry->pQueue = NULL;
+        }
+    }
+
+    // Nothing of the queue gets scheduled anymore, wait for a callback of it in flight unless called from one
+    timerWheelWaitForCallback(pWorker, pQueue, TIMER_WHEEL_INVALID_INDEX);
+    MUTEX_UNLOCK(pWorker->lock);
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS kvsTimerQueueFree(PTIMER_QUEUE_HANDLE pHandle)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheelQueue pQueue;
+
+    CHK(pHandle != NULL, STATUS_NULL_ARG);
+    if (!IS_TIMER_WHEEL_QUEUE_HANDLE(*pHandle)) {
+        return timerQueueFree(pHandle);
+    }
+
+    pQueue = FROM_TIMER_WHEEL_QUEUE_HANDLE(*pHandle);
+    CHK_STATUS(kvsTimerQueueShutdown(*pHandle));
+
+    MUTEX_LOCK(pQueue->pWorker->lock);
+    pQueue->pWorker->queueCount--;
+    MUTEX_UNLOCK(pQueue->pWorker->lock);
+
+    MEMFREE(pQueue);
+    *pHandle = INVALID_TIMER_QUEUE_HANDLE_VALUE;
+
+CleanUp:
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS kvsTimerQueueAddTimer(TIMER_QUEUE_HANDLE handle, UINT64 start, UINT64 period, TimerCallbackFunc timerCallbackFn, UINT64 customData,
+                             PUINT32 pTimerId)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheelQueue pQueue;
+    PTimerWheelWorker pWorker = NULL;
+    PTimerWheelEntry pEntry;
+    UINT32 index;
+    BOOL locked = FALSE;
+
+    if (!IS_TIMER_WHEEL_QUEUE_HANDLE(handle)) {
+        return timerQueueAddTimer(handle, start, period, timerCallbackFn, customData, pTimerId);
+    }
+
+    CHK(timerCallbackFn != NULL && pTimerId != NULL, STATUS_NULL_ARG);
+    CHK(period == TIMER_QUEUE_SINGLE_INVOCATION_PERIOD || period >= MIN_TIMER_QUEUE_PERIOD_DURATION, STATUS_INVALID_TIMER_PERIOD_VALUE);
+
+    pQueue = FROM_TIMER_WHEEL_QUEUE_HANDLE(handle);
+    pWorker = pQueue->pWorker;
+
+    MUTEX_LOCK(pWorker->lock);
+    locked = TRUE;
+
+    CHK(!pQueue->shutdown && !ATOMIC_LOAD_BOOL(&pWorker->shutdown), STATUS_TIMER_QUEUE_SHUTDOWN);
+    if (pWorker->freeHead == TIMER_WHEEL_INVALID_INDEX) {
+        CHK_STATUS(timerWheelGrowEntries(pWorker));
+    }
+
+    index = pWorker->freeHead;
+    pEntry = &pWorker->pEntries[index];
+    pWorker->freeHead = pEntry->next;
+    pWorker->activeTimerCount++;
+
+    pEntry->timerCallbackFn = timerCallbackFn;
+    pEntry->customData = customData;
+    pEntry->period = period;
+    pEntry->pQueue = pQueue;
+    timerWheelSchedule(pWorker, index, timerWheelTimeToTick(pWorker, GETTIME() + start));
+
+    *pTimerId = index;
+
+CleanUp:
+
+    if (locked) {
+        MUTEX_UNLOCK(pWorker->lock);
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS kvsTimerQueueCancelTimer(TIMER_QUEUE_HANDLE handle, UINT32 timerId, UINT64 customData)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheelQueue pQueue;
+    PTimerWheelWorker pWorker = NULL;
+    PTimerWheelEntry pEntry;
+    BOOL locked = FALSE;
+
+    if (!IS_TIMER_WHEEL_QUEUE_HANDLE(handle)) {
+        return timerQueueCancelTimer(handle, timerId, customData);
+    }
+
+    pQueue = FROM_TIMER_WHEEL_QUEUE_HANDLE(handle);
+    pWorker = pQueue->pWorker;
+
+    MUTEX_LOCK(pWorker->lock);
+    locked = TRUE;
+
+    // The timer's callback may be using customData right now, the caller can release it once this returns
+    timerWheelWaitForCallback(pWorker, pQueue, timerId);
+
+    CHK(timerId < pWorker->entryCount, STATUS_INVALID_ARG);
+    pEntry = &pWorker->pEntries[timerId];
+
+    // Check if anything needs to be done
+    CHK(pEntry->pQueue == pQueue && pEntry->timerCallbackFn != NULL && pEntry->customData == customData, retStatus);
+
+    if (pEntry->state == TIMER_WHEEL_ENTRY_SCHEDULED) {
+        timerWheelUnlink(pWorker, timerId);
+        timerWheelReleaseEntry(pWorker, timerId);
+    } else {
+        // Cancelled from its own callback, released once the callback returns
+        pEntry->timerCallbackFn = NULL;
+    }
+
+CleanUp:
+
+    if (locked) {
+        MUTEX_UNLOCK(pWorker->lock);
+    }
+
+    LEAVES();
+    return retStatus;
+}
+
+STATUS kvsTimerQueueUpdateTimerPeriod(TIMER_QUEUE_HANDLE handle, UINT64 customData, UINT32 timerId, UINT64 period)
+{
+    ENTERS();
+    STATUS retStatus = STATUS_SUCCESS;
+    PTimerWheelQueue pQueue;
+    PTimerWheelWorker pWorker = NULL;
+    PTimerWheelEntry pEntry;
+    BOOL locked = FALSE;
+
+    if (!IS_TIMER_WHEEL_QUEUE_HANDLE(handle)) {
+        return timerQueueUpdateTimerPeriod(handle, customData, timerId, period);
+    }
+
+    CHK(period == TIMER_QUEUE_SINGLE_INVOCATION_PERIOD || period >= MIN_TIMER_QUEUE_PERIOD_DURATION, STATUS_INVALID_TIMER_PERIOD_VALUE);
+
+    pQueue = FROM_TIMER_WHEEL_QUEUE_HANDLE(handle);
+    pWorker = pQueue->pWorker;
+
+    MUTEX_LOCK(pWorker->lock);
+    locked = TRUE;
+
+    CHK(timerId < pWorker->entryCount, STATUS_INVALID_ARG);
+    pEntry = &pWorker->pEntries[timerId];
+
+    // Check if anything needs to be done
+    CHK(pEntry->pQueue == pQueue && pEntry->timerCallbackFn != NULL && pEntry->customData == customData, retStatus);
+
+    // Takes effect immediately. A running timer picks the new period up when its callback returns.
+    pEntry->period = period;
+    if (pEntry->state == TIMER_WHEEL_ENTRY_SCHEDULED) {
+        timerWheelUnlink(pWorker, timerId);
+        timerWheelSchedule(pWorker, timerId, timerWheelTimeToTick(pWorker, GETTIME() + period));
+    }
+
+CleanUp:
+
+    if (locked) {
+        MUTEX_UNLOCK(pWorker->lock);
+    }
+
+    LEAVES();
+    return retStatus;
+}
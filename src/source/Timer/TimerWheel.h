@@ -0,0 +1,139 @@
+/*******************************************
+Shared timer wheel include file
+*******************************************/
+#ifndef __KINESIS_VIDEO_WEBRTC_CLIENT_TIMERWHEEL__
+#define __KINESIS_VIDEO_WEBRTC_CLIENT_TIMERWHEEL__
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wheel resolution. Timers fire on the first tick at or after their due time
+#define TIMER_WHEEL_TICK_DURATION (1 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND)
+
+// Level 0 has one slot per tick, every higher level has one slot per full turn of the level below:
+// 256ms, 16.4s, 17.5min and 18.6h of coverage. Longer timers are parked in the last level and re-cascaded.
+#define TIMER_WHEEL_LEVEL0_BITS  8
+#define TIMER_WHEEL_LEVELN_BITS  6
+#define TIMER_WHEEL_LEVEL_COUNT  4
+#define TIMER_WHEEL_LEVEL0_SLOTS (1 << TIMER_WHEEL_LEVEL0_BITS)
+#define TIMER_WHEEL_LEVELN_SLOTS (1 << TIMER_WHEEL_LEVELN_BITS)
+#define TIMER_WHEEL_MAX_TICKS    ((UINT64) 1 << (TIMER_WHEEL_LEVEL0_BITS + (TIMER_WHEEL_LEVEL_COUNT - 1) * TIMER_WHEEL_LEVELN_BITS))
+// Every slot list head plus the list of timers being fired on the current tick
+#define TIMER_WHEEL_LIST_COUNT   (TIMER_WHEEL_LEVEL0_SLOTS + (TIMER_WHEEL_LEVEL_COUNT - 1) * TIMER_WHEEL_LEVELN_SLOTS + 1)
+#define TIMER_WHEEL_EXPIRED_LIST (TIMER_WHEEL_LIST_COUNT - 1)
+
+#define TIMER_WHEEL_INVALID_INDEX       MAX_UINT32
+#define TIMER_WHEEL_DEFAULT_TIMER_COUNT 64
+#define TIMER_WHEEL_MAX_WORKER_COUNT    64
+
+// Timer queue handles backed by the wheel carry this tag in the low bit so they can be told apart from kvspic ones
+#define TIMER_WHEEL_QUEUE_HANDLE_TAG     ((TIMER_QUEUE_HANDLE) 1)
+#define IS_TIMER_WHEEL_QUEUE_HANDLE(h)   (IS_VALID_TIMER_QUEUE_HANDLE(h) && ((h) &TIMER_WHEEL_QUEUE_HANDLE_TAG) != 0)
+#define TO_TIMER_WHEEL_QUEUE_HANDLE(p)   ((TIMER_QUEUE_HANDLE) (p) | TIMER_WHEEL_QUEUE_HANDLE_TAG)
+#define FROM_TIMER_WHEEL_QUEUE_HANDLE(h) ((PTimerWheelQueue) ((h) & ~TIMER_WHEEL_QUEUE_HANDLE_TAG))
+
+typedef enum {
+    TIMER_WHEEL_ENTRY_FREE,
+    TIMER_WHEEL_ENTRY_SCHEDULED,
+    TIMER_WHEEL_ENTRY_RUNNING,
+} TIMER_WHEEL_ENTRY_STATE;
+
+struct __TimerWheelQueue;
+
+typedef struct {
+    TimerCallbackFunc timerCallbackFn; //!< NULL once cancelled
+    UINT64 customData;                 //!< Passed back to the callback, also required to cancel the timer
+    UINT64 period;                     //!< Period in 100ns, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD for one-shot timers
+    UINT64 expiryTick;                 //!< Wheel tick the timer is due on
+    struct __TimerWheelQueue* pQueue;  //!< Owning queue
+    UINT32 next;                       //!< Next entry in the same list, or in the free list
+    UINT32 prev;                       //!< Previous entry in the same list
+    UINT32 list;                       //!< List the entry is linked into
+    TIMER_WHEEL_ENTRY_STATE state;
+} TimerWheelEntry, *PTimerWheelEntry;
+
+// One worker thread and the wheel it drives. Every queue lives on exactly one worker, so timers of one peer
+// connection never fire concurrently, as with a dedicated timer queue.
+typedef struct {
+    MUTEX lock;                              //!< Reentrant, guards the wheel. Not held while callbacks run
+    CVAR cvar;                               //!< Signaled when a timer is due before wakeTick or on shutdown
+    CVAR callbackCvar;                       //!< Signaled when a callback returns, cancelling a timer waits on it for a callback in flight
+    UINT32 runningIndex;                     //!< Entry whose callback is in flight, TIMER_WHEEL_INVALID_INDEX between callbacks
+    struct __TimerWheelQueue* pRunningQueue; //!< Queue of the callback in flight
+    TID workerTid;
+    volatile ATOMIC_BOOL shutdown;
+    UINT64 startTime;                        //!< Time of tick 0
+    UINT64 currentTick;                      //!< Next tick to process, every scheduled timer is due on or after it
+    UINT64 wakeTick;                         //!< Tick the worker sleeps until, MAX_UINT64 when idle
+    UINT32 activeTimerCount;                 //!< Scheduled and running timers
+    UINT32 queueCount;                       //!< Queues assigned to this worker
+    PTimerWheelEntry pEntries;               //!< Entry pool. Lists link entries by index so the pool can grow, entry index is the timer id
+    UINT32 entryCount;
+    UINT32 freeHead;
+    UINT32 lists[TIMER_WHEEL_LIST_COUNT];
+} TimerWheelWorker, *PTimerWheelWorker;
+
+typedef struct {
+    UINT32 workerCount;
+    PTimerWheelWorker pWorkers;
+} TimerWheel, *PTimerWheel;
+
+typedef struct __TimerWheelQueue {
+    PTimerWheel pTimerWheel;
+    PTimerWheelWorker pWorker;
+    BOOL shutdown;
+} TimerWheelQueue, *PTimerWheelQueue;
+
+/**
+ * Creates a timer wheel with its worker threads
+ *
+ * @param - UINT32 - IN - Number of worker threads, between 1 and TIMER_WHEEL_MAX_WORKER_COUNT
+ * @param - PTimerWheel* - OUT - Created timer wheel
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS createTimerWheel(UINT32, PTimerWheel*);
+
+/**
+ * Stops the worker threads and frees the timer wheel. All queues must have been freed before.
+ *
+ * @param - PTimerWheel* - IN/OUT - Timer wheel to free, set to NULL
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS freeTimerWheel(PTimerWheel*);
+
+/**
+ * Creates a timer queue on the least loaded worker of the wheel. The handle is used with the kvsTimerQueue* calls.
+ *
+ * @param - PTimerWheel - IN - Timer wheel
+ * @param - PTIMER_QUEUE_HANDLE - OUT - Timer queue handle
+ *
+ * @return - STATUS code of the execution
+ */
+STATUS timerWheelCreateQueue(PTimerWheel, PTIMER_QUEUE_HANDLE);
+
+/**
+ * Process-wide wheel shared by every peer connection, created by initKvsWebRtc when
+ * WEBRTC_TIMER_WHEEL_THREADS_ENV_VAR is set. NULL otherwise.
+ */
+PTimerWheel getSharedTimerWheel(VOID);
+STATUS createSharedTimerWheel(VOID);
+STATUS freeSharedTimerWheel(VOID);
+
+// Timer queue calls taking either a kvspic timer queue handle or a timer wheel queue handle. Same contract as the
+// timerQueue* function of the same name.
+STATUS kvsTimerQueueCreate(PTIMER_QUEUE_HANDLE);
+STATUS kvsTimerQueueFree(PTIMER_QUEUE_HANDLE);
+STATUS kvsTimerQueueAddTimer(TIMER_QUEUE_HANDLE, UINT64, UINT64, TimerCallbackFunc, UINT64, PUINT32);
+STATUS kvsTimerQueueCancelTimer(TIMER_QUEUE_HANDLE, UINT32, UINT64);
+STATUS kvsTimerQueueUpdateTimerPeriod(TIMER_QUEUE_HANDLE, UINT64, UINT32, UINT64);
+STATUS kvsTimerQueueShutdown(TIMER_QUEUE_HANDLE);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __KINESIS_VIDEO_WEBRTC_CLIENT_TIMERWHEEL__ */
@@ -33,6 +33,30 @@ TEST_F(DataChannelApiTest, createDataChannel_Disconnected)
     freePeerConnection(&pPeerConnection);
 }
 
+TEST_F(DataChannelApiTest, createOffer_advertisesMaxMessageSize)
+{
+    RtcConfiguration configuration;
+    PRtcPeerConnection pPeerConnection = nullptr;
+    PRtcDataChannel pDataChannel = nullptr;
+    RtcSessionDescriptionInit sessionDescriptionInit;
+
+    initRtcConfiguration(&configuration);
+    configuration.kvsRtcConfiguration.sctpMaxMessageSize = 100000;
+
+    EXPECT_EQ(createPeerConnection(&configuration, &pPeerConnection), STATUS_SUCCESS);
+    EXPECT_EQ(createDataChannel(pPeerConnection, (PCHAR) "DataChannel 1", nullptr, &pDataChannel), STATUS_SUCCESS);
+    EXPECT_EQ(createOffer(pPeerConnection, &sessionDescriptionInit), STATUS_SUCCESS);
+#ifdef ENABLE_NATIVE_SCTP
+    EXPECT_NE(STRSTR(sessionDescriptionInit.sdp, "a=max-message-size:100000"), nullptr);
+#else
+    // usrsctp does not enforce the limit, so it is not advertised
+    EXPECT_EQ(STRSTR(sessionDescriptionInit.sdp, "a=max-message-size"), nullptr);
+#endif
+
+    closePeerConnection(pPeerConnection);
+    freePeerConnection(&pPeerConnection);
+}
+
 } // namespace webrtcclient
 } // namespace video
 } // namespace kinesis
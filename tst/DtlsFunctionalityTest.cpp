@@ -248,6 +248,182 @@ TEST_F(DtlsFunctionalityTest, processPacketWithVariedSizesInThread)
     MEMFREE(pData);
 }
 
+static BOOL waitForCertificatePool(UINT32 ecdsaCount, UINT32 rsaCount)
+{
+    CertificatePoolStats stats;
+
+    for (UINT64 duration = 0; duration < MAX_TEST_AWAIT_DURATION; duration += 20 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND) {
+        if (STATUS_SUCCEEDED(certificatePoolGetStats(&stats)) && stats.readyCounts[CERTIFICATE_POOL_TYPE_ECDSA] >= ecdsaCount &&
+            stats.readyCounts[CERTIFICATE_POOL_TYPE_RSA] >= rsaCount) {
+            return TRUE;
+        }
+        THREAD_SLEEP(20 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    }
+
+    return FALSE;
+}
+
+static VOID freePooledCertificate(PDtlsSessionCertificateInfo pCertInfo)
+{
+#ifdef KVS_USE_OPENSSL
+    freeCertificateAndKey(&pCertInfo->pCert, &pCertInfo->pKey);
+#else
+    freeCertificateAndKey(&pCertInfo->cert, &pCertInfo->privateKey);
+#endif
+}
+
+TEST_F(DtlsFunctionalityTest, certificatePoolInvalidArgs)
+{
+    RtcCertificatePoolConfig config{};
+    CertificatePoolStats stats;
+    DtlsSessionCertificateInfo certInfo;
+    BOOL taken = TRUE;
+
+    EXPECT_EQ(STATUS_NULL_ARG, initRtcCertificatePool(NULL));
+    config.ecdsaCertificateCount = MAX_RTC_CERTIFICATE_POOL_SIZE + 1;
+    EXPECT_EQ(STATUS_INVALID_ARG, initRtcCertificatePool(&config));
+    config.ecdsaCertificateCount = 0;
+    config.rsaCertificateBits = -1;
+    EXPECT_EQ(STATUS_INVALID_ARG, initRtcCertificatePool(&config));
+    EXPECT_EQ(STATUS_INVALID_OPERATION, certificatePoolGetStats(&stats));
+
+    // Without a pool nothing is handed out
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolTake(FALSE, 0, &certInfo, &taken));
+    EXPECT_FALSE(taken);
+    EXPECT_EQ(STATUS_NULL_ARG, certificatePoolTake(FALSE, 0, NULL, &taken));
+
+    config.rsaCertificateBits = 0;
+    EXPECT_EQ(STATUS_SUCCESS, initRtcCertificatePool(&config));
+    EXPECT_EQ(STATUS_INVALID_OPERATION, initRtcCertificatePool(&config));
+    EXPECT_EQ(STATUS_NULL_ARG, certificatePoolGetStats(NULL));
+    EXPECT_EQ(STATUS_SUCCESS, deinitRtcCertificatePool());
+    EXPECT_EQ(STATUS_SUCCESS, deinitRtcCertificatePool());
+}
+
+TEST_F(DtlsFunctionalityTest, certificatePoolHandsOutAndRefills)
+{
+    RtcCertificatePoolConfig config{};
+    CertificatePoolStats stats;
+    DtlsSessionCertificateInfo certInfo;
+    BOOL taken;
+
+    config.ecdsaCertificateCount = 2;
+    config.rsaCertificateCount = 1;
+    config.rsaCertificateBits = 1024;
+    ASSERT_EQ(STATUS_SUCCESS, initRtcCertificatePool(&config));
+    ASSERT_TRUE(waitForCertificatePool(2, 1));
+
+    MEMSET(&certInfo, 0x00, SIZEOF(certInfo));
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolTake(FALSE, GENERATED_CERTIFICATE_BITS, &certInfo, &taken));
+    EXPECT_TRUE(taken);
+    freePooledCertificate(&certInfo);
+
+    // RSA certificates are only handed out for the pooled key size
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolTake(TRUE, GENERATED_CERTIFICATE_BITS, &certInfo, &taken));
+    EXPECT_FALSE(taken);
+    MEMSET(&certInfo, 0x00, SIZEOF(certInfo));
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolTake(TRUE, 1024, &certInfo, &taken));
+    EXPECT_TRUE(taken);
+    freePooledCertificate(&certInfo);
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolTake(TRUE, 1024, &certInfo, &taken));
+    EXPECT_FALSE(taken);
+
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolGetStats(&stats));
+    EXPECT_EQ(2, stats.takenCount);
+    EXPECT_EQ(2, stats.missedCount);
+
+    // Taken certificates are replaced in the background
+    EXPECT_TRUE(waitForCertificatePool(2, 1));
+    EXPECT_EQ(STATUS_SUCCESS, deinitRtcCertificatePool());
+}
+
+static PVOID takePooledCertificatesRoutine(PVOID args)
+{
+    volatile ATOMIC_BOOL* pStop = (volatile ATOMIC_BOOL*) args;
+    DtlsSessionCertificateInfo certInfo;
+    BOOL taken;
+
+    while (!ATOMIC_LOAD_BOOL(pStop)) {
+        MEMSET(&certInfo, 0x00, SIZEOF(certInfo));
+        if (STATUS_SUCCEEDED(certificatePoolTake(FALSE, GENERATED_CERTIFICATE_BITS, &certInfo, &taken)) && taken) {
+            freePooledCertificate(&certInfo);
+        }
+    }
+
+    return NULL;
+}
+
+TEST_F(DtlsFunctionalityTest, certificatePoolDeinitWhileTaking)
+{
+    RtcCertificatePoolConfig config{};
+    CertificatePoolStats stats;
+    volatile ATOMIC_BOOL stop = FALSE;
+    TID takers[4];
+    DtlsSessionCertificateInfo certInfo;
+    BOOL taken = TRUE;
+    UINT32 i;
+
+    config.ecdsaCertificateCount = 2;
+    ASSERT_EQ(STATUS_SUCCESS, initRtcCertificatePool(&config));
+    for (i = 0; i < ARRAY_SIZE(takers); i++) {
+        ASSERT_EQ(STATUS_SUCCESS, THREAD_CREATE(&takers[i], takePooledCertificatesRoutine, (PVOID) &stop));
+    }
+
+    // Takers racing the teardown either get a certificate or find no pool, never a freed one
+    THREAD_SLEEP(50 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(STATUS_SUCCESS, deinitRtcCertificatePool());
+    EXPECT_EQ(STATUS_INVALID_OPERATION, certificatePoolGetStats(&stats));
+    THREAD_SLEEP(10 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+
+    ATOMIC_STORE_BOOL(&stop, TRUE);
+    for (i = 0; i < ARRAY_SIZE(takers); i++) {
+        THREAD_JOIN(takers[i], NULL);
+    }
+
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolTake(FALSE, GENERATED_CERTIFICATE_BITS, &certInfo, &taken));
+    EXPECT_FALSE(taken);
+}
+
+TEST_F(DtlsFunctionalityTest, certificatePoolRotatesOldCertificates)
+{
+    RtcCertificatePoolConfig config{};
+    CertificatePoolStats stats;
+
+    config.ecdsaCertificateCount = 1;
+    config.maxCertificateAge = 100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND;
+    ASSERT_EQ(STATUS_SUCCESS, initRtcCertificatePool(&config));
+    ASSERT_TRUE(waitForCertificatePool(1, 0));
+
+    THREAD_SLEEP(500 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolGetStats(&stats));
+    EXPECT_LE(2, stats.rotatedCount);
+    EXPECT_TRUE(waitForCertificatePool(1, 0));
+    EXPECT_EQ(STATUS_SUCCESS, deinitRtcCertificatePool());
+}
+
+TEST_F(DtlsFunctionalityTest, dtlsSessionsUsePooledCertificates)
+{
+    RtcCertificatePoolConfig config{};
+    CertificatePoolStats stats;
+    PDtlsSession pClient = NULL, pServer = NULL;
+    TIMER_QUEUE_HANDLE timerQueueHandle = INVALID_TIMER_QUEUE_HANDLE_VALUE;
+
+    config.ecdsaCertificateCount = 2;
+    ASSERT_EQ(STATUS_SUCCESS, initRtcCertificatePool(&config));
+    ASSERT_TRUE(waitForCertificatePool(2, 0));
+
+    EXPECT_EQ(STATUS_SUCCESS, timerQueueCreate(&timerQueueHandle));
+    EXPECT_EQ(STATUS_SUCCESS, createAndConnect(timerQueueHandle, &pClient, &pServer, FALSE));
+    EXPECT_NE(nullptr, pClient);
+    EXPECT_NE(nullptr, pServer);
+    EXPECT_EQ(STATUS_SUCCESS, certificatePoolGetStats(&stats));
+    EXPECT_EQ(2, stats.takenCount);
+
+    freeDtlsSession(&pClient);
+    freeDtlsSession(&pServer);
+    timerQueueFree(&timerQueueHandle);
+    // Left for deinitKvsWebRtc to release
+}
 
 } // namespace webrtcclient
 } // namespace video
@@ -220,6 +220,416 @@ TEST_F(IceFunctionalityTest, connectionListenerFunctionalityTest)
     }
 }
 
+typedef struct {
+    std::atomic<UINT32> datagramCount;
+    std::atomic<UINT32> byteCount;
+    std::atomic<BOOL> outOfOrder;
+} ConnectionListenerReceiveCounter;
+
+STATUS connectionListenerCountingCallback(UINT64 customData, PSocketConnection pSocketConnection, PBYTE pBuffer, UINT32 bufferLen,
+                                          PKvsIpAddress pSrc, PKvsIpAddress pDest)
+{
+    UNUSED_PARAM(pSocketConnection);
+    UNUSED_PARAM(pDest);
+    ConnectionListenerReceiveCounter* pCounter = (ConnectionListenerReceiveCounter*) customData;
+
+    // Every datagram carries its sequence number in the first byte
+    if (pSrc == NULL || pBuffer[0] != (BYTE) pCounter->datagramCount.load()) {
+        pCounter->outOfOrder = TRUE;
+    }
+    pCounter->byteCount += bufferLen;
+    pCounter->datagramCount++;
+
+    return STATUS_SUCCESS;
+}
+
+TEST_F(IceFunctionalityTest, connectionListenerBatchedReceiveTest)
+{
+    const UINT32 datagramCount = 3 * CONNECTION_LISTENER_RECV_BATCH_SIZE + 5;
+    PConnectionListener pConnectionListener = NULL;
+    PSocketConnection pSender = NULL, pReceiver = NULL;
+    ConnectionListenerReceiveCounter counter;
+    KvsIpAddress localhost;
+    BYTE packet[1000];
+    UINT32 i, expectedBytes = 0;
+    UINT64 deadline;
+
+    counter.datagramCount = 0;
+    counter.byteCount = 0;
+    counter.outOfOrder = FALSE;
+
+    MEMSET(&localhost, 0x0, SIZEOF(KvsIpAddress));
+    localhost.family = KVS_IP_FAMILY_TYPE_IPV4;
+    // 127.0.0.1
+    localhost.address[0] = 0x7f;
+    localhost.address[3] = 0x01;
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pSender));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, (UINT64) &counter,
+                                     connectionListenerCountingCallback, 0, 256 * 1024, &pReceiver));
+    ATOMIC_STORE_BOOL(&pReceiver->receiveData, TRUE);
+
+    // Queue everything before the listener starts so the first wakeup has more than one batch to drain
+    for (i = 0; i < datagramCount; i++) {
+        MEMSET(packet, (BYTE) i, SIZEOF(packet));
+        EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendData(pSender, packet, 100 + i, &pReceiver->hostIpAddr));
+        expectedBytes += 100 + i;
+    }
+
+    EXPECT_EQ(STATUS_SUCCESS, createConnectionListener(&pConnectionListener));
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerAddConnection(pConnectionListener, pReceiver));
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerStart(pConnectionListener));
+
+    deadline = GETTIME() + 5 * HUNDREDS_OF_NANOS_IN_A_SECOND;
+    while (counter.datagramCount.load() < datagramCount && GETTIME() < deadline) {
+        THREAD_SLEEP(10 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    }
+
+    EXPECT_EQ(datagramCount, counter.datagramCount.load());
+    EXPECT_EQ(expectedBytes, counter.byteCount.load());
+    EXPECT_FALSE(counter.outOfOrder.load());
+
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerRemoveConnection(pConnectionListener, pReceiver));
+    EXPECT_EQ(STATUS_SUCCESS, freeConnectionListener(&pConnectionListener));
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pSender));
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pReceiver));
+}
+
+#if defined(HAVE_RECVMMSG)
+TEST_F(IceFunctionalityTest, connectionListenerReceiveDataCapsBatchesPerWakeupTest)
+{
+    const UINT32 perWakeup = CONNECTION_LISTENER_RECV_MAX_BATCHES_PER_WAKEUP * CONNECTION_LISTENER_RECV_BATCH_SIZE;
+    const UINT32 datagramCount = perWakeup + 3;
+    PConnectionListener pConnectionListener = NULL;
+    PSocketConnection pSender = NULL, pReceiver = NULL;
+    ConnectionListenerReceiveCounter counter;
+    KvsIpAddress localhost;
+    BYTE packet[100];
+    UINT32 i;
+
+    counter.datagramCount = 0;
+    counter.byteCount = 0;
+    counter.outOfOrder = FALSE;
+
+    MEMSET(&localhost, 0x0, SIZEOF(KvsIpAddress));
+    localhost.family = KVS_IP_FAMILY_TYPE_IPV4;
+    // 127.0.0.1
+    localhost.address[0] = 0x7f;
+    localhost.address[3] = 0x01;
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pSender));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, (UINT64) &counter,
+                                     connectionListenerCountingCallback, 0, 256 * 1024, &pReceiver));
+    ATOMIC_STORE_BOOL(&pReceiver->receiveData, TRUE);
+
+    for (i = 0; i < datagramCount; i++) {
+        MEMSET(packet, (BYTE) i, SIZEOF(packet));
+        EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendData(pSender, packet, SIZEOF(packet), &pReceiver->hostIpAddr));
+    }
+
+    // The listener is not started, its first shard is only used for the receive buffers
+    EXPECT_EQ(STATUS_SUCCESS, createConnectionListener(&pConnectionListener));
+
+    // One wakeup reads a bounded number of batches, the rest waits for the next one
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerReceiveData(&pConnectionListener->pShards[0], pReceiver, pReceiver->localSocket));
+    EXPECT_EQ(perWakeup, counter.datagramCount.load());
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerReceiveData(&pConnectionListener->pShards[0], pReceiver, pReceiver->localSocket));
+    EXPECT_EQ(datagramCount, counter.datagramCount.load());
+    EXPECT_FALSE(counter.outOfOrder.load());
+
+    EXPECT_EQ(STATUS_SUCCESS, freeConnectionListener(&pConnectionListener));
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pSender));
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pReceiver));
+}
+#endif
+
+TEST_F(IceFunctionalityTest, connectionListenerShardedReceiveTest)
+{
+    const UINT32 socketCount = 8, datagramsPerSocket = 20;
+    PConnectionListener pConnectionListener = NULL;
+    PSocketConnection pSender = NULL, receivers[socketCount];
+    ConnectionListenerReceiveCounter counters[socketCount];
+    KvsIpAddress localhost;
+    BYTE packet[200];
+    UINT32 i, j, received;
+    UINT64 deadline;
+
+    MEMSET(&localhost, 0x0, SIZEOF(KvsIpAddress));
+    localhost.family = KVS_IP_FAMILY_TYPE_IPV4;
+    // 127.0.0.1
+    localhost.address[0] = 0x7f;
+    localhost.address[3] = 0x01;
+
+    // Four receive threads, all pinned to the first CPU
+    EXPECT_EQ(STATUS_SUCCESS, createConnectionListenerWithParams(4, 0x1, &pConnectionListener));
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerStart(pConnectionListener));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pSender));
+
+    for (i = 0; i < socketCount; i++) {
+        counters[i].datagramCount = 0;
+        counters[i].byteCount = 0;
+        counters[i].outOfOrder = FALSE;
+        EXPECT_EQ(STATUS_SUCCESS,
+                  createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, (UINT64) &counters[i],
+                                         connectionListenerCountingCallback, 0, 0, &receivers[i]));
+        ATOMIC_STORE_BOOL(&receivers[i]->receiveData, TRUE);
+        EXPECT_EQ(STATUS_SUCCESS, connectionListenerAddConnection(pConnectionListener, receivers[i]));
+        EXPECT_TRUE(connectionListenerHasConnection(pConnectionListener, receivers[i]));
+    }
+    EXPECT_EQ(socketCount, pConnectionListener->socketCount);
+
+#if defined(HAVE_EPOLL)
+    // Sockets are spread evenly across the receive threads
+    EXPECT_EQ(4, pConnectionListener->shardCount);
+    for (i = 0; i < pConnectionListener->shardCount; i++) {
+        EXPECT_EQ(socketCount / 4, pConnectionListener->pShards[i].socketCount);
+    }
+#endif
+
+    // Sockets added after the threads started are picked up without restarting the listener
+    for (j = 0; j < datagramsPerSocket; j++) {
+        for (i = 0; i < socketCount; i++) {
+            MEMSET(packet, (BYTE) j, SIZEOF(packet));
+            EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendData(pSender, packet, SIZEOF(packet), &receivers[i]->hostIpAddr));
+        }
+    }
+
+    deadline = GETTIME() + 5 * HUNDREDS_OF_NANOS_IN_A_SECOND;
+    do {
+        THREAD_SLEEP(10 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+        for (i = 0, received = 0; i < socketCount; i++) {
+            received += counters[i].datagramCount.load();
+        }
+    } while (received < socketCount * datagramsPerSocket && GETTIME() < deadline);
+
+    for (i = 0; i < socketCount; i++) {
+        EXPECT_EQ(datagramsPerSocket, counters[i].datagramCount.load());
+        EXPECT_FALSE(counters[i].outOfOrder.load());
+    }
+
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerRemoveConnection(pConnectionListener, receivers[0]));
+    EXPECT_FALSE(connectionListenerHasConnection(pConnectionListener, receivers[0]));
+    EXPECT_EQ(socketCount - 1, pConnectionListener->socketCount);
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerRemoveAllConnection(pConnectionListener));
+    EXPECT_EQ(0, pConnectionListener->socketCount);
+    EXPECT_EQ(STATUS_SUCCESS, freeConnectionListener(&pConnectionListener));
+
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pSender));
+    for (i = 0; i < socketCount; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&receivers[i]));
+    }
+}
+
+TEST_F(IceFunctionalityTest, connectionListenerAttachSharedTest)
+{
+    const UINT32 socketsPerListener = 3;
+    PConnectionListener pFirst = NULL, pSecond = NULL;
+    PSocketConnection pSender = NULL, first[socketsPerListener], second[socketsPerListener];
+    ConnectionListenerReceiveCounter counters[2 * socketsPerListener];
+    KvsIpAddress localhost;
+    BYTE packet[200];
+    UINT32 i, received;
+    UINT64 deadline;
+
+    MEMSET(&localhost, 0x0, SIZEOF(KvsIpAddress));
+    localhost.family = KVS_IP_FAMILY_TYPE_IPV4;
+    // 127.0.0.1
+    localhost.address[0] = 0x7f;
+    localhost.address[3] = 0x01;
+
+    // The second attach reuses the threads of the first, its parameters are ignored
+    EXPECT_EQ(STATUS_SUCCESS, attachSharedConnectionListener(2, 0, &pFirst));
+    EXPECT_EQ(STATUS_SUCCESS, attachSharedConnectionListener(8, 0, &pSecond));
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerStart(pFirst));
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerStart(pSecond));
+
+#if defined(HAVE_EPOLL)
+    // Both run on the same process-wide listener, pinned to different shards
+    EXPECT_TRUE(pFirst->pSharedListener != NULL);
+    EXPECT_EQ(pFirst->pSharedListener, pSecond->pSharedListener);
+    EXPECT_EQ(2, pFirst->pSharedListener->shardCount);
+    EXPECT_NE(pFirst->sharedShardIndex, pSecond->sharedShardIndex);
+#endif
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pSender));
+    for (i = 0; i < 2 * socketsPerListener; i++) {
+        counters[i].datagramCount = 0;
+        counters[i].byteCount = 0;
+        counters[i].outOfOrder = FALSE;
+    }
+
+    for (i = 0; i < socketsPerListener; i++) {
+        EXPECT_EQ(STATUS_SUCCESS,
+                  createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, (UINT64) &counters[i],
+                                         connectionListenerCountingCallback, 0, 0, &first[i]));
+        EXPECT_EQ(STATUS_SUCCESS,
+                  createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL,
+                                         (UINT64) &counters[socketsPerListener + i], connectionListenerCountingCallback, 0, 0, &second[i]));
+        ATOMIC_STORE_BOOL(&first[i]->receiveData, TRUE);
+        ATOMIC_STORE_BOOL(&second[i]->receiveData, TRUE);
+        EXPECT_EQ(STATUS_SUCCESS, connectionListenerAddConnection(pFirst, first[i]));
+        EXPECT_EQ(STATUS_SUCCESS, connectionListenerAddConnection(pSecond, second[i]));
+        EXPECT_TRUE(connectionListenerHasConnection(pFirst, first[i]));
+        EXPECT_FALSE(connectionListenerHasConnection(pSecond, first[i]));
+    }
+    EXPECT_EQ(socketsPerListener, pFirst->socketCount);
+    EXPECT_EQ(socketsPerListener, pSecond->socketCount);
+
+#if defined(HAVE_EPOLL)
+    // All sockets of a listener are read by the thread of its shard
+    EXPECT_EQ(2 * socketsPerListener, pFirst->pSharedListener->socketCount);
+    for (i = 0; i < socketsPerListener; i++) {
+        EXPECT_EQ(pFirst->sharedShardIndex, first[i]->listenerShardIndex);
+        EXPECT_EQ(pSecond->sharedShardIndex, second[i]->listenerShardIndex);
+    }
+#endif
+
+    for (i = 0; i < socketsPerListener; i++) {
+        MEMSET(packet, 0x00, SIZEOF(packet));
+        EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendData(pSender, packet, SIZEOF(packet), &first[i]->hostIpAddr));
+        EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendData(pSender, packet, SIZEOF(packet), &second[i]->hostIpAddr));
+    }
+
+    deadline = GETTIME() + 5 * HUNDREDS_OF_NANOS_IN_A_SECOND;
+    do {
+        THREAD_SLEEP(10 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+        for (i = 0, received = 0; i < 2 * socketsPerListener; i++) {
+            received += counters[i].datagramCount.load();
+        }
+    } while (received < 2 * socketsPerListener && GETTIME() < deadline);
+    EXPECT_EQ(2 * socketsPerListener, received);
+
+    // Removing everything from one listener leaves the sockets of the other in place
+    EXPECT_EQ(STATUS_SUCCESS, connectionListenerRemoveAllConnection(pFirst));
+    EXPECT_EQ(0, pFirst->socketCount);
+    EXPECT_EQ(socketsPerListener, pSecond->socketCount);
+    for (i = 0; i < socketsPerListener; i++) {
+        EXPECT_TRUE(connectionListenerHasConnection(pSecond, second[i]));
+    }
+
+    // Freeing an attached listener drops its remaining sockets, the last one takes the threads down
+    EXPECT_EQ(STATUS_SUCCESS, freeConnectionListener(&pFirst));
+    EXPECT_EQ(STATUS_SUCCESS, freeConnectionListener(&pSecond));
+    EXPECT_TRUE(pFirst == NULL && pSecond == NULL);
+
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pSender));
+    for (i = 0; i < socketsPerListener; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&first[i]));
+        EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&second[i]));
+    }
+}
+
+TEST_F(IceFunctionalityTest, socketConnectionSendDataBatchTest)
+{
+    PSocketConnection pSender = NULL, pReceiver = NULL;
+    KvsIpAddress localhost;
+    // Three equal sized packets followed by a shorter one can be coalesced, the last larger one can not
+    UINT32 lengths[] = {1200, 1200, 1200, 700, 1300};
+    BYTE packets[ARRAY_SIZE(lengths)][1300];
+    PBYTE buffers[ARRAY_SIZE(lengths)];
+    BYTE receiveBuffer[2048];
+    UINT32 i, sentCount = 0;
+    INT32 readLen;
+    struct pollfd pfd;
+
+    MEMSET(&localhost, 0x0, SIZEOF(KvsIpAddress));
+    localhost.family = KVS_IP_FAMILY_TYPE_IPV4;
+    // 127.0.0.1
+    localhost.address[0] = 0x7f;
+    localhost.address[3] = 0x01;
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pSender));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pReceiver));
+
+    for (i = 0; i < ARRAY_SIZE(lengths); i++) {
+        MEMSET(packets[i], (BYTE) (i + 1), lengths[i]);
+        buffers[i] = packets[i];
+    }
+
+    EXPECT_EQ(STATUS_NULL_ARG, socketConnectionSendDataBatch(pSender, NULL, lengths, ARRAY_SIZE(lengths), &pReceiver->hostIpAddr, &sentCount));
+    EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendDataBatch(pSender, buffers, lengths, 0, &pReceiver->hostIpAddr, &sentCount));
+    EXPECT_EQ(0, sentCount);
+
+    EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendDataBatch(pSender, buffers, lengths, ARRAY_SIZE(lengths), &pReceiver->hostIpAddr, &sentCount));
+    EXPECT_EQ(ARRAY_SIZE(lengths), sentCount);
+
+    // Segmentation offload must still deliver every packet as its own datagram, in order
+    pfd.fd = pReceiver->localSocket;
+    pfd.events = POLLIN;
+    for (i = 0; i < ARRAY_SIZE(lengths); i++) {
+        pfd.revents = 0;
+        ASSERT_EQ(1, poll(&pfd, 1, 1000));
+        readLen = (INT32) recv(pReceiver->localSocket, receiveBuffer, SIZEOF(receiveBuffer), 0);
+        EXPECT_EQ((INT32) lengths[i], readLen);
+        EXPECT_EQ((BYTE) (i + 1), receiveBuffer[0]);
+        EXPECT_EQ((BYTE) (i + 1), receiveBuffer[lengths[i] - 1]);
+    }
+
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pSender));
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pReceiver));
+}
+
+TEST_F(IceFunctionalityTest, socketConnectionSendDataGatherTest)
+{
+    PSocketConnection pSender = NULL, pReceiver = NULL;
+    KvsIpAddress localhost;
+    BYTE header[4] = {0x40, 0x01, 0x00, 0x05}, payload[5] = {1, 2, 3, 4, 5}, padding[3] = {0};
+    PBYTE buffers[] = {header, payload, padding};
+    UINT32 lengths[] = {SIZEOF(header), SIZEOF(payload), SIZEOF(padding)};
+    PBYTE tooManyBuffers[SOCKET_SEND_GATHER_MAX_BUFFERS + 1];
+    UINT32 tooManyLengths[SOCKET_SEND_GATHER_MAX_BUFFERS + 1];
+    BYTE receiveBuffer[64];
+    UINT32 i;
+    INT32 readLen;
+    struct pollfd pfd;
+
+    MEMSET(&localhost, 0x0, SIZEOF(KvsIpAddress));
+    localhost.family = KVS_IP_FAMILY_TYPE_IPV4;
+    // 127.0.0.1
+    localhost.address[0] = 0x7f;
+    localhost.address[3] = 0x01;
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pSender));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pReceiver));
+
+    for (i = 0; i < ARRAY_SIZE(tooManyBuffers); i++) {
+        tooManyBuffers[i] = payload;
+        tooManyLengths[i] = SIZEOF(payload);
+    }
+
+    EXPECT_EQ(STATUS_NULL_ARG, socketConnectionSendDataGather(pSender, NULL, lengths, ARRAY_SIZE(buffers), &pReceiver->hostIpAddr));
+    EXPECT_EQ(STATUS_INVALID_ARG, socketConnectionSendDataGather(pSender, buffers, lengths, ARRAY_SIZE(buffers), NULL));
+    EXPECT_EQ(STATUS_INVALID_ARG, socketConnectionSendDataGather(pSender, buffers, lengths, 0, &pReceiver->hostIpAddr));
+    EXPECT_EQ(STATUS_INVALID_ARG,
+              socketConnectionSendDataGather(pSender, tooManyBuffers, tooManyLengths, ARRAY_SIZE(tooManyBuffers), &pReceiver->hostIpAddr));
+
+    EXPECT_EQ(STATUS_SUCCESS, socketConnectionSendDataGather(pSender, buffers, lengths, ARRAY_SIZE(buffers), &pReceiver->hostIpAddr));
+
+    // The parts must arrive as one datagram in order
+    pfd.fd = pReceiver->localSocket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    ASSERT_EQ(1, poll(&pfd, 1, 1000));
+    readLen = (INT32) recv(pReceiver->localSocket, receiveBuffer, SIZEOF(receiveBuffer), 0);
+    EXPECT_EQ((INT32) (SIZEOF(header) + SIZEOF(payload) + SIZEOF(padding)), readLen);
+    EXPECT_EQ(0, MEMCMP(receiveBuffer, header, SIZEOF(header)));
+    EXPECT_EQ(0, MEMCMP(receiveBuffer + SIZEOF(header), payload, SIZEOF(payload)));
+    EXPECT_EQ(0, MEMCMP(receiveBuffer + SIZEOF(header) + SIZEOF(payload), padding, SIZEOF(padding)));
+
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pSender));
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pReceiver));
+}
+
 ///////////////////////////////////////////////
 // IceAgent Test
 ///////////////////////////////////////////////
@@ -1132,6 +1542,150 @@ TEST_F(IceFunctionalityTest, announcedIpAddressInvalidRejected)
     EXPECT_EQ(STATUS_SUCCESS, timerQueueFree(&timerQueueHandle));
 }
 
+typedef struct {
+    PIceAgent pIceAgent;
+    PSocketConnection pSocketConnection;
+    PKvsIpAddress pSrc;
+    volatile ATOMIC_BOOL done;
+} DataPathTestCustomData, *PDataPathTestCustomData;
+
+VOID dataPathTestInboundPacket(UINT64 customData, PBYTE pBuffer, UINT32 bufferLen)
+{
+    UNUSED_PARAM(pBuffer);
+    UNUSED_PARAM(bufferLen);
+    ATOMIC_INCREMENT((volatile SIZE_T*) customData);
+}
+
+PVOID dataPathTestMediaRoutine(PVOID arg)
+{
+    PDataPathTestCustomData pCustomData = (PDataPathTestCustomData) arg;
+    BYTE media[100];
+
+    MEMSET(media, 0x80, SIZEOF(media));
+    CHECK(STATUS_SUCCEEDED(iceAgentSendPacket(pCustomData->pIceAgent, media, SIZEOF(media))));
+    CHECK(STATUS_SUCCEEDED(incomingDataHandler((UINT64) pCustomData->pIceAgent, pCustomData->pSocketConnection, media, 60, pCustomData->pSrc, NULL)));
+    ATOMIC_STORE_BOOL(&pCustomData->done, TRUE);
+
+    return 0;
+}
+
+TEST_F(IceFunctionalityTest, iceAgentDataPathSkipsAgentLock)
+{
+    PIceAgent pIceAgent = NULL;
+    CHAR localIceUfrag[LOCAL_ICE_UFRAG_LEN + 1];
+    CHAR localIcePwd[LOCAL_ICE_PWD_LEN + 1];
+    RtcConfiguration configuration;
+    IceAgentCallbacks iceAgentCallbacks;
+    PConnectionListener pConnectionListener = NULL;
+    TIMER_QUEUE_HANDLE timerQueueHandle = INVALID_TIMER_QUEUE_HANDLE_VALUE;
+    PSocketConnection pLocalSocket = NULL, pPeerSocket = NULL;
+    IceCandidate localCandidate, remoteCandidate;
+    IceCandidatePair iceCandidatePair;
+    RtcIceCandidatePairDiagnostics diagnostics;
+    DataPathTestCustomData customData;
+    KvsIpAddress localhost;
+    volatile SIZE_T inboundCount = 0;
+    BYTE media[100], receiveBuffer[200];
+    TID routine;
+    UINT64 deadline;
+    struct pollfd pfd;
+
+    initRtcConfiguration(&configuration);
+
+    MEMSET(localIceUfrag, 0x00, SIZEOF(localIceUfrag));
+    MEMSET(localIcePwd, 0x00, SIZEOF(localIcePwd));
+    MEMSET(&iceAgentCallbacks, 0x00, SIZEOF(IceAgentCallbacks));
+    MEMSET(&localCandidate, 0x00, SIZEOF(IceCandidate));
+    MEMSET(&remoteCandidate, 0x00, SIZEOF(IceCandidate));
+    MEMSET(&iceCandidatePair, 0x00, SIZEOF(IceCandidatePair));
+    MEMSET(&diagnostics, 0x00, SIZEOF(RtcIceCandidatePairDiagnostics));
+    MEMSET(&localhost, 0x00, SIZEOF(KvsIpAddress));
+    MEMSET(media, 0x80, SIZEOF(media));
+
+    localhost.family = KVS_IP_FAMILY_TYPE_IPV4;
+    // 127.0.0.1
+    localhost.address[0] = 0x7f;
+    localhost.address[3] = 0x01;
+
+    iceAgentCallbacks.inboundPacketFn = dataPathTestInboundPacket;
+    iceAgentCallbacks.customData = (UINT64) &inboundCount;
+
+    EXPECT_EQ(STATUS_SUCCESS, generateJSONSafeString(localIceUfrag, LOCAL_ICE_UFRAG_LEN));
+    EXPECT_EQ(STATUS_SUCCESS, generateJSONSafeString(localIcePwd, LOCAL_ICE_PWD_LEN));
+    EXPECT_EQ(STATUS_SUCCESS, createConnectionListener(&pConnectionListener));
+    EXPECT_EQ(STATUS_SUCCESS, timerQueueCreate(&timerQueueHandle));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createIceAgent(localIceUfrag, localIcePwd, &iceAgentCallbacks, &configuration, timerQueueHandle, pConnectionListener, &pIceAgent));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pLocalSocket));
+    EXPECT_EQ(STATUS_SUCCESS,
+              createSocketConnection((KVS_IP_FAMILY_TYPE) localhost.family, KVS_SOCKET_PROTOCOL_UDP, &localhost, NULL, 0, NULL, 0, 0, &pPeerSocket));
+
+    // A selected host pair between two loopback sockets
+    localCandidate.iceCandidateType = ICE_CANDIDATE_TYPE_HOST;
+    localCandidate.pSocketConnection = pLocalSocket;
+    localCandidate.ipAddress = pLocalSocket->hostIpAddr;
+    remoteCandidate.iceCandidateType = ICE_CANDIDATE_TYPE_HOST;
+    remoteCandidate.ipAddress = pPeerSocket->hostIpAddr;
+    iceCandidatePair.local = &localCandidate;
+    iceCandidatePair.remote = &remoteCandidate;
+    iceCandidatePair.state = ICE_CANDIDATE_PAIR_STATE_SUCCEEDED;
+    iceCandidatePair.pRtcIceCandidatePairDiagnostics = &diagnostics;
+    pIceAgent->pDataSendingIceCandidatePair = &iceCandidatePair;
+    ATOMIC_STORE(&pIceAgent->dataPathPair, (SIZE_T) &iceCandidatePair);
+
+    customData.pIceAgent = pIceAgent;
+    customData.pSocketConnection = pLocalSocket;
+    customData.pSrc = &pPeerSocket->hostIpAddr;
+    ATOMIC_STORE_BOOL(&customData.done, FALSE);
+
+    // Media in both directions must get through while a timer holds the agent lock
+    MUTEX_LOCK(pIceAgent->lock);
+    EXPECT_EQ(STATUS_SUCCESS, THREAD_CREATE(&routine, dataPathTestMediaRoutine, (PVOID) &customData));
+    deadline = GETTIME() + 5 * HUNDREDS_OF_NANOS_IN_A_SECOND;
+    while (!ATOMIC_LOAD_BOOL(&customData.done) && GETTIME() < deadline) {
+        THREAD_SLEEP(HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    }
+    EXPECT_TRUE(ATOMIC_LOAD_BOOL(&customData.done));
+    MUTEX_UNLOCK(pIceAgent->lock);
+    THREAD_JOIN(routine, NULL);
+
+    EXPECT_EQ(1, ATOMIC_LOAD(&inboundCount));
+    pfd.fd = pPeerSocket->localSocket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    ASSERT_EQ(1, poll(&pfd, 1, 1000));
+    EXPECT_EQ((INT32) SIZEOF(media), (INT32) recv(pPeerSocket->localSocket, receiveBuffer, SIZEOF(receiveBuffer), 0));
+
+    // Counters only reach the diagnostics and the liveness timestamp when folded in under the lock
+    EXPECT_EQ(0, diagnostics.packetsSent);
+    EXPECT_FALSE(IS_VALID_TIMESTAMP(pIceAgent->lastDataReceivedTime));
+    MUTEX_LOCK(pIceAgent->lock);
+    iceAgentCollectDataPathStats(pIceAgent);
+    MUTEX_UNLOCK(pIceAgent->lock);
+    EXPECT_EQ(1, diagnostics.packetsSent);
+    EXPECT_EQ(SIZEOF(media), diagnostics.bytesSent);
+    EXPECT_EQ(1, diagnostics.packetsReceived);
+    EXPECT_EQ(60, diagnostics.bytesReceived);
+    EXPECT_TRUE(IS_VALID_TIMESTAMP(pIceAgent->lastDataReceivedTime));
+    EXPECT_NE(0, diagnostics.lastPacketSentTimestamp);
+
+    // Once retracted, sends fall back to the locked path and are accounted for immediately
+    iceAgentRetractDataPath(pIceAgent);
+    EXPECT_EQ(0, ATOMIC_LOAD(&pIceAgent->dataPathPair));
+    EXPECT_EQ(STATUS_SUCCESS, iceAgentSendPacket(pIceAgent, media, SIZEOF(media)));
+    EXPECT_EQ(2, diagnostics.packetsSent);
+    EXPECT_EQ(0, ATOMIC_LOAD(&iceCandidatePair.dataPathPacketsSent));
+
+    pIceAgent->pDataSendingIceCandidatePair = NULL;
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pLocalSocket));
+    EXPECT_EQ(STATUS_SUCCESS, freeSocketConnection(&pPeerSocket));
+    EXPECT_EQ(STATUS_SUCCESS, iceAgentShutdown(pIceAgent));
+    EXPECT_EQ(STATUS_SUCCESS, timerQueueShutdown(timerQueueHandle));
+    EXPECT_EQ(STATUS_SUCCESS, freeIceAgent(&pIceAgent));
+    EXPECT_EQ(STATUS_SUCCESS, timerQueueFree(&timerQueueHandle));
+}
+
 TEST_F(IceFunctionalityTest, DISABLED_IceAgentCandidateGatheringTest)
 {
     ASSERT_EQ(TRUE, mAccessKeyIdSet);
@@ -1329,6 +1329,50 @@ TEST_P(JitterBufferFunctionalityTest, markerBitOutOfOrderWaitsForCompletion)
     clearJitterBufferForTest();
 }
 
+TEST_P(JitterBufferFunctionalityTest, largeFrameCompletesWhenLatePacketArrives)
+{
+    if (GetParam()) {
+        // RealTimeJitterBuffer caps the span it scans for a single frame well below this frame size
+        GTEST_SKIP();
+    }
+
+    UINT32 i;
+    // Spans more sequence numbers than the packet ring starts with
+    UINT32 framePktCount = 1500;
+    UINT32 pktCount = framePktCount + 1;
+    UINT32 latePktIndex = 5;
+
+    initializeJitterBuffer(2, 0, pktCount);
+
+    for (i = 0; i < framePktCount; i++) {
+        setPacket(i, {(BYTE) i}, 100, i, i == 0);
+    }
+    setPacket(framePktCount, {0xFF}, 200, framePktCount, TRUE, TRUE);
+
+    mPExpectedFrameArr[0] = (PBYTE) MEMALLOC(framePktCount);
+    for (i = 0; i < framePktCount; i++) {
+        mPExpectedFrameArr[0][i] = (BYTE) i;
+    }
+    mExpectedFrameSizeArr[0] = framePktCount;
+    setExpectedFrame(1, {0xFF});
+
+    setPayloadToFree();
+
+    for (i = 0; i < pktCount; i++) {
+        if (i != latePktIndex) {
+            EXPECT_EQ(STATUS_SUCCESS, jitterBufferPush(mJitterBuffer, mPRtpPackets[i], nullptr));
+        }
+    }
+    EXPECT_EQ(0, mReadyFrameIndex);
+
+    // Filling the hole completes the first frame, and the second one follows right away on its marker
+    EXPECT_EQ(STATUS_SUCCESS, jitterBufferPush(mJitterBuffer, mPRtpPackets[latePktIndex], nullptr));
+    EXPECT_EQ(2, mReadyFrameIndex);
+    EXPECT_EQ(0, mDroppedFrameIndex);
+
+    clearJitterBufferForTest();
+}
+
 INSTANTIATE_TEST_SUITE_P(DefaultJitterBuffer, JitterBufferFunctionalityTest, ::testing::Values(false));
 INSTANTIATE_TEST_SUITE_P(RealTimeJitterBuffer, JitterBufferFunctionalityTest, ::testing::Values(true));
 
@@ -169,7 +169,7 @@ TEST_F(PacerFunctionalityTest, enqueuePacket)
     PBYTE pData = createTestPacket(1200);
     EXPECT_NE(nullptr, pData);
 
-    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, pData, 1200, 1));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, 1));
     EXPECT_EQ(1U, pacerGetQueueSize(pPacer));
 
     // pData is now owned by pacer, don't free it
@@ -182,7 +182,7 @@ TEST_F(PacerFunctionalityTest, enqueueMultiplePackets)
     for (UINT16 i = 0; i < 10; i++) {
         PBYTE pData = createTestPacket(1200);
         EXPECT_NE(nullptr, pData);
-        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, pData, 1200, i + 1));
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, i + 1));
     }
 
     EXPECT_EQ(10U, pacerGetQueueSize(pPacer));
@@ -194,9 +194,9 @@ TEST_F(PacerFunctionalityTest, enqueuePacketNullArgs)
 
     PBYTE pData = createTestPacket(1200);
 
-    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueuePacket(nullptr, pData, 1200, 1));
-    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueuePacket(pPacer, nullptr, 1200, 1));
-    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueuePacket(pPacer, pData, 0, 1));
+    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueuePacket(nullptr, PACER_PRIORITY_VIDEO, pData, 1200, 1));
+    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, nullptr, 1200, 1));
+    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 0, 1));
 
     MEMFREE(pData);
 }
@@ -214,14 +214,14 @@ TEST_F(PacerFunctionalityTest, enqueueQueueOverflow)
     // Fill up the queue
     for (UINT16 i = 0; i < 5; i++) {
         PBYTE pData = createTestPacket(1200);
-        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, pData, 1200, i + 1));
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, i + 1));
     }
 
     EXPECT_EQ(5U, pacerGetQueueSize(pPacer));
 
     // Try to add one more - should fail
     PBYTE pData = createTestPacket(1200);
-    EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, pacerEnqueuePacket(pPacer, pData, 1200, 6));
+    EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, 6));
     // pData was freed by pacerEnqueuePacket on failure
 }
 
@@ -253,7 +253,7 @@ TEST_F(PacerFunctionalityTest, getStatsAfterEnqueue)
 
     for (UINT16 i = 0; i < 5; i++) {
         PBYTE pData = createTestPacket(1200);
-        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, pData, 1200, i + 1));
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, i + 1));
     }
 
     PacerStats stats;
@@ -357,6 +357,38 @@ TEST_F(PacerFunctionalityTest, drainQueueWithoutPeerConnection)
     EXPECT_EQ(STATUS_INVALID_OPERATION, pacerDrainQueue(pPacer));
 }
 
+TEST_F(PacerFunctionalityTest, drainQueueCountsUnsentPacketsAsDiscarded)
+{
+    RtcConfiguration configuration;
+    PRtcPeerConnection pRtcPeerConnection = NULL;
+    PacerStats stats;
+
+    MEMSET(&configuration, 0x00, SIZEOF(RtcConfiguration));
+    EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&configuration, &pRtcPeerConnection));
+    EXPECT_EQ(STATUS_SUCCESS, createPacer(&pPacer, timerQueueHandle, nullptr));
+    pPacer->pKvsPeerConnection = pRtcPeerConnection;
+    // One interval worth of budget is plenty for the packets below
+    EXPECT_EQ(STATUS_SUCCESS, pacerSetTargetBitrate(pPacer, 100000000));
+    pPacer->lastSendTimeKvs = GETTIME() - PACER_INTERVAL_KVS;
+
+    for (UINT16 i = 0; i < 3; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, createTestPacket(1000), 1000, i + 1));
+    }
+
+    // Without a selected candidate pair nothing goes out, the packets are neither counted as sent nor charged to the budget
+    EXPECT_EQ(STATUS_SUCCESS, pacerDrainQueue(pPacer));
+    EXPECT_EQ(STATUS_SUCCESS, pacerGetStats(pPacer, &stats));
+    EXPECT_EQ(0ULL, stats.packetsSent);
+    EXPECT_EQ(0ULL, stats.bytesSent);
+    EXPECT_EQ(3ULL, stats.packetsDiscardedOnSend);
+    EXPECT_EQ(3000ULL, stats.bytesDiscardedOnSend);
+    EXPECT_EQ(0ULL, stats.currentQueueSize);
+    EXPECT_GE(pPacer->budgetBytes, pacerCalculateBudget(pPacer, PACER_INTERVAL_KVS));
+
+    EXPECT_EQ(STATUS_SUCCESS, freePacer(&pPacer));
+    EXPECT_EQ(STATUS_SUCCESS, freePeerConnection(&pRtcPeerConnection));
+}
+
 //
 // Integration Tests
 //
@@ -374,7 +406,7 @@ TEST_F(PacerFunctionalityTest, fullLifecycle)
     // Enqueue some packets
     for (UINT16 i = 0; i < 20; i++) {
         PBYTE pData = createTestPacket(1200);
-        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, pData, 1200, i + 1));
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, i + 1));
     }
 
     EXPECT_EQ(20U, pacerGetQueueSize(pPacer));
@@ -409,7 +441,7 @@ TEST_F(PacerFunctionalityTest, queueClearedOnFree)
     // Enqueue packets
     for (UINT16 i = 0; i < 50; i++) {
         PBYTE pData = createTestPacket(1200);
-        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, pData, 1200, i + 1));
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, i + 1));
     }
 
     EXPECT_EQ(50U, pacerGetQueueSize(pPacer));
@@ -419,6 +451,40 @@ TEST_F(PacerFunctionalityTest, queueClearedOnFree)
     EXPECT_EQ(nullptr, pPacer);
 }
 
+TEST_F(PacerFunctionalityTest, pooledPacketsReturnedOnFree)
+{
+    PPacketPool pPacketPool = nullptr;
+    PacketPoolStats stats;
+    PacerPacketInfo frame[4];
+    PBYTE pData;
+
+    EXPECT_EQ(STATUS_SUCCESS, createPacketPool(1200, 8, &pPacketPool));
+    EXPECT_EQ(STATUS_SUCCESS, createPacer(&pPacer, timerQueueHandle, nullptr));
+    EXPECT_EQ(STATUS_SUCCESS, pacerSetPacketPool(pPacer, pPacketPool));
+    EXPECT_EQ(STATUS_NULL_ARG, pacerSetPacketPool(nullptr, pPacketPool));
+
+    pData = packetPoolAlloc(pPacketPool, 1200);
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, 1));
+
+    for (UINT16 i = 0; i < 4; i++) {
+        frame[i].pData = packetPoolAlloc(pPacketPool, 1200);
+        frame[i].size = 1200;
+        frame[i].twccSeqNum = i + 2;
+    }
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueueFrame(pPacer, PACER_PRIORITY_VIDEO, frame, 4));
+
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pPacketPool, &stats));
+    EXPECT_EQ(5U, stats.blocksInUse);
+
+    // Queued packet data goes back to the pool, not the heap
+    EXPECT_EQ(STATUS_SUCCESS, freePacer(&pPacer));
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pPacketPool, &stats));
+    EXPECT_EQ(0U, stats.blocksInUse);
+    EXPECT_EQ(5U, stats.hits);
+
+    EXPECT_EQ(STATUS_SUCCESS, freePacketPool(&pPacketPool));
+}
+
 TEST_F(PacerFunctionalityTest, multipleBitrateChanges)
 {
     EXPECT_EQ(STATUS_SUCCESS, createPacer(&pPacer, timerQueueHandle, nullptr));
@@ -446,7 +512,7 @@ TEST_F(PacerFunctionalityTest, highThroughputEnqueue)
     UINT32 packetsEnqueued = 0;
     for (UINT32 i = 0; i < 200; i++) {
         PBYTE pData = createTestPacket(1200);
-        if (STATUS_SUCCEEDED(pacerEnqueuePacket(pPacer, pData, 1200, (UINT16)(i + 1)))) {
+        if (STATUS_SUCCEEDED(pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, pData, 1200, (UINT16)(i + 1)))) {
             packetsEnqueued++;
         }
     }
@@ -524,7 +590,7 @@ TEST_F(PacerFunctionalityTest, enqueueFrame)
         packets[i].twccSeqNum = (UINT16)(i + 1);
     }
 
-    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueueFrame(pPacer, packets, 10));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueueFrame(pPacer, PACER_PRIORITY_VIDEO, packets, 10));
     EXPECT_EQ(10U, pacerGetQueueSize(pPacer));
 
     PacerStats stats;
@@ -544,9 +610,9 @@ TEST_F(PacerFunctionalityTest, enqueueFrameNullArgs)
         packets[i].twccSeqNum = (UINT16)(i + 1);
     }
 
-    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueueFrame(nullptr, packets, 5));
-    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueueFrame(pPacer, nullptr, 5));
-    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueueFrame(pPacer, packets, 0));
+    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueueFrame(nullptr, PACER_PRIORITY_VIDEO, packets, 5));
+    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueueFrame(pPacer, PACER_PRIORITY_VIDEO, nullptr, 5));
+    EXPECT_EQ(STATUS_NULL_ARG, pacerEnqueueFrame(pPacer, PACER_PRIORITY_VIDEO, packets, 0));
 
     // Clean up - we own the data
     for (UINT32 i = 0; i < 5; i++) {
@@ -574,7 +640,7 @@ TEST_F(PacerFunctionalityTest, enqueueFrameQueueOverflow)
     }
 
     // Should fail and free all packet data
-    EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, pacerEnqueueFrame(pPacer, packets, 10));
+    EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, pacerEnqueueFrame(pPacer, PACER_PRIORITY_VIDEO, packets, 10));
     EXPECT_EQ(0U, pacerGetQueueSize(pPacer));
 
     // Verify stats show dropped packets
@@ -596,7 +662,7 @@ TEST_F(PacerFunctionalityTest, enqueueFrameSameTimestamp)
         packets[i].twccSeqNum = (UINT16)(i + 1);
     }
 
-    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueueFrame(pPacer, packets, 5));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueueFrame(pPacer, PACER_PRIORITY_VIDEO, packets, 5));
     EXPECT_EQ(5U, pacerGetQueueSize(pPacer));
 
     // All packets should have the same enqueue time (verified by drain behavior)
@@ -615,12 +681,134 @@ TEST_F(PacerFunctionalityTest, enqueueMultipleFrames)
             packets[i].size = 1200;
             packets[i].twccSeqNum = (UINT16)(frame * 10 + i + 1);
         }
-        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueueFrame(pPacer, packets, 10));
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueueFrame(pPacer, PACER_PRIORITY_VIDEO, packets, 10));
     }
 
     EXPECT_EQ(30U, pacerGetQueueSize(pPacer));
 }
 
+//
+// Priority Tests
+//
+
+TEST_F(PacerFunctionalityTest, dequeueInPriorityOrder)
+{
+    PacerPacket packet;
+    BYTE invalid[100];
+    UINT16 expected[] = {4, 3, 2, 5, 1};
+
+    EXPECT_EQ(STATUS_SUCCESS, createPacer(&pPacer, timerQueueHandle, nullptr));
+
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_PADDING, createTestPacket(100), 100, 1));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, createTestPacket(1200), 1200, 2));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_RETRANSMISSION, createTestPacket(1200), 1200, 3));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_AUDIO, createTestPacket(160), 160, 4));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, createTestPacket(1200), 1200, 5));
+    EXPECT_EQ(STATUS_INVALID_ARG, pacerEnqueuePacket(pPacer, PACER_PRIORITY_COUNT, invalid, SIZEOF(invalid), 6));
+    EXPECT_EQ(5U, pacerGetQueueSize(pPacer));
+
+    for (UINT32 i = 0; i < ARRAY_SIZE(expected); i++) {
+        EXPECT_TRUE(pacerDequeuePacket(pPacer, MAX_UINT32, &packet));
+        EXPECT_EQ(expected[i], packet.twccSeqNum);
+        MEMFREE(packet.pData);
+    }
+    EXPECT_FALSE(pacerDequeuePacket(pPacer, MAX_UINT32, &packet));
+    EXPECT_EQ(0U, pacerGetQueueSize(pPacer));
+}
+
+TEST_F(PacerFunctionalityTest, paddingQueueIsShort)
+{
+    PacerConfig config;
+    PacerStats stats;
+
+    config.initialBitrateBps = 300000;
+    config.maxQueueSize = PACER_PADDING_QUEUE_SIZE + 2;
+    config.maxQueueBytes = 100000;
+    config.maxQueueTimeKvs = 0;
+    config.pacingFactor = 0;
+    config.enabled = TRUE;
+    EXPECT_EQ(STATUS_SUCCESS, createPacer(&pPacer, timerQueueHandle, &config));
+
+    // Padding stops at its own ring size, well before the queue limit
+    for (UINT16 i = 0; i < PACER_PADDING_QUEUE_SIZE; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_PADDING, createTestPacket(100), 100, i + 1));
+    }
+    EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, pacerEnqueuePacket(pPacer, PACER_PRIORITY_PADDING, createTestPacket(100), 100, 100));
+    EXPECT_EQ(PACER_PADDING_QUEUE_SIZE, pacerGetQueueSize(pPacer));
+
+    // Media still gets the whole queue, pushing padding out once the limit is reached
+    for (UINT16 i = 0; i < config.maxQueueSize; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, createTestPacket(1000), 1000, 200 + i));
+    }
+    EXPECT_EQ(config.maxQueueSize, pacerGetQueueSize(pPacer));
+    EXPECT_EQ(0U, pPacer->queues[PACER_PRIORITY_PADDING].count);
+
+    EXPECT_EQ(STATUS_SUCCESS, pacerGetStats(pPacer, &stats));
+    EXPECT_EQ(PACER_PADDING_QUEUE_SIZE + 1, stats.packetsDropped);
+}
+
+TEST_F(PacerFunctionalityTest, lowerPriorityWaitsForBudget)
+{
+    PacerPacket packet;
+
+    EXPECT_EQ(STATUS_SUCCESS, createPacer(&pPacer, timerQueueHandle, nullptr));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_RETRANSMISSION, createTestPacket(1200), 1200, 1));
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, createTestPacket(100), 100, 2));
+
+    // The small video packet does not overtake the retransmission waiting for budget
+    EXPECT_FALSE(pacerDequeuePacket(pPacer, 1000, &packet));
+    EXPECT_EQ(2U, pacerGetQueueSize(pPacer));
+
+    EXPECT_TRUE(pacerDequeuePacket(pPacer, 1200, &packet));
+    EXPECT_EQ(1, packet.twccSeqNum);
+    EXPECT_EQ(PACER_PRIORITY_RETRANSMISSION, packet.priority);
+    MEMFREE(packet.pData);
+}
+
+TEST_F(PacerFunctionalityTest, overflowDropsOldestLowerPriority)
+{
+    PacerConfig config;
+    PacerStats stats;
+    PacerPacket packet;
+    PacerPacketInfo packets[5];
+
+    config.initialBitrateBps = 300000;
+    config.maxQueueSize = 4;
+    config.maxQueueBytes = 100000;
+    config.maxQueueTimeKvs = 0;
+    config.pacingFactor = 0;
+    config.enabled = TRUE;
+    EXPECT_EQ(STATUS_SUCCESS, createPacer(&pPacer, timerQueueHandle, &config));
+
+    for (UINT16 i = 0; i < 4; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, createTestPacket(1200), 1200, i + 1));
+    }
+
+    // A retransmission takes the place of the oldest video packet, more video is dropped
+    EXPECT_EQ(STATUS_SUCCESS, pacerEnqueuePacket(pPacer, PACER_PRIORITY_RETRANSMISSION, createTestPacket(1200), 1200, 5));
+    EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, pacerEnqueuePacket(pPacer, PACER_PRIORITY_VIDEO, createTestPacket(1200), 1200, 6));
+    EXPECT_EQ(4U, pacerGetQueueSize(pPacer));
+
+    // A frame larger than the queue is dropped whole without evicting anything
+    for (UINT16 i = 0; i < 5; i++) {
+        packets[i].pData = createTestPacket(160);
+        packets[i].size = 160;
+        packets[i].twccSeqNum = i + 7;
+    }
+    EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, pacerEnqueueFrame(pPacer, PACER_PRIORITY_AUDIO, packets, 5));
+    EXPECT_EQ(4U, pacerGetQueueSize(pPacer));
+
+    EXPECT_EQ(STATUS_SUCCESS, pacerGetStats(pPacer, &stats));
+    EXPECT_EQ(7ULL, stats.packetsDropped);
+
+    EXPECT_TRUE(pacerDequeuePacket(pPacer, MAX_UINT32, &packet));
+    EXPECT_EQ(5, packet.twccSeqNum);
+    MEMFREE(packet.pData);
+    EXPECT_TRUE(pacerDequeuePacket(pPacer, MAX_UINT32, &packet));
+    EXPECT_EQ(2, packet.twccSeqNum);
+    MEMFREE(packet.pData);
+}
+
 } // namespace webrtcclient
 } // namespace video
 } // namespace kinesis
@@ -0,0 +1,193 @@
+/*******************************************
+PacketPool Unit Tests
+Fixed-size packet buffer slab
+*******************************************/
+
+#include "WebRTCClientTestFixture.h"
+
+namespace com {
+namespace amazonaws {
+namespace kinesis {
+namespace video {
+namespace webrtcclient {
+
+class PacketPoolFunctionalityTest : public WebRtcClientTestBase {
+  public:
+    PPacketPool pPacketPool = nullptr;
+
+    void TearDown() override
+    {
+        freePacketPool(&pPacketPool);
+        WebRtcClientTestBase::TearDown();
+    }
+};
+
+TEST_F(PacketPoolFunctionalityTest, createInvalidArgs)
+{
+    EXPECT_EQ(STATUS_NULL_ARG, createPacketPool(100, 4, nullptr));
+    EXPECT_EQ(STATUS_INVALID_ARG, createPacketPool(0, 4, &pPacketPool));
+    EXPECT_EQ(STATUS_INVALID_ARG, createPacketPool(100, 0, &pPacketPool));
+    EXPECT_EQ(STATUS_INVALID_ARG, createPacketPool(100, PACKET_POOL_MAX_BLOCK_COUNT + 1, &pPacketPool));
+    EXPECT_EQ(nullptr, pPacketPool);
+    EXPECT_EQ(STATUS_SUCCESS, freePacketPool(&pPacketPool));
+}
+
+TEST_F(PacketPoolFunctionalityTest, allocFromSlabUntilExhausted)
+{
+    PBYTE blocks[4];
+    PBYTE pOverflow;
+    PacketPoolStats stats;
+    UINT32 i;
+
+    EXPECT_EQ(STATUS_SUCCESS, createPacketPool(100, 4, &pPacketPool));
+
+    for (i = 0; i < 4; i++) {
+        blocks[i] = packetPoolAlloc(pPacketPool, 100);
+        ASSERT_NE(nullptr, blocks[i]);
+        EXPECT_TRUE(packetPoolOwns(pPacketPool, blocks[i]));
+        EXPECT_EQ(0, (SIZE_T) blocks[i] % PACKET_POOL_BLOCK_ALIGNMENT);
+        MEMSET(blocks[i], (BYTE) i, 100);
+    }
+
+    // Slab is exhausted, the heap takes over
+    pOverflow = packetPoolAlloc(pPacketPool, 100);
+    ASSERT_NE(nullptr, pOverflow);
+    EXPECT_FALSE(packetPoolOwns(pPacketPool, pOverflow));
+
+    // Blocks must not overlap
+    for (i = 0; i < 4; i++) {
+        EXPECT_EQ((BYTE) i, blocks[i][0]);
+        EXPECT_EQ((BYTE) i, blocks[i][99]);
+    }
+
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pPacketPool, &stats));
+    EXPECT_EQ(4, stats.hits);
+    EXPECT_EQ(1, stats.misses);
+    EXPECT_EQ(4, stats.blocksInUse);
+
+    packetPoolFree(pPacketPool, pOverflow);
+    packetPoolFree(pPacketPool, blocks[2]);
+
+    // The released block is handed out again
+    EXPECT_EQ(blocks[2], packetPoolAlloc(pPacketPool, 50));
+
+    for (i = 0; i < 4; i++) {
+        packetPoolFree(pPacketPool, blocks[i]);
+    }
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pPacketPool, &stats));
+    EXPECT_EQ(5, stats.hits);
+    EXPECT_EQ(0, stats.blocksInUse);
+}
+
+TEST_F(PacketPoolFunctionalityTest, oversizedAndNullPoolFallBackToHeap)
+{
+    PBYTE pBuffer;
+    PacketPoolStats stats;
+
+    EXPECT_EQ(STATUS_SUCCESS, createPacketPool(100, 4, &pPacketPool));
+
+    pBuffer = packetPoolAlloc(pPacketPool, 101);
+    ASSERT_NE(nullptr, pBuffer);
+    EXPECT_FALSE(packetPoolOwns(pPacketPool, pBuffer));
+    packetPoolFree(pPacketPool, pBuffer);
+
+    pBuffer = packetPoolAlloc(nullptr, 10);
+    ASSERT_NE(nullptr, pBuffer);
+    packetPoolFree(nullptr, pBuffer);
+    packetPoolFree(pPacketPool, nullptr);
+
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pPacketPool, &stats));
+    EXPECT_EQ(0, stats.hits);
+    EXPECT_EQ(1, stats.misses);
+    EXPECT_EQ(STATUS_NULL_ARG, packetPoolGetStats(nullptr, &stats));
+}
+
+TEST_F(PacketPoolFunctionalityTest, rtpPacketFromPoolRoundTrip)
+{
+    BYTE rawPacket[] = {0x80, 0x60, 0x00, 0x2a, 0x00, 0x00, 0x03, 0xe8, 0x12, 0x34, 0x56, 0x78, 0xde, 0xad, 0xbe, 0xef};
+    PRtpPacket pRtpPacket = nullptr;
+    PacketPoolStats stats;
+
+    EXPECT_EQ(STATUS_SUCCESS, createPacketPool(RTP_PACKET_POOL_HEADER_SIZE + 64, 2, &pPacketPool));
+
+    EXPECT_EQ(STATUS_SUCCESS, createRtpPacketFromPool(pPacketPool, rawPacket, SIZEOF(rawPacket), &pRtpPacket));
+    ASSERT_NE(nullptr, pRtpPacket);
+    EXPECT_TRUE(packetPoolOwns(pPacketPool, (PBYTE) pRtpPacket));
+    EXPECT_NE(rawPacket, pRtpPacket->pRawPacket);
+    EXPECT_EQ(42, pRtpPacket->header.sequenceNumber);
+    EXPECT_EQ(1000, pRtpPacket->header.timestamp);
+    EXPECT_EQ(0x12345678, pRtpPacket->header.ssrc);
+    EXPECT_EQ(4, pRtpPacket->payloadLength);
+    EXPECT_EQ(0, MEMCMP(rawPacket + 12, pRtpPacket->payload, 4));
+
+    EXPECT_EQ(STATUS_SUCCESS, freeRtpPacket(&pRtpPacket));
+    EXPECT_EQ(nullptr, pRtpPacket);
+
+    // Without a pool the same layout comes from the heap
+    EXPECT_EQ(STATUS_SUCCESS, createRtpPacketFromPool(nullptr, rawPacket, SIZEOF(rawPacket), &pRtpPacket));
+    ASSERT_NE(nullptr, pRtpPacket);
+    EXPECT_EQ(0x12345678, pRtpPacket->header.ssrc);
+    EXPECT_EQ(STATUS_SUCCESS, freeRtpPacket(&pRtpPacket));
+
+    EXPECT_EQ(STATUS_RTP_INPUT_PACKET_TOO_SMALL, createRtpPacketFromPool(pPacketPool, rawPacket, MIN_HEADER_LENGTH - 1, &pRtpPacket));
+
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pPacketPool, &stats));
+    EXPECT_EQ(1, stats.hits);
+    EXPECT_EQ(0, stats.blocksInUse);
+}
+
+TEST_F(PacketPoolFunctionalityTest, crossThreadFree)
+{
+    const UINT32 iterations = 20000;
+    PBYTE pBlock;
+    PacketPoolStats stats;
+    UINT32 i;
+    std::thread releaser;
+    std::mutex handoffLock;
+    std::vector<PBYTE> handoff;
+    std::atomic<bool> done(false);
+
+    EXPECT_EQ(STATUS_SUCCESS, createPacketPool(64, 32, &pPacketPool));
+
+    releaser = std::thread([&]() {
+        std::vector<PBYTE> batch;
+        for (;;) {
+            // done is set after the last hand-off, so a swap that follows observing it drains everything
+            bool finished = done.load();
+            {
+                std::lock_guard<std::mutex> guard(handoffLock);
+                batch.swap(handoff);
+            }
+            for (PBYTE p : batch) {
+                packetPoolFree(pPacketPool, p);
+            }
+            batch.clear();
+            if (finished) {
+                break;
+            }
+        }
+    });
+
+    for (i = 0; i < iterations; i++) {
+        pBlock = packetPoolAlloc(pPacketPool, 64);
+        EXPECT_NE(nullptr, pBlock);
+        if (pBlock == NULL) {
+            break;
+        }
+        MEMSET(pBlock, 0x5A, 64);
+        std::lock_guard<std::mutex> guard(handoffLock);
+        handoff.push_back(pBlock);
+    }
+    done.store(true);
+    releaser.join();
+
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pPacketPool, &stats));
+    EXPECT_EQ(iterations, stats.hits + stats.misses);
+    EXPECT_EQ(0, stats.blocksInUse);
+}
+
+} // namespace webrtcclient
+} // namespace video
+} // namespace kinesis
+} // namespace amazonaws
+} // namespace com
@@ -219,7 +219,7 @@ TEST_F(RtcpFunctionalityTest, onRtcpPacketCompoundNack)
     initTransceiver(44000);
     ASSERT_EQ(STATUS_SUCCESS,
               createRtpRollingBuffer(DEFAULT_ROLLING_BUFFER_DURATION_IN_SECONDS * DEFAULT_EXPECTED_VIDEO_BIT_RATE / 8 / DEFAULT_MTU_SIZE_BYTES,
-                                     &pKvsRtpTransceiver->sender.packetBuffer));
+                                     DEFAULT_MTU_SIZE_BYTES, &pKvsRtpTransceiver->sender.packetBuffer));
     ASSERT_EQ(STATUS_SUCCESS,
               createRetransmitter(DEFAULT_SEQ_NUM_BUFFER_SIZE, DEFAULT_VALID_INDEX_BUFFER_SIZE, &pKvsRtpTransceiver->sender.retransmitter));
     ASSERT_EQ(STATUS_SUCCESS, createRtpPacketWithSeqNum(0, &pRtpPacket));
@@ -384,7 +384,6 @@ static void parseTwcc(const std::string& hex, const uint32_t expectedReceived, c
     RtcpPacket rtcpPacket{};
     RtpPacket rtpPacket{};
     RtcConfiguration config{};
-    UINT64 value;
     UINT16 twsn;
     UINT16 i = 0;
     UINT32 extpayload, received = 0, lost = 0;
@@ -413,8 +412,8 @@ static void parseTwcc(const std::string& hex, const uint32_t expectedReceived, c
     EXPECT_EQ(STATUS_SUCCESS, parseRtcpTwccPacket(&rtcpPacket, pKvsPeerConnection->pTwccManager));
 
     for (i = 0; i < MAX_UINT16; i++) {
-        if (STATUS_SUCCEEDED(hashTableGet(pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable, i, &value))) {
-            PTwccRtpPacketInfo tempTwccRtpPktInfo = (PTwccRtpPacketInfo) value;
+        PTwccRtpPacketInfo tempTwccRtpPktInfo = twccManagerGetPacketInfo(pKvsPeerConnection->pTwccManager, i);
+        if (tempTwccRtpPktInfo != NULL) {
             if (tempTwccRtpPktInfo->remoteTimeKvs == TWCC_PACKET_LOST_TIME) {
                 lost++;
             } else if (tempTwccRtpPktInfo->remoteTimeKvs != TWCC_PACKET_UNITIALIZED_TIME) {
@@ -471,7 +470,61 @@ TEST_F(RtcpFunctionalityTest, twccParsePacketTest)
     parseTwcc("4487A9E754B3E6FD040200E4147C9F81202700B7E6649000000000000000000004000000000008000018000000001", 45, 183);
 }
 
-TEST_F(RtcpFunctionalityTest, updateTwccHashTableTest)
+static VOID testGccBandwidthHandler(UINT64 customData, DOUBLE bitrate)
+{
+    *((PDOUBLE) customData) = bitrate;
+}
+
+TEST_F(RtcpFunctionalityTest, twccFeedbackDrivesGccTargetBitrate)
+{
+    RtcConfiguration config{};
+    RtcpPacket rtcpPacket{};
+    RtpPacket rtpPacket{};
+    BYTE payload[256] = {0};
+    UINT32 payloadLen = SIZEOF(payload), extpayload;
+    DOUBLE reportedBitrate = 0;
+    UINT64 targetBitrate;
+    // Four packets from sequence number 4724, two of them lost
+    std::string hex = "4487A9E754B3E6FD12740004148566AAC1402C00";
+
+    hexDecode(const_cast<PCHAR>(hex.data()), hex.size(), payload, &payloadLen);
+    rtcpPacket.header.packetLength = payloadLen / 4;
+    rtcpPacket.payload = payload;
+    rtcpPacket.payloadLength = payloadLen;
+
+    initRtcConfiguration(&config);
+    config.kvsRtcConfiguration.enableGccBandwidthEstimation = TRUE;
+    EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&config, &pRtcPeerConnection));
+    pKvsPeerConnection = reinterpret_cast<PKvsPeerConnection>(pRtcPeerConnection);
+    EXPECT_NE(nullptr, pKvsPeerConnection->pGccController);
+    pRtcRtpTransceiver = addTransceiver(42);
+    EXPECT_EQ(STATUS_SUCCESS, transceiverOnBandwidthEstimation(pRtcRtpTransceiver, (UINT64) &reportedBitrate, testGccBandwidthHandler));
+    EXPECT_EQ(STATUS_SUCCESS, peerConnectionEnablePacing(pRtcPeerConnection, nullptr));
+
+    // No application TWCC callback is registered, the estimator alone makes sent packets tracked
+    for (UINT16 seqNum = 4724; seqNum < 4728; seqNum++) {
+        rtpPacket.header.extension = TRUE;
+        rtpPacket.header.extensionProfile = TWCC_EXT_PROFILE;
+        rtpPacket.header.extensionLength = SIZEOF(UINT32);
+        extpayload = TWCC_PAYLOAD(parseExtId(TWCC_EXT_URL), seqNum);
+        rtpPacket.header.extensionPayload = (PBYTE) &extpayload;
+        rtpPacket.payloadLength = 1000;
+        rtpPacket.sentTime = GETTIME();
+        EXPECT_EQ(STATUS_SUCCESS, twccManagerOnPacketSent(pKvsPeerConnection, &rtpPacket));
+    }
+
+    EXPECT_EQ(STATUS_SUCCESS, onRtcpTwccPacket(&rtcpPacket, pKvsPeerConnection));
+
+    // Half the packets were lost, so the loss controller backs off from the initial 300 kbps
+    targetBitrate = gccGetTargetBitrate(pKvsPeerConnection->pGccController);
+    EXPECT_LT(targetBitrate, 300000ULL);
+    EXPECT_EQ((DOUBLE) targetBitrate, reportedBitrate);
+    EXPECT_EQ(targetBitrate, peerConnectionGetPacerBitrate(pRtcPeerConnection));
+
+    EXPECT_EQ(STATUS_SUCCESS, freePeerConnection(&pRtcPeerConnection));
+}
+
+TEST_F(RtcpFunctionalityTest, updateTwccPacketInfosTest)
 {
     PRtcPeerConnection pRtcPeerConnection = NULL;
     PKvsPeerConnection pKvsPeerConnection = NULL;
@@ -479,9 +532,9 @@ TEST_F(RtcpFunctionalityTest, updateTwccHashTableTest)
     initRtcConfiguration(&config);
     UINT64 receivedBytes = 0, receivedPackets = 0, sentBytes = 0, sentPackets = 0;
     INT64 duration = 0;
+    PTwccManager pTwccManager = NULL;
     PTwccRtpPacketInfo pTwccRtpPacketInfo = NULL;
-    PHashTable pTwccRtpPktInfosHashTable = NULL;
-    UINT16 hashTableInsertionCount = 0;
+    UINT16 insertionCount = 0;
     UINT16 lowerBound = UINT16_MAX - 3;
     UINT16 upperBound = 3;
     UINT16 i = 0;
@@ -491,45 +544,45 @@ TEST_F(RtcpFunctionalityTest, updateTwccHashTableTest)
     pKvsPeerConnection = reinterpret_cast<PKvsPeerConnection>(pRtcPeerConnection);
     EXPECT_EQ(STATUS_SUCCESS, peerConnectionOnSenderBandwidthEstimation(pRtcPeerConnection, 0, testBwHandler));
 
-    // Grab the hash table.
-    pTwccRtpPktInfosHashTable = pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable;
-
-    pKvsPeerConnection->pTwccManager->prevReportedBaseSeqNum = lowerBound;
-    pKvsPeerConnection->pTwccManager->lastReportedSeqNum = upperBound + 10;
+    pTwccManager = pKvsPeerConnection->pTwccManager;
+    pTwccManager->prevReportedBaseSeqNum = lowerBound;
+    pTwccManager->lastReportedSeqNum = upperBound + 10;
 
     // Breakup the packet indexes to be across the max int overflow.
     for (i = lowerBound; i <= UINT16_MAX && i != 0; i++) {
-        pTwccRtpPacketInfo = (PTwccRtpPacketInfo) MEMCALLOC(1, SIZEOF(TwccRtpPacketInfo));
-        EXPECT_EQ(STATUS_SUCCESS, hashTableUpsert(pTwccRtpPktInfosHashTable, i, (UINT64) pTwccRtpPacketInfo));
-        hashTableInsertionCount++;
+        EXPECT_NE(nullptr, twccManagerAddPacketInfo(pTwccManager, i));
+        insertionCount++;
     }
     for (i = 0; i < upperBound; i++) {
-        pTwccRtpPacketInfo = (PTwccRtpPacketInfo) MEMCALLOC(1, SIZEOF(TwccRtpPacketInfo));
-        EXPECT_EQ(STATUS_SUCCESS, hashTableUpsert(pTwccRtpPktInfosHashTable, i, (UINT64) pTwccRtpPacketInfo));
-        hashTableInsertionCount++;
+        EXPECT_NE(nullptr, twccManagerAddPacketInfo(pTwccManager, i));
+        insertionCount++;
     }
 
     // Add at a non-monotonically-increased index.
-    pTwccRtpPacketInfo = (PTwccRtpPacketInfo) MEMCALLOC(1, SIZEOF(TwccRtpPacketInfo));
-    EXPECT_EQ(STATUS_SUCCESS, hashTableUpsert(pTwccRtpPktInfosHashTable, upperBound + 10, (UINT64) pTwccRtpPacketInfo));
-    hashTableInsertionCount++;
-
-    // Validate hash table size after and before updating (onRtcpTwccPacket case).
-    EXPECT_EQ(hashTableInsertionCount, pTwccRtpPktInfosHashTable->itemCount);
-    EXPECT_EQ(STATUS_SUCCESS,
-              updateTwccHashTable(pKvsPeerConnection->pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets));
-    EXPECT_EQ(0, pTwccRtpPktInfosHashTable->itemCount);
-
-    hashTableInsertionCount = 0;
-    pTwccRtpPacketInfo = NULL;
+    EXPECT_NE(nullptr, twccManagerAddPacketInfo(pTwccManager, upperBound + 10));
+    insertionCount++;
+
+    // Validate ring occupancy after and before updating (onRtcpTwccPacket case).
+    EXPECT_EQ(insertionCount, pTwccManager->packetInfoCount);
+    EXPECT_EQ(STATUS_SUCCESS, updateTwccPacketInfos(pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets));
+    EXPECT_EQ(0, pTwccManager->packetInfoCount);
+    EXPECT_EQ(insertionCount, sentPackets);
+    EXPECT_EQ(insertionCount, receivedPackets);
+
+    // Lost packets stay around for the rolling window to clean up
+    insertionCount = 0;
     for (i = 0; i <= upperBound; i++) {
-        EXPECT_EQ(STATUS_SUCCESS, hashTableUpsert(pTwccRtpPktInfosHashTable, i, (UINT64) pTwccRtpPacketInfo));
-        hashTableInsertionCount++;
+        pTwccRtpPacketInfo = twccManagerAddPacketInfo(pTwccManager, i);
+        ASSERT_NE(nullptr, pTwccRtpPacketInfo);
+        pTwccRtpPacketInfo->remoteTimeKvs = (i % 2 == 0) ? TWCC_PACKET_LOST_TIME : 1;
+        insertionCount++;
     }
-    EXPECT_EQ(hashTableInsertionCount, pTwccRtpPktInfosHashTable->itemCount);
-    EXPECT_EQ(STATUS_SUCCESS,
-              updateTwccHashTable(pKvsPeerConnection->pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets));
-    EXPECT_EQ(0, pTwccRtpPktInfosHashTable->itemCount);
+    EXPECT_EQ(insertionCount, pTwccManager->packetInfoCount);
+    EXPECT_EQ(STATUS_SUCCESS, updateTwccPacketInfos(pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets));
+    EXPECT_EQ(2, pTwccManager->packetInfoCount);
+    EXPECT_EQ(2, receivedPackets);
+    EXPECT_NE(nullptr, twccManagerGetPacketInfo(pTwccManager, 0));
+    EXPECT_EQ(nullptr, twccManagerGetPacketInfo(pTwccManager, 1));
 
     MUTEX_LOCK(pKvsPeerConnection->twccLock);
     MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
@@ -537,7 +590,7 @@ TEST_F(RtcpFunctionalityTest, updateTwccHashTableTest)
     EXPECT_EQ(STATUS_SUCCESS, freePeerConnection(&pRtcPeerConnection));
 }
 
-TEST_F(RtcpFunctionalityTest, updateTwccHashTableIntPromotionCase)
+TEST_F(RtcpFunctionalityTest, updateTwccPacketInfosIntPromotionCase)
 {
     PRtcPeerConnection pRtcPeerConnection = NULL;
     PKvsPeerConnection pKvsPeerConnection = NULL;
@@ -545,30 +598,22 @@ TEST_F(RtcpFunctionalityTest, updateTwccHashTableIntPromotionCase)
     initRtcConfiguration(&config);
     EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&config, &pRtcPeerConnection));
     pKvsPeerConnection = reinterpret_cast<PKvsPeerConnection>(pRtcPeerConnection);
-    PTwccRtpPacketInfo pTwccRtpPacketInfo = NULL;
     INT64 duration = 0;
     UINT64 receivedBytes = 0, receivedPackets = 0, sentBytes = 0, sentPackets = 0;
-    UINT16 i;
-
-    // Grab the hash table
-    PHashTable pTwccRtpPktInfosHashTable = pKvsPeerConnection->pTwccManager->pTwccRtpPktInfosHashTable;
-    UINT16 hashTableInsertionCount = 0;
+    PTwccManager pTwccManager = pKvsPeerConnection->pTwccManager;
 
-    // Set up the hash table
-    pKvsPeerConnection->pTwccManager->prevReportedBaseSeqNum = UINT16_MAX;
-    pKvsPeerConnection->pTwccManager->lastReportedSeqNum = UINT16_MAX;
+    pTwccManager->prevReportedBaseSeqNum = UINT16_MAX;
+    pTwccManager->lastReportedSeqNum = UINT16_MAX;
 
     // Add packet at UINT16_MAX
-    pTwccRtpPacketInfo = (PTwccRtpPacketInfo) MEMCALLOC(1, SIZEOF(TwccRtpPacketInfo));
-    EXPECT_EQ(STATUS_SUCCESS, hashTableUpsert(pTwccRtpPktInfosHashTable, UINT16_MAX, (UINT64) pTwccRtpPacketInfo));
-    hashTableInsertionCount++;
+    EXPECT_NE(nullptr, twccManagerAddPacketInfo(pTwccManager, UINT16_MAX));
+    EXPECT_EQ(1, pTwccManager->packetInfoCount);
 
     // Even though pTwccManager->lastReportedSeqNum is a UINT16, (pTwccManager->lastReportedSeqNum + 1) can get
     // promoted to an int (32) when pTwccManager->lastReportedSeqNum == UINT16_MAX
-    EXPECT_EQ(STATUS_SUCCESS,
-              updateTwccHashTable(pKvsPeerConnection->pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets));
+    EXPECT_EQ(STATUS_SUCCESS, updateTwccPacketInfos(pTwccManager, &duration, &receivedBytes, &receivedPackets, &sentBytes, &sentPackets));
 
-    EXPECT_EQ(0, pTwccRtpPktInfosHashTable->itemCount); // Ensure the table is cleared again
+    EXPECT_EQ(0, pTwccManager->packetInfoCount); // Ensure the ring is cleared again
 
     MUTEX_LOCK(pKvsPeerConnection->twccLock);
     MUTEX_UNLOCK(pKvsPeerConnection->twccLock);
@@ -576,6 +621,56 @@ TEST_F(RtcpFunctionalityTest, updateTwccHashTableIntPromotionCase)
     EXPECT_EQ(STATUS_SUCCESS, freePeerConnection(&pRtcPeerConnection));
 }
 
+TEST_F(RtcpFunctionalityTest, twccPacketRingGenerationTags)
+{
+    PRtcPeerConnection pRtcPeerConnection = NULL;
+    PKvsPeerConnection pKvsPeerConnection = NULL;
+    RtcConfiguration config{};
+    initRtcConfiguration(&config);
+    PTwccManager pTwccManager = NULL;
+    PTwccRtpPacketInfo pTwccRtpPacketInfo = NULL;
+    UINT32 i;
+
+    EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&config, &pRtcPeerConnection));
+    pKvsPeerConnection = reinterpret_cast<PKvsPeerConnection>(pRtcPeerConnection);
+    pTwccManager = pKvsPeerConnection->pTwccManager;
+
+    pTwccRtpPacketInfo = twccManagerAddPacketInfo(pTwccManager, 100);
+    ASSERT_NE(nullptr, pTwccRtpPacketInfo);
+    pTwccRtpPacketInfo->packetSize = 1000;
+    EXPECT_EQ(pTwccRtpPacketInfo, twccManagerGetPacketInfo(pTwccManager, 100));
+    // Same slot, different ring generation
+    EXPECT_EQ(nullptr, twccManagerGetPacketInfo(pTwccManager, 100 + TWCC_PACKET_RING_SIZE));
+
+    // Send a full ring worth of packets past 100 so its slot is taken over
+    for (i = 101; i <= 100 + TWCC_PACKET_RING_SIZE; i++) {
+        EXPECT_NE(nullptr, twccManagerAddPacketInfo(pTwccManager, (UINT16) i));
+    }
+    EXPECT_EQ(TWCC_PACKET_RING_SIZE, pTwccManager->packetInfoCount);
+    EXPECT_EQ(nullptr, twccManagerGetPacketInfo(pTwccManager, 100));
+    pTwccRtpPacketInfo = twccManagerGetPacketInfo(pTwccManager, 100 + TWCC_PACKET_RING_SIZE);
+    ASSERT_NE(nullptr, pTwccRtpPacketInfo);
+    EXPECT_EQ(0, pTwccRtpPacketInfo->packetSize);
+
+    // Keep sending across the 16-bit wraparound, the newest seqNums stay reachable and the oldest are evicted
+    for (; i <= MAX_UINT16 + 200; i++) {
+        EXPECT_NE(nullptr, twccManagerAddPacketInfo(pTwccManager, (UINT16) i));
+    }
+    EXPECT_EQ(TWCC_PACKET_RING_SIZE, pTwccManager->packetInfoCount);
+    EXPECT_NE(nullptr, twccManagerGetPacketInfo(pTwccManager, 199));
+    EXPECT_NE(nullptr, twccManagerGetPacketInfo(pTwccManager, MAX_UINT16));
+    EXPECT_EQ(nullptr, twccManagerGetPacketInfo(pTwccManager, 200));
+    EXPECT_EQ(nullptr, twccManagerGetPacketInfo(pTwccManager, (UINT16) (199 - TWCC_PACKET_RING_SIZE)));
+
+    pTwccRtpPacketInfo = twccManagerGetPacketInfo(pTwccManager, 0);
+    twccManagerRemovePacketInfo(pTwccManager, pTwccRtpPacketInfo);
+    twccManagerRemovePacketInfo(pTwccManager, pTwccRtpPacketInfo);
+    EXPECT_EQ(TWCC_PACKET_RING_SIZE - 1, pTwccManager->packetInfoCount);
+    EXPECT_EQ(nullptr, twccManagerGetPacketInfo(pTwccManager, 0));
+
+    EXPECT_EQ(STATUS_SUCCESS, freePeerConnection(&pRtcPeerConnection));
+}
+
 //
 // TWCC Feedback Generation (Receiver Side) Tests
 //
@@ -587,7 +682,6 @@ TEST_F(RtcpFunctionalityTest, twccReceiverOnPacketReceivedBasic)
     RtcConfiguration config{};
     RtpPacket rtpPacket;
     BYTE extensionPayload[4];
-    UINT64 packetInfoValue = 0;
 
     // Create peer connection
     EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&config, &pRtcPeerConnection));
@@ -623,9 +717,9 @@ TEST_F(RtcpFunctionalityTest, twccReceiverOnPacketReceivedBasic)
     EXPECT_EQ(100, pManager->lastSeqNum);
     EXPECT_EQ(0x12345678, pManager->mediaSourceSsrc);
 
-    // Verify packet is in hash table
-    EXPECT_EQ(STATUS_SUCCESS, hashTableGet(pManager->pReceivedPktsHashTable, 100, &packetInfoValue));
-    EXPECT_NE(0, packetInfoValue);
+    // Verify packet is tracked
+    EXPECT_NE(nullptr, twccReceiverGetPacketInfo(pManager, 100));
+    EXPECT_EQ(nullptr, twccReceiverGetPacketInfo(pManager, 101));
 
     // Add another packet with sequence number 101
     twccPayload = htonl((1 << 28) | (1 << 24) | (101 << 8));
@@ -755,7 +849,6 @@ TEST_F(RtcpFunctionalityTest, twccReceiverDuplicatePacketHandling)
     RtcConfiguration config{};
     RtpPacket rtpPacket;
     BYTE extensionPayload[4];
-    UINT32 itemCount = 0;
 
     // Create peer connection
     EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&config, &pRtcPeerConnection));
@@ -779,16 +872,14 @@ TEST_F(RtcpFunctionalityTest, twccReceiverDuplicatePacketHandling)
     EXPECT_EQ(STATUS_SUCCESS, twccReceiverOnPacketReceived(pKvsPeerConnection, &rtpPacket));
 
     // Get initial count
-    EXPECT_EQ(STATUS_SUCCESS, hashTableGetCount(pManager->pReceivedPktsHashTable, &itemCount));
-    EXPECT_EQ(1, itemCount);
+    EXPECT_EQ(1, pManager->receivedPacketCount);
 
     // Try to add duplicate packet 100 - should be silently ignored
     rtpPacket.receivedTime = GETTIME();
     EXPECT_EQ(STATUS_SUCCESS, twccReceiverOnPacketReceived(pKvsPeerConnection, &rtpPacket));
 
     // Count should still be 1
-    EXPECT_EQ(STATUS_SUCCESS, hashTableGetCount(pManager->pReceivedPktsHashTable, &itemCount));
-    EXPECT_EQ(1, itemCount);
+    EXPECT_EQ(1, pManager->receivedPacketCount);
 
     EXPECT_EQ(STATUS_SUCCESS, freePeerConnection(&pRtcPeerConnection));
 }
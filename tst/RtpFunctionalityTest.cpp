@@ -14,6 +14,137 @@ BYTE start4ByteCode[] = {0x00, 0x00, 0x00, 0x01};
 class RtpFunctionalityTest : public WebRtcClientTestBase {
   protected:
     void verifyH264PackingUnpacking(const char* sampleFolder, UINT32 numFrames);
+
+    // Receive side of a transceiver: a jitter buffer whose frames go through onFrameReadyFunc
+    PKvsRtpTransceiver mpTransceiver = nullptr;
+    UINT32 mFrameSizeSkew = 0; // added to the frame size handed to onFrameReadyFunc, non zero fails its size check
+    STATUS mFrameReadyStatus = STATUS_SUCCESS;
+    BOOL mPacketsIntact = TRUE;
+    std::map<UINT16, std::vector<BYTE>> mPushedPayloads;
+    std::vector<std::vector<BYTE>> mFragmentsFrames, mCopiedFrames;
+
+    static STATUS frameReadyThroughTransceiver(UINT64 customData, UINT16 startIndex, UINT16 endIndex, UINT32 frameSize)
+    {
+        RtpFunctionalityTest* base = (RtpFunctionalityTest*) customData;
+        PRtpPacket pPacket;
+        UINT16 index;
+
+        base->mFrameReadyStatus = onFrameReadyFunc((UINT64) base->mpTransceiver, startIndex, endIndex, frameSize + base->mFrameSizeSkew);
+
+        // Only a delivered FU start packet may have had its NAL header rebuilt
+        for (index = startIndex; UINT16_DEC(index) != endIndex; index++) {
+            EXPECT_EQ(STATUS_SUCCESS, jitterBufferGetPacket(base->mpTransceiver->pJitterBuffer, index, &pPacket));
+            base->mPacketsIntact = base->mPacketsIntact && pPacket->payloadLength == base->mPushedPayloads[index].size() &&
+                0 == MEMCMP(pPacket->payload, base->mPushedPayloads[index].data(), pPacket->payloadLength);
+        }
+        return STATUS_SUCCESS;
+    }
+
+    static STATUS frameDroppedThroughTransceiver(UINT64 customData, UINT16 startIndex, UINT16 endIndex, UINT32 timestamp)
+    {
+        UNUSED_PARAM(customData);
+        UNUSED_PARAM(startIndex);
+        UNUSED_PARAM(endIndex);
+        UNUSED_PARAM(timestamp);
+        return STATUS_SUCCESS;
+    }
+
+    static VOID onFrameFragmentsGather(UINT64 customData, PFrame pFrame, PRtcFrameFragment pFragments, UINT32 fragmentCount)
+    {
+        RtpFunctionalityTest* base = (RtpFunctionalityTest*) customData;
+        UINT32 i;
+
+        EXPECT_EQ(nullptr, pFrame->frameData);
+        base->mFragmentsFrames.emplace_back();
+        for (i = 0; i < fragmentCount; i++) {
+            base->mFragmentsFrames.back().insert(base->mFragmentsFrames.back().end(), pFragments[i].pData, pFragments[i].pData + pFragments[i].size);
+        }
+        EXPECT_EQ(pFrame->size, base->mFragmentsFrames.back().size());
+    }
+
+    static VOID onFrameCopy(UINT64 customData, PFrame pFrame)
+    {
+        RtpFunctionalityTest* base = (RtpFunctionalityTest*) customData;
+
+        base->mCopiedFrames.emplace_back(pFrame->frameData, pFrame->frameData + pFrame->size);
+    }
+
+    VOID createReceivingTransceiver(DepayRtpPayloadFunc depayFunc, DepayRtpPayloadFragmentsFunc depayFragmentsFunc, UINT32 clockRate)
+    {
+        mpTransceiver = (PKvsRtpTransceiver) MEMCALLOC(1, SIZEOF(KvsRtpTransceiver));
+        ASSERT_NE(nullptr, mpTransceiver);
+        mpTransceiver->statsLock = MUTEX_CREATE(FALSE);
+        mpTransceiver->transceiver.receiver.track.kind = MEDIA_STREAM_TRACK_KIND_VIDEO;
+        mpTransceiver->depayFragmentsFn = depayFragmentsFunc;
+        mpTransceiver->onFrame = onFrameCopy;
+        mpTransceiver->onFrameCustomData = (UINT64) this;
+        mpTransceiver->onFrameFragments = onFrameFragmentsGather;
+        mpTransceiver->onFrameFragmentsCustomData = (UINT64) this;
+        ASSERT_EQ(STATUS_SUCCESS,
+                  createJitterBuffer(frameReadyThroughTransceiver, frameDroppedThroughTransceiver, depayFunc, DEFAULT_JITTER_BUFFER_MAX_LATENCY,
+                                     clockRate, (UINT64) this, FALSE, &mpTransceiver->pJitterBuffer));
+    }
+
+    VOID pushReceivedPacket(UINT16 seqNum, UINT32 timestamp, BOOL marker, std::vector<BYTE> payload)
+    {
+        TestRtpPacket params;
+        PRtpPacket pPacket = NULL;
+        BOOL discarded = FALSE;
+
+        params.seqNum = seqNum;
+        params.timestamp = timestamp;
+        params.marker = marker;
+        params.payloadLength = (UINT32) payload.size();
+        ASSERT_EQ(STATUS_SUCCESS, createTestRtpPacket(params, &pPacket));
+        MEMCPY(pPacket->payload, payload.data(), payload.size());
+        mPushedPayloads[seqNum] = payload;
+        EXPECT_EQ(STATUS_SUCCESS, jitterBufferPush(mpTransceiver->pJitterBuffer, pPacket, &discarded));
+        EXPECT_FALSE(discarded);
+    }
+
+    // Depayloads a packet with the copying depayloader, then with its fragment counterpart, and expects the same bytes
+    VOID expectFragmentsMatchCopy(DepayRtpPayloadFunc depayFunc, DepayRtpPayloadFragmentsFunc depayFragmentsFunc, std::vector<BYTE> packet,
+                                  UINT32 expectedFragmentCount)
+    {
+        BYTE copied[64];
+        std::vector<BYTE> gathered;
+        RtcFrameFragment fragments[8];
+        UINT32 i, copiedLength = SIZEOF(copied), fragmentCount = 0;
+        BOOL copyIsStart = TRUE, fragmentIsStart = TRUE;
+
+        // Copy first, a fill may rebuild a NAL header in the packet
+        EXPECT_EQ(STATUS_SUCCESS, depayFunc(packet.data(), (UINT32) packet.size(), copied, &copiedLength, &copyIsStart));
+
+        EXPECT_EQ(STATUS_SUCCESS, depayFragmentsFunc(packet.data(), (UINT32) packet.size(), NULL, &fragmentCount, NULL));
+        EXPECT_EQ(expectedFragmentCount, fragmentCount);
+
+        fragmentCount = ARRAY_SIZE(fragments);
+        EXPECT_EQ(STATUS_SUCCESS, depayFragmentsFunc(packet.data(), (UINT32) packet.size(), fragments, &fragmentCount, &fragmentIsStart));
+        EXPECT_EQ(expectedFragmentCount, fragmentCount);
+        EXPECT_EQ(copyIsStart, fragmentIsStart);
+
+        for (i = 0; i < fragmentCount; i++) {
+            if (!fragments[i].startCode) {
+                EXPECT_TRUE(fragments[i].pData >= packet.data() && fragments[i].pData + fragments[i].size <= packet.data() + packet.size());
+            }
+            gathered.insert(gathered.end(), fragments[i].pData, fragments[i].pData + fragments[i].size);
+        }
+        EXPECT_EQ(copiedLength, gathered.size());
+        EXPECT_EQ(0, MEMCMP(copied, gathered.data(), MIN(copiedLength, gathered.size())));
+    }
+
+    void TearDown() override
+    {
+        if (mpTransceiver != nullptr) {
+            freeJitterBuffer(&mpTransceiver->pJitterBuffer);
+            SAFE_MEMFREE(mpTransceiver->pFrameFragments);
+            SAFE_MEMFREE(mpTransceiver->pFrameFragmentsBackup);
+            SAFE_MEMFREE(mpTransceiver->peerFrameBuffer);
+            MUTEX_FREE(mpTransceiver->statsLock);
+            SAFE_MEMFREE(mpTransceiver);
+        }
+        WebRtcClientTestBase::TearDown();
+    }
 };
 
 TEST_F(RtpFunctionalityTest, packetUnderflow)
@@ -628,6 +759,181 @@ TEST_F(RtpFunctionalityTest, trailingZerosWouldBeReturned)
     EXPECT_EQ(7, naluLength);
 }
 
+TEST_F(RtpFunctionalityTest, annexBFindStartCodeMatchesBruteForce)
+{
+    BYTE data[256 + 64];
+    UINT32 expected, i, len, offset, iteration;
+
+    srand(12345);
+    for (iteration = 0; iteration < 200; iteration++) {
+        // Sparse random zeros and ones so start codes land in the vector body, the block edges and the scalar tail
+        for (i = 0; i < ARRAY_SIZE(data); i++) {
+            UINT32 r = (UINT32) rand() % 16;
+            data[i] = r < 5 ? 0x00 : (r < 7 ? 0x01 : (BYTE) rand());
+        }
+
+        for (offset = 0; offset < 4; offset++) {
+            for (len = 0; len <= 256; len += (len < 40 ? 1 : 17)) {
+                expected = len;
+                for (i = 0; i + 2 < len; i++) {
+                    if (data[offset + i] == 0 && data[offset + i + 1] == 0 && data[offset + i + 2] == 1) {
+                        expected = i;
+                        break;
+                    }
+                }
+                EXPECT_EQ(expected, annexBFindStartCode(data + offset, len)) << "iteration " << iteration << " offset " << offset << " len " << len;
+            }
+        }
+    }
+}
+
+TEST_F(RtpFunctionalityTest, annexBScanNalusReturnsAllBoundaries)
+{
+    BYTE frame[] = {0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x80, 0x00, 0x00, 0x01, 0x68, 0xce, 0x00, 0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00, 0x00, 0x01};
+    AnnexBNalu nalus[4];
+    UINT32 naluCount = 0, scannedLength = 0;
+
+    EXPECT_EQ(STATUS_SUCCESS, annexBScanNalus(frame, SIZEOF(frame), nalus, ARRAY_SIZE(nalus), &naluCount, &scannedLength));
+    EXPECT_EQ(3, naluCount);
+    EXPECT_EQ(SIZEOF(frame), scannedLength);
+
+    EXPECT_EQ(4, nalus[0].offset);
+    EXPECT_EQ(3, nalus[0].length);
+    EXPECT_EQ(10, nalus[1].offset);
+    // The trailing zero before a 4-byte start code stays with the NAL unit, the zero of the start code does not
+    EXPECT_EQ(3, nalus[1].length);
+    EXPECT_EQ(17, nalus[2].offset);
+    EXPECT_EQ(3, nalus[2].length);
+
+    // Each NAL unit matches what the per-NAL parser reports
+    UINT32 startIndex = 0, naluLength = 0, consumed = 0;
+    for (UINT32 i = 0; i < naluCount; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, getNextNaluLength(frame + consumed, SIZEOF(frame) - consumed, &startIndex, &naluLength));
+        EXPECT_EQ(nalus[i].offset, consumed + startIndex);
+        EXPECT_EQ(nalus[i].length, naluLength);
+        consumed += startIndex + naluLength;
+    }
+
+    // A short array stops early and the scan resumes from the returned length
+    EXPECT_EQ(STATUS_SUCCESS, annexBScanNalus(frame, SIZEOF(frame), nalus, 1, &naluCount, &scannedLength));
+    EXPECT_EQ(1, naluCount);
+    EXPECT_EQ(7, scannedLength);
+    EXPECT_EQ(STATUS_SUCCESS, annexBScanNalus(frame + scannedLength, SIZEOF(frame) - scannedLength, nalus, ARRAY_SIZE(nalus), &naluCount, &scannedLength));
+    EXPECT_EQ(2, naluCount);
+    EXPECT_EQ(3, nalus[0].offset);
+
+    BYTE invalid[] = {0x01, 0x00, 0x02};
+    EXPECT_EQ(STATUS_RTP_INVALID_NALU, annexBScanNalus(invalid, SIZEOF(invalid), nalus, ARRAY_SIZE(nalus), &naluCount, &scannedLength));
+}
+
+TEST_F(RtpFunctionalityTest, packetizersMatchTwoPassPayloaders)
+{
+    typedef STATUS (*PayloadFunc)(UINT32, PBYTE, UINT32, PBYTE, PUINT32, PUINT32, PUINT32);
+    PayloadFunc payloadFuncs[] = {createPayloadForH264, createPayloadForH265, createPayloadForVP8, createPayloadForOpus, createPayloadForG711};
+    RtpPacketizeFunc packetizeFuncs[] = {packetizeH264Frame, packetizeH265Frame, packetizeVP8Frame, packetizeOpusFrame, packetizeG711Frame};
+    PayloadDescriptorArray descriptors;
+    PayloadArray flattened, expected;
+    UINT32 mtu = 200, frameLen = 0, i, j;
+    BYTE frame[4096];
+
+    // SPS and PPS small enough to aggregate, a NAL unit needing fragmentation, then a small trailing slice
+    UINT32 naluLengths[] = {12, 5, 1500, 40};
+    for (i = 0; i < ARRAY_SIZE(naluLengths); i++) {
+        MEMCPY(frame + frameLen, start4ByteCode, SIZEOF(start4ByteCode));
+        frameLen += SIZEOF(start4ByteCode);
+        for (j = 0; j < naluLengths[i]; j++) {
+            // Keep NAL unit bytes non-zero so no start code is emulated
+            frame[frameLen + j] = (BYTE) (0x41 + i + j % 31);
+        }
+        frameLen += naluLengths[i];
+    }
+
+    MEMSET(&descriptors, 0x00, SIZEOF(descriptors));
+    MEMSET(&flattened, 0x00, SIZEOF(flattened));
+    for (i = 0; i < ARRAY_SIZE(payloadFuncs); i++) {
+        resetPayloadDescriptorArray(&descriptors);
+        EXPECT_EQ(STATUS_SUCCESS, packetizeFuncs[i](mtu, frame, frameLen, &descriptors));
+        EXPECT_EQ(STATUS_SUCCESS, flattenPayloadDescriptors(&descriptors, &flattened));
+
+        EXPECT_EQ(STATUS_SUCCESS, payloadFuncs[i](mtu, frame, frameLen, NULL, &expected.payloadLength, NULL, &expected.payloadSubLenSize));
+        expected.payloadBuffer = (PBYTE) MEMALLOC(expected.payloadLength);
+        expected.payloadSubLength = (PUINT32) MEMALLOC(expected.payloadSubLenSize * SIZEOF(UINT32));
+        EXPECT_EQ(STATUS_SUCCESS,
+                  payloadFuncs[i](mtu, frame, frameLen, expected.payloadBuffer, &expected.payloadLength, expected.payloadSubLength,
+                                  &expected.payloadSubLenSize));
+
+        EXPECT_EQ(expected.payloadLength, flattened.payloadLength);
+        ASSERT_EQ(expected.payloadSubLenSize, flattened.payloadSubLenSize);
+        EXPECT_EQ(0, MEMCMP(expected.payloadBuffer, flattened.payloadBuffer, expected.payloadLength));
+        EXPECT_EQ(0, MEMCMP(expected.payloadSubLength, flattened.payloadSubLength, expected.payloadSubLenSize * SIZEOF(UINT32)));
+
+        // Frame bytes are referenced rather than copied into the scratch buffer
+        EXPECT_GT(expected.payloadLength, descriptors.scratchLength);
+
+        MEMFREE(expected.payloadBuffer);
+        MEMFREE(expected.payloadSubLength);
+    }
+
+    freePayloadDescriptorArray(&descriptors);
+    SAFE_MEMFREE(flattened.payloadBuffer);
+    SAFE_MEMFREE(flattened.payloadSubLength);
+}
+
+TEST_F(RtpFunctionalityTest, descriptorSerializationMatchesContiguousPayload)
+{
+    PayloadDescriptorArray descriptors;
+    PayloadArray flattened;
+    RtpPacket expectedPackets[16], packets[16];
+    BYTE frame[2048], expectedBytes[256], bytes[256];
+    UINT32 mtu = 200, i, expectedLen, packetLen;
+    UINT32 extPayload = TWCC_PAYLOAD(1, 42);
+
+    // STAP-A of two small NAL units followed by a fragmented one
+    UINT32 frameLen = 0;
+    UINT32 naluLengths[] = {10, 6, 900};
+    for (i = 0; i < ARRAY_SIZE(naluLengths); i++) {
+        MEMCPY(frame + frameLen, start4ByteCode, SIZEOF(start4ByteCode));
+        frameLen += SIZEOF(start4ByteCode);
+        MEMSET(frame + frameLen, 0x61 + i, naluLengths[i]);
+        frameLen += naluLengths[i];
+    }
+
+    MEMSET(&descriptors, 0x00, SIZEOF(descriptors));
+    MEMSET(&flattened, 0x00, SIZEOF(flattened));
+    EXPECT_EQ(STATUS_SUCCESS, packetizeH264Frame(mtu, frame, frameLen, &descriptors));
+    EXPECT_EQ(STATUS_SUCCESS, flattenPayloadDescriptors(&descriptors, &flattened));
+    ASSERT_GE(ARRAY_SIZE(packets), descriptors.descriptorCount);
+
+    EXPECT_EQ(STATUS_SUCCESS, constructRtpPackets(&flattened, 96, 65534, 1234, 5678, expectedPackets, ARRAY_SIZE(expectedPackets)));
+    EXPECT_EQ(STATUS_SUCCESS, constructRtpPacketsFromDescriptors(&descriptors, 96, 65534, 1234, 5678, packets, ARRAY_SIZE(packets)));
+    EXPECT_EQ(STATUS_BUFFER_TOO_SMALL, constructRtpPacketsFromDescriptors(&descriptors, 96, 65534, 1234, 5678, packets, 1));
+
+    for (i = 0; i < descriptors.descriptorCount; i++) {
+        // Also cover the header extension writeFrame adds for TWCC
+        expectedPackets[i].header.extension = packets[i].header.extension = TRUE;
+        expectedPackets[i].header.extensionProfile = packets[i].header.extensionProfile = TWCC_EXT_PROFILE;
+        expectedPackets[i].header.extensionLength = packets[i].header.extensionLength = SIZEOF(UINT32);
+        expectedPackets[i].header.extensionPayload = packets[i].header.extensionPayload = (PBYTE) &extPayload;
+
+        expectedLen = SIZEOF(expectedBytes);
+        EXPECT_EQ(STATUS_SUCCESS, createBytesFromRtpPacket(&expectedPackets[i], expectedBytes, &expectedLen));
+
+        EXPECT_EQ(STATUS_SUCCESS, createBytesFromRtpPacketDescriptor(&packets[i], &descriptors, i, NULL, &packetLen));
+        EXPECT_EQ(expectedLen, packetLen);
+        EXPECT_EQ(STATUS_SUCCESS, createBytesFromRtpPacketDescriptor(&packets[i], &descriptors, i, bytes, &packetLen));
+        EXPECT_EQ(expectedLen, packetLen);
+        EXPECT_EQ(0, MEMCMP(expectedBytes, bytes, expectedLen));
+
+        packetLen = expectedLen - 1;
+        EXPECT_EQ(STATUS_NOT_ENOUGH_MEMORY, createBytesFromRtpPacketDescriptor(&packets[i], &descriptors, i, bytes, &packetLen));
+    }
+    EXPECT_EQ(STATUS_INVALID_ARG, createBytesFromRtpPacketDescriptor(&packets[0], &descriptors, descriptors.descriptorCount, bytes, &packetLen));
+
+    freePayloadDescriptorArray(&descriptors);
+    SAFE_MEMFREE(flattened.payloadBuffer);
+    SAFE_MEMFREE(flattened.payloadSubLength);
+}
+
 // https://tools.ietf.org/html/rfc3550#section-5.3.1
 TEST_F(RtpFunctionalityTest, createPacketWithExtension)
 {
@@ -1161,6 +1467,176 @@ TEST_F(RtpFunctionalityTest, depayH264FrameStartDetection)
     }
 }
 
+// The fragments of a packet concatenate to what depayH264FromRtpPayload copies out, start codes included
+TEST_F(RtpFunctionalityTest, depayH264FragmentsMatchCopiedPayload)
+{
+    BYTE singleNalu[] = {0x61, 0x80, 0x00, 0x00};
+    BYTE stapA[] = {0x78, 0x00, 0x04, 0x67, 0x42, 0x00, 0x1E, 0x00, 0x03, 0x68, 0xCE, 0x38};
+    BYTE fuAStart[] = {0x7C, 0x85, 0x80, 0x00, 0x11};
+    BYTE fuAMiddle[] = {0x7C, 0x05, 0x22, 0x33};
+    PBYTE packets[] = {singleNalu, stapA, fuAStart, fuAMiddle};
+    UINT32 packetLengths[] = {SIZEOF(singleNalu), SIZEOF(stapA), SIZEOF(fuAStart), SIZEOF(fuAMiddle)};
+    UINT32 expectedFragmentCounts[] = {2, 4, 2, 1};
+    BYTE copied[64], gathered[64];
+    RtcFrameFragment fragments[8];
+    UINT32 i, j, copiedLength, gatheredLength, fragmentCount;
+    BOOL copyIsStart, fragmentIsStart;
+
+    for (i = 0; i < ARRAY_SIZE(packets); i++) {
+        // Both depayloaders are told the packet continues a frame, so the 3-byte start code is expected
+        copiedLength = SIZEOF(copied);
+        copyIsStart = FALSE;
+        EXPECT_EQ(STATUS_SUCCESS, depayH264FromRtpPayload(packets[i], packetLengths[i], copied, &copiedLength, &copyIsStart));
+
+        fragmentCount = 0;
+        EXPECT_EQ(STATUS_SUCCESS, depayH264FragmentsFromRtpPayload(packets[i], packetLengths[i], NULL, &fragmentCount, NULL));
+        EXPECT_EQ(expectedFragmentCounts[i], fragmentCount);
+
+        fragmentCount = 1;
+        if (expectedFragmentCounts[i] > 1) {
+            EXPECT_EQ(STATUS_BUFFER_TOO_SMALL, depayH264FragmentsFromRtpPayload(packets[i], packetLengths[i], fragments, &fragmentCount, NULL));
+        }
+
+        fragmentCount = ARRAY_SIZE(fragments);
+        fragmentIsStart = FALSE;
+        EXPECT_EQ(STATUS_SUCCESS, depayH264FragmentsFromRtpPayload(packets[i], packetLengths[i], fragments, &fragmentCount, &fragmentIsStart));
+        EXPECT_EQ(expectedFragmentCounts[i], fragmentCount);
+        EXPECT_EQ(copyIsStart, fragmentIsStart);
+
+        gatheredLength = 0;
+        for (j = 0; j < fragmentCount; j++) {
+            // Payload bytes are referenced in place, only start codes live outside the packet
+            if (!fragments[j].startCode) {
+                EXPECT_TRUE(fragments[j].pData >= packets[i] && fragments[j].pData + fragments[j].size <= packets[i] + packetLengths[i]);
+            }
+            MEMCPY(gathered + gatheredLength, fragments[j].pData, fragments[j].size);
+            gatheredLength += fragments[j].size;
+        }
+        EXPECT_EQ(copiedLength, gatheredLength);
+        EXPECT_EQ(0, MEMCMP(copied, gathered, copiedLength));
+    }
+}
+
+TEST_F(RtpFunctionalityTest, depayH265FragmentsMatchCopiedPayload)
+{
+    // Single NAL unit (VPS)
+    expectFragmentsMatchCopy(depayH265FromRtpPayload, depayH265FragmentsFromRtpPayload, {0x40, 0x01, 0x0C, 0x01, 0xFF}, 2);
+    // FU start of an IDR_W_RADL slice, its two byte NAL header is rebuilt over the payload and FU headers
+    expectFragmentsMatchCopy(depayH265FromRtpPayload, depayH265FragmentsFromRtpPayload, {0x62, 0x01, 0x93, 0xAF, 0x01}, 2);
+    // FU middle and end, payload only
+    expectFragmentsMatchCopy(depayH265FromRtpPayload, depayH265FragmentsFromRtpPayload, {0x62, 0x01, 0x13, 0x44, 0x55}, 1);
+    expectFragmentsMatchCopy(depayH265FromRtpPayload, depayH265FragmentsFromRtpPayload, {0x62, 0x01, 0x53, 0x66}, 1);
+}
+
+TEST_F(RtpFunctionalityTest, depayH265FragmentsRebuildNalHeaderInPlace)
+{
+    BYTE fuStart[] = {0x62, 0x01, 0x93, 0xAF, 0x01};
+    RtcFrameFragment fragments[2];
+    UINT32 fragmentCount = ARRAY_SIZE(fragments);
+    BOOL isStart = TRUE;
+
+    // Running out of fragments leaves the packet untouched
+    fragmentCount = 1;
+    EXPECT_EQ(STATUS_BUFFER_TOO_SMALL, depayH265FragmentsFromRtpPayload(fuStart, SIZEOF(fuStart), fragments, &fragmentCount, &isStart));
+    EXPECT_EQ(0x01, fuStart[1]);
+    EXPECT_EQ(0x93, fuStart[2]);
+
+    fragmentCount = ARRAY_SIZE(fragments);
+    EXPECT_EQ(STATUS_SUCCESS, depayH265FragmentsFromRtpPayload(fuStart, SIZEOF(fuStart), fragments, &fragmentCount, &isStart));
+    ASSERT_EQ(2U, fragmentCount);
+    EXPECT_TRUE(fragments[0].startCode);
+    EXPECT_EQ(fuStart + 1, fragments[1].pData);
+    EXPECT_EQ(4U, fragments[1].size);
+    // IDR_W_RADL (19) with the layer and TID of the payload header
+    EXPECT_EQ(0x26, fuStart[1]);
+    EXPECT_EQ(0x01, fuStart[2]);
+}
+
+TEST_F(RtpFunctionalityTest, depayVP8FragmentsMatchCopiedPayload)
+{
+    // Bare payload descriptor
+    expectFragmentsMatchCopy(depayVP8FromRtpPayload, depayVP8FragmentsFromRtpPayload, {0x10, 0x9D, 0x01, 0x2A}, 1);
+    // Extended control bits with a 16-bit picture ID
+    expectFragmentsMatchCopy(depayVP8FromRtpPayload, depayVP8FragmentsFromRtpPayload, {0x90, 0x80, 0x81, 0x23, 0x9D, 0x01}, 1);
+    // Extended control bits with TL0PICIDX and TID/KEYIDX
+    expectFragmentsMatchCopy(depayVP8FromRtpPayload, depayVP8FragmentsFromRtpPayload, {0x80, 0x60, 0x05, 0x40, 0x31, 0x32, 0x33}, 1);
+}
+
+TEST_F(RtpFunctionalityTest, depayAudioFragmentsMatchCopiedPayload)
+{
+    expectFragmentsMatchCopy(depayOpusFromRtpPayload, depayOpusFragmentsFromRtpPayload, {0xFC, 0xFF, 0xFE, 0x01}, 1);
+    expectFragmentsMatchCopy(depayG711FromRtpPayload, depayG711FragmentsFromRtpPayload, {0xD5, 0x55, 0x54, 0xD4}, 1);
+}
+
+// With onFrameFragments registered the frame is not also copied for onFrame, without it onFrame gets the same bytes
+TEST_F(RtpFunctionalityTest, onFrameFragmentsSuppressesOnFrame)
+{
+    std::vector<BYTE> fuFrame = {0x00, 0x00, 0x00, 0x01, 0x65, 0x80, 0x00, 0x11, 0x22, 0x33};
+    std::vector<BYTE> singleNaluFrame = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84};
+
+    createReceivingTransceiver(depayH264FromRtpPayload, depayH264FragmentsFromRtpPayload, VIDEO_CLOCKRATE);
+
+    pushReceivedPacket(0, 3000, FALSE, {0x7C, 0x85, 0x80, 0x00, 0x11});
+    pushReceivedPacket(1, 3000, TRUE, {0x7C, 0x45, 0x22, 0x33});
+    // The first frame is handed over once the next one starts
+    pushReceivedPacket(2, 6000, TRUE, {0x65, 0x88, 0x84});
+
+    EXPECT_EQ(STATUS_SUCCESS, mFrameReadyStatus);
+    ASSERT_EQ(2U, mFragmentsFrames.size());
+    EXPECT_EQ(fuFrame, mFragmentsFrames[0]);
+    EXPECT_EQ(singleNaluFrame, mFragmentsFrames[1]);
+    EXPECT_EQ(0U, mCopiedFrames.size());
+
+    mpTransceiver->onFrameFragments = NULL;
+    pushReceivedPacket(3, 9000, TRUE, {0x65, 0x88, 0x84});
+
+    EXPECT_EQ(STATUS_SUCCESS, mFrameReadyStatus);
+    EXPECT_EQ(2U, mFragmentsFrames.size());
+    ASSERT_EQ(1U, mCopiedFrames.size());
+    EXPECT_EQ(mFragmentsFrames[1], mCopiedFrames[0]);
+}
+
+// The fragment and backup arrays grow when a frame needs more than the previous ones did
+TEST_F(RtpFunctionalityTest, deliverFrameFragmentsGrowsArrays)
+{
+    std::vector<BYTE> expected = {0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x00, 0x01, 0x68, 0xCE,
+                                  0x00, 0x00, 0x01, 0x06, 0x05, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84};
+
+    createReceivingTransceiver(depayH264FromRtpPayload, depayH264FragmentsFromRtpPayload, VIDEO_CLOCKRATE);
+
+    pushReceivedPacket(0, 3000, TRUE, {0x65, 0x88, 0x84});
+    // SPS, PPS and SEI aggregated, then a slice
+    pushReceivedPacket(1, 6000, FALSE, {0x78, 0x00, 0x02, 0x67, 0x42, 0x00, 0x02, 0x68, 0xCE, 0x00, 0x02, 0x06, 0x05});
+    EXPECT_EQ(1U, mFragmentsFrames.size());
+    EXPECT_EQ(2U, mpTransceiver->frameFragmentsCapacity);
+    EXPECT_EQ(1U, mpTransceiver->frameFragmentsBackupCapacity);
+
+    pushReceivedPacket(2, 6000, TRUE, {0x65, 0x88, 0x84});
+
+    EXPECT_EQ(STATUS_SUCCESS, mFrameReadyStatus);
+    ASSERT_EQ(2U, mFragmentsFrames.size());
+    EXPECT_EQ(8U, mpTransceiver->frameFragmentsCapacity);
+    EXPECT_EQ(2U, mpTransceiver->frameFragmentsBackupCapacity);
+    EXPECT_EQ(expected, mFragmentsFrames[1]);
+    EXPECT_TRUE(mPacketsIntact);
+}
+
+// A frame whose fragments don't add up to its size is not delivered, and the FU header the fill rewrote is put back
+TEST_F(RtpFunctionalityTest, deliverFrameFragmentsRestoresPacketsOnFailure)
+{
+    createReceivingTransceiver(depayH264FromRtpPayload, depayH264FragmentsFromRtpPayload, VIDEO_CLOCKRATE);
+    mFrameSizeSkew = 1;
+
+    pushReceivedPacket(0, 3000, FALSE, {0x7C, 0x85, 0x80, 0x00, 0x11});
+    pushReceivedPacket(1, 3000, TRUE, {0x7C, 0x45, 0x22, 0x33});
+    pushReceivedPacket(2, 6000, TRUE, {0x65, 0x88, 0x84});
+
+    EXPECT_EQ(STATUS_INVALID_ARG_LEN, mFrameReadyStatus);
+    EXPECT_TRUE(mPacketsIntact);
+    EXPECT_EQ(0U, mFragmentsFrames.size());
+    EXPECT_EQ(0U, mCopiedFrames.size());
+}
+
 } // namespace webrtcclient
 } // namespace video
 } // namespace kinesis
@@ -19,7 +19,7 @@ VOID pushConsecutiveRtpPacketsIntoBuffer(UINT32 packetCount, UINT32 bufferCapaci
     PRtpRollingBuffer pRtpRollingBuffer;
     UINT32 i;
 
-    EXPECT_EQ(STATUS_SUCCESS, createRtpRollingBuffer(bufferCapacity, &pRtpRollingBuffer));
+    EXPECT_EQ(STATUS_SUCCESS, createRtpRollingBuffer(bufferCapacity, DEFAULT_MTU_SIZE_BYTES, &pRtpRollingBuffer));
 
     EXPECT_EQ(STATUS_SUCCESS, createRtpPacketWithSeqNum(0, &pRtpPacket));
     EXPECT_EQ(STATUS_SUCCESS, rtpRollingBufferAddRtpPacket(pRtpRollingBuffer, pRtpPacket));
@@ -37,7 +37,7 @@ TEST_F(RtpRollingBufferFunctionalityTest, appendDataToBufferAndVerify)
     PRtpRollingBuffer pRtpRollingBuffer;
     PRtpPacket pRtpPacket;
 
-    EXPECT_EQ(STATUS_SUCCESS, createRtpRollingBuffer(2, &pRtpRollingBuffer));
+    EXPECT_EQ(STATUS_SUCCESS, createRtpRollingBuffer(2, DEFAULT_MTU_SIZE_BYTES, &pRtpRollingBuffer));
 
     EXPECT_EQ(STATUS_SUCCESS, createRtpPacketWithSeqNum(0, &pRtpPacket));
     EXPECT_EQ(STATUS_SUCCESS, rtpRollingBufferAddRtpPacket(pRtpRollingBuffer, pRtpPacket));
@@ -55,6 +55,30 @@ TEST_F(RtpRollingBufferFunctionalityTest, appendDataToBufferAndVerify)
     EXPECT_EQ(STATUS_SUCCESS, freeRtpPacket(&pRtpPacket));
 }
 
+TEST_F(RtpRollingBufferFunctionalityTest, packetPoolSizedFromMtuOnFirstAdd)
+{
+    PRtpRollingBuffer pRtpRollingBuffer;
+    PRtpPacket pRtpPacket;
+    PacketPoolStats stats;
+
+    EXPECT_NE(STATUS_SUCCESS, createRtpRollingBuffer(2, 0, &pRtpRollingBuffer));
+    EXPECT_EQ(STATUS_SUCCESS, createRtpRollingBuffer(2, 500, &pRtpRollingBuffer));
+
+    // Nothing is preallocated until a packet is buffered
+    EXPECT_TRUE(pRtpRollingBuffer->pPacketPool == NULL);
+
+    EXPECT_EQ(STATUS_SUCCESS, createRtpPacketWithSeqNum(0, &pRtpPacket));
+    EXPECT_EQ(STATUS_SUCCESS, rtpRollingBufferAddRtpPacket(pRtpRollingBuffer, pRtpPacket));
+    ASSERT_TRUE(pRtpRollingBuffer->pPacketPool != NULL);
+    EXPECT_EQ(STATUS_SUCCESS, packetPoolGetStats(pRtpRollingBuffer->pPacketPool, &stats));
+    EXPECT_EQ(RTP_PACKET_POOL_HEADER_SIZE + OUTBOUND_PACKET_BUFFER_SIZE(500), stats.blockSize);
+    EXPECT_EQ(2, stats.blockCount);
+    EXPECT_EQ(1, stats.blocksInUse);
+
+    EXPECT_EQ(STATUS_SUCCESS, freeRtpRollingBuffer(&pRtpRollingBuffer));
+    EXPECT_EQ(STATUS_SUCCESS, freeRtpPacket(&pRtpPacket));
+}
+
 TEST_F(RtpRollingBufferFunctionalityTest, getIndexForSeqListReturnEmptyList)
 {
     PRtpRollingBuffer pRtpRollingBuffer;
@@ -98,6 +98,12 @@ class SctpAssocApiTest : public WebRtcClientTestBase {
         sctpAssocHandlePacket(&assoc, packet, len, mockOutboundCapture, (UINT64) &cap, mockMessageCapture, (UINT64) &msg);
     }
 
+    // Let the delayed SACK timer run out
+    void expireSackDelay()
+    {
+        TwoAssocHarness::expireSackDelay(&assoc, &cap);
+    }
+
     // Inject a FORWARD-TSN packet from the simulated peer
     void sendPeerForwardTsn(UINT32 newCumTsn)
     {
@@ -133,6 +139,24 @@ class SctpAssocApiTest : public WebRtcClientTestBase {
         return true;
     }
 
+    // Count the chunks of the given type bundled in a captured packet
+    UINT32 countChunks(const CapturedPacket& packet, UINT8 chunkType)
+    {
+        UINT32 count = 0, offset = SCTP_COMMON_HEADER_SIZE;
+        UINT16 chunkLen;
+        while (offset + SCTP_CHUNK_HEADER_SIZE <= packet.len) {
+            chunkLen = (UINT16) getUnalignedInt16BigEndian((PINT16)(packet.data + offset + 2));
+            if (chunkLen < SCTP_CHUNK_HEADER_SIZE) {
+                break;
+            }
+            if (packet.data[offset] == chunkType) {
+                count++;
+            }
+            offset += SCTP_PAD4(chunkLen);
+        }
+        return count;
+    }
+
     // Find the LAST SACK in capture (when multiple packets are captured)
     bool parseLastSack(const PacketCapture& capture, SackInfo& info)
     {
@@ -899,7 +923,30 @@ TEST_F(SctpAssocApiTest, handleData_inOrderDelivered)
     EXPECT_EQ(0, MEMCMP(msg.messages[0].payload, payload, 5));
 }
 
-TEST_F(SctpAssocApiTest, handleData_sendsSackImmediately)
+TEST_F(SctpAssocApiTest, handleData_sackDelayedForFirstPacket)
+{
+    driveToEstablished();
+
+    BYTE payload[] = "hello";
+    BYTE packet[256];
+    UINT32 tsn = assoc.peerCumulativeTsn + 1;
+    UINT32 off = buildDataPacket(packet, 5000, 5000, assoc.myVerificationTag, tsn, 0, 0, SCTP_PPID_STRING, FALSE, payload, 5);
+
+    cap.reset();
+    sctpAssocHandlePacket(&assoc, packet, off, mockOutboundCapture, (UINT64) &cap, mockMessageNoop, 0);
+
+    EXPECT_EQ(cap.findChunkType(SCTP_CHUNK_SACK), -1);
+    EXPECT_TRUE(assoc.needSack);
+    EXPECT_NE(assoc.sackDelayExpiry, (UINT64) 0);
+
+    // The timer sends it
+    expireSackDelay();
+    EXPECT_NE(cap.findChunkType(SCTP_CHUNK_SACK), -1);
+    EXPECT_FALSE(assoc.needSack);
+    EXPECT_EQ(assoc.sackDelayExpiry, (UINT64) 0);
+}
+
+TEST_F(SctpAssocApiTest, handleData_sackDelayIsInMilliseconds)
 {
     driveToEstablished();
 
@@ -907,10 +954,47 @@ TEST_F(SctpAssocApiTest, handleData_sendsSackImmediately)
     BYTE packet[256];
     UINT32 tsn = assoc.peerCumulativeTsn + 1;
     UINT32 off = buildDataPacket(packet, 5000, 5000, assoc.myVerificationTag, tsn, 0, 0, SCTP_PPID_STRING, FALSE, payload, 5);
+    UINT64 beforeMs, afterMs;
 
     cap.reset();
+    beforeMs = GETTIME() / HUNDREDS_OF_NANOS_IN_A_MILLISECOND;
     sctpAssocHandlePacket(&assoc, packet, off, mockOutboundCapture, (UINT64) &cap, mockMessageNoop, 0);
+    afterMs = GETTIME() / HUNDREDS_OF_NANOS_IN_A_MILLISECOND;
+
+    // The SACK is held for SCTP_SACK_DELAY_MS of wall clock time, well below the peer's minimum RTO
+    EXPECT_GE(assoc.sackDelayExpiry, beforeMs + SCTP_SACK_DELAY_MS);
+    EXPECT_LE(assoc.sackDelayExpiry, afterMs + SCTP_SACK_DELAY_MS);
+    EXPECT_LT((UINT64) SCTP_SACK_DELAY_MS, (UINT64) SCTP_RTO_MIN_MS);
+
+    // Not yet sent just before the delay elapses, sent once it has
+    sctpAssocCheckTimers(&assoc, beforeMs + SCTP_SACK_DELAY_MS - 1, mockOutboundCapture, (UINT64) &cap);
+    EXPECT_EQ(cap.findChunkType(SCTP_CHUNK_SACK), -1);
+    sctpAssocCheckTimers(&assoc, afterMs + SCTP_SACK_DELAY_MS, mockOutboundCapture, (UINT64) &cap);
+    EXPECT_NE(cap.findChunkType(SCTP_CHUNK_SACK), -1);
+}
+
+TEST_F(SctpAssocApiTest, handleData_secondPacketSendsSack)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+
+    cap.reset();
+    sendPeerData(base);
+    EXPECT_EQ(cap.count, (UINT32) 0);
 
+    sendPeerData(base + 1);
+    ASSERT_EQ(cap.count, (UINT32) 1);
+    EXPECT_EQ(cap.findChunkType(SCTP_CHUNK_SACK), 0);
+    EXPECT_EQ(assoc.sackDelayExpiry, (UINT64) 0);
+}
+
+TEST_F(SctpAssocApiTest, handleData_gapSendsSackImmediately)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+
+    cap.reset();
+    sendPeerData(base + 1);
     EXPECT_NE(cap.findChunkType(SCTP_CHUNK_SACK), -1);
 }
 
@@ -947,6 +1031,48 @@ TEST_F(SctpAssocApiTest, handleData_duplicateTsnIgnored)
     EXPECT_EQ(msg.count, (UINT32) 1);
 }
 
+// A retransmission of an out-of-order TSN already held is SACKed right away but not delivered again
+TEST_F(SctpAssocApiTest, handleData_outOfOrderRetransmissionNotRedelivered)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+
+    sendPeerData(base + 1);
+    EXPECT_EQ(msg.count, (UINT32) 1);
+    EXPECT_EQ(assoc.receivedTsnCount, (UINT32) 1);
+
+    cap.reset();
+    sendPeerData(base + 1);
+    EXPECT_EQ(msg.count, (UINT32) 1);
+    EXPECT_EQ(assoc.receivedTsnCount, (UINT32) 1);
+    EXPECT_GE(cap.findChunkType(SCTP_CHUNK_SACK), 0);
+}
+
+// An out-of-order TSN that can't be tracked is SACKed but neither delivered nor recorded, the peer retransmits it
+TEST_F(SctpAssocApiTest, handleData_outOfOrderWithoutRoomDropped)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+    UINT32 i;
+
+    for (i = 0; i < SCTP_MAX_RECEIVED; i++) {
+        assoc.receivedTsns[i] = base + 10 + i;
+    }
+    assoc.receivedTsnCount = SCTP_MAX_RECEIVED;
+
+    cap.reset();
+    sendPeerData(base + 1);
+    EXPECT_EQ(msg.count, (UINT32) 0);
+    EXPECT_EQ(assoc.receivedTsnCount, (UINT32) SCTP_MAX_RECEIVED);
+    EXPECT_EQ(assoc.peerCumulativeTsn, base - 1);
+    EXPECT_GE(cap.findChunkType(SCTP_CHUNK_SACK), 0);
+
+    // The in-order TSN still gets through
+    sendPeerData(base);
+    EXPECT_EQ(msg.count, (UINT32) 1);
+    EXPECT_EQ(assoc.peerCumulativeTsn, base);
+}
+
 TEST_F(SctpAssocApiTest, handleData_outOfOrderStored)
 {
     driveToEstablished();
@@ -1035,6 +1161,7 @@ TEST_F(SctpAssocApiTest, handleData_sackHasCorrectCumTsn)
 
     cap.reset();
     sctpAssocHandlePacket(&assoc, packet, off, mockOutboundCapture, (UINT64) &cap, mockMessageNoop, 0);
+    expireSackDelay();
 
     INT32 sackIdx = cap.findChunkType(SCTP_CHUNK_SACK);
     ASSERT_GE(sackIdx, 0);
@@ -1578,6 +1705,7 @@ TEST_F(SctpAssocApiTest, gapBlocks_noGapsValid)
     UINT32 base = assoc.peerCumulativeTsn + 1;
     cap.reset();
     sendPeerData(base);
+    expireSackDelay();
 
     SackInfo sack;
     ASSERT_TRUE(parseSack(cap, sack));
@@ -1964,6 +2092,7 @@ TEST_F(SctpAssocApiTest, gapBlock_manyInOrderAdvances)
     }
     cap.reset();
     sendPeerData(base + 10);
+    expireSackDelay();
 
     SackInfo sack;
     ASSERT_TRUE(parseSack(cap, sack));
@@ -2550,6 +2679,152 @@ TEST_F(SctpAssocApiTest, reassembly_unorderedThreeFragments)
     EXPECT_EQ(0, MEMCMP(msg.messages[0].payload, expected, 6));
 }
 
+// Fragments of messages on two streams arriving interleaved are reassembled separately
+TEST_F(SctpAssocApiTest, reassembly_interleavedStreams)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+    BYTE packet[256];
+    UINT32 off;
+
+    // Stream 1 message is TSNs base..base+2, stream 2 message is base+3..base+4
+    struct {
+        UINT32 tsn;
+        UINT16 sid;
+        UINT8 flags;
+        const char* payload;
+    } fragments[] = {
+        {base, 1, SCTP_DATA_FLAG_BEGIN, "A1"}, {base + 3, 2, SCTP_DATA_FLAG_BEGIN, "B1"}, {base + 1, 1, 0, "A2"},
+        {base + 4, 2, SCTP_DATA_FLAG_END, "B2"}, {base + 2, 1, SCTP_DATA_FLAG_END, "A3"},
+    };
+
+    msg.reset();
+    for (UINT32 i = 0; i < ARRAY_SIZE(fragments); i++) {
+        off = buildDataPacketWithFlags(packet, 5000, 5000, assoc.myVerificationTag, fragments[i].tsn, fragments[i].sid, 0, SCTP_PPID_BINARY,
+                                       fragments[i].flags, (PBYTE) fragments[i].payload, 2);
+        sctpAssocHandlePacket(&assoc, packet, off, mockOutboundNoop, 0, mockMessageCapture, (UINT64) &msg);
+    }
+
+    ASSERT_EQ(msg.count, (UINT32) 2);
+    EXPECT_EQ(msg.messages[0].streamId, (UINT32) 2);
+    EXPECT_EQ(msg.messages[0].payloadLen, (UINT32) 4);
+    EXPECT_EQ(0, MEMCMP(msg.messages[0].payload, "B1B2", 4));
+    EXPECT_EQ(msg.messages[1].streamId, (UINT32) 1);
+    EXPECT_EQ(msg.messages[1].payloadLen, (UINT32) 6);
+    EXPECT_EQ(0, MEMCMP(msg.messages[1].payload, "A1A2A3", 6));
+    EXPECT_EQ(assoc.peerCumulativeTsn, base + 4);
+}
+
+// A fragment that overtook the first one is acked and held until the message reaches it
+TEST_F(SctpAssocApiTest, reassembly_fragmentAheadOfBeginHeld)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+    BYTE packet[256];
+    UINT32 off;
+
+    msg.reset();
+    off = buildDataPacketWithFlags(packet, 5000, 5000, assoc.myVerificationTag, base + 1, 0, 0, SCTP_PPID_BINARY, SCTP_DATA_FLAG_END, (PBYTE) "BBB",
+                                   3);
+    sctpAssocHandlePacket(&assoc, packet, off, mockOutboundNoop, 0, mockMessageCapture, (UINT64) &msg);
+    EXPECT_EQ(assoc.receivedTsnCount, (UINT32) 1);
+    EXPECT_EQ(msg.count, (UINT32) 0);
+
+    off = buildDataPacketWithFlags(packet, 5000, 5000, assoc.myVerificationTag, base, 0, 0, SCTP_PPID_BINARY, SCTP_DATA_FLAG_BEGIN, (PBYTE) "AAA", 3);
+    sctpAssocHandlePacket(&assoc, packet, off, mockOutboundNoop, 0, mockMessageCapture, (UINT64) &msg);
+    EXPECT_EQ(assoc.peerCumulativeTsn, base + 1);
+    ASSERT_EQ(msg.count, (UINT32) 1);
+    EXPECT_EQ(msg.messages[0].payloadLen, (UINT32) 6);
+    EXPECT_EQ(0, MEMCMP(msg.messages[0].payload, "AAABBB", 6));
+    EXPECT_EQ(assoc.pHeldFragments, (PSctpHeldFragment) NULL);
+}
+
+// With a middle fragment lost and the rest arriving out of order, the received ones are gap acked and the message
+// completes once the retransmission fills the gap
+TEST_F(SctpAssocApiTest, reassembly_missingMiddleFragmentGapAcked)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+    BYTE packet[256];
+    UINT32 off, i;
+    SackInfo info;
+    const char* payloads[] = {"AA", "BB", "CC", "DD", "EE"};
+    UINT32 order[] = {4, 2, 0, 3}; // fragment 1 is lost
+
+    msg.reset();
+    for (i = 0; i < ARRAY_SIZE(order); i++) {
+        off = buildDataPacketWithFlags(packet, 5000, 5000, assoc.myVerificationTag, base + order[i], 0, 0, SCTP_PPID_BINARY,
+                                       order[i] == 0 ? SCTP_DATA_FLAG_BEGIN : (order[i] == 4 ? SCTP_DATA_FLAG_END : 0),
+                                       (PBYTE) payloads[order[i]], 2);
+        sctpAssocHandlePacket(&assoc, packet, off, mockOutboundCapture, (UINT64) &cap, mockMessageCapture, (UINT64) &msg);
+    }
+
+    EXPECT_EQ(msg.count, (UINT32) 0);
+    EXPECT_EQ(assoc.peerCumulativeTsn, base);
+    EXPECT_EQ(assoc.receivedTsnCount, (UINT32) 3);
+    ASSERT_TRUE(parseLastSack(cap, info));
+    EXPECT_EQ(info.cumTsn, base);
+    ASSERT_EQ(info.numGaps, (UINT16) 1);
+    EXPECT_EQ(info.gapStarts[0], (UINT16) 2);
+    EXPECT_EQ(info.gapEnds[0], (UINT16) 4);
+
+    off = buildDataPacketWithFlags(packet, 5000, 5000, assoc.myVerificationTag, base + 1, 0, 0, SCTP_PPID_BINARY, 0, (PBYTE) payloads[1], 2);
+    sctpAssocHandlePacket(&assoc, packet, off, mockOutboundCapture, (UINT64) &cap, mockMessageCapture, (UINT64) &msg);
+
+    ASSERT_EQ(msg.count, (UINT32) 1);
+    EXPECT_EQ(msg.messages[0].payloadLen, (UINT32) 10);
+    EXPECT_EQ(0, MEMCMP(msg.messages[0].payload, "AABBCCDDEE", 10));
+    EXPECT_EQ(assoc.peerCumulativeTsn, base + 4);
+    EXPECT_EQ(assoc.receivedTsnCount, (UINT32) 0);
+    EXPECT_EQ(assoc.pHeldFragments, (PSctpHeldFragment) NULL);
+    for (i = 0; i < SCTP_MAX_REASSEMBLY_CONTEXTS; i++) {
+        EXPECT_FALSE(assoc.reassembly[i].inUse);
+    }
+}
+
+// A message over maxMessageSize is dropped but its fragments are still acked
+TEST_F(SctpAssocApiTest, reassembly_overMaxMessageSizeDropped)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+    BYTE frag[] = "AAA";
+    BYTE packet[256];
+    UINT32 off, i;
+
+    assoc.maxMessageSize = 8;
+    msg.reset();
+    for (i = 0; i < 3; i++) {
+        off = buildDataPacketWithFlags(packet, 5000, 5000, assoc.myVerificationTag, base + i, 0, 0, SCTP_PPID_BINARY,
+                                       i == 0 ? SCTP_DATA_FLAG_BEGIN : (i == 2 ? SCTP_DATA_FLAG_END : 0), frag, 3);
+        sctpAssocHandlePacket(&assoc, packet, off, mockOutboundNoop, 0, mockMessageCapture, (UINT64) &msg);
+    }
+
+    EXPECT_EQ(msg.count, (UINT32) 0);
+    EXPECT_EQ(assoc.peerCumulativeTsn, base + 2);
+    for (i = 0; i < SCTP_MAX_REASSEMBLY_CONTEXTS; i++) {
+        EXPECT_FALSE(assoc.reassembly[i].inUse);
+    }
+}
+
+// FORWARD-TSN past a partially received message releases its reassembly context
+TEST_F(SctpAssocApiTest, reassembly_forwardTsnFreesAbandonedMessage)
+{
+    driveToEstablished();
+    UINT32 base = assoc.peerCumulativeTsn + 1;
+    BYTE frag[] = "AAA";
+    BYTE packet[256];
+    UINT32 i;
+
+    UINT32 off = buildDataPacketWithFlags(packet, 5000, 5000, assoc.myVerificationTag, base, 0, 0, SCTP_PPID_BINARY, SCTP_DATA_FLAG_BEGIN, frag, 3);
+    sctpAssocHandlePacket(&assoc, packet, off, mockOutboundNoop, 0, mockMessageCapture, (UINT64) &msg);
+    EXPECT_TRUE(assoc.reassembly[0].inUse);
+
+    sendPeerForwardTsn(base + 1);
+    for (i = 0; i < SCTP_MAX_REASSEMBLY_CONTEXTS; i++) {
+        EXPECT_FALSE(assoc.reassembly[i].inUse);
+    }
+}
+
 /******************************************************************************
  * Outstanding / Retransmit
  * Matches Rust: acks_single_chunk (multiple), retransmit cumTsn tracking
@@ -2600,6 +2875,221 @@ TEST_F(SctpAssocApiTest, outstanding_abandonThenSendNewData)
     EXPECT_EQ(assoc.outstandingCount, (UINT32) 1);
 }
 
+/******************************************************************************
+ * Bundling
+ *****************************************************************************/
+
+TEST_F(SctpAssocApiTest, bundle_pendingQueueDrainsIntoOnePacket)
+{
+    driveToEstablished();
+    BYTE payload[] = "message!";
+    UINT32 i;
+
+    sctpAssocSend(&assoc, 0, SCTP_PPID_STRING, FALSE, payload, 8, 0xFFFF, 0, mockOutboundNoop, 0);
+    UINT32 sentTsn = assoc.nextTsn - 1;
+
+    // Hold the next messages back as if the window were full
+    assoc.cwnd = assoc.flightSize;
+    for (i = 0; i < 10; i++) {
+        sctpAssocSend(&assoc, 0, SCTP_PPID_STRING, FALSE, payload, 8, 0xFFFF, 0, mockOutboundNoop, 0);
+    }
+    ASSERT_EQ(assoc.pendingQueueCount, (UINT32) 10);
+
+    assoc.cwnd = SCTP_DEFAULT_ARWND;
+    cap.reset();
+    sendPeerSack(sentTsn);
+
+    EXPECT_EQ(assoc.pendingQueueCount, (UINT32) 0);
+    ASSERT_EQ(cap.count, (UINT32) 1);
+    EXPECT_EQ(countChunks(cap.packets[0], SCTP_CHUNK_DATA), (UINT32) 10);
+}
+
+TEST_F(SctpAssocApiTest, bundle_respectsMtu)
+{
+    driveToEstablished();
+    BYTE payload[400];
+    UINT32 i, dataChunks = 0;
+
+    MEMSET(payload, 0x5a, SIZEOF(payload));
+    sctpAssocSend(&assoc, 0, SCTP_PPID_BINARY, FALSE, payload, 8, 0xFFFF, 0, mockOutboundNoop, 0);
+    UINT32 sentTsn = assoc.nextTsn - 1;
+
+    assoc.cwnd = assoc.flightSize;
+    for (i = 0; i < 5; i++) {
+        sctpAssocSend(&assoc, 0, SCTP_PPID_BINARY, FALSE, payload, SIZEOF(payload), 0xFFFF, 0, mockOutboundNoop, 0);
+    }
+
+    assoc.cwnd = SCTP_DEFAULT_ARWND;
+    cap.reset();
+    sendPeerSack(sentTsn);
+
+    // Two 416 byte chunks fit a 1188 byte packet, a third does not
+    ASSERT_EQ(cap.count, (UINT32) 3);
+    for (i = 0; i < cap.count; i++) {
+        EXPECT_LE(cap.packets[i].len, (UINT32) assoc.mtu);
+        dataChunks += countChunks(cap.packets[i], SCTP_CHUNK_DATA);
+    }
+    EXPECT_EQ(dataChunks, (UINT32) 5);
+}
+
+TEST_F(SctpAssocApiTest, bundle_delayedSackRidesOnData)
+{
+    driveToEstablished();
+    BYTE payload[] = "reply";
+
+    sendPeerData(assoc.peerCumulativeTsn + 1);
+    ASSERT_TRUE(assoc.needSack);
+
+    cap.reset();
+    sctpAssocSend(&assoc, 0, SCTP_PPID_STRING, FALSE, payload, 5, 0xFFFF, 0, mockOutboundCapture, (UINT64) &cap);
+
+    // Control chunks lead the bundle
+    ASSERT_EQ(cap.count, (UINT32) 1);
+    EXPECT_EQ(cap.findChunkType(SCTP_CHUNK_SACK), 0);
+    EXPECT_EQ(countChunks(cap.packets[0], SCTP_CHUNK_DATA), (UINT32) 1);
+    EXPECT_FALSE(assoc.needSack);
+    EXPECT_EQ(assoc.sackDelayExpiry, (UINT64) 0);
+}
+
+TEST_F(SctpAssocApiTest, bundle_t3RetransmitsShareAPacket)
+{
+    driveToEstablished();
+    BYTE payload[] = "hello";
+    UINT32 i;
+
+    for (i = 0; i < 3; i++) {
+        sctpAssocSend(&assoc, 0, SCTP_PPID_STRING, FALSE, payload, 5, 0xFFFF, 0, mockOutboundNoop, 0);
+    }
+
+    cap.reset();
+    sctpAssocCheckTimers(&assoc, assoc.t3RtxExpiry, mockOutboundCapture, (UINT64) &cap);
+
+    ASSERT_EQ(cap.count, (UINT32) 1);
+    EXPECT_EQ(countChunks(cap.packets[0], SCTP_CHUNK_DATA), (UINT32) 3);
+}
+
+// ============================================================================
+// Outstanding ring and fast retransmit
+// ============================================================================
+
+// Three SACKs reporting the first TSN missing retransmit it without waiting for T3 and halve the window
+TEST_F(SctpAssocApiTest, fastRtx_afterThreeMissReports)
+{
+    driveToEstablished();
+    BYTE payload[] = "hello";
+    UINT32 base = assoc.nextTsn;
+    UINT16 gapStarts[] = {2};
+    UINT16 gapEnds[] = {2};
+    UINT32 i, cwndBefore;
+
+    for (i = 0; i < 5; i++) {
+        sctpAssocSend(&assoc, 0, SCTP_PPID_STRING, FALSE, payload, 5, 0xFFFF, 0, mockOutboundNoop, 0);
+    }
+
+    // base+1 and base+2 arrive, base is reported missing twice
+    for (i = 0; i < 2; i++) {
+        cap.reset();
+        gapEnds[0] = (UINT16) (2 + i);
+        sendPeerSackWithGaps(base - 1, gapStarts, gapEnds, 1);
+        EXPECT_EQ(cap.findChunkType(SCTP_CHUNK_DATA), -1);
+    }
+    EXPECT_FALSE(assoc.inFastRecovery);
+
+    cwndBefore = assoc.cwnd;
+    cap.reset();
+    gapEnds[0] = 4;
+    sendPeerSackWithGaps(base - 1, gapStarts, gapEnds, 1);
+
+    INT32 idx = cap.findChunkType(SCTP_CHUNK_DATA);
+    ASSERT_GE(idx, 0);
+    EXPECT_EQ((UINT32) getUnalignedInt32BigEndian((PINT32)(cap.packets[idx].data + SCTP_COMMON_HEADER_SIZE + 4)), base);
+    EXPECT_EQ(countChunks(cap.packets[idx], SCTP_CHUNK_DATA), (UINT32) 1);
+    EXPECT_TRUE(assoc.inFastRecovery);
+    EXPECT_EQ(assoc.ssthresh, MAX(cwndBefore / 2, 4 * (UINT32) assoc.mtu));
+    EXPECT_EQ(assoc.cwnd, assoc.ssthresh);
+}
+
+// A TSN is fast retransmitted once, and fast recovery ends when everything outstanding at its start is acked
+TEST_F(SctpAssocApiTest, fastRtx_onceThenRecoveryExits)
+{
+    driveToEstablished();
+    BYTE payload[] = "hello";
+    UINT32 base = assoc.nextTsn;
+    UINT16 gapStarts[] = {2};
+    UINT16 gapEnds[] = {2};
+    UINT32 i, cwndInRecovery;
+
+    for (i = 0; i < 6; i++) {
+        sctpAssocSend(&assoc, 0, SCTP_PPID_STRING, FALSE, payload, 5, 0xFFFF, 0, mockOutboundNoop, 0);
+    }
+    for (i = 0; i < 3; i++) {
+        gapEnds[0] = (UINT16) (2 + i);
+        sendPeerSackWithGaps(base - 1, gapStarts, gapEnds, 1);
+    }
+    ASSERT_TRUE(assoc.inFastRecovery);
+    cwndInRecovery = assoc.cwnd;
+
+    // Fourth miss report: no second retransmission and no window growth
+    cap.reset();
+    gapEnds[0] = 5;
+    sendPeerSackWithGaps(base - 1, gapStarts, gapEnds, 1);
+    EXPECT_EQ(cap.findChunkType(SCTP_CHUNK_DATA), -1);
+    EXPECT_EQ(assoc.cwnd, cwndInRecovery);
+
+    sendPeerSack(base + 5);
+    EXPECT_FALSE(assoc.inFastRecovery);
+    EXPECT_EQ(assoc.outstandingCount, (UINT32) 0);
+    EXPECT_EQ(assoc.flightSize, (UINT32) 0);
+}
+
+// Retransmitted fragments keep their B/E flags so the peer can still reassemble the message
+TEST_F(SctpAssocApiTest, t3Rtx_fragmentsKeepFlags)
+{
+    driveToEstablished();
+    UINT32 maxDataPayload = assoc.mtu - SCTP_COMMON_HEADER_SIZE - SCTP_DATA_HEADER_SIZE;
+    UINT32 bigLen = maxDataPayload * 2 + 10;
+
+    BYTE* bigPayload = (BYTE*) MEMALLOC(bigLen);
+    ASSERT_TRUE(bigPayload != NULL);
+    MEMSET(bigPayload, 0xAA, bigLen);
+    sctpAssocSend(&assoc, 0, SCTP_PPID_BINARY, TRUE, bigPayload, bigLen, 0xFFFF, 0, mockOutboundNoop, 0);
+    MEMFREE(bigPayload);
+
+    cap.reset();
+    sctpAssocCheckTimers(&assoc, assoc.t3RtxExpiry, mockOutboundCapture, (UINT64) &cap);
+
+    ASSERT_EQ(cap.count, (UINT32) 3);
+    EXPECT_EQ(cap.packets[0].data[SCTP_COMMON_HEADER_SIZE + 1], SCTP_DATA_FLAG_UNORDERED | SCTP_DATA_FLAG_BEGIN);
+    EXPECT_EQ(cap.packets[1].data[SCTP_COMMON_HEADER_SIZE + 1], SCTP_DATA_FLAG_UNORDERED);
+    EXPECT_EQ(cap.packets[2].data[SCTP_COMMON_HEADER_SIZE + 1], SCTP_DATA_FLAG_UNORDERED | SCTP_DATA_FLAG_END);
+}
+
+// Once SCTP_MAX_OUTSTANDING TSNs are unacked, new messages wait in the pending queue until a SACK frees ring slots
+TEST_F(SctpAssocApiTest, outstanding_ringFullQueuesToPending)
+{
+    driveToEstablished();
+    BYTE payload[] = "x";
+    UINT32 base = assoc.nextTsn;
+    UINT32 i;
+
+    assoc.cwnd = SCTP_DEFAULT_ARWND;
+    for (i = 0; i < SCTP_MAX_OUTSTANDING; i++) {
+        sctpAssocSend(&assoc, 0, SCTP_PPID_BINARY, TRUE, payload, 1, 0xFFFF, 0, mockOutboundNoop, 0);
+    }
+    EXPECT_EQ(assoc.outstandingCount, (UINT32) SCTP_MAX_OUTSTANDING);
+
+    sctpAssocSend(&assoc, 0, SCTP_PPID_BINARY, TRUE, payload, 1, 0xFFFF, 0, mockOutboundNoop, 0);
+    EXPECT_EQ(assoc.pendingQueueCount, (UINT32) 1);
+    EXPECT_EQ(assoc.nextTsn, base + SCTP_MAX_OUTSTANDING);
+
+    // The new TSN reuses the slot of the acked one
+    sendPeerSack(base);
+    EXPECT_EQ(assoc.pendingQueueCount, (UINT32) 0);
+    EXPECT_EQ(assoc.nextTsn, base + SCTP_MAX_OUTSTANDING + 1);
+    EXPECT_EQ(assoc.outstandingCount, (UINT32) SCTP_MAX_OUTSTANDING);
+    EXPECT_EQ(SCTP_OUTSTANDING_ENTRY(&assoc, base + SCTP_MAX_OUTSTANDING)->tsn, base + SCTP_MAX_OUTSTANDING);
+}
+
 } // namespace webrtcclient
 } // namespace video
 } // namespace kinesis
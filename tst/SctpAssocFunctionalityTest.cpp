@@ -370,6 +370,29 @@ TEST_F(SctpAssocFunctionalityTest, fragment_oversizedMessage)
     MEMFREE(bigPayload);
 }
 
+// Messages above the old 64 KB reassembly limit span several reassembly blocks
+TEST_F(SctpAssocFunctionalityTest, fragment_messageLargerThan64KB)
+{
+    h.completeHandshake();
+
+    UINT32 bigLen = 100 * 1024;
+    BYTE* bigPayload = (BYTE*) MEMALLOC(bigLen);
+    ASSERT_TRUE(bigPayload != NULL);
+    for (UINT32 i = 0; i < bigLen; i++) {
+        bigPayload[i] = (BYTE)(i & 0xFF);
+    }
+
+    sctpAssocSend(&h.assocA, 0, SCTP_PPID_BINARY, FALSE, bigPayload, bigLen, 0xFFFF, 0, mockOutboundCapture, (UINT64) &h.capA);
+    h.exchangePackets();
+    h.exchangePackets();
+
+    ASSERT_EQ(h.msgB.count, (UINT32) 1);
+    EXPECT_EQ(h.msgB.messages[0].payloadLen, bigLen);
+    EXPECT_EQ(0, MEMCMP(h.msgB.messages[0].payload, bigPayload, SCTP_TEST_MAX_MSG_LEN));
+
+    MEMFREE(bigPayload);
+}
+
 TEST_F(SctpAssocFunctionalityTest, fragment_exactMtuBoundary)
 {
     h.completeHandshake();
@@ -1419,9 +1442,8 @@ TEST_F(SctpAssocFunctionalityTest, retransmit_sessionTickTimersDrivesRetransmiss
     gSessionCapA.reset();
     gSessionCapB.reset();
 
-    // Shorten RTO so the test doesn't need to sleep 10+ seconds.
-    // SCTP_NOW_MS() uses units of 10ms, so rtoMs=10 → 100ms real time.
-    sessionA->assoc.rtoMs = 10;
+    // Shorten RTO so the test doesn't need to sleep for a second
+    sessionA->assoc.rtoMs = 100;
 
     // Send a message from A — it will be captured in gSessionCapA
     BYTE payload[] = "retransmit me";
@@ -1436,7 +1458,7 @@ TEST_F(SctpAssocFunctionalityTest, retransmit_sessionTickTimersDrivesRetransmiss
 
     // T3-rtx is armed on A, but no packets arrive to trigger putSctpPacket.
     // Without sctpSessionTickTimers, the message is lost forever.
-    // Sleep past the T3 expiry (rtoMs=10 → 100ms real time, sleep 200ms).
+    // Sleep past the T3 expiry (rtoMs=100ms, sleep 200ms).
     THREAD_SLEEP(200 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
 
     // Drive the timer via the same function the periodic callback uses
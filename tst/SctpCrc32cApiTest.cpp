@@ -164,6 +164,31 @@ TEST_F(SctpCrc32cApiTest, crc32c_knownSctpPacket)
     EXPECT_EQ(storedCrc, crc);
 }
 
+// Every implementation must agree with the byte-wise reference for all lengths and alignments,
+// which exercises the unaligned head, the 8-byte body and the tail of the wide loops
+TEST_F(SctpCrc32cApiTest, crc32c_implementationsMatchReference)
+{
+    BYTE data[1024 + 8];
+    for (UINT32 i = 0; i < ARRAY_SIZE(data); i++) {
+        data[i] = (BYTE) ((i * 131 + 7) & 0xFF);
+    }
+
+    for (UINT32 offset = 0; offset < 8; offset++) {
+        for (UINT32 len = 0; len <= 1024; len += (len < 64 ? 1 : 61)) {
+            UINT32 expected = sctpCrc32cBytewise(data + offset, len);
+            EXPECT_EQ(sctpCrc32cSlicingBy8(data + offset, len), expected) << "offset " << offset << " len " << len;
+            EXPECT_EQ(sctpCrc32cHardware(data + offset, len), expected) << "offset " << offset << " len " << len;
+            EXPECT_EQ(sctpCrc32c(data + offset, len), expected) << "offset " << offset << " len " << len;
+        }
+    }
+
+    // Standard check value through each variant
+    BYTE check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(sctpCrc32cBytewise(check, 9), (UINT32) 0xE3069283);
+    EXPECT_EQ(sctpCrc32cSlicingBy8(check, 9), (UINT32) 0xE3069283);
+    EXPECT_EQ(sctpCrc32cHardware(check, 9), (UINT32) 0xE3069283);
+}
+
 } // namespace webrtcclient
 } // namespace video
 } // namespace kinesis
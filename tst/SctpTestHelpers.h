@@ -8,6 +8,7 @@
 #define SCTP_TEST_MAX_PACKETS  128
 #define SCTP_TEST_MAX_MESSAGES 128
 #define SCTP_TEST_MAX_PKT_LEN  SCTP_MAX_PACKET_SIZE
+#define SCTP_TEST_MAX_MSG_LEN  65536 // longer messages are captured truncated, with their full payloadLen
 
 struct CapturedPacket {
     BYTE data[SCTP_TEST_MAX_PKT_LEN];
@@ -17,7 +18,7 @@ struct CapturedPacket {
 struct CapturedMessage {
     UINT32 streamId;
     UINT32 ppid;
-    BYTE payload[SCTP_MAX_REASSEMBLY_SIZE];
+    BYTE payload[SCTP_TEST_MAX_MSG_LEN];
     UINT32 payloadLen;
 };
 
@@ -71,8 +72,8 @@ static VOID mockMessageCapture(UINT64 customData, UINT32 streamId, UINT32 ppid,
         cap->messages[cap->count].streamId = streamId;
         cap->messages[cap->count].ppid = ppid;
         UINT32 copyLen = payloadLen;
-        if (copyLen > SCTP_MAX_REASSEMBLY_SIZE) {
-            copyLen = SCTP_MAX_REASSEMBLY_SIZE;
+        if (copyLen > SCTP_TEST_MAX_MSG_LEN) {
+            copyLen = SCTP_TEST_MAX_MSG_LEN;
         }
         if (copyLen > 0) {
             MEMCPY(cap->messages[cap->count].payload, pPayload, copyLen);
@@ -166,9 +167,21 @@ struct TwoAssocHarness {
             total++;
         }
 
+        // A real round trip outlasts the delayed SACK timer
+        expireSackDelay(&assocA, &capA);
+        expireSackDelay(&assocB, &capB);
+
         return total;
     }
 
+    // Fire the delayed SACK timer if it is running
+    static void expireSackDelay(PSctpAssociation pAssoc, PacketCapture* pCapture)
+    {
+        if (pAssoc->sackDelayExpiry != 0) {
+            sctpAssocCheckTimers(pAssoc, pAssoc->sackDelayExpiry, mockOutboundCapture, (UINT64) pCapture);
+        }
+    }
+
     // Run the full 4-way handshake to get both to ESTABLISHED
     void completeHandshake()
     {
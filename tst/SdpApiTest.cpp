@@ -90,6 +90,8 @@ a=msid-semantic: WMS f327e13b-3518-47fc-8b53-9cf74d22d03e
 
         EXPECT_STREQ(sessionDescription.sdpAttributes[2].attributeName, "msid-semantic");
         EXPECT_STREQ(sessionDescription.sdpAttributes[2].attributeValue, " WMS f327e13b-3518-47fc-8b53-9cf74d22d03e");
+
+        EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sessionDescription));
     });
 }
 
@@ -126,9 +128,46 @@ a=candidate:842163049 1 udp 1677729535 54.240.196.188 15632 typ srflx raddr 10.1
         EXPECT_EQ(sessionDescription.mediaDescriptions[1].mediaAttributesCount, 2);
         EXPECT_STREQ(sessionDescription.mediaDescriptions[1].sdpAttributes[0].attributeName, "ssrc");
         EXPECT_STREQ(sessionDescription.mediaDescriptions[1].sdpAttributes[0].attributeValue, "45567500 cname:AZdzrek14WN2tYrw");
+
+        EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sessionDescription));
     });
 }
 
+TEST_F(SdpApiTest, deserializeSessionDescription_ManyMediaSections)
+{
+    std::string sessionDescriptionMedia = R"(v=0
+o=- 1904080082932320671 2 IN IP4 127.0.0.1
+s=-
+t=0 0
+a=group:BUNDLE
+)";
+    const UINT32 mediaCount = 64;
+
+    for (UINT32 i = 0; i < mediaCount; i++) {
+        sessionDescriptionMedia += "m=video 9 UDP/TLS/RTP/SAVPF 96\na=mid:" + std::to_string(i) + "\na=recvonly\na=rtpmap:96 H264/90000\n";
+    }
+
+    SessionDescription sessionDescription;
+    MEMSET(&sessionDescription, 0x00, SIZEOF(SessionDescription));
+    EXPECT_EQ(STATUS_SUCCESS, deserializeSessionDescription(&sessionDescription, (PCHAR) sessionDescriptionMedia.c_str()));
+
+    EXPECT_EQ(mediaCount, sessionDescription.mediaCount);
+    for (UINT32 i = 0; i < sessionDescription.mediaCount; i++) {
+        EXPECT_STREQ("video 9 UDP/TLS/RTP/SAVPF 96", sessionDescription.mediaDescriptions[i].mediaName);
+        EXPECT_EQ(3, sessionDescription.mediaDescriptions[i].mediaAttributesCount);
+        EXPECT_STREQ("mid", sessionDescription.mediaDescriptions[i].sdpAttributes[0].attributeName);
+        EXPECT_STREQ(std::to_string(i).c_str(), sessionDescription.mediaDescriptions[i].sdpAttributes[0].attributeValue);
+        EXPECT_STREQ("recvonly", sessionDescription.mediaDescriptions[i].sdpAttributes[1].attributeName);
+        EXPECT_STREQ("", sessionDescription.mediaDescriptions[i].sdpAttributes[1].attributeValue);
+    }
+
+    // Parsed strings point into the arena copy, not the caller's buffer
+    EXPECT_TRUE(sessionDescription.mediaDescriptions[0].mediaName < sessionDescriptionMedia.c_str() ||
+                sessionDescription.mediaDescriptions[0].mediaName >= sessionDescriptionMedia.c_str() + sessionDescriptionMedia.size());
+
+    EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sessionDescription));
+}
+
 auto populate_session_description = [](PSessionDescription pSessionDescription) {
     MEMSET(pSessionDescription, 0x00, SIZEOF(SessionDescription));
 
@@ -141,18 +180,15 @@ auto populate_session_description = [](PSessionDescription pSessionDescription)
     STRCPY(pSessionDescription->sdpOrigin.sdpConnectionInformation.addressType, "IP4");
     STRCPY(pSessionDescription->sdpOrigin.sdpConnectionInformation.connectionAddress, "127.0.0.1");
 
-    STRCPY(pSessionDescription->sessionName, "-");
+    pSessionDescription->sessionName = (PCHAR) "-";
 
     pSessionDescription->timeDescriptionCount = 1;
     pSessionDescription->sdpTimeDescription[0].startTime = 0;
     pSessionDescription->sdpTimeDescription[0].stopTime = 0;
 
-    pSessionDescription->sessionAttributesCount = 2;
-    STRCPY(pSessionDescription->sdpAttributes[0].attributeName, "group");
-    STRCPY(pSessionDescription->sdpAttributes[0].attributeValue, "BUNDLE 0 1");
-
-    STRCPY(pSessionDescription->sdpAttributes[1].attributeName, "msid-semantic");
-    STRCPY(pSessionDescription->sdpAttributes[1].attributeValue, " WMS f327e13b-3518-47fc-8b53-9cf74d22d03e");
+    EXPECT_EQ(STATUS_SUCCESS, sdpAppendAttribute(pSessionDescription, NULL, (PCHAR) "group", (PCHAR) "BUNDLE 0 1"));
+    EXPECT_EQ(STATUS_SUCCESS,
+              sdpAppendAttribute(pSessionDescription, NULL, (PCHAR) "msid-semantic", (PCHAR) " WMS f327e13b-3518-47fc-8b53-9cf74d22d03e"));
 };
 
 TEST_F(SdpApiTest, serializeSessionDescription_NoMedia)
@@ -181,6 +217,8 @@ a=msid-semantic: WMS f327e13b-3518-47fc-8b53-9cf74d22d03e
 
     EXPECT_EQ(serializeSessionDescription(&sessionDescription, buff.get(), &buff_len), STATUS_SUCCESS);
     EXPECT_STREQ(buff.get(), (PCHAR)(lfToCRLF(sessionDescriptionNoMedia, ARRAY_SIZE(sessionDescriptionNoMedia) - 1).c_str()));
+
+    EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sessionDescription));
 }
 
 TEST_F(SdpApiTest, serializeSessionDescription_Media)
@@ -202,22 +240,19 @@ a=ssrc:45567500 cname:AZdzrek14WN2tYrw
     const UINT32 expectedLen = ARRAY_SIZE(sessionDescriptionNoMedia) + 10;
     std::unique_ptr<CHAR[]> buff(new CHAR[expectedLen]);
 
-    populate_session_description(&sessionDescription);
-
-    sessionDescription.mediaCount = 2;
+    PSdpMediaDescription pMediaDescription = NULL;
 
-    STRCPY(sessionDescription.mediaDescriptions[0].mediaName, "audio 3554 UDP/TLS/RTP/SAVPF 111 103 9 102 0 8 105 13 110 113 126");
-    sessionDescription.mediaDescriptions[0].mediaAttributesCount = 1;
-
-    STRCPY(sessionDescription.mediaDescriptions[0].sdpAttributes[0].attributeName, "candidate");
-    STRCPY(sessionDescription.mediaDescriptions[0].sdpAttributes[0].attributeValue,
-           "1682923840 1 udp 2113937151 10.111.144.78 63135 typ host generation 0 network-cost 999");
+    populate_session_description(&sessionDescription);
 
-    STRCPY(sessionDescription.mediaDescriptions[1].mediaName, "video 15632 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 127 125 104");
-    sessionDescription.mediaDescriptions[1].mediaAttributesCount = 1;
+    EXPECT_EQ(STATUS_SUCCESS, sdpAppendMediaDescription(&sessionDescription, &pMediaDescription));
+    pMediaDescription->mediaName = (PCHAR) "audio 3554 UDP/TLS/RTP/SAVPF 111 103 9 102 0 8 105 13 110 113 126";
+    EXPECT_EQ(STATUS_SUCCESS,
+              sdpAppendAttributeFormat(&sessionDescription, pMediaDescription, (PCHAR) "candidate", (PCHAR) "%u 1 udp %u 10.111.144.78 %u %s",
+                                       1682923840, 2113937151, 63135, "typ host generation 0 network-cost 999"));
 
-    STRCPY(sessionDescription.mediaDescriptions[1].sdpAttributes[0].attributeName, "ssrc");
-    STRCPY(sessionDescription.mediaDescriptions[1].sdpAttributes[0].attributeValue, "45567500 cname:AZdzrek14WN2tYrw");
+    EXPECT_EQ(STATUS_SUCCESS, sdpAppendMediaDescription(&sessionDescription, &pMediaDescription));
+    pMediaDescription->mediaName = (PCHAR) "video 15632 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 127 125 104";
+    EXPECT_EQ(STATUS_SUCCESS, sdpAppendAttribute(&sessionDescription, pMediaDescription, (PCHAR) "ssrc", (PCHAR) "45567500 cname:AZdzrek14WN2tYrw"));
 
     EXPECT_EQ(serializeSessionDescription(&sessionDescription, NULL, &buff_len), STATUS_SUCCESS);
     EXPECT_EQ(buff_len, expectedLen);
@@ -228,6 +263,8 @@ a=ssrc:45567500 cname:AZdzrek14WN2tYrw
 
     EXPECT_EQ(serializeSessionDescription(&sessionDescription, buff.get(), &buff_len), STATUS_SUCCESS);
     EXPECT_STREQ(buff.get(), (PCHAR) lfToCRLF(sessionDescriptionNoMedia, ARRAY_SIZE(sessionDescriptionNoMedia) - 1).c_str());
+
+    EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sessionDescription));
 }
 
 TEST_F(SdpApiTest, serializeSessionDescription_AttributeOverflow)
@@ -246,6 +283,7 @@ t=0 0
     MEMSET(&sessionDescription, 0x00, SIZEOF(SessionDescription));
     auto converted = lfToCRLF((PCHAR) sessionDescriptionNoMedia.c_str(), sessionDescriptionNoMedia.size());
     EXPECT_EQ(deserializeSessionDescription(&sessionDescription, (PCHAR) converted.c_str()), STATUS_SDP_ATTRIBUTE_MAX_EXCEEDED);
+    EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sessionDescription));
 }
 
 TEST_F(SdpApiTest, setTransceiverPayloadTypes_NoRtxType)
@@ -402,17 +440,20 @@ TEST_F(SdpApiTest, populateSingleMediaSection_TestTxSendRecvMaxTransceivers)
     STRCPY(track.streamId, "myKvsVideoStream");
     STRCPY(track.trackId, "myTrack");
 
-    // Max transceivers
-    for (UINT32 i = 0; i < MAX_SDP_SESSION_MEDIA_COUNT - 1; i++) {
+    // Media sections are no longer bounded by a fixed array, well past the old five m-line limit has to fit
+    const UINT32 transceiverCount = 12;
+    for (UINT32 i = 0; i < transceiverCount; i++) {
         EXPECT_EQ(STATUS_SUCCESS, addTransceiver(offerPc, &track, &rtcRtpTransceiverInit, &pTransceiver));
     }
 
     EXPECT_EQ(STATUS_SUCCESS, createOffer(offerPc, &sessionDescriptionInit));
     EXPECT_PRED_FORMAT2(testing::IsSubstring, "sendrecv", sessionDescriptionInit.sdp);
 
-    // Adding one more should fail
-    EXPECT_EQ(STATUS_SUCCESS, addTransceiver(offerPc, &track, &rtcRtpTransceiverInit, &pTransceiver));
-    EXPECT_EQ(STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT, createOffer(offerPc, &sessionDescriptionInit));
+    UINT32 videoSections = 0;
+    for (PCHAR pCurrent = STRSTR(sessionDescriptionInit.sdp, "m=video"); pCurrent != NULL; pCurrent = STRSTR(pCurrent + 1, "m=video")) {
+        videoSections++;
+    }
+    EXPECT_EQ(transceiverCount, videoSections);
 
     closePeerConnection(offerPc);
     freePeerConnection(&offerPc);
@@ -688,8 +729,10 @@ a=group:BUNDLE 0 1 2 3
     assertLFAndCRLF((PCHAR) offer3.c_str(), offer3.size(), [](PCHAR sdp) {
         SessionDescription sessionDescription;
         MEMSET(&sessionDescription, 0x00, SIZEOF(SessionDescription));
-        // as log as Sdp.h  MAX_SDP_SESSION_MEDIA_COUNT 5 this should fail instead of overwriting memory
-        EXPECT_EQ(STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT, deserializeSessionDescription(&sessionDescription, (PCHAR) sdp));
+        // Media sections are allocated on demand, more than the five audio, video, text, application and message fit
+        EXPECT_EQ(STATUS_SUCCESS, deserializeSessionDescription(&sessionDescription, (PCHAR) sdp));
+        EXPECT_EQ(6, sessionDescription.mediaCount);
+        EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sessionDescription));
     });
 }
 
@@ -985,7 +1028,7 @@ a=ssrc:331864867 msid:2e3ca9ff-0c7e-4b9d-9471-2ce80de74b84 757d07a0-892a-46e7-a1
 
         EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&configuration, &pRtcPeerConnection));
 
-        EXPECT_EQ(STATUS_SESSION_DESCRIPTION_MAX_MEDIA_COUNT, setRemoteDescription(pRtcPeerConnection, &offerSdp));
+        EXPECT_EQ(STATUS_SUCCESS, setRemoteDescription(pRtcPeerConnection, &offerSdp));
         closePeerConnection(pRtcPeerConnection);
         EXPECT_EQ(STATUS_SUCCESS, freePeerConnection(&pRtcPeerConnection));
     });
@@ -1215,6 +1258,7 @@ a=extmap:11 urn:ietf:params:rtp-hdrext:sdes:repaired-rtp-stream-id
 TEST_F(SdpApiTest, twccExtension)
 {
     SessionDescription sd{};
+
     EXPECT_EQ(STATUS_SUCCESS, deserializeSessionDescription(&sd, const_cast<PCHAR>(sdpext)));
     uint32_t extid = 0;
     for (int i = 0; i < sd.mediaDescriptions[0].mediaAttributesCount; i++) {
@@ -1228,6 +1272,7 @@ TEST_F(SdpApiTest, twccExtension)
         }
     }
     EXPECT_EQ(4, extid);
+    EXPECT_EQ(STATUS_SUCCESS, resetSessionDescription(&sd));
 }
 
 TEST_F(SdpApiTest, populateSingleMediaSection_TestPayloadFmtp)
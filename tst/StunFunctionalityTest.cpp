@@ -693,6 +693,292 @@ TEST_F(StunFunctionalityTest, deserializeStunErrorCode)
     EXPECT_EQ(STATUS_SUCCESS, freeStunPacket(&pStunPacket));
 }
 
+STATUS oneShotHmacSha1(PBYTE key, UINT32 keyLen, PBYTE message, UINT32 messageLen, PBYTE pDigest)
+{
+    STATUS retStatus = STATUS_SUCCESS;
+    UINT32 digestLen = KVS_SHA1_DIGEST_LENGTH;
+
+    KVS_SHA1_HMAC(key, keyLen, message, messageLen, pDigest, &digestLen);
+
+CleanUp:
+
+    return retStatus;
+}
+
+TEST_F(StunFunctionalityTest, hmacKeyScheduleMatchesOneShotHmac)
+{
+    BYTE key[2 * KVS_SHA1_BLOCK_LENGTH], message[200], expected[KVS_SHA1_DIGEST_LENGTH], actual[KVS_SHA1_DIGEST_LENGTH];
+    UINT32 keyLens[] = {0, STRLEN(TEST_STUN_PASSWORD), KVS_SHA1_BLOCK_LENGTH, SIZEOF(key)};
+    KvsHmacSha1Key hmacKey;
+    UINT32 i, j;
+
+    MEMSET(&hmacKey, 0x00, SIZEOF(hmacKey));
+    for (i = 0; i < SIZEOF(key); i++) {
+        key[i] = (BYTE) (i * 7 + 3);
+    }
+
+    for (i = 0; i < SIZEOF(message); i++) {
+        message[i] = (BYTE) (i * 13 + 1);
+    }
+
+    // Keys both shorter and longer than the SHA1 block, which get hashed down first. The key schedule is reinitialized in place.
+    for (i = 0; i < ARRAY_SIZE(keyLens); i++) {
+        EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyInit(&hmacKey, key, keyLens[i]));
+
+        // The same key schedule is reused across messages
+        for (j = 0; j < 3; j++) {
+            EXPECT_EQ(STATUS_SUCCESS, oneShotHmacSha1(key, keyLens[i], message, SIZEOF(message) - j * 50, expected));
+            EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1(&hmacKey, message, SIZEOF(message) - j * 50, actual));
+            EXPECT_EQ(0, MEMCMP(expected, actual, KVS_SHA1_DIGEST_LENGTH));
+        }
+    }
+
+    EXPECT_NE(STATUS_SUCCESS, kvsHmacSha1KeyInit(NULL, key, SIZEOF(key)));
+    EXPECT_NE(STATUS_SUCCESS, kvsHmacSha1(NULL, message, SIZEOF(message), actual));
+    EXPECT_NE(STATUS_SUCCESS, kvsHmacSha1(&hmacKey, message, SIZEOF(message), NULL));
+
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyFree(&hmacKey));
+    // Freeing is idempotent
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyFree(&hmacKey));
+    EXPECT_NE(STATUS_SUCCESS, kvsHmacSha1KeyFree(NULL));
+}
+
+TEST_F(StunFunctionalityTest, serializeSinglePassIntoLargerBuffer)
+{
+    BYTE transactionId[STUN_TRANSACTION_ID_LEN] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    BYTE buffer[STUN_PACKET_ALLOCATION_SIZE];
+    PBYTE pExactBuffer = NULL;
+    UINT32 size, exactSize;
+    PStunPacket pStunPacket = NULL;
+
+    EXPECT_EQ(STATUS_SUCCESS, createStunPacket(STUN_PACKET_TYPE_BINDING_REQUEST, transactionId, &pStunPacket));
+    EXPECT_EQ(STATUS_SUCCESS, appendStunUsernameAttribute(pStunPacket, (PCHAR) "abcd:efgh"));
+    EXPECT_EQ(STATUS_SUCCESS, appendStunPriorityAttribute(pStunPacket, 12345));
+    EXPECT_EQ(STATUS_SUCCESS, appendStunFlagAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_USE_CANDIDATE));
+
+    // Two-pass: size query followed by an exactly sized buffer
+    EXPECT_EQ(STATUS_SUCCESS,
+              serializeStunPacket(pStunPacket, (PBYTE) TEST_STUN_PASSWORD, STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR), TRUE, TRUE, NULL, &exactSize));
+    EXPECT_TRUE(NULL != (pExactBuffer = (PBYTE) MEMALLOC(exactSize)));
+    EXPECT_EQ(STATUS_SUCCESS,
+              serializeStunPacket(pStunPacket, (PBYTE) TEST_STUN_PASSWORD, STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR), TRUE, TRUE, pExactBuffer,
+                                  &exactSize));
+
+    // Single-pass into a larger buffer returns the actual size and the same bytes
+    size = SIZEOF(buffer);
+    EXPECT_EQ(STATUS_SUCCESS,
+              serializeStunPacket(pStunPacket, (PBYTE) TEST_STUN_PASSWORD, STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR), TRUE, TRUE, buffer, &size));
+    EXPECT_EQ(exactSize, size);
+    EXPECT_EQ(0, MEMCMP(pExactBuffer, buffer, size));
+
+    // Too small a buffer fails rather than truncating
+    size = exactSize - 1;
+    EXPECT_NE(STATUS_SUCCESS,
+              serializeStunPacket(pStunPacket, (PBYTE) TEST_STUN_PASSWORD, STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR), TRUE, TRUE, buffer, &size));
+
+    EXPECT_EQ(STATUS_SUCCESS, freeStunPacket(&pStunPacket));
+    SAFE_MEMFREE(pExactBuffer);
+}
+
+TEST_F(StunFunctionalityTest, bindingRequestTemplateUpdateMatchesSerialize)
+{
+    BYTE transactionId[STUN_TRANSACTION_ID_LEN] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    BYTE newTransactionId[STUN_TRANSACTION_ID_LEN] = {21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
+    BYTE buffer[STUN_PACKET_ALLOCATION_SIZE];
+    UINT32 size;
+    KvsHmacSha1Key hmacKey;
+    StunPacketTemplate stunPacketTemplate;
+    PStunPacket pStunPacket = NULL, pDeserializedPacket = NULL;
+    PStunAttributePriority pStunAttributePriority = NULL;
+
+    MEMSET(&hmacKey, 0x00, SIZEOF(hmacKey));
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyInit(&hmacKey, (PBYTE) TEST_STUN_PASSWORD, STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR)));
+    EXPECT_EQ(STATUS_SUCCESS, createStunPacket(STUN_PACKET_TYPE_BINDING_REQUEST, transactionId, &pStunPacket));
+    EXPECT_EQ(STATUS_SUCCESS, appendStunUsernameAttribute(pStunPacket, (PCHAR) "abcd:efgh"));
+    EXPECT_EQ(STATUS_SUCCESS, appendStunPriorityAttribute(pStunPacket, 12345));
+    EXPECT_EQ(STATUS_SUCCESS, appendStunIceControllAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_ICE_CONTROLLING, 0));
+
+    EXPECT_EQ(STATUS_SUCCESS, stunPacketTemplateInit(pStunPacket, &hmacKey, &stunPacketTemplate));
+    EXPECT_EQ(STATUS_SUCCESS, stunPacketTemplateUpdate(&stunPacketTemplate, &hmacKey, newTransactionId, 67890));
+
+    // Patching the template has to produce exactly what a full serialization of the updated packet would
+    MEMCPY(pStunPacket->header.transactionId, newTransactionId, STUN_TRANSACTION_ID_LEN);
+    EXPECT_EQ(STATUS_SUCCESS, getStunAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_PRIORITY, (PStunAttributeHeader*) &pStunAttributePriority));
+    pStunAttributePriority->priority = 67890;
+    size = SIZEOF(buffer);
+    EXPECT_EQ(STATUS_SUCCESS, serializeStunPacketWithKey(pStunPacket, &hmacKey, TRUE, buffer, &size));
+    EXPECT_EQ(size, stunPacketTemplate.packetLen);
+    EXPECT_EQ(0, MEMCMP(buffer, stunPacketTemplate.packet, size));
+
+    // And it has to pass the integrity and fingerprint checks on the receiving side
+    EXPECT_EQ(STATUS_SUCCESS,
+              deserializeStunPacket(stunPacketTemplate.packet, stunPacketTemplate.packetLen, (PBYTE) TEST_STUN_PASSWORD,
+                                    (UINT32) STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR), &pDeserializedPacket));
+    EXPECT_EQ(0, MEMCMP(newTransactionId, pDeserializedPacket->header.transactionId, STUN_TRANSACTION_ID_LEN));
+    EXPECT_EQ(STATUS_SUCCESS, getStunAttribute(pDeserializedPacket, STUN_ATTRIBUTE_TYPE_PRIORITY, (PStunAttributeHeader*) &pStunAttributePriority));
+    EXPECT_EQ(67890, pStunAttributePriority->priority);
+
+    EXPECT_EQ(STATUS_SUCCESS, freeStunPacket(&pStunPacket));
+    EXPECT_EQ(STATUS_SUCCESS, freeStunPacket(&pDeserializedPacket));
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyFree(&hmacKey));
+}
+
+TEST_F(StunFunctionalityTest, packetViewMatchesDeserialize)
+{
+    BYTE transactionId[STUN_TRANSACTION_ID_LEN] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    BYTE buffer[STUN_PACKET_ALLOCATION_SIZE];
+    UINT32 size, priority;
+    KvsIpAddress address, viewAddress;
+    KvsHmacSha1Key hmacKey, wrongHmacKey;
+    StunPacketView stunPacketView;
+    PStunAttributeView pAttributeView = NULL;
+    PStunPacket pStunPacket = NULL, pDeserializedPacket = NULL;
+    PStunAttributeAddress pStunAttributeAddress = NULL;
+    UINT32 i;
+
+    MEMSET(&hmacKey, 0x00, SIZEOF(hmacKey));
+    MEMSET(&wrongHmacKey, 0x00, SIZEOF(wrongHmacKey));
+    for (auto family : {KVS_IP_FAMILY_TYPE_IPV4, KVS_IP_FAMILY_TYPE_IPV6}) {
+        MEMSET(&address, 0x00, SIZEOF(KvsIpAddress));
+        address.family = (UINT16) family;
+        address.port = (UINT16) getInt16(12345);
+        for (i = 0; i < IPV6_ADDRESS_LENGTH; i++) {
+            address.address[i] = (BYTE) (i + 100);
+        }
+
+        EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyInit(&hmacKey, (PBYTE) TEST_STUN_PASSWORD, STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR)));
+        EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyInit(&wrongHmacKey, (PBYTE) "wrong", 5));
+        EXPECT_EQ(STATUS_SUCCESS, createStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS, transactionId, &pStunPacket));
+        EXPECT_EQ(STATUS_SUCCESS, appendStunAddressAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, &address));
+        EXPECT_EQ(STATUS_SUCCESS, appendStunPriorityAttribute(pStunPacket, 67890));
+        EXPECT_EQ(STATUS_SUCCESS, appendStunFlagAttribute(pStunPacket, STUN_ATTRIBUTE_TYPE_USE_CANDIDATE));
+        size = SIZEOF(buffer);
+        EXPECT_EQ(STATUS_SUCCESS, serializeStunPacketWithKey(pStunPacket, &hmacKey, TRUE, buffer, &size));
+
+        EXPECT_EQ(STATUS_SUCCESS, stunPacketViewInit(buffer, size, &hmacKey, &stunPacketView));
+        EXPECT_EQ(STATUS_SUCCESS,
+                  deserializeStunPacket(buffer, size, (PBYTE) TEST_STUN_PASSWORD, (UINT32) STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR),
+                                        &pDeserializedPacket));
+
+        // Same attributes in the same order, values pointing into the buffer
+        EXPECT_EQ(STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS, stunPacketView.stunMessageType);
+        EXPECT_EQ(0, MEMCMP(transactionId, stunPacketView.transactionId, STUN_TRANSACTION_ID_LEN));
+        EXPECT_EQ(pDeserializedPacket->attributesCount, stunPacketView.attributesCount);
+        for (i = 0; i < stunPacketView.attributesCount; i++) {
+            EXPECT_EQ(pDeserializedPacket->attributeList[i]->type, stunPacketView.attributes[i].type);
+            EXPECT_EQ(pDeserializedPacket->attributeList[i]->length, stunPacketView.attributes[i].length);
+            EXPECT_TRUE(stunPacketView.attributes[i].pValue > buffer && stunPacketView.attributes[i].pValue < buffer + size);
+        }
+
+        EXPECT_EQ(STATUS_SUCCESS, stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, &pAttributeView));
+        EXPECT_TRUE(pAttributeView != NULL);
+        EXPECT_EQ(STATUS_SUCCESS, stunAttributeViewGetAddress(&stunPacketView, pAttributeView, &viewAddress));
+        EXPECT_EQ(STATUS_SUCCESS,
+                  getStunAttribute(pDeserializedPacket, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, (PStunAttributeHeader*) &pStunAttributeAddress));
+        EXPECT_TRUE(isSameIpAddress(&pStunAttributeAddress->address, &viewAddress, TRUE));
+        EXPECT_TRUE(isSameIpAddress(&address, &viewAddress, TRUE));
+
+        EXPECT_EQ(STATUS_SUCCESS, stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_PRIORITY, &pAttributeView));
+        EXPECT_EQ(STATUS_SUCCESS, stunAttributeViewGetUint32(pAttributeView, &priority));
+        EXPECT_EQ(67890, priority);
+
+        EXPECT_EQ(STATUS_SUCCESS, stunPacketViewGetAttribute(&stunPacketView, STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED, &pAttributeView));
+        EXPECT_TRUE(pAttributeView == NULL);
+
+        // Integrity has to be checked with the right key and a key is needed at all
+        EXPECT_EQ(STATUS_STUN_MESSAGE_INTEGRITY_MISMATCH, stunPacketViewInit(buffer, size, &wrongHmacKey, &stunPacketView));
+        EXPECT_NE(STATUS_SUCCESS, stunPacketViewInit(buffer, size, NULL, &stunPacketView));
+
+        // The buffer is left as it was
+        EXPECT_EQ(STATUS_SUCCESS, stunPacketViewInit(buffer, size, &hmacKey, &stunPacketView));
+
+        // Tampering is caught by the integrity check
+        buffer[STUN_HEADER_LEN + STUN_ATTRIBUTE_HEADER_LEN + 2] ^= 0x01;
+        EXPECT_EQ(STATUS_STUN_MESSAGE_INTEGRITY_MISMATCH, stunPacketViewInit(buffer, size, &hmacKey, &stunPacketView));
+        EXPECT_EQ(0, stunPacketView.attributesCount);
+
+        EXPECT_EQ(STATUS_SUCCESS, freeStunPacket(&pStunPacket));
+        EXPECT_EQ(STATUS_SUCCESS, freeStunPacket(&pDeserializedPacket));
+    }
+
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyFree(&hmacKey));
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyFree(&wrongHmacKey));
+}
+
+TEST_F(StunFunctionalityTest, packetViewRejectsAttributesPastBuffer)
+{
+    // USERNAME claiming 8 bytes with only 4 left in the buffer
+    BYTE packet[] = {0x00, 0x01, 0x00, 0x08, 0x21, 0x12, 0xa4, 0x42, 0x70, 0x66, 0x68, 0x6e, 0x70, 0x62,
+                     0x50, 0x66, 0x41, 0x61, 0x6b, 0x4d, 0x00, 0x06, 0x00, 0x08, 0x61, 0x62, 0x63, 0x64};
+    // Same USERNAME with its value in the buffer but past the 8 bytes of message length
+    BYTE trailing[] = {0x00, 0x01, 0x00, 0x08, 0x21, 0x12, 0xa4, 0x42, 0x70, 0x66, 0x68, 0x6e, 0x70, 0x62, 0x50, 0x66,
+                       0x41, 0x61, 0x6b, 0x4d, 0x00, 0x06, 0x00, 0x08, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68};
+    StunPacketView stunPacketView;
+    PStunPacket pStunPacket = NULL;
+
+    EXPECT_NE(STATUS_SUCCESS, stunPacketViewInit(trailing, SIZEOF(trailing), NULL, &stunPacketView));
+    EXPECT_EQ(0, stunPacketView.attributesCount);
+
+    EXPECT_NE(STATUS_SUCCESS, stunPacketViewInit(packet, SIZEOF(packet), NULL, &stunPacketView));
+    EXPECT_NE(STATUS_SUCCESS, deserializeStunPacket(packet, SIZEOF(packet), NULL, 0, &pStunPacket));
+    EXPECT_TRUE(pStunPacket == NULL);
+
+    // With the right length it parses
+    packet[23] = 0x04;
+    EXPECT_EQ(STATUS_SUCCESS, stunPacketViewInit(packet, SIZEOF(packet), NULL, &stunPacketView));
+    EXPECT_EQ(1, stunPacketView.attributesCount);
+    EXPECT_EQ(STUN_ATTRIBUTE_TYPE_USERNAME, stunPacketView.attributes[0].type);
+    EXPECT_EQ(0, MEMCMP("abcd", stunPacketView.attributes[0].pValue, 4));
+
+    // Header only and the NULL checks
+    EXPECT_NE(STATUS_SUCCESS, stunPacketViewInit(packet, STUN_HEADER_LEN - 1, NULL, &stunPacketView));
+    EXPECT_NE(STATUS_SUCCESS, stunPacketViewInit(NULL, SIZEOF(packet), NULL, &stunPacketView));
+    EXPECT_NE(STATUS_SUCCESS, stunPacketViewInit(packet, SIZEOF(packet), NULL, NULL));
+}
+
+TEST_F(StunFunctionalityTest, stackStunPacketSerializesLikeAllocatedOne)
+{
+    BYTE transactionId[STUN_TRANSACTION_ID_LEN] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    UINT64 storage[STUN_BINDING_RESPONSE_STORAGE_SIZE / SIZEOF(UINT64)];
+    // ERROR-CODE serialization leaves its reserved bytes untouched
+    BYTE buffer[STUN_PACKET_ALLOCATION_SIZE] = {0}, stackBuffer[STUN_PACKET_ALLOCATION_SIZE] = {0};
+    UINT32 size, stackSize;
+    KvsIpAddress address;
+    KvsHmacSha1Key hmacKey;
+    PStunPacket pStunPacket = NULL, pStackStunPacket = NULL;
+
+    MEMSET(&address, 0x00, SIZEOF(KvsIpAddress));
+    MEMSET(&hmacKey, 0x00, SIZEOF(hmacKey));
+    address.family = KVS_IP_FAMILY_TYPE_IPV6;
+    address.port = (UINT16) getInt16(12345);
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyInit(&hmacKey, (PBYTE) TEST_STUN_PASSWORD, STRLEN(TEST_STUN_PASSWORD) * SIZEOF(CHAR)));
+
+    EXPECT_EQ(STATUS_SUCCESS, createStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS, transactionId, &pStunPacket));
+    EXPECT_EQ(STATUS_SUCCESS,
+              initStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS, transactionId, (PBYTE) storage, SIZEOF(storage), &pStackStunPacket));
+    EXPECT_EQ((PVOID) storage, (PVOID) pStackStunPacket);
+
+    for (auto pPacket : {pStunPacket, pStackStunPacket}) {
+        EXPECT_EQ(STATUS_SUCCESS, appendStunAddressAttribute(pPacket, STUN_ATTRIBUTE_TYPE_XOR_MAPPED_ADDRESS, &address));
+        EXPECT_EQ(STATUS_SUCCESS, appendStunIceControllAttribute(pPacket, STUN_ATTRIBUTE_TYPE_ICE_CONTROLLED, 1234));
+        EXPECT_EQ(STATUS_SUCCESS, appendStunErrorCodeAttribute(pPacket, (PCHAR) "Role Conflict", 487));
+    }
+
+    size = SIZEOF(buffer);
+    stackSize = SIZEOF(stackBuffer);
+    EXPECT_EQ(STATUS_SUCCESS, serializeStunPacketWithKey(pStunPacket, &hmacKey, TRUE, buffer, &size));
+    EXPECT_EQ(STATUS_SUCCESS, serializeStunPacketWithKey(pStackStunPacket, &hmacKey, TRUE, stackBuffer, &stackSize));
+    EXPECT_EQ(size, stackSize);
+    EXPECT_EQ(0, MEMCMP(buffer, stackBuffer, size));
+
+    // Too little storage for even the attribute table
+    EXPECT_NE(STATUS_SUCCESS, initStunPacket(STUN_PACKET_TYPE_BINDING_RESPONSE_SUCCESS, transactionId, (PBYTE) storage, SIZEOF(StunPacket),
+                                             &pStackStunPacket));
+
+    EXPECT_EQ(STATUS_SUCCESS, freeStunPacket(&pStunPacket));
+    EXPECT_EQ(STATUS_SUCCESS, kvsHmacSha1KeyFree(&hmacKey));
+}
+
 } // namespace webrtcclient
 } // namespace video
 } // namespace kinesis
@@ -0,0 +1,360 @@
+/*******************************************
+TimerWheel Unit Tests
+Shared hierarchical timer wheel
+*******************************************/
+
+#include "WebRTCClientTestFixture.h"
+
+namespace com {
+namespace amazonaws {
+namespace kinesis {
+namespace video {
+namespace webrtcclient {
+
+class TimerWheelFunctionalityTest : public WebRtcClientTestBase {
+  public:
+    PTimerWheel pTimerWheel = nullptr;
+    TIMER_QUEUE_HANDLE timerQueueHandle = INVALID_TIMER_QUEUE_HANDLE_VALUE;
+
+    void TearDown() override
+    {
+        kvsTimerQueueFree(&timerQueueHandle);
+        freeTimerWheel(&pTimerWheel);
+        WebRtcClientTestBase::TearDown();
+    }
+
+    void createWheelQueue(UINT32 workerCount = 1)
+    {
+        ASSERT_EQ(STATUS_SUCCESS, createTimerWheel(workerCount, &pTimerWheel));
+        ASSERT_EQ(STATUS_SUCCESS, timerWheelCreateQueue(pTimerWheel, &timerQueueHandle));
+        ASSERT_TRUE(IS_TIMER_WHEEL_QUEUE_HANDLE(timerQueueHandle));
+    }
+};
+
+typedef struct {
+    volatile SIZE_T invocationCount;
+    UINT32 stopAfter;
+    UINT64 firstInvocationTime;
+    TIMER_QUEUE_HANDLE timerQueueHandle;
+    UINT32 timerId;
+} TimerWheelTestContext, *PTimerWheelTestContext;
+
+static STATUS timerWheelTestCallback(UINT32 timerId, UINT64 currentTime, UINT64 customData)
+{
+    UNUSED_PARAM(timerId);
+    PTimerWheelTestContext pContext = (PTimerWheelTestContext) customData;
+
+    if (ATOMIC_INCREMENT(&pContext->invocationCount) == 0) {
+        pContext->firstInvocationTime = currentTime;
+    }
+
+    return pContext->stopAfter != 0 && ATOMIC_LOAD(&pContext->invocationCount) >= pContext->stopAfter ? STATUS_TIMER_QUEUE_STOP_SCHEDULING
+                                                                                                          : STATUS_SUCCESS;
+}
+
+static STATUS timerWheelCancelSelfCallback(UINT32 timerId, UINT64 currentTime, UINT64 customData)
+{
+    UNUSED_PARAM(currentTime);
+    PTimerWheelTestContext pContext = (PTimerWheelTestContext) customData;
+
+    ATOMIC_INCREMENT(&pContext->invocationCount);
+    return kvsTimerQueueCancelTimer(pContext->timerQueueHandle, timerId, customData);
+}
+
+static STATUS timerWheelSlowCallback(UINT32 timerId, UINT64 currentTime, UINT64 customData)
+{
+    UNUSED_PARAM(timerId);
+    UNUSED_PARAM(currentTime);
+    PTimerWheelTestContext pContext = (PTimerWheelTestContext) customData;
+
+    THREAD_SLEEP(100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    ATOMIC_INCREMENT(&pContext->invocationCount);
+    return STATUS_SUCCESS;
+}
+
+TEST_F(TimerWheelFunctionalityTest, createInvalidArgs)
+{
+    TIMER_QUEUE_HANDLE handle;
+
+    EXPECT_EQ(STATUS_NULL_ARG, createTimerWheel(1, nullptr));
+    EXPECT_EQ(STATUS_INVALID_ARG, createTimerWheel(0, &pTimerWheel));
+    EXPECT_EQ(STATUS_INVALID_ARG, createTimerWheel(TIMER_WHEEL_MAX_WORKER_COUNT + 1, &pTimerWheel));
+    EXPECT_EQ(nullptr, pTimerWheel);
+    EXPECT_EQ(STATUS_NULL_ARG, timerWheelCreateQueue(nullptr, &handle));
+    EXPECT_EQ(STATUS_SUCCESS, freeTimerWheel(&pTimerWheel));
+    EXPECT_EQ(STATUS_NULL_ARG, freeTimerWheel(nullptr));
+}
+
+TEST_F(TimerWheelFunctionalityTest, periodicAndSingleShotTimers)
+{
+    TimerWheelTestContext periodic{}, singleShot{};
+    UINT32 periodicId, singleShotId;
+    UINT64 startTime = GETTIME();
+
+    createWheelQueue();
+
+    EXPECT_EQ(STATUS_INVALID_TIMER_PERIOD_VALUE,
+              kvsTimerQueueAddTimer(timerQueueHandle, 0, HUNDREDS_OF_NANOS_IN_A_MICROSECOND, timerWheelTestCallback, (UINT64) &periodic, &periodicId));
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 5 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, 5 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND,
+                                    timerWheelTestCallback, (UINT64) &periodic, &periodicId));
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 20 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD,
+                                    timerWheelTestCallback, (UINT64) &singleShot, &singleShotId));
+    EXPECT_NE(periodicId, singleShotId);
+
+    THREAD_SLEEP(200 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+
+    // 5ms period over 200ms, leaving plenty of room for a loaded machine
+    EXPECT_GE(ATOMIC_LOAD(&periodic.invocationCount), 10);
+    EXPECT_LE(ATOMIC_LOAD(&periodic.invocationCount), 41);
+    EXPECT_GE(periodic.firstInvocationTime, startTime + 5 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(1, ATOMIC_LOAD(&singleShot.invocationCount));
+    EXPECT_GE(singleShot.firstInvocationTime, startTime + 20 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueCancelTimer(timerQueueHandle, periodicId, (UINT64) &periodic));
+}
+
+TEST_F(TimerWheelFunctionalityTest, stopSchedulingEndsTimer)
+{
+    TimerWheelTestContext context{};
+    UINT32 timerId;
+
+    createWheelQueue();
+    context.stopAfter = 3;
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 0, 2 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, timerWheelTestCallback, (UINT64) &context, &timerId));
+    THREAD_SLEEP(100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(3, ATOMIC_LOAD(&context.invocationCount));
+    EXPECT_EQ(0, pTimerWheel->pWorkers[0].activeTimerCount);
+}
+
+TEST_F(TimerWheelFunctionalityTest, cancelTimer)
+{
+    TimerWheelTestContext context{}, selfCancel{};
+    UINT32 timerId;
+
+    createWheelQueue();
+
+    // Cancelled before it is due
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 50 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, 5 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND,
+                                    timerWheelTestCallback, (UINT64) &context, &timerId));
+    // Wrong custom data is ignored
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueCancelTimer(timerQueueHandle, timerId, 0));
+    EXPECT_EQ(1, pTimerWheel->pWorkers[0].activeTimerCount);
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueCancelTimer(timerQueueHandle, timerId, (UINT64) &context));
+    EXPECT_EQ(0, pTimerWheel->pWorkers[0].activeTimerCount);
+    EXPECT_EQ(STATUS_INVALID_ARG, kvsTimerQueueCancelTimer(timerQueueHandle, pTimerWheel->pWorkers[0].entryCount, (UINT64) &context));
+
+    // Cancelled from its own callback
+    selfCancel.timerQueueHandle = timerQueueHandle;
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 0, 2 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, timerWheelCancelSelfCallback, (UINT64) &selfCancel,
+                                    &timerId));
+
+    THREAD_SLEEP(100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(0, ATOMIC_LOAD(&context.invocationCount));
+    EXPECT_EQ(1, ATOMIC_LOAD(&selfCancel.invocationCount));
+    EXPECT_EQ(0, pTimerWheel->pWorkers[0].activeTimerCount);
+}
+
+TEST_F(TimerWheelFunctionalityTest, updateTimerPeriod)
+{
+    TimerWheelTestContext context{};
+    UINT32 timerId;
+
+    createWheelQueue();
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, HUNDREDS_OF_NANOS_IN_A_SECOND, HUNDREDS_OF_NANOS_IN_A_SECOND, timerWheelTestCallback,
+                                    (UINT64) &context, &timerId));
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueUpdateTimerPeriod(timerQueueHandle, (UINT64) &context, timerId, 5 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND));
+    EXPECT_EQ(STATUS_INVALID_TIMER_PERIOD_VALUE, kvsTimerQueueUpdateTimerPeriod(timerQueueHandle, (UINT64) &context, timerId, 1));
+
+    THREAD_SLEEP(100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_GE(ATOMIC_LOAD(&context.invocationCount), 5);
+}
+
+TEST_F(TimerWheelFunctionalityTest, timersBeyondLevelZeroCascade)
+{
+    TimerWheelTestContext context[3]{};
+    UINT64 delays[3] = {300 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, 600 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, 100 * HUNDREDS_OF_NANOS_IN_A_SECOND};
+    UINT64 startTime = GETTIME();
+    UINT32 i, timerIds[3];
+
+    createWheelQueue();
+
+    for (i = 0; i < 3; i++) {
+        EXPECT_EQ(STATUS_SUCCESS,
+                  kvsTimerQueueAddTimer(timerQueueHandle, delays[i], TIMER_QUEUE_SINGLE_INVOCATION_PERIOD, timerWheelTestCallback, (UINT64) &context[i],
+                                        &timerIds[i]));
+    }
+
+    THREAD_SLEEP(800 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    for (i = 0; i < 2; i++) {
+        EXPECT_EQ(1, ATOMIC_LOAD(&context[i].invocationCount));
+        EXPECT_GE(context[i].firstInvocationTime, startTime + delays[i]);
+        EXPECT_LT(context[i].firstInvocationTime, startTime + delays[i] + 100 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    }
+    EXPECT_EQ(0, ATOMIC_LOAD(&context[2].invocationCount));
+    EXPECT_EQ(1, pTimerWheel->pWorkers[0].activeTimerCount);
+}
+
+TEST_F(TimerWheelFunctionalityTest, entryPoolGrows)
+{
+    TimerWheelTestContext context{};
+    UINT32 i, timerId;
+
+    createWheelQueue();
+
+    for (i = 0; i < TIMER_WHEEL_DEFAULT_TIMER_COUNT * 3; i++) {
+        EXPECT_EQ(STATUS_SUCCESS,
+                  kvsTimerQueueAddTimer(timerQueueHandle, (i % 50) * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD,
+                                        timerWheelTestCallback, (UINT64) &context, &timerId));
+    }
+    EXPECT_GE(pTimerWheel->pWorkers[0].entryCount, TIMER_WHEEL_DEFAULT_TIMER_COUNT * 3);
+
+    THREAD_SLEEP(200 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(TIMER_WHEEL_DEFAULT_TIMER_COUNT * 3, ATOMIC_LOAD(&context.invocationCount));
+    EXPECT_EQ(0, pTimerWheel->pWorkers[0].activeTimerCount);
+}
+
+TEST_F(TimerWheelFunctionalityTest, shutdownQueue)
+{
+    TimerWheelTestContext context{}, otherContext{};
+    TIMER_QUEUE_HANDLE otherHandle = INVALID_TIMER_QUEUE_HANDLE_VALUE;
+    UINT32 timerId;
+
+    createWheelQueue();
+    EXPECT_EQ(STATUS_SUCCESS, timerWheelCreateQueue(pTimerWheel, &otherHandle));
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 0, 2 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, timerWheelTestCallback, (UINT64) &context, &timerId));
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(otherHandle, 0, 2 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, timerWheelTestCallback, (UINT64) &otherContext, &timerId));
+    THREAD_SLEEP(20 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+
+    // Shutting one queue down only stops its own timers
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueShutdown(timerQueueHandle));
+    EXPECT_EQ(STATUS_TIMER_QUEUE_SHUTDOWN,
+              kvsTimerQueueAddTimer(timerQueueHandle, 0, 2 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, timerWheelTestCallback, (UINT64) &context, &timerId));
+    EXPECT_EQ(1, pTimerWheel->pWorkers[0].activeTimerCount);
+
+    SIZE_T count = ATOMIC_LOAD(&context.invocationCount), otherCount = ATOMIC_LOAD(&otherContext.invocationCount);
+    THREAD_SLEEP(50 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(count, ATOMIC_LOAD(&context.invocationCount));
+    EXPECT_LT(otherCount, ATOMIC_LOAD(&otherContext.invocationCount));
+
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueFree(&otherHandle));
+    EXPECT_FALSE(IS_VALID_TIMER_QUEUE_HANDLE(otherHandle));
+    EXPECT_EQ(0, pTimerWheel->pWorkers[0].activeTimerCount);
+}
+
+TEST_F(TimerWheelFunctionalityTest, callbacksRunWithoutWorkerLock)
+{
+    TimerWheelTestContext slow{}, other{};
+    TIMER_QUEUE_HANDLE otherHandle = INVALID_TIMER_QUEUE_HANDLE_VALUE;
+    UINT32 slowId, otherId;
+    UINT64 startTime;
+
+    createWheelQueue();
+    EXPECT_EQ(STATUS_SUCCESS, timerWheelCreateQueue(pTimerWheel, &otherHandle));
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 0, 200 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, timerWheelSlowCallback, (UINT64) &slow, &slowId));
+    THREAD_SLEEP(20 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+
+    // Another queue of the same worker is not held up by the callback in flight
+    startTime = GETTIME();
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(otherHandle, HUNDREDS_OF_NANOS_IN_A_SECOND, TIMER_QUEUE_SINGLE_INVOCATION_PERIOD, timerWheelTestCallback,
+                                    (UINT64) &other, &otherId));
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueCancelTimer(otherHandle, otherId, (UINT64) &other));
+    EXPECT_LT(GETTIME() - startTime, 50 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_EQ(0, ATOMIC_LOAD(&slow.invocationCount));
+
+    // Cancelling the running timer waits for its callback to return
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueCancelTimer(timerQueueHandle, slowId, (UINT64) &slow));
+    EXPECT_EQ(1, ATOMIC_LOAD(&slow.invocationCount));
+    EXPECT_EQ(0, pTimerWheel->pWorkers[0].activeTimerCount);
+
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueFree(&otherHandle));
+}
+
+TEST_F(TimerWheelFunctionalityTest, queuesSpreadOverWorkers)
+{
+    TIMER_QUEUE_HANDLE handles[4];
+    UINT32 i;
+
+    ASSERT_EQ(STATUS_SUCCESS, createTimerWheel(2, &pTimerWheel));
+    for (i = 0; i < 4; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, timerWheelCreateQueue(pTimerWheel, &handles[i]));
+    }
+    EXPECT_EQ(2, pTimerWheel->pWorkers[0].queueCount);
+    EXPECT_EQ(2, pTimerWheel->pWorkers[1].queueCount);
+    EXPECT_NE(FROM_TIMER_WHEEL_QUEUE_HANDLE(handles[0])->pWorker, FROM_TIMER_WHEEL_QUEUE_HANDLE(handles[1])->pWorker);
+
+    for (i = 0; i < 4; i++) {
+        EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueFree(&handles[i]));
+    }
+    EXPECT_EQ(0, pTimerWheel->pWorkers[0].queueCount);
+    EXPECT_EQ(0, pTimerWheel->pWorkers[1].queueCount);
+}
+
+TEST_F(TimerWheelFunctionalityTest, fallsBackToTimerQueueWithoutSharedWheel)
+{
+    TimerWheelTestContext context{};
+    UINT32 timerId;
+
+    ASSERT_EQ(nullptr, getSharedTimerWheel());
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueCreate(&timerQueueHandle));
+    EXPECT_FALSE(IS_TIMER_WHEEL_QUEUE_HANDLE(timerQueueHandle));
+
+    EXPECT_EQ(STATUS_SUCCESS,
+              kvsTimerQueueAddTimer(timerQueueHandle, 0, 5 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND, timerWheelTestCallback, (UINT64) &context, &timerId));
+    THREAD_SLEEP(50 * HUNDREDS_OF_NANOS_IN_A_MILLISECOND);
+    EXPECT_LT(0, ATOMIC_LOAD(&context.invocationCount));
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueCancelTimer(timerQueueHandle, timerId, (UINT64) &context));
+    EXPECT_EQ(STATUS_SUCCESS, kvsTimerQueueShutdown(timerQueueHandle));
+}
+
+TEST_F(TimerWheelFunctionalityTest, peerConnectionsShareWheelFromEnv)
+{
+    RtcConfiguration configuration{};
+    PRtcPeerConnection offerPc = NULL, answerPc = NULL;
+
+    deinitKvsWebRtc();
+    setenv(WEBRTC_TIMER_WHEEL_THREADS_ENV_VAR, "2", 1);
+    EXPECT_EQ(STATUS_SUCCESS, initKvsWebRtc());
+    unsetenv(WEBRTC_TIMER_WHEEL_THREADS_ENV_VAR);
+    ASSERT_NE(nullptr, getSharedTimerWheel());
+    EXPECT_EQ(2, getSharedTimerWheel()->workerCount);
+
+    initRtcConfiguration(&configuration);
+    EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&configuration, &offerPc));
+    EXPECT_EQ(STATUS_SUCCESS, createPeerConnection(&configuration, &answerPc));
+    EXPECT_TRUE(IS_TIMER_WHEEL_QUEUE_HANDLE(((PKvsPeerConnection) offerPc)->timerQueueHandle));
+    EXPECT_NE(FROM_TIMER_WHEEL_QUEUE_HANDLE(((PKvsPeerConnection) offerPc)->timerQueueHandle)->pWorker,
+              FROM_TIMER_WHEEL_QUEUE_HANDLE(((PKvsPeerConnection) answerPc)->timerQueueHandle)->pWorker);
+
+    EXPECT_EQ(TRUE, connectTwoPeers(offerPc, answerPc));
+
+    closePeerConnection(offerPc);
+    closePeerConnection(answerPc);
+    freePeerConnection(&offerPc);
+    freePeerConnection(&answerPc);
+
+    EXPECT_EQ(0, getSharedTimerWheel()->pWorkers[0].queueCount + getSharedTimerWheel()->pWorkers[1].queueCount);
+    deinitKvsWebRtc();
+    EXPECT_EQ(nullptr, getSharedTimerWheel());
+    EXPECT_EQ(STATUS_SUCCESS, initKvsWebRtc());
+    EXPECT_EQ(nullptr, getSharedTimerWheel());
+}
+
+} // namespace webrtcclient
+} // namespace video
+} // namespace kinesis
+} // namespace amazonaws
+} // namespace com
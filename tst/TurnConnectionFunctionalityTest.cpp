@@ -307,9 +307,8 @@ TEST_F(TurnConnectionFunctionalityTest, turnConnectionShutdownWithAllocationRemo
     BOOL doneAllocate = FALSE;
     UINT64 shutdownTimeout;
     UINT64 doneAllocateTimeout = GETTIME() + 10 * HUNDREDS_OF_NANOS_IN_A_SECOND;
-    PSocketConnection pTurnSocketConnection = NULL, pCurrSocketConnection = NULL;
+    PSocketConnection pTurnSocketConnection = NULL;
     BOOL connectionRemovedFromListener = TRUE;
-    UINT32 i;
 
     initializeTestTurnConnection();
     pTurnSocketConnection = pTurnConnection->pControlChannel;
@@ -343,14 +342,7 @@ TEST_F(TurnConnectionFunctionalityTest, turnConnectionShutdownWithAllocationRemo
 
     THREAD_SLEEP(2 * HUNDREDS_OF_NANOS_IN_A_SECOND);
 
-    MUTEX_LOCK(pConnectionListener->lock);
-    for (i = 0; connectionRemovedFromListener && i < CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION; i++) {
-        if (pConnectionListener->sockets[i] != NULL) {
-            pCurrSocketConnection = pConnectionListener->sockets[i];
-            connectionRemovedFromListener = (pCurrSocketConnection != pTurnSocketConnection);
-        }
-    }
-    MUTEX_UNLOCK(pConnectionListener->lock);
+    connectionRemovedFromListener = !connectionListenerHasConnection(pConnectionListener, pTurnSocketConnection);
 
     /* make sure that pTurnSocketConnection has been removed from connection listener's list */
     EXPECT_TRUE(connectionRemovedFromListener == TRUE);
@@ -367,9 +359,8 @@ TEST_F(TurnConnectionFunctionalityTest, turnConnectionShutdownWithoutAllocationR
     BOOL atGetCredential = FALSE;
     UINT64 shutdownTimeout;
     UINT64 atGetCredentialTimeout = GETTIME() + 10 * HUNDREDS_OF_NANOS_IN_A_SECOND;
-    PSocketConnection pTurnSocketConnection = NULL, pCurrSocketConnection = NULL;
+    PSocketConnection pTurnSocketConnection = NULL;
     BOOL connectionRemovedFromListener = TRUE;
-    UINT32 i;
 
     initializeTestTurnConnection();
     pTurnSocketConnection = pTurnConnection->pControlChannel;
@@ -402,14 +393,7 @@ TEST_F(TurnConnectionFunctionalityTest, turnConnectionShutdownWithoutAllocationR
 
     THREAD_SLEEP(2 * HUNDREDS_OF_NANOS_IN_A_SECOND);
 
-    MUTEX_LOCK(pConnectionListener->lock);
-    for (i = 0; connectionRemovedFromListener && i < CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION; i++) {
-        if (pConnectionListener->sockets[i] != NULL) {
-            pCurrSocketConnection = pConnectionListener->sockets[i];
-            connectionRemovedFromListener = (pCurrSocketConnection != pTurnSocketConnection);
-        }
-    }
-    MUTEX_UNLOCK(pConnectionListener->lock);
+    connectionRemovedFromListener = !connectionListenerHasConnection(pConnectionListener, pTurnSocketConnection);
 
     /* make sure that pTurnSocketConnection has been removed from connection listener's list */
     EXPECT_TRUE(connectionRemovedFromListener == TRUE);
@@ -426,8 +410,7 @@ TEST_F(TurnConnectionFunctionalityTest, turnConnectionShutdownAfterFailure)
     BOOL atGetCredential = FALSE;
     UINT64 shutdownTimeout;
     UINT64 atGetCredentialTimeout = GETTIME() + 10 * HUNDREDS_OF_NANOS_IN_A_SECOND;
-    PSocketConnection pTurnSocketConnection = NULL, pCurrSocketConnection = NULL;
-    UINT32 i;
+    PSocketConnection pTurnSocketConnection = NULL;
     BOOL connectionRemovedFromListener = TRUE;
 
     initializeTestTurnConnection();
@@ -464,14 +447,7 @@ TEST_F(TurnConnectionFunctionalityTest, turnConnectionShutdownAfterFailure)
     /* select in connection timeout every 1s */
     THREAD_SLEEP(3 * HUNDREDS_OF_NANOS_IN_A_SECOND);
 
-    MUTEX_LOCK(pConnectionListener->lock);
-    for (i = 0; connectionRemovedFromListener && i < CONNECTION_LISTENER_DEFAULT_MAX_LISTENING_CONNECTION; i++) {
-        if (pConnectionListener->sockets[i] != NULL) {
-            pCurrSocketConnection = pConnectionListener->sockets[i];
-            connectionRemovedFromListener = (pCurrSocketConnection != pTurnSocketConnection);
-        }
-    }
-    MUTEX_UNLOCK(pConnectionListener->lock);
+    connectionRemovedFromListener = !connectionListenerHasConnection(pConnectionListener, pTurnSocketConnection);
 
     /* make sure that pTurnSocketConnection has been removed from connection listener's list */
     EXPECT_TRUE(connectionRemovedFromListener == TRUE);